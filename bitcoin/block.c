@@ -12,7 +12,7 @@ static const u8 *pull(const u8 **cursor, size_t *max, void *copy, size_t n)
 {
 	const u8 *p = *cursor;
 
-	if (*max < n) {
+	if (!p || *max < n) {
 		*cursor = NULL;
 		*max = 0;
 		/* Just make sure we don't leak uninitialized mem! */
@@ -136,29 +136,137 @@ static void bitcoin_block_pull_dynafed_details(const u8 **cursor, size_t *len, s
 }
 
 /* Encoding is <blockhdr> <varint-num-txs> <tx>... */
+/* Walk a serialized (non-elements) tx, recording its inputs and outputs
+ * and deriving the txid, without building a wally tx. */
+static bool pull_tx_view(struct bitcoin_block *b, size_t txnum,
+			 const u8 **cursor, size_t *max)
+{
+	struct bitcoin_block_tx *btx = &b->txs[txnum];
+	struct sha256_ctx shactx;
+	const u8 *nonwit, *field;
+	bool segwit;
+	u64 n;
+
+	btx->raw = *cursor;
+	sha256_init(&shactx);
+
+	/* nVersion */
+	field = pull(cursor, max, NULL, 4);
+	if (!field)
+		return false;
+	sha256_update(&shactx, field, 4);
+
+	/* Segwit marker and flag are not part of the txid. */
+	segwit = (*max >= 2 && (*cursor)[0] == 0 && (*cursor)[1] != 0);
+	if (segwit)
+		pull(cursor, max, NULL, 2);
+
+	nonwit = *cursor;
+	btx->first_input = tal_count(b->inputs);
+	btx->num_inputs = pull_varint(cursor, max);
+	for (n = 0; n < btx->num_inputs && *cursor; n++) {
+		struct bitcoin_outpoint out;
+
+		pull(cursor, max, &out.txid, sizeof(out.txid));
+		out.n = pull_le32(cursor, max);
+		/* scriptSig */
+		pull(cursor, max, NULL, pull_varint(cursor, max));
+		/* nSequence */
+		pull(cursor, max, NULL, 4);
+		tal_arr_expand(&b->inputs, out);
+	}
+
+	btx->first_output = tal_count(b->outputs);
+	btx->num_outputs = pull_varint(cursor, max);
+	for (n = 0; n < btx->num_outputs && *cursor; n++) {
+		struct bitcoin_block_output out;
+		le64 satoshis;
+
+		pull(cursor, max, &satoshis, sizeof(satoshis));
+		out.amount.satoshis = le64_to_cpu(satoshis); /* Raw: from wire */
+		out.script_len = pull_varint(cursor, max);
+		out.script = pull(cursor, max, NULL, out.script_len);
+		out.is_main_asset = true;
+		tal_arr_expand(&b->outputs, out);
+	}
+	if (!*cursor)
+		return false;
+	sha256_update(&shactx, nonwit, *cursor - nonwit);
+
+	if (segwit) {
+		for (n = 0; n < btx->num_inputs; n++) {
+			u64 items = pull_varint(cursor, max);
+			for (u64 k = 0; k < items && *cursor; k++)
+				pull(cursor, max, NULL, pull_varint(cursor, max));
+		}
+	}
+
+	/* nLockTime */
+	field = pull(cursor, max, NULL, 4);
+	if (!field)
+		return false;
+	sha256_update(&shactx, field, 4);
+
+	sha256_double_done(&shactx, &b->txids[txnum].shad);
+	btx->rawlen = *cursor - btx->raw;
+	return true;
+}
+
+/* Fill in the view of an already-decoded tx. */
+static void add_tx_view(struct bitcoin_block *b, size_t txnum)
+{
+	const struct bitcoin_tx *tx = b->tx[txnum];
+	struct bitcoin_block_tx *btx = &b->txs[txnum];
+
+	bitcoin_txid(tx, &b->txids[txnum]);
+	btx->raw = NULL;
+	btx->rawlen = 0;
+
+	btx->first_input = tal_count(b->inputs);
+	btx->num_inputs = tx->wtx->num_inputs;
+	for (size_t i = 0; i < tx->wtx->num_inputs; i++) {
+		struct bitcoin_outpoint out;
+		bitcoin_tx_input_get_outpoint(tx, i, &out);
+		tal_arr_expand(&b->inputs, out);
+	}
+
+	btx->first_output = tal_count(b->outputs);
+	btx->num_outputs = tx->wtx->num_outputs;
+	for (size_t i = 0; i < tx->wtx->num_outputs; i++) {
+		struct bitcoin_block_output out;
+		struct amount_asset amt = bitcoin_tx_output_get_amount(tx, i);
+
+		out.script = tx->wtx->outputs[i].script;
+		out.script_len = tx->wtx->outputs[i].script_len;
+		/* Coinbase outputs are flagged by wally; never treat them as
+		 * spendable value. */
+		out.is_main_asset = amount_asset_is_main(&amt)
+			&& !(tx->wtx->outputs[i].features & WALLY_TX_IS_COINBASE);
+		if (out.is_main_asset)
+			out.amount = amount_asset_to_sat(&amt);
+		else
+			out.amount = AMOUNT_SAT(0);
+		tal_arr_expand(&b->outputs, out);
+	}
+}
+
 struct bitcoin_block *
-bitcoin_block_from_hex(const tal_t *ctx, const struct chainparams *chainparams,
-		       const char *hex, size_t hexlen)
+bitcoin_block_from_raw(const tal_t *ctx, const struct chainparams *chainparams,
+		       const u8 *raw TAKES, size_t rawlen)
 {
 	struct bitcoin_block *b;
-	u8 *linear_tx;
 	const u8 *p;
 	size_t len, i, num, templen;
 	struct sha256_ctx shactx;
 	bool is_dynafed;
 	u32 height;
 
-	if (hexlen && hex[hexlen-1] == '\n')
-		hexlen--;
-
 	/* Set up the block for success. */
 	b = tal(ctx, struct bitcoin_block);
 
-	/* De-hex the array. */
-	len = hex_data_size(hexlen);
-	p = linear_tx = tal_arr(ctx, u8, len);
-	if (!hex_decode(hex, hexlen, linear_tx, len))
-		return tal_free(b);
+	/* Views point into this, so we keep it. */
+	b->raw = p = tal_dup_arr(b, u8, raw, rawlen, 0);
+	len = rawlen;
 
 	sha256_init(&shactx);
 
@@ -207,22 +315,66 @@ bitcoin_block_from_hex(const tal_t *ctx, const struct chainparams *chainparams,
 	sha256_double_done(&shactx, &b->hdr.hash.shad);
 
 	num = pull_varint(&p, &len);
-	b->tx = tal_arr(b, struct bitcoin_tx *, num);
+	b->txs = tal_arr(b, struct bitcoin_block_tx, num);
 	b->txids = tal_arr(b, struct bitcoin_txid, num);
+	b->tx = tal_arrz(b, struct bitcoin_tx *, num);
+	b->inputs = tal_arr(b, struct bitcoin_outpoint, 0);
+	b->outputs = tal_arr(b, struct bitcoin_block_output, 0);
 	for (i = 0; i < num; i++) {
-		b->tx[i] = pull_bitcoin_tx(b->tx, &p, &len);
-		b->tx[i]->chainparams = chainparams;
-		bitcoin_txid(b->tx[i], &b->txids[i]);
+		/* Elements txs are too complex to walk by hand: decode them. */
+		if (is_elements(chainparams)) {
+			b->tx[i] = pull_bitcoin_tx(b->tx, &p, &len);
+			if (!b->tx[i])
+				return tal_free(b);
+			b->tx[i]->chainparams = chainparams;
+			add_tx_view(b, i);
+		} else if (!pull_tx_view(b, i, &p, &len))
+			return tal_free(b);
 	}
 
 	/* We should end up not overrunning, nor have extra */
 	if (!p || len)
 		return tal_free(b);
 
-	tal_free(linear_tx);
 	return b;
 }
 
+struct bitcoin_block *
+bitcoin_block_from_hex(const tal_t *ctx, const struct chainparams *chainparams,
+		       const char *hex, size_t hexlen)
+{
+	u8 *linear_block;
+	size_t len;
+
+	if (hexlen && hex[hexlen-1] == '\n')
+		hexlen--;
+
+	/* De-hex the array. */
+	len = hex_data_size(hexlen);
+	linear_block = tal_arr(NULL, u8, len);
+	if (!hex_decode(hex, hexlen, linear_block, len)) {
+		tal_free(linear_block);
+		return NULL;
+	}
+
+	return bitcoin_block_from_raw(ctx, chainparams,
+				      take(linear_block), len);
+}
+
+struct bitcoin_tx *bitcoin_block_tx(struct bitcoin_block *b, size_t i)
+{
+	if (!b->tx[i]) {
+		const u8 *p = b->txs[i].raw;
+		size_t len = b->txs[i].rawlen;
+
+		b->tx[i] = pull_bitcoin_tx(b->tx, &p, &len);
+		/* We already walked it, so this can't fail */
+		assert(b->tx[i] && len == 0);
+		b->tx[i]->chainparams = chainparams;
+	}
+	return b->tx[i];
+}
+
 void bitcoin_block_blkid(const struct bitcoin_block *b,
 			 struct bitcoin_blkid *out)
 {
@@ -5,7 +5,12 @@
 #include <ccan/endian/endian.h>
 #include <ccan/structeq/structeq.h>
 #include <ccan/tal/tal.h>
+#include <ccan/take/take.h>
+#include <common/amount.h>
 
+struct bitcoin_outpoint;
+struct bitcoin_tx;
+struct bitcoin_txid;
 struct chainparams;
 
 enum dynafed_params_type {
@@ -30,17 +35,51 @@ struct bitcoin_block_hdr {
 	struct bitcoin_blkid hash;
 };
 
+/* An output inside a block: script points into the block's raw data. */
+struct bitcoin_block_output {
+	const u8 *script;
+	size_t script_len;
+	struct amount_sat amount;
+	/* False if this isn't plain main-asset value (elements only). */
+	bool is_main_asset;
+};
+
+/* A transaction inside a block, without decoding it into a wally tx. */
+struct bitcoin_block_tx {
+	/* Serialized tx, within the block's raw data. */
+	const u8 *raw;
+	size_t rawlen;
+	/* Offsets into bitcoin_block inputs and outputs arrays. */
+	size_t first_input, num_inputs;
+	size_t first_output, num_outputs;
+};
+
 struct bitcoin_block {
 	struct bitcoin_block_hdr hdr;
 	/* tal_count shows now many */
-	struct bitcoin_tx **tx;
+	struct bitcoin_block_tx *txs;
 	struct bitcoin_txid *txids;
+	/* Outpoints spent by all txs, and all outputs, in block order. */
+	struct bitcoin_outpoint *inputs;
+	struct bitcoin_block_output *outputs;
+	/* Decoded txs: NULL until bitcoin_block_tx() asks for one. */
+	struct bitcoin_tx **tx;
+	/* The raw block, which the above point into. */
+	const u8 *raw;
 };
 
 struct bitcoin_block *
 bitcoin_block_from_hex(const tal_t *ctx, const struct chainparams *chainparams,
 		       const char *hex, size_t hexlen);
 
+/* Same, but from the raw serialized block. */
+struct bitcoin_block *
+bitcoin_block_from_raw(const tal_t *ctx, const struct chainparams *chainparams,
+		       const u8 *raw TAKES, size_t rawlen);
+
+/* Fully decode the @i'th transaction of the block (cached, owned by block) */
+struct bitcoin_tx *bitcoin_block_tx(struct bitcoin_block *block, size_t i);
+
 /* Compute the double SHA block ID from the block header. */
 void bitcoin_block_blkid(const struct bitcoin_block *block,
 			 struct bitcoin_blkid *out);
@@ -0,0 +1,120 @@
+#include "config.h"
+#include <bitcoin/block.h>
+#include <bitcoin/blockfilter.h>
+#include <bitcoin/varint.h>
+#include <ccan/asort/asort.h>
+#include <ccan/crypto/siphash24/siphash24.h>
+#include <ccan/endian/endian.h>
+#include <common/utils.h>
+
+/* BIP158 basic filter parameters */
+#define BASIC_FILTER_P 19
+#define BASIC_FILTER_M 784931
+
+/* Golomb-Rice coded set is a big-endian bitstream. */
+struct bitreader {
+	const u8 *p;
+	size_t len;
+	size_t bitpos;
+};
+
+static bool read_bit(struct bitreader *br, u64 *bit)
+{
+	if (br->bitpos / 8 >= br->len)
+		return false;
+	*bit = (br->p[br->bitpos / 8] >> (7 - br->bitpos % 8)) & 1;
+	br->bitpos++;
+	return true;
+}
+
+static bool read_golomb_rice(struct bitreader *br, u64 *delta)
+{
+	u64 bit, q = 0, r = 0;
+
+	/* Quotient is unary: 1s terminated by a 0. */
+	for (;;) {
+		if (!read_bit(br, &bit))
+			return false;
+		if (!bit)
+			break;
+		q++;
+	}
+	for (size_t i = 0; i < BASIC_FILTER_P; i++) {
+		if (!read_bit(br, &bit))
+			return false;
+		r = (r << 1) | bit;
+	}
+	*delta = (q << BASIC_FILTER_P) | r;
+	return true;
+}
+
+/* (a * b) >> 64, without relying on a 128-bit type. */
+static u64 mul_high64(u64 a, u64 b)
+{
+	u64 alo = a & 0xFFFFFFFF, ahi = a >> 32;
+	u64 blo = b & 0xFFFFFFFF, bhi = b >> 32;
+	u64 lolo = alo * blo, lohi = alo * bhi, hilo = ahi * blo;
+	u64 mid = (lolo >> 32) + (lohi & 0xFFFFFFFF) + (hilo & 0xFFFFFFFF);
+
+	return ahi * bhi + (lohi >> 32) + (hilo >> 32) + (mid >> 32);
+}
+
+static int cmp_u64(const u64 *a, const u64 *b, void *unused)
+{
+	if (*a < *b)
+		return -1;
+	return *a > *b;
+}
+
+bool blockfilter_match_any(const struct bitcoin_blkid *blkid,
+			   const u8 *filter, size_t len,
+			   const u8 **scripts)
+{
+	struct siphash_seed seed;
+	struct bitreader br;
+	u64 n, f, val, *queries;
+	size_t used, qi;
+
+	used = varint_get(filter, len, &n);
+	if (used == 0)
+		return true;
+	if (n == 0 || tal_count(scripts) == 0)
+		return false;
+	if (n > UINT64_MAX / BASIC_FILTER_M)
+		return true;
+	f = n * BASIC_FILTER_M;
+
+	/* Key is the first 16 bytes of the block hash (internal order). */
+	for (size_t i = 0; i < 2; i++) {
+		le64 k;
+		memcpy(&k, blkid->shad.sha.u.u8 + i * sizeof(k), sizeof(k));
+		seed.u.u64[i] = le64_to_cpu(k);
+	}
+
+	queries = tal_arr(tmpctx, u64, tal_count(scripts));
+	for (size_t i = 0; i < tal_count(scripts); i++)
+		queries[i] = mul_high64(siphash24(&seed, scripts[i],
+						  tal_bytelen(scripts[i])),
+					f);
+	asort(queries, tal_count(queries), cmp_u64, NULL);
+
+	/* Both sets are sorted: walk them together. */
+	br.p = filter + used;
+	br.len = len - used;
+	br.bitpos = 0;
+	val = 0;
+	qi = 0;
+	for (u64 i = 0; i < n; i++) {
+		u64 delta;
+		if (!read_golomb_rice(&br, &delta))
+			return true;
+		val += delta;
+		while (queries[qi] < val) {
+			if (++qi == tal_count(queries))
+				return false;
+		}
+		if (queries[qi] == val)
+			return true;
+	}
+	return false;
+}
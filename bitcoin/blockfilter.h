@@ -0,0 +1,18 @@
+#ifndef LIGHTNING_BITCOIN_BLOCKFILTER_H
+#define LIGHTNING_BITCOIN_BLOCKFILTER_H
+#include "config.h"
+#include <ccan/short_types/short_types.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+struct bitcoin_blkid;
+
+/* Does the BIP158 "basic" @filter for block @blkid match any of @scripts
+ * (a tal array of tal scripts)?  Like any bloom-ish filter this can have
+ * false positives, never false negatives.  A malformed filter matches
+ * everything, so the caller falls back to fetching the block. */
+bool blockfilter_match_any(const struct bitcoin_blkid *blkid,
+			   const u8 *filter, size_t len,
+			   const u8 **scripts);
+
+#endif /* LIGHTNING_BITCOIN_BLOCKFILTER_H */
@@ -741,12 +741,23 @@ struct wally_psbt *psbt_from_bytes(const tal_t *ctx, const u8 *bytes,
 
 void towire_wally_psbt(u8 **pptr, const struct wally_psbt *psbt)
 {
-	/* Let's include the PSBT bytes */
-	size_t bytes_written;
-	const u8 *pbt_bytes = psbt_get_bytes(NULL, psbt, &bytes_written);
-	towire_u32(pptr, bytes_written);
-	towire_u8_array(pptr, pbt_bytes, bytes_written);
-	tal_free(pbt_bytes);
+	size_t len = 0, written, off;
+
+	if (psbt)
+		wally_psbt_get_length(psbt, 0, &len);
+	towire_u32(pptr, len);
+	if (!len)
+		return;
+
+	/* Serialize straight into the message: PSBTs with many inputs
+	 * are large, and we send them to subdaemons a lot. */
+	off = tal_count(*pptr);
+	tal_resize(pptr, off + len);
+	if (wally_psbt_to_bytes(psbt, 0, *pptr + off, len, &written) != WALLY_OK
+	    || written != len) {
+		/* something went wrong. bad libwally ?? */
+		abort();
+	}
 }
 
 struct wally_psbt *fromwire_wally_psbt(const tal_t *ctx,
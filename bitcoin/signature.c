@@ -7,6 +7,7 @@
 #include <bitcoin/shadouble.h>
 #include <bitcoin/signature.h>
 #include <bitcoin/tx.h>
+#include <bitcoin/varint.h>
 #include <ccan/mem/mem.h>
 #include <common/type_to_string.h>
 #include <secp256k1_schnorrsig.h>
@@ -158,6 +159,75 @@ void bitcoin_tx_hash_for_sig(const struct bitcoin_tx *tx, unsigned int in,
 	tal_wally_end(tx->wtx);
 }
 
+static void sha256_update_varbytes(struct sha256_ctx *ctx,
+				   const u8 *bytes, size_t len)
+{
+	u8 buf[VARINT_MAX_LEN];
+
+	sha256_update(ctx, buf, varint_put(buf, len));
+	sha256_update(ctx, bytes, len);
+}
+
+void bip143_hashes_init(struct bip143_hashes *hashes,
+			const struct wally_tx *wtx)
+{
+	struct sha256_ctx ctx;
+
+	/* BIP143:
+	 *  2. hashPrevouts (32-byte hash)
+	 *  3. hashSequence (32-byte hash)
+	 *  ...
+	 *  8. hashOutputs (32-byte hash)
+	 */
+	sha256_init(&ctx);
+	for (size_t i = 0; i < wtx->num_inputs; i++) {
+		sha256_update(&ctx, wtx->inputs[i].txhash,
+			      sizeof(wtx->inputs[i].txhash));
+		sha256_le32(&ctx, wtx->inputs[i].index);
+	}
+	sha256_double_done(&ctx, &hashes->prevouts);
+
+	sha256_init(&ctx);
+	for (size_t i = 0; i < wtx->num_inputs; i++)
+		sha256_le32(&ctx, wtx->inputs[i].sequence);
+	sha256_double_done(&ctx, &hashes->sequence);
+
+	sha256_init(&ctx);
+	for (size_t i = 0; i < wtx->num_outputs; i++) {
+		sha256_le64(&ctx, wtx->outputs[i].satoshi);
+		sha256_update_varbytes(&ctx, wtx->outputs[i].script,
+				       wtx->outputs[i].script_len);
+	}
+	sha256_double_done(&ctx, &hashes->outputs);
+}
+
+void bip143_hash_for_sig(const struct wally_tx *wtx,
+			 const struct bip143_hashes *hashes,
+			 unsigned int in,
+			 const u8 *script,
+			 struct amount_sat input_amt,
+			 struct sha256_double *dest)
+{
+	struct sha256_ctx ctx;
+
+	assert(in < wtx->num_inputs);
+
+	sha256_init(&ctx);
+	sha256_le32(&ctx, wtx->version);
+	sha256_update(&ctx, &hashes->prevouts, sizeof(hashes->prevouts));
+	sha256_update(&ctx, &hashes->sequence, sizeof(hashes->sequence));
+	sha256_update(&ctx, wtx->inputs[in].txhash,
+		      sizeof(wtx->inputs[in].txhash));
+	sha256_le32(&ctx, wtx->inputs[in].index);
+	sha256_update_varbytes(&ctx, script, tal_bytelen(script));
+	sha256_le64(&ctx, input_amt.satoshis); /* Raw: sighash serialization */
+	sha256_le32(&ctx, wtx->inputs[in].sequence);
+	sha256_update(&ctx, &hashes->outputs, sizeof(hashes->outputs));
+	sha256_le32(&ctx, wtx->locktime);
+	sha256_le32(&ctx, SIGHASH_ALL);
+	sha256_double_done(&ctx, dest);
+}
+
 void sign_tx_input(const struct bitcoin_tx *tx,
 		   unsigned int in,
 		   const u8 *subscript,
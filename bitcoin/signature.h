@@ -1,14 +1,16 @@
 #ifndef LIGHTNING_BITCOIN_SIGNATURE_H
 #define LIGHTNING_BITCOIN_SIGNATURE_H
 #include "config.h"
+#include <bitcoin/shadouble.h>
 #include <ccan/short_types/short_types.h>
 #include <ccan/tal/tal.h>
+#include <common/amount.h>
 #include <secp256k1.h>
 
 struct sha256;
-struct sha256_double;
 struct sha256_ctx;
 struct bitcoin_tx;
+struct wally_tx;
 struct pubkey;
 struct privkey;
 struct bitcoin_tx_output;
@@ -63,6 +65,40 @@ void bitcoin_tx_hash_for_sig(const struct bitcoin_tx *tx, unsigned int in,
 			     enum sighash_type sighash_type,
 			     struct sha256_double *dest);
 
+/* The BIP143 hashes which don't depend on the input being signed: with
+ * SIGHASH_ALL they're the same for every input, so compute them once. */
+struct bip143_hashes {
+	struct sha256_double prevouts, sequence, outputs;
+};
+
+/**
+ * bip143_hashes_init - precompute hashPrevouts/hashSequence/hashOutputs
+ * @hashes - the hashes to fill in
+ * @wtx - the (non-Elements) tx being signed
+ */
+void bip143_hashes_init(struct bip143_hashes *hashes,
+			const struct wally_tx *wtx);
+
+/**
+ * bip143_hash_for_sig - bitcoin_tx_hash_for_sig for SIGHASH_ALL segwit v0,
+ * reusing hashes from bip143_hashes_init.
+ * @wtx - tx to hash (unchanged since bip143_hashes_init!)
+ * @hashes - from bip143_hashes_init
+ * @in - index that this 'hash' is for
+ * @script - scriptCode for that input
+ * @input_amt - the amount that input spends
+ * @dest - hash result
+ *
+ * Signing every input through bitcoin_tx_hash_for_sig recomputes the
+ * shared hashes each time, which is quadratic in the number of inputs.
+ */
+void bip143_hash_for_sig(const struct wally_tx *wtx,
+			 const struct bip143_hashes *hashes,
+			 unsigned int in,
+			 const u8 *script,
+			 struct amount_sat input_amt,
+			 struct sha256_double *dest);
+
 /**
  * sign_hash - produce a raw secp256k1 signature (with low R value).
  * @p: secret key
@@ -176,25 +176,52 @@ int main(int argc, const char *argv[])
 	assert(b->hdr.timestamp == 1550507183);
 	assert(b->hdr.nonce == 1226407989);
 
-	assert(tal_count(b->tx) == 3);
-	bitcoin_txid(b->tx[0], &txid);
+	assert(tal_count(b->txs) == 3);
+	bitcoin_txid(bitcoin_block_tx(b, 0), &txid);
 	bitcoin_txid_from_hex("14d86acd2158acd1f59ab77ab251e3f5073db905a7b2aed25d3ba7780c3d790c",
 			      strlen("14d86acd2158acd1f59ab77ab251e3f5073db905a7b2aed25d3ba7780c3d790c"),
 			      &expected_txid);
 	assert(bitcoin_txid_eq(&txid, &expected_txid));
 
-	bitcoin_txid(b->tx[1], &txid);
+	bitcoin_txid(bitcoin_block_tx(b, 1), &txid);
 	bitcoin_txid_from_hex("c261a53121cc9841f843e2e6e0cff337e4f3c5eee788c982a0bffe771ce69919",
 			      strlen("c261a53121cc9841f843e2e6e0cff337e4f3c5eee788c982a0bffe771ce69919"),
 			      &expected_txid);
 	assert(bitcoin_txid_eq(&txid, &expected_txid));
 
-	bitcoin_txid(b->tx[2], &txid);
+	bitcoin_txid(bitcoin_block_tx(b, 2), &txid);
 	bitcoin_txid_from_hex("80cea306607b708a03a1854520729da884e4317b7b51f3d4a622f88176f5e034",
 			      strlen("80cea306607b708a03a1854520729da884e4317b7b51f3d4a622f88176f5e034"),
 			      &expected_txid);
 	assert(bitcoin_txid_eq(&txid, &expected_txid));
 
+	/* The views must agree with the decoded transactions */
+	for (size_t i = 0; i < tal_count(b->txs); i++) {
+		const struct bitcoin_block_tx *btx = &b->txs[i];
+		const struct bitcoin_tx *tx = bitcoin_block_tx(b, i);
+
+		bitcoin_txid(tx, &txid);
+		assert(bitcoin_txid_eq(&txid, &b->txids[i]));
+		assert(btx->num_inputs == tx->wtx->num_inputs);
+		for (size_t j = 0; j < btx->num_inputs; j++) {
+			struct bitcoin_outpoint out;
+			bitcoin_tx_input_get_outpoint(tx, j, &out);
+			assert(bitcoin_outpoint_eq(&out,
+						   &b->inputs[btx->first_input + j]));
+		}
+		assert(btx->num_outputs == tx->wtx->num_outputs);
+		for (size_t j = 0; j < btx->num_outputs; j++) {
+			const struct bitcoin_block_output *out
+				= &b->outputs[btx->first_output + j];
+			assert(out->script_len == tx->wtx->outputs[j].script_len);
+			assert(memeq(out->script, out->script_len,
+				     tx->wtx->outputs[j].script,
+				     tx->wtx->outputs[j].script_len));
+			assert(out->amount.satoshis /* Raw: test */
+			       == tx->wtx->outputs[j].satoshi);
+		}
+	}
+
 	tal_free(b);
 	common_shutdown();
 	return 0;
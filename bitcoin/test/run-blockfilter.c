@@ -0,0 +1,69 @@
+#include "config.h"
+#include <assert.h>
+#include <bitcoin/blockfilter.c>
+#include <bitcoin/varint.c>
+#include <ccan/str/hex/hex.h>
+#include <common/setup.h>
+#include <common/utils.h>
+#include <stdio.h>
+
+/* AUTOGENERATED MOCKS START */
+/* AUTOGENERATED MOCKS END */
+
+/* From the BIP158 test vectors: testnet genesis block. */
+static const char genesis_blkid[] = "000000000933ea01ad0ee984209779baaec3ced90fa3f408719526f8d77f4943";
+static const char genesis_script[] = "4104678afdb0fe5548271967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5fac";
+static const char genesis_filter[] = "019dfca8";
+
+int main(int argc, const char *argv[])
+{
+	struct bitcoin_blkid blkid;
+	const u8 *filter, **scripts;
+
+	common_setup(argv[0]);
+
+	/* Block ids are displayed reversed. */
+	assert(hex_decode(genesis_blkid, strlen(genesis_blkid),
+			  &blkid, sizeof(blkid)));
+	for (size_t i = 0; i < sizeof(blkid) / 2; i++) {
+		u8 tmp = blkid.shad.sha.u.u8[i];
+		blkid.shad.sha.u.u8[i] = blkid.shad.sha.u.u8[sizeof(blkid) - 1 - i];
+		blkid.shad.sha.u.u8[sizeof(blkid) - 1 - i] = tmp;
+	}
+	filter = tal_hexdata(tmpctx, genesis_filter, strlen(genesis_filter));
+
+	/* Nothing to match. */
+	scripts = tal_arr(tmpctx, const u8 *, 0);
+	assert(!blockfilter_match_any(&blkid, filter, tal_bytelen(filter),
+				      scripts));
+
+	/* The coinbase output script matches. */
+	tal_arr_expand(&scripts, tal_hexdata(scripts, genesis_script,
+					     strlen(genesis_script)));
+	assert(blockfilter_match_any(&blkid, filter, tal_bytelen(filter),
+				     scripts));
+
+	/* A different script doesn't. */
+	scripts[0] = tal_hexdata(scripts, "0014", strlen("0014"));
+	assert(!blockfilter_match_any(&blkid, filter, tal_bytelen(filter),
+				      scripts));
+
+	/* But with it in the query set, we still match. */
+	tal_arr_expand(&scripts, tal_hexdata(scripts, genesis_script,
+					     strlen(genesis_script)));
+	assert(blockfilter_match_any(&blkid, filter, tal_bytelen(filter),
+				     scripts));
+
+	/* Empty filter matches nothing */
+	filter = tal_hexdata(tmpctx, "00", 2);
+	assert(!blockfilter_match_any(&blkid, filter, tal_bytelen(filter),
+				      scripts));
+
+	/* Truncated filter is treated as a match */
+	filter = tal_hexdata(tmpctx, "019d", 4);
+	assert(blockfilter_match_any(&blkid, filter, tal_bytelen(filter),
+				     scripts));
+
+	common_shutdown();
+	return 0;
+}
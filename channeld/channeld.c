@@ -100,6 +100,12 @@ struct peer {
 	struct oneshot *commit_timer;
 	u64 commit_timer_attempts;
 	u32 commit_msec;
+	/* While changes keep coming, we delay the commit up to this long
+	 * (0 to disable), so a burst shares one commitment_signed. */
+	u32 commit_batch_msec;
+	/* When the first uncommitted change arrived, and how many since. */
+	struct timemono commit_batch_start;
+	size_t commit_batch_changes;
 
 	/* The feerate we want. */
 	u32 desired_feerate;
@@ -1026,6 +1032,7 @@ static struct bitcoin_signature *calc_commitsigs(const tal_t *ctx,
 	size_t i;
 	struct pubkey local_htlckey;
 	const u8 *msg;
+	const struct bitcoin_tx **htlc_txs;
 	struct bitcoin_signature *htlc_sigs;
 
 	htlcs = collect_htlcs(tmpctx, htlc_map);
@@ -1067,24 +1074,28 @@ static struct bitcoin_signature *calc_commitsigs(const tal_t *ctx,
 	 *  - MUST include one `htlc_signature` for every HTLC transaction
 	 *    corresponding to the ordering of the commitment transaction
 	 */
-	htlc_sigs = tal_arr(ctx, struct bitcoin_signature, tal_count(txs) - 1);
+	htlc_txs = tal_dup_arr(tmpctx, const struct bitcoin_tx *,
+			       (const struct bitcoin_tx **)txs + 1,
+			       tal_count(txs) - 1, 0);
+	msg = towire_hsmd_sign_remote_htlc_txs(NULL, txs[0], htlc_txs,
+					       &peer->remote_per_commit,
+					       channel_has(peer->channel,
+							   OPT_ANCHOR_OUTPUTS));
+	msg = hsm_req(tmpctx, take(msg));
+	if (!fromwire_hsmd_sign_remote_htlc_txs_reply(ctx, msg, &htlc_sigs))
+		status_failed(STATUS_FAIL_HSM_IO,
+			      "Bad sign_remote_htlc_txs reply: %s",
+			      tal_hex(tmpctx, msg));
+	if (tal_count(htlc_sigs) != tal_count(txs) - 1)
+		status_failed(STATUS_FAIL_HSM_IO,
+			      "sign_remote_htlc_txs gave %zu sigs for %zu txs",
+			      tal_count(htlc_sigs), tal_count(txs) - 1);
 
 	for (i = 0; i < tal_count(htlc_sigs); i++) {
 		u8 *wscript;
 
 		wscript = bitcoin_tx_output_get_witscript(tmpctx, txs[0],
 							  txs[i+1]->wtx->inputs[0].index);
-		msg = towire_hsmd_sign_remote_htlc_tx(NULL, txs[i + 1], wscript,
-						     &peer->remote_per_commit,
-						      channel_has(peer->channel,
-								  OPT_ANCHOR_OUTPUTS));
-
-		msg = hsm_req(tmpctx, take(msg));
-		if (!fromwire_hsmd_sign_tx_reply(msg, &htlc_sigs[i]))
-			status_failed(STATUS_FAIL_HSM_IO,
-				      "Bad sign_remote_htlc_tx reply: %s",
-				      tal_hex(tmpctx, msg));
-
 		status_debug("Creating HTLC signature %s for tx %s wscript %s key %s",
 			     type_to_string(tmpctx, struct bitcoin_signature,
 					    &htlc_sigs[i]),
@@ -1337,6 +1348,7 @@ static void send_commit(struct peer *peer)
 		maybe_send_shutdown(peer);
 
 		peer->commit_timer = NULL;
+		peer->commit_batch_changes = 0;
 		return;
 	}
 
@@ -1393,14 +1405,34 @@ static void send_commit(struct peer *peer)
 
 	/* Timer now considered expired, you can add a new one. */
 	peer->commit_timer = NULL;
+	peer->commit_batch_changes = 0;
 	start_commit_timer(peer);
 }
 
+/* Past this many changes, a bigger batch doesn't save much. */
+#define COMMIT_BATCH_MAX_CHANGES 100
+
 static void start_commit_timer(struct peer *peer)
 {
-	/* Already armed? */
-	if (peer->commit_timer)
-		return;
+	struct timemono now = time_mono();
+
+	if (peer->commit_batch_changes++ == 0)
+		peer->commit_batch_start = now;
+
+	/* Already armed?  If we're batching, and it's busy, push it back
+	 * (unless we've already waited long enough, or have plenty). */
+	if (peer->commit_timer) {
+		struct timerel waited;
+
+		if (!peer->commit_batch_msec
+		    || peer->commit_batch_changes > COMMIT_BATCH_MAX_CHANGES)
+			return;
+		waited = timemono_between(now, peer->commit_batch_start);
+		if (time_to_msec(waited) + peer->commit_msec
+		    > peer->commit_batch_msec)
+			return;
+		peer->commit_timer = tal_free(peer->commit_timer);
+	}
 
 	peer->commit_timer = new_reltimer(&peer->timers, peer,
 					  time_from_msec(peer->commit_msec),
@@ -3815,6 +3847,7 @@ static void init_channel(struct peer *peer)
 				    &peer->node_ids[LOCAL],
 				    &peer->node_ids[REMOTE],
 				    &peer->commit_msec,
+				    &peer->commit_batch_msec,
 				    &peer->cltv_delta,
 				    &peer->last_was_revoke,
 				    &peer->last_sent_commit,
@@ -3980,6 +4013,7 @@ int main(int argc, char *argv[])
 	peer = tal(NULL, struct peer);
 	timers_init(&peer->timers, time_mono());
 	peer->commit_timer = NULL;
+	peer->commit_batch_changes = 0;
 	peer->have_sigs[LOCAL] = peer->have_sigs[REMOTE] = false;
 	peer->announce_depth_reached = false;
 	peer->channel_local_active = false;
@@ -1198,21 +1198,55 @@ u32 approx_max_feerate(const struct channel *channel)
 	return avail.satoshis / weight * 1000; /* Raw: once-off reverse feerate*/
 }
 
+/* Count the untrimmed HTLCs and total the trimmed ones on @side's next
+ * commitment at @feerate_per_kw.  This is what gather_htlcs() then
+ * num_untrimmed_htlcs() and htlc_dust() give, in one pass and without
+ * allocating: feerate checks do this for every candidate feerate. */
+static bool htlc_trim_totals(const struct channel *channel,
+			     enum side side,
+			     u32 feerate_per_kw,
+			     size_t *untrimmed,
+			     struct amount_msat *trimmed)
+{
+	struct htlc_map_iter it;
+	const struct htlc *htlc;
+	const int committed_flag = HTLC_FLAG(side, HTLC_F_COMMITTED);
+	const int pending_flag = HTLC_FLAG(side, HTLC_F_PENDING);
+	struct amount_sat dust_limit = channel->config[side].dust_limit;
+	bool option_anchor_outputs = channel_has(channel, OPT_ANCHOR_OUTPUTS);
+
+	*untrimmed = 0;
+	*trimmed = AMOUNT_MSAT(0);
+	if (!channel->htlcs)
+		return true;
+
+	for (htlc = htlc_map_first(channel->htlcs, &it);
+	     htlc;
+	     htlc = htlc_map_next(channel->htlcs, &it)) {
+		/* Committed and not being removed, or being added. */
+		if (htlc_has(htlc, committed_flag) == htlc_has(htlc, pending_flag))
+			continue;
+
+		if (!htlc_is_trimmed(htlc_owner(htlc), htlc->amount,
+				     feerate_per_kw, dust_limit, side,
+				     option_anchor_outputs))
+			(*untrimmed)++;
+		else if (!amount_msat_add(trimmed, *trimmed, htlc->amount))
+			return false;
+	}
+	return true;
+}
+
 /* Is the sum of trimmed htlcs, as this new feerate, above our
  * max allowed htlc dust limit? */
 static struct amount_msat htlc_calculate_dust(const struct channel *channel,
 					      u32 feerate_per_kw,
 					      enum side side)
 {
-	const struct htlc **committed, **adding, **removing;
-	struct amount_msat acc_dust = AMOUNT_MSAT(0);
-
-	gather_htlcs(tmpctx, channel, side,
-		     &committed, &removing, &adding);
-
-	htlc_dust(channel, committed, adding, removing,
-		  side, feerate_per_kw, &acc_dust);
+	size_t untrimmed;
+	struct amount_msat acc_dust;
 
+	htlc_trim_totals(channel, side, feerate_per_kw, &untrimmed, &acc_dust);
 	return acc_dust;
 }
 
@@ -1232,23 +1266,12 @@ bool htlc_dust_ok(const struct channel *channel,
 bool can_opener_afford_feerate(const struct channel *channel, u32 feerate_per_kw)
 {
 	struct amount_sat needed, fee;
-	struct amount_sat dust_limit = channel->config[!channel->opener].dust_limit;
 	size_t untrimmed;
-	const struct htlc **committed, **adding, **removing;
+	struct amount_msat trimmed;
 	bool option_anchor_outputs = channel_has(channel, OPT_ANCHOR_OUTPUTS);
 
-	gather_htlcs(tmpctx, channel, !channel->opener,
-		     &committed, &removing, &adding);
-
-	untrimmed = commit_tx_num_untrimmed(committed, feerate_per_kw, dust_limit,
-					    option_anchor_outputs,
-					    !channel->opener)
-			+ commit_tx_num_untrimmed(adding, feerate_per_kw, dust_limit,
-						  option_anchor_outputs,
-						  !channel->opener)
-			- commit_tx_num_untrimmed(removing, feerate_per_kw, dust_limit,
-						  option_anchor_outputs,
-						  !channel->opener);
+	htlc_trim_totals(channel, !channel->opener, feerate_per_kw,
+			 &untrimmed, &trimmed);
 
 	fee = commit_tx_base_fee(feerate_per_kw, untrimmed,
 				 option_anchor_outputs);
@@ -585,6 +585,635 @@ static void enable_notifications(int fd)
 	}
 }
 
+/* With --stream, we don't gather the whole response before printing it:
+ * we tokenize it as it arrives, and print the result as we go.  Memory
+ * used is bounded by nesting depth and the largest single string, not the
+ * size of the response, which matters for huge listpays/listforwards. */
+enum stream_event {
+	STREAM_OPEN_OBJECT,
+	STREAM_OPEN_ARRAY,
+	STREAM_CLOSE,
+	STREAM_KEY,
+	STREAM_SCALAR,
+};
+
+/* For scalars and keys, str is the full token (strings include quotes);
+ * depth is the number of containers enclosing this event. */
+typedef void (*stream_cb)(void *arg, enum stream_event ev, size_t depth,
+			  const char *str, size_t len, bool is_string);
+
+struct stream_lexer {
+	/* '{' or '[' for each currently open container */
+	char *stack;
+	/* The string or primitive we're in the middle of. */
+	char *tok;
+	bool in_string, escaped, in_primitive;
+	/* Next string in this object is a key */
+	bool want_key;
+	stream_cb cb;
+	void *arg;
+};
+
+static void stream_token_done(struct stream_lexer *lx, bool is_string)
+{
+	size_t depth = tal_count(lx->stack);
+
+	if (is_string && lx->want_key) {
+		lx->want_key = false;
+		lx->cb(lx->arg, STREAM_KEY, depth,
+		       lx->tok, tal_count(lx->tok), true);
+	} else
+		lx->cb(lx->arg, STREAM_SCALAR, depth,
+		       lx->tok, tal_count(lx->tok), is_string);
+	tal_resize(&lx->tok, 0);
+}
+
+static void stream_lex(struct stream_lexer *lx, char c)
+{
+	size_t depth;
+
+	if (lx->in_string) {
+		tal_arr_expand(&lx->tok, c);
+		if (lx->escaped)
+			lx->escaped = false;
+		else if (c == '\\')
+			lx->escaped = true;
+		else if (c == '"') {
+			lx->in_string = false;
+			stream_token_done(lx, true);
+		}
+		return;
+	}
+
+	if (lx->in_primitive) {
+		if (c != ',' && c != ':' && c != ']' && c != '}'
+		    && !cisspace(c)) {
+			tal_arr_expand(&lx->tok, c);
+			return;
+		}
+		lx->in_primitive = false;
+		stream_token_done(lx, false);
+	}
+
+	depth = tal_count(lx->stack);
+	switch (c) {
+	case ':':
+		return;
+	case ',':
+		lx->want_key = (depth && lx->stack[depth-1] == '{');
+		return;
+	case '{':
+	case '[':
+		lx->cb(lx->arg, c == '{' ? STREAM_OPEN_OBJECT : STREAM_OPEN_ARRAY,
+		       depth, NULL, 0, false);
+		tal_arr_expand(&lx->stack, c);
+		lx->want_key = (c == '{');
+		return;
+	case '}':
+	case ']':
+		if (!depth || lx->stack[depth-1] != (c == '}' ? '{' : '['))
+			errx(ERROR_TALKING_TO_LIGHTNINGD,
+			     "Malformed response: unexpected '%c'", c);
+		tal_resize(&lx->stack, depth - 1);
+		lx->want_key = false;
+		lx->cb(lx->arg, STREAM_CLOSE, depth - 1, NULL, 0, false);
+		return;
+	case '"':
+		lx->in_string = true;
+		break;
+	default:
+		if (cisspace(c))
+			return;
+		lx->in_primitive = true;
+		break;
+	}
+	tal_arr_expand(&lx->tok, c);
+}
+
+/* Printers are handed the events of the result (or error) alone, so
+ * depth here is relative to that. */
+struct stream_frame {
+	bool is_array;
+	/* Nothing printed in this container yet */
+	bool first;
+	/* FLAT: length of our path prefix, and array index */
+	size_t prefix_len, idx;
+	/* HUMAN: key of first member, if we haven't decided whether to
+	 * elide it yet. */
+	char *first_key;
+	bool elide;
+};
+
+/* A recorded event, for HUMAN lookahead */
+struct stream_saved {
+	enum stream_event ev;
+	char *str;
+	size_t len;
+	bool is_string;
+};
+
+/* Human mode elides the key of single-field objects, so we need to see
+ * what follows the first member.  We buffer at most this much before
+ * assuming that it is a single-field object after all. */
+#define HUMAN_LOOKAHEAD 65536
+
+struct stream_printer {
+	enum format format;
+	struct stream_frame *frames;
+	/* FLAT: current path */
+	char *prefix;
+	/* HUMAN: events of first member we're holding (if any) */
+	struct stream_saved *saved;
+	size_t saved_bytes, saved_depth;
+	bool saving;
+};
+
+static struct stream_frame *stream_top(struct stream_printer *sp)
+{
+	size_t n = tal_count(sp->frames);
+	return n ? &sp->frames[n-1] : NULL;
+}
+
+static void stream_push(struct stream_printer *sp, bool is_array)
+{
+	struct stream_frame f;
+
+	f.is_array = is_array;
+	f.first = true;
+	f.prefix_len = sp->prefix ? strlen(sp->prefix) : 0;
+	f.idx = 0;
+	f.first_key = NULL;
+	f.elide = false;
+	tal_arr_expand(&sp->frames, f);
+}
+
+static void stream_pop(struct stream_printer *sp)
+{
+	tal_free(stream_top(sp)->first_key);
+	tal_resize(&sp->frames, tal_count(sp->frames) - 1);
+}
+
+/* Strip the quotes from a string token */
+static const char *stream_content(const char *str, size_t *len,
+				  bool is_string)
+{
+	if (is_string) {
+		*len -= 2;
+		return str + 1;
+	}
+	return str;
+}
+
+/* Separator before a new member or element, as print_json does it. */
+static void json_stream_sep(struct stream_printer *sp)
+{
+	size_t depth = tal_count(sp->frames);
+	struct stream_frame *top = stream_top(sp);
+
+	if (!top)
+		return;
+	printf(top->first ? "\n%*s" : ",\n%*s", (int)depth * 3, "");
+	top->first = false;
+}
+
+static void json_stream_event(struct stream_printer *sp,
+			      enum stream_event ev,
+			      const char *str, size_t len, bool is_string)
+{
+	struct stream_frame *top = stream_top(sp);
+	bool closing_array;
+
+	switch (ev) {
+	case STREAM_KEY:
+		json_stream_sep(sp);
+		printf("%.*s: ", (int)len, str);
+		return;
+	case STREAM_SCALAR:
+		if (!top || top->is_array)
+			json_stream_sep(sp);
+		printf("%.*s", (int)len, str);
+		return;
+	case STREAM_OPEN_OBJECT:
+	case STREAM_OPEN_ARRAY:
+		if (!top || top->is_array)
+			json_stream_sep(sp);
+		printf("%c", ev == STREAM_OPEN_OBJECT ? '{' : '[');
+		stream_push(sp, ev == STREAM_OPEN_ARRAY);
+		return;
+	case STREAM_CLOSE:
+		closing_array = top->is_array;
+		if (top->first)
+			printf("%c", closing_array ? ']' : '}');
+		else
+			printf("\n%*s%c", (int)(tal_count(sp->frames) - 1) * 3,
+			       "", closing_array ? ']' : '}');
+		stream_pop(sp);
+		return;
+	}
+	abort();
+}
+
+static void raw_stream_event(struct stream_printer *sp,
+			     enum stream_event ev,
+			     const char *str, size_t len, bool is_string)
+{
+	struct stream_frame *top = stream_top(sp);
+
+	/* Values in objects follow their key; everything else needs a
+	 * comma if it's not first. */
+	if (top && (ev == STREAM_KEY || (top->is_array && ev != STREAM_CLOSE))) {
+		if (!top->first)
+			fputc(',', stdout);
+		top->first = false;
+	}
+
+	switch (ev) {
+	case STREAM_KEY:
+		printf("%.*s:", (int)len, str);
+		return;
+	case STREAM_SCALAR:
+		printf("%.*s", (int)len, str);
+		return;
+	case STREAM_OPEN_OBJECT:
+	case STREAM_OPEN_ARRAY:
+		fputc(ev == STREAM_OPEN_OBJECT ? '{' : '[', stdout);
+		stream_push(sp, ev == STREAM_OPEN_ARRAY);
+		return;
+	case STREAM_CLOSE:
+		fputc(top->is_array ? ']' : '}', stdout);
+		stream_pop(sp);
+		return;
+	}
+	abort();
+}
+
+static void flat_stream_event(struct stream_printer *sp,
+			      enum stream_event ev,
+			      const char *str, size_t len, bool is_string)
+{
+	struct stream_frame *top = stream_top(sp);
+
+	/* Array elements get their index appended to the path */
+	if (top && top->is_array && ev != STREAM_CLOSE) {
+		tal_resize(&sp->prefix, top->prefix_len + 1);
+		sp->prefix[top->prefix_len] = '\0';
+		tal_append_fmt(&sp->prefix, "[%zu]", top->idx++);
+	}
+
+	switch (ev) {
+	case STREAM_KEY:
+		str = stream_content(str, &len, is_string);
+		tal_resize(&sp->prefix, top->prefix_len + 1);
+		sp->prefix[top->prefix_len] = '\0';
+		if (top->prefix_len == 0)
+			tal_append_fmt(&sp->prefix, "%.*s", (int)len, str);
+		else
+			tal_append_fmt(&sp->prefix, ".%.*s", (int)len, str);
+		return;
+	case STREAM_SCALAR:
+		str = stream_content(str, &len, is_string);
+		printf("%s=%.*s\n", sp->prefix, (int)len, str);
+		return;
+	case STREAM_OPEN_OBJECT:
+	case STREAM_OPEN_ARRAY:
+		stream_push(sp, ev == STREAM_OPEN_ARRAY);
+		return;
+	case STREAM_CLOSE:
+		stream_pop(sp);
+		return;
+	}
+	abort();
+}
+
+/* Same translation as human_readable() */
+static void human_stream_str(const char *str, size_t len, char term)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (str[i] == '\\' && i + 1 < len) {
+			if (str[i+1] == 'n') {
+				fputc('\n', stdout);
+				i++;
+				continue;
+			} else if (str[i+1] == 't') {
+				fputc('\t', stdout);
+				i++;
+				continue;
+			}
+		}
+		fputc(str[i], stdout);
+	}
+	fputc(term, stdout);
+}
+
+static void human_stream_event(struct stream_printer *sp,
+			       enum stream_event ev,
+			       const char *str, size_t len, bool is_string);
+
+static void human_stream_replay(struct stream_printer *sp)
+{
+	struct stream_saved *saved = sp->saved;
+
+	/* Replaying may start saving again, for a nested object. */
+	sp->saved = NULL;
+	sp->saving = false;
+	for (size_t i = 0; i < tal_count(saved); i++)
+		human_stream_event(sp, saved[i].ev,
+				   saved[i].str, saved[i].len,
+				   saved[i].is_string);
+	tal_free(saved);
+}
+
+static void human_stream_save(struct stream_printer *sp,
+			      enum stream_event ev,
+			      const char *str, size_t len, bool is_string)
+{
+	struct stream_saved s;
+
+	s.ev = ev;
+	s.str = tal_dup_arr(sp->saved, char, str, len, 0);
+	s.len = len;
+	s.is_string = is_string;
+	tal_arr_expand(&sp->saved, s);
+	sp->saved_bytes += len;
+
+	if (ev == STREAM_OPEN_OBJECT || ev == STREAM_OPEN_ARRAY)
+		sp->saved_depth++;
+	else if (ev == STREAM_CLOSE)
+		sp->saved_depth--;
+
+	/* Value is complete: now we wait to see what follows it. */
+	if (sp->saved_depth == 0 && ev != STREAM_KEY)
+		sp->saving = false;
+	else if (sp->saved_bytes > HUMAN_LOOKAHEAD) {
+		/* Too big to hold: guess it's a wrapper object. */
+		stream_top(sp)->elide = true;
+		human_stream_replay(sp);
+	}
+}
+
+static void human_stream_event(struct stream_printer *sp,
+			       enum stream_event ev,
+			       const char *str, size_t len, bool is_string)
+{
+	struct stream_frame *top;
+
+	if (sp->saving) {
+		human_stream_save(sp, ev, str, len, is_string);
+		return;
+	}
+
+	top = stream_top(sp);
+	if (top && !top->is_array && !top->elide) {
+		if (ev == STREAM_KEY && !top->first_key && top->first) {
+			/* First member: hold it until we know if it's alone */
+			top->first_key = tal_dup_arr(sp->frames, char,
+						     str, len, 0);
+			sp->saved = tal_arr(sp->frames, struct stream_saved, 0);
+			sp->saved_bytes = sp->saved_depth = 0;
+			sp->saving = true;
+			return;
+		}
+		if (top->first_key) {
+			/* Another key: print first one, with its key. */
+			if (ev == STREAM_KEY) {
+				size_t klen = tal_count(top->first_key);
+				const char *k = stream_content(top->first_key,
+							       &klen, true);
+				human_stream_str(k, klen, '=');
+			} else
+				top->elide = true;
+			top->first = false;
+			top->first_key = tal_free(top->first_key);
+			human_stream_replay(sp);
+			/* Replay can't change our frame, but can move it */
+			top = stream_top(sp);
+		}
+	} else if (top && top->elide && ev == STREAM_KEY) {
+		/* We guessed wrong: it's not a single-field object */
+		top->elide = false;
+	}
+
+	switch (ev) {
+	case STREAM_KEY:
+		str = stream_content(str, &len, is_string);
+		human_stream_str(str, len, '=');
+		return;
+	case STREAM_SCALAR:
+		str = stream_content(str, &len, is_string);
+		human_stream_str(str, len, '\n');
+		return;
+	case STREAM_OPEN_OBJECT:
+	case STREAM_OPEN_ARRAY:
+		stream_push(sp, ev == STREAM_OPEN_ARRAY);
+		return;
+	case STREAM_CLOSE:
+		stream_pop(sp);
+		return;
+	}
+	abort();
+}
+
+static void stream_print(struct stream_printer *sp,
+			 enum stream_event ev,
+			 const char *str, size_t len, bool is_string)
+{
+	switch (sp->format) {
+	case HUMAN:
+		human_stream_event(sp, ev, str, len, is_string);
+		return;
+	case FLAT:
+		flat_stream_event(sp, ev, str, len, is_string);
+		return;
+	case RAW:
+		raw_stream_event(sp, ev, str, len, is_string);
+		return;
+	case JSON:
+	default:
+		json_stream_event(sp, ev, str, len, is_string);
+		return;
+	}
+}
+
+struct cli_stream {
+	struct stream_lexer lexer;
+	struct stream_printer printer;
+	/* Format for the result */
+	enum format format;
+	const char *idstr;
+	enum log_level notification_level;
+	bool last_was_progress;
+	/* The current message, until we know it's our response. */
+	char *msg;
+	/* Last top-level key, and "id" if we've seen it */
+	char *key, *id;
+	/* We're printing the result or error */
+	bool printing, printed, is_error;
+	/* Skipping result's "format-hint" (HUMAN only) */
+	bool skip_hint;
+	/* Got the whole response */
+	bool done;
+};
+
+static bool stream_keyeq(const char *str, size_t len, const char *key)
+{
+	return len == strlen(key) + 2 && memcmp(str + 1, key, len - 2) == 0;
+}
+
+static void stream_message_done(struct cli_stream *cs)
+{
+	jsmntok_t *toks;
+
+	/* We were printing it, so we're done. */
+	if (!cs->msg) {
+		cs->done = true;
+		return;
+	}
+
+	toks = json_parse_simple(cs->msg, cs->msg, tal_count(cs->msg));
+	if (!toks)
+		errx(ERROR_TALKING_TO_LIGHTNINGD,
+		     "Malformed response '%.*s'",
+		     (int)tal_count(cs->msg), cs->msg);
+	if (!handle_notify(cs->msg, toks, cs->notification_level,
+			   &cs->last_was_progress))
+		errx(ERROR_TALKING_TO_LIGHTNINGD,
+		     "Either 'result' or 'error' must be returned in response '%.*s'",
+		     (int)tal_count(cs->msg), cs->msg);
+	tal_free(toks);
+	tal_resize(&cs->msg, 0);
+	cs->key = tal_free(cs->key);
+	cs->id = tal_free(cs->id);
+}
+
+static void stream_event(void *arg, enum stream_event ev, size_t depth,
+			 const char *str, size_t len, bool is_string)
+{
+	struct cli_stream *cs = arg;
+
+	if (cs->printing) {
+		/* Error can be null, meaning no error. */
+		if (cs->is_error && depth == 1 && ev == STREAM_SCALAR
+		    && !is_string && len == 4 && memcmp(str, "null", 4) == 0) {
+			cs->printing = false;
+			cs->is_error = false;
+			cs->printer.format = cs->format;
+			return;
+		}
+		if (cs->skip_hint) {
+			if (depth == 2 && ev == STREAM_SCALAR)
+				cs->skip_hint = false;
+			return;
+		}
+		if (cs->printer.format == HUMAN && !cs->is_error
+		    && depth == 2 && ev == STREAM_KEY
+		    && stream_keyeq(str, len, "format-hint")) {
+			cs->skip_hint = true;
+			return;
+		}
+		stream_print(&cs->printer, ev, str, len, is_string);
+		if (depth == 1 && (ev == STREAM_SCALAR || ev == STREAM_CLOSE)) {
+			cs->printing = false;
+			cs->printed = true;
+			/* human and flat modes end each line themselves */
+			if (cs->printer.format == JSON
+			    || cs->printer.format == RAW)
+				printf("\n");
+		}
+		return;
+	}
+
+	if (depth == 0) {
+		if (ev == STREAM_CLOSE)
+			stream_message_done(cs);
+		else if (ev != STREAM_OPEN_OBJECT)
+			errx(ERROR_TALKING_TO_LIGHTNINGD,
+			     "Non-object response");
+		return;
+	}
+
+	/* We only care about top-level members (of our response) */
+	if (depth != 1 || cs->printed)
+		return;
+
+	if (ev == STREAM_KEY) {
+		tal_free(cs->key);
+		cs->key = tal_dup_arr(cs, char, str, len, 0);
+		if (!stream_keyeq(str, len, "result")
+		    && !stream_keyeq(str, len, "error"))
+			return;
+
+		/* lightningd puts "id" first, so we can check it now */
+		if (!cs->id)
+			errx(ERROR_TALKING_TO_LIGHTNINGD,
+			     "Missing 'id' in response '%.*s'",
+			     (int)tal_count(cs->msg), cs->msg);
+		if (!streq(cs->id, cs->idstr))
+			errx(ERROR_TALKING_TO_LIGHTNINGD,
+			     "Incorrect 'id' (%s) in response", cs->id);
+
+		if (cs->last_was_progress)
+			printf("\n");
+		cs->last_was_progress = false;
+
+		/* From here on, we don't keep the message. */
+		cs->msg = tal_free(cs->msg);
+		cs->printing = true;
+		cs->is_error = stream_keyeq(str, len, "error");
+		/* Errors are always printed as JSON (or raw) */
+		if (cs->is_error && cs->printer.format != RAW)
+			cs->printer.format = JSON;
+	} else if (ev == STREAM_SCALAR
+		   && cs->key && stream_keyeq(cs->key, tal_count(cs->key), "id")) {
+		size_t idlen = len;
+		const char *id = stream_content(str, &idlen, is_string);
+		tal_free(cs->id);
+		cs->id = tal_strndup(cs, id, idlen);
+	}
+}
+
+static int stream_response(const tal_t *ctx, int fd, const char *idstr,
+			   enum format format,
+			   enum log_level notification_level)
+{
+	struct cli_stream *cs = tal(ctx, struct cli_stream);
+	char buf[4096];
+
+	cs->lexer.stack = tal_arr(cs, char, 0);
+	cs->lexer.tok = tal_arr(cs, char, 0);
+	cs->lexer.in_string = cs->lexer.escaped = false;
+	cs->lexer.in_primitive = cs->lexer.want_key = false;
+	cs->lexer.cb = stream_event;
+	cs->lexer.arg = cs;
+	cs->format = cs->printer.format = format;
+	cs->printer.frames = tal_arr(cs, struct stream_frame, 0);
+	cs->printer.prefix = tal_strdup(cs, "");
+	cs->printer.saved = NULL;
+	cs->printer.saving = false;
+	cs->idstr = idstr;
+	cs->notification_level = notification_level;
+	cs->last_was_progress = false;
+	cs->msg = tal_arr(cs, char, 0);
+	cs->key = cs->id = NULL;
+	cs->printing = cs->printed = cs->is_error = false;
+	cs->skip_hint = false;
+	cs->done = false;
+
+	while (!cs->done) {
+		size_t n = read_nofail(fd, buf, sizeof(buf));
+
+		for (size_t i = 0; i < n && !cs->done; i++) {
+			if (cs->msg)
+				tal_arr_expand(&cs->msg, buf[i]);
+			stream_lex(&cs->lexer, buf[i]);
+		}
+	}
+
+	if (!cs->printed)
+		errx(ERROR_TALKING_TO_LIGHTNINGD,
+		     "Either 'result' or 'error' must be returned in response");
+	return cs->is_error ? ERROR_FROM_LIGHTNINGD : NO_ERROR;
+}
+
 static char *opt_set_level(const char *arg, enum log_level *level)
 {
 	if (streq(arg, "none"))
@@ -655,7 +1284,7 @@ int main(int argc, char *argv[])
 	enum format format = DEFAULT_FORMAT;
 	enum input input = DEFAULT_INPUT;
 	enum log_level notification_level = LOG_INFORM;
-	bool last_was_progress = false;
+	bool last_was_progress = false, stream = false;
 	char *command = NULL, *filter = NULL;
 	struct commando *commando = NULL;
 
@@ -680,6 +1309,9 @@ int main(int argc, char *argv[])
 			   "JSON output (default unless 'help')");
 	opt_register_noarg("-R|--raw", opt_set_raw, &format,
 			   "Raw, unformatted JSON output");
+	opt_register_noarg("-S|--stream", opt_set_bool, &stream,
+			   "Print the response as it arrives, rather than"
+			   " reading it all first");
 	opt_register_noarg("-k|--keywords", opt_set_keywords, &input,
 			   "Use format key=value for <params>");
 	opt_register_noarg("-o|--order", opt_set_ordered, &input,
@@ -828,6 +1460,17 @@ int main(int argc, char *argv[])
 	if (!write_all(fd, cmd, strlen(cmd)))
 		err(ERROR_TALKING_TO_LIGHTNINGD, "Writing command");
 
+	/* We need the whole thing to sort the help list. */
+	if (stream
+	    && !(format == DEFAULT_FORMAT && streq(method, "help") && !command)) {
+		int ret = stream_response(ctx, fd, idstr,
+					  format == DEFAULT_FORMAT ? JSON : format,
+					  notification_level);
+		tal_free(ctx);
+		opt_free_table();
+		return ret;
+	}
+
 	/* Start with 1000 characters, 100 tokens. */
 	resp = tal_arr(ctx, char, 1000);
 	toks = tal_arr(ctx, jsmntok_t, 100);
@@ -900,6 +900,49 @@ struct bolt11 *bolt11_decode_nosig(const tal_t *ctx, const char *str,
 	return b11;
 }
 
+/* We (and plugins like pay) decode the same invoices over and over:
+ * remember the last few signatures we checked, so we can skip the
+ * secp256k1 recover/verify.  The hash and signature are exactly what
+ * the check depends on, so a hit gives the same answer. */
+struct sig_cache_entry {
+	bool valid;
+	struct sha256 hash;
+	u8 sig_and_recid[65];
+	struct node_id id;
+};
+static struct sig_cache_entry sig_cache[64];
+
+static struct sig_cache_entry *sig_cache_slot(const struct sha256 *hash)
+{
+	/* hash is a sha256 already: any bits will do as an index */
+	return &sig_cache[hash->u.u32[0] % ARRAY_SIZE(sig_cache)];
+}
+
+static const struct node_id *sig_cache_get(const struct sha256 *hash,
+					   const u8 sig_and_recid[65])
+{
+	const struct sig_cache_entry *e = sig_cache_slot(hash);
+
+	if (!e->valid
+	    || !sha256_eq(&e->hash, hash)
+	    || memcmp(e->sig_and_recid, sig_and_recid,
+		      sizeof(e->sig_and_recid)) != 0)
+		return NULL;
+	return &e->id;
+}
+
+static void sig_cache_add(const struct sha256 *hash,
+			  const u8 sig_and_recid[65],
+			  const struct node_id *id)
+{
+	struct sig_cache_entry *e = sig_cache_slot(hash);
+
+	e->valid = true;
+	e->hash = *hash;
+	memcpy(e->sig_and_recid, sig_and_recid, sizeof(e->sig_and_recid));
+	e->id = *id;
+}
+
 /* Decodes and checks signature; returns NULL on error. */
 struct bolt11 *bolt11_decode(const tal_t *ctx, const char *str,
 			     const struct feature_set *our_features,
@@ -915,6 +958,7 @@ struct bolt11 *bolt11_decode(const tal_t *ctx, const char *str,
 	struct sha256 hash;
 	bool have_n;
 	const char *err;
+	const struct node_id *cached_id;
 
 	b11 = bolt11_decode_nosig(ctx, str, our_features, description,
 				  must_be_chain, &hash, &sigdata, &have_n,
@@ -954,7 +998,13 @@ struct bolt11 *bolt11_decode(const tal_t *ctx, const char *str,
 	 * MUST use the `n` field to validate the signature instead of
 	 * performing signature recovery.
 	 */
-	if (!have_n) {
+	cached_id = sig_cache_get(&hash, sig_and_recid);
+	if (cached_id) {
+		if (!have_n)
+			b11->receiver_id = *cached_id;
+		else if (!node_id_eq(&b11->receiver_id, cached_id))
+			return decode_fail(b11, fail, "invalid signature");
+	} else if (!have_n) {
 		struct pubkey k;
 		if (!secp256k1_ecdsa_recover(secp256k1_ctx,
 					     &k.pubkey,
@@ -974,6 +1024,8 @@ struct bolt11 *bolt11_decode(const tal_t *ctx, const char *str,
 			return decode_fail(b11, fail, "invalid signature");
 	}
 
+	if (!cached_id)
+		sig_cache_add(&hash, sig_and_recid, &b11->receiver_id);
 	return b11;
 }
 
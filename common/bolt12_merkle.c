@@ -1,7 +1,6 @@
 #include "config.h"
 #include <assert.h>
-#include <ccan/cast/cast.h>
-#include <ccan/ilog/ilog.h>
+#include <ccan/array_size/array_size.h>
 #include <ccan/mem/mem.h>
 #include <common/bolt12_merkle.h>
 
@@ -95,13 +94,12 @@ static void calc_nonce(const struct sha256_ctx *lnnonce_ctx,
 	SUPERVERBOSE(") = %s\n", type_to_string(tmpctx, struct sha256, hash));
 }
 
-static void calc_lnleaf(const struct tlv_field *field, struct sha256 *hash)
+static void calc_lnleaf(const struct sha256_ctx *lnleaf_ctx,
+			const struct tlv_field *field, struct sha256 *hash)
 {
-	struct sha256_ctx sctx;
+	struct sha256_ctx sctx = *lnleaf_ctx;
 
-	SUPERVERBOSE("leaf: H(");
-	h_simpletag_ctx(&sctx, "LnLeaf");
-	SUPERVERBOSE(",");
+	SUPERVERBOSE("leaf: H(LnLeaf,");
 	sha256_update_tlvfield(&sctx, field);
 	sha256_done(&sctx, hash);
 	SUPERVERBOSE(") -> %s\n", type_to_string(tmpctx, struct sha256, hash));
@@ -110,86 +108,94 @@ static void calc_lnleaf(const struct tlv_field *field, struct sha256 *hash)
 /* BOLT-offers #12:
  * The Merkle tree inner nodes are H("LnBranch", lesser-SHA256||greater-SHA256)
  */
-static struct sha256 *merkle_pair(const tal_t *ctx,
-				  const struct sha256 *a, const struct sha256 *b)
+/* res may be a or b. */
+static void merkle_pair(const struct sha256_ctx *lnbranch_ctx,
+			const struct sha256 *a, const struct sha256 *b,
+			struct sha256 *res)
 {
-	struct sha256 *res;
-	struct sha256_ctx sctx;
+	struct sha256_ctx sctx = *lnbranch_ctx;
 
 	/* Make sure a < b */
-	if (memcmp(a->u.u8, b->u.u8, sizeof(a->u.u8)) > 0)
-		return merkle_pair(ctx, b, a);
+	if (memcmp(a->u.u8, b->u.u8, sizeof(a->u.u8)) > 0) {
+		const struct sha256 *tmp = a;
+		a = b;
+		b = tmp;
+	}
 
-	SUPERVERBOSE("branch: H(");
-	h_simpletag_ctx(&sctx, "LnBranch");
-	SUPERVERBOSE(",%s %s",
+	SUPERVERBOSE("branch: H(LnBranch,%s %s",
 		     tal_hexstr(tmpctx, a->u.u8, sizeof(a->u.u8)),
 		     tal_hexstr(tmpctx, b->u.u8, sizeof(b->u.u8)));
 	sha256_update(&sctx, a->u.u8, sizeof(a->u.u8));
 	sha256_update(&sctx, b->u.u8, sizeof(b->u.u8));
-
-	res = tal(ctx, struct sha256);
 	sha256_done(&sctx, res);
 	SUPERVERBOSE(") -> %s\n", type_to_string(tmpctx, struct sha256, res));
-	return res;
 }
 
-static const struct sha256 *merkle_recurse(const struct sha256 **base,
-					   const struct sha256 **arr, size_t len)
+/* The tree is a power-of-2 tree with the leaves on the left, where a
+ * branch with an empty right side is just its left side.  So, like a
+ * binary counter, we only need to keep one pending left subtree per
+ * level while we stream the leaves through: no allocations needed. */
+struct merkle_frontier {
+	struct sha256_ctx lnbranch_ctx;
+	/* Bit n is set if level[n] holds a subtree of 2^n leaves */
+	u64 occupied;
+	struct sha256 level[64];
+};
+
+static void merkle_add(struct merkle_frontier *f, struct sha256 *node)
+{
+	size_t n;
+
+	for (n = 0; f->occupied & (1ULL << n); n++) {
+		merkle_pair(&f->lnbranch_ctx, &f->level[n], node, node);
+		f->occupied &= ~(1ULL << n);
+	}
+	f->level[n] = *node;
+	f->occupied |= (1ULL << n);
+}
+
+/* Returns false if there were no leaves at all */
+static bool merkle_finish(struct merkle_frontier *f, struct sha256 *root)
 {
-	const struct sha256 *left, *right;
-	if (len == 1)
-		return arr[0];
-
-	SUPERVERBOSE("Merkle recurse [%zu - %zu] and [%zu - %zu]\n",
-		     arr - base, arr + len / 2 - 1 - base,
-		     arr + len / 2 - base, arr + len - 1 - base);
-	left = merkle_recurse(base, arr, len / 2);
-	right = merkle_recurse(base, arr + len / 2, len / 2);
-	/* left is never NULL if right is not NULL */
-	if (!right) {
-		SUPERVERBOSE("[%zu - %zu] is NULL!\n",
-			     arr + len / 2 - base, arr + len - base);
-		return left;
+	bool have_root = false;
+
+	/* Combine leftover subtrees, smallest (rightmost) first. */
+	for (size_t n = 0; n < ARRAY_SIZE(f->level); n++) {
+		if (!(f->occupied & (1ULL << n)))
+			continue;
+		if (have_root)
+			merkle_pair(&f->lnbranch_ctx, &f->level[n], root, root);
+		else
+			*root = f->level[n];
+		have_root = true;
 	}
-	return merkle_pair(base, left, right);
+	return have_root;
 }
 
-/* This is not the fastest way, but it is the most intuitive. */
 void merkle_tlv(const struct tlv_field *fields, struct sha256 *merkle)
 {
-	struct sha256 **arr;
-	struct sha256_ctx lnnonce_ctx;
-	size_t n;
+	struct sha256_ctx lnnonce_ctx, lnleaf_ctx;
+	struct merkle_frontier frontier;
 
 	SUPERVERBOSE("nonce tag:");
 	h_lnnonce_ctx(&lnnonce_ctx, fields);
+	h_simpletag_ctx(&lnleaf_ctx, "LnLeaf");
+	h_simpletag_ctx(&frontier.lnbranch_ctx, "LnBranch");
+	frontier.occupied = 0;
 
-	/* We build an oversized power-of-2 symmentic tree, but with
-	 * NULL nodes at the end.  When we recurse, we pass through
-	 * NULL.  This is less efficient than calculating the
-	 * power-of-2 split as we recurse, but simpler. */
-	arr = tal_arrz(NULL, struct sha256 *,
-		       1ULL << (ilog64(tal_count(fields)) + 1));
-
-	n = 0;
 	for (size_t i = 0; i < tal_count(fields); i++) {
 		struct sha256 leaf, nonce;
 		if (is_signature_field(&fields[i]))
 			continue;
-		calc_lnleaf(&fields[i], &leaf);
+		calc_lnleaf(&lnleaf_ctx, &fields[i], &leaf);
 		calc_nonce(&lnnonce_ctx, &fields[i], &nonce);
-		arr[n++] = merkle_pair(arr, &leaf, &nonce);
+		merkle_pair(&frontier.lnbranch_ctx, &leaf, &nonce, &leaf);
+		merkle_add(&frontier, &leaf);
 	}
 
 	/* This should never happen, but define it a distinctive all-zeroes */
-	if (n == 0)
+	if (!merkle_finish(&frontier, merkle))
 		memset(merkle, 0, sizeof(*merkle));
-	else
-		*merkle = *merkle_recurse(cast_const2(const struct sha256 **, arr),
-					  cast_const2(const struct sha256 **, arr),
-					  tal_count(arr));
-	tal_free(arr);
 }
 
 /* BOLT-offers #12:
@@ -3,6 +3,7 @@
 #include <ccan/crypto/hkdf_sha256/hkdf_sha256.h>
 #include <ccan/mem/mem.h>
 #include <common/cryptomsg.h>
+#include <common/trace_probe.h>
 #include <sodium/crypto_aead_chacha20poly1305.h>
 #include <wire/wire_io.h>
 
@@ -93,6 +94,7 @@ u8 *cryptomsg_decrypt_body(const tal_t *ctx,
 
 	if (inlen < 16)
 		return NULL;
+	TRACE_PROBE1(cryptomsg_decrypt_start, inlen);
 	decrypted = tal_arr(ctx, u8, inlen - 16);
 
 	le64_nonce(npub, cs->rn++);
@@ -110,11 +112,13 @@ u8 *cryptomsg_decrypt_body(const tal_t *ctx,
 						      NULL, 0,
 						      npub, cs->rk.data) != 0) {
 		/* FIXME: Report error! */
+		TRACE_PROBE1(cryptomsg_decrypt_end, false);
 		return tal_free(decrypted);
 	}
 	assert(mlen == tal_count(decrypted));
 
 	maybe_rotate_key(&cs->rn, &cs->rk, &cs->r_ck);
+	TRACE_PROBE1(cryptomsg_decrypt_end, true);
 	return decrypted;
 }
 
@@ -148,17 +152,20 @@ bool cryptomsg_decrypt_header(struct crypto_state *cs, u8 hdr[18], u16 *lenp)
 	return true;
 }
 
-u8 *cryptomsg_encrypt_msg(const tal_t *ctx,
-			  struct crypto_state *cs,
-			  const u8 *msg TAKES)
+void cryptomsg_encrypt_msg_append(struct crypto_state *cs,
+				  const u8 *msg TAKES,
+				  u8 **outp)
 {
 	unsigned char npub[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
 	unsigned long long clen, mlen = tal_count(msg);
+	size_t off = tal_count(*outp);
 	be16 l;
 	int ret;
 	u8 *out;
 
-	out = tal_arr(ctx, u8, sizeof(l) + 16 + mlen + 16);
+	TRACE_PROBE1(cryptomsg_encrypt_start, mlen);
+	tal_resize(outp, off + sizeof(l) + 16 + mlen + 16);
+	out = *outp + off;
 
 	/* BOLT #8:
 	 *
@@ -229,8 +236,18 @@ u8 *cryptomsg_encrypt_msg(const tal_t *ctx,
 #endif
 
 	maybe_rotate_key(&cs->sn, &cs->sk, &cs->s_ck);
+	TRACE_PROBE(cryptomsg_encrypt_end);
 
 	if (taken(msg))
 		tal_free(msg);
+}
+
+u8 *cryptomsg_encrypt_msg(const tal_t *ctx,
+			  struct crypto_state *cs,
+			  const u8 *msg TAKES)
+{
+	u8 *out = tal_arr(ctx, u8, 0);
+
+	cryptomsg_encrypt_msg_append(cs, msg, &out);
 	return out;
 }
@@ -25,6 +25,10 @@
 u8 *cryptomsg_encrypt_msg(const tal_t *ctx,
 			  struct crypto_state *cs,
 			  const u8 *msg);
+/* Same, but appends to *out (so many messages can be written at once). */
+void cryptomsg_encrypt_msg_append(struct crypto_state *cs,
+				  const u8 *msg TAKES,
+				  u8 **out);
 bool cryptomsg_decrypt_header(struct crypto_state *cs, u8 hdr[18], u16 *lenp);
 u8 *cryptomsg_decrypt_body(const tal_t *ctx,
 			   struct crypto_state *cs, const u8 *in);
@@ -11,6 +11,7 @@
 #include <common/utils.h>
 #include <common/version.h>
 #include <signal.h>
+#include <sys/time.h>
 
 #if BACKTRACE_SUPPORTED
 static void (*bt_print)(const char *fmt, ...) PRINTF_FMT(1,2);
@@ -120,6 +121,128 @@ static void remove_steal_notifiers(void)
 	/* We remove this from root, assuming everything else freed. */
 	tal_del_notifier(NULL, add_steal_notifier);
 }
+
+/* If $LIGHTNINGD_DEV_PROFILE is a directory, we sample our stack
+ * PROFILE_HZ times per second of CPU time, and on exit write the
+ * samples there as collapsed stacks (as used by flamegraph.pl). */
+#define PROFILE_HZ 100
+#define PROFILE_DEPTH 32
+/* After this many, we overwrite the oldest. */
+#define PROFILE_MAX_SAMPLES 65536
+
+struct profile_sample {
+	size_t depth;
+	uintptr_t pc[PROFILE_DEPTH];
+};
+
+static struct profile_sample *profile_samples;
+static size_t profile_num_samples;
+static char *profile_filename;
+
+static int profile_add_pc(void *data, uintptr_t pc)
+{
+	struct profile_sample *sample = data;
+
+	if (sample->depth == PROFILE_DEPTH)
+		return 1;
+	sample->pc[sample->depth++] = pc;
+	return 0;
+}
+
+static void profile_error(void *data UNUSED, const char *msg UNUSED,
+			  int errnum UNUSED)
+{
+}
+
+/* This is a signal handler: backtrace_simple only unwinds, it doesn't
+ * allocate or symbolize. */
+static void profile_sample(int sig UNUSED)
+{
+	struct profile_sample *sample;
+
+	sample = &profile_samples[profile_num_samples % PROFILE_MAX_SAMPLES];
+	sample->depth = 0;
+	/* Skip ourselves. */
+	backtrace_simple(backtrace_state, 1, profile_add_pc, profile_error,
+			 sample);
+	profile_num_samples++;
+}
+
+static int profile_add_function(void *data, uintptr_t pc UNUSED,
+				const char *filename UNUSED, int lineno UNUSED,
+				const char *function)
+{
+	const char ***names = data;
+
+	tal_arr_expand(names, function ? function : "??");
+	return 0;
+}
+
+static void profile_write(void)
+{
+	struct itimerval stop;
+	size_t num;
+	FILE *f;
+
+	/* No more samples while we write. */
+	memset(&stop, 0, sizeof(stop));
+	setitimer(ITIMER_PROF, &stop, NULL);
+
+	f = fopen(profile_filename, "w");
+	if (!f) {
+		warn("Writing profile %s", profile_filename);
+		return;
+	}
+
+	num = profile_num_samples;
+	if (num > PROFILE_MAX_SAMPLES)
+		num = PROFILE_MAX_SAMPLES;
+	for (size_t i = 0; i < num; i++) {
+		const struct profile_sample *sample = &profile_samples[i];
+		/* Innermost (and inlined) functions first. */
+		const char **names = tal_arr(NULL, const char *, 0);
+
+		for (size_t d = 0; d < sample->depth; d++)
+			backtrace_pcinfo(backtrace_state, sample->pc[d],
+					 profile_add_function, profile_error,
+					 &names);
+		if (tal_count(names) == 0)
+			continue;
+		for (size_t n = tal_count(names); n > 0; n--)
+			fprintf(f, "%s%s", names[n-1], n == 1 ? " 1\n" : ";");
+		tal_free(names);
+	}
+	fclose(f);
+}
+
+static void profile_activate(const char *argv0, const char *dir)
+{
+	struct sigaction sa;
+	struct itimerval timer;
+	const char *name = strrchr(argv0, '/');
+
+	/* We need libbacktrace to unwind. */
+	if (!backtrace_state)
+		return;
+
+	profile_filename = notleak(tal_fmt(NULL, "%s/%s-%u.folded",
+					   dir, name ? name + 1 : argv0,
+					   getpid()));
+	profile_samples = notleak(tal_arrz(NULL, struct profile_sample,
+					   PROFILE_MAX_SAMPLES));
+
+	sa.sa_handler = profile_sample;
+	sigemptyset(&sa.sa_mask);
+	/* Don't make sync reads and writes fail with EINTR */
+	sa.sa_flags = SA_RESTART;
+	sigaction(SIGPROF, &sa, NULL);
+
+	timer.it_interval.tv_sec = 0;
+	timer.it_interval.tv_usec = 1000000 / PROFILE_HZ;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_PROF, &timer, NULL);
+	atexit(profile_write);
+}
 #endif
 
 void daemon_setup(const char *argv0,
@@ -135,6 +258,8 @@ void daemon_setup(const char *argv0,
 	if (!getenv("LIGHTNINGD_DEV_NO_BACKTRACE"))
 		backtrace_state = backtrace_create_state(argv0, 0, NULL, NULL);
 	add_steal_notifiers(NULL);
+	if (getenv("LIGHTNINGD_DEV_PROFILE"))
+		profile_activate(argv0, getenv("LIGHTNINGD_DEV_PROFILE"));
 #else
 	backtrace_state = backtrace_create_state(argv0, 0, NULL, NULL);
 #endif
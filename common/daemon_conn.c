@@ -67,16 +67,24 @@ struct io_plan *daemon_conn_read_with_fd_(struct io_conn *conn,
 static struct io_plan *daemon_conn_write_next(struct io_conn *conn,
 					      struct daemon_conn *dc)
 {
-	const u8 *msg;
+	const u8 *msg = NULL, **msgs;
 
-	msg = msg_dequeue(dc->out);
+	/* Send everything up to the next fd in one go. */
+	msgs = msg_dequeue_batch(NULL, dc->out);
+	if (!msgs)
+		msg = msg_dequeue(dc->out);
 
 	/* If nothing in queue, give empty callback a chance to queue somthing */
-	if (!msg && dc->outq_empty) {
+	if (!msgs && !msg && dc->outq_empty) {
 		dc->outq_empty(dc->arg);
-		msg = msg_dequeue(dc->out);
+		msgs = msg_dequeue_batch(NULL, dc->out);
+		if (!msgs)
+			msg = msg_dequeue(dc->out);
 	}
 
+	if (msgs)
+		return io_write_wire_batch(conn, take(msgs),
+					   daemon_conn_write_next, dc);
 	if (msg) {
 		int fd = msg_extract_fd(dc->out, msg);
 		if (fd >= 0) {
@@ -51,6 +51,11 @@ void dev_disconnect_init(int fd)
 	dev_disconnect_fd = fd;
 }
 
+bool dev_disconnect_active(void)
+{
+	return dev_disconnect_fd != -1;
+}
+
 enum dev_disconnect dev_disconnect(const struct node_id *id, int pkt_type)
 {
 	if (dev_disconnect_fd == -1)
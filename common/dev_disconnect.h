@@ -22,6 +22,9 @@ enum dev_disconnect {
 /* Force a close fd before or after a certain packet type */
 enum dev_disconnect dev_disconnect(const struct node_id *id, int pkt_type);
 
+/* Is there a dev_disconnect file at all? */
+bool dev_disconnect_active(void);
+
 /* Make next write on fd fail as if they'd disconnected. */
 void dev_sabotage_fd(int fd, bool close_fd);
 
@@ -4,6 +4,7 @@
 #include <ccan/cast/cast.h>
 #include <common/dijkstra.h>
 #include <common/gossmap.h>
+#include <common/trace_probe.h>
 #include <gheap.h>
 
 /* Each node has this side-info. */
@@ -119,38 +120,174 @@ static struct amount_msat risk_price(struct amount_msat amount,
 	return riskfee;
 }
 
-/* Do Dijkstra: start in this case is the dst node. */
-const struct dijkstra *
-dijkstra_(const tal_t *ctx,
-	  const struct gossmap *map,
-	  const struct gossmap_node *start,
-	  struct amount_msat amount,
-	  double riskfactor,
-	  bool (*channel_ok)(const struct gossmap *map,
-			     const struct gossmap_chan *c,
-			     int dir,
-			     struct amount_msat amount,
-			     void *arg),
-	  u64 (*path_score)(u32 distance,
-			    struct amount_msat cost,
-			    struct amount_msat risk,
-			    int dir,
-			    const struct gossmap_chan *c),
-	  void *arg)
+static void init_gheap_ctx(struct gheap_ctx *gheap_ctx)
+{
+	/* There doesn't seem to be much difference with fanout 2-4. */
+	gheap_ctx->fanout = 2;
+	/* There seems to be a slight decrease if we alter this value. */
+	gheap_ctx->page_chunks = 1;
+	gheap_ctx->item_size = sizeof(struct gossmap_node *);
+	gheap_ctx->less_comparer = less_comparer;
+	gheap_ctx->less_comparer_ctx = NULL;
+	gheap_ctx->item_mover = item_mover;
+}
+
+/* Try to improve d (neighbor) by going through c to cur_d.  dir is the
+ * direction from neighbor to cur, and h is c->half[dir] (or a copy). */
+static bool relax(const struct gossmap *map,
+		  const struct dijkstra *cur_d,
+		  struct dijkstra *d,
+		  struct gossmap_chan *c,
+		  int dir,
+		  const struct half_chan *h,
+		  double riskfactor,
+		  bool (*channel_ok)(const struct gossmap *map,
+				     const struct gossmap_chan *c,
+				     int dir,
+				     struct amount_msat amount,
+				     void *arg),
+		  u64 (*path_score)(u32 distance,
+				    struct amount_msat cost,
+				    struct amount_msat risk,
+				    int dir,
+				    const struct gossmap_chan *c),
+		  void *arg)
+{
+	struct amount_msat cost, risk;
+	u64 score;
+
+	if (!channel_ok(map, c, dir, cur_d->cost, arg))
+		return false;
+
+	cost = cur_d->cost;
+	if (!amount_msat_add_fee(&cost, h->base_fee, h->proportional_fee))
+		/* Shouldn't happen! */
+		return false;
+
+	/* cltv_delay can't overflow: only 20 bits per hop. */
+	risk = risk_price(cost, riskfactor, cur_d->total_delay + h->delay);
+	score = path_score(cur_d->distance + 1, cost, risk, dir, c);
+	if (score >= d->score)
+		return false;
+
+	d->distance = cur_d->distance + 1;
+	d->total_delay = cur_d->total_delay + h->delay;
+	d->cost = cost;
+	d->best_chan = c;
+	d->score = score;
+	return true;
+}
+
+/* Steps 3 to 6 below: consume the heap until we run out of reachable nodes
+ * (or we visit stop, if non-NULL).  Nodes not in the heap must have heapptr
+ * NULL (i.e. already visited). */
+static void dijkstra_run(struct dijkstra *dij,
+			 const struct gossmap *map,
+			 const struct gossmap_node **heap,
+			 size_t heapsize,
+			 const struct gossmap_node *stop,
+			 const struct gheap_ctx *gheap_ctx,
+			 double riskfactor,
+			 bool (*channel_ok)(const struct gossmap *map,
+					    const struct gossmap_chan *c,
+					    int dir,
+					    struct amount_msat amount,
+					    void *arg),
+			 u64 (*path_score)(u32 distance,
+					   struct amount_msat cost,
+					   struct amount_msat risk,
+					   int dir,
+					   const struct gossmap_chan *c),
+			 void *arg)
+{
+	while (heapsize != 0) {
+		struct dijkstra *cur_d;
+		const struct gossmap_node *cur = heap[0];
+		const struct gossmap_edge *edges;
+
+		cur_d = get_dijkstra(dij, map, cur);
+		assert(cur_d->heapptr == heap);
+
+		/* Finished all reachable nodes */
+		if (cur_d->distance == UINT_MAX)
+			break;
+
+		/* Nothing can improve on this from here. */
+		if (cur == stop) {
+			cur_d->heapptr = NULL;
+			break;
+		}
+
+		/* If we have them, edges avoid chasing through node->chan_idxs
+		 * and the neighbor. */
+		edges = gossmap_node_edges(map, cur);
+		for (size_t i = 0; i < cur->num_chans; i++) {
+			int dir;
+			struct gossmap_chan *c;
+			const struct half_chan *h;
+			struct dijkstra *d;
+
+			if (edges) {
+				dir = edges[i].dir;
+				h = &edges[i].half;
+				d = dij + h->nodeidx;
+				/* Ignore if already visited. */
+				if (!d->heapptr)
+					continue;
+				c = gossmap_chan_byidx(map, edges[i].chan_idx);
+			} else {
+				int which_half;
+				c = gossmap_nth_chan(map, cur, i, &which_half);
+				/* We're going from neighbor to c, hence
+				 * !which_half */
+				dir = !which_half;
+				h = &c->half[dir];
+				d = get_dijkstra(dij, map,
+						 gossmap_nth_node(map, c, dir));
+				/* Ignore if already visited. */
+				if (!d->heapptr)
+					continue;
+			}
+
+			if (!relax(map, cur_d, d, c, dir, h, riskfactor,
+				   channel_ok, path_score, arg))
+				continue;
+
+			gheap_restore_heap_after_item_increase(gheap_ctx,
+							       heap, heapsize,
+							       d->heapptr - heap);
+		}
+		gheap_pop_heap(gheap_ctx, heap, heapsize--);
+		cur_d->heapptr = NULL;
+	}
+}
+
+static const struct dijkstra *
+dijkstra_until(const tal_t *ctx,
+	       const struct gossmap *map,
+	       const struct gossmap_node *start,
+	       const struct gossmap_node *stop,
+	       struct amount_msat amount,
+	       double riskfactor,
+	       bool (*channel_ok)(const struct gossmap *map,
+				  const struct gossmap_chan *c,
+				  int dir,
+				  struct amount_msat amount,
+				  void *arg),
+	       u64 (*path_score)(u32 distance,
+				 struct amount_msat cost,
+				 struct amount_msat risk,
+				 int dir,
+				 const struct gossmap_chan *c),
+	       void *arg)
 {
 	struct dijkstra *dij;
 	const struct gossmap_node **heap;
-	size_t heapsize;
 	struct gheap_ctx gheap_ctx;
 
-	/* There doesn't seem to be much difference with fanout 2-4. */
-	gheap_ctx.fanout = 2;
-	/* There seems to be a slight decrease if we alter this value. */
-	gheap_ctx.page_chunks = 1;
-	gheap_ctx.item_size = sizeof(*heap);
-	gheap_ctx.less_comparer = less_comparer;
-	gheap_ctx.less_comparer_ctx = NULL;
-	gheap_ctx.item_mover = item_mover;
+	TRACE_PROBE2(dijkstra_start, gossmap_max_node_idx(map),
+		     amount.millisatoshis); /* Raw: tracing */
+	init_gheap_ctx(&gheap_ctx);
 
 	dij = tal_arr(ctx, struct dijkstra, gossmap_max_node_idx(map));
 
@@ -172,7 +309,6 @@ dijkstra_(const tal_t *ctx,
 	 * initial node as current.[14]
 	 */
 	heap = mkheap(NULL, dij, map, start, amount);
-	heapsize = tal_count(heap);
 
 	/*
 	 * 3. For the current node, consider all of its unvisited neighbouds
@@ -200,65 +336,213 @@ dijkstra_(const tal_t *ctx,
 	 * smallest tentative distance, set it as the new "current node", and
 	 * go back to step 3.
 	 */
-	while (heapsize != 0) {
-		struct dijkstra *cur_d;
-		const struct gossmap_node *cur = heap[0];
+	dijkstra_run(dij, map, heap, tal_count(heap), stop, &gheap_ctx,
+		     riskfactor, channel_ok, path_score, arg);
+	tal_free(heap);
+	TRACE_PROBE(dijkstra_end);
+	return dij;
+}
 
-		cur_d = get_dijkstra(dij, map, cur);
-		assert(cur_d->heapptr == heap);
+/* Do Dijkstra: start in this case is the dst node. */
+const struct dijkstra *
+dijkstra_(const tal_t *ctx,
+	  const struct gossmap *map,
+	  const struct gossmap_node *start,
+	  struct amount_msat amount,
+	  double riskfactor,
+	  bool (*channel_ok)(const struct gossmap *map,
+			     const struct gossmap_chan *c,
+			     int dir,
+			     struct amount_msat amount,
+			     void *arg),
+	  u64 (*path_score)(u32 distance,
+			    struct amount_msat cost,
+			    struct amount_msat risk,
+			    int dir,
+			    const struct gossmap_chan *c),
+	  void *arg)
+{
+	return dijkstra_until(ctx, map, start, NULL, amount, riskfactor,
+			      channel_ok, path_score, arg);
+}
 
-		/* Finished all reachable nodes */
-		if (cur_d->distance == UINT_MAX)
-			break;
+const struct dijkstra *
+dijkstra_to_(const tal_t *ctx,
+	     const struct gossmap *map,
+	     const struct gossmap_node *start,
+	     const struct gossmap_node *stop,
+	     struct amount_msat amount,
+	     double riskfactor,
+	     bool (*channel_ok)(const struct gossmap *map,
+				const struct gossmap_chan *c,
+				int dir,
+				struct amount_msat amount,
+				void *arg),
+	     u64 (*path_score)(u32 distance,
+			       struct amount_msat cost,
+			       struct amount_msat risk,
+			       int dir,
+			       const struct gossmap_chan *c),
+	     void *arg)
+{
+	return dijkstra_until(ctx, map, start, stop, amount, riskfactor,
+			      channel_ok, path_score, arg);
+}
 
-		for (size_t i = 0; i < cur->num_chans; i++) {
+enum repair_state {
+	REPAIR_UNKNOWN,
+	REPAIR_VALID,
+	REPAIR_INVALID,
+};
+
+/* What can we tell about this node from its own best_chan?  If it
+ * depends on the parent, returns REPAIR_UNKNOWN and sets *parent. */
+static enum repair_state node_repair_state(const struct dijkstra *dij,
+					   const struct gossmap *map,
+					   u32 idx,
+					   u32 *parent,
+					   bool (*channel_ok)(const struct gossmap *map,
+							      const struct gossmap_chan *c,
+							      int dir,
+							      struct amount_msat amount,
+							      void *arg),
+					   void *arg)
+{
+	const struct gossmap_chan *c;
+	int dir;
+
+	/* Start node, or never reached at all: removing channels can't
+	 * change that. */
+	if (dij[idx].distance == 0 || dij[idx].distance == UINT_MAX)
+		return REPAIR_VALID;
+
+	c = dij[idx].best_chan;
+	if (c->half[0].nodeidx == idx)
+		dir = 0;
+	else {
+		assert(c->half[1].nodeidx == idx);
+		dir = 1;
+	}
+	*parent = c->half[!dir].nodeidx;
+	if (!channel_ok(map, c, dir, dij[*parent].cost, arg))
+		return REPAIR_INVALID;
+	return REPAIR_UNKNOWN;
+}
+
+size_t dijkstra_repair_(struct dijkstra *dij,
+			const struct gossmap *map,
+			double riskfactor,
+			bool (*channel_ok)(const struct gossmap *map,
+					   const struct gossmap_chan *c,
+					   int dir,
+					   struct amount_msat amount,
+					   void *arg),
+			u64 (*path_score)(u32 distance,
+					  struct amount_msat cost,
+					  struct amount_msat risk,
+					  int dir,
+					  const struct gossmap_chan *c),
+			void *arg)
+{
+	const struct gossmap_node *n, **heap, **invalid;
+	size_t num_invalid, heapsize;
+	enum repair_state *state;
+	u32 *stack;
+	struct gheap_ctx gheap_ctx;
+
+	assert(tal_count(dij) == gossmap_max_node_idx(map));
+	init_gheap_ctx(&gheap_ctx);
+
+	global_map = map;
+	global_dijkstra = dij;
+
+	/* A node is invalid if its best_chan is no longer ok, or its parent
+	 * (the other end of best_chan) is invalid.  Walk up the tree,
+	 * remembering the path so everyone on it gets the same answer. */
+	state = tal_arrz(tmpctx, enum repair_state, tal_count(dij));
+	stack = tal_arr(tmpctx, u32, 0);
+	for (n = gossmap_first_node(map); n; n = gossmap_next_node(map, n)) {
+		u32 idx = gossmap_node_idx(map, n);
+
+		while (state[idx] == REPAIR_UNKNOWN) {
+			enum repair_state s;
+			u32 parent;
+
+			s = node_repair_state(dij, map, idx, &parent,
+					      channel_ok, arg);
+			if (s != REPAIR_UNKNOWN) {
+				state[idx] = s;
+				break;
+			}
+			tal_arr_expand(&stack, idx);
+			idx = parent;
+		}
+		for (size_t i = 0; i < tal_count(stack); i++)
+			state[stack[i]] = state[idx];
+		tal_resize(&stack, 0);
+	}
+
+	/* Everyone else counts as visited. */
+	for (size_t i = 0; i < tal_count(dij); i++)
+		dij[i].heapptr = NULL;
+
+	invalid = tal_arr(tmpctx, const struct gossmap_node *, 0);
+	for (n = gossmap_first_node(map); n; n = gossmap_next_node(map, n)) {
+		struct dijkstra *d = get_dijkstra(dij, map, n);
+		if (state[gossmap_node_idx(map, n)] != REPAIR_INVALID)
+			continue;
+		d->distance = UINT_MAX;
+		d->cost = AMOUNT_MSAT(-1ULL);
+		d->total_delay = 0;
+		d->score = -1ULL;
+		d->best_chan = NULL;
+		tal_arr_expand(&invalid, n);
+	}
+
+	num_invalid = heapsize = tal_count(invalid);
+	if (num_invalid == 0)
+		return 0;
+
+	/* Everyone has the same score, so it's already a heap */
+	heap = tal_dup_talarr(tmpctx, const struct gossmap_node *, invalid);
+	for (size_t i = 0; i < heapsize; i++)
+		get_dijkstra(dij, map, heap[i])->heapptr = &heap[i];
+
+	/* Now seed from valid neighbors, which cannot have changed.  We
+	 * iterate invalid[], not heap[], since the heap gets shuffled. */
+	for (size_t i = 0; i < num_invalid; i++) {
+		const struct gossmap_node *inv = invalid[i];
+		struct dijkstra *d = get_dijkstra(dij, map, inv);
+
+		for (size_t j = 0; j < inv->num_chans; j++) {
 			struct gossmap_node *neighbor;
 			int which_half;
 			struct gossmap_chan *c;
-			struct dijkstra *d;
-			struct amount_msat cost, risk;
-			u64 score;
+			const struct dijkstra *nd;
 
-			c = gossmap_nth_chan(map, cur, i, &which_half);
+			c = gossmap_nth_chan(map, inv, j, &which_half);
 			neighbor = gossmap_nth_node(map, c, !which_half);
-
-			d = get_dijkstra(dij, map, neighbor);
-			/* Ignore if already visited. */
-			if (!d->heapptr)
-				continue;
-
-			/* We're going from neighbor to c, hence !which_half */
-			if (!channel_ok(map, c, !which_half, cur_d->cost, arg))
-				continue;
-
-			cost = cur_d->cost;
-			if (!amount_msat_add_fee(&cost,
-						 c->half[!which_half].base_fee,
-						 c->half[!which_half].proportional_fee))
-				/* Shouldn't happen! */
+			nd = get_dijkstra(dij, map, neighbor);
+			if (nd->heapptr || nd->distance == UINT_MAX)
 				continue;
 
-			/* cltv_delay can't overflow: only 20 bits per hop. */
-			risk = risk_price(cost, riskfactor,
-					  cur_d->total_delay
-					  + c->half[!which_half].delay);
-			score = path_score(cur_d->distance + 1, cost, risk, !which_half, c);
-			if (score >= d->score)
+			/* We're going from inv to neighbor, hence which_half */
+			if (!relax(map, nd, d, c, which_half,
+				   &c->half[which_half], riskfactor,
+				   channel_ok, path_score, arg))
 				continue;
 
-			d->distance = cur_d->distance + 1;
-			d->total_delay = cur_d->total_delay
-				+ c->half[!which_half].delay;
-			d->cost = cost;
-			d->best_chan = c;
-			d->score = score;
 			gheap_restore_heap_after_item_increase(&gheap_ctx,
 							       heap, heapsize,
 							       d->heapptr - heap);
 		}
-		gheap_pop_heap(&gheap_ctx, heap, heapsize--);
-		cur_d->heapptr = NULL;
 	}
+
+	dijkstra_run(dij, map, heap, heapsize, NULL, &gheap_ctx, riskfactor,
+		     channel_ok, path_score, arg);
 	tal_free(heap);
-	return dij;
+	tal_free(invalid);
+	tal_free(stack);
+	tal_free(state);
+	return num_invalid;
 }
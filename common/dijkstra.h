@@ -36,6 +36,71 @@ dijkstra_(const tal_t *ctx,
 		  (path_score),						\
 		  (arg))
 
+/* Same, but stop as soon as we've found the best path from stop (usually
+ * the source), rather than exploring the whole graph.  Only stop, and nodes
+ * on its path, are guaranteed to have their final values! */
+const struct dijkstra *
+dijkstra_to_(const tal_t *ctx,
+	     const struct gossmap *gossmap,
+	     const struct gossmap_node *start,
+	     const struct gossmap_node *stop,
+	     struct amount_msat amount,
+	     double riskfactor,
+	     bool (*channel_ok)(const struct gossmap *map,
+				const struct gossmap_chan *c,
+				int dir,
+				struct amount_msat amount,
+				void *arg),
+	     u64 (*path_score)(u32 distance,
+			       struct amount_msat cost,
+			       struct amount_msat risk,
+			       int dir,
+			       const struct gossmap_chan *c),
+	     void *arg);
+
+#define dijkstra_to(ctx, map, start, stop, amount, riskfactor,		\
+		    channel_ok, path_score, arg)			\
+	dijkstra_to_((ctx), (map), (start), (stop), (amount), (riskfactor), \
+		     typesafe_cb_preargs(bool, void *, (channel_ok), (arg), \
+					 const struct gossmap *,	\
+					 const struct gossmap_chan *,	\
+					 int, struct amount_msat),	\
+		     (path_score),					\
+		     (arg))
+
+/* Update a dijkstra() result in place after channels have gone away:
+ * channel_ok must now reject a superset of what it rejected before (e.g.
+ * more exclusions, lower capacity estimates), otherwise the result can be
+ * suboptimal and you should simply call dijkstra() again.  map, amount,
+ * riskfactor and path_score must be the same as the original call.  Only nodes
+ * whose best path used a channel which is no longer ok are recalculated.
+ * Doesn't work on a dijkstra_to() result, which is incomplete.
+ *
+ * Returns the number of nodes recalculated. */
+size_t dijkstra_repair_(struct dijkstra *dij,
+			const struct gossmap *gossmap,
+			double riskfactor,
+			bool (*channel_ok)(const struct gossmap *map,
+					   const struct gossmap_chan *c,
+					   int dir,
+					   struct amount_msat amount,
+					   void *arg),
+			u64 (*path_score)(u32 distance,
+					  struct amount_msat cost,
+					  struct amount_msat risk,
+					  int dir,
+					  const struct gossmap_chan *c),
+			void *arg);
+
+#define dijkstra_repair(dij, map, riskfactor, channel_ok, path_score, arg) \
+	dijkstra_repair_((dij), (map), (riskfactor),			\
+			 typesafe_cb_preargs(bool, void *, (channel_ok), (arg), \
+					     const struct gossmap *,	\
+					     const struct gossmap_chan *, \
+					     int, struct amount_msat),	\
+			 (path_score),					\
+			 (arg))
+
 /* Returns UINT_MAX if unreachable. */
 u32 dijkstra_distance(const struct dijkstra *dij, u32 node_idx);
 
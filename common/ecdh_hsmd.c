@@ -1,15 +1,128 @@
 #include "config.h"
+#include <ccan/crypto/siphash24/siphash24.h>
+#include <ccan/htable/htable_type.h>
+#include <ccan/list/list.h>
+#include <ccan/time/time.h>
 #include <common/ecdh_hsmd.h>
+#include <common/memleak.h>
+#include <common/pseudorand.h>
 #include <hsmd/hsmd_wiregen.h>
 #include <wire/wire_sync.h>
 
 static int stashed_hsm_fd = -1;
 static void (*stashed_failed)(enum status_failreason, const char *fmt, ...);
 
+/* Blinding points are shared by every payment (or onion message) over
+ * the same blinded path, so we remember a bounded number of them. */
+#define BLINDING_CACHE_MAX 1000
+#define BLINDING_CACHE_SECS 600
+
+struct blinding_ss {
+	/* In blinding_cache.order, oldest first. */
+	struct list_node list;
+	struct pubkey point;
+	struct secret ss;
+	struct timemono expiry;
+};
+
+static const struct pubkey *blinding_ss_key(const struct blinding_ss *b)
+{
+	return &b->point;
+}
+
+static size_t pubkey_hash(const struct pubkey *point)
+{
+	return siphash24(siphash_seed(), point->pubkey.data,
+			 sizeof(point->pubkey.data));
+}
+
+static bool blinding_ss_eq(const struct blinding_ss *b,
+			   const struct pubkey *point)
+{
+	return pubkey_eq(&b->point, point);
+}
+
+HTABLE_DEFINE_TYPE(struct blinding_ss,
+		   blinding_ss_key, pubkey_hash, blinding_ss_eq,
+		   blinding_ss_map);
+
+struct blinding_cache {
+	struct blinding_ss_map map;
+	struct list_head order;
+	size_t count;
+};
+
+static struct blinding_cache *blinding_cache;
+
+static void blinding_ss_remove(struct blinding_ss *b)
+{
+	blinding_ss_map_del(&blinding_cache->map, b);
+	list_del_from(&blinding_cache->order, &b->list);
+	blinding_cache->count--;
+	tal_free(b);
+}
+
+static const struct secret *blinding_cache_get(const struct pubkey *point)
+{
+	struct blinding_ss *b;
+
+	if (!blinding_cache)
+		return NULL;
+
+	b = blinding_ss_map_get(&blinding_cache->map, point);
+	if (!b)
+		return NULL;
+
+	if (time_greater_(time_mono().ts, b->expiry.ts)) {
+		blinding_ss_remove(b);
+		return NULL;
+	}
+	return &b->ss;
+}
+
+static void blinding_cache_add(const struct pubkey *point,
+			       const struct secret *ss)
+{
+	struct timemono now = time_mono();
+	struct blinding_ss *b;
+
+	if (!blinding_cache) {
+		blinding_cache = notleak_with_children(tal(NULL,
+							   struct blinding_cache));
+		blinding_ss_map_init(&blinding_cache->map);
+		list_head_init(&blinding_cache->order);
+		blinding_cache->count = 0;
+	}
+
+	/* Everyone expires in the order they were added. */
+	while ((b = list_top(&blinding_cache->order,
+			     struct blinding_ss, list)) != NULL) {
+		if (blinding_cache->count < BLINDING_CACHE_MAX
+		    && !time_greater_(now.ts, b->expiry.ts))
+			break;
+		blinding_ss_remove(b);
+	}
+
+	b = tal(blinding_cache, struct blinding_ss);
+	b->point = *point;
+	b->ss = *ss;
+	b->expiry = timemono_add(now, time_from_sec(BLINDING_CACHE_SECS));
+	blinding_ss_map_add(&blinding_cache->map, b);
+	list_add_tail(&blinding_cache->order, &b->list);
+	blinding_cache->count++;
+}
+
 void ecdh(const struct pubkey *point, struct secret *ss)
 {
-	const u8 *msg = towire_hsmd_ecdh_req(NULL, point);
+	const struct secret *cached = blinding_cache_get(point);
+	const u8 *msg;
+
+	if (cached) {
+		*ss = *cached;
+		return;
+	}
 
+	msg = towire_hsmd_ecdh_req(NULL, point);
 	if (!wire_sync_write(stashed_hsm_fd, take(msg)))
 		stashed_failed(STATUS_FAIL_HSM_IO, "Write ECDH to hsmd failed");
 
@@ -21,6 +134,37 @@ void ecdh(const struct pubkey *point, struct secret *ss)
 		stashed_failed(STATUS_FAIL_HSM_IO, "Invalid hsmd ECDH response");
 }
 
+void ecdh_blinding(const struct pubkey *blinding, struct secret *ss)
+{
+	const struct secret *cached = blinding_cache_get(blinding);
+
+	if (cached) {
+		*ss = *cached;
+		return;
+	}
+	ecdh(blinding, ss);
+	blinding_cache_add(blinding, ss);
+}
+
+struct secret *ecdh_batch(const tal_t *ctx, const struct pubkey *points)
+{
+	const u8 *msg = towire_hsmd_ecdh_batch_req(NULL, points);
+	struct secret *ss;
+
+	if (!wire_sync_write(stashed_hsm_fd, take(msg)))
+		stashed_failed(STATUS_FAIL_HSM_IO, "Write ECDH batch to hsmd failed");
+
+	msg = wire_sync_read(tmpctx, stashed_hsm_fd);
+	if (!msg)
+		stashed_failed(STATUS_FAIL_HSM_IO, "No hsmd ECDH batch response");
+
+	if (!fromwire_hsmd_ecdh_batch_resp(ctx, msg, &ss)
+	    || tal_count(ss) != tal_count(points))
+		stashed_failed(STATUS_FAIL_HSM_IO, "Invalid hsmd ECDH batch response");
+
+	return ss;
+}
+
 void ecdh_hsmd_setup(int hsm_fd,
 		     void (*failed)(enum status_failreason,
 				    const char *fmt, ...))
@@ -1,6 +1,7 @@
 #ifndef LIGHTNING_COMMON_ECDH_HSMD_H
 #define LIGHTNING_COMMON_ECDH_HSMD_H
 #include "config.h"
+#include <ccan/tal/tal.h>
 #include <common/ecdh.h>
 #include <common/status_levels.h>
 
@@ -10,4 +11,13 @@
 void ecdh_hsmd_setup(int hsm_fd,
 		     void (*failed)(enum status_failreason,
 				    const char *fmt, ...));
+
+/* ecdh() for a route-blinding point: the result is remembered for a
+ * while (blinding points are shared by everyone using the same blinded
+ * path), and later ecdh() calls on the same point are answered from it. */
+void ecdh_blinding(const struct pubkey *blinding, struct secret *ss);
+
+/* ecdh() for each of the (tal array) @points, in a single hsmd request.
+ * Returns a tal array of the shared secrets, in the same order. */
+struct secret *ecdh_batch(const tal_t *ctx, const struct pubkey *points);
 #endif /* LIGHTNING_COMMON_ECDH_HSMD_H */
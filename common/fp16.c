@@ -38,13 +38,3 @@ fp16_t u64_to_fp16(u64 val, bool round_up)
 	assert((mantissa >> 11) == 0);
 	return (exponent << 11) | mantissa;
 }
-
-bool amount_msat_less_fp16(struct amount_msat amt, fp16_t fp)
-{
-	return amt.millisatoshis < fp16_to_u64(fp); /* Raw: fp16 compare */
-}
-
-bool amount_msat_greater_fp16(struct amount_msat amt, fp16_t fp)
-{
-	return amt.millisatoshis > fp16_to_u64(fp); /* Raw: fp16 compare */
-}
@@ -13,7 +13,16 @@ static inline u64 fp16_to_u64(fp16_t val)
 
 fp16_t u64_to_fp16(u64 val, bool round_up);
 
-bool amount_msat_less_fp16(struct amount_msat amt, fp16_t fp);
-bool amount_msat_greater_fp16(struct amount_msat amt, fp16_t fp);
+/* These are inline since they're called for every channel we consider
+ * when routing. */
+static inline bool amount_msat_less_fp16(struct amount_msat amt, fp16_t fp)
+{
+	return amt.millisatoshis < fp16_to_u64(fp); /* Raw: fp16 compare */
+}
+
+static inline bool amount_msat_greater_fp16(struct amount_msat amt, fp16_t fp)
+{
+	return amt.millisatoshis > fp16_to_u64(fp); /* Raw: fp16 compare */
+}
 
 #endif /* LIGHTNING_COMMON_FP16_H */
@@ -18,6 +18,21 @@ struct hdr_and_type {
 /* Beware padding! */
 #define HDR_AND_TYPE_SIZE (sizeof(struct gossip_hdr) + sizeof(u16))
 
+static void parse_hdr_and_type(const struct hdr_and_type *buf,
+			       size_t *len,
+			       u32 *timestamp,
+			       u16 *flags,
+			       u16 *type)
+{
+	*len = be16_to_cpu(buf->hdr.len);
+	if (flags)
+		*flags = be16_to_cpu(buf->hdr.flags);
+	if (timestamp)
+		*timestamp = be32_to_cpu(buf->hdr.timestamp);
+	if (type)
+		*type = be16_to_cpu(buf->type);
+}
+
 bool gossip_store_readhdr(int gossip_store_fd, size_t off,
 			  size_t *len,
 			  u32 *timestamp,
@@ -30,13 +45,37 @@ bool gossip_store_readhdr(int gossip_store_fd, size_t off,
 	r = pread(gossip_store_fd, &buf, HDR_AND_TYPE_SIZE, off);
 	if (r != HDR_AND_TYPE_SIZE)
 		return false;
-	*len = be16_to_cpu(buf.hdr.len);
-	if (flags)
-		*flags = be16_to_cpu(buf.hdr.flags);
-	if (timestamp)
-		*timestamp = be32_to_cpu(buf.hdr.timestamp);
-	if (type)
-		*type = be16_to_cpu(buf.type);
+	parse_hdr_and_type(&buf, len, timestamp, flags, type);
+	return true;
+}
+
+void gossip_store_hdrbuf_init(struct gossip_store_hdrbuf *hb, int fd)
+{
+	hb->fd = fd;
+	hb->start = 0;
+	hb->len = 0;
+}
+
+bool gossip_store_readhdr_buffered(struct gossip_store_hdrbuf *hb, size_t off,
+				   size_t *len,
+				   u32 *timestamp,
+				   u16 *flags,
+				   u16 *type)
+{
+	struct hdr_and_type buf;
+
+	/* Not (entirely) in what we read last time?  Read ahead from here.
+	 * This also picks up anything appended since. */
+	if (off < hb->start || off + HDR_AND_TYPE_SIZE > hb->start + hb->len) {
+		ssize_t r = pread(hb->fd, hb->buf, sizeof(hb->buf), off);
+		hb->start = off;
+		hb->len = r < 0 ? 0 : r;
+		if (hb->len < HDR_AND_TYPE_SIZE)
+			return false;
+	}
+
+	memcpy(&buf, hb->buf + (off - hb->start), HDR_AND_TYPE_SIZE);
+	parse_hdr_and_type(&buf, len, timestamp, flags, type);
 	return true;
 }
 
@@ -44,9 +83,11 @@ size_t find_gossip_store_end(int gossip_store_fd, size_t off)
 {
 	size_t msglen;
 	u16 type;
+	struct gossip_store_hdrbuf hb;
 
-	while (gossip_store_readhdr(gossip_store_fd, off,
-				    &msglen, NULL, NULL, &type)) {
+	gossip_store_hdrbuf_init(&hb, gossip_store_fd);
+	while (gossip_store_readhdr_buffered(&hb, off,
+					     &msglen, NULL, NULL, &type)) {
 		/* Don't swallow end marker! */
 		if (type == WIRE_GOSSIP_STORE_ENDED)
 			break;
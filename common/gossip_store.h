@@ -76,6 +76,35 @@ bool gossip_store_readhdr(int gossip_store_fd, size_t off,
 			  u16 *flags,
 			  u16 *type);
 
+/**
+ * Read-ahead state for gossip_store_readhdr_buffered.
+ */
+struct gossip_store_hdrbuf {
+	int fd;
+	/* File offset of buf[0], and how much of buf is valid. */
+	size_t start, len;
+	u8 buf[16384];
+};
+
+/**
+ * gossip_store_hdrbuf_init - set up to walk headers in @fd.
+ */
+void gossip_store_hdrbuf_init(struct gossip_store_hdrbuf *hb, int fd);
+
+/**
+ * gossip_store_readhdr_buffered - gossip_store_readhdr, reading ahead.
+ * @hb: the read-ahead buffer, from gossip_store_hdrbuf_init.
+ *
+ * For skipping through many records: rather than a pread() per header,
+ * this reads the store in chunks.  Only use it for a single pass, as
+ * the flags of records already buffered may since have changed.
+ */
+bool gossip_store_readhdr_buffered(struct gossip_store_hdrbuf *hb, size_t off,
+				   size_t *len,
+				   u32 *timestamp,
+				   u16 *flags,
+				   u16 *type);
+
 /**
  * Gossipd will be writing to this, and it's not atomic!  Safest
  * way to find the "end" is to walk through.
@@ -9,6 +9,7 @@
 #include <common/gossip_store.h>
 #include <common/gossmap.h>
 #include <common/pseudorand.h>
+#include <common/trace_probe.h>
 #include <common/type_to_string.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -79,6 +80,16 @@ struct gossmap {
 
 	/* local messages, if any. */
 	const u8 *local;
+
+	/* If gossmap_enable_edges(): edges for node_arr[i] start at
+	 * edges[edge_start[i]]. */
+	struct gossmap_edge *edges;
+	u32 *edge_start;
+	/* Channels have been added or removed since we built edges. */
+	bool edges_dirty;
+
+	/* Bumped every time the contents change, see gossmap_generation() */
+	u64 generation;
 };
 
 /* Accessors for the gossmap */
@@ -360,6 +371,7 @@ static struct gossmap_chan *new_channel(struct gossmap *map,
 	node_add_channel(map->node_arr + n1idx, gossmap_chan_idx(map, chan));
 	node_add_channel(map->node_arr + n2idx, gossmap_chan_idx(map, chan));
 	chanidx_htable_add(map->channels, chan2ptrint(chan));
+	map->edges_dirty = true;
 
 	return chan;
 }
@@ -393,6 +405,88 @@ void gossmap_remove_chan(struct gossmap *map, struct gossmap_chan *chan)
 	chan->cann_off = map->freed_chans;
 	chan->plus_scid_off = 0;
 	map->freed_chans = chanidx;
+	map->edges_dirty = true;
+}
+
+static void build_edges(struct gossmap *map)
+{
+	size_t num_edges = 0;
+
+	tal_resize(&map->edge_start, map->num_node_arr);
+	for (size_t i = 0; i < map->num_node_arr; i++) {
+		map->edge_start[i] = num_edges;
+		if (map->node_arr[i].chan_idxs)
+			num_edges += map->node_arr[i].num_chans;
+	}
+
+	tal_resize(&map->edges, num_edges);
+	for (size_t i = 0; i < map->num_node_arr; i++) {
+		const struct gossmap_node *node = &map->node_arr[i];
+		struct gossmap_edge *e = map->edges + map->edge_start[i];
+
+		if (!node->chan_idxs)
+			continue;
+		for (size_t n = 0; n < node->num_chans; n++) {
+			int which_half;
+			const struct gossmap_chan *c;
+
+			c = gossmap_nth_chan(map, node, n, &which_half);
+			e[n].chan_idx = node->chan_idxs[n];
+			/* Travelling *to* us, so the other half. */
+			e[n].dir = !which_half;
+			e[n].half = c->half[!which_half];
+		}
+	}
+	map->edges_dirty = false;
+}
+
+static void maybe_rebuild_edges(struct gossmap *map)
+{
+	if (map->edges && map->edges_dirty)
+		build_edges(map);
+}
+
+/* chan->half[dir] has changed: that's an edge into the other node. */
+static void update_edge(struct gossmap *map,
+			const struct gossmap_chan *chan,
+			int dir)
+{
+	const struct gossmap_node *node;
+	struct gossmap_edge *e;
+	u32 chanidx;
+
+	/* If it needs rebuilding anyway, we don't care. */
+	if (!map->edges || map->edges_dirty)
+		return;
+
+	chanidx = gossmap_chan_idx(map, chan);
+	node = gossmap_nth_node(map, chan, !dir);
+	e = map->edges + map->edge_start[gossmap_node_idx(map, node)];
+	for (size_t i = 0; i < node->num_chans; i++) {
+		if (e[i].chan_idx == chanidx) {
+			assert(e[i].dir == dir);
+			e[i].half = chan->half[dir];
+			return;
+		}
+	}
+	abort();
+}
+
+void gossmap_enable_edges(struct gossmap *map)
+{
+	if (map->edges)
+		return;
+	map->edges = tal_arr(map, struct gossmap_edge, 0);
+	map->edge_start = tal_arr(map, u32, 0);
+	build_edges(map);
+}
+
+const struct gossmap_edge *gossmap_node_edges(const struct gossmap *map,
+					      const struct gossmap_node *node)
+{
+	if (!map->edges || map->edges_dirty)
+		return NULL;
+	return map->edges + map->edge_start[gossmap_node_idx(map, node)];
 }
 
 void gossmap_remove_node(struct gossmap *map, struct gossmap_node *node)
@@ -531,6 +625,7 @@ static bool update_channel(struct gossmap *map, size_t cupdate_off)
 	hc.nodeidx = chan->half[chanflags & 1].nodeidx;
 	chan->half[chanflags & 1] = hc;
 	chan->cupdate_off[chanflags & 1] = cupdate_off;
+	update_edge(map, chan, chanflags & 1);
 
 	return !dumb_values;
 }
@@ -586,19 +681,77 @@ static void node_announcement(struct gossmap *map, size_t nann_off)
 		n->nann_off = nann_off;
 }
 
-static void reopen_store(struct gossmap *map, size_t ended_off)
+/* We walk the whole store on load and on every refresh, so there's no
+ * point faulting it in a page at a time: populate it up front, and ask
+ * for huge pages where the kernel supports them for file mappings. */
+static u8 *map_store(int fd, size_t len)
+{
+	int flags = MAP_SHARED;
+	u8 *p;
+
+#ifdef MAP_POPULATE
+	flags |= MAP_POPULATE;
+#endif
+	p = mmap(NULL, len, PROT_READ, flags, fd, 0);
+	if (p == MAP_FAILED)
+		return NULL;
+#ifdef MADV_HUGEPAGE
+	madvise(p, len, MADV_HUGEPAGE);
+#endif
+	return p;
+}
+
+static void init_map_indices(struct gossmap *map)
+{
+	/* Since channel_announcement is ~430 bytes, and channel_update is 136,
+	 * node_announcement is 144, and current topology has 35000 channels
+	 * and 10000 nodes, let's assume each channel gets about 750 bytes.
+	 *
+	 * We halve this, since often some records are deleted. */
+	map->channels = tal(map, struct chanidx_htable);
+	chanidx_htable_init_sized(map->channels, map->map_size / 750 / 2);
+	map->nodes = tal(map, struct nodeidx_htable);
+	nodeidx_htable_init_sized(map->nodes, map->map_size / 2500 / 2);
+
+	map->num_chan_arr = map->map_size / 750 / 2 + 1;
+	map->chan_arr = tal_arr(map, struct gossmap_chan, map->num_chan_arr);
+	map->freed_chans = init_chan_arr(map->chan_arr, 0);
+	map->num_node_arr = map->map_size / 2500 / 2 + 1;
+	map->node_arr = tal_arr(map, struct gossmap_node, map->num_node_arr);
+	map->freed_nodes = init_node_arr(map->node_arr, 0);
+}
+
+static void free_map_indices(struct gossmap *map)
+{
+	for (size_t i = 0; i < tal_count(map->node_arr); i++)
+		free(map->node_arr[i].chan_idxs);
+	tal_free(map->channels);
+	tal_free(map->nodes);
+	tal_free(map->chan_arr);
+	tal_free(map->node_arr);
+}
+
+/* gossipd has compacted the store into a new file.  Every offset we hold
+ * points into the old one, so we load the new one from scratch. */
+static void reopen_store(struct gossmap *map)
 {
 	int fd = open(map->fname, O_RDONLY);
 
 	if (fd < 0)
 		err(1, "Failed to reopen %s", map->fname);
 
-	/* This tells us the equivalent offset in new map */
-	map->map_end = map_be64(map, ended_off + 2);
-
 	close(map->fd);
 	map->fd = fd;
-	gossmap_refresh(map, NULL);
+
+	if (map->mmap)
+		munmap(map->mmap, map->map_size);
+	map->map_size = lseek(map->fd, 0, SEEK_END);
+	map->mmap = map_store(map->fd, map->map_size);
+
+	free_map_indices(map);
+	init_map_indices(map);
+	map->edges_dirty = true;
+	map->map_end = 1;
 }
 
 static bool map_catchup(struct gossmap *map, size_t *num_rejected)
@@ -641,14 +794,19 @@ static bool map_catchup(struct gossmap *map, size_t *num_rejected)
 			remove_channel_by_deletemsg(map, off);
 		else if (type == WIRE_NODE_ANNOUNCEMENT)
 			node_announcement(map, off);
-		else if (type == WIRE_GOSSIP_STORE_ENDED)
-			reopen_store(map, off);
-		else
+		else if (type == WIRE_GOSSIP_STORE_ENDED) {
+			reopen_store(map);
+			/* Start again from the top of the new file. */
+			reclen = 0;
+		} else
 			continue;
 
 		changed = true;
 	}
 
+	maybe_rebuild_edges(map);
+	if (changed)
+		map->generation++;
 	if (num_rejected)
 		*num_rejected = num_bad;
 	return changed;
@@ -663,9 +821,7 @@ static bool load_gossip_store(struct gossmap *map, size_t *num_rejected)
 	map->map_size = lseek(map->fd, 0, SEEK_END);
 	map->local = NULL;
 	/* If this fails, we fall back to read */
-	map->mmap = mmap(NULL, map->map_size, PROT_READ, MAP_SHARED, map->fd, 0);
-	if (map->mmap == MAP_FAILED)
-		map->mmap = NULL;
+	map->mmap = map_store(map->fd, map->map_size);
 
 	/* We only support major version 0 */
 	if (GOSSIP_STORE_MAJOR_VERSION(map_u8(map, 0)) != 0) {
@@ -676,25 +832,20 @@ static bool load_gossip_store(struct gossmap *map, size_t *num_rejected)
 		return false;
 	}
 
-	/* Since channel_announcement is ~430 bytes, and channel_update is 136,
-	 * node_announcement is 144, and current topology has 35000 channels
-	 * and 10000 nodes, let's assume each channel gets about 750 bytes.
-	 *
-	 * We halve this, since often some records are deleted. */
-	map->channels = tal(map, struct chanidx_htable);
-	chanidx_htable_init_sized(map->channels, map->map_size / 750 / 2);
-	map->nodes = tal(map, struct nodeidx_htable);
-	nodeidx_htable_init_sized(map->nodes, map->map_size / 2500 / 2);
-
-	map->num_chan_arr = map->map_size / 750 / 2 + 1;
-	map->chan_arr = tal_arr(map, struct gossmap_chan, map->num_chan_arr);
-	map->freed_chans = init_chan_arr(map->chan_arr, 0);
-	map->num_node_arr = map->map_size / 2500 / 2 + 1;
-	map->node_arr = tal_arr(map, struct gossmap_node, map->num_node_arr);
-	map->freed_nodes = init_node_arr(map->node_arr, 0);
+	init_map_indices(map);
+	map->edges = NULL;
+	map->edge_start = NULL;
+	map->edges_dirty = false;
+	map->generation = 0;
 
 	map->map_end = 1;
+	/* We're about to read the whole thing, front to back: let the kernel
+	 * read ahead aggressively, then go back to normal (random) access. */
+	if (map->mmap)
+		madvise(map->mmap, map->map_size, MADV_SEQUENTIAL);
 	map_catchup(map, num_rejected);
+	if (map->mmap)
+		madvise(map->mmap, map->map_size, MADV_NORMAL);
 	return true;
 }
 
@@ -912,8 +1063,11 @@ void gossmap_apply_localmods(struct gossmap *map,
 			chan->half[h] = mod->hc[h];
 			chan->half[h].nodeidx = mod->orig[h].nodeidx;
 			chan->cupdate_off[h] = 0xFFFFFFFF;
+			update_edge(map, chan, h);
 		}
 	}
+	maybe_rebuild_edges(map);
+	map->generation++;
 }
 
 void gossmap_remove_localmods(struct gossmap *map,
@@ -941,13 +1095,21 @@ void gossmap_remove_localmods(struct gossmap *map,
 				chan->half[h] = mod->orig[h];
 				chan->half[h].nodeidx = nodeidx;
 				chan->cupdate_off[h] = mod->orig_cupdate_off[h];
+				update_edge(map, chan, h);
 			}
 		}
 	}
 	map->local = NULL;
+	maybe_rebuild_edges(map);
+	map->generation++;
 }
 
-bool gossmap_refresh(struct gossmap *map, size_t *num_rejected)
+u64 gossmap_generation(const struct gossmap *map)
+{
+	return map->generation;
+}
+
+static bool refresh_map(struct gossmap *map, size_t *num_rejected)
 {
 	off_t len;
 
@@ -959,15 +1121,40 @@ bool gossmap_refresh(struct gossmap *map, size_t *num_rejected)
 	if (len == map->map_size)
 		return false;
 
-	if (map->mmap)
+	if (map->mmap) {
+#ifdef MREMAP_MAYMOVE
+		/* Growing the mapping keeps the pages we've already faulted
+		 * in: unmapping would make us fault in the whole store again
+		 * the next time we walk it. */
+		u8 *newmap = mremap(map->mmap, map->map_size, len,
+				    MREMAP_MAYMOVE);
+		if (newmap != MAP_FAILED) {
+			/* Only the new tail needs reading in. */
+			madvise(newmap + (map->map_end & ~(getpagesize() - 1)),
+				len - (map->map_end & ~(getpagesize() - 1)),
+				MADV_WILLNEED);
+			map->mmap = newmap;
+			map->map_size = len;
+			return map_catchup(map, num_rejected);
+		}
+#endif
 		munmap(map->mmap, map->map_size);
+	}
 	map->map_size = len;
-	map->mmap = mmap(NULL, map->map_size, PROT_READ, MAP_SHARED, map->fd, 0);
-	if (map->mmap == MAP_FAILED)
-		map->mmap = NULL;
+	map->mmap = map_store(map->fd, map->map_size);
 	return map_catchup(map, num_rejected);
 }
 
+bool gossmap_refresh(struct gossmap *map, size_t *num_rejected)
+{
+	bool changed;
+
+	TRACE_PROBE1(gossmap_refresh_start, map->map_size);
+	changed = refresh_map(map, num_rejected);
+	TRACE_PROBE2(gossmap_refresh_end, changed, map->map_size);
+	return changed;
+}
+
 struct gossmap *gossmap_load(const tal_t *ctx, const char *filename,
 			     size_t *num_channel_updates_rejected)
 {
@@ -1110,19 +1297,6 @@ struct gossmap_chan *gossmap_next_chan(const struct gossmap *map,
 	return chan_iter(map, prev - map->chan_arr + 1);
 }
 
-bool gossmap_chan_capacity(const struct gossmap_chan *chan,
-			   int direction,
-			   struct amount_msat amount)
-{
-	if (amount_msat_less_fp16(amount, chan->half[direction].htlc_min))
-		return false;
-
-	if (amount_msat_greater_fp16(amount, chan->half[direction].htlc_max))
-		return false;
-
-	return true;
-}
-
 /* Get the announcement msg which created this chan */
 u8 *gossmap_chan_get_announce(const tal_t *ctx,
 			      const struct gossmap *map,
@@ -1294,6 +1468,23 @@ int gossmap_node_get_feature(const struct gossmap *map,
 				n->nann_off + feature_len_off + 2, feature_len);
 }
 
+bool gossmap_node_get_timestamp(const struct gossmap *map,
+				const struct gossmap_node *n,
+				u32 *timestamp)
+{
+	/* Note that first two bytes are message type */
+	const size_t feature_len_off = 2 + 64;
+	size_t feature_len;
+
+	if (n->nann_off == 0)
+		return false;
+
+	feature_len = map_be16(map, n->nann_off + feature_len_off);
+	*timestamp = map_be32(map, n->nann_off + feature_len_off + 2
+			      + feature_len);
+	return true;
+}
+
 u8 *gossmap_node_get_features(const tal_t *ctx,
 			      const struct gossmap *map,
 			      const struct gossmap_node *n)
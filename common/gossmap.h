@@ -40,6 +40,16 @@ struct gossmap_chan {
 	} half[2];
 };
 
+/* Flattened copy of the channels into a node, for pathfinding. */
+struct gossmap_edge {
+	/* The channel, and which half of it leads to this node: the
+	 * neighbor is half.nodeidx. */
+	u32 chan_idx;
+	u32 dir;
+	/* Copy of chan->half[dir] */
+	struct half_chan half;
+};
+
 /* If num_channel_updates_rejected is not NULL, indicates how many channels we
  * marked inactive because their values were too high to be represented. */
 struct gossmap *gossmap_load(const tal_t *ctx, const char *filename,
@@ -49,6 +59,21 @@ struct gossmap *gossmap_load(const tal_t *ctx, const char *filename,
  * was updated. Note: this can scramble node and chan indexes! */
 bool gossmap_refresh(struct gossmap *map, size_t *num_channel_updates_rejected);
 
+/* Changes whenever gossmap_refresh() updates something, or localmods are
+ * applied or removed.  If it's the same, node and chan indexes (and anything
+ * derived from them) are still valid. */
+u64 gossmap_generation(const struct gossmap *map);
+
+/* Maintain a contiguous array of edges into each node (expensive to build
+ * initially, but then kept up-to-date by gossmap_refresh() and localmods). */
+void gossmap_enable_edges(struct gossmap *map);
+
+/* Returns node->num_chans edges into this node, in the same order as
+ * gossmap_nth_chan(), or NULL if not enabled (or gossmap_remove_chan /
+ * gossmap_remove_node made them stale). */
+const struct gossmap_edge *gossmap_node_edges(const struct gossmap *map,
+					      const struct gossmap_node *node);
+
 /* Local modifications. */
 struct gossmap_localmods *gossmap_localmods_new(const tal_t *ctx);
 
@@ -149,6 +174,11 @@ int gossmap_node_get_feature(const struct gossmap *map,
 			     const struct gossmap_node *n,
 			     int fbit);
 
+/* Get the node_announcement timestamp: false if no announcement. */
+bool gossmap_node_get_timestamp(const struct gossmap *map,
+				const struct gossmap_node *n,
+				u32 *timestamp);
+
 /* Return the node feature bitmap: NULL if no announcement. */
 u8 *gossmap_node_get_features(const tal_t *ctx,
 			      const struct gossmap *map,
@@ -180,9 +210,18 @@ struct gossmap_node *gossmap_nth_node(const struct gossmap *map,
 				      int n);
 
 /* Can this channel send this amount? */
-bool gossmap_chan_capacity(const struct gossmap_chan *chan,
-			   int direction,
-			   struct amount_msat amount);
+static inline bool gossmap_chan_capacity(const struct gossmap_chan *chan,
+					 int direction,
+					 struct amount_msat amount)
+{
+	if (amount_msat_less_fp16(amount, chan->half[direction].htlc_min))
+		return false;
+
+	if (amount_msat_greater_fp16(amount, chan->half[direction].htlc_max))
+		return false;
+
+	return true;
+}
 
 /* Remove a channel from the map (warning! realloc can move gossmap_chan
  * and gossmap_node ptrs!) */
@@ -12,6 +12,10 @@
 
 /* wire/hsmd_wire.csv contents version:
  *    edd3d288fc88a5470adc2f99abcbfe4d4af29fae0c7a80b4226f28810a815524
+ * v4 adds hsmd_sign_remote_htlc_txs:
+ *    1bf1c5a806c5a4828ecdfe422de730bf850673c18318f574eed937117b9cda15
+ * v5 adds hsmd_ecdh_batch_req:
+ *    57e7db6e6ed0a7684dbb1e2b9bdde3d1d08d3b0710534450cdfd0b886086ed52
  */
-#define HSM_MAX_VERSION 3
+#define HSM_MAX_VERSION 5
 #endif /* LIGHTNING_COMMON_HSM_VERSION_H */
@@ -44,6 +44,28 @@ bool json_filter_ok(const struct json_filter *filter, const char *member)
 	return strmap_get(&filter->filter_map, member) != NULL;
 }
 
+/* Like json_filter_down() would return, but doesn't move: lets callers
+ * skip generating a field (or obj/array) nobody will see. */
+bool json_filter_wants(const struct json_filter *filter, const char *member)
+{
+	if (!filter)
+		return true;
+	if (filter->depth > 0)
+		return filter->positive;
+
+	/* Leaf node: everything below is wanted. */
+	if (!filter->filter_array && strmap_empty(&filter->filter_map))
+		return true;
+
+	/* Misuse (array vs object): say yes, so json_filter_down notices. */
+	if (!member)
+		return true;
+	if (filter->filter_array)
+		return true;
+
+	return strmap_get(&filter->filter_map, member) != NULL;
+}
+
 /* Returns true if we should print this new obj/array */
 bool json_filter_down(struct json_filter **filter, const char *member)
 {
@@ -192,60 +214,83 @@ const char *json_filter_misused(const tal_t *ctx, const struct json_filter *f)
 	}
 }
 
-/* Recursively populate filter.  NULL on success.
+/* Recursively populate filter.  NULL on success, otherwise sets *badtok.
  *
  * Example for listtransactions to include output type, amount_msat,
  *   {"transactions": [{"outputs": [{"amount_msat": true, "type": true}]}]}
  */
-static struct command_result *
-build_filter(struct command *cmd,
-	     const char *name,
-	     const char *buffer,
-	     const jsmntok_t *tok,
-	     struct json_filter *filter)
+static const char *build_filter(const char *buffer,
+				const jsmntok_t *tok,
+				struct json_filter *filter,
+				const jsmntok_t **badtok)
 {
-	struct command_result *ret;
+	const char *err;
 	size_t i;
 	const jsmntok_t *t;
 	struct json_filter *subf;
 
 	if (tok->type == JSMN_ARRAY) {
-		if (tok->size != 1)
-			return command_fail_badparam(cmd, name, buffer, tok,
-						     "Arrays can only have one element");
+		if (tok->size != 1) {
+			*badtok = tok;
+			return "Arrays can only have one element";
+		}
 		subf = json_filter_subarr(filter);
-		return build_filter(cmd, name, buffer, tok + 1, subf);
+		return build_filter(buffer, tok + 1, subf, badtok);
 	}
 
 	json_for_each_obj(i, t, tok) {
 		bool is_true;
 		const jsmntok_t *val = t + 1;
 
-		if (t->type != JSMN_STRING)
-			return command_fail_badparam(cmd, name, buffer, t,
-						     "expected string key");
+		if (t->type != JSMN_STRING) {
+			*badtok = t;
+			return "expected string key";
+		}
 		subf = json_filter_subobj(filter, buffer + t->start, t->end - t->start);
 		if (val->type == JSMN_OBJECT || val->type == JSMN_ARRAY) {
-			ret = build_filter(cmd, name, buffer, val, subf);
-			if (ret)
-				return ret;
-		} else if (!json_to_bool(buffer, val, &is_true) || !is_true)
-			return command_fail_badparam(cmd, name, buffer, val, "value must be true");
+			err = build_filter(buffer, val, subf, badtok);
+			if (err)
+				return err;
+		} else if (!json_to_bool(buffer, val, &is_true) || !is_true) {
+			*badtok = val;
+			return "value must be true";
+		}
 	}
 	return NULL;
 }
 
+struct json_filter *json_filter_parse(const tal_t *ctx,
+				      const char *buffer,
+				      const jsmntok_t *tok,
+				      const char **err,
+				      const jsmntok_t **badtok)
+{
+	struct json_filter *filter;
+
+	if (tok->type != JSMN_OBJECT) {
+		*badtok = tok;
+		*err = "Expected object";
+		return NULL;
+	}
+
+	filter = json_filter_new(ctx);
+	*err = build_filter(buffer, tok, filter, badtok);
+	if (*err)
+		return tal_free(filter);
+	return filter;
+}
+
 struct command_result *parse_filter(struct command *cmd,
 				    const char *name,
 				    const char *buffer,
 				    const jsmntok_t *tok)
 {
 	struct json_filter **filter = command_filter_ptr(cmd);
+	const char *err;
+	const jsmntok_t *badtok;
 
-	if (tok->type != JSMN_OBJECT)
-		return command_fail_badparam(cmd, name, buffer, tok,
-					     "Expected object");
-
-	*filter = json_filter_new(cmd);
-	return build_filter(cmd, name, buffer, tok, *filter);
+	*filter = json_filter_parse(cmd, buffer, tok, &err, &badtok);
+	if (!*filter)
+		return command_fail_badparam(cmd, name, buffer, badtok, err);
+	return NULL;
 }
@@ -14,6 +14,9 @@ struct json_filter;
 /* Print this? */
 bool json_filter_ok(const struct json_filter *filter, const char *member);
 
+/* Would this member (or obj/array) be printed?  Doesn't change filter. */
+bool json_filter_wants(const struct json_filter *filter, const char *member);
+
 /* Returns true if we should print this new obj/array */
 bool json_filter_down(struct json_filter **filter, const char *member);
 
@@ -33,6 +36,13 @@ struct json_filter *json_filter_subobj(struct json_filter *filter,
 				       size_t fieldnamelen);
 struct json_filter *json_filter_subarr(struct json_filter *filter);
 
+/* Parse a filter object: returns NULL and sets *err, *badtok if invalid. */
+struct json_filter *json_filter_parse(const tal_t *ctx,
+				      const char *buffer,
+				      const jsmntok_t *tok,
+				      const char **err,
+				      const jsmntok_t **badtok);
+
 /* Turn this "filter" field into cmd->filter and return NULL, or fail command */
 struct command_result *parse_filter(struct command *cmd,
 				    const char *name,
@@ -17,6 +17,8 @@
 
 struct param {
 	const char *name;
+	/* Length of name before any "|", and deprecated alias after it */
+	size_t namelen, altlen;
 	bool is_set;
 	enum param_style style;
 	param_cbx cbx;
@@ -36,6 +38,11 @@ static bool param_add(struct param **params,
 
 	last.is_set = false;
 	last.name = name;
+	last.namelen = strcspn(name, "|");
+	if (name[last.namelen])
+		last.altlen = strlen(name + last.namelen + 1);
+	else
+		last.altlen = 0;
 	last.style = style;
 	last.cbx = cbx;
 	last.arg = arg;
@@ -121,14 +128,14 @@ static struct param *find_param(struct param *params, const char *start,
 	struct param *first = params;
 	struct param *last = first + tal_count(params);
 
+	/* Lengths are precomputed, so mismatches are usually one compare */
 	while (first != last) {
-		size_t arglen = strcspn(first->name, "|");
-		if (memeq(first->name, arglen, start, n))
+		if (memeq(first->name, first->namelen, start, n))
 			return first;
 		if (deprecated_apis
-		    && first->name[arglen]
-		    && memeq(first->name + arglen + 1,
-			     strlen(first->name + arglen + 1),
+		    && first->altlen
+		    && memeq(first->name + first->namelen + 1,
+			     first->altlen,
 			     start, n))
 			return first;
 		first++;
@@ -262,7 +269,7 @@ static char *param_usage(const tal_t *ctx,
 	char *usage = tal_strdup(ctx, "");
 	for (size_t i = 0; i < tal_count(params); i++) {
 		/* Don't print |deprecated part! */
-		int len = strcspn(params[i].name, "|");
+		int len = params[i].namelen;
 		if (i != 0)
 			tal_append_fmt(&usage, " ");
 		if (is_required(params[i].style))
@@ -47,6 +47,8 @@ struct json_stream *new_json_stream(const tal_t *ctx,
 	json_out_call_on_move(js->jout, adjust_io_write, js);
 	js->writer = writer;
 	js->reader = NULL;
+	js->written = 0;
+	js->drain_cb = NULL;
 	js->log = log;
 	js->filter = NULL;
 	return js;
@@ -71,6 +73,11 @@ const char *json_stream_detach_filter(const tal_t *ctx, struct json_stream *js)
 	return err;
 }
 
+bool json_stream_wants(const struct json_stream *js, const char *fieldname)
+{
+	return json_filter_wants(js->filter, fieldname);
+}
+
 struct json_stream *json_stream_dup(const tal_t *ctx,
 				    struct json_stream *original,
 				    struct log *log)
@@ -255,6 +262,7 @@ static struct io_plan *json_stream_output_write(struct io_conn *conn,
 
 	/* For when we've just done some output */
 	json_out_consume(js->jout, js->len_read);
+	js->written += js->len_read;
 
 	/* Get how much we can write out from js */
 	p = json_out_contents(js->jout, &js->len_read);
@@ -263,6 +271,7 @@ static struct io_plan *json_stream_output_write(struct io_conn *conn,
 	if (!p) {
 		/* We're not doing io_write now, unset. */
 		js->reader = NULL;
+		json_stream_drained(js);
 		if (!json_stream_still_writing(js))
 			return js->reader_cb(conn, js, js->reader_arg);
 		return io_out_wait(conn, js, json_stream_output_write, js);
@@ -290,33 +299,100 @@ struct io_plan *json_stream_output_(struct json_stream *js,
 	return json_stream_output_write(conn, js);
 }
 
+size_t json_stream_buffered(const struct json_stream *js)
+{
+	size_t len;
+
+	json_out_contents(js->jout, &len);
+	return len;
+}
+
+void json_stream_reserve(struct json_stream *js, size_t len)
+{
+	assert(json_stream_total_len(js) == 0);
+
+	/* json_out has no reserve, but consuming leaves the space behind */
+	if (json_out_direct(js->jout, len))
+		json_out_consume(js->jout, len);
+}
+
+size_t json_stream_total_len(const struct json_stream *js)
+{
+	return js->written + json_stream_buffered(js);
+}
+
+void json_stream_on_drain_(struct json_stream *js,
+			   void (*cb)(void *arg),
+			   void *arg)
+{
+	assert(!js->drain_cb);
+	js->drain_cb = cb;
+	js->drain_arg = arg;
+}
+
+void json_stream_drained(struct json_stream *js)
+{
+	void (*cb)(void *arg) = js->drain_cb;
+
+	if (!cb)
+		return;
+	/* Clear first: cb may register again. */
+	js->drain_cb = NULL;
+	cb(js->drain_arg);
+}
+
+/* Numbers are most of what we output (listforwards, listpeerchannels...),
+ * so convert them ourselves rather than going through vsnprintf. */
+static void json_add_int(struct json_stream *js, const char *fieldname,
+			 bool negative, u64 magnitude)
+{
+	char buf[sizeof("-18446744073709551615")];
+	char *p = buf + sizeof(buf);
+	size_t len;
+
+	if (!json_filter_ok(js->filter, fieldname))
+		return;
+
+	do {
+		*(--p) = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude);
+	if (negative)
+		*(--p) = '-';
+
+	len = buf + sizeof(buf) - p;
+	memcpy(json_member_direct(js, fieldname, len), p, len);
+}
+
 void json_add_num(struct json_stream *result, const char *fieldname, unsigned int value)
 {
-	json_add_primitive_fmt(result, fieldname, "%u", value);
+	json_add_int(result, fieldname, false, value);
 }
 
 void json_add_u64(struct json_stream *result, const char *fieldname,
 		  uint64_t value)
 {
-	json_add_primitive_fmt(result, fieldname, "%"PRIu64, value);
+	json_add_int(result, fieldname, false, value);
 }
 
 void json_add_s64(struct json_stream *result, const char *fieldname,
 		  int64_t value)
 {
-	json_add_primitive_fmt(result, fieldname, "%"PRIi64, value);
+	/* Negating as unsigned is fine even for INT64_MIN */
+	json_add_int(result, fieldname, value < 0,
+		     value < 0 ? -(u64)value : (u64)value);
 }
 
 void json_add_u32(struct json_stream *result, const char *fieldname,
 		  uint32_t value)
 {
-	json_add_primitive_fmt(result, fieldname, "%u", value);
+	json_add_int(result, fieldname, false, value);
 }
 
 void json_add_s32(struct json_stream *result, const char *fieldname,
 		  int32_t value)
 {
-	json_add_primitive_fmt(result, fieldname, "%d", value);
+	json_add_s64(result, fieldname, value);
 }
 
 void json_add_stringn(struct json_stream *result, const char *fieldname,
@@ -340,14 +416,23 @@ void json_add_null(struct json_stream *stream, const char *fieldname)
 void json_add_hex(struct json_stream *js, const char *fieldname,
 		  const void *data, size_t len)
 {
-	/* Size without NUL term */
-	size_t hexlen = hex_str_size(len);
-	char str[hexlen];
+	static const char hexdigits[] = "0123456789abcdef";
+	const u8 *p = data;
+	char *dest;
 
-	if (!hex_encode(data, len, str, hexlen))
-		abort();
+	if (!json_filter_ok(js->filter, fieldname))
+		return;
 
-	json_add_string(js, fieldname, str);
+	/* Hex never needs escaping, so write it straight into the stream:
+	 * transactions and PSBTs can be megabytes, which we don't want on
+	 * the stack or scanned again by json_out_addstr. */
+	dest = json_member_direct(js, fieldname, 1 + len * 2 + 1);
+	*(dest++) = '"';
+	for (size_t i = 0; i < len; i++) {
+		*(dest++) = hexdigits[p[i] >> 4];
+		*(dest++) = hexdigits[p[i] & 0xF];
+	}
+	*dest = '"';
 }
 
 void json_add_hex_talarr(struct json_stream *result,
@@ -417,6 +502,28 @@ void json_add_tok(struct json_stream *result, const char *fieldname,
 	if (!json_filter_ok(result->filter, fieldname))
 		return;
 
+	/* If we're filtering, we need to walk inside. */
+	if (result->filter
+	    && (tok->type == JSMN_OBJECT || tok->type == JSMN_ARRAY)) {
+		const jsmntok_t *t;
+		size_t i;
+
+		if (tok->type == JSMN_OBJECT) {
+			json_object_start(result, fieldname);
+			json_for_each_obj(i, t, tok)
+				json_add_tok(result,
+					     json_strdup(tmpctx, buffer, t),
+					     t + 1, buffer);
+			json_object_end(result);
+		} else {
+			json_array_start(result, fieldname);
+			json_for_each_arr(i, t, tok)
+				json_add_tok(result, NULL, t, buffer);
+			json_array_end(result);
+		}
+		return;
+	}
+
 	space = json_member_direct(result, fieldname, json_tok_full_len(tok));
 	memcpy(space, json_tok_full(buffer, tok), json_tok_full_len(tok));
 }
@@ -48,6 +48,12 @@ struct json_stream {
 				     void *arg);
 	void *reader_arg;
 	size_t len_read;
+	/* How much reader has written out in total */
+	size_t written;
+
+	/* If non-NULL, called once reader has written everything out */
+	void (*drain_cb)(void *arg);
+	void *drain_arg;
 
 	/* If non-NULL, reflects the current filter position */
 	struct json_filter *filter;
@@ -90,6 +96,10 @@ void json_stream_attach_filter(struct json_stream *js,
 /* Detach the filter: returns non-NULL string if it was misused. */
 const char *json_stream_detach_filter(const tal_t *ctx, struct json_stream *js);
 
+/* Will anything be printed for this field (given the filter, if any)?
+ * Use it to avoid computing expensive fields which will be filtered out. */
+bool json_stream_wants(const struct json_stream *js, const char *fieldname);
+
 /**
  * json_stream_close - finished writing to a JSON stream.
  * @js: the json_stream.
@@ -199,6 +209,59 @@ struct io_plan *json_stream_output_(struct json_stream *js,
 							  void *arg),
 				    void *arg);
 
+/**
+ * json_stream_reserve - make room for @len bytes up front.
+ * @js: the json_stream, which must be empty.
+ * @len: how many bytes we expect to buffer.
+ *
+ * Saves repeated reallocation when the caller knows roughly how big
+ * the output will be.
+ */
+void json_stream_reserve(struct json_stream *js, size_t len);
+
+/**
+ * json_stream_buffered - how many bytes are waiting to be written out?
+ * @js: the json_stream
+ */
+size_t json_stream_buffered(const struct json_stream *js);
+
+/**
+ * json_stream_total_len - how many bytes have gone into this stream?
+ * @js: the json_stream
+ *
+ * This is everything written out so far, plus anything still buffered.
+ */
+size_t json_stream_total_len(const struct json_stream *js);
+
+/**
+ * json_stream_on_drain - call @cb once the reader has written everything.
+ * @js: the json_stream
+ * @cb: the callback to call (once) when the buffer empties.
+ * @arg: the argument to @cb
+ *
+ * This lets a writer producing a huge response stop once it has
+ * buffered enough, and continue where it left off.  Note that @cb is
+ * called from inside the reader's io callback, so it shouldn't write
+ * to @js directly.  You need to json_stream_flush() to wake the reader.
+ */
+#define json_stream_on_drain(js, cb, arg)				\
+	json_stream_on_drain_((js),					\
+			      typesafe_cb(void, void *, (cb), (arg)),	\
+			      (arg))
+
+void json_stream_on_drain_(struct json_stream *js,
+			   void (*cb)(void *arg),
+			   void *arg);
+
+/**
+ * json_stream_drained - call json_stream_on_drain callback, if any.
+ * @js: the json_stream
+ *
+ * The reader does this itself, but if it goes away the writer would
+ * wait forever.
+ */
+void json_stream_drained(struct json_stream *js);
+
 /* Ensure there's a double \n after a JSON response. */
 void json_stream_double_cr(struct json_stream *js);
 void json_stream_flush(struct json_stream *js);
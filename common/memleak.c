@@ -21,6 +21,7 @@
  */
 #include "config.h"
 #include <backtrace.h>
+#include <ccan/asort/asort.h>
 #include <ccan/cast/cast.h>
 #include <ccan/crypto/siphash24/siphash24.h>
 #include <ccan/htable/htable.h>
@@ -381,6 +382,91 @@ bool dump_memleak(struct htable *memtable,
 
 	return found_leak;
 }
+
+typedef STRMAP(struct memstat *) memstat_map;
+
+static void tally_memstats(const tal_t *ctx, const tal_t *root,
+			   memstat_map *map, struct memstat ***stats)
+{
+	const char *parent_label = root ? tal_name(root) : NULL;
+
+	for (const tal_t *i = tal_first(root); i; i = tal_next(i)) {
+		const char *label = tal_name(i);
+		char key[256];
+		struct memstat *st;
+
+		/* Don't count (or walk into) our own results! */
+		if (i == ctx)
+			continue;
+
+		snprintf(key, sizeof(key), "%s/%s",
+			 label ? label : "", parent_label ? parent_label : "");
+		st = strmap_get(map, key);
+		if (!st) {
+			st = tal(ctx, struct memstat);
+			/* Nothing is freed while we walk, so these stay valid */
+			st->label = label;
+			st->parent_label = parent_label;
+			st->count = st->bytes = 0;
+			strmap_add(map, tal_strdup(st, key), st);
+			tal_arr_expand(stats, st);
+		}
+		st->count++;
+		st->bytes += tal_bytelen(i);
+
+		tally_memstats(ctx, i, map, stats);
+	}
+}
+
+static int memstat_cmp(struct memstat *const *a, struct memstat *const *b,
+		       void *unused)
+{
+	if ((*a)->bytes > (*b)->bytes)
+		return -1;
+	if ((*a)->bytes < (*b)->bytes)
+		return 1;
+	return 0;
+}
+
+struct memstat *memstats(const tal_t *ctx, const tal_t *root)
+{
+	memstat_map map;
+	struct memstat **stats;
+	struct memstat *ret;
+	/* Everything is allocated off this, so we can skip it while walking */
+	const tal_t *tmp = tal(NULL, char);
+
+	strmap_init(&map);
+	stats = tal_arr(tmp, struct memstat *, 0);
+	tally_memstats(tmp, root, &map, &stats);
+	strmap_clear(&map);
+
+	asort(stats, tal_count(stats), memstat_cmp, NULL);
+	ret = tal_arr(ctx, struct memstat, tal_count(stats));
+	for (size_t i = 0; i < tal_count(stats); i++) {
+		ret[i] = *stats[i];
+		if (ret[i].label)
+			ret[i].label = tal_strdup(ret, ret[i].label);
+		if (ret[i].parent_label)
+			ret[i].parent_label = tal_strdup(ret,
+							 ret[i].parent_label);
+	}
+	tal_free(tmp);
+	return ret;
+}
+
+void dump_memstats(const tal_t *root, size_t max,
+		   void PRINTF_FMT(1,2) (*print)(const char *fmt, ...))
+{
+	struct memstat *stats = memstats(NULL, root);
+
+	for (size_t i = 0; i < tal_count(stats) && i < max; i++)
+		print("MEMSTAT: %zu bytes in %zu allocations: %s (parent %s)",
+		      stats[i].bytes, stats[i].count,
+		      stats[i].label ? stats[i].label : "unlabelled",
+		      stats[i].parent_label ? stats[i].parent_label : "none");
+	tal_free(stats);
+}
 #else /* !DEVELOPER */
 void *notleak_(void *ptr, bool plus_children UNNEEDED)
 {
@@ -151,6 +151,25 @@ extern struct backtrace_state *backtrace_state;
 /* Only defined if DEVELOPER */
 bool dump_memleak(struct htable *memtable,
 		  void PRINTF_FMT(1,2) (*print)(const char *fmt, ...));
+
+/* Live allocations sharing a tal label and parent label. */
+struct memstat {
+	const char *label, *parent_label;
+	size_t count, bytes;
+};
+
+/**
+ * memstats - tally all allocations under @root by label and parent label.
+ * @ctx: context for the returned array (never counted itself).
+ * @root: tal tree to walk (NULL for everything).
+ *
+ * Returns an array sorted by bytes, highest first.  Labels may be NULL.
+ */
+struct memstat *memstats(const tal_t *ctx, const tal_t *root);
+
+/* Print the @max biggest entries from memstats() of @root. */
+void dump_memstats(const tal_t *root, size_t max,
+		   void PRINTF_FMT(1,2) (*print)(const char *fmt, ...));
 #endif
 
 #endif /* LIGHTNING_COMMON_MEMLEAK_H */
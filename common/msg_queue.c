@@ -6,7 +6,9 @@
 
 struct msg_queue {
 	bool fd_passing;
+	/* Messages before q[head] have already been dequeued. */
 	const u8 **q;
+	size_t head;
 };
 
 struct msg_queue *msg_queue_new(const tal_t *ctx, bool fd_passing)
@@ -14,11 +16,20 @@ struct msg_queue *msg_queue_new(const tal_t *ctx, bool fd_passing)
 	struct msg_queue *q = tal(ctx, struct msg_queue);
 	q->fd_passing = fd_passing;
 	q->q = tal_arr(q, const u8 *, 0);
+	q->head = 0;
 	return q;
 }
 
 static void do_enqueue(struct msg_queue *q, const u8 *add TAKES)
 {
+	/* If we never drain completely, don't let the dead slots at the
+	 * front grow forever. */
+	if (q->head > 32 && q->head * 2 > tal_count(q->q)) {
+		size_t n = tal_count(q->q) - q->head;
+		memmove(q->q, q->q + q->head, sizeof(*q->q) * n);
+		tal_resize(&q->q, n);
+		q->head = 0;
+	}
 	tal_arr_expand(&q->q, tal_dup_talarr(q, u8, add));
 
 	/* In case someone is waiting */
@@ -27,7 +38,7 @@ static void do_enqueue(struct msg_queue *q, const u8 *add TAKES)
 
 size_t msg_queue_length(const struct msg_queue *q)
 {
-	return tal_count(q->q);
+	return tal_count(q->q) - q->head;
 }
 
 void msg_enqueue(struct msg_queue *q, const u8 *add)
@@ -48,18 +59,44 @@ void msg_enqueue_fd(struct msg_queue *q, int fd)
 
 const u8 *msg_dequeue(struct msg_queue *q)
 {
-	size_t n = tal_count(q->q);
 	const u8 *msg;
 
-	if (!n)
+	if (q->head == tal_count(q->q))
 		return NULL;
 
-	msg = q->q[0];
-	memmove(q->q, q->q + 1, sizeof(*q->q) * (n-1));
-	tal_resize(&q->q, n-1);
+	/* Don't shuffle (and realloc) the whole queue for every message:
+	 * just advance, and reset once it's empty. */
+	msg = q->q[q->head++];
+	if (q->head == tal_count(q->q)) {
+		tal_resize(&q->q, 0);
+		q->head = 0;
+	}
 	return msg;
 }
 
+const u8 **msg_dequeue_batch(const tal_t *ctx, struct msg_queue *q)
+{
+	const u8 **msgs;
+	size_t n;
+
+	for (n = 0; q->head + n < tal_count(q->q); n++) {
+		if (q->fd_passing
+		    && fromwire_peektype(q->q[q->head + n]) == MSG_PASS_FD)
+			break;
+	}
+	if (n == 0)
+		return NULL;
+
+	msgs = tal_arr(ctx, const u8 *, n);
+	for (size_t i = 0; i < n; i++)
+		msgs[i] = tal_steal(msgs, q->q[q->head++]);
+	if (q->head == tal_count(q->q)) {
+		tal_resize(&q->q, 0);
+		q->head = 0;
+	}
+	return msgs;
+}
+
 int msg_extract_fd(const struct msg_queue *q, const u8 *msg)
 {
 	const u8 *p = msg + sizeof(u16);
@@ -27,6 +27,10 @@ void msg_wake(const struct msg_queue *q);
 /* Returns NULL if nothing to do. */
 const u8 *msg_dequeue(struct msg_queue *q);
 
+/* Returns NULL if nothing to do, or the next entry is an fd: otherwise all
+ * the messages up to the next fd, in order (they're freed with the array). */
+const u8 **msg_dequeue_batch(const tal_t *ctx, struct msg_queue *q);
+
 /* Returns -1 if not an fd: close after sending. */
 int msg_extract_fd(const struct msg_queue *q, const u8 *msg);
 
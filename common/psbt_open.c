@@ -24,37 +24,75 @@ bool psbt_get_serial_id(const struct wally_map *map, u64 *serial_id)
 	return true;
 }
 
-static int compare_serials(const struct wally_map *map_a,
-			   const struct wally_map *map_b)
+/* Looking up a serial_id means searching the unknowns map (and allocating
+ * the key), so when sorting we extract them all once, up front. */
+struct serial_idx {
+	u64 serial;
+	size_t idx;
+};
+
+static u64 serial_of(const struct wally_map *map)
 {
-	u64 serial_left, serial_right;
+	u64 serial_id;
 	bool ok;
 
-	ok = psbt_get_serial_id(map_a, &serial_left);
-	assert(ok);
-	ok = psbt_get_serial_id(map_b, &serial_right);
+	ok = psbt_get_serial_id(map, &serial_id);
 	assert(ok);
-	if (serial_left > serial_right)
+	return serial_id;
+}
+
+static int compare_serial_idx(const struct serial_idx *a,
+			      const struct serial_idx *b,
+			      void *unused UNUSED)
+{
+	if (a->serial > b->serial)
 		return 1;
-	if (serial_left < serial_right)
+	if (a->serial < b->serial)
 		return -1;
 	return 0;
 }
 
-static int compare_inputs_at(const struct input_set *a,
-			     const struct input_set *b,
-			     void *unused UNUSED)
+/* Returns false if it was already in order (usual for later rounds,
+ * since we keep the psbt sorted). */
+static bool sort_serials(struct serial_idx *order)
 {
-	return compare_serials(&a->input.unknowns,
-			       &b->input.unknowns);
+	size_t i;
+
+	for (i = 1; i < tal_count(order); i++) {
+		if (order[i-1].serial > order[i].serial)
+			break;
+	}
+	if (i >= tal_count(order))
+		return false;
+
+	asort(order, tal_count(order), compare_serial_idx, NULL);
+	return true;
 }
 
-static int compare_outputs_at(const struct output_set *a,
-			      const struct output_set *b,
-			      void *unused UNUSED)
+static struct serial_idx *input_serials(const tal_t *ctx,
+					const struct wally_psbt *psbt)
 {
-	return compare_serials(&a->output.unknowns,
-			       &b->output.unknowns);
+	struct serial_idx *order = tal_arr(ctx, struct serial_idx,
+					   psbt->num_inputs);
+
+	for (size_t i = 0; i < tal_count(order); i++) {
+		order[i].serial = serial_of(&psbt->inputs[i].unknowns);
+		order[i].idx = i;
+	}
+	return order;
+}
+
+static struct serial_idx *output_serials(const tal_t *ctx,
+					 const struct wally_psbt *psbt)
+{
+	struct serial_idx *order = tal_arr(ctx, struct serial_idx,
+					   psbt->num_outputs);
+
+	for (size_t i = 0; i < tal_count(order); i++) {
+		order[i].serial = serial_of(&psbt->outputs[i].unknowns);
+		order[i].idx = i;
+	}
+	return order;
 }
 
 static const u8 *linearize_input(const tal_t *ctx,
@@ -162,49 +200,52 @@ static bool output_identical(const struct wally_psbt *a,
 
 static void sort_inputs(struct wally_psbt *psbt)
 {
-	/* Build an input map */
-	struct input_set *set = tal_arr(NULL,
-					struct input_set,
-					psbt->num_inputs);
-
-	for (size_t i = 0; i < tal_count(set); i++) {
-		set[i].tx_input = psbt->tx->inputs[i];
-		set[i].input = psbt->inputs[i];
-	}
+	struct serial_idx *order = input_serials(NULL, psbt);
+
+	if (sort_serials(order)) {
+		/* Build an input map */
+		struct input_set *set = tal_arr(order,
+						struct input_set,
+						psbt->num_inputs);
 
-	asort(set, tal_count(set),
-	      compare_inputs_at, NULL);
+		for (size_t i = 0; i < tal_count(set); i++) {
+			set[i].tx_input = psbt->tx->inputs[order[i].idx];
+			set[i].input = psbt->inputs[order[i].idx];
+		}
 
-	/* Put PSBT parts into place */
-	for (size_t i = 0; i < tal_count(set); i++) {
-		psbt->inputs[i] = set[i].input;
-		psbt->tx->inputs[i] = set[i].tx_input;
+		/* Put PSBT parts into place */
+		for (size_t i = 0; i < tal_count(set); i++) {
+			psbt->inputs[i] = set[i].input;
+			psbt->tx->inputs[i] = set[i].tx_input;
+		}
 	}
 
-	tal_free(set);
+	tal_free(order);
 }
 
 static void sort_outputs(struct wally_psbt *psbt)
 {
-	/* Build an output map */
-	struct output_set *set = tal_arr(NULL,
-					 struct output_set,
-					 psbt->num_outputs);
-	for (size_t i = 0; i < tal_count(set); i++) {
-		set[i].tx_output = psbt->tx->outputs[i];
-		set[i].output = psbt->outputs[i];
-	}
+	struct serial_idx *order = output_serials(NULL, psbt);
 
-	asort(set, tal_count(set),
-	      compare_outputs_at, NULL);
+	if (sort_serials(order)) {
+		/* Build an output map */
+		struct output_set *set = tal_arr(order,
+						 struct output_set,
+						 psbt->num_outputs);
 
-	/* Put PSBT parts into place */
-	for (size_t i = 0; i < tal_count(set); i++) {
-		psbt->outputs[i] = set[i].output;
-		psbt->tx->outputs[i] = set[i].tx_output;
+		for (size_t i = 0; i < tal_count(set); i++) {
+			set[i].tx_output = psbt->tx->outputs[order[i].idx];
+			set[i].output = psbt->outputs[order[i].idx];
+		}
+
+		/* Put PSBT parts into place */
+		for (size_t i = 0; i < tal_count(set); i++) {
+			psbt->outputs[i] = set[i].output;
+			psbt->tx->outputs[i] = set[i].tx_output;
+		}
 	}
 
-	tal_free(set);
+	tal_free(order);
 }
 
 void psbt_sort_by_serial_id(struct wally_psbt *psbt)
@@ -240,15 +281,19 @@ struct psbt_changeset *psbt_get_changeset(const tal_t *ctx,
 					  struct wally_psbt *orig,
 					  struct wally_psbt *new)
 {
-	int result;
 	size_t i = 0, j = 0;
 	struct psbt_changeset *set;
+	const struct serial_idx *orig_serials, *new_serials;
 
 	psbt_sort_by_serial_id(orig);
 	psbt_sort_by_serial_id(new);
 
 	set = new_changeset(ctx);
 
+	/* Both are now sorted, so this is a simple merge. */
+	orig_serials = input_serials(tmpctx, orig);
+	new_serials = input_serials(tmpctx, new);
+
 	/* Find the input diff */
 	while (i < orig->num_inputs || j < new->num_inputs) {
 		if (i >= orig->num_inputs) {
@@ -262,14 +307,12 @@ struct psbt_changeset *psbt_get_changeset(const tal_t *ctx,
 			continue;
 		}
 
-		result = compare_serials(&orig->inputs[i].unknowns,
-					 &new->inputs[j].unknowns);
-		if (result == -1) {
+		if (orig_serials[i].serial < new_serials[j].serial) {
 			ADD(input, set->rm_ins, orig, i);
 			i++;
 			continue;
 		}
-		if (result == 1) {
+		if (orig_serials[i].serial > new_serials[j].serial) {
 			ADD(input, set->added_ins, new, j);
 			j++;
 			continue;
@@ -285,6 +328,8 @@ struct psbt_changeset *psbt_get_changeset(const tal_t *ctx,
 	/* Find the output diff */
 	i = 0;
 	j = 0;
+	orig_serials = output_serials(tmpctx, orig);
+	new_serials = output_serials(tmpctx, new);
 	while (i < orig->num_outputs || j < new->num_outputs) {
 		if (i >= orig->num_outputs) {
 			ADD(output, set->added_outs, new, j);
@@ -297,14 +342,12 @@ struct psbt_changeset *psbt_get_changeset(const tal_t *ctx,
 			continue;
 		}
 
-		result = compare_serials(&orig->outputs[i].unknowns,
-					 &new->outputs[j].unknowns);
-		if (result == -1) {
+		if (orig_serials[i].serial < new_serials[j].serial) {
 			ADD(output, set->rm_outs, orig, i);
 			i++;
 			continue;
 		}
-		if (result == 1) {
+		if (orig_serials[i].serial > new_serials[j].serial) {
 			ADD(output, set->added_outs, new, j);
 			j++;
 			continue;
@@ -6,6 +6,7 @@
 #include <common/onionreply.h>
 #include <common/overflows.h>
 #include <common/sphinx.h>
+#include <common/trace_probe.h>
 
 
 #include <secp256k1_ecdh.h>
@@ -608,38 +609,42 @@ struct route_step *process_onionpacket(
 {
 	struct route_step *step = talz(ctx, struct route_step);
 	struct hmac hmac;
-	struct keyset keys;
+	struct secret rho, mu;
 	u8 blind[BLINDING_FACTOR_SIZE];
-	u8 *paddedheader;
-	size_t payload_size;
+	u8 *header;
+	size_t payload_size, len = tal_bytelen(msg->routinginfo);
 	bigsize_t shift_size;
 	const u8 *cursor;
 	size_t max;
 
+	TRACE_PROBE(process_onionpacket_start);
+
 	step->next = talz(step, struct onionpacket);
 	step->next->version = msg->version;
-	generate_key_set(shared_secret, &keys);
 
-	compute_packet_hmac(msg, assocdata, assocdatalen, &keys.mu, &hmac);
+	/* We only need two of the keys generate_key_set() would make. */
+	subkey_from_hmac("mu", shared_secret, &mu);
+	compute_packet_hmac(msg, assocdata, assocdatalen, &mu, &hmac);
 
 	if (!hmac_eq(&msg->hmac, &hmac)
 	    || IFDEV(dev_fail_process_onionpacket, false)) {
 		/* Computed MAC does not match expected MAC, the message was modified. */
-		return tal_free(step);
+		goto fail;
 	}
 
 	//FIXME:store seen secrets to avoid replay attacks
-	paddedheader = tal_arrz(step, u8, tal_bytelen(msg->routinginfo)*2);
-	memcpy(paddedheader, msg->routinginfo, tal_bytelen(msg->routinginfo));
-	xor_cipher_stream(paddedheader, &keys.rho, tal_bytelen(paddedheader));
+	/* We decrypt in place, in what becomes the next routinginfo. */
+	subkey_from_hmac("rho", shared_secret, &rho);
+	header = tal_dup_arr(step->next, u8, msg->routinginfo, len, 0);
+	xor_cipher_stream(header, &rho, len);
 
 	compute_blinding_factor(&msg->ephemeralkey, shared_secret, blind);
 	if (!blind_group_element(&step->next->ephemeralkey, &msg->ephemeralkey, blind))
-		return tal_free(step);
+		goto fail;
 
 	/* Now, try to pull data out. */
-	cursor = paddedheader;
-	max = tal_bytelen(msg->routinginfo);
+	cursor = header;
+	max = len;
 
 	/* Any of these could fail, falling thru with cursor == NULL */
 	payload_size = fromwire_bigsize(&cursor, &max);
@@ -647,8 +652,8 @@ struct route_step *process_onionpacket(
 	 * means we can't just ust fromwire_tal_arrn. */
 	fromwire_pad(&cursor, &max, payload_size);
 	if (cursor != NULL)
-		step->raw_payload = tal_dup_arr(step, u8, paddedheader,
-						cursor - paddedheader, 0);
+		step->raw_payload = tal_dup_arr(step, u8, header,
+						cursor - header, 0);
 	fromwire_hmac(&cursor, &max, &step->next->hmac);
 
 	/* BOLT-remove-legacy-onion #4:
@@ -656,16 +661,18 @@ struct route_step *process_onionpacket(
 	 * reserved.  (`0` indicated a legacy format no longer supported, and `1` is reserved for future
 	 * use). */
 	if (payload_size < 2 || !cursor)
-		return tal_free(step);
+		goto fail;
 
 	/* This includes length field and hmac */
-	shift_size = cursor - paddedheader;
+	shift_size = cursor - header;
 
-	/* Left shift the current payload out and make the remainder the new onion */
-	step->next->routinginfo = tal_dup_arr(step->next,
-					      u8,
-					      paddedheader + shift_size,
-					      tal_bytelen(msg->routinginfo), 0);
+	/* Left shift the current payload out and make the remainder the new
+	 * onion: the gap at the end is zeroes XORed with the stream, so we
+	 * only generate the part of the stream beyond @len that we need. */
+	memmove(header, header + shift_size, len - shift_size);
+	memset(header + len - shift_size, 0, shift_size);
+	xor_cipher_stream_off(&rho, len, header + len - shift_size, shift_size);
+	step->next->routinginfo = header;
 
 	if (memeqzero(step->next->hmac.bytes, sizeof(step->next->hmac.bytes))) {
 		step->nextcase = ONION_END;
@@ -673,8 +680,12 @@ struct route_step *process_onionpacket(
 		step->nextcase = ONION_FORWARD;
 	}
 
-	tal_free(paddedheader);
+	TRACE_PROBE1(process_onionpacket_end, true);
 	return step;
+
+fail:
+	TRACE_PROBE1(process_onionpacket_end, false);
+	return tal_free(step);
 }
 
 #if DEVELOPER
@@ -772,36 +783,38 @@ u8 *unwrap_onionreply(const tal_t *ctx,
 		      const struct onionreply *reply,
 		      int *origin_index)
 {
-	struct onionreply *r;
+	u8 *contents, *ret;
 	const u8 *cursor;
-	size_t max;
+	size_t len, max;
+	struct hmac hmac;
 	u16 msglen;
 
-	r = new_onionreply(tmpctx, reply->contents);
 	*origin_index = -1;
 
+	/* Too short. */
+	len = tal_bytelen(reply->contents);
+	if (len < sizeof(hmac.bytes))
+		return NULL;
+
+	/* We peel every layer off the same copy, rather than having
+	 * wrap_onionreply() duplicate the whole reply once per hop. */
+	contents = tal_dup_talarr(tmpctx, u8, reply->contents);
 	for (int i = 0; i < numhops; i++) {
 		struct secret key;
-		struct hmac hmac, expected_hmac;
+		struct hmac expected_hmac;
 
 		/* Since the encryption is just XORing with the cipher
 		 * stream encryption is identical to decryption */
-		r = wrap_onionreply(tmpctx, &shared_secrets[i], r);
+		subkey_from_hmac("ammag", &shared_secrets[i], &key);
+		xor_cipher_stream(contents, &key, len);
 
 		/* Check if the HMAC matches, this means that this is
 		 * the origin */
 		subkey_from_hmac("um", &shared_secrets[i], &key);
-
-		cursor = r->contents;
-		max = tal_count(r->contents);
-
-		fromwire_hmac(&cursor, &max, &hmac);
-		/* Too short. */
-		if (!cursor)
-			return NULL;
-
-		compute_hmac(&key, cursor, max, NULL, 0, &expected_hmac);
-		if (hmac_eq(&hmac, &expected_hmac)) {
+		compute_hmac(&key, contents + sizeof(hmac.bytes),
+			     len - sizeof(hmac.bytes), NULL, 0, &expected_hmac);
+		if (memeq(contents, sizeof(hmac.bytes),
+			  expected_hmac.bytes, sizeof(expected_hmac.bytes))) {
 			*origin_index = i;
 			break;
 		}
@@ -809,11 +822,17 @@ u8 *unwrap_onionreply(const tal_t *ctx,
 
 	/* Didn't find source, it's garbled */
 	if (*origin_index == -1) {
+		tal_free(contents);
 		return NULL;
 	}
 
+	cursor = contents;
+	max = len;
+	fromwire_hmac(&cursor, &max, &hmac);
 	msglen = fromwire_u16(&cursor, &max);
-	return fromwire_tal_arrn(ctx, &cursor, &max, msglen);
+	ret = fromwire_tal_arrn(ctx, &cursor, &max, msglen);
+	tal_free(contents);
+	return ret;
 }
 
 struct onionpacket *sphinx_decompress(const tal_t *ctx,
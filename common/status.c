@@ -243,4 +243,13 @@ void memleak_status_broken(const char *fmt, ...)
 	status_vfmt(LOG_BROKEN, NULL, fmt, ap);
 	va_end(ap);
 }
+
+/* Print DEBUG status: callback for dump_memstats. */
+void memleak_status_debug(const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	status_vfmt(LOG_DBG, NULL, fmt, ap);
+	va_end(ap);
+}
 #endif
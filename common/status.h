@@ -73,6 +73,8 @@ void status_send_fd(int fd);
 #if DEVELOPER
 /* Print BROKEN status: callback for dump_memleak. */
 void memleak_status_broken(const char *fmt, ...);
+/* Print DEBUG status: callback for dump_memstats. */
+void memleak_status_debug(const char *fmt, ...);
 #endif
 
 #endif /* LIGHTNING_COMMON_STATUS_H */
@@ -113,6 +113,13 @@ static void test_b11(const char *b11str,
 	}
 	assert(!expect_extra);
 
+	/* Second decode comes from the signature cache: same answer. */
+	assert(node_id_eq(&b11->receiver_id, &expect_b11->receiver_id));
+	b11 = bolt11_decode(tmpctx, b11str, NULL, hashed_desc,
+			    expect_b11->chain, &fail);
+	assert(b11);
+	assert(node_id_eq(&b11->receiver_id, &expect_b11->receiver_id));
+
 	/* FIXME: Spec changed to require c fields, but test vectors don't! */
 
 #if DEVELOPER
@@ -6,6 +6,7 @@
 #include "../bolt12_merkle.c"
 #include <assert.h>
 #include <ccan/array_size/array_size.h>
+#include <ccan/cast/cast.h>
 #include <common/channel_type.h>
 #include <common/features.h>
 #include <common/setup.h>
@@ -204,6 +204,22 @@ int main(int argc, char *argv[])
 		dec = cryptomsg_decrypt_body(enc, &cs_in, enc);
 		assert(memeq(dec, tal_bytelen(dec), msg, tal_bytelen(msg)));
 	}
+
+	/* Appending gives the same stream as encrypting one at a time. */
+	cs_in = cs_out;
+	{
+		u8 *batch = tal_arr(tmpctx, u8, 0), *one, *two;
+
+		cryptomsg_encrypt_msg_append(&cs_out, msg, &batch);
+		cryptomsg_encrypt_msg_append(&cs_out, msg, &batch);
+		one = cryptomsg_encrypt_msg(tmpctx, &cs_in, msg);
+		two = cryptomsg_encrypt_msg(tmpctx, &cs_in, msg);
+		assert(tal_bytelen(batch) == tal_bytelen(one) + tal_bytelen(two));
+		assert(memeq(batch, tal_bytelen(one), one, tal_bytelen(one)));
+		assert(memeq(batch + tal_bytelen(one), tal_bytelen(two),
+			     two, tal_bytelen(two)));
+		assert(cs_in.sn == cs_out.sn);
+	}
 	common_shutdown();
 	return 0;
 }
@@ -266,12 +266,14 @@ static void check_cannounce(const u8 *cannounce,
 	}
 }
 
-static void check_nannounce(const u8 *nannounce,
+static void check_nannounce(const struct gossmap *map,
+			    const struct gossmap_node *gnode,
+			    const u8 *nannounce,
 			    const struct node_id *n)
 {
 	secp256k1_ecdsa_signature sig;
 	u8 *features, *addresses;
-	u32 timestamp;
+	u32 timestamp, map_timestamp;
 	u8 rgb_color[3], alias[32];
 	struct node_id node_id;
 	struct tlv_node_ann_tlvs *na_tlvs;
@@ -284,6 +286,28 @@ static void check_nannounce(const u8 *nannounce,
 					  &addresses,
 					  &na_tlvs));
 	assert(node_id_eq(&node_id, n));
+	assert(gossmap_node_get_timestamp(map, gnode, &map_timestamp));
+	assert(map_timestamp == timestamp);
+}
+
+/* Edges must always match what we'd get by walking the channels. */
+static void check_edges(const struct gossmap *map)
+{
+	for (const struct gossmap_node *n = gossmap_first_node(map);
+	     n;
+	     n = gossmap_next_node(map, n)) {
+		const struct gossmap_edge *e = gossmap_node_edges(map, n);
+		assert(e);
+		for (size_t i = 0; i < n->num_chans; i++) {
+			int which_half;
+			struct gossmap_chan *c = gossmap_nth_chan(map, n, i,
+								  &which_half);
+			assert(e[i].chan_idx == gossmap_chan_idx(map, c));
+			assert(e[i].dir == !which_half);
+			assert(memcmp(&e[i].half, &c->half[!which_half],
+				      sizeof(e[i].half)) == 0);
+		}
+	}
 }
 
 int main(int argc, char *argv[])
@@ -296,6 +320,7 @@ int main(int argc, char *argv[])
 	struct gossmap_chan *chan;
 	struct gossmap_localmods *mods;
 	struct amount_sat capacity;
+	u64 gen;
 	u32 timestamp, fee_base_msat, fee_proportional_millionths;
 	u8 message_flags, channel_flags;
 	struct amount_msat htlc_minimum_msat, htlc_maximum_msat;
@@ -308,6 +333,9 @@ int main(int argc, char *argv[])
 
 	map = gossmap_load(tmpctx, gossfile, NULL);
 	assert(map);
+	assert(!gossmap_node_edges(map, gossmap_first_node(map)));
+	gossmap_enable_edges(map);
+	check_edges(map);
 
 	/* There is a public channel 2<->3 (103x1x0), and private
 	 * 1<->2 (110x1x1). */
@@ -414,12 +442,14 @@ int main(int argc, char *argv[])
 	nann = gossmap_node_get_announce(tmpctx, map,
 					 gossmap_find_node(map, &l1));
 	assert(!nann);
+	assert(!gossmap_node_get_timestamp(map, gossmap_find_node(map, &l1),
+					   &timestamp));
 	nann = gossmap_node_get_announce(tmpctx, map,
 					 gossmap_find_node(map, &l2));
-	check_nannounce(nann, &l2);
+	check_nannounce(map, gossmap_find_node(map, &l2), nann, &l2);
 	nann = gossmap_node_get_announce(tmpctx, map,
 					 gossmap_find_node(map, &l3));
-	check_nannounce(nann, &l3);
+	check_nannounce(map, gossmap_find_node(map, &l3), nann, &l3);
 
 	/* Now, let's add a new channel l1 -> l4. */
 	mods = gossmap_localmods_new(tmpctx);
@@ -429,7 +459,11 @@ int main(int argc, char *argv[])
 	assert(gossmap_local_addchan(mods, &l1, &l4, &scid_local, NULL));
 
 	/* Apply changes, check they work. */
+	gen = gossmap_generation(map);
 	gossmap_apply_localmods(map, mods);
+	check_edges(map);
+	assert(gossmap_generation(map) != gen);
+	gen = gossmap_generation(map);
 	assert(gossmap_find_node(map, &l4));
 	chan = gossmap_find_chan(map, &scid_local);
 
@@ -439,6 +473,8 @@ int main(int argc, char *argv[])
 
 	/* Remove, no longer can find. */
 	gossmap_remove_localmods(map, mods);
+	check_edges(map);
+	assert(gossmap_generation(map) != gen);
 
 	assert(!gossmap_find_chan(map, &scid_local));
 	assert(!gossmap_find_node(map, &l4));
@@ -458,6 +494,7 @@ int main(int argc, char *argv[])
 				 101, 102, 103, true, 0);
 
 	gossmap_apply_localmods(map, mods);
+	check_edges(map);
 	chan = gossmap_find_chan(map, &scid_local);
 	assert(gossmap_chan_set(chan, 0));
 	assert(!gossmap_chan_set(chan, 1));
@@ -479,6 +516,7 @@ int main(int argc, char *argv[])
 
 	/* Cleanup leaves everything previous intact */
 	gossmap_remove_localmods(map, mods);
+	check_edges(map);
 
 	assert(!gossmap_find_node(map, &l4));
 	assert(!gossmap_find_chan(map, &scid_local));
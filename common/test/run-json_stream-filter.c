@@ -283,5 +283,57 @@ int main(int argc, char *argv[])
 
 	str = json_out_contents(js->jout, &len);
 	assert(strncmp(str, "{\"result\":\"resultstr\"", len) == 0);
+
+	/* Numbers and hex are written directly into the stream. */
+	js = new_json_stream(tmpctx, NULL, NULL);
+	filter = json_filter_new(js);
+	subf = json_filter_subobj(filter, "result", strlen("result"));
+	json_filter_subobj(subf, "u64", strlen("u64"));
+	json_filter_subobj(subf, "s64", strlen("s64"));
+	json_filter_subobj(subf, "s32", strlen("s32"));
+	json_filter_subobj(subf, "hex", strlen("hex"));
+	json_object_start(js, NULL);
+	json_stream_attach_filter(js, filter);
+
+	json_object_start(js, "result");
+	json_add_u64(js, "u64", UINT64_MAX);
+	json_add_u32(js, "ignored", 7);
+	json_add_s64(js, "s64", INT64_MIN);
+	json_add_s32(js, "s32", 0);
+	json_add_hex(js, "hex", "\x01\xab", 2);
+	json_object_end(js);
+
+	str = json_out_contents(js->jout, &len);
+	assert(strncmp(str, "{\"result\":{\"u64\":18446744073709551615,\"s64\":-9223372036854775808,\"s32\":0,\"hex\":\"01ab\"}",
+		       len) == 0);
+
+	/* json_stream_wants lets callers skip unwanted fields. */
+	js = new_json_stream(tmpctx, NULL, NULL);
+	assert(json_stream_wants(js, "anything"));
+	filter = json_filter_new(js);
+	subf = json_filter_subobj(filter, "result", strlen("result"));
+	subf = json_filter_subobj(subf, "messages", strlen("messages"));
+	subf = json_filter_subarr(subf);
+	json_filter_subobj(subf, "string", strlen("string"));
+	json_object_start(js, NULL);
+	json_stream_attach_filter(js, filter);
+
+	assert(json_stream_wants(js, "result"));
+	assert(!json_stream_wants(js, "ignored"));
+	json_object_start(js, "result");
+	assert(json_stream_wants(js, "messages"));
+	assert(!json_stream_wants(js, "other"));
+	json_object_start(js, "other");
+	/* Everything under an unwanted field is unwanted. */
+	assert(!json_stream_wants(js, "messages"));
+	json_object_end(js);
+	json_array_start(js, "messages");
+	assert(json_stream_wants(js, NULL));
+	json_object_start(js, NULL);
+	assert(json_stream_wants(js, "string"));
+	assert(!json_stream_wants(js, "ignored"));
+	json_object_end(js);
+	json_array_end(js);
+	json_object_end(js);
 	common_shutdown();
 }
@@ -1,5 +1,6 @@
 #include "config.h"
 #include <assert.h>
+#include <ccan/cast/cast.h>
 #include <common/channel_type.h>
 #include <common/dijkstra.h>
 #include <common/gossmap.h>
@@ -158,6 +159,20 @@ static bool route_can_carry_unless_disabled(const struct gossmap *map,
 	return route_can_carry_even_disabled(map, c, dir, amount, arg);
 }
 
+static bool route_can_carry_unless_excluded(const struct gossmap *map,
+					    const struct gossmap_chan *c,
+					    int dir,
+					    struct amount_msat amount,
+					    const struct short_channel_id **excluded)
+{
+	if (*excluded) {
+		struct short_channel_id scid = gossmap_chan_scid(map, c);
+		if (short_channel_id_eq(&scid, *excluded))
+			return false;
+	}
+	return route_can_carry_unless_disabled(map, c, dir, amount, NULL);
+}
+
 static void node_id_from_privkey(const struct privkey *p, struct node_id *id)
 {
 	struct pubkey k;
@@ -174,6 +189,8 @@ int main(int argc, char *argv[])
 	struct privkey tmp;
 	const struct dijkstra *dij;
 	struct route_hop *route;
+	const struct short_channel_id *excluded;
+	struct short_channel_id bc_scid;
 	int store_fd;
 	struct gossmap *gossmap;
 	const double riskfactor = 1.0;
@@ -262,6 +279,17 @@ int main(int argc, char *argv[])
 	assert(amount_msat_eq(route[0].amount, AMOUNT_MSAT(1000)));
 	assert(route[0].delay == 13);
 
+	/* Stopping early at A gives the same answer. */
+	dij = dijkstra_to(tmpctx, gossmap, c_node, a_node, AMOUNT_MSAT(1000),
+			  riskfactor, route_can_carry_unless_disabled,
+			  route_score_cheaper, NULL);
+	route = route_from_dijkstra(tmpctx, gossmap, dij, a_node,
+				    AMOUNT_MSAT(1000), 12);
+	assert(route);
+	assert(tal_count(route) == 2);
+	assert(channel_is_between(gossmap, &route[0], a_node, d_node));
+	assert(channel_is_between(gossmap, &route[1], d_node, c_node));
+
 	/* Will go via B for large amounts. */
 	dij = dijkstra(tmpctx, gossmap, c_node, AMOUNT_MSAT(3000000), riskfactor,
 		       route_can_carry_unless_disabled,
@@ -277,6 +305,39 @@ int main(int argc, char *argv[])
 	assert(amount_msat_eq(route[0].amount, AMOUNT_MSAT(3000000 + 3 + 1)));
 	assert(route[0].delay == 14);
 
+	/* Same again, but repair it after excluding B<->C. */
+	excluded = NULL;
+	dij = dijkstra(tmpctx, gossmap, c_node, AMOUNT_MSAT(3000000), riskfactor,
+		       route_can_carry_unless_excluded,
+		       route_score_cheaper, &excluded);
+	route = route_from_dijkstra(tmpctx, gossmap, dij, a_node,
+				    AMOUNT_MSAT(3000000), 13);
+	assert(route);
+	assert(tal_count(route) == 2);
+	assert(channel_is_between(gossmap, &route[1], b_node, c_node));
+	bc_scid = route[1].scid;
+	excluded = &bc_scid;
+
+	/* Both A and B went via B<->C. */
+	assert(dijkstra_repair(cast_const(struct dijkstra *, dij), gossmap,
+			       riskfactor, route_can_carry_unless_excluded,
+			       route_score_cheaper, &excluded) == 2);
+	route = route_from_dijkstra(tmpctx, gossmap, dij, a_node,
+				    AMOUNT_MSAT(3000000), 13);
+	assert(route);
+	assert(tal_count(route) == 2);
+	assert(channel_is_between(gossmap, &route[0], a_node, d_node));
+	assert(channel_is_between(gossmap, &route[1], d_node, c_node));
+	assert(amount_msat_eq(route[0].amount, AMOUNT_MSAT(3000000 + 6)));
+	assert(route[0].delay == 14);
+	/* B is still reachable, via A. */
+	assert(dijkstra_distance(dij, gossmap_node_idx(gossmap, b_node)) == 3);
+
+	/* Nothing else to fix. */
+	assert(dijkstra_repair(cast_const(struct dijkstra *, dij), gossmap,
+			       riskfactor, route_can_carry_unless_excluded,
+			       route_score_cheaper, &excluded) == 0);
+
 	/* Make B->C inactive, force it back via D */
 	update_connection(store_fd, &b, &c, 1, 1, 1, true);
 	assert(gossmap_refresh(gossmap, NULL));
@@ -0,0 +1,28 @@
+#ifndef LIGHTNING_COMMON_TRACE_PROBE_H
+#define LIGHTNING_COMMON_TRACE_PROBE_H
+#include "config.h"
+
+/* USDT (User Statically-Defined Tracing) probes, for bpftrace, perf and
+ * friends: e.g. `bpftrace -l 'usdt:lightningd:cln:*'`.  Each is a single
+ * nop until something attaches to it, and they compile away entirely
+ * without <sys/sdt.h>.
+ *
+ * Paired probes are named foo_start and foo_end, so latency is simply the
+ * time between them. */
+#if HAVE_USDT
+#include <sys/sdt.h>
+
+#define TRACE_PROBE(name) DTRACE_PROBE(cln, name)
+#define TRACE_PROBE1(name, a) DTRACE_PROBE1(cln, name, a)
+#define TRACE_PROBE2(name, a, b) DTRACE_PROBE2(cln, name, a, b)
+#define TRACE_PROBE3(name, a, b, c) DTRACE_PROBE3(cln, name, a, b, c)
+#define TRACE_PROBE4(name, a, b, c, d) DTRACE_PROBE4(cln, name, a, b, c, d)
+#else
+#define TRACE_PROBE(name) do { } while (0)
+#define TRACE_PROBE1(name, a) do { } while (0)
+#define TRACE_PROBE2(name, a, b) do { } while (0)
+#define TRACE_PROBE3(name, a, b, c) do { } while (0)
+#define TRACE_PROBE4(name, a, b, c, d) do { } while (0)
+#endif /* !HAVE_USDT */
+
+#endif /* LIGHTNING_COMMON_TRACE_PROBE_H */
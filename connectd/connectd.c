@@ -248,6 +248,9 @@ static struct peer *new_peer(struct daemon *daemon,
 	peer->draining = false;
 	peer->peer_outq = msg_queue_new(peer, false);
 	peer->last_recv_time = time_now();
+	peer->onionmsg_incoming_tokens = ONION_MSG_TOKENS_MAX;
+	peer->onionmsg_last_incoming = time_mono();
+	peer->onionmsg_limited = false;
 
 #if DEVELOPER
 	peer->dev_writes_enabled = NULL;
@@ -1888,6 +1891,8 @@ static void dev_connect_memleak(struct daemon *daemon, const u8 *msg)
 	memleak_scan_htable(memtable, &daemon->peers->raw);
 
 	found_leak = dump_memleak(memtable, memleak_status_broken);
+	/* While we're here, show where our memory is going. */
+	dump_memstats(NULL, 10, memleak_status_debug);
 	daemon_conn_send(daemon->master,
 			 take(towire_connectd_dev_memleak_reply(NULL,
 							      found_leak)));
@@ -2052,6 +2057,8 @@ int main(int argc, char *argv[])
 	list_head_init(&daemon->connecting);
 	timers_init(&daemon->timers, time_mono());
 	daemon->gossip_store_fd = -1;
+	daemon->gossip_backfill_tokens = 0;
+	daemon->gossip_backfill_time = time_mono();
 	daemon->shutting_down = false;
 
 	/* stdin == control */
@@ -2076,6 +2083,11 @@ int main(int argc, char *argv[])
 	 * status_failed on error. */
 	ecdh_hsmd_setup(HSM_FD, status_failed);
 
+	/* One loop serves every peer.  We don't shard peers across threads:
+	 * tal, tmpctx and ccan/io assume a single thread, and every peer
+	 * shares the peers htable, the gossip_store and the daemon_conns to
+	 * lightningd and gossipd.  (lightningd's threads get away with it by
+	 * never touching any of that.) */
 	for (;;) {
 		struct timer *expired;
 		io_loop(&daemon->timers, &expired);
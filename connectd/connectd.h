@@ -11,6 +11,7 @@
 #include <common/pseudorand.h>
 #include <common/wireaddr.h>
 
+struct gossip_store_index;
 struct io_conn;
 struct connecting;
 struct wireaddr_internal;
@@ -27,6 +28,12 @@ struct gossip_state {
 	struct gossip_rcvd_filter *grf;
 	/* Offset within the gossip_store file */
 	size_t off;
+	/* Until off reaches this, they're catching up on old gossip */
+	size_t backfill_end;
+	/* gossip_store_generation() which off and backfill_end are in */
+	u64 store_generation;
+	/* Set if we're waiting for backfill budget */
+	struct oneshot *backfill_timer;
 };
 
 /*~ We need to know if we were expecting a pong, and why */
@@ -86,6 +93,11 @@ struct peer {
 	/* Last time we received traffic */
 	struct timeabs last_recv_time;
 
+	/* Ratelimits for onion messages.  One token per msec. */
+	size_t onionmsg_incoming_tokens;
+	struct timemono onionmsg_last_incoming;
+	bool onionmsg_limited;
+
 #if DEVELOPER
 	bool dev_read_enabled;
 	/* If non-NULL, this counts down; 0 means disable */
@@ -181,8 +193,11 @@ struct daemon {
 	/* The gossip_store */
 	int gossip_store_fd;
 	size_t gossip_store_end;
-	u32 gossip_recent_time;
-	size_t gossip_store_recent_off;
+	struct gossip_store_index *gossip_store_index;
+
+	/* Budget shared by all peers catching up on old gossip */
+	s64 gossip_backfill_tokens;
+	struct timemono gossip_backfill_time;
 
 	/* We only announce websocket addresses if !deprecated_apis */
 	bool announce_websocket;
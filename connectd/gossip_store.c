@@ -1,5 +1,6 @@
 #include "config.h"
 #include <ccan/crc32c/crc32c.h>
+#include <ccan/tal/tal.h>
 #include <common/status.h>
 #include <connectd/gossip_store.h>
 #include <errno.h>
@@ -23,6 +24,18 @@ static bool timestamp_filter(u32 timestamp_min, u32 timestamp_max,
 		&& timestamp <= timestamp_max;
 }
 
+/* Bumped each time we follow the end marker to a compacted store. */
+static u64 store_generation;
+/* Where the end of the previous store is, in the current one. */
+static size_t store_equivalent_off;
+
+u64 gossip_store_generation(size_t *equivalent_off)
+{
+	if (equivalent_off)
+		*equivalent_off = store_equivalent_off;
+	return store_generation;
+}
+
 static size_t reopen_gossip_store(int *gossip_store_fd, const u8 *msg)
 {
 	u64 equivalent_offset;
@@ -45,6 +58,8 @@ static size_t reopen_gossip_store(int *gossip_store_fd, const u8 *msg)
 
 	close(*gossip_store_fd);
 	*gossip_store_fd = newfd;
+	store_generation++;
+	store_equivalent_off = equivalent_offset;
 	return equivalent_offset;
 }
 
@@ -192,9 +207,11 @@ size_t find_gossip_store_by_timestamp(int gossip_store_fd,
 	u16 type, flags;
 	u32 ts;
 	size_t msglen;
+	struct gossip_store_hdrbuf hb;
 
-	while (gossip_store_readhdr(gossip_store_fd, off,
-				    &msglen, &ts, &flags, &type)) {
+	gossip_store_hdrbuf_init(&hb, gossip_store_fd);
+	while (gossip_store_readhdr_buffered(&hb, off,
+					     &msglen, &ts, &flags, &type)) {
 		/* Don't swallow end marker!  Reset, as they will call
 		 * gossip_store_next and reopen file. */
 		if (type == WIRE_GOSSIP_STORE_ENDED)
@@ -211,3 +228,110 @@ size_t find_gossip_store_by_timestamp(int gossip_store_fd,
 	}
 	return off;
 }
+
+/* We checkpoint every this many entries. */
+#define GOSSIP_INDEX_INTERVAL 1024
+
+struct gossip_index_entry {
+	size_t off;
+	/* Greatest timestamp of any entry before off. */
+	u32 max_timestamp;
+};
+
+/*~ The store isn't in timestamp order, but "greatest timestamp so far" is
+ * monotonic, and the first entry >= timestamp is exactly where that first
+ * reaches it.  So a sparse array of those is something we can bisect. */
+struct gossip_store_index {
+	/* The store generation we indexed: offsets change on compaction.
+	 * (Not the fd: the new one can reuse an old number!) */
+	u64 generation;
+	/* How far we've indexed, and greatest timestamp there. */
+	size_t end;
+	u32 max_timestamp;
+	/* Entries since the last checkpoint. */
+	size_t unindexed;
+	struct gossip_index_entry *entries;
+};
+
+static void gossip_store_index_reset(struct gossip_store_index *idx,
+				     u64 generation)
+{
+	idx->generation = generation;
+	idx->end = 1;
+	idx->max_timestamp = 0;
+	idx->unindexed = 0;
+	tal_resize(&idx->entries, 0);
+}
+
+struct gossip_store_index *new_gossip_store_index(const tal_t *ctx)
+{
+	struct gossip_store_index *idx = tal(ctx, struct gossip_store_index);
+
+	idx->entries = tal_arr(idx, struct gossip_index_entry, 0);
+	gossip_store_index_reset(idx, store_generation);
+	return idx;
+}
+
+size_t gossip_store_index_update(struct gossip_store_index *idx,
+				 int gossip_store_fd)
+{
+	u16 type, flags;
+	u32 ts;
+	size_t msglen;
+
+	struct gossip_store_hdrbuf hb;
+
+	if (idx->generation != store_generation)
+		gossip_store_index_reset(idx, store_generation);
+
+	gossip_store_hdrbuf_init(&hb, gossip_store_fd);
+	while (gossip_store_readhdr_buffered(&hb, idx->end,
+					     &msglen, &ts, &flags, &type)) {
+		/* Don't swallow end marker! */
+		if (type == WIRE_GOSSIP_STORE_ENDED)
+			break;
+
+		if (idx->unindexed++ == GOSSIP_INDEX_INTERVAL) {
+			struct gossip_index_entry e;
+			e.off = idx->end;
+			e.max_timestamp = idx->max_timestamp;
+			tal_arr_expand(&idx->entries, e);
+			idx->unindexed = 1;
+		}
+
+		/* Entries deleted later still count: that only makes us
+		 * start earlier than we need to. */
+		if (!(flags & GOSSIP_STORE_DELETED_BIT)
+		    && public_msg_type(type)
+		    && ts > idx->max_timestamp)
+			idx->max_timestamp = ts;
+
+		idx->end += sizeof(struct gossip_hdr) + msglen;
+	}
+	return idx->end;
+}
+
+size_t gossip_store_index_find(struct gossip_store_index *idx,
+			       int gossip_store_fd,
+			       u32 timestamp)
+{
+	size_t lo, hi;
+
+	gossip_store_index_update(idx, gossip_store_fd);
+
+	/* Find the first checkpoint which has seen timestamp */
+	lo = 0;
+	hi = tal_count(idx->entries);
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (idx->entries[mid].max_timestamp < timestamp)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	/* Nothing before the previous one can match */
+	return find_gossip_store_by_timestamp(gossip_store_fd,
+					      lo ? idx->entries[lo-1].off : 1,
+					      timestamp);
+}
@@ -24,4 +24,34 @@ size_t find_gossip_store_by_timestamp(int gossip_store_fd,
 				      size_t off,
 				      u32 timestamp);
 
+/**
+ * How many times we've followed the end marker to a new (compacted) store.
+ *
+ * Offsets into the store are only meaningful within one generation.  If
+ * @equivalent_off is non-NULL, it's set to where the end of the previous
+ * store is in this one.
+ */
+u64 gossip_store_generation(size_t *equivalent_off);
+
+/* A sparse index of timestamps in the gossip_store. */
+struct gossip_store_index;
+
+struct gossip_store_index *new_gossip_store_index(const tal_t *ctx);
+
+/**
+ * Index any new gossip_store entries.
+ *
+ * Returns the offset of the end of the file (or the end marker, if it has
+ * been compacted).  Starts again if the store has been compacted.
+ */
+size_t gossip_store_index_update(struct gossip_store_index *idx,
+				 int gossip_store_fd);
+
+/**
+ * Return offset of first entry >= this timestamp, using the index.
+ */
+size_t gossip_store_index_find(struct gossip_store_index *idx,
+			       int gossip_store_fd,
+			       u32 timestamp);
+
 #endif /* LIGHTNING_CONNECTD_GOSSIP_STORE_H */
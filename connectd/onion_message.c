@@ -36,11 +36,43 @@ void onionmsg_req(struct daemon *daemon, const u8 *msg)
 	}
 }
 
+/* Returns true if we should drop this message: each peer gets a bucket of
+ * ONION_MSG_TOKENS_MAX tokens, refilled at one per msec, and each message
+ * costs ONION_MSG_MSEC of them.  We check this before we unwrap the onion,
+ * since that costs two round trips to hsmd for ECDH. */
+static bool onionmsg_ratelimited(struct peer *peer)
+{
+	struct timemono now = time_mono();
+	u64 msec = time_to_msec(timemono_between(now,
+						 peer->onionmsg_last_incoming));
+
+	peer->onionmsg_last_incoming = now;
+	if (peer->onionmsg_incoming_tokens + msec > ONION_MSG_TOKENS_MAX)
+		peer->onionmsg_incoming_tokens = ONION_MSG_TOKENS_MAX;
+	else
+		peer->onionmsg_incoming_tokens += msec;
+
+	if (peer->onionmsg_incoming_tokens < ONION_MSG_MSEC) {
+		/* Only complain once per burst, not for every message */
+		if (!peer->onionmsg_limited) {
+			status_peer_unusual(&peer->id,
+					    "Ratelimiting onion messages");
+			peer->onionmsg_limited = true;
+		}
+		return true;
+	}
+
+	peer->onionmsg_incoming_tokens -= ONION_MSG_MSEC;
+	peer->onionmsg_limited = false;
+	return false;
+}
+
 /* Peer sends an onion msg. */
 void handle_onion_message(struct daemon *daemon,
 			  struct peer *peer, const u8 *msg)
 {
 	struct pubkey blinding;
+	struct secret blinding_ss;
 	u8 *onion;
 	u8 *next_onion_msg;
 	struct pubkey next_node;
@@ -53,7 +85,9 @@ void handle_onion_message(struct daemon *daemon,
 			     OPT_ONION_MESSAGES))
 		return;
 
-	/* FIXME: ratelimit! */
+	if (onionmsg_ratelimited(peer))
+		return;
+
 	if (!fromwire_onion_message(msg, msg, &blinding, &onion)) {
 		inject_peer_msg(peer,
 				towire_warningfmt(NULL, NULL,
@@ -61,6 +95,11 @@ void handle_onion_message(struct daemon *daemon,
 		return;
 	}
 
+	/* Everyone sending to the same blinded path uses the same
+	 * blinding point: have the ecdh() in onion_message_parse() answer
+	 * it from our cache next time. */
+	ecdh_blinding(&blinding, &blinding_ss);
+
 	if (!onion_message_parse(tmpctx, onion, &blinding, &peer->id,
 				 &daemon->mykey,
 				 &next_onion_msg, &next_node,
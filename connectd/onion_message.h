@@ -3,6 +3,11 @@
 #include "config.h"
 #include <ccan/short_types/short_types.h>
 
+/* Each peer can send us one onion message per ONION_MSG_MSEC on average,
+ * with bursts of up to ONION_MSG_TOKENS_MAX / ONION_MSG_MSEC. */
+#define ONION_MSG_MSEC 250
+#define ONION_MSG_TOKENS_MAX (60 * 1000)
+
 /* Onion message comes in from peer */
 void handle_onion_message(struct daemon *daemon,
 			  struct peer *peer, const u8 *msg);
@@ -171,5 +171,20 @@ int main(int argc, char *argv[])
 		     "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"
 		     "\r\n"));
 
+	/* RFC-6455 example masked "Hello", but as a binary frame: twice, so
+	 * we read both at once and the second comes from our buffer. */
+	my_rbuf = tal_strdup(tmpctx,
+			     "\x82\x85\x37\xfa\x21\x3d\x7f\x9f\x4d\x51\x58"
+			     "\x82\x85\x37\xfa\x21\x3d\x7f\x9f\x4d\x51\x58");
+	my_rbuf_off = 0;
+	my_wbuf = tal_arr(tmpctx, char, 0);
+
+	websocket_to_lightningd(STDIN_FILENO, STDOUT_FILENO);
+	assert(ws_buffered());
+	websocket_to_lightningd(STDIN_FILENO, STDOUT_FILENO);
+	assert(!ws_buffered());
+	assert(streq(tal_strndup(tmpctx, my_wbuf, tal_bytelen(my_wbuf)),
+		     "HelloHello"));
+
 	common_shutdown();
 }
@@ -235,6 +235,52 @@ static void lightningd_to_websocket(int lightningfd, int wsfd)
 		exit(0);
 }
 
+/* We read from the websocket in large chunks: frames are usually small,
+ * and this saves separate read() calls for the header, extended header
+ * and payload of every one. */
+static struct {
+	u8 buf[65536];
+	size_t off, len;
+} wsin;
+
+/* Is there more read from the websocket we haven't processed? */
+static bool ws_buffered(void)
+{
+	return wsin.off != wsin.len;
+}
+
+/* Returns up to max bytes from the websocket (at least one) */
+static u8 *ws_read(int fd, size_t max, size_t *len)
+{
+	u8 *p;
+
+	if (!ws_buffered()) {
+		ssize_t r = read(fd, wsin.buf, sizeof(wsin.buf));
+		if (r <= 0)
+			exit(0);
+		wsin.off = 0;
+		wsin.len = r;
+	}
+
+	*len = wsin.len - wsin.off;
+	if (*len > max)
+		*len = max;
+	p = wsin.buf + wsin.off;
+	wsin.off += *len;
+	return p;
+}
+
+static void ws_read_all(int fd, u8 *dst, size_t len)
+{
+	while (len) {
+		size_t n;
+		const u8 *p = ws_read(fd, len, &n);
+		memcpy(dst, p, n);
+		dst += n;
+		len -= n;
+	}
+}
+
 /* Returns payload size, sets inmask, is_binframe */
 static size_t read_payload_header(int fd, u8 inmask[4], bool *is_binframe)
 {
@@ -244,8 +290,7 @@ static size_t read_payload_header(int fd, u8 inmask[4], bool *is_binframe)
 	size_t hdrsize = 2, len;
 
 	/* First two bytes define hdr size. */
-	if (!read_all(fd, frame_hdr, 2))
-		exit(0);
+	ws_read_all(fd, frame_hdr, 2);
 
 	/* RFC-6455:
 	 *  %x2 denotes a binary frame
@@ -263,8 +308,8 @@ static size_t read_payload_header(int fd, u8 inmask[4], bool *is_binframe)
 		hdrsize += 4;
 
 	/* Read rest of hdr if necessary */
-	if (hdrsize > 2 && !read_all(fd, frame_hdr + 2, hdrsize - 2))
-		exit(0);
+	if (hdrsize > 2)
+		ws_read_all(fd, frame_hdr + 2, hdrsize - 2);
 
 	if (len == 126) {
 		be16 be16len;
@@ -285,10 +330,11 @@ static size_t read_payload_header(int fd, u8 inmask[4], bool *is_binframe)
 	return len;
 }
 
-static void apply_mask(u8 *buf, size_t len, const u8 inmask[4])
+/* off is how far into the payload buf is */
+static void apply_mask(u8 *buf, size_t len, const u8 inmask[4], size_t off)
 {
 	for (size_t i = 0; i < len; i++)
-		buf[i] ^= inmask[i % 4];
+		buf[i] ^= inmask[(off + i) % 4];
 }
 
 static void websocket_to_lightningd(int wsfd, int lightningfd)
@@ -297,19 +343,15 @@ static void websocket_to_lightningd(int wsfd, int lightningfd)
 	u8 inmask[4];
 	bool is_binframe;
 
-	len = read_payload_header(wsfd, inmask, &is_binframe);
-	while (len > 0) {
-		u8 buf[65536];
-		int rlen = len;
+	size_t off = 0;
 
-		if (rlen > sizeof(buf))
-			rlen = sizeof(buf);
+	len = read_payload_header(wsfd, inmask, &is_binframe);
+	while (off < len) {
+		size_t rlen;
+		u8 *buf = ws_read(wsfd, len - off, &rlen);
 
-		rlen = read(wsfd, buf, rlen);
-		if (rlen <= 0)
-			exit(0);
-		apply_mask(buf, rlen, inmask);
-		len -= rlen;
+		apply_mask(buf, rlen, inmask, off);
+		off += rlen;
 		/* We ignore non binary frames (FIXME: Send error!) */
 		if (is_binframe && !write_all(lightningfd, buf, rlen))
 			exit(0);
@@ -340,8 +382,13 @@ int main(int argc, char *argv[])
 
 		if (pfds[1].revents & POLLIN)
 			lightningd_to_websocket(STDOUT_FILENO, STDIN_FILENO);
-		if (pfds[0].revents & POLLIN)
-			websocket_to_lightningd(STDIN_FILENO, STDOUT_FILENO);
+		/* poll() won't tell us about frames we've already read */
+		if (pfds[0].revents & POLLIN) {
+			do {
+				websocket_to_lightningd(STDIN_FILENO,
+							STDOUT_FILENO);
+			} while (ws_buffered());
+		}
 	}
 
 	common_shutdown();
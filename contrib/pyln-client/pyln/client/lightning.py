@@ -963,15 +963,27 @@ class LightningRpc(UnixDomainSocketRpc):
         }
         return self.call("invoice", payload)
 
-    def listchannels(self, short_channel_id=None, source=None, destination=None):
+    def listchannels(self, short_channel_id=None, source=None, destination=None,
+                     feature=None, min_capacity_msat=None, max_capacity_msat=None,
+                     active=None, max_base_fee_msat=None, max_fee_ppm=None,
+                     updated_since=None):
         """
         Show all known channels or filter by optional
-        {short_channel_id}, {source} or {destination}.
+        {short_channel_id}, {source} or {destination}, further
+        filtered by {feature}, {min_capacity_msat}, {max_capacity_msat},
+        {active}, {max_base_fee_msat}, {max_fee_ppm} and {updated_since}.
         """
         payload = {
             "short_channel_id": short_channel_id,
             "source": source,
-            "destination": destination
+            "destination": destination,
+            "feature": feature,
+            "min_capacity_msat": min_capacity_msat,
+            "max_capacity_msat": max_capacity_msat,
+            "active": active,
+            "max_base_fee_msat": max_base_fee_msat,
+            "max_fee_ppm": max_fee_ppm,
+            "updated_since": updated_since,
         }
         return self.call("listchannels", payload)
 
@@ -993,14 +1005,17 @@ class LightningRpc(UnixDomainSocketRpc):
         }
         return self.call("listdatastore", payload)
 
-    def listforwards(self, status=None, in_channel=None, out_channel=None):
+    def listforwards(self, status=None, in_channel=None, out_channel=None, start=None, limit=None):
         """List all forwarded payments and their information matching
-        forward {status}, {in_channel} and {out_channel}.
+        forward {status}, {in_channel} and {out_channel}, at most {limit}
+        starting at created_index {start}.
         """
         payload = {
             "status": status,
             "in_channel": in_channel,
             "out_channel": out_channel,
+            "start": start,
+            "limit": limit,
         }
         return self.call("listforwards", payload)
 
@@ -1021,11 +1036,12 @@ class LightningRpc(UnixDomainSocketRpc):
         """
         return self.call("listtransactions")
 
-    def listinvoices(self, label=None, payment_hash=None, invstring=None, offer_id=None):
+    def listinvoices(self, label=None, payment_hash=None, invstring=None, offer_id=None, start=None, limit=None):
         """Query invoices
 
         Show invoice matching {label}, {payment_hash}, {invstring} or {offer_id}
-        (or all, if no filters are present).
+        (or all, if no filters are present), at most {limit} starting at
+        created_index {start}.
 
         """
         payload = {
@@ -1033,16 +1049,20 @@ class LightningRpc(UnixDomainSocketRpc):
             "payment_hash": payment_hash,
             "invstring": invstring,
             "offer_id": offer_id,
+            "start": start,
+            "limit": limit,
         }
         return self.call("listinvoices", payload)
 
-    def listnodes(self, node_id=None):
+    def listnodes(self, node_id=None, feature=None, updated_since=None):
         """
         Show all nodes in our local network view, filter on node {id}
-        if provided.
+        if provided, and on {feature} and {updated_since}.
         """
         payload = {
-            "id": node_id
+            "id": node_id,
+            "feature": feature,
+            "updated_since": updated_since,
         }
         return self.call("listnodes", payload)
 
@@ -1070,22 +1090,27 @@ class LightningRpc(UnixDomainSocketRpc):
         }
         return self.call("listpeers", payload)
 
-    def listpeerchannels(self, peer_id=None):
+    def listpeerchannels(self, peer_id=None, since=None):
         """
         Show current peers channels, and if the {peer_id} is specified
-        all the channels for the peer are returned.
+        all the channels for the peer are returned.  With {since}, only
+        channels whose change_index is greater are returned.
         """
         payload = {
             "id": peer_id,
+            "since": since,
         }
         return self.call("listpeerchannels", payload)
 
-    def listsendpays(self, bolt11=None, payment_hash=None, status=None):
-        """Show all sendpays results, or only for `bolt11` or `payment_hash`."""
+    def listsendpays(self, bolt11=None, payment_hash=None, status=None, start=None, limit=None):
+        """Show all sendpays results, or only for `bolt11` or `payment_hash`,
+        at most `limit` starting at id `start`."""
         payload = {
             "bolt11": bolt11,
             "payment_hash": payment_hash,
-            "status": status
+            "status": status,
+            "start": start,
+            "limit": limit,
         }
         return self.call("listsendpays", payload)
 
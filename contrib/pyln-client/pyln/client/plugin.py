@@ -59,6 +59,8 @@ class Method(object):
         self.deprecated = deprecated
         self.before: List[str] = []
         self.after: List[str] = []
+        self.parallel = False
+        self.batch = False
 
 
 class RpcException(Exception):
@@ -256,6 +258,7 @@ class Plugin(object):
 
         # A dict from topics to handler functions
         self.subscriptions: Dict[str, Callable[..., None]] = {}
+        self.subscription_filters: Dict[str, JSONType] = {}
 
         if not stdout:
             self.stdout = sys.stdout
@@ -341,7 +344,8 @@ class Plugin(object):
         method.background = background
         self.methods[name] = method
 
-    def add_subscription(self, topic: str, func: Callable[..., None]) -> None:
+    def add_subscription(self, topic: str, func: Callable[..., None],
+                         filter: Optional[JSONType] = None) -> None:
         """Add a subscription to our list of subscriptions.
 
         A subscription is an association between a topic and a handler
@@ -353,6 +357,9 @@ class Plugin(object):
         registered before we send our manifest, hence before
         `Plugin.run` is called.
 
+        If `filter` is set, `lightningd` only sends the fields of the
+        notification params it names (like the `filter` for commands).
+
         """
         if topic in self.subscriptions:
             raise ValueError(
@@ -372,15 +379,18 @@ class Plugin(object):
                 "handlers.".format(func.__name__, topic), level="warn")
 
         self.subscriptions[topic] = func
+        if filter is not None:
+            self.subscription_filters[topic] = filter
 
-    def subscribe(self, topic: str) -> NoneDecoratorType:
+    def subscribe(self, topic: str,
+                  filter: Optional[JSONType] = None) -> NoneDecoratorType:
         """Function decorator to register a notification handler.
 
         """
         # Yes, decorator type annotations are just weird, don't think too much
         # about it...
         def decorator(f: Callable[..., None]) -> Callable[..., None]:
-            self.add_subscription(topic, f)
+            self.add_subscription(topic, f, filter=filter)
             return f
         return decorator
 
@@ -476,8 +486,17 @@ class Plugin(object):
     def add_hook(self, name: str, func: Callable[..., JSONType],
                  background: bool = False,
                  before: Optional[List[str]] = None,
-                 after: Optional[List[str]] = None) -> None:
+                 after: Optional[List[str]] = None,
+                 parallel: bool = False,
+                 batch: bool = False) -> None:
         """Register a hook that is called synchronously by lightningd on events
+
+        If `parallel` is set, lightningd may call it at the same time as
+        other plugins' parallel hooks, rather than waiting for them.
+
+        If `batch` is set, the hook is called with a `batch` array of
+        the usual parameters, and must return `{"batch": [...]}` with
+        one result for each.
         """
         if name in self.methods:
             raise ValueError(
@@ -504,17 +523,22 @@ class Plugin(object):
         method.after = []
         if after:
             method.after = after
+        method.parallel = parallel
+        method.batch = batch
         self.methods[name] = method
 
     def hook(self, method_name: str,
              before: List[str] = None,
-             after: List[str] = None) -> JsonDecoratorType:
+             after: List[str] = None,
+             parallel: bool = False,
+             batch: bool = False) -> JsonDecoratorType:
         """Decorator to add a plugin hook to the dispatch table.
 
         Internally uses add_hook.
         """
         def decorator(f: Callable[..., JSONType]) -> Callable[..., JSONType]:
-            self.add_hook(method_name, f, background=False, before=before, after=after)
+            self.add_hook(method_name, f, background=False, before=before, after=after,
+                          parallel=parallel, batch=batch)
             return f
         return decorator
 
@@ -863,9 +887,14 @@ class Plugin(object):
                 continue
 
             if method.mtype == MethodType.HOOK:
-                hooks.append({'name': method.name,
-                              'before': method.before,
-                              'after': method.after})
+                hook = {'name': method.name,
+                        'before': method.before,
+                        'after': method.after}
+                if method.parallel:
+                    hook['parallel'] = True
+                if method.batch:
+                    hook['batch'] = True
+                hooks.append(hook)
                 continue
 
             doc = inspect.getdoc(method.func)
@@ -911,10 +940,18 @@ class Plugin(object):
                 m = methods[len(methods) - 1]
                 m["long_description"] = method.long_desc
 
+        subscriptions: List[JSONType] = []
+        for topic in self.subscriptions:
+            if topic in self.subscription_filters:
+                subscriptions.append({'name': topic,
+                                      'filter': self.subscription_filters[topic]})
+            else:
+                subscriptions.append(topic)
+
         manifest = {
             'options': list(self.options.values()),
             'rpcmethods': methods,
-            'subscriptions': list(self.subscriptions.keys()),
+            'subscriptions': subscriptions,
             'hooks': hooks,
             'dynamic': self.dynamic,
             'nonnumericids': True,
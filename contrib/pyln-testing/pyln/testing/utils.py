@@ -412,6 +412,7 @@ class BitcoinD(TailableProc):
             '-logtimestamps',
             '-nolisten',
             '-txindex',
+            '-blockfilterindex',
             '-nowallet',
             '-addresstype=bech32',
             '-debug=mempool',
@@ -4,6 +4,7 @@
 #include <ccan/list/list.h>
 #include <ccan/short_types/short_types.h>
 #include <ccan/strset/strset.h>
+#include <ccan/time/time.h>
 #include <common/autodata.h>
 #include <common/utils.h>
 
@@ -55,7 +56,23 @@ struct db {
 	 * committed. */
 	u32 data_version;
 
+	/* How long we've spent inside the driver (for statistics). */
+	struct timerel time_spent;
+
+	/* Group commit: db_commit_transaction() leaves the underlying
+	 * transaction open, and db_commit_flush() actually commits it. */
+	bool group_commit;
+	/* Is there a logically-committed transaction awaiting flush? */
+	bool commit_pending;
+
+	/* Use write-ahead logging, if the driver can (set before setup_fn) */
+	bool wal;
+
 	void (*report_changes_fn)(struct db *);
+
+	/* Called before each commit, e.g. to flush cached writes. */
+	void (*precommit_fn)(void *arg);
+	void *precommit_arg;
 };
 
 struct db_query {
@@ -118,6 +135,9 @@ struct db_stmt {
 
 	bool executed;
 
+	/* May this query be answered by a (slightly stale) read replica? */
+	bool replica_ok;
+
 	int row;
 
 #if DEVELOPER
@@ -171,6 +191,8 @@ struct db_config {
 	size_t (*count_changes_fn)(struct db_stmt *stmt);
 
 	bool (*setup_fn)(struct db *db);
+	/* Optional: use a read replica for db_query_prepared_stale(). */
+	bool (*replica_fn)(struct db *db, const char *dsn, u32 max_lag_secs);
 	void (*teardown_fn)(struct db *db);
 
 	bool (*vacuum_fn)(struct db *db);
@@ -186,6 +208,12 @@ struct db_config {
 void db_fatal(const char *fmt, ...)
 	PRINTF_FMT(1, 2);
 
+/* Account for time spent in the driver since @start. */
+static inline void db_add_time_spent(struct db *db, struct timemono start)
+{
+	db->time_spent = timerel_add(db->time_spent, timemono_since(start));
+}
+
 /* Provide a way for DB backends to register themselves */
 AUTODATA_TYPE(db_backends, struct db_config);
 
@@ -1,8 +1,11 @@
 #include "config.h"
 #include <ccan/ccan/tal/str/str.h>
 #include <ccan/endian/endian.h>
+#include <ccan/strset/strset.h>
+#include <ccan/time/time.h>
 #include <db/common.h>
 #include <db/utils.h>
+#include <stdlib.h>
 
 #if HAVE_POSTGRES
 /* Indented in order not to trigger the inclusion order check */
@@ -14,9 +17,168 @@
 #define INT4OID			23
 #define TEXTOID			25
 
+/* How often we ask the replica how far behind it is. */
+#define REPLICA_LAG_CHECK_SECS 1
+
+/* Inside a transaction we use pipeline mode (if libpq supports it):
+ * statements are queued without waiting for their results, and we only
+ * wait when we need a result (a query, count of changes, insert id) or
+ * on commit.  So a write-only transaction costs one round-trip. */
+struct pipelined {
+	/* Where to put the result (NULL to discard it). */
+	void **dest;
+	/* Is an error fatal?  True for everything but queries, which
+	 * report their errors to the caller. */
+	bool must_succeed;
+};
+
+struct db_postgres {
+	/* The actual db connection. */
+	PGconn *conn;
+	/* Names of statements we've PQprepare()d on this connection. */
+	struct strset prepared;
+	/* Results still to come back from the pipeline, in order. */
+	struct pipelined *pending;
+
+	/* A read replica for db_query_prepared_stale(), or NULL. */
+	PGconn *replica;
+	/* How far behind (in seconds) it may be before we ignore it. */
+	u32 replica_max_lag;
+	/* Was it within that, as of replica_checked? */
+	bool replica_fresh;
+	struct timemono replica_checked;
+	/* After we commit a write, the replica may not have it until up to
+	 * replica_max_lag later: until then, everything reads the primary. */
+	struct timemono replica_avoid_until;
+};
+
+/* stmt->inner_stmt while its result is still in the pipeline. */
+static char result_pending;
+
+static inline PGconn *conn2pg(void *conn)
+{
+	struct db_postgres *wrapper = (struct db_postgres *)conn;
+	return wrapper->conn;
+}
+
+static bool pipelining(const struct db_postgres *wrapper)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+	return PQpipelineStatus(wrapper->conn) != PQ_PIPELINE_OFF;
+#else
+	return false;
+#endif
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+static void pipeline_expect(struct db_postgres *wrapper, int sent,
+			    void **dest, bool must_succeed)
+{
+	struct pipelined p;
+
+	if (!sent)
+		db_fatal("Failed to queue postgres command: %s",
+			 PQerrorMessage(wrapper->conn));
+
+	p.dest = dest;
+	p.must_succeed = must_succeed;
+	tal_arr_expand(&wrapper->pending, p);
+}
+
+/* Send everything queued, and collect all the results. */
+static void pipeline_sync(struct db_postgres *wrapper)
+{
+	PGresult *res, *extra;
+
+	if (!PQpipelineSync(wrapper->conn))
+		db_fatal("Failed to flush postgres pipeline: %s",
+			 PQerrorMessage(wrapper->conn));
+
+	for (size_t i = 0; i < tal_count(wrapper->pending); i++) {
+		const struct pipelined *p = &wrapper->pending[i];
+		ExecStatusType status;
+
+		res = PQgetResult(wrapper->conn);
+		if (!res)
+			db_fatal("Missing postgres pipeline result: %s",
+				 PQerrorMessage(wrapper->conn));
+		/* Each command's results are terminated by a NULL. */
+		while ((extra = PQgetResult(wrapper->conn)) != NULL)
+			PQclear(extra);
+
+		status = PQresultStatus(res);
+		if (p->must_succeed
+		    && status != PGRES_COMMAND_OK
+		    && status != PGRES_TUPLES_OK)
+			db_fatal("Error executing statement: %s",
+				 PQresultErrorMessage(res));
+
+		if (p->dest)
+			*p->dest = res;
+		else
+			PQclear(res);
+	}
+	tal_resize(&wrapper->pending, 0);
+
+	res = PQgetResult(wrapper->conn);
+	if (PQresultStatus(res) != PGRES_PIPELINE_SYNC)
+		db_fatal("Unexpected postgres pipeline sync result: %s",
+			 PQresStatus(PQresultStatus(res)));
+	PQclear(res);
+}
+
+/* Make sure this stmt's result is in. */
+static void pipeline_wait(struct db_stmt *stmt)
+{
+	if (stmt->inner_stmt == &result_pending) {
+		stmt->inner_stmt = NULL;
+		pipeline_sync(stmt->db->conn);
+	}
+}
+
+static void pipeline_forget(struct db_stmt *stmt)
+{
+	struct db_postgres *wrapper = stmt->db->conn;
+
+	for (size_t i = 0; i < tal_count(wrapper->pending); i++) {
+		if (wrapper->pending[i].dest == &stmt->inner_stmt)
+			wrapper->pending[i].dest = NULL;
+	}
+}
+#else
+static void pipeline_wait(struct db_stmt *stmt)
+{
+}
+
+static void pipeline_forget(struct db_stmt *stmt)
+{
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
+/* Run a simple command now, even if pipelining: caller frees result. */
+static PGresult *db_postgres_exec_now(struct db *db, const char *cmd)
+{
+	struct db_postgres *wrapper = db->conn;
+	PGresult *res = NULL;
+
+	if (!pipelining(wrapper))
+		return PQexec(wrapper->conn, cmd);
+
+#ifdef LIBPQ_HAS_PIPELINING
+	pipeline_expect(wrapper,
+			PQsendQueryParams(wrapper->conn, cmd,
+					  0, NULL, NULL, NULL, NULL, 0),
+			(void **)&res, false);
+	pipeline_sync(wrapper);
+#endif
+	return res;
+}
+
 static bool db_postgres_setup(struct db *db)
 {
 	size_t prefix_len = strlen("postgres://");
+	struct db_postgres *wrapper;
+	PGconn *conn;
 
 	/* We attempt to parse the connection string without the `postgres://`
 	prefix first, so we can correctly handle the key-value-pair style of
@@ -30,27 +192,64 @@ static bool db_postgres_setup(struct db *db)
 
 	if (info != NULL) {
 		PQconninfoFree(info);
-		db->conn = PQconnectdb(db->filename + prefix_len);
+		conn = PQconnectdb(db->filename + prefix_len);
 	} else {
-		db->conn = PQconnectdb(db->filename);
+		conn = PQconnectdb(db->filename);
 	}
 
-	if (PQstatus(db->conn) != CONNECTION_OK) {
-		db->error = tal_fmt(db, "Could not connect to %s: %s", db->filename, PQerrorMessage(db->conn));
+	if (PQstatus(conn) != CONNECTION_OK) {
+		db->error = tal_fmt(db, "Could not connect to %s: %s", db->filename, PQerrorMessage(conn));
 		db->conn = NULL;
 		return false;
 	}
+
+	wrapper = tal(db, struct db_postgres);
+	wrapper->conn = conn;
+	strset_init(&wrapper->prepared);
+	wrapper->pending = tal_arr(wrapper, struct pipelined, 0);
+	wrapper->replica = NULL;
+	db->conn = wrapper;
 	return true;
 }
 
+/* Same two styles of DSN as the primary */
+static PGconn *db_postgres_connect(const char *dsn)
+{
+	size_t prefix_len = strlen("postgres://");
+	PQconninfoOption *info;
+
+	if (!strstarts(dsn, "postgres://"))
+		return NULL;
+
+	info = PQconninfoParse(dsn + prefix_len, NULL);
+	if (info != NULL) {
+		PQconninfoFree(info);
+		return PQconnectdb(dsn + prefix_len);
+	}
+	return PQconnectdb(dsn);
+}
+
 static bool db_postgres_begin_tx(struct db *db)
 {
 	assert(db->conn);
 	PGresult *res;
-	res = PQexec(db->conn, "BEGIN;");
+
+#ifdef LIBPQ_HAS_PIPELINING
+	struct db_postgres *wrapper = db->conn;
+
+	/* We don't wait for this: errors show up on the next sync. */
+	if (PQenterPipelineMode(wrapper->conn)) {
+		pipeline_expect(wrapper,
+				PQsendQueryParams(wrapper->conn, "BEGIN;",
+						  0, NULL, NULL, NULL, NULL, 0),
+				NULL, true);
+		return true;
+	}
+#endif
+	res = PQexec(conn2pg(db->conn), "BEGIN;");
 	if (PQresultStatus(res) != PGRES_COMMAND_OK) {
 		db->error = tal_fmt(db, "BEGIN command failed: %s",
-				    PQerrorMessage(db->conn));
+				    PQerrorMessage(conn2pg(db->conn)));
 		PQclear(res);
 		return false;
 	}
@@ -62,19 +261,57 @@ static bool db_postgres_commit_tx(struct db *db)
 {
 	assert(db->conn);
 	PGresult *res;
-	res = PQexec(db->conn, "COMMIT;");
-	if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+	bool ok;
+	res = db_postgres_exec_now(db, "COMMIT;");
+	ok = (PQresultStatus(res) == PGRES_COMMAND_OK);
+	if (!ok)
 		db->error = tal_fmt(db, "COMMIT command failed: %s",
-				    PQerrorMessage(db->conn));
-		PQclear(res);
-		return false;
-	}
+				    PQresultErrorMessage(res));
 	PQclear(res);
-	return true;
+
+	/* So a later command (e.g. listinvoices after invoice) sees it. */
+	if (ok && (db->dirty || db->commit_pending)) {
+		struct db_postgres *wrapper = db->conn;
+		if (wrapper->replica)
+			wrapper->replica_avoid_until
+				= timemono_add(time_mono(),
+					       time_from_sec(wrapper->replica_max_lag));
+	}
+
+#ifdef LIBPQ_HAS_PIPELINING
+	if (pipelining(db->conn) && !PQexitPipelineMode(conn2pg(db->conn)))
+		db_fatal("Could not leave postgres pipeline mode: %s",
+			 PQerrorMessage(conn2pg(db->conn)));
+#endif
+	return ok;
+}
+
+static char binding_type_char(enum db_binding_type type)
+{
+	switch (type) {
+	case DB_BINDING_UNINITIALIZED:
+		break;
+	case DB_BINDING_UINT64:
+		return 'U';
+	case DB_BINDING_INT:
+		return 'I';
+	case DB_BINDING_BLOB:
+		return 'B';
+	case DB_BINDING_TEXT:
+		return 'T';
+	case DB_BINDING_NULL:
+		return 'N';
+	}
+	abort();
 }
 
-static PGresult *db_postgres_do_exec(struct db_stmt *stmt)
+/* Returns NULL (and sets stmt->inner_stmt to &result_pending) if the
+ * statement was queued on the pipeline: if @must_succeed, an error there
+ * is fatal. */
+static PGresult *db_postgres_do_exec(struct db_stmt *stmt, bool must_succeed,
+				     PGconn *replica)
 {
+	struct db_postgres *wrapper = stmt->db->conn;
 	int slots = stmt->query->placeholders;
 	const char *paramValues[slots];
 	int paramLengths[slots];
@@ -86,6 +323,7 @@ static PGresult *db_postgres_do_exec(struct db_stmt *stmt)
 	 * byte-order we need a place to temporarily stash them. */
 	s32 ints[slots];
 	u64 u64s[slots];
+	size_t idx;
 
 	for (size_t i=0; i<slots; i++) {
 		struct db_binding *b = &stmt->bindings[i];
@@ -129,19 +367,191 @@ static PGresult *db_postgres_do_exec(struct db_stmt *stmt)
 			break;
 		}
 	}
-	return PQexecParams(stmt->db->conn, stmt->query->query, slots,
+
+	/* We don't bother preparing on the replica: it's for big scans. */
+	if (replica)
+		return PQexecParams(replica, stmt->query->query, slots,
+				    paramTypes, paramValues, paramLengths,
+				    paramFormats, resultFormat);
+
+	/* Compiled-in queries are a finite set, so we prepare each once
+	 * per connection and reuse it.  We send parameter types, so they
+	 * are part of the statement identity too (NULL bindings are
+	 * untyped). */
+	if (db_stmt_query_index(stmt, &idx)) {
+		char *name = tal_fmt(tmpctx, "cln%zu_", idx);
+
+		for (size_t i = 0; i < slots; i++)
+			tal_append_fmt(&name, "%c",
+				       binding_type_char(stmt->bindings[i].type));
+
+#ifdef LIBPQ_HAS_PIPELINING
+		if (pipelining(wrapper)) {
+			if (!strset_get(&wrapper->prepared, name)) {
+				pipeline_expect(wrapper,
+						PQsendPrepare(wrapper->conn, name,
+							      stmt->query->query,
+							      slots, paramTypes),
+						NULL, true);
+				strset_add(&wrapper->prepared, name);
+			}
+			stmt->inner_stmt = &result_pending;
+			pipeline_expect(wrapper,
+					PQsendQueryPrepared(wrapper->conn, name,
+							    slots, paramValues,
+							    paramLengths,
+							    paramFormats,
+							    resultFormat),
+					&stmt->inner_stmt, must_succeed);
+			return NULL;
+		}
+#endif
+		if (!strset_get(&wrapper->prepared, name)) {
+			PGresult *res;
+
+			res = PQprepare(wrapper->conn, name, stmt->query->query,
+					slots, paramTypes);
+			if (PQresultStatus(res) != PGRES_COMMAND_OK)
+				return res;
+			PQclear(res);
+			strset_add(&wrapper->prepared, name);
+		}
+		return PQexecPrepared(wrapper->conn, name, slots,
+				      paramValues, paramLengths, paramFormats,
+				      resultFormat);
+	}
+
+#ifdef LIBPQ_HAS_PIPELINING
+	if (pipelining(wrapper)) {
+		stmt->inner_stmt = &result_pending;
+		pipeline_expect(wrapper,
+				PQsendQueryParams(wrapper->conn,
+						  stmt->query->query, slots,
+						  paramTypes, paramValues,
+						  paramLengths, paramFormats,
+						  resultFormat),
+				&stmt->inner_stmt, must_succeed);
+		return NULL;
+	}
+#endif
+	return PQexecParams(wrapper->conn, stmt->query->query, slots,
 			    paramTypes, paramValues, paramLengths, paramFormats,
 			    resultFormat);
 }
 
+/* Schema changes can alter the result types of prepared statements,
+ * which postgres refuses to replan: simply drop them all. */
+static void db_postgres_forget_prepared(struct db *db)
+{
+	struct db_postgres *wrapper = db->conn;
+
+	PQclear(db_postgres_exec_now(db, "DEALLOCATE ALL;"));
+	strset_clear(&wrapper->prepared);
+	strset_init(&wrapper->prepared);
+}
+
+/* Ask the replica whether it's no more than replica_max_lag behind. */
+static void replica_check(struct db_postgres *wrapper)
+{
+	PGresult *res;
+
+	wrapper->replica_checked = time_mono();
+
+	if (PQstatus(wrapper->replica) != CONNECTION_OK)
+		PQreset(wrapper->replica);
+
+	/* An idle primary sends nothing, so the last replayed transaction
+	 * can be old even though there is nothing left to replay.  But
+	 * receive and replay are also equal if the WAL receiver has lost
+	 * the primary, so that only counts while it's streaming (which
+	 * needs pg_read_all_stats to see: otherwise status is NULL, and
+	 * we never trust the replica). */
+	res = PQexec(wrapper->replica,
+		     "SELECT CASE"
+		     " WHEN (SELECT status FROM pg_stat_wal_receiver)"
+		     "  IS DISTINCT FROM 'streaming'"
+		     " THEN NULL"
+		     " WHEN pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn()"
+		     " THEN 0"
+		     " ELSE EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp())"
+		     " END;");
+	wrapper->replica_fresh = (PQresultStatus(res) == PGRES_TUPLES_OK
+				  && PQntuples(res) == 1
+				  && !PQgetisnull(res, 0, 0)
+				  && strtod(PQgetvalue(res, 0, 0), NULL)
+				  <= wrapper->replica_max_lag);
+	PQclear(res);
+}
+
+static bool replica_fresh(struct db_postgres *wrapper)
+{
+	if (!wrapper->replica)
+		return false;
+
+	if (time_greater_(wrapper->replica_avoid_until.ts, time_mono().ts))
+		return false;
+
+	if (!time_less(timemono_since(wrapper->replica_checked),
+		       time_from_sec(REPLICA_LAG_CHECK_SECS)))
+		replica_check(wrapper);
+	return wrapper->replica_fresh;
+}
+
+static bool db_postgres_replica(struct db *db, const char *dsn,
+				u32 max_lag_secs)
+{
+	struct db_postgres *wrapper = db->conn;
+	PGconn *conn = db_postgres_connect(dsn);
+
+	if (!conn) {
+		db->error = tal_fmt(db, "Replica %s is not a postgres DSN", dsn);
+		return false;
+	}
+	if (PQstatus(conn) != CONNECTION_OK) {
+		db->error = tal_fmt(db, "Could not connect to replica %s: %s",
+				    dsn, PQerrorMessage(conn));
+		PQfinish(conn);
+		return false;
+	}
+
+	wrapper->replica = conn;
+	wrapper->replica_max_lag = max_lag_secs;
+	wrapper->replica_avoid_until = time_mono();
+	replica_check(wrapper);
+	return true;
+}
+
 static bool db_postgres_query(struct db_stmt *stmt)
 {
-	stmt->inner_stmt = db_postgres_do_exec(stmt);
+	struct db_postgres *wrapper = stmt->db->conn;
+	PGresult *r;
 	int res;
+
+	if (stmt->replica_ok && replica_fresh(wrapper)) {
+		r = db_postgres_do_exec(stmt, false, wrapper->replica);
+		if (PQresultStatus(r) == PGRES_TUPLES_OK) {
+			stmt->inner_stmt = r;
+			stmt->row = -1;
+			return true;
+		}
+		/* Whatever went wrong, the primary can answer it: don't
+		 * use the replica again until it passes another check. */
+		PQclear(r);
+		wrapper->replica_fresh = false;
+	}
+
+	r = db_postgres_do_exec(stmt, false, NULL);
+
+	/* We need the rows now. */
+	if (!r)
+		pipeline_wait(stmt);
+	else
+		stmt->inner_stmt = r;
 	res = PQresultStatus(stmt->inner_stmt);
 
 	if (res != PGRES_EMPTY_QUERY && res != PGRES_TUPLES_OK) {
-		stmt->error = PQerrorMessage(stmt->db->conn);
+		stmt->error = tal_strdup(stmt,
+					 PQresultErrorMessage(stmt->inner_stmt));
 		PQclear(stmt->inner_stmt);
 		stmt->inner_stmt = NULL;
 		return false;
@@ -215,6 +625,11 @@ static const unsigned char *db_postgres_column_text(struct db_stmt *stmt, int co
 
 static void db_postgres_stmt_free(struct db_stmt *stmt)
 {
+	if (stmt->inner_stmt == &result_pending) {
+		/* Result will simply be discarded when it arrives. */
+		pipeline_forget(stmt);
+		stmt->inner_stmt = NULL;
+	}
 	if (stmt->inner_stmt)
 		PQclear(stmt->inner_stmt);
 	stmt->inner_stmt = NULL;
@@ -223,18 +638,24 @@ static void db_postgres_stmt_free(struct db_stmt *stmt)
 static bool db_postgres_exec(struct db_stmt *stmt)
 {
 	bool ok;
-	stmt->inner_stmt = db_postgres_do_exec(stmt);
+	PGresult *r = db_postgres_do_exec(stmt, true, NULL);
+
+	/* Queued: any error will be fatal when the result arrives. */
+	if (!r)
+		return true;
+
+	stmt->inner_stmt = r;
 	ok = PQresultStatus(stmt->inner_stmt) == PGRES_COMMAND_OK;
 
 	if (!ok)
-		stmt->error = PQerrorMessage(stmt->db->conn);
+		stmt->error = PQerrorMessage(conn2pg(stmt->db->conn));
 
 	return ok;
 }
 
 static u64 db_postgres_last_insert_id(struct db_stmt *stmt)
 {
-	PGresult *res = PQexec(stmt->db->conn, "SELECT lastval()");
+	PGresult *res = db_postgres_exec_now(stmt->db, "SELECT lastval()");
 	int id = atoi(PQgetvalue(res, 0, 0));
 	PQclear(res);
 	return id;
@@ -242,13 +663,23 @@ static u64 db_postgres_last_insert_id(struct db_stmt *stmt)
 
 static size_t db_postgres_count_changes(struct db_stmt *stmt)
 {
-	PGresult *res = (PGresult*)stmt->inner_stmt;
+	PGresult *res;
+
+	pipeline_wait(stmt);
+	res = (PGresult*)stmt->inner_stmt;
 	char *count = PQcmdTuples(res);
 	return atoi(count);
 }
 
 static void db_postgres_teardown(struct db *db)
 {
+	struct db_postgres *wrapper = db->conn;
+
+	if (wrapper) {
+		strset_clear(&wrapper->prepared);
+		if (wrapper->replica)
+			PQfinish(wrapper->replica);
+	}
 }
 
 static bool db_postgres_vacuum(struct db *db)
@@ -262,10 +693,10 @@ static bool db_postgres_vacuum(struct db *db)
 		return true;
 #endif
 
-	res = PQexec(db->conn, "VACUUM FULL;");
+	res = PQexec(conn2pg(db->conn), "VACUUM FULL;");
 	if (PQresultStatus(res) != PGRES_COMMAND_OK) {
 		db->error = tal_fmt(db, "VACUUM command failed: %s",
-				    PQerrorMessage(db->conn));
+				    PQerrorMessage(conn2pg(db->conn)));
 		PQclear(res);
 		return false;
 	}
@@ -281,6 +712,7 @@ static bool db_postgres_rename_column(struct db *db,
 
 	cmd = tal_fmt(db, "ALTER TABLE %s RENAME %s TO %s;",
 		      tablename, from, to);
+	db_postgres_forget_prepared(db);
 	db_exec_prepared_v2(take(db_prepare_untranslated(db, cmd)));
 	return true;
 }
@@ -299,6 +731,7 @@ static bool db_postgres_delete_columns(struct db *db,
 	}
 	tal_append_fmt(&cmd, ";");
 
+	db_postgres_forget_prepared(db);
 	db_exec_prepared_v2(take(db_prepare_untranslated(db, cmd)));
 	return true;
 }
@@ -322,6 +755,7 @@ struct db_config db_postgres_config = {
     .last_insert_id_fn = db_postgres_last_insert_id,
     .count_changes_fn = db_postgres_count_changes,
     .setup_fn = db_postgres_setup,
+    .replica_fn = db_postgres_replica,
     .teardown_fn = db_postgres_teardown,
     .vacuum_fn = db_postgres_vacuum,
     .rename_column = db_postgres_rename_column,
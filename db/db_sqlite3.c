@@ -7,13 +7,93 @@
 #include <db/utils.h>
 
 #if HAVE_SQLITE3
+  #include <pthread.h>
   #include <sqlite3.h>
 
+/* How many prepared statements we keep around for reuse. */
+#define STMT_CACHE_SIZE 64
+
+/* In WAL mode, how often the background thread checkpoints. */
+#define CHECKPOINT_INTERVAL_SECS 1
+
+/* A prepared statement for one of the compiled-in queries. */
+struct cached_stmt {
+	/* In db_sqlite3.stmt_cache, most recently used first. */
+	struct list_node list;
+	size_t query_idx;
+	sqlite3_stmt *s;
+	/* A db_stmt is using it now (same query can be nested!) */
+	bool in_use;
+};
+
+/* Threading rules.  Everything else in lightningd (and the rest of this
+ * file) runs on the main thread; these are the only other threads, and
+ * they're deliberately dumb:
+ *
+ * - The replicator thread owns replicator.conn (the backup db), and
+ *   touches the queue, counters, failed and stop only under its lock.
+ * - The checkpointer thread owns checkpointer.conn (its own connection
+ *   to the main db), and reads stop only under its lock.
+ * - Neither ever calls tal, logging, the db layer or anything ccan/io:
+ *   only sqlite3, pthreads, malloc and free.  Anything they hand back
+ *   (like replicator.failed) is malloc'ed and read by the main thread.
+ * - The main thread starts and joins them (replicator_stop,
+ *   checkpointer_stop) before freeing these structures or closing
+ *   the main db. */
+
+/* A transaction for the replica thread: malloc'ed, not tal, as tal
+ * isn't thread-safe. */
+struct replica_batch {
+	struct replica_batch *next;
+	u64 seq;
+	char *sql;
+};
+
+/* Applies whole transactions to the backup db, so its commit (and
+ * fsync) overlaps with the main db's instead of following it. */
+struct replicator {
+	/* Only the thread touches this, once started. */
+	sqlite3 *conn;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	/* Signalled when a batch is queued, or we want it to stop. */
+	pthread_cond_t queued_cond;
+	/* Signalled when a batch has been applied. */
+	pthread_cond_t applied_cond;
+
+	/* The rest are protected by lock. */
+	struct replica_batch *head, **tail;
+	u64 queued, applied;
+	/* malloc'ed error message if a batch failed. */
+	char *failed;
+	bool stop;
+};
+
+/* In WAL mode, copies the log back into the db off the main thread. */
+struct checkpointer {
+	/* Its own connection to the main db. */
+	sqlite3 *conn;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	/* Protected by lock. */
+	bool stop;
+};
+
 struct db_sqlite3 {
 	/* The actual db connection.  */
 	sqlite3 *conn;
 	/* A replica db connection, if requested, or NULL otherwise.  */
 	sqlite3 *backup_conn;
+	/* If non-NULL, the thread which owns backup_conn. */
+	struct replicator *replicator;
+	/* Statements of this transaction, not yet given to replicator. */
+	char *replica_pending;
+	/* Non-NULL in WAL mode, if we could start it. */
+	struct checkpointer *checkpointer;
+	/* Prepared statements, so we don't prepare hot ones every time. */
+	struct list_head stmt_cache;
+	size_t num_cached;
 };
 
 /**
@@ -28,6 +108,269 @@ sqlite3 *conn2sql(void *conn)
 	return wrapper->conn;
 }
 
+static void stmt_cache_evict(struct db_sqlite3 *wrapper,
+			     struct cached_stmt *c)
+{
+	sqlite3_finalize(c->s);
+	list_del(&c->list);
+	wrapper->num_cached--;
+	tal_free(c);
+}
+
+/* Before we change the schema or close, drop everything not in use. */
+static void stmt_cache_flush(struct db_sqlite3 *wrapper)
+{
+	struct cached_stmt *c, *next;
+
+	list_for_each_safe(&wrapper->stmt_cache, c, next, list) {
+		if (!c->in_use)
+			stmt_cache_evict(wrapper, c);
+	}
+}
+
+/* Reuse a cached statement if we can, otherwise prepare (and maybe cache) */
+static int stmt_cache_prepare(struct db_sqlite3 *wrapper,
+			      const struct db_stmt *stmt,
+			      sqlite3_stmt **s)
+{
+	struct cached_stmt *c;
+	size_t idx;
+	int err;
+
+	if (!db_stmt_query_index(stmt, &idx))
+		return sqlite3_prepare_v2(wrapper->conn, stmt->query->query,
+					  -1, s, NULL);
+
+	list_for_each(&wrapper->stmt_cache, c, list) {
+		if (c->query_idx != idx)
+			continue;
+		/* Nested use: just prepare another one. */
+		if (c->in_use)
+			return sqlite3_prepare_v2(wrapper->conn,
+						  stmt->query->query,
+						  -1, s, NULL);
+		list_del(&c->list);
+		list_add(&wrapper->stmt_cache, &c->list);
+		c->in_use = true;
+		*s = c->s;
+		return SQLITE_OK;
+	}
+
+	err = sqlite3_prepare_v2(wrapper->conn, stmt->query->query, -1, s, NULL);
+	if (err != SQLITE_OK)
+		return err;
+
+	/* Make room by dropping the least-recently used idle statement. */
+	if (wrapper->num_cached == STMT_CACHE_SIZE) {
+		list_for_each_rev(&wrapper->stmt_cache, c, list) {
+			if (!c->in_use) {
+				stmt_cache_evict(wrapper, c);
+				break;
+			}
+		}
+		/* All in use?  Don't cache this one. */
+		if (wrapper->num_cached == STMT_CACHE_SIZE)
+			return SQLITE_OK;
+	}
+
+	c = tal(wrapper, struct cached_stmt);
+	c->query_idx = idx;
+	c->s = *s;
+	c->in_use = true;
+	list_add(&wrapper->stmt_cache, &c->list);
+	wrapper->num_cached++;
+	return SQLITE_OK;
+}
+
+/* Returns true if @s was a cached statement (now reset for reuse). */
+static bool stmt_cache_release(struct db_sqlite3 *wrapper, sqlite3_stmt *s)
+{
+	struct cached_stmt *c;
+
+	list_for_each(&wrapper->stmt_cache, c, list) {
+		if (c->s != s)
+			continue;
+		sqlite3_reset(s);
+		sqlite3_clear_bindings(s);
+		c->in_use = false;
+		return true;
+	}
+	return false;
+}
+
+static void *replicator_thread(void *arg)
+{
+	struct replicator *r = arg;
+	struct replica_batch *b;
+	char *errmsg;
+	int err;
+
+	pthread_mutex_lock(&r->lock);
+	for (;;) {
+		while (!r->head && !r->stop)
+			pthread_cond_wait(&r->queued_cond, &r->lock);
+		/* We drain the queue before stopping. */
+		b = r->head;
+		if (!b)
+			break;
+		r->head = b->next;
+		if (!r->head)
+			r->tail = &r->head;
+		pthread_mutex_unlock(&r->lock);
+
+		errmsg = NULL;
+		err = sqlite3_exec(r->conn, b->sql, NULL, NULL, &errmsg);
+
+		pthread_mutex_lock(&r->lock);
+		if (err != SQLITE_OK && !r->failed)
+			r->failed = strdup(errmsg ? errmsg : sqlite3_errstr(err));
+		sqlite3_free(errmsg);
+		r->applied = b->seq;
+		pthread_cond_broadcast(&r->applied_cond);
+		free(b->sql);
+		free(b);
+	}
+	pthread_mutex_unlock(&r->lock);
+	return NULL;
+}
+
+/* Hand the thread some SQL, returns the seq to wait for. */
+static u64 replicator_queue(struct replicator *r, const char *sql)
+{
+	struct replica_batch *b = malloc(sizeof(*b));
+	u64 seq;
+
+	b->next = NULL;
+	b->sql = strdup(sql);
+	if (!b->sql)
+		db_fatal("Out of memory replicating transaction");
+
+	pthread_mutex_lock(&r->lock);
+	seq = b->seq = ++r->queued;
+	*r->tail = b;
+	r->tail = &b->next;
+	pthread_cond_signal(&r->queued_cond);
+	pthread_mutex_unlock(&r->lock);
+	return seq;
+}
+
+/* Wait until the backup has durably committed batch seq. */
+static void replicator_wait(struct replicator *r, u64 seq)
+{
+	const char *failed;
+
+	pthread_mutex_lock(&r->lock);
+	while (r->applied < seq && !r->failed)
+		pthread_cond_wait(&r->applied_cond, &r->lock);
+	failed = r->failed;
+	pthread_mutex_unlock(&r->lock);
+
+	if (failed)
+		db_fatal("Failed to replicate transaction: %s", failed);
+}
+
+static struct replicator *replicator_start(const tal_t *ctx, sqlite3 *conn)
+{
+	struct replicator *r;
+
+	/* Two threads must be able to use two connections at once. */
+	if (!sqlite3_threadsafe())
+		return NULL;
+
+	r = tal(ctx, struct replicator);
+	r->conn = conn;
+	r->head = NULL;
+	r->tail = &r->head;
+	r->queued = r->applied = 0;
+	r->failed = NULL;
+	r->stop = false;
+	pthread_mutex_init(&r->lock, NULL);
+	pthread_cond_init(&r->queued_cond, NULL);
+	pthread_cond_init(&r->applied_cond, NULL);
+	if (pthread_create(&r->thread, NULL, replicator_thread, r) != 0)
+		return tal_free(r);
+	return r;
+}
+
+static void replicator_stop(struct replicator *r)
+{
+	pthread_mutex_lock(&r->lock);
+	r->stop = true;
+	pthread_cond_signal(&r->queued_cond);
+	pthread_mutex_unlock(&r->lock);
+	pthread_join(r->thread, NULL);
+
+	pthread_cond_destroy(&r->applied_cond);
+	pthread_cond_destroy(&r->queued_cond);
+	pthread_mutex_destroy(&r->lock);
+	free(r->failed);
+	tal_free(r);
+}
+
+static void *checkpointer_thread(void *arg)
+{
+	struct checkpointer *c = arg;
+	struct timespec until;
+
+	pthread_mutex_lock(&c->lock);
+	while (!c->stop) {
+		clock_gettime(CLOCK_REALTIME, &until);
+		until.tv_sec += CHECKPOINT_INTERVAL_SECS;
+		pthread_cond_timedwait(&c->cond, &c->lock, &until);
+		if (c->stop)
+			break;
+		pthread_mutex_unlock(&c->lock);
+		/* Passive never blocks the main connection: if it gets
+		 * busy, we simply try again next time. */
+		sqlite3_wal_checkpoint_v2(c->conn, NULL,
+					  SQLITE_CHECKPOINT_PASSIVE,
+					  NULL, NULL);
+		pthread_mutex_lock(&c->lock);
+	}
+	pthread_mutex_unlock(&c->lock);
+	return NULL;
+}
+
+static struct checkpointer *checkpointer_start(const tal_t *ctx,
+					       const char *filename)
+{
+	struct checkpointer *c;
+
+	if (!sqlite3_threadsafe())
+		return NULL;
+
+	c = tal(ctx, struct checkpointer);
+	if (sqlite3_open_v2(filename, &c->conn, SQLITE_OPEN_READWRITE, NULL)
+	    != SQLITE_OK) {
+		sqlite3_close(c->conn);
+		return tal_free(c);
+	}
+	c->stop = false;
+	pthread_mutex_init(&c->lock, NULL);
+	pthread_cond_init(&c->cond, NULL);
+	if (pthread_create(&c->thread, NULL, checkpointer_thread, c) != 0) {
+		pthread_cond_destroy(&c->cond);
+		pthread_mutex_destroy(&c->lock);
+		sqlite3_close(c->conn);
+		return tal_free(c);
+	}
+	return c;
+}
+
+static void checkpointer_stop(struct checkpointer *c)
+{
+	pthread_mutex_lock(&c->lock);
+	c->stop = true;
+	pthread_cond_signal(&c->cond);
+	pthread_mutex_unlock(&c->lock);
+	pthread_join(c->thread, NULL);
+
+	pthread_cond_destroy(&c->cond);
+	pthread_mutex_destroy(&c->lock);
+	sqlite3_close(c->conn);
+	tal_free(c);
+}
+
 static void replicate_statement(struct db_sqlite3 *wrapper,
 				const char *qry)
 {
@@ -37,6 +380,12 @@ static void replicate_statement(struct db_sqlite3 *wrapper,
 	if (!wrapper->backup_conn)
 		return;
 
+	/* Whole transactions go over at once, when we commit. */
+	if (wrapper->replicator) {
+		tal_append_fmt(&wrapper->replica_pending, "%s;\n", qry);
+		return;
+	}
+
 	sqlite3_prepare_v2(wrapper->backup_conn,
 			   qry, -1, &stmt, NULL);
 	err = sqlite3_step(stmt);
@@ -49,11 +398,36 @@ static void replicate_statement(struct db_sqlite3 *wrapper,
 			 qry);
 }
 
+/* Give the replicator everything so far, return seq to wait for (or 0) */
+static u64 replicate_pending(struct db_sqlite3 *wrapper, bool transaction)
+{
+	u64 seq;
+
+	if (!wrapper->replicator || streq(wrapper->replica_pending, ""))
+		return 0;
+
+	if (transaction)
+		seq = replicator_queue(wrapper->replicator,
+				       tal_fmt(tmpctx,
+					       "BEGIN TRANSACTION;\n%sCOMMIT;",
+					       wrapper->replica_pending));
+	else
+		seq = replicator_queue(wrapper->replicator,
+				       wrapper->replica_pending);
+	tal_free(wrapper->replica_pending);
+	wrapper->replica_pending = tal_strdup(wrapper, "");
+	return seq;
+}
+
 static void db_sqlite3_changes_add(struct db_sqlite3 *wrapper,
 				   struct db_stmt *stmt,
 				   const char *qry)
 {
 	replicate_statement(wrapper, qry);
+	/* Outside a transaction, it's committed already. */
+	if (!stmt->db->in_transaction && wrapper->replicator)
+		replicator_wait(wrapper->replicator,
+				replicate_pending(wrapper, false));
 	db_changes_add(stmt, qry);
 }
 
@@ -113,6 +487,57 @@ static const char *db_sqlite3_fmt_error(struct db_stmt *stmt)
 		       sqlite3_errmsg(conn2sql(stmt->db->conn)));
 }
 
+/* Commits become one append (and fsync) to the log, and checkpoints
+ * move to a background thread.  synchronous=FULL keeps every commit
+ * durable, which we need: NORMAL could forget the last ones. */
+static bool db_sqlite3_setup_wal(struct db *db, const char *filename)
+{
+	struct db_sqlite3 *wrapper = (struct db_sqlite3 *) db->conn;
+	sqlite3_stmt *stmt;
+	char *errmsg;
+	bool is_wal;
+	int err;
+
+	sqlite3_prepare_v2(wrapper->conn, "PRAGMA journal_mode = WAL;", -1,
+			   &stmt, NULL);
+	err = sqlite3_step(stmt);
+	is_wal = (err == SQLITE_ROW
+		  && streq((const char *)sqlite3_column_text(stmt, 0), "wal"));
+	sqlite3_finalize(stmt);
+	if (!is_wal) {
+		db->error = tal_fmt(db, "Could not switch %s to WAL mode: %s",
+				    filename, sqlite3_errmsg(wrapper->conn));
+		return false;
+	}
+
+	err = sqlite3_exec(wrapper->conn,
+			   "PRAGMA synchronous = FULL;"
+			   "PRAGMA mmap_size = 268435456;"
+			   "PRAGMA cache_size = -16384;",
+			   NULL, NULL, &errmsg);
+	if (err != SQLITE_OK) {
+		db->error = tal_fmt(db, "Could not tune WAL mode: %s", errmsg);
+		sqlite3_free(errmsg);
+		return false;
+	}
+
+	/* If we can't checkpoint in the background, sqlite3 will do it
+	 * itself at commit time, as usual. */
+	wrapper->checkpointer = checkpointer_start(wrapper, filename);
+	if (wrapper->checkpointer) {
+		err = sqlite3_exec(wrapper->conn,
+				   "PRAGMA wal_autocheckpoint = 0;",
+				   NULL, NULL, &errmsg);
+		if (err != SQLITE_OK) {
+			db->error = tal_fmt(db, "Could not disable autocheckpoint: %s",
+					    errmsg);
+			sqlite3_free(errmsg);
+			return false;
+		}
+	}
+	return true;
+}
+
 static bool db_sqlite3_setup(struct db *db)
 {
 	char *filename;
@@ -138,6 +563,8 @@ static bool db_sqlite3_setup(struct db *db)
 	}
 
 	wrapper = tal(db, struct db_sqlite3);
+	list_head_init(&wrapper->stmt_cache);
+	wrapper->num_cached = 0;
 	db->conn = wrapper;
 
 	err = sqlite3_open_v2(filename, &sql, flags, NULL);
@@ -154,6 +581,9 @@ static bool db_sqlite3_setup(struct db *db)
 			 sqlite3_errstr(err));
 	}
 
+	wrapper->replicator = NULL;
+	wrapper->replica_pending = tal_strdup(wrapper, "");
+	wrapper->checkpointer = NULL;
 	if (!backup_filename)
 		wrapper->backup_conn = NULL;
 	else {
@@ -202,6 +632,12 @@ static bool db_sqlite3_setup(struct db *db)
 		sqlite3_backup_finish(copier);
 	}
 
+	/* From here on, only the replicator uses backup_conn (if we can
+	 * have one: otherwise we replicate each statement ourselves). */
+	if (wrapper->backup_conn)
+		wrapper->replicator = replicator_start(wrapper,
+						       wrapper->backup_conn);
+
 	/* In case another process (litestream?) grabs a lock, we don't
 	 * want to return SQLITE_BUSY immediately (which will cause a
 	 * fatal error): give it 60 seconds.
@@ -210,6 +646,9 @@ static bool db_sqlite3_setup(struct db *db)
 	 */
 	sqlite3_busy_timeout(conn2sql(db->conn), 60000);
 
+	if (db->wal && !db_sqlite3_setup_wal(db, filename))
+		return false;
+
 	sqlite3_prepare_v2(conn2sql(db->conn),
 			   "PRAGMA foreign_keys = ON;", -1, &stmt, NULL);
 	err = sqlite3_step(stmt);
@@ -220,10 +659,10 @@ static bool db_sqlite3_setup(struct db *db)
 static bool db_sqlite3_query(struct db_stmt *stmt)
 {
 	sqlite3_stmt *s;
-	sqlite3 *conn = conn2sql(stmt->db->conn);
+	struct db_sqlite3 *wrapper = (struct db_sqlite3 *) stmt->db->conn;
 	int err;
 
-	err = sqlite3_prepare_v2(conn, stmt->query->query, -1, &s, NULL);
+	err = stmt_cache_prepare(wrapper, stmt, &s);
 
 	for (size_t i=0; i<stmt->query->placeholders; i++) {
 		struct db_binding *b = &stmt->bindings[i];
@@ -332,7 +771,8 @@ static bool db_sqlite3_begin_tx(struct db *db)
 		db->error = tal_fmt(db, "Failed to begin a transaction: %s", errmsg);
 		return false;
 	}
-	replicate_statement(wrapper, "BEGIN TRANSACTION;");
+	if (!wrapper->replicator)
+		replicate_statement(wrapper, "BEGIN TRANSACTION;");
 	return true;
 }
 
@@ -340,16 +780,23 @@ static bool db_sqlite3_commit_tx(struct db *db)
 {
 	int err;
 	char *errmsg;
+	u64 seq;
 
 	struct db_sqlite3 *wrapper = (struct db_sqlite3 *) db->conn;
 
+	/* Start the backup on it first, so both commit at once. */
+	seq = replicate_pending(wrapper, true);
 	err = sqlite3_exec(conn2sql(db->conn),
 				    "COMMIT;", NULL, NULL, &errmsg);
 	if (err != SQLITE_OK) {
 		db->error = tal_fmt(db, "Failed to commit a transaction: %s", errmsg);
 		return false;
 	}
-	replicate_statement(wrapper, "COMMIT;");
+	/* We don't return until the backup is just as durable. */
+	if (wrapper->replicator)
+		replicator_wait(wrapper->replicator, seq);
+	else
+		replicate_statement(wrapper, "COMMIT;");
 	return true;
 }
 
@@ -391,7 +838,9 @@ static const unsigned char *db_sqlite3_column_text(struct db_stmt *stmt, int col
 
 static void db_sqlite3_stmt_free(struct db_stmt *stmt)
 {
-	if (stmt->inner_stmt)
+	struct db_sqlite3 *wrapper = (struct db_sqlite3 *) stmt->db->conn;
+
+	if (stmt->inner_stmt && !stmt_cache_release(wrapper, stmt->inner_stmt))
 		sqlite3_finalize(stmt->inner_stmt);
 	stmt->inner_stmt = NULL;
 }
@@ -406,6 +855,13 @@ static void db_sqlite3_close(struct db *db)
 {
 	struct db_sqlite3 *wrapper = (struct db_sqlite3 *) db->conn;
 
+	/* sqlite3_close() fails if there are unfinalized statements. */
+	stmt_cache_flush(wrapper);
+	if (wrapper->replicator)
+		replicator_stop(wrapper->replicator);
+	/* Last connection to close does the final checkpoint. */
+	if (wrapper->checkpointer)
+		checkpointer_stop(wrapper->checkpointer);
 	if (wrapper->backup_conn)
 		sqlite3_close(wrapper->backup_conn);
 	sqlite3_close(wrapper->conn);
@@ -432,7 +888,12 @@ static bool db_sqlite3_vacuum(struct db *db)
 		db->error = tal_fmt(db, "%s",
 				    sqlite3_errmsg(conn2sql(db->conn)));
 	sqlite3_finalize(stmt);
-	replicate_statement(wrapper, "VACUUM;");
+	if (wrapper->replicator)
+		replicator_wait(wrapper->replicator,
+				replicator_queue(wrapper->replicator,
+						 "VACUUM;"));
+	else
+		replicate_statement(wrapper, "VACUUM;");
 
 	return err == SQLITE_DONE;
 }
@@ -475,6 +936,9 @@ static char **prepare_table_manip(const tal_t *ctx,
 	int err;
 	struct db_sqlite3 *wrapper = (struct db_sqlite3 *)db->conn;
 
+	/* We're about to drop this table: cached statements may refer to it. */
+	stmt_cache_flush(wrapper);
+
 	/* Get schema. */
 	sqlite3_prepare_v2(wrapper->conn, "SELECT sql FROM sqlite_master WHERE type = ? AND name = ?;", -1, &stmt, NULL);
 	sqlite3_bind_text(stmt, 1, "table", strlen("table"), SQLITE_TRANSIENT);
@@ -1,5 +1,6 @@
 #include "config.h"
-#include <ccan/tal/tal.h>
+#include <ccan/tal/str/str.h>
+#include <common/trace_probe.h>
 #include <db/bindings.h>
 #include <db/common.h>
 #include <db/exec.h>
@@ -125,6 +126,7 @@ static void db_data_version_incr(struct db *db)
 void db_begin_transaction_(struct db *db, const char *location)
 {
 	bool ok;
+	struct timemono start;
 	if (db->in_transaction)
 		db_fatal("Already in transaction from %s", db->in_transaction);
 
@@ -132,7 +134,16 @@ void db_begin_transaction_(struct db *db, const char *location)
 	db->dirty = false;
 
 	db_prepare_for_changes(db);
+
+	/* Simply continue the underlying transaction. */
+	if (db->commit_pending) {
+		db->in_transaction = location;
+		return;
+	}
+
+	start = time_mono();
 	ok = db->config->begin_tx_fn(db);
+	db_add_time_spent(db, start);
 	if (!ok)
 		db_fatal("Failed to start DB transaction: %s", db->error);
 
@@ -144,10 +155,20 @@ bool db_in_transaction(struct db *db)
 	return db->in_transaction;
 }
 
+struct timerel db_time_spent(const struct db *db)
+{
+	return db->time_spent;
+}
+
 void db_commit_transaction(struct db *db)
 {
 	bool ok;
+	struct timemono start;
 	assert(db->in_transaction);
+
+	if (db->precommit_fn)
+		db->precommit_fn(db->precommit_arg);
+
 	db_assert_no_outstanding_statements(db);
 
 	/* Increment before reporting changes to an eventual plugin. */
@@ -155,11 +176,76 @@ void db_commit_transaction(struct db *db)
 		db_data_version_incr(db);
 
 	db_report_changes(db, NULL, 0);
+	db->in_transaction = NULL;
+
+	if (db->group_commit) {
+		db->commit_pending = true;
+		db->dirty = false;
+		return;
+	}
+
+	TRACE_PROBE(db_commit_start);
+	start = time_mono();
 	ok = db->config->commit_tx_fn(db);
+	db_add_time_spent(db, start);
+	TRACE_PROBE1(db_commit_end, ok);
 
 	if (!ok)
 		db_fatal("Failed to commit DB transaction: %s", db->error);
 
-	db->in_transaction = NULL;
 	db->dirty = false;
 }
+
+void db_set_precommit_(struct db *db, void (*cb)(void *), void *arg)
+{
+	db->precommit_fn = cb;
+	db->precommit_arg = arg;
+}
+
+bool db_group_commit(const struct db *db)
+{
+	return db->group_commit;
+}
+
+bool db_commit_pending(const struct db *db)
+{
+	return db->commit_pending;
+}
+
+void db_commit_flush(struct db *db)
+{
+	bool ok;
+	struct timemono start;
+
+	assert(!db->in_transaction);
+	if (!db->commit_pending)
+		return;
+
+	TRACE_PROBE(db_commit_start);
+	start = time_mono();
+	ok = db->config->commit_tx_fn(db);
+	db_add_time_spent(db, start);
+	TRACE_PROBE1(db_commit_end, ok);
+
+	if (!ok)
+		db_fatal("Failed to commit DB transaction: %s", db->error);
+
+	db->commit_pending = false;
+}
+
+bool db_set_replica(struct db *db, const char *dsn, u32 max_lag_secs)
+{
+	if (!db->config->replica_fn) {
+		db->error = tal_fmt(db, "%s databases don't support replicas",
+				    db->config->name);
+		return false;
+	}
+	return db->config->replica_fn(db, dsn, max_lag_secs);
+}
+
+void db_set_group_commit(struct db *db, bool enable)
+{
+	if (!enable)
+		db_commit_flush(db);
+	db->group_commit = enable;
+}
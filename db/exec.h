@@ -4,6 +4,8 @@
 
 #include <ccan/short_types/short_types.h>
 #include <ccan/take/take.h>
+#include <ccan/time/time.h>
+#include <ccan/typesafe_cb/typesafe_cb.h>
 
 struct db;
 
@@ -40,6 +42,14 @@ void db_begin_transaction_(struct db *db, const char *location);
 
 bool db_in_transaction(struct db *db);
 
+/**
+ * db_time_spent - Total time spent inside the database driver
+ *
+ * Includes statement execution, row stepping and transaction
+ * begin/commit.  Callers sample it before and after some work.
+ */
+struct timerel db_time_spent(const struct db *db);
+
 /**
  * db_commit_transaction - Commit a running transaction
  *
@@ -48,5 +58,52 @@ bool db_in_transaction(struct db *db);
  */
 void db_commit_transaction(struct db *db);
 
+/**
+ * db_set_precommit - Set a callback to run before every commit
+ *
+ * It runs inside the transaction, so it can still write (e.g. flush
+ * writes which were cached during the transaction).
+ */
+#define db_set_precommit(db, cb, arg)					\
+	db_set_precommit_((db),						\
+			  typesafe_cb(void, void *, (cb), (arg)),	\
+			  (arg))
+void db_set_precommit_(struct db *db, void (*cb)(void *), void *arg);
+
+/**
+ * db_set_replica - Answer db_query_prepared_stale() from a read replica
+ * @db: the database
+ * @dsn: how to reach the replica
+ * @max_lag_secs: past this, we go back to the primary until it catches up
+ *
+ * Returns false (with db->error set) if the driver can't, or can't
+ * connect.
+ */
+bool db_set_replica(struct db *db, const char *dsn, u32 max_lag_secs);
+
+/**
+ * db_set_group_commit - Merge successive commits into one
+ *
+ * When enabled, db_commit_transaction() ends the transaction logically
+ * but leaves the underlying one open, so the next db_begin_transaction()
+ * continues it.  Nothing is durable until db_commit_flush(), so the
+ * caller must hold back anything which depends on it until then.
+ * Disabling flushes any pending commit.
+ */
+void db_set_group_commit(struct db *db, bool enable);
+
+/* Is group commit enabled? */
+bool db_group_commit(const struct db *db);
+
+/* Is there a committed transaction which is not yet durable? */
+bool db_commit_pending(const struct db *db);
+
+/**
+ * db_commit_flush - Make any pending group commit durable
+ *
+ * Must not be called inside a transaction.  fatal() on database error.
+ */
+void db_commit_flush(struct db *db);
+
 
 #endif /* LIGHTNING_DB_EXEC_H */
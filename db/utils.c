@@ -76,6 +76,7 @@ static struct db_stmt *db_prepare_core(struct db *db,
 	stmt->db = db;
 	stmt->query = db_query;
 	stmt->executed = false;
+	stmt->replica_ok = false;
 	stmt->inner_stmt = NULL;
 
 	tal_add_destructor(stmt, db_stmt_free);
@@ -116,6 +117,17 @@ struct db_stmt *db_prepare_v2_(const char *location, struct db *db,
 	return db_prepare_core(db, location, &db->queries->query_table[pos]);
 }
 
+bool db_stmt_query_index(const struct db_stmt *stmt, size_t *idx)
+{
+	const struct db_query_set *qs = stmt->db->queries;
+
+	if (stmt->query < qs->query_table
+	    || stmt->query >= qs->query_table + qs->query_table_size)
+		return false;
+	*idx = stmt->query - qs->query_table;
+	return true;
+}
+
 /* Provides replication and hook interface for raw SQL too */
 struct db_stmt *db_prepare_untranslated(struct db *db, const char *query)
 {
@@ -140,19 +152,32 @@ bool db_query_prepared(struct db_stmt *stmt)
 	/* Make sure we don't accidentally execute a modifying query using a
 	 * read-only path. */
 	bool ret;
+	struct timemono start = time_mono();
 	assert(stmt->query->readonly);
 	ret = stmt->db->config->query_fn(stmt);
+	db_add_time_spent(stmt->db, start);
 	stmt->executed = true;
 	list_del_from(&stmt->db->pending_statements, &stmt->list);
 	return ret;
 }
 
+bool db_query_prepared_stale(struct db_stmt *stmt)
+{
+	struct db *db = stmt->db;
+
+	/* A replica can only have what we've really committed. */
+	stmt->replica_ok = !db->dirty && !db->commit_pending;
+	return db_query_prepared(stmt);
+}
+
 bool db_step(struct db_stmt *stmt)
 {
 	bool ret;
+	struct timemono start = time_mono();
 
 	assert(stmt->executed);
 	ret = stmt->db->config->step_fn(stmt);
+	db_add_time_spent(stmt->db, start);
 
 #if DEVELOPER
 	/* We only track cols_used if we return a result! */
@@ -166,8 +191,11 @@ bool db_step(struct db_stmt *stmt)
 
 bool db_exec_prepared_v2(struct db_stmt *stmt TAKES)
 {
+	struct timemono start = time_mono();
 	bool ret = stmt->db->config->exec_fn(stmt);
 
+	db_add_time_spent(stmt->db, start);
+
 	/* If this was a write we need to bump the data_version upon commit. */
 	stmt->db->dirty = stmt->db->dirty || !stmt->query->readonly;
 
@@ -310,7 +338,7 @@ void db_prepare_for_changes(struct db *db)
 	db->changes = tal_arr(db, const char *, 0);
 }
 
-struct db *db_open(const tal_t *ctx, const char *filename)
+struct db *db_open(const tal_t *ctx, const char *filename, bool wal)
 {
 	struct db *db;
 
@@ -331,6 +359,11 @@ struct db *db_open(const tal_t *ctx, const char *filename)
 	tal_add_destructor(db, destroy_db);
 	db->in_transaction = NULL;
 	db->changes = NULL;
+	db->time_spent = time_from_sec(0);
+	db->group_commit = false;
+	db->commit_pending = false;
+	db->wal = wal;
+	db->precommit_fn = NULL;
 
 	/* This must be outside a transaction, so catch it */
 	assert(!db->in_transaction);
@@ -51,6 +51,27 @@ bool db_exec_prepared_v2(struct db_stmt *stmt TAKES);
  */
 bool db_query_prepared(struct db_stmt *stmt);
 
+/**
+ * db_query_prepared_stale -- Execute a query which a replica may answer
+ *
+ * Like db_query_prepared, but if the db has a read replica (see
+ * db_set_replica), this transaction hasn't written anything and nothing
+ * has been committed within the replica's maximum lag, the results may
+ * come from there, so be up to that maximum lag out of date.
+ * For big reports (listforwards and friends), not for decisions.
+ *
+ * @stmt: The prepared statement to execute
+ */
+bool db_query_prepared_stale(struct db_stmt *stmt);
+
+/**
+ * db_stmt_query_index -- Which of the compiled-in queries is this?
+ *
+ * Returns false for db_prepare_untranslated() statements.  Backends use
+ * this index to cache prepared statements.
+ */
+bool db_stmt_query_index(const struct db_stmt *stmt, size_t *idx);
+
 size_t db_count_changes(struct db_stmt *stmt);
 void db_report_changes(struct db *db, const char *final, size_t min);
 void db_prepare_for_changes(struct db *db);
@@ -79,8 +100,9 @@ struct db_stmt *db_prepare_v2_(const char *location, struct db *db,
 
 /**
  * db_open - Open or create a database
+ * @wal: use write-ahead logging, if the driver supports it.
  */
-struct db *db_open(const tal_t *ctx, const char *filename);
+struct db *db_open(const tal_t *ctx, const char *filename, bool wal);
 
 /**
  * Report a statement that changes the wallet
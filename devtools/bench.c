@@ -0,0 +1,229 @@
+/* Micro-benchmarks for hot paths, with fixed inputs so runs are comparable.
+ *
+ * Prints one JSON object per line, one line per benchmark, eg:
+ * {"bench":"bolt11_decode","iterations":1000,"total_usec":35012,"nsec_per_op":35012}
+ */
+#include "config.h"
+#include <ccan/err/err.h>
+#include <ccan/opt/opt.h>
+#include <ccan/tal/str/str.h>
+#include <ccan/time/time.h>
+#include <common/bolt11.h>
+#include <common/cryptomsg.h>
+#include <common/dijkstra.h>
+#include <common/gossmap.h>
+#include <common/json_parse_simple.h>
+#include <common/route.h>
+#include <common/setup.h>
+#include <common/sphinx.h>
+#include <common/utils.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+/* BOLT #11 test vector: "Please make a donation of any amount" */
+static const char *bench_invoice =
+	"lnbc1pvjluezsp5zyg3zyg3zyg3zyg3zyg3zyg3zyg3zyg3zyg3zyg3zyg3zyg3zygs"
+	"pp5qqqsyqcyq5rqwzqfqqqsyqcyq5rqwzqfqqqsyqcyq5rqwzqfqypqdpl2pkx2ctnv5"
+	"sxxmmwwd5kgetjypeh2ursdae8g6twvus8g6rfwvs8qun0dfjkxaq9qrsgq357wnc5r2u"
+	"eh7ck6q93dj32dlqnls087fxdwk8qakdyafkq3yap9us6v52vjjsrvywa6rt52cm9r9zq"
+	"t8r2t7mlcwspyetp5h2tztugp9lfyql";
+
+static void report(const char *name, size_t iterations,
+		   struct timemono start)
+{
+	u64 usec = time_to_usec(timemono_since(start));
+
+	printf("{\"bench\":\"%s\",\"iterations\":%zu,"
+	       "\"total_usec\":%"PRIu64",\"nsec_per_op\":%"PRIu64"}\n",
+	       name, iterations, usec, usec * 1000 / iterations);
+	fflush(stdout);
+}
+
+/* Something shaped like a listpeerchannels response. */
+static char *bench_json(const tal_t *ctx)
+{
+	char *json = tal_strdup(ctx, "{\"channels\":[");
+
+	for (size_t i = 0; i < 200; i++) {
+		tal_append_fmt(&json,
+			       "%s{\"peer_id\":\"02%064zx\","
+			       "\"short_channel_id\":\"%zux1x0\","
+			       "\"state\":\"CHANNELD_NORMAL\","
+			       "\"to_us_msat\":%zu,\"total_msat\":1000000000,"
+			       "\"htlcs\":[],\"features\":[\"option_static_remotekey\"]}",
+			       i ? "," : "", i, 700000 + i, i * 1000);
+	}
+	tal_append_fmt(&json, "]}");
+	return json;
+}
+
+static void bench_json_parse(size_t iterations)
+{
+	const char *json = bench_json(tmpctx);
+	jsmntok_t *toks = toks_alloc(tmpctx);
+	struct timemono start = time_mono();
+
+	for (size_t i = 0; i < iterations; i++) {
+		jsmn_parser parser;
+		bool complete;
+
+		jsmn_init(&parser);
+		toks_reset(toks);
+		if (!json_parse_input(&parser, &toks, json, strlen(json),
+				      &complete) || !complete)
+			errx(1, "json_parse_input failed");
+	}
+	report("json_parse_input", iterations, start);
+}
+
+static void bench_bolt11_decode(size_t iterations)
+{
+	struct timemono start = time_mono();
+
+	for (size_t i = 0; i < iterations; i++) {
+		char *fail;
+		if (!bolt11_decode(tmpctx, bench_invoice, NULL, NULL, NULL,
+				   &fail))
+			errx(1, "bolt11_decode failed: %s", fail);
+		clean_tmpctx();
+	}
+	report("bolt11_decode", iterations, start);
+}
+
+static void bench_cryptomsg(size_t iterations)
+{
+	struct crypto_state cs_out, cs_in;
+	u8 *msg = tal_arrz(NULL, u8, 1000);
+	struct timemono start;
+
+	memset(&cs_out, 1, sizeof(cs_out));
+	cs_out.sn = cs_out.rn = 0;
+	cs_in = cs_out;
+	cs_in.sk = cs_out.rk;
+	cs_in.rk = cs_out.sk;
+
+	start = time_mono();
+	for (size_t i = 0; i < iterations; i++)
+		cryptomsg_encrypt_msg(tmpctx, &cs_out, msg);
+	report("cryptomsg_encrypt_msg", iterations, start);
+	clean_tmpctx();
+
+	/* Now the other side, with freshly encrypted messages. */
+	memset(&cs_out, 1, sizeof(cs_out));
+	cs_out.sn = cs_out.rn = 0;
+	start = time_mono();
+	for (size_t i = 0; i < iterations; i++) {
+		u8 *enc = cryptomsg_encrypt_msg(tmpctx, &cs_out, msg);
+		u8 *body;
+		u16 len;
+
+		if (!cryptomsg_decrypt_header(&cs_in, enc, &len))
+			errx(1, "cryptomsg_decrypt_header failed");
+		body = tal_dup_arr(tmpctx, u8, enc + CRYPTOMSG_HDR_SIZE,
+				   tal_bytelen(enc) - CRYPTOMSG_HDR_SIZE, 0);
+		if (!cryptomsg_decrypt_body(tmpctx, &cs_in, body))
+			errx(1, "cryptomsg_decrypt_body failed");
+		clean_tmpctx();
+	}
+	report("cryptomsg_roundtrip", iterations, start);
+	tal_free(msg);
+}
+
+static void bench_process_onionpacket(size_t iterations)
+{
+	const tal_t *ctx = tal(NULL, char);
+	struct privkey privkey;
+	struct pubkey pubkey;
+	struct secret session_key, *path_secrets;
+	struct sphinx_path *sp;
+	struct onionpacket *packet;
+	u8 assocdata[32];
+	struct timemono start;
+
+	memset(&privkey, 0x41, sizeof(privkey));
+	memset(&session_key, 0x42, sizeof(session_key));
+	memset(assocdata, 0x43, sizeof(assocdata));
+	if (!pubkey_from_privkey(&privkey, &pubkey))
+		abort();
+
+	sp = sphinx_path_new_with_key(ctx,
+				      tal_dup_arr(ctx, u8, assocdata,
+						  sizeof(assocdata), 0),
+				      &session_key);
+	sphinx_add_hop(sp, &pubkey, take(tal_arrz(NULL, u8, 40)));
+	packet = create_onionpacket(ctx, sp, ROUTING_INFO_SIZE,
+				    &path_secrets);
+
+	start = time_mono();
+	for (size_t i = 0; i < iterations; i++) {
+		struct secret ss;
+
+		if (!onion_shared_secret(&ss, packet, &privkey))
+			errx(1, "onion_shared_secret failed");
+		if (!process_onionpacket(tmpctx, packet, &ss,
+					 assocdata, sizeof(assocdata), true))
+			errx(1, "process_onionpacket failed");
+		clean_tmpctx();
+	}
+	report("process_onionpacket", iterations, start);
+	tal_free(ctx);
+}
+
+static void bench_dijkstra(const char *gossmap_file, size_t iterations)
+{
+	struct gossmap *map;
+	struct gossmap_node *dst;
+	struct timemono start;
+
+	start = time_mono();
+	map = gossmap_load(NULL, gossmap_file, NULL);
+	if (!map)
+		err(1, "Loading gossip store %s", gossmap_file);
+	report("gossmap_load", 1, start);
+
+	/* Always the same destination, so runs on one snapshot compare. */
+	dst = gossmap_first_node(map);
+	if (!dst)
+		errx(1, "Empty gossip store %s", gossmap_file);
+
+	start = time_mono();
+	for (size_t i = 0; i < iterations; i++) {
+		dijkstra(tmpctx, map, dst, AMOUNT_MSAT(10000000), 10,
+			 route_can_carry, route_score_cheaper, NULL);
+		clean_tmpctx();
+	}
+	report("dijkstra", iterations, start);
+	tal_free(map);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int iterations = 1000;
+	char *gossmap_file = NULL;
+
+	common_setup(argv[0]);
+
+	opt_register_arg("--iterations", opt_set_uintval, opt_show_uintval,
+			 &iterations, "Iterations for each benchmark");
+	opt_register_arg("--gossmap", opt_set_charp, NULL, &gossmap_file,
+			 "Gossip store to run dijkstra over (skipped if unset)");
+	opt_register_noarg("-h|--help", opt_usage_and_exit,
+			   "\n"
+			   "Micro-benchmarks for hot paths: one JSON line each.",
+			   "Get usage information");
+	opt_parse(&argc, argv, opt_log_stderr_exit);
+	if (argc != 1)
+		opt_usage_exit_fail("Expected no arguments");
+	if (iterations == 0)
+		opt_usage_exit_fail("--iterations must be non-zero");
+
+	bench_json_parse(iterations);
+	bench_bolt11_decode(iterations);
+	bench_cryptomsg(iterations);
+	bench_process_onionpacket(iterations);
+	if (gossmap_file)
+		bench_dijkstra(gossmap_file, iterations / 100 + 1);
+
+	common_shutdown();
+	return 0;
+}
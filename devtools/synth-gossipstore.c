@@ -0,0 +1,316 @@
+/* Generate a synthetic gossip_store of a scale-free network, for benchmarks.
+ *
+ * Signatures are zero: the gossip_store is trusted by its readers
+ * (gossmap, and gossipd on load), so this is enough for routing and
+ * loading benchmarks, but it can't be gossiped to real peers.
+ */
+#include "config.h"
+#include <ccan/array_size/array_size.h>
+#include <ccan/crc32c/crc32c.h>
+#include <ccan/err/err.h>
+#include <ccan/isaac/isaac64.h>
+#include <ccan/opt/opt.h>
+#include <ccan/read_write_all/read_write_all.h>
+#include <ccan/tal/str/str.h>
+#include <common/gossip_constants.h>
+#include <common/gossip_store.h>
+#include <common/node_id.h>
+#include <common/setup.h>
+#include <common/utils.h>
+#include <fcntl.h>
+#include <gossipd/gossip_store_wiregen.h>
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <wire/peer_wire.h>
+
+/* Keep in sync with gossipd/gossip_store.c */
+#define GOSSIP_STORE_VER ((0 << 5) | 12)
+
+struct synth {
+	isaac64_ctx rng;
+	int outfd;
+	const struct chainparams *chainparams;
+	u32 timestamp;
+	unsigned long min_capacity, max_capacity;
+	u32 max_fee_base, max_fee_ppm;
+	size_t bytes;
+};
+
+static void write_record(struct synth *s, const u8 *msg TAKES, u32 timestamp)
+{
+	struct gossip_hdr hdr;
+
+	hdr.flags = CPU_TO_BE16(0);
+	hdr.len = cpu_to_be16(tal_count(msg));
+	hdr.crc = cpu_to_be32(crc32c(timestamp, msg, tal_count(msg)));
+	hdr.timestamp = cpu_to_be32(timestamp);
+
+	if (!write_all(s->outfd, &hdr, sizeof(hdr))
+	    || !write_all(s->outfd, msg, tal_count(msg)))
+		err(1, "Writing output");
+	s->bytes += sizeof(hdr) + tal_count(msg);
+	if (taken(msg))
+		tal_free(msg);
+}
+
+/* Uniform in log space between min and max (inclusive-ish). */
+static u64 log_uniform(struct synth *s, u64 min, u64 max)
+{
+	double lmin = log((double)min), lmax = log((double)max);
+
+	if (max <= min)
+		return min;
+	return exp(lmin + isaac64_next_double(&s->rng) * (lmax - lmin));
+}
+
+static void write_update(struct synth *s,
+			 const struct short_channel_id *scid,
+			 int direction, struct amount_sat capacity,
+			 u32 timestamp)
+{
+	static const u16 cltv_deltas[] = { 18, 34, 40, 80, 144 };
+	secp256k1_ecdsa_signature sig;
+	struct amount_msat htlc_max;
+	u32 fee_base, fee_ppm;
+
+	memset(&sig, 0, sizeof(sig));
+	/* Plenty of nodes charge no base fee at all. */
+	if (isaac64_next_uint(&s->rng, 2))
+		fee_base = 0;
+	else
+		fee_base = log_uniform(s, 1, s->max_fee_base);
+	fee_ppm = log_uniform(s, 1, s->max_fee_ppm);
+	if (!amount_sat_to_msat(&htlc_max, capacity))
+		abort();
+
+	write_record(s,
+		     take(towire_channel_update(NULL, &sig,
+						&s->chainparams->genesis_blockhash,
+						scid, timestamp,
+						ROUTING_OPT_HTLC_MAX_MSAT,
+						direction,
+						cltv_deltas[isaac64_next_uint(&s->rng,
+									      ARRAY_SIZE(cltv_deltas))],
+						AMOUNT_MSAT(1000),
+						fee_base, fee_ppm, htlc_max)),
+		     timestamp);
+}
+
+static void write_channel(struct synth *s,
+			  const struct short_channel_id *scid,
+			  const struct pubkey *a, const struct pubkey *b)
+{
+	secp256k1_ecdsa_signature sig;
+	struct node_id ida, idb;
+	struct amount_sat capacity;
+	const struct pubkey *k1, *k2;
+	const struct node_id *id1, *id2;
+
+	memset(&sig, 0, sizeof(sig));
+	node_id_from_pubkey(&ida, a);
+	node_id_from_pubkey(&idb, b);
+	/* BOLT #7: node_id_1 is the lexicographically lesser */
+	if (node_id_cmp(&ida, &idb) < 0) {
+		id1 = &ida; id2 = &idb; k1 = a; k2 = b;
+	} else {
+		id1 = &idb; id2 = &ida; k1 = b; k2 = a;
+	}
+
+	capacity.satoshis /* Raw: synthetic capacity */
+		= log_uniform(s, s->min_capacity, s->max_capacity);
+
+	write_record(s,
+		     take(towire_channel_announcement(NULL, &sig, &sig,
+						      &sig, &sig, NULL,
+						      &s->chainparams->genesis_blockhash,
+						      scid, id1, id2, k1, k2)),
+		     s->timestamp);
+	write_record(s, take(towire_gossip_store_channel_amount(NULL,
+								  capacity)),
+		     0);
+	write_update(s, scid, 0, capacity, s->timestamp);
+	write_update(s, scid, 1, capacity, s->timestamp);
+}
+
+static void write_node(struct synth *s, const struct pubkey *key, size_t n)
+{
+	secp256k1_ecdsa_signature sig;
+	struct node_id id;
+	u8 alias[32];
+	char *name;
+
+	memset(&sig, 0, sizeof(sig));
+	memset(alias, 0, sizeof(alias));
+	name = tal_fmt(tmpctx, "synth-%zu", n);
+	memcpy(alias, name, strlen(name));
+	node_id_from_pubkey(&id, key);
+
+	write_record(s,
+		     take(towire_node_announcement(NULL, &sig, NULL,
+						   s->timestamp, &id, id.k + 1,
+						   alias, NULL,
+						   tlv_node_ann_tlvs_new(tmpctx))),
+		     s->timestamp);
+}
+
+static struct short_channel_id synth_scid(size_t n)
+{
+	struct short_channel_id scid;
+
+	/* Spread over blocks, a few channels per block like mainnet. */
+	if (!mk_short_channel_id(&scid, 500000 + n / 16, n % 16, 0))
+		abort();
+	return scid;
+}
+
+int main(int argc, char *argv[])
+{
+	struct synth s;
+	unsigned int num_nodes = 1000, num_channels = 5000, num_updates = 0;
+	unsigned int seed = 0;
+	char *outfile = NULL, *network = "regtest";
+	double preferential = 0.8;
+	struct pubkey *keys;
+	u32 *endpoints;
+	u8 version = GOSSIP_STORE_VER;
+
+	common_setup(argv[0]);
+
+	s.timestamp = 1600000000;
+	s.min_capacity = 20000;
+	s.max_capacity = 100000000;
+	s.max_fee_base = 5000;
+	s.max_fee_ppm = 5000;
+	s.bytes = 0;
+
+	opt_register_arg("--nodes", opt_set_uintval, opt_show_uintval,
+			 &num_nodes, "Number of nodes");
+	opt_register_arg("--channels", opt_set_uintval, opt_show_uintval,
+			 &num_channels,
+			 "Number of channels (at least nodes - 1)");
+	opt_register_arg("--preferential", opt_set_doubleval,
+			 opt_show_doubleval, &preferential,
+			 "Chance each channel's second end is picked by degree"
+			 " (0 = uniformly random, 1 = purely scale-free)");
+	opt_register_arg("--updates", opt_set_uintval, opt_show_uintval,
+			 &num_updates,
+			 "Extra channel_updates to append, newer than the originals");
+	opt_register_arg("--min-capacity", opt_set_ulongval_si,
+			 opt_show_ulongval_si, &s.min_capacity,
+			 "Smallest channel capacity (sat)");
+	opt_register_arg("--max-capacity", opt_set_ulongval_si,
+			 opt_show_ulongval_si, &s.max_capacity,
+			 "Largest channel capacity (sat)");
+	opt_register_arg("--max-fee-base", opt_set_uintval,
+			 opt_show_uintval, &s.max_fee_base,
+			 "Largest fee_base_msat (half of channels use 0)");
+	opt_register_arg("--max-fee-ppm", opt_set_uintval,
+			 opt_show_uintval, &s.max_fee_ppm,
+			 "Largest fee_proportional_millionths");
+	opt_register_arg("--seed", opt_set_uintval, opt_show_uintval,
+			 &seed, "Random seed: same seed, same network");
+	opt_register_arg("--network", opt_set_charp, NULL, &network,
+			 "Chain to generate for");
+	opt_register_arg("--output|-o", opt_set_charp, NULL, &outfile,
+			 "Send output to this file instead of stdout");
+	opt_register_noarg("--help|-h", opt_usage_and_exit,
+			   "\n"
+			   "Generate a synthetic gossip_store for benchmarks.",
+			   "Print this message.");
+	opt_parse(&argc, argv, opt_log_stderr_exit);
+	if (argc != 1)
+		opt_usage_exit_fail("Expected no arguments");
+	if (num_nodes < 2)
+		opt_usage_exit_fail("Need at least 2 nodes");
+	if (num_channels < num_nodes - 1)
+		opt_usage_exit_fail("Need at least nodes - 1 channels");
+	if (preferential < 0 || preferential > 1)
+		opt_usage_exit_fail("--preferential must be between 0 and 1");
+	if (s.min_capacity == 0 || s.min_capacity > s.max_capacity)
+		opt_usage_exit_fail("Bad capacity range");
+
+	s.chainparams = chainparams_for_network(network);
+	if (!s.chainparams)
+		errx(1, "Unknown network %s", network);
+	isaac64_init(&s.rng, (const unsigned char *)&seed, sizeof(seed));
+
+	if (outfile) {
+		s.outfd = open(outfile, O_WRONLY|O_TRUNC|O_CREAT, 0666);
+		if (s.outfd < 0)
+			err(1, "opening %s", outfile);
+	} else
+		s.outfd = STDOUT_FILENO;
+
+	if (!write_all(s.outfd, &version, sizeof(version)))
+		err(1, "Writing version");
+
+	keys = tal_arr(NULL, struct pubkey, num_nodes);
+	for (size_t i = 0; i < num_nodes; i++) {
+		struct privkey p;
+
+		memset(&p, 0, sizeof(p));
+		/* Node i has privkey i+1 (big-endian) */
+		for (size_t b = 0; b < sizeof(size_t); b++)
+			p.secret.data[31 - b] = (i + 1) >> (b * 8);
+		if (!pubkey_from_privkey(&p, &keys[i]))
+			abort();
+	}
+
+	/* Every channel adds both ends here, so picking a random entry
+	 * picks a node with probability proportional to its degree. */
+	endpoints = tal_arr(keys, u32, 0);
+	for (size_t n = 0; n < num_channels; n++) {
+		struct short_channel_id scid = synth_scid(n);
+		u32 a, b;
+
+		/* The first nodes - 1 channels make a connected tree, each
+		 * joining a new node to the network grown so far. */
+		if (n < num_nodes - 1) {
+			a = n + 1;
+			if (n > 0
+			    && isaac64_next_double(&s.rng) < preferential)
+				b = endpoints[isaac64_next_uint(&s.rng,
+								tal_count(endpoints))];
+			else
+				b = isaac64_next_uint(&s.rng, n + 1);
+		} else {
+			a = isaac64_next_uint(&s.rng, num_nodes);
+			do {
+				if (isaac64_next_double(&s.rng) < preferential)
+					b = endpoints[isaac64_next_uint(&s.rng,
+									tal_count(endpoints))];
+				else
+					b = isaac64_next_uint(&s.rng, num_nodes);
+			} while (b == a);
+		}
+
+		write_channel(&s, &scid, &keys[a], &keys[b]);
+		tal_arr_expand(&endpoints, a);
+		tal_arr_expand(&endpoints, b);
+		clean_tmpctx();
+	}
+
+	for (size_t i = 0; i < num_nodes; i++) {
+		write_node(&s, &keys[i], i);
+		clean_tmpctx();
+	}
+
+	/* Later updates to random channels, like fee changes over time */
+	for (size_t i = 0; i < num_updates; i++) {
+		struct short_channel_id scid;
+		struct amount_sat capacity;
+
+		scid = synth_scid(isaac64_next_uint(&s.rng, num_channels));
+		/* Capacity only sets htlc_maximum_msat: keep it plausible. */
+		capacity = amount_sat(s.min_capacity);
+		write_update(&s, &scid, isaac64_next_uint(&s.rng, 2), capacity,
+			     s.timestamp + 86400 * (1 + i / num_channels));
+	}
+
+	fprintf(stderr, "nodes %u, channels %u, extra updates %u, %zu bytes\n",
+		num_nodes, num_channels, num_updates, s.bytes);
+	tal_free(keys);
+	common_shutdown();
+	return 0;
+}
@@ -100,13 +100,15 @@ void get_cupdate_parts(const u8 *channel_update,
 	 *    * [`u32`:`timestamp`]
 	 *...
 	 */
-	/* Note: 2 bytes for `type` field */
 	/* We already checked it's valid before accepting */
-	assert(tal_count(channel_update) > 2 + 64 + 32 + 8 + 4);
-	parts[0] = channel_update + 2 + 64;
-	sizes[0] = 32 + 8;
-	parts[1] = channel_update + 2 + 64 + 32 + 8 + 4;
-	sizes[1] = tal_count(channel_update) - (64 + 2 + 32 + 8 + 4);
+	assert(tal_count(channel_update)
+	       > WIRE_CHANNEL_UPDATE_MESSAGE_FLAGS_OFFSET);
+	parts[0] = channel_update + WIRE_CHANNEL_UPDATE_CHAIN_HASH_OFFSET;
+	sizes[0] = WIRE_CHANNEL_UPDATE_TIMESTAMP_OFFSET
+		- WIRE_CHANNEL_UPDATE_CHAIN_HASH_OFFSET;
+	parts[1] = channel_update + WIRE_CHANNEL_UPDATE_MESSAGE_FLAGS_OFFSET;
+	sizes[1] = tal_count(channel_update)
+		- WIRE_CHANNEL_UPDATE_MESSAGE_FLAGS_OFFSET;
 }
 
 /* Is this channel_update different from prev (not sigs and timestamps)? */
@@ -781,6 +783,27 @@ void refresh_local_channel(struct daemon *daemon,
 	sign_timestamp_and_apply_update(daemon, chan, direction, take(update));
 }
 
+/* If we're limiting the rate of our channel_updates, how long should the
+ * next one wait? */
+static u32 local_update_delay(struct daemon *daemon)
+{
+	u32 now;
+
+	if (!daemon->channel_update_rate)
+		return 0;
+
+	now = time_now().ts.tv_sec;
+	if (daemon->update_slot_time < now) {
+		daemon->update_slot_time = now;
+		daemon->update_slot_count = 0;
+	} else if (daemon->update_slot_count == daemon->channel_update_rate) {
+		daemon->update_slot_time++;
+		daemon->update_slot_count = 0;
+	}
+	daemon->update_slot_count++;
+	return daemon->update_slot_time - now;
+}
+
 /* channeld (via lightningd) asks us to update the local channel. */
 void handle_local_channel_update(struct daemon *daemon, const u8 *msg)
 {
@@ -795,6 +818,7 @@ void handle_local_channel_update(struct daemon *daemon, const u8 *msg)
 	u8 *unsigned_update;
 	const struct half_chan *hc;
 	bool public;
+	u32 delay;
 
 	if (!fromwire_gossipd_local_channel_update(msg,
 						   &id,
@@ -852,6 +876,16 @@ void handle_local_channel_update(struct daemon *daemon, const u8 *msg)
 		}
 	}
 
+	/* Spread out bursts (private ones go direct to peer, so don't care) */
+	if (is_chan_public(chan)) {
+		delay = local_update_delay(daemon);
+		if (delay) {
+			defer_update(daemon, delay,
+				     chan, direction, take(unsigned_update));
+			return;
+		}
+	}
+
 	sign_timestamp_and_apply_update(daemon, chan, direction,
 					take(unsigned_update));
 }
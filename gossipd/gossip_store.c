@@ -7,6 +7,7 @@
 #include <common/gossip_store.h>
 #include <common/private_channel_announcement.h>
 #include <common/status.h>
+#include <common/timeout.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <gossipd/gossip_store.h>
@@ -46,12 +47,23 @@ struct gossip_store {
 	 * compaction */
 	bool disable_compaction;
 
+	/* Non-NULL while we're compacting */
+	struct compaction *compaction;
+
+	/* Appended records not yet written, which end at len.  We gather
+	 * these and write them together once per io_loop iteration. */
+	u8 *pending;
+	struct oneshot *flush_timer;
+
 	/* Timestamp of store when we opened it (0 if we created it) */
 	u32 timestamp;
 };
 
+static void gossip_store_flush(struct gossip_store *gs);
+
 static void gossip_store_destroy(struct gossip_store *gs)
 {
+	gossip_store_flush(gs);
 	close(gs->fd);
 }
 
@@ -72,6 +84,23 @@ static ssize_t gossip_pwritev(int fd, const struct iovec *iov, int iovcnt,
 }
 #endif /* !HAVE_PWRITEV */
 
+static void fill_hdr(struct gossip_hdr *hdr, const u8 *msg, u32 timestamp,
+		     bool push, bool zombie, bool spam)
+{
+	u32 msglen = tal_count(msg);
+
+	hdr->len = cpu_to_be16(msglen);
+	hdr->flags = 0;
+	if (push)
+		hdr->flags |= CPU_TO_BE16(GOSSIP_STORE_PUSH_BIT);
+	if (spam)
+		hdr->flags |= CPU_TO_BE16(GOSSIP_STORE_RATELIMIT_BIT);
+	if (zombie)
+		hdr->flags |= CPU_TO_BE16(GOSSIP_STORE_ZOMBIE_BIT);
+	hdr->crc = cpu_to_be32(crc32c(timestamp, msg, msglen));
+	hdr->timestamp = cpu_to_be32(timestamp);
+}
+
 static bool append_msg(int fd, const u8 *msg, u32 timestamp,
 		       bool push, bool zombie, bool spam, u64 *len)
 {
@@ -83,16 +112,7 @@ static bool append_msg(int fd, const u8 *msg, u32 timestamp,
 	assert(*len);
 
 	msglen = tal_count(msg);
-	hdr.len = cpu_to_be16(msglen);
-	hdr.flags = 0;
-	if (push)
-		hdr.flags |= CPU_TO_BE16(GOSSIP_STORE_PUSH_BIT);
-	if (spam)
-		hdr.flags |= CPU_TO_BE16(GOSSIP_STORE_RATELIMIT_BIT);
-	if (zombie)
-		hdr.flags |= CPU_TO_BE16(GOSSIP_STORE_ZOMBIE_BIT);
-	hdr.crc = cpu_to_be32(crc32c(timestamp, msg, msglen));
-	hdr.timestamp = cpu_to_be32(timestamp);
+	fill_hdr(&hdr, msg, timestamp, push, zombie, spam);
 
 	/* pwritev makes it more likely to appear at once, plus it's
 	 * exactly what we want. */
@@ -106,6 +126,59 @@ static bool append_msg(int fd, const u8 *msg, u32 timestamp,
 	return true;
 }
 
+/* Write out everything in gs->pending. */
+static void gossip_store_flush(struct gossip_store *gs)
+{
+	size_t len = tal_count(gs->pending);
+
+	gs->flush_timer = tal_free(gs->flush_timer);
+	if (len == 0)
+		return;
+
+	if (pwrite(gs->fd, gs->pending, len, gs->len - len) != len)
+		status_failed(STATUS_FAIL_INTERNAL_ERROR,
+			      "Failed writing to gossip store: %s",
+			      strerror(errno));
+	tal_resize(&gs->pending, 0);
+}
+
+static void gossip_store_flush_timeout(struct gossip_store *gs)
+{
+	gs->flush_timer = NULL;
+	gossip_store_flush(gs);
+}
+
+/* Don't let a single iteration's worth grow without bound */
+#define GOSSIP_STORE_PENDING_MAX (1024 * 1024)
+
+static void pending_msg(struct gossip_store *gs, const u8 *msg,
+			u32 timestamp, bool push, bool zombie, bool spam)
+{
+	size_t off = tal_count(gs->pending);
+	size_t msglen = tal_count(msg);
+	struct gossip_hdr hdr;
+
+	fill_hdr(&hdr, msg, timestamp, push, zombie, spam);
+	tal_resize(&gs->pending, off + sizeof(hdr) + msglen);
+	memcpy(gs->pending + off, &hdr, sizeof(hdr));
+	memcpy(gs->pending + off + sizeof(hdr), msg, msglen);
+	gs->len += sizeof(hdr) + msglen;
+
+	if (tal_count(gs->pending) > GOSSIP_STORE_PENDING_MAX)
+		gossip_store_flush(gs);
+	else if (!gs->flush_timer)
+		gs->flush_timer = new_reltimer(gs->rstate->timers, gs,
+					       time_from_msec(0),
+					       gossip_store_flush_timeout, gs);
+}
+
+/* Make sure @offset is on disk before we read or modify it */
+static void flush_if_pending(struct gossip_store *gs, u64 offset)
+{
+	if (offset >= gs->len - tal_count(gs->pending))
+		gossip_store_flush(gs);
+}
+
 /* v9 added the GOSSIP_STORE_LEN_RATELIMIT_BIT.
  * v10 removed any remaining non-htlc-max channel_update.
  */
@@ -279,6 +352,9 @@ struct gossip_store *gossip_store_new(struct routing_state *rstate,
 			      strerror(errno));
 	gs->rstate = rstate;
 	gs->disable_compaction = false;
+	gs->compaction = NULL;
+	gs->pending = tal_arr(gs, u8, 0);
+	gs->flush_timer = NULL;
 	gs->len = sizeof(gs->version);
 	gs->peers = peers;
 
@@ -409,66 +485,105 @@ static void move_broadcast(struct offmap *offmap,
 	offmap_del(offmap, omap);
 }
 
-/**
- * Rewrite the on-disk gossip store, compacting it along the way
- *
- * Creates a new file, writes all the updates from the `broadcast_state`, and
- * then atomically swaps the files.
- */
-bool gossip_store_compact(struct gossip_store *gs)
-{
-	size_t count = 0, deleted = 0;
+/* Records to copy per timer callback when compacting in the background. */
+#define COMPACTION_CHUNK 1000
+
+/* An in-progress compaction.  We walk the old file copying live records
+ * into the new one; anything appended meanwhile is simply copied when we
+ * get to it, and flag changes to records already copied are mirrored. */
+struct compaction {
+	/* GOSSIP_STORE_TEMP_FILENAME */
 	int fd;
-	u64 off, len = sizeof(gs->version), idx;
+
+	/* Next offset to copy in the old file, and EOF of the new one */
+	u64 off, len;
+
+	/* Records copied, skipped (already deleted), and deleted after
+	 * being copied. */
+	size_t count, dropped, deleted;
+
+	/* Old offsets to new ones, so we can move broadcasts at the end */
 	struct offmap *offmap;
-	struct gossip_hdr hdr;
-	struct offmap_iter oit;
-	struct node_map_iter nit;
-	struct offset_map *omap;
 
-	if (gs->disable_compaction)
-		return false;
+	/* Non-NULL while we're proceeding in the background */
+	struct oneshot *timer;
+};
+
+static bool compaction_start(struct gossip_store *gs)
+{
+	struct compaction *c;
 
 	status_debug(
 	    "Compacting gossip_store with %zu entries, %zu of which are stale",
 	    gs->count, gs->deleted);
 
-	fd = open(GOSSIP_STORE_TEMP_FILENAME, O_RDWR|O_TRUNC|O_CREAT, 0600);
-
-	if (fd < 0) {
+	c = tal(gs, struct compaction);
+	c->fd = open(GOSSIP_STORE_TEMP_FILENAME, O_RDWR|O_TRUNC|O_CREAT, 0600);
+	if (c->fd < 0) {
 		status_broken(
 		    "Could not open file for gossip_store compaction");
 		goto disable;
 	}
 
-	if (write(fd, &gs->version, sizeof(gs->version))
+	if (write(c->fd, &gs->version, sizeof(gs->version))
 	    != sizeof(gs->version)) {
 		status_broken("Writing version to store: %s", strerror(errno));
-		goto unlink_disable;
+		close(c->fd);
+		unlink(GOSSIP_STORE_TEMP_FILENAME);
+		goto disable;
 	}
 
-	/* Walk old file, copy everything and remember new offsets. */
-	offmap = tal(tmpctx, struct offmap);
-	offmap_init_sized(offmap, gs->count);
+	c->off = c->len = sizeof(gs->version);
+	c->count = c->dropped = c->deleted = 0;
+	c->offmap = tal(c, struct offmap);
+	offmap_init_sized(c->offmap, gs->count - gs->deleted);
+	c->timer = NULL;
+	gs->compaction = c;
+	return true;
+
+disable:
+	status_debug("Encountered an error while compacting, disabling "
+		     "future compactions.");
+	gs->disable_compaction = true;
+	tal_free(c);
+	return false;
+}
 
-	/* Start by writing all channel announcements and updates. */
-	off = 1;
-	while (pread(gs->fd, &hdr, sizeof(hdr), off) == sizeof(hdr)) {
+static void compaction_abort(struct gossip_store *gs)
+{
+	close(gs->compaction->fd);
+	unlink(GOSSIP_STORE_TEMP_FILENAME);
+	gs->compaction = tal_free(gs->compaction);
+	status_debug("Encountered an error while compacting, disabling "
+		     "future compactions.");
+	gs->disable_compaction = true;
+}
+
+/* Copy up to @max records across; false on error. */
+static bool compaction_copy(struct gossip_store *gs, size_t max)
+{
+	struct compaction *c = gs->compaction;
+	struct gossip_hdr hdr;
+
+	gossip_store_flush(gs);
+	while (max-- && pread(gs->fd, &hdr, sizeof(hdr), c->off) == sizeof(hdr)) {
 		u16 msglen;
 		u32 wlen;
 		int msgtype;
+		struct offset_map *omap;
 
 		msglen = be16_to_cpu(hdr.len);
 		if (be16_to_cpu(hdr.flags) & GOSSIP_STORE_DELETED_BIT) {
-			off += sizeof(hdr) + msglen;
-			deleted++;
+			c->off += sizeof(hdr) + msglen;
+			c->dropped++;
 			continue;
 		}
 
-		count++;
-		wlen = transfer_store_msg(gs->fd, off, fd, len, &msgtype);
+		c->count++;
+		wlen = transfer_store_msg(gs->fd, c->off, c->fd, c->len,
+					  &msgtype);
 		if (wlen == 0)
-			goto unlink_disable;
+			return false;
 
 		/* We track location of all these message types. */
 		if (msgtype == WIRE_GOSSIP_STORE_PRIVATE_CHANNEL
@@ -476,50 +591,63 @@ bool gossip_store_compact(struct gossip_store *gs)
 		    || msgtype == WIRE_CHANNEL_ANNOUNCEMENT
 		    || msgtype == WIRE_CHANNEL_UPDATE
 		    || msgtype == WIRE_NODE_ANNOUNCEMENT) {
-			omap = tal(offmap, struct offset_map);
-			omap->from = off;
-			omap->to = len;
-			offmap_add(offmap, omap);
+			omap = tal(c->offmap, struct offset_map);
+			omap->from = c->off;
+			omap->to = c->len;
+			offmap_add(c->offmap, omap);
 		}
-		len += wlen;
-		off += wlen;
+		c->len += wlen;
+		c->off += wlen;
 	}
+	return true;
+}
+
+/* Everything is copied: move broadcasts across and swap files. */
+static void compaction_finish(struct gossip_store *gs)
+{
+	struct compaction *c = gs->compaction;
+	struct offmap_iter oit;
+	struct node_map_iter nit;
+	struct offset_map *omap;
+	u64 idx;
+
+	assert(c->off == gs->len);
+	assert(tal_count(gs->pending) == 0);
 
-	/* OK, now we've written file successfully, we can move broadcasts. */
 	/* Remap node announcements. */
 	for (struct node *n = node_map_first(gs->rstate->nodes, &nit);
 	     n;
 	     n = node_map_next(gs->rstate->nodes, &nit)) {
-		move_broadcast(offmap, &n->bcast, "node_announce");
+		move_broadcast(c->offmap, &n->bcast, "node_announce");
 	}
 
 	/* Remap channel announcements and updates */
-	for (struct chan *c = uintmap_first(&gs->rstate->chanmap, &idx);
-	     c;
-	     c = uintmap_after(&gs->rstate->chanmap, &idx)) {
-		move_broadcast(offmap, &c->bcast, "channel_announce");
-		move_broadcast(offmap, &c->half[0].bcast, "channel_update");
-		move_broadcast(offmap, &c->half[1].bcast, "channel_update");
+	for (struct chan *ch = uintmap_first(&gs->rstate->chanmap, &idx);
+	     ch;
+	     ch = uintmap_after(&gs->rstate->chanmap, &idx)) {
+		move_broadcast(c->offmap, &ch->bcast, "channel_announce");
+		move_broadcast(c->offmap, &ch->half[0].bcast, "channel_update");
+		move_broadcast(c->offmap, &ch->half[1].bcast, "channel_update");
 	}
 
 	/* That should be everything. */
-	omap = offmap_first(offmap, &oit);
+	omap = offmap_first(c->offmap, &oit);
 	if (omap)
 		status_failed(STATUS_FAIL_INTERNAL_ERROR,
 			      "gossip_store: Entry at %zu->%zu not updated?",
 			      omap->from, omap->to);
 
-	if (count != gs->count - gs->deleted)
+	if (c->count - c->deleted != gs->count - gs->deleted)
 		status_failed(STATUS_FAIL_INTERNAL_ERROR,
 			      "gossip_store: Expected %zu msgs in new"
 			      " gossip store, got %zu",
-			      gs->count - gs->deleted, count);
+			      gs->count - gs->deleted, c->count - c->deleted);
 
-	if (deleted != gs->deleted)
+	if (c->dropped + c->deleted != gs->deleted)
 		status_failed(STATUS_FAIL_INTERNAL_ERROR,
 			      "gossip_store: Expected %zu deleted msgs in old"
 			      " gossip store, got %zu",
-			      gs->deleted, deleted);
+			      gs->deleted, c->dropped + c->deleted);
 
 	if (rename(GOSSIP_STORE_TEMP_FILENAME, GOSSIP_STORE_FILENAME) == -1)
 		status_failed(STATUS_FAIL_INTERNAL_ERROR,
@@ -529,27 +657,104 @@ bool gossip_store_compact(struct gossip_store *gs)
 
 	status_debug(
 	    "Compaction completed: dropped %zu messages, new count %zu, len %"PRIu64,
-	    deleted, count, len);
+	    c->dropped, c->count, c->len);
 
 	/* Write end marker now new one is ready */
-	append_msg(gs->fd, towire_gossip_store_ended(tmpctx, len),
+	append_msg(gs->fd, towire_gossip_store_ended(tmpctx, c->len),
 		   0, true, false, false, &gs->len);
 
-	gs->count = count;
-	gs->deleted = 0;
-	gs->len = len;
+	gs->count = c->count;
+	gs->deleted = c->deleted;
+	gs->len = c->len;
 	close(gs->fd);
-	gs->fd = fd;
+	gs->fd = c->fd;
+	gs->compaction = tal_free(c);
+}
 
-	return true;
+static void compaction_step(struct gossip_store *gs)
+{
+	struct compaction *c = gs->compaction;
 
-unlink_disable:
-	unlink(GOSSIP_STORE_TEMP_FILENAME);
-disable:
-	status_debug("Encountered an error while compacting, disabling "
-		     "future compactions.");
-	gs->disable_compaction = true;
-	return false;
+	c->timer = NULL;
+	if (!compaction_copy(gs, COMPACTION_CHUNK)) {
+		compaction_abort(gs);
+		return;
+	}
+
+	/* Anything appended while we were copying gets picked up here, so
+	 * once we catch up we can swap immediately. */
+	if (c->off < gs->len) {
+		c->timer = new_reltimer(gs->rstate->timers, c,
+					time_from_msec(0),
+					compaction_step, gs);
+		return;
+	}
+	compaction_finish(gs);
+}
+
+/* Start compacting in the background once half the store is stale. */
+static void gossip_store_maybe_compact(struct gossip_store *gs)
+{
+	if (gs->compaction || gs->disable_compaction)
+		return;
+
+	/* Don't bother with small stores: restart will clean them up. */
+	if (gs->count < 1000 || gs->deleted < gs->count / 2)
+		return;
+
+	if (!compaction_start(gs))
+		return;
+	gs->compaction->timer = new_reltimer(gs->rstate->timers,
+					     gs->compaction,
+					     time_from_msec(0),
+					     compaction_step, gs);
+}
+
+/* If compaction has already copied the record at @index, return where it
+ * is in the new file (forgetting it if @forget), otherwise 0. */
+static u64 compacted_index(struct gossip_store *gs, u64 index, bool forget)
+{
+	struct offset_map *omap;
+	u64 to;
+
+	if (!gs->compaction || index >= gs->compaction->off)
+		return 0;
+
+	omap = offmap_get(gs->compaction->offmap, index);
+	if (!omap)
+		status_failed(STATUS_FAIL_INTERNAL_ERROR,
+			      "gossip_store: compacted entry at %"PRIu64
+			      " not tracked?", index);
+	to = omap->to;
+	if (forget) {
+		offmap_del(gs->compaction->offmap, omap);
+		tal_free(omap);
+	}
+	return to;
+}
+
+/**
+ * Rewrite the on-disk gossip store, compacting it along the way
+ *
+ * Creates a new file, writes all the updates from the `broadcast_state`, and
+ * then atomically swaps the files.  If a background compaction is already
+ * running, this simply finishes it now.
+ */
+bool gossip_store_compact(struct gossip_store *gs)
+{
+	if (gs->disable_compaction)
+		return false;
+
+	if (!gs->compaction && !compaction_start(gs))
+		return false;
+
+	gs->compaction->timer = tal_free(gs->compaction->timer);
+	if (!compaction_copy(gs, SIZE_MAX)) {
+		compaction_abort(gs);
+		return false;
+	}
+	compaction_finish(gs);
+	return true;
 }
 
 u64 gossip_store_add(struct gossip_store *gs, const u8 *gossip_msg,
@@ -561,16 +766,9 @@ u64 gossip_store_add(struct gossip_store *gs, const u8 *gossip_msg,
 	/* Should never get here during loading! */
 	assert(gs->writable);
 
-	if (!append_msg(gs->fd, gossip_msg, timestamp, push, zombie, spam, &gs->len)) {
-		status_broken("Failed writing to gossip store: %s",
-			      strerror(errno));
-		return 0;
-	}
-	if (addendum && !append_msg(gs->fd, addendum, 0, false, false, false, &gs->len)) {
-		status_broken("Failed writing addendum to gossip store: %s",
-			      strerror(errno));
-		return 0;
-	}
+	pending_msg(gs, gossip_msg, timestamp, push, zombie, spam);
+	if (addendum)
+		pending_msg(gs, addendum, 0, false, false, false);
 
 	gs->count++;
 	if (addendum)
@@ -586,8 +784,10 @@ u64 gossip_store_add_private_update(struct gossip_store *gs, const u8 *update)
 	return gossip_store_add(gs, pupdate, 0, false, false, false, NULL);
 }
 
-/* Returns index of following entry. */
-static u32 delete_by_index(struct gossip_store *gs, u32 index, int type)
+/* Returns index of following entry.  If @new_index is non-zero, this
+ * record was already copied by compaction, so delete it there too. */
+static u32 delete_by_index(struct gossip_store *gs, u32 index, u64 new_index,
+			   int type)
 {
 	struct {
 		beint16_t beflags;
@@ -600,6 +800,8 @@ static u32 delete_by_index(struct gossip_store *gs, u32 index, int type)
 	/* Should never try to overwrite version */
 	assert(index);
 
+	flush_if_pending(gs, index);
+
 #if DEVELOPER
 	const u8 *msg = gossip_store_get(tmpctx, gs, index);
 	assert(fromwire_peektype(msg) == type);
@@ -618,6 +820,17 @@ static u32 delete_by_index(struct gossip_store *gs, u32 index, int type)
 			      index, strerror(errno));
 	gs->deleted++;
 
+	if (new_index) {
+		if (pwrite(gs->compaction->fd, &hdr.beflags,
+			   sizeof(hdr.beflags), new_index)
+		    != sizeof(hdr.beflags))
+			status_failed(STATUS_FAIL_INTERNAL_ERROR,
+				      "Failed writing flags to delete"
+				      " compacted @%"PRIu64": %s",
+				      new_index, strerror(errno));
+		gs->compaction->deleted++;
+	}
+
 	return index + sizeof(struct gossip_hdr) + be16_to_cpu(hdr.belen);
 }
 
@@ -625,20 +838,31 @@ void gossip_store_delete(struct gossip_store *gs,
 			 struct broadcastable *bcast,
 			 int type)
 {
-	u32 next_index;
+	u32 index, next_index;
+	u64 new_index;
 
 	if (!bcast->index)
 		return;
 
-	next_index = delete_by_index(gs, bcast->index, type);
+	index = bcast->index;
+	new_index = compacted_index(gs, index, true);
+	next_index = delete_by_index(gs, index, new_index, type);
 
 	/* Reset index. */
 	bcast->index = 0;
 
 	/* For a channel_announcement, we need to delete amount too */
-	if (type == WIRE_CHANNEL_ANNOUNCEMENT)
-		delete_by_index(gs, next_index,
+	if (type == WIRE_CHANNEL_ANNOUNCEMENT) {
+		/* Amount isn't tracked, but it's adjacent in both files */
+		if (new_index && next_index < gs->compaction->off)
+			new_index += next_index - index;
+		else
+			new_index = 0;
+		delete_by_index(gs, next_index, new_index,
 				WIRE_GOSSIP_STORE_CHANNEL_AMOUNT);
+	}
+
+	gossip_store_maybe_compact(gs);
 }
 
 void gossip_store_mark_channel_deleted(struct gossip_store *gs,
@@ -654,6 +878,7 @@ static void mark_zombie(struct gossip_store *gs,
 {
 	beint16_t beflags;
 	u32 index = bcast->index;
+	u64 new_index;
 
 	/* We assume flags is the first field! */
 	BUILD_ASSERT(offsetof(struct gossip_hdr, flags) == 0);
@@ -662,6 +887,8 @@ static void mark_zombie(struct gossip_store *gs,
 	assert(gs->writable);
 	assert(index);
 
+	flush_if_pending(gs, index);
+
 #if DEVELOPER
 	const u8 *msg = gossip_store_get(tmpctx, gs, index);
 	assert(fromwire_peektype(msg) == expected_type);
@@ -680,6 +907,16 @@ static void mark_zombie(struct gossip_store *gs,
 			      "Failed writing flags to zombie %s @%u: %s",
 			      peer_wire_name(expected_type),
 			      index, strerror(errno));
+
+	new_index = compacted_index(gs, index, false);
+	if (new_index
+	    && pwrite(gs->compaction->fd, &beflags, sizeof(beflags), new_index)
+	    != sizeof(beflags))
+		status_failed(STATUS_FAIL_INTERNAL_ERROR,
+			      "Failed writing flags to zombie compacted %s"
+			      " @%"PRIu64": %s",
+			      peer_wire_name(expected_type),
+			      new_index, strerror(errno));
 }
 
 /* Marks the length field of a channel_announcement with the zombie flag bit */
@@ -708,6 +945,7 @@ const u8 *gossip_store_get(const tal_t *ctx,
 		status_failed(STATUS_FAIL_INTERNAL_ERROR,
 			      "gossip_store: can't access offset %"PRIu64,
 			      offset);
+	flush_if_pending(gs, offset);
 	if (pread(gs->fd, &hdr, sizeof(hdr), offset) != sizeof(hdr)) {
 		status_failed(STATUS_FAIL_INTERNAL_ERROR,
 			      "gossip_store: can't read hdr offset %"PRIu64
@@ -753,7 +991,10 @@ const u8 *gossip_store_get_private_update(const tal_t *ctx,
 
 int gossip_store_readonly_fd(struct gossip_store *gs)
 {
-	int fd = open(GOSSIP_STORE_FILENAME, O_RDONLY);
+	int fd;
+
+	gossip_store_flush(gs);
+	fd = open(GOSSIP_STORE_FILENAME, O_RDONLY);
 
 	/* Skip over version header */
 	if (fd != -1 && lseek(fd, 1, SEEK_SET) != 1) {
@@ -208,6 +208,16 @@ static bool get_node_announcement_by_id(const tal_t *ctx,
  * It's not the subdaemon's fault if they're malformed or invalid; so these
  * all return an error packet which gets sent back to the subdaemon in that
  * case.
+ *
+ * You might wonder why we don't farm signature checks out to threads.
+ * tal, tmpctx and io_loop all assume a single thread, so the only threads
+ * we have (in lightningd's sqlite3 and log code) are dumb workers which
+ * never allocate or touch shared state.  Checking a signature here isn't
+ * like that: deciding what to check, and acting on the result, means
+ * routing_state, the gossip_store and tmpctx allocations all along the way.
+ * Our answer to "too much on one core" is another subdaemon, not locks.
+ * Instead we try hard not to verify what we'd discard anyway: known
+ * announcements, and channel_updates older than the ones we have.
  */
 
 /* The routing code checks that it's basically valid, returning an
@@ -748,7 +758,9 @@ static void gossip_init(struct daemon *daemon, const u8 *msg)
 				     &dev_gossip_time,
 				     &dev_fast_gossip,
 				     &dev_fast_gossip_prune,
-				     &daemon->ip_discovery)) {
+				     &daemon->ip_discovery,
+				     &daemon->channel_update_rate,
+				     &daemon->fast_sync_peers)) {
 		master_badmsg(WIRE_GOSSIPD_INIT, msg);
 	}
 
@@ -835,6 +847,8 @@ static void dev_gossip_memleak(struct daemon *daemon, const u8 *msg)
 	memleak_scan_obj(memtable, daemon);
 
 	found_leak = dump_memleak(memtable, memleak_status_broken);
+	/* While we're here, show where our memory is going. */
+	dump_memstats(NULL, 10, memleak_status_debug);
 	daemon_conn_send(daemon->master,
 			 take(towire_gossipd_dev_memleak_reply(NULL,
 							      found_leak)));
@@ -1119,6 +1133,9 @@ int main(int argc, char *argv[])
 	daemon->discovered_ip_v6 = NULL;
 	daemon->ip_discovery = OPT_AUTOBOOL_AUTO;
 	list_head_init(&daemon->deferred_updates);
+	daemon->channel_update_rate = 0;
+	daemon->update_slot_time = daemon->update_slot_count = 0;
+	daemon->fast_sync_peers = 0;
 
 	/* Tell the ecdh() function how to talk to hsmd */
 	ecdh_hsmd_setup(HSM_FD, status_failed);
@@ -75,6 +75,14 @@ struct daemon {
 
 	/* Any of our channel_updates we're deferring. */
 	struct list_head deferred_updates;
+
+	/* Max local channel_updates to release per second (0 = no limit),
+	 * and the second (and count within it) of the last one released. */
+	u32 channel_update_rate;
+	u32 update_slot_time, update_slot_count;
+
+	/* With an empty gossip_store, query this many peers at once (or 0) */
+	u32 fast_sync_peers;
 };
 
 struct range_query_reply {
@@ -348,6 +348,8 @@ static u32 crc32_of_update(const u8 *channel_update)
 	return sum;
 }
 
+/* csum may be NULL: reading the update back from the store is the expensive
+ * part, and most peers only ask for timestamps. */
 static void get_checksum_and_timestamp(struct routing_state *rstate,
 				       const struct chan *chan,
 				       int direction,
@@ -356,12 +358,16 @@ static void get_checksum_and_timestamp(struct routing_state *rstate,
 	const struct half_chan *hc = &chan->half[direction];
 
 	if (!is_chan_public(chan) || !is_halfchan_defined(hc)) {
-		*tstamp = *csum = 0;
+		*tstamp = 0;
+		if (csum)
+			*csum = 0;
 	} else {
-		const u8 *update = gossip_store_get(tmpctx, rstate->gs,
-						    hc->bcast.index);
 		*tstamp = hc->bcast.timestamp;
-		*csum = crc32_of_update(update);
+		if (csum) {
+			const u8 *update = gossip_store_get(tmpctx, rstate->gs,
+							    hc->bcast.index);
+			*csum = crc32_of_update(update);
+		}
 	}
 }
 
@@ -486,10 +492,12 @@ static struct short_channel_id *gather_range(const tal_t *ctx,
 
 		get_checksum_and_timestamp(rstate, chan, 0,
 					   &ts.timestamp_node_id_1,
-					   &cs.checksum_node_id_1);
+					   query_option_flags & QUERY_ADD_CHECKSUMS
+					   ? &cs.checksum_node_id_1 : NULL);
 		get_checksum_and_timestamp(rstate, chan, 1,
 					   &ts.timestamp_node_id_2,
-					   &cs.checksum_node_id_2);
+					   query_option_flags & QUERY_ADD_CHECKSUMS
+					   ? &cs.checksum_node_id_2 : NULL);
 		if (query_option_flags & QUERY_ADD_TIMESTAMPS)
 			tal_arr_expand(tstamps, ts);
 		if (query_option_flags & QUERY_ADD_CHECKSUMS)
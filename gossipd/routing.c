@@ -44,6 +44,14 @@ struct dying_channel {
 	struct broadcastable marker;
 };
 
+/* An entry in rstate->prune_heap.  timestamp is never later than the
+ * oldest channel_update of the channel (it's only checked, and fixed up,
+ * once it's old enough to matter), and the channel may be gone by then. */
+struct prune_entry {
+	u32 timestamp;
+	struct short_channel_id scid;
+};
+
 /* We consider a reasonable gossip rate to be 2 per day, with burst of
  * 4 per day.  So we use a granularity of one hour. */
 #define TOKENS_PER_MSG 12
@@ -295,6 +303,7 @@ struct routing_state *new_routing_state(const tal_t *ctx,
 	rstate->local_channel_announced = false;
 	rstate->last_timestamp = 0;
 	rstate->dying_channels = tal_arr(rstate, struct dying_channel, 0);
+	rstate->prune_heap = tal_arr(rstate, struct prune_entry, 0);
 
 	rstate->pending_cannouncements = tal(rstate, struct pending_cannouncement_map);
 	pending_cannouncement_map_init(rstate->pending_cannouncements);
@@ -835,6 +844,56 @@ static void destroy_pending_cannouncement(struct pending_cannouncement *pending,
 	pending_cannouncement_map_del(rstate->pending_cannouncements, pending);
 }
 
+/* Timestamps of channel_updates only go forward, so this only ever
+ * increases (except for going zombie, when it's no longer in the heap). */
+static u32 chan_prune_timestamp(const struct chan *chan)
+{
+	if (!is_halfchan_defined(&chan->half[0])
+	    || !is_halfchan_defined(&chan->half[1]))
+		return 0;
+	return min_unsigned(chan->half[0].bcast.timestamp,
+			    chan->half[1].bcast.timestamp);
+}
+
+static void prune_heap_add(struct routing_state *rstate,
+			   const struct chan *chan)
+{
+	struct prune_entry *heap;
+	size_t i;
+
+	tal_resize(&rstate->prune_heap, tal_count(rstate->prune_heap) + 1);
+	heap = rstate->prune_heap;
+	i = tal_count(heap) - 1;
+	while (i > 0 && heap[(i - 1) / 2].timestamp > chan_prune_timestamp(chan)) {
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i].timestamp = chan_prune_timestamp(chan);
+	heap[i].scid = chan->scid;
+}
+
+static void prune_heap_pop(struct routing_state *rstate)
+{
+	struct prune_entry *heap = rstate->prune_heap;
+	size_t n = tal_count(heap) - 1, i = 0;
+	struct prune_entry last = heap[n];
+
+	for (;;) {
+		size_t child = i * 2 + 1;
+		if (child >= n)
+			break;
+		if (child + 1 < n
+		    && heap[child + 1].timestamp < heap[child].timestamp)
+			child++;
+		if (heap[child].timestamp >= last.timestamp)
+			break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = last;
+	tal_resize(&rstate->prune_heap, n);
+}
+
 static void add_channel_announce_to_broadcast(struct routing_state *rstate,
 					      struct chan *chan,
 					      const u8 *channel_announce,
@@ -857,6 +916,7 @@ static void add_channel_announce_to_broadcast(struct routing_state *rstate,
 						     false,
 						     addendum);
 	rstate->local_channel_announced |= is_local;
+	prune_heap_add(rstate, chan);
 }
 
 static void delete_chan_messages_from_store(struct routing_state *rstate,
@@ -1567,6 +1627,8 @@ bool routing_add_channel_update(struct routing_state *rstate,
 		chan->half[0].zombie = false;
 		chan->half[1].zombie = false;
 		zombie = false;
+		/* It was dropped from the heap when it was zombified */
+		prune_heap_add(rstate, chan);
 	}
 
 	/* If we're loading from store, this means we don't re-add to store. */
@@ -1721,6 +1783,20 @@ u8 *handle_channel_update(struct routing_state *rstate, const u8 *update TAKES,
 		return NULL;
 	}
 
+	/* Signature checking dominates initial sync, and most of what we
+	 * get there are updates we already have from another peer.
+	 * routing_add_channel_update() would ignore those, so do it before
+	 * we bother verifying them. */
+	if (!force) {
+		const struct chan *chan = get_channel(rstate, &short_channel_id);
+		if (chan
+		    && is_halfchan_defined(&chan->half[direction])
+		    && timestamp <= chan->half[direction].rgraph.timestamp) {
+			SUPERVERBOSE("Ignoring outdated update.");
+			return NULL;
+		}
+	}
+
 	warn = check_channel_update(rstate, owner, &signature, serialized);
 	if (warn) {
 		/* BOLT #7:
@@ -2052,15 +2128,15 @@ void route_prune(struct routing_state *rstate)
 	struct chan **pruned = tal_arr(tmpctx, struct chan *, 0);
 	u64 idx;
 
-	/* Now iterate through all channels and see if it is still alive */
-	for (struct chan *chan = uintmap_first(&rstate->chanmap, &idx);
-	     chan;
-	     chan = uintmap_after(&rstate->chanmap, &idx)) {
-		/* Local-only?  Don't prune. */
-		if (!is_chan_public(chan))
-			continue;
-		/* These have been pruned already */
-		if (is_chan_zombie(chan))
+	/* Only channels whose entry is old enough could need pruning. */
+	while (tal_count(rstate->prune_heap)
+	       && rstate->prune_heap[0].timestamp < highwater) {
+		struct chan *chan = get_channel(rstate,
+						&rstate->prune_heap[0].scid);
+		prune_heap_pop(rstate);
+
+		/* Closed, or pruned already (resurrection re-adds it) */
+		if (!chan || is_chan_zombie(chan))
 			continue;
 
 		/* BOLT #7:
@@ -2069,10 +2145,10 @@ void route_prune(struct routing_state *rstate)
 		 *    - MAY prune the channel.
 		 */
 		/* This is a fancy way of saying "both ends must refresh!" */
-		if (!is_halfchan_defined(&chan->half[0])
-		    || chan->half[0].bcast.timestamp < highwater
-		    || !is_halfchan_defined(&chan->half[1])
-		    || chan->half[1].bcast.timestamp < highwater) {
+		if (chan_prune_timestamp(chan) >= highwater) {
+			/* Updated since, so put it back where it belongs. */
+			prune_heap_add(rstate, chan);
+		} else {
 			status_debug(
 			    "Pruning channel %s from network view (ages %"PRIu64" and %"PRIu64"s)",
 			    type_to_string(tmpctx, struct short_channel_id,
@@ -2236,6 +2312,8 @@ void remove_all_gossip(struct routing_state *rstate)
 		tal_free(c);
 	}
 
+	tal_resize(&rstate->prune_heap, 0);
+
 	while ((uc = uintmap_first(&rstate->unupdated_chanmap, &index)) != NULL)
 		tal_free(uc);
 
@@ -2265,21 +2343,29 @@ static void channel_spent(struct routing_state *rstate,
 void routing_expire_channels(struct routing_state *rstate, u32 blockheight)
 {
 	struct chan *chan;
+	size_t n;
 
-	for (size_t i = 0; i < tal_count(rstate->dying_channels); i++) {
-		struct dying_channel *d = rstate->dying_channels + i;
+	/* They're in deadline order, so we stop at the first live one */
+	for (n = 0; n < tal_count(rstate->dying_channels); n++) {
+		struct dying_channel *d = rstate->dying_channels + n;
 
 		if (blockheight < d->deadline_blockheight)
-			continue;
+			break;
 		chan = get_channel(rstate, &d->scid);
 		if (chan)
 			channel_spent(rstate, chan);
 		/* Delete dying marker itself */
 		gossip_store_delete(rstate->gs,
 				    &d->marker, WIRE_GOSSIP_STORE_CHAN_DYING);
-		tal_arr_remove(&rstate->dying_channels, i);
-		i--;
 	}
+
+	if (n == 0)
+		return;
+	memmove(rstate->dying_channels, rstate->dying_channels + n,
+		(tal_count(rstate->dying_channels) - n)
+		* sizeof(*rstate->dying_channels));
+	tal_resize(&rstate->dying_channels,
+		   tal_count(rstate->dying_channels) - n);
 }
 
 void remember_chan_dying(struct routing_state *rstate,
@@ -2287,11 +2373,21 @@ void remember_chan_dying(struct routing_state *rstate,
 			 u32 deadline_blockheight,
 			 u64 index)
 {
-	struct dying_channel d;
+	struct dying_channel d, *dying;
+	size_t i;
+
 	d.scid = *scid;
 	d.deadline_blockheight = deadline_blockheight;
 	d.marker.index = index;
+
+	/* Deadlines are almost always the latest, so insert from the end */
 	tal_arr_expand(&rstate->dying_channels, d);
+	dying = rstate->dying_channels;
+	for (i = tal_count(dying) - 1;
+	     i > 0 && dying[i-1].deadline_blockheight > deadline_blockheight;
+	     i--)
+		dying[i] = dying[i-1];
+	dying[i] = d;
 }
 
 void routing_channel_spent(struct routing_state *rstate,
@@ -34,6 +34,10 @@ struct half_chan {
 	bool zombie;
 };
 
+/* These are individually tal-allocated and never move: deferred updates
+ * hang off them, and local_chan, nodes and pending queries point at them.
+ * So packing them into dense arrays would mean handles everywhere; keep
+ * them small instead (80 bytes on 64-bit). */
 struct chan {
 	struct short_channel_id scid;
 
@@ -233,9 +237,14 @@ struct routing_state {
 	/* Highest timestamp of gossip we accepted (before now) */
 	u32 last_timestamp;
 
-	/* Channels which are closed, but we're waiting 12 blocks */
+	/* Channels which are closed, but we're waiting 12 blocks: ordered
+	 * by deadline. */
 	struct dying_channel *dying_channels;
 
+	/* Min-heap of public channels by when they could next need pruning,
+	 * so route_prune() doesn't have to look at them all. */
+	struct prune_entry *prune_heap;
+
 #if DEVELOPER
 	/* Override local time for gossip messages */
 	struct timeabs *gossip_time;
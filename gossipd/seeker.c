@@ -35,6 +35,21 @@ enum seeker_state {
 
 	/* Asking a peer for stale scids. */
 	ASKING_FOR_STALE_SCIDS,
+
+	/* Empty gossip_store: asking several peers at once. */
+	FAST_SYNCING,
+};
+
+/* Most peers we'll fast sync from at once. */
+#define MAX_FAST_SYNC_PEERS 8
+
+/* In fast sync, each peer is asked for the scids in its own range of
+ * blocks. */
+struct fast_sync_shard {
+	u32 first_blocknum, number_of_blocks;
+	bool done;
+	/* Who we asked (NULL if they went away, or we haven't yet). */
+	struct peer *peer_softref;
 };
 
 /* Gossip we're seeking at the moment. */
@@ -76,11 +91,21 @@ struct seeker {
 	/* A peer that told us about unknown gossip. */
 	struct peer *preferred_peer_softref;
 
+	/* Did we start with (almost) no gossip? */
+	bool store_empty;
+
+	/* Block ranges we're fast syncing. */
+	struct fast_sync_shard fast_sync[MAX_FAST_SYNC_PEERS];
+	size_t num_fast_sync;
+
+	/* Count of fast sync replies, to check we're making progress. */
+	size_t fast_sync_replies, prev_fast_sync_replies;
 };
 
 /* Mutual recursion */
 static void seeker_check(struct seeker *seeker);
 static void probe_some_random_scids(struct seeker *seeker);
+static void peer_gossip_probe_scids(struct seeker *seeker);
 
 static void begin_check_timer(struct seeker *seeker)
 {
@@ -128,6 +153,24 @@ static void set_state_(struct seeker *seeker, enum seeker_state state,
 	selected_peer(seeker, peer);
 }
 
+/* We don't count our own, or reloaded, channels: below this we might as
+ * well have nothing. */
+#define FAST_SYNC_MAX_CHANNELS 100
+
+static bool gossip_store_empty(struct routing_state *rstate)
+{
+	size_t num_public = 0;
+	u64 idx;
+
+	for (struct chan *c = uintmap_first(&rstate->chanmap, &idx);
+	     c;
+	     c = uintmap_after(&rstate->chanmap, &idx)) {
+		if (is_chan_public(c) && ++num_public >= FAST_SYNC_MAX_CHANNELS)
+			return false;
+	}
+	return true;
+}
+
 struct seeker *new_seeker(struct daemon *daemon)
 {
 	struct seeker *seeker = tal(daemon, struct seeker);
@@ -140,6 +183,11 @@ struct seeker *new_seeker(struct daemon *daemon)
 		seeker->gossiper_softref[i] = NULL;
 	seeker->preferred_peer_softref = NULL;
 	seeker->unknown_nodes = false;
+	seeker->store_empty = gossip_store_empty(daemon->rstate);
+	for (size_t i = 0; i < ARRAY_SIZE(seeker->fast_sync); i++)
+		seeker->fast_sync[i].peer_softref = NULL;
+	seeker->num_fast_sync = 0;
+	seeker->fast_sync_replies = seeker->prev_fast_sync_replies = 0;
 	set_state(seeker, STARTING_UP, NULL, "New seeker");
 	begin_check_timer(seeker);
 	return seeker;
@@ -739,12 +787,227 @@ static void probe_many_random_scids(struct seeker *seeker)
 	return probe_random_scids(seeker, 10000);
 }
 
+/* After the startup peer (or fast sync) is done, we let everyone gossip
+ * normally and check with a random peer that we have all channels. */
+static void startup_finished(struct seeker *seeker, struct peer *except)
+{
+	struct peer *p;
+
+	list_for_each(&seeker->daemon->peers, p, list) {
+		if (p == except)
+			continue;
+
+		normal_gossip_start(seeker, p);
+	}
+
+	/* Ask a random peer for all channels, in case we're missing */
+	seeker->scid_probe_start = chainparams->when_lightning_became_cool;
+	seeker->scid_probe_end = seeker->daemon->current_blockheight;
+	if (seeker->scid_probe_start > seeker->scid_probe_end)
+		seeker->scid_probe_start = 0;
+	peer_gossip_probe_scids(seeker);
+}
+
+static bool want_fast_sync(const struct seeker *seeker)
+{
+	return seeker->store_empty && seeker->daemon->fast_sync_peers > 1;
+}
+
+/* Not busy with a shard or scid query of its own */
+static bool peer_can_fast_sync(const struct peer *peer)
+{
+	const struct seeker *seeker = peer->daemon->seeker;
+
+	if (!peer_can_take_range_query(peer)
+	    || !peer_can_take_scid_query(peer))
+		return false;
+
+	for (size_t i = 0; i < seeker->num_fast_sync; i++) {
+		if (seeker->fast_sync[i].peer_softref == peer)
+			return false;
+	}
+	return true;
+}
+
+static void fast_sync_done(struct seeker *seeker)
+{
+	for (size_t i = 0; i < seeker->num_fast_sync; i++)
+		clear_softref(seeker, &seeker->fast_sync[i].peer_softref);
+	seeker->num_fast_sync = 0;
+	startup_finished(seeker, NULL);
+}
+
+static void fast_sync_scids_done(struct peer *peer, bool complete);
+
+/* Give each idle peer a batch of the scids we've learned about. */
+static void fast_sync_ask_scids(struct seeker *seeker)
+{
+	struct peer *peer;
+
+	while (!uintmap_empty(&seeker->unknown_scids)
+	       && (peer = random_peer(seeker->daemon, peer_can_fast_sync))) {
+		struct short_channel_id *scids;
+
+		scids = unknown_scids_remove(tmpctx, seeker);
+		status_peer_debug(&peer->id,
+				  "seeker: fast sync asking for %zu scids",
+				  tal_count(scids));
+		if (!query_short_channel_ids(seeker->daemon, peer, scids, NULL,
+					     fast_sync_scids_done))
+			status_failed(STATUS_FAIL_INTERNAL_ERROR,
+				      "seeker: quering %zu scids is too many?",
+				      tal_count(scids));
+	}
+
+	/* Finished when every range is in, and every scid query answered. */
+	if (!uintmap_empty(&seeker->unknown_scids))
+		return;
+	for (size_t i = 0; i < seeker->num_fast_sync; i++) {
+		if (!seeker->fast_sync[i].done)
+			return;
+	}
+	list_for_each(&seeker->daemon->peers, peer, list) {
+		if (peer->scid_query_outstanding)
+			return;
+	}
+
+	status_debug("seeker: fast sync complete");
+	fast_sync_done(seeker);
+}
+
+static void fast_sync_scids_done(struct peer *peer, bool complete)
+{
+	struct seeker *seeker = peer->daemon->seeker;
+
+	seeker->fast_sync_replies++;
+	/* We might have given up on fast sync. */
+	if (seeker->state != FAST_SYNCING)
+		return;
+	fast_sync_ask_scids(seeker);
+}
+
+static void fast_sync_range_done(struct peer *peer,
+				 u32 first_blocknum, u32 number_of_blocks,
+				 const struct range_query_reply *replies)
+{
+	struct seeker *seeker = peer->daemon->seeker;
+
+	/* This is where shards get merged: the map ignores duplicates. */
+	for (size_t i = 0; i < tal_count(replies); i++) {
+		if (!get_channel(seeker->daemon->rstate, &replies[i].scid))
+			add_unknown_scid(seeker, &replies[i].scid, peer);
+	}
+
+	seeker->fast_sync_replies++;
+	if (seeker->state != FAST_SYNCING)
+		return;
+
+	for (size_t i = 0; i < seeker->num_fast_sync; i++) {
+		struct fast_sync_shard *shard = &seeker->fast_sync[i];
+		if (shard->peer_softref != peer)
+			continue;
+		shard->done = true;
+		clear_softref(seeker, &shard->peer_softref);
+	}
+	fast_sync_ask_scids(seeker);
+}
+
+static void fast_sync_ask_range(struct seeker *seeker,
+				struct fast_sync_shard *shard,
+				struct peer *peer)
+{
+	status_peer_debug(&peer->id,
+			  "seeker: fast sync asking for blocks %u-%u",
+			  shard->first_blocknum,
+			  shard->first_blocknum + shard->number_of_blocks - 1);
+	set_softref(seeker, &shard->peer_softref, peer);
+	query_channel_range(seeker->daemon, peer,
+			    shard->first_blocknum, shard->number_of_blocks,
+			    0, fast_sync_range_done);
+}
+
+/* Split the blocks between as many peers as we can (and want): returns
+ * false if there aren't enough peers to bother. */
+static bool start_fast_sync(struct seeker *seeker)
+{
+	u32 first = chainparams->when_lightning_became_cool;
+	u32 end = seeker->daemon->current_blockheight + 1;
+	size_t num_peers = 0, max_peers;
+	struct peer *p;
+
+	max_peers = seeker->daemon->fast_sync_peers;
+	if (max_peers > ARRAY_SIZE(seeker->fast_sync))
+		max_peers = ARRAY_SIZE(seeker->fast_sync);
+
+	list_for_each(&seeker->daemon->peers, p, list) {
+		if (peer_can_take_range_query(p)
+		    && peer_can_take_scid_query(p)
+		    && num_peers < max_peers)
+			num_peers++;
+	}
+	if (num_peers < 2)
+		return false;
+
+	if (first >= end)
+		first = 0;
+
+	set_state(seeker, FAST_SYNCING, NULL,
+		  "Fast sync of blocks %u-%u from %zu peers",
+		  first, end - 1, num_peers);
+
+	/* No streaming until we're done: we'd just get it all twice. */
+	list_for_each(&seeker->daemon->peers, p, list)
+		disable_gossip_stream(seeker, p);
+
+	seeker->num_fast_sync = num_peers;
+	seeker->prev_fast_sync_replies = seeker->fast_sync_replies;
+	for (size_t i = 0; i < num_peers; i++) {
+		struct fast_sync_shard *shard = &seeker->fast_sync[i];
+		u32 shard_end = first + (u64)(end - first) * (i + 1) / num_peers;
+
+		shard->first_blocknum = first + (u64)(end - first) * i / num_peers;
+		shard->number_of_blocks = shard_end - shard->first_blocknum;
+		shard->done = false;
+		fast_sync_ask_range(seeker, shard,
+				    random_peer(seeker->daemon,
+						peer_can_fast_sync));
+	}
+	return true;
+}
+
+static void check_fast_sync(struct seeker *seeker)
+{
+	/* Nothing in the last interval?  Give up, do it the slow way. */
+	if (seeker->fast_sync_replies == seeker->prev_fast_sync_replies) {
+		status_debug("seeker: fast sync made no progress, giving up");
+		fast_sync_done(seeker);
+		return;
+	}
+	seeker->prev_fast_sync_replies = seeker->fast_sync_replies;
+
+	/* Hand out ranges of peers which went away. */
+	for (size_t i = 0; i < seeker->num_fast_sync; i++) {
+		struct fast_sync_shard *shard = &seeker->fast_sync[i];
+		struct peer *peer;
+
+		if (shard->done || shard->peer_softref)
+			continue;
+		peer = random_peer(seeker->daemon, peer_can_fast_sync);
+		if (peer)
+			fast_sync_ask_range(seeker, shard, peer);
+	}
+}
+
 static void check_firstpeer(struct seeker *seeker)
 {
-	struct peer *peer = seeker->random_peer_softref, *p;
+	struct peer *peer = seeker->random_peer_softref;
 
 	/* It might have died, pick another. */
 	if (!peer) {
+		/* Gossip is slow from one peer: use many if we can. */
+		if (want_fast_sync(seeker) && start_fast_sync(seeker))
+			return;
+
 		peer = random_seeker(seeker, peer_has_gossip_queries);
 		/* No peer?  Wait for a new one to join. */
 		if (!peer) {
@@ -764,19 +1027,7 @@ static void check_firstpeer(struct seeker *seeker)
 	/* Other peers can gossip now. */
 	status_peer_debug(&peer->id, "seeker: startup peer finished");
 	clear_softref(seeker, &seeker->random_peer_softref);
-	list_for_each(&seeker->daemon->peers, p, list) {
-		if (p == peer)
-			continue;
-
-		normal_gossip_start(seeker, p);
-	}
-
-	/* Ask a random peer for all channels, in case we're missing */
-	seeker->scid_probe_start = chainparams->when_lightning_became_cool;
-	seeker->scid_probe_end = seeker->daemon->current_blockheight;
-	if (seeker->scid_probe_start > seeker->scid_probe_end)
-		seeker->scid_probe_start = 0;
-	peer_gossip_probe_scids(seeker);
+	startup_finished(seeker, peer);
 }
 
 static void check_probe(struct seeker *seeker,
@@ -881,6 +1132,9 @@ static void seeker_check(struct seeker *seeker)
 	case PROBING_NANNOUNCES:
 		check_probe(seeker, peer_gossip_probe_nannounces);
 		break;
+	case FAST_SYNCING:
+		check_fast_sync(seeker);
+		break;
 	case NORMAL:
 		maybe_rotate_gossipers(seeker);
 		if (!seek_any_unknown_scids(seeker)
@@ -906,11 +1160,19 @@ void seeker_setup_peer_gossip(struct seeker *seeker, struct peer *peer)
 
 	switch (seeker->state) {
 	case STARTING_UP:
-		if (seeker->random_peer_softref == NULL)
+		/* If we want fast sync, we wait for seeker_check, to give
+		 * more peers a chance to connect first. */
+		if (seeker->random_peer_softref == NULL
+		    && !want_fast_sync(seeker))
 			peer_gossip_startup(seeker, peer);
 		/* Waiting for seeker_check to release us */
 		return;
 
+	/* It'll be told to stream when we're done. */
+	case FAST_SYNCING:
+		disable_gossip_stream(seeker, peer);
+		return;
+
 	/* In these states, we set up peers to stream gossip normally */
 	case PROBING_SCIDS:
 	case PROBING_NANNOUNCES:
@@ -30,6 +30,7 @@ struct {
 	struct ext_key bip32;
 	struct secret bolt12;
 	struct secret derived_secret;
+	struct secret channel_seed_base;
 } secretstuff;
 
 /* Have we initialized the secretstuff? */
@@ -78,6 +79,7 @@ bool hsmd_check_client_capabilities(struct hsmd_client *client,
 	 */
 	switch (t) {
 	case WIRE_HSMD_ECDH_REQ:
+	case WIRE_HSMD_ECDH_BATCH_REQ:
 		return (client->capabilities & HSM_CAP_ECDH) != 0;
 
 	case WIRE_HSMD_CANNOUNCEMENT_SIG_REQ:
@@ -98,6 +100,7 @@ bool hsmd_check_client_capabilities(struct hsmd_client *client,
 
 	case WIRE_HSMD_SIGN_REMOTE_COMMITMENT_TX:
 	case WIRE_HSMD_SIGN_REMOTE_HTLC_TX:
+	case WIRE_HSMD_SIGN_REMOTE_HTLC_TXS:
 	case WIRE_HSMD_VALIDATE_COMMITMENT_TX:
 	case WIRE_HSMD_VALIDATE_REVOCATION:
 		return (client->capabilities & HSM_CAP_SIGN_REMOTE_TX) != 0;
@@ -128,6 +131,7 @@ bool hsmd_check_client_capabilities(struct hsmd_client *client,
 	/* FIXME: Since we autogenerate these, we should really generate separate
 	 * enums for replies to avoid this kind of clutter! */
 	case WIRE_HSMD_ECDH_RESP:
+	case WIRE_HSMD_ECDH_BATCH_RESP:
 	case WIRE_HSMD_CANNOUNCEMENT_SIG_REPLY:
 	case WIRE_HSMD_CUPDATE_SIG_REPLY:
 	case WIRE_HSMD_CLIENT_HSMFD_REPLY:
@@ -143,6 +147,7 @@ bool hsmd_check_client_capabilities(struct hsmd_client *client,
 	case WIRE_HSMD_VALIDATE_COMMITMENT_TX_REPLY:
 	case WIRE_HSMD_VALIDATE_REVOCATION_REPLY:
 	case WIRE_HSMD_SIGN_TX_REPLY:
+	case WIRE_HSMD_SIGN_REMOTE_HTLC_TXS_REPLY:
 	case WIRE_HSMD_SIGN_OPTION_WILL_FUND_OFFER_REPLY:
 	case WIRE_HSMD_GET_PER_COMMITMENT_POINT_REPLY:
 	case WIRE_HSMD_CHECK_FUTURE_SECRET_REPLY:
@@ -269,11 +274,29 @@ static u8 *handle_derive_secret(struct hsmd_client *c, const u8 *msg_in)
 	return towire_hsmd_derive_secret_reply(NULL, &secret);
 }
 
+/*~ Deriving a channel's keys costs three HKDFs and five point
+ * multiplications, and almost every request from a channeld needs some of
+ * them.  So we keep the last channels we derived for here: it's
+ * direct-mapped on the dbid (which is never reused), so it's bounded and
+ * never allocates. */
+#define CHANNEL_KEYS_CACHE_SIZE 256
+
+static struct channel_keys {
+	bool valid, have_keys;
+	struct node_id peer_id;
+	u64 dbid;
+	struct secret seed;
+	/* These are only valid if have_keys */
+	struct pubkey funding_pubkey;
+	struct basepoints basepoints;
+	struct secrets secrets;
+	struct sha256 shaseed;
+} channel_keys_cache[CHANNEL_KEYS_CACHE_SIZE];
+
 /*~ This gets the seed for this particular channel. */
-static void get_channel_seed(const struct node_id *peer_id, u64 dbid,
-			     struct secret *channel_seed)
+static void derive_channel_seed(const struct node_id *peer_id, u64 dbid,
+				struct secret *channel_seed)
 {
-	struct secret channel_base;
 	u8 input[sizeof(peer_id->k) + sizeof(dbid)];
 	/*~ Again, "per-peer" should be "per-channel", but Hysterical Raisins */
 	const char *info = "per-peer seed";
@@ -283,7 +306,6 @@ static void get_channel_seed(const struct node_id *peer_id, u64 dbid,
 	 * unnecessary, but again, existing users can't be broken. */
 	/* FIXME: lnd has a nicer BIP32 method for deriving secrets which we
 	 * should migrate to. */
-	hsm_channel_secret_base(&channel_base);
 	memcpy(input, peer_id->k, sizeof(peer_id->k));
 	BUILD_ASSERT(sizeof(peer_id->k) == PUBKEY_CMPR_LEN);
 	/*~ For all that talk about platform-independence, note that this
@@ -293,10 +315,63 @@ static void get_channel_seed(const struct node_id *peer_id, u64 dbid,
 
 	hkdf_sha256(channel_seed, sizeof(*channel_seed),
 		    input, sizeof(input),
-		    &channel_base, sizeof(channel_base),
+		    &secretstuff.channel_seed_base,
+		    sizeof(secretstuff.channel_seed_base),
 		    info, strlen(info));
 }
 
+static struct channel_keys *channel_keys(const struct node_id *peer_id,
+					 u64 dbid)
+{
+	struct channel_keys *k;
+
+	k = &channel_keys_cache[dbid % CHANNEL_KEYS_CACHE_SIZE];
+	if (!k->valid || k->dbid != dbid || !node_id_eq(&k->peer_id, peer_id)) {
+		k->valid = true;
+		k->have_keys = false;
+		k->peer_id = *peer_id;
+		k->dbid = dbid;
+		derive_channel_seed(peer_id, dbid, &k->seed);
+	}
+	return k;
+}
+
+static void get_channel_seed(const struct node_id *peer_id, u64 dbid,
+			     struct secret *channel_seed)
+{
+	*channel_seed = channel_keys(peer_id, dbid)->seed;
+}
+
+/*~ Like derive_basepoints() on the channel seed, but cached: any of the
+ * outputs can be NULL. */
+static void get_channel_keys(const struct node_id *peer_id, u64 dbid,
+			     struct pubkey *funding_pubkey,
+			     struct basepoints *basepoints,
+			     struct secrets *secrets,
+			     struct sha256 *shaseed)
+{
+	struct channel_keys *k = channel_keys(peer_id, dbid);
+
+	if (!k->have_keys) {
+		if (!derive_basepoints(&k->seed, &k->funding_pubkey,
+				       &k->basepoints, &k->secrets,
+				       &k->shaseed))
+			hsmd_status_failed(STATUS_FAIL_INTERNAL_ERROR,
+					   "Deriving basepoints for %"PRIu64,
+					   dbid);
+		k->have_keys = true;
+	}
+
+	if (funding_pubkey)
+		*funding_pubkey = k->funding_pubkey;
+	if (basepoints)
+		*basepoints = k->basepoints;
+	if (secrets)
+		*secrets = k->secrets;
+	if (shaseed)
+		*shaseed = k->shaseed;
+}
+
 /* ~This stub implementation is overriden by fully validating signers
  * that need to manage per-channel state. */
 static u8 *handle_new_channel(struct hsmd_client *c, const u8 *msg_in)
@@ -377,12 +452,11 @@ static u8 *handle_ready_channel(struct hsmd_client *c, const u8 *msg_in)
 static void hsm_unilateral_close_privkey(struct privkey *dst,
 					 struct unilateral_close_info *info)
 {
-	struct secret channel_seed;
 	struct basepoints basepoints;
 	struct secrets secrets;
 
-	get_channel_seed(&info->peer_id, info->channel_id, &channel_seed);
-	derive_basepoints(&channel_seed, NULL, &basepoints, &secrets, NULL);
+	get_channel_keys(&info->peer_id, info->channel_id,
+			 NULL, &basepoints, &secrets, NULL);
 
 	/* BOLT #3:
 	 *
@@ -457,6 +531,16 @@ static void hsm_key_for_utxo(struct privkey *privkey, struct pubkey *pubkey,
  * add a partial sig for each */
 static void sign_our_inputs(struct utxo **utxos, struct wally_psbt *psbt)
 {
+	struct bip143_hashes hashes;
+	/* wally_psbt_sign() rehashes every input and output for every input
+	 * it signs: that's quadratic for big withdrawals, so for plain
+	 * bitcoin we compute the shared BIP143 hashes once and sign the
+	 * SIGHASH_ALL inputs ourselves. */
+	bool use_bip143_hashes = !is_elements(chainparams);
+
+	if (use_bip143_hashes)
+		bip143_hashes_init(&hashes, psbt->tx);
+
 	for (size_t i = 0; i < tal_count(utxos); i++) {
 		struct utxo *utxo = utxos[i];
 		for (size_t j = 0; j < psbt->num_inputs; j++) {
@@ -491,6 +575,37 @@ static void sign_our_inputs(struct utxo **utxos, struct wally_psbt *psbt)
 							scriptpubkey_p2wsh(psbt, wscript),
 							utxo->amount);
 			}
+			if (use_bip143_hashes
+			    && (psbt->inputs[j].sighash == 0
+				|| psbt->inputs[j].sighash == SIGHASH_ALL)) {
+				struct sha256_double hash;
+				struct bitcoin_signature sig;
+				const u8 *scriptcode;
+
+				if (psbt->inputs[j].witness_script)
+					scriptcode = tal_dup_arr(tmpctx, u8,
+								 psbt->inputs[j].witness_script,
+								 psbt->inputs[j].witness_script_len, 0);
+				else
+					scriptcode = p2wpkh_scriptcode(tmpctx, &pubkey);
+
+				bip143_hash_for_sig(psbt->tx, &hashes, j,
+						    scriptcode,
+						    psbt_input_get_amount(psbt, j),
+						    &hash);
+				sign_hash(&privkey, &hash, &sig.s);
+				sig.sighash_type = SIGHASH_ALL;
+				if (!psbt_input_set_signature(psbt, j, &pubkey, &sig))
+					hsmd_status_broken(
+					    "Could not add signature for utxo"
+					    " with key %s. PSBT: %s",
+					    type_to_string(tmpctx, struct pubkey,
+							   &pubkey),
+					    type_to_string(tmpctx, struct wally_psbt,
+							   psbt));
+				continue;
+			}
+
 			tal_wally_start();
 			if (wally_psbt_sign(psbt, privkey.secret.data,
 					    sizeof(privkey.secret.data),
@@ -770,15 +885,14 @@ static u8 *handle_get_channel_basepoints(struct hsmd_client *c,
 {
 	struct node_id peer_id;
 	u64 dbid;
-	struct secret seed;
 	struct basepoints basepoints;
 	struct pubkey funding_pubkey;
 
 	if (!fromwire_hsmd_get_channel_basepoints(msg_in, &peer_id, &dbid))
 		return hsmd_status_malformed_request(c, msg_in);
 
-	get_channel_seed(&peer_id, dbid, &seed);
-	derive_basepoints(&seed, &funding_pubkey, &basepoints, NULL, NULL);
+	get_channel_keys(&peer_id, dbid,
+			 &funding_pubkey, &basepoints, NULL, NULL);
 
 	return towire_hsmd_get_channel_basepoints_reply(NULL, &basepoints,
 							&funding_pubkey);
@@ -811,6 +925,32 @@ static u8 *handle_ecdh(struct hsmd_client *c, const u8 *msg_in)
 	return towire_hsmd_ecdh_resp(NULL, &ss);
 }
 
+/*~ The same, for many points at once: this saves a round trip for each
+ * when a peer sends us a whole batch of HTLCs to decrypt. */
+static u8 *handle_ecdh_batch(struct hsmd_client *c, const u8 *msg_in)
+{
+	struct privkey privkey;
+	struct pubkey *points;
+	struct secret *ss;
+
+	if (!fromwire_hsmd_ecdh_batch_req(tmpctx, msg_in, &points))
+		return hsmd_status_malformed_request(c, msg_in);
+
+	node_key(&privkey, NULL);
+	ss = tal_arr(tmpctx, struct secret, tal_count(points));
+	for (size_t i = 0; i < tal_count(points); i++) {
+		if (secp256k1_ecdh(secp256k1_ctx, ss[i].data,
+				   &points[i].pubkey,
+				   privkey.secret.data, NULL, NULL) != 1) {
+			return hsmd_status_bad_request_fmt(c, msg_in,
+							   "secp256k1_ecdh fail"
+							   " on point %zu", i);
+		}
+	}
+
+	return towire_hsmd_ecdh_batch_resp(NULL, ss);
+}
+
 /*~ This is used when the remote peer claims to have knowledge of future
  * commitment states (option_data_loss_protect in the spec) which means we've
  * been restored from backup or something, and may have already revealed
@@ -1033,7 +1173,6 @@ static u8 *handle_channel_update_sig(struct hsmd_client *c, const u8 *msg_in)
  * the previous commitment transaction. */
 static u8 *handle_get_per_commitment_point(struct hsmd_client *c, const u8 *msg_in)
 {
-	struct secret channel_seed;
 	struct sha256 shaseed;
 	struct pubkey per_commitment_point;
 	u64 n;
@@ -1042,9 +1181,7 @@ static u8 *handle_get_per_commitment_point(struct hsmd_client *c, const u8 *msg_
 	if (!fromwire_hsmd_get_per_commitment_point(msg_in, &n))
 		return hsmd_status_malformed_request(c, msg_in);
 
-	get_channel_seed(&c->id, c->dbid, &channel_seed);
-	if (!derive_shaseed(&channel_seed, &shaseed))
-		return hsmd_status_bad_request(c, msg_in, "bad derive_shaseed");
+	get_channel_keys(&c->id, c->dbid, NULL, NULL, NULL, &shaseed);
 
 	if (!per_commit_point(&shaseed, &per_commitment_point, n))
 		return hsmd_status_bad_request_fmt(
@@ -1085,7 +1222,6 @@ static u8 *handle_sign_withdrawal_tx(struct hsmd_client *c, const u8 *msg_in)
 /* This is used by closingd to sign off on a mutual close tx. */
 static u8 *handle_sign_mutual_close_tx(struct hsmd_client *c, const u8 *msg_in)
 {
-	struct secret channel_seed;
 	struct bitcoin_tx *tx;
 	struct pubkey remote_funding_pubkey, local_funding_pubkey;
 	struct bitcoin_signature sig;
@@ -1101,9 +1237,8 @@ static u8 *handle_sign_mutual_close_tx(struct hsmd_client *c, const u8 *msg_in)
 	/* FIXME: We should know dust level, decent fee range and
 	 * balances, and final_keyindex, and thus be able to check tx
 	 * outputs! */
-	get_channel_seed(&c->id, c->dbid, &channel_seed);
-	derive_basepoints(&channel_seed,
-			  &local_funding_pubkey, NULL, &secrets, NULL);
+	get_channel_keys(&c->id, c->dbid,
+			 &local_funding_pubkey, NULL, &secrets, NULL);
 
 	funding_wscript = bitcoin_redeem_2of2(tmpctx,
 					      &local_funding_pubkey,
@@ -1190,7 +1325,6 @@ static u8 *handle_sign_local_htlc_tx(struct hsmd_client *c, const u8 *msg_in)
  * HTLC transactions. */
 static u8 *handle_sign_remote_htlc_tx(struct hsmd_client *c, const u8 *msg_in)
 {
-	struct secret channel_seed;
 	struct bitcoin_tx *tx;
 	struct bitcoin_signature sig;
 	struct secrets secrets;
@@ -1208,8 +1342,7 @@ static u8 *handle_sign_remote_htlc_tx(struct hsmd_client *c, const u8 *msg_in)
 		return hsmd_status_malformed_request(c, msg_in);
 
 	tx->chainparams = c->chainparams;
-	get_channel_seed(&c->id, c->dbid, &channel_seed);
-	derive_basepoints(&channel_seed, NULL, &basepoints, &secrets, NULL);
+	get_channel_keys(&c->id, c->dbid, NULL, &basepoints, &secrets, NULL);
 
 	if (!derive_simple_privkey(&secrets.htlc_basepoint_secret,
 				   &basepoints.htlc,
@@ -1238,6 +1371,80 @@ static u8 *handle_sign_remote_htlc_tx(struct hsmd_client *c, const u8 *msg_in)
 	return towire_hsmd_sign_tx_reply(NULL, &sig);
 }
 
+/*~ Busy channels can have hundreds of HTLCs, so channeld can also ask for
+ * all the HTLC signatures for a commitment transaction at once.  Since each
+ * HTLC tx spends the commitment tx, we take the witness scripts from its
+ * outputs rather than trusting separate ones. */
+static u8 *handle_sign_remote_htlc_txs(struct hsmd_client *c, const u8 *msg_in)
+{
+	struct bitcoin_tx *commit_tx, **htlc_txs;
+	struct bitcoin_signature *sigs;
+	struct bitcoin_txid commit_txid;
+	struct secrets secrets;
+	struct basepoints basepoints;
+	struct pubkey remote_per_commit_point;
+	struct privkey htlc_privkey;
+	struct pubkey htlc_pubkey;
+	bool option_anchor_outputs;
+
+	if (!fromwire_hsmd_sign_remote_htlc_txs(tmpctx, msg_in,
+						&commit_tx, &htlc_txs,
+						&remote_per_commit_point,
+						&option_anchor_outputs))
+		return hsmd_status_malformed_request(c, msg_in);
+
+	commit_tx->chainparams = c->chainparams;
+	bitcoin_txid(commit_tx, &commit_txid);
+	get_channel_keys(&c->id, c->dbid, NULL, &basepoints, &secrets, NULL);
+
+	if (!derive_simple_privkey(&secrets.htlc_basepoint_secret,
+				   &basepoints.htlc,
+				   &remote_per_commit_point,
+				   &htlc_privkey))
+		return hsmd_status_bad_request_fmt(
+		    c, msg_in, "Failed deriving htlc privkey");
+
+	if (!derive_simple_key(&basepoints.htlc,
+			       &remote_per_commit_point,
+			       &htlc_pubkey))
+		return hsmd_status_bad_request_fmt(
+		    c, msg_in, "Failed deriving htlc pubkey");
+
+	sigs = tal_arr(tmpctx, struct bitcoin_signature, tal_count(htlc_txs));
+	for (size_t i = 0; i < tal_count(htlc_txs); i++) {
+		struct bitcoin_tx *tx = htlc_txs[i];
+		struct bitcoin_outpoint outpoint;
+		const u8 *wscript;
+
+		tx->chainparams = c->chainparams;
+		if (tx->wtx->num_inputs != 1)
+			return hsmd_status_bad_request_fmt(
+			    c, msg_in, "htlc tx %zu: bad txinput count", i);
+
+		outpoint.txid = commit_txid;
+		outpoint.n = tx->wtx->inputs[0].index;
+		if (!wally_tx_input_spends(&tx->wtx->inputs[0], &outpoint)
+		    || outpoint.n >= commit_tx->wtx->num_outputs)
+			return hsmd_status_bad_request_fmt(
+			    c, msg_in, "htlc tx %zu: does not spend commit tx",
+			    i);
+
+		wscript = bitcoin_tx_output_get_witscript(tmpctx, commit_tx,
+							  outpoint.n);
+		if (!wscript)
+			return hsmd_status_bad_request_fmt(
+			    c, msg_in, "htlc tx %zu: no witness script", i);
+
+		/* Same as handle_sign_remote_htlc_tx above. */
+		sign_tx_input(tx, 0, NULL, wscript, &htlc_privkey, &htlc_pubkey,
+			      option_anchor_outputs
+			      ? (SIGHASH_SINGLE|SIGHASH_ANYONECANPAY)
+			      : SIGHASH_ALL, &sigs[i]);
+	}
+
+	return towire_hsmd_sign_remote_htlc_txs_reply(NULL, sigs);
+}
+
 /*~ This is used by channeld to create signatures for the remote peer's
  * commitment transaction.  It's functionally identical to signing our own,
  * but we expect to do this repeatedly as commitment transactions are
@@ -1249,7 +1456,6 @@ static u8 *handle_sign_remote_htlc_tx(struct hsmd_client *c, const u8 *msg_in)
 static u8 *handle_sign_remote_commitment_tx(struct hsmd_client *c, const u8 *msg_in)
 {
 	struct pubkey remote_funding_pubkey, local_funding_pubkey;
-	struct secret channel_seed;
 	struct bitcoin_tx *tx;
 	struct bitcoin_signature sig;
 	struct secrets secrets;
@@ -1279,9 +1485,8 @@ static u8 *handle_sign_remote_commitment_tx(struct hsmd_client *c, const u8 *msg
 		return hsmd_status_bad_request_fmt(c, msg_in,
 						   "tx must have > 0 outputs");
 
-	get_channel_seed(&c->id, c->dbid, &channel_seed);
-	derive_basepoints(&channel_seed,
-			  &local_funding_pubkey, NULL, &secrets, NULL);
+	get_channel_keys(&c->id, c->dbid,
+			 &local_funding_pubkey, NULL, &secrets, NULL);
 
 	funding_wscript = bitcoin_redeem_2of2(tmpctx,
 					      &local_funding_pubkey,
@@ -1348,7 +1553,6 @@ static u8 *handle_sign_commitment_tx(struct hsmd_client *c, const u8 *msg_in)
 	struct pubkey remote_funding_pubkey, local_funding_pubkey;
 	struct node_id peer_id;
 	u64 dbid;
-	struct secret channel_seed;
 	struct bitcoin_tx *tx;
 	struct bitcoin_signature sig;
 	u64 commit_num;
@@ -1373,9 +1577,8 @@ static u8 *handle_sign_commitment_tx(struct hsmd_client *c, const u8 *msg_in)
 		return hsmd_status_bad_request_fmt(c, msg_in,
 						   "tx must have > 0 outputs");
 
-	get_channel_seed(&peer_id, dbid, &channel_seed);
-	derive_basepoints(&channel_seed,
-			  &local_funding_pubkey, NULL, &secrets, NULL);
+	get_channel_keys(&peer_id, dbid,
+			 &local_funding_pubkey, NULL, &secrets, NULL);
 
 	/*~ Bitcoin signatures cover the (part of) the script they're
 	 * executing; the rules are a bit complex in general, but for
@@ -1402,7 +1605,6 @@ static u8 *handle_validate_commitment_tx(struct hsmd_client *c, const u8 *msg_in
 	u32 feerate;
 	struct bitcoin_signature sig;
 	struct bitcoin_signature *htlc_sigs;
-	struct secret channel_seed;
 	struct sha256 shaseed;
 	struct secret *old_secret;
 	struct pubkey next_per_commitment_point;
@@ -1420,9 +1622,7 @@ static u8 *handle_validate_commitment_tx(struct hsmd_client *c, const u8 *msg_in
 	 * old_secret and next_per_commitment_point are used.
 	 */
 
-	get_channel_seed(&c->id, c->dbid, &channel_seed);
-	if (!derive_shaseed(&channel_seed, &shaseed))
-		return hsmd_status_bad_request(c, msg_in, "bad derive_shaseed");
+	get_channel_keys(&c->id, c->dbid, NULL, NULL, NULL, &shaseed);
 
 	if (!per_commit_point(&shaseed, &next_per_commitment_point, commit_num + 1))
 		return hsmd_status_bad_request_fmt(
@@ -1604,6 +1804,8 @@ u8 *hsmd_handle_client_message(const tal_t *ctx, struct hsmd_client *client,
 		return handle_check_future_secret(client, msg);
 	case WIRE_HSMD_ECDH_REQ:
 		return handle_ecdh(client, msg);
+	case WIRE_HSMD_ECDH_BATCH_REQ:
+		return handle_ecdh_batch(client, msg);
 	case WIRE_HSMD_SIGN_INVOICE:
 		return handle_sign_invoice(client, msg);
 	case WIRE_HSMD_SIGN_OPTION_WILL_FUND_OFFER:
@@ -1634,6 +1836,8 @@ u8 *hsmd_handle_client_message(const tal_t *ctx, struct hsmd_client *client,
 		return handle_sign_local_htlc_tx(client, msg);
 	case WIRE_HSMD_SIGN_REMOTE_HTLC_TX:
 		return handle_sign_remote_htlc_tx(client, msg);
+	case WIRE_HSMD_SIGN_REMOTE_HTLC_TXS:
+		return handle_sign_remote_htlc_txs(client, msg);
 	case WIRE_HSMD_SIGN_REMOTE_COMMITMENT_TX:
 		return handle_sign_remote_commitment_tx(client, msg);
 	case WIRE_HSMD_SIGN_PENALTY_TO_US:
@@ -1653,6 +1857,7 @@ u8 *hsmd_handle_client_message(const tal_t *ctx, struct hsmd_client *client,
 
 	case WIRE_HSMD_DEV_MEMLEAK:
 	case WIRE_HSMD_ECDH_RESP:
+	case WIRE_HSMD_ECDH_BATCH_RESP:
 	case WIRE_HSMD_DERIVE_SECRET_REPLY:
 	case WIRE_HSMD_CANNOUNCEMENT_SIG_REPLY:
 	case WIRE_HSMD_CUPDATE_SIG_REPLY:
@@ -1669,6 +1874,7 @@ u8 *hsmd_handle_client_message(const tal_t *ctx, struct hsmd_client *client,
 	case WIRE_HSMD_VALIDATE_COMMITMENT_TX_REPLY:
 	case WIRE_HSMD_VALIDATE_REVOCATION_REPLY:
 	case WIRE_HSMD_SIGN_TX_REPLY:
+	case WIRE_HSMD_SIGN_REMOTE_HTLC_TXS_REPLY:
 	case WIRE_HSMD_SIGN_OPTION_WILL_FUND_OFFER_REPLY:
 	case WIRE_HSMD_GET_PER_COMMITMENT_POINT_REPLY:
 	case WIRE_HSMD_CHECK_FUTURE_SECRET_REPLY:
@@ -1698,6 +1904,11 @@ u8 *hsmd_init(struct secret hsm_secret,
 		     sizeof(secretstuff.hsm_secret.data));
 	memcpy(secretstuff.hsm_secret.data, hsm_secret.data, sizeof(hsm_secret.data));
 
+	/* Every channel seed needs this, so derive it once. */
+	hsm_channel_secret_base(&secretstuff.channel_seed_base);
+	sodium_memzero(channel_keys_cache, sizeof(channel_keys_cache));
+	sodium_mlock(channel_keys_cache, sizeof(channel_keys_cache));
+
 	assert(bip32_key_version.bip32_pubkey_version == BIP32_VER_MAIN_PUBLIC
 			|| bip32_key_version.bip32_pubkey_version == BIP32_VER_TEST_PUBLIC);
 
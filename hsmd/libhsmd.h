@@ -61,7 +61,11 @@ struct hsmd_client *hsmd_client_new_peer(const tal_t *ctx, u64 capabilities,
 /* Handle an incoming request with the provided context. Upon
  * successful processing we return a response message that is
  * allocated off of `ctx`. Failures return a `NULL` pointer, and the
- * failure details were passed to `hsmd_failed`. */
+ * failure details were passed to `hsmd_failed`.
+ *
+ * Only ever call this from one thread: handlers allocate with tal (and
+ * tmpctx), log through the status conn, and read secretstuff and the dev
+ * overrides without any locking. */
 u8 *hsmd_handle_client_message(const tal_t *ctx, struct hsmd_client *client,
 			       const u8 *msg);
 
@@ -11,16 +11,20 @@
 #include <bitcoin/shadouble.h>
 #include <ccan/array_size/array_size.h>
 #include <ccan/io/io.h>
+#include <ccan/tal/grab_file/grab_file.h>
+#include <ccan/tal/path/path.h>
 #include <ccan/tal/str/str.h>
 #include <common/json_parse.h>
 #include <common/memleak.h>
 #include <db/exec.h>
+#include <errno.h>
 #include <lightningd/bitcoind.h>
 #include <lightningd/chaintopology.h>
 #include <lightningd/io_loop_with_timers.h>
 #include <lightningd/lightningd.h>
 #include <lightningd/log.h>
 #include <lightningd/plugin.h>
+#include <unistd.h>
 
 /* The names of the requests we can make to our Bitcoin backend. */
 static const char *methods[] = {"getchaininfo", "getrawblockbyheight",
@@ -97,6 +101,21 @@ void bitcoind_check_commands(struct bitcoind *bitcoind)
 		}
 		wait_plugin(bitcoind, methods[i], p);
 	}
+
+	/* This one is optional: it lets us skip hex-in-JSON for blocks. */
+	p = find_plugin_for_command(bitcoind->ld, "writerawblockbyheight");
+	if (p)
+		wait_plugin(bitcoind, "writerawblockbyheight", p);
+
+	/* Optional, for use-blockfilters: BIP158 filters. */
+	p = find_plugin_for_command(bitcoind->ld, "getblockfilterbyheight");
+	if (p)
+		wait_plugin(bitcoind, "getblockfilterbyheight", p);
+
+	/* Also optional: lets us check many outputs in one call. */
+	p = find_plugin_for_command(bitcoind->ld, "getutxouts");
+	if (p)
+		wait_plugin(bitcoind, "getutxouts", p);
 }
 
 /* Our Bitcoin backend plugin gave us a bad response. We can't recover. */
@@ -343,8 +362,20 @@ struct getrawblockbyheight_call {
 		   struct bitcoin_block *block,
 		   void *);
 	void *cb_arg;
+	/* For writerawblockbyheight: the file it writes into. */
+	const char *path;
 };
 
+static void getrawblockbyheight_done(struct getrawblockbyheight_call *call,
+				     struct bitcoin_blkid *blkid,
+				     struct bitcoin_block *blk)
+{
+	db_begin_transaction(call->bitcoind->ld->wallet->db);
+	call->cb(call->bitcoind, blkid, blk, call->cb_arg);
+	db_commit_transaction(call->bitcoind->ld->wallet->db);
+	tal_free(call);
+}
+
 static void
 getrawblockbyheight_callback(const char *buf, const jsmntok_t *toks,
 			     const jsmntok_t *idtok,
@@ -358,10 +389,8 @@ getrawblockbyheight_callback(const char *buf, const jsmntok_t *toks,
 	 * with NULL values. */
 	err = json_scan(tmpctx, buf, toks, "{result:{blockhash:null}}");
 	if (!err) {
-		db_begin_transaction(call->bitcoind->ld->wallet->db);
-		call->cb(call->bitcoind, NULL, NULL, call->cb_arg);
-		db_commit_transaction(call->bitcoind->ld->wallet->db);
-		goto clean;
+		getrawblockbyheight_done(call, NULL, NULL);
+		return;
 	}
 
 	err = json_scan(tmpctx, buf, toks, "{result:{blockhash:%,block:%}}",
@@ -379,12 +408,56 @@ getrawblockbyheight_callback(const char *buf, const jsmntok_t *toks,
 				     "getrawblockbyheight",
 				     "bad block");
 
-	db_begin_transaction(call->bitcoind->ld->wallet->db);
-	call->cb(call->bitcoind, &blkid, blk, call->cb_arg);
-	db_commit_transaction(call->bitcoind->ld->wallet->db);
+	getrawblockbyheight_done(call, &blkid, blk);
+}
 
-clean:
-	tal_free(call);
+static void
+writerawblockbyheight_callback(const char *buf, const jsmntok_t *toks,
+			       const jsmntok_t *idtok,
+			       struct getrawblockbyheight_call *call)
+{
+	const char *err;
+	struct bitcoin_blkid blkid;
+	struct bitcoin_block *blk;
+	u64 size;
+	u8 *raw;
+
+	err = json_scan(tmpctx, buf, toks, "{result:{blockhash:null}}");
+	if (!err) {
+		getrawblockbyheight_done(call, NULL, NULL);
+		return;
+	}
+
+	err = json_scan(tmpctx, buf, toks, "{result:{blockhash:%,size:%}}",
+			JSON_SCAN(json_to_sha256, &blkid.shad.sha),
+			JSON_SCAN(json_to_u64, &size));
+	if (err)
+		bitcoin_plugin_error(call->bitcoind, buf, toks,
+				     "writerawblockbyheight",
+				     "bad 'result' field: %s", err);
+
+	raw = grab_file(tmpctx, call->path);
+	if (!raw)
+		bitcoin_plugin_error(call->bitcoind, buf, toks,
+				     "writerawblockbyheight",
+				     "could not read %s: %s",
+				     call->path, strerror(errno));
+	unlink(call->path);
+
+	/* grab_file adds a nul terminator */
+	if (tal_bytelen(raw) - 1 != size)
+		bitcoin_plugin_error(call->bitcoind, buf, toks,
+				     "writerawblockbyheight",
+				     "%s was %zu bytes, not %"PRIu64,
+				     call->path, tal_bytelen(raw) - 1, size);
+
+	blk = bitcoin_block_from_raw(tmpctx, chainparams, take(raw), size);
+	if (!blk)
+		bitcoin_plugin_error(call->bitcoind, buf, toks,
+				     "writerawblockbyheight",
+				     "bad block");
+
+	getrawblockbyheight_done(call, &blkid, blk);
 }
 
 void bitcoind_getrawblockbyheight_(struct bitcoind *bitcoind,
@@ -403,9 +476,149 @@ void bitcoind_getrawblockbyheight_(struct bitcoind *bitcoind,
 	call->cb = cb;
 	call->cb_arg = cb_arg;
 
-	req = jsonrpc_request_start(bitcoind, "getrawblockbyheight", NULL, true,
-				    bitcoind->log,
-				    NULL,  getrawblockbyheight_callback,
+	/* If the backend can hand us raw bytes, avoid the hex and JSON. */
+	if (strmap_get(&bitcoind->pluginsmap, "writerawblockbyheight")) {
+		call->path = path_join(call, path_cwd(tmpctx),
+				       tal_fmt(tmpctx, ".rawblock-%"PRIu64,
+					       bitcoind->rawblock_counter++));
+		req = jsonrpc_request_start(bitcoind, "writerawblockbyheight",
+					    NULL, true, bitcoind->log,
+					    NULL, writerawblockbyheight_callback,
+					    call);
+		json_add_num(req->stream, "height", height);
+		json_add_string(req->stream, "path", call->path);
+	} else {
+		call->path = NULL;
+		req = jsonrpc_request_start(bitcoind, "getrawblockbyheight",
+					    NULL, true, bitcoind->log,
+					    NULL, getrawblockbyheight_callback,
+					    call);
+		json_add_num(req->stream, "height", height);
+	}
+	jsonrpc_request_end(req);
+	bitcoin_plugin_send(bitcoind, req);
+}
+
+/* `getblockfilterbyheight`
+ *
+ * If no block were found at that height, will set each field to `null`.
+ * Plugin response:
+ * {
+ *	"blockhash": "<blkid>",
+ *	"header": "rawheader",
+ *	"filter": "BIP158 basic filter"
+ * }
+ */
+
+struct getblockfilterbyheight_call {
+	struct bitcoind *bitcoind;
+	u32 height;
+	void (*cb)(struct bitcoind *bitcoind,
+		   struct bitcoin_blkid *blkid,
+		   struct bitcoin_block *blk,
+		   const u8 *filter,
+		   void *);
+	void *cb_arg;
+};
+
+static void getblockfilter_fullblock(struct bitcoind *bitcoind,
+				     struct bitcoin_blkid *blkid,
+				     struct bitcoin_block *blk,
+				     struct getblockfilterbyheight_call *call)
+{
+	call->cb(bitcoind, blkid, blk, NULL, call->cb_arg);
+	tal_free(call);
+}
+
+static void
+getblockfilterbyheight_callback(const char *buf, const jsmntok_t *toks,
+				const jsmntok_t *idtok,
+				struct getblockfilterbyheight_call *call)
+{
+	const jsmntok_t *errtok;
+	const char *err;
+	struct bitcoin_blkid blkid;
+	struct bitcoin_block *blk;
+	u8 *header, *filter;
+
+	/* Probably no -blockfilterindex: stop asking, just get blocks. */
+	errtok = json_get_member(buf, toks, "error");
+	if (errtok) {
+		log_unusual(call->bitcoind->log,
+			    "getblockfilterbyheight failed (%.*s):"
+			    " fetching full blocks from now on",
+			    json_tok_full_len(errtok),
+			    json_tok_full(buf, errtok));
+		call->bitcoind->blockfilters_failed = true;
+		bitcoind_getrawblockbyheight(call->bitcoind, call->height,
+					     getblockfilter_fullblock, call);
+		return;
+	}
+
+	err = json_scan(tmpctx, buf, toks, "{result:{blockhash:null}}");
+	if (!err) {
+		db_begin_transaction(call->bitcoind->ld->wallet->db);
+		call->cb(call->bitcoind, NULL, NULL, NULL, call->cb_arg);
+		db_commit_transaction(call->bitcoind->ld->wallet->db);
+		tal_free(call);
+		return;
+	}
+
+	err = json_scan(tmpctx, buf, toks,
+			"{result:{blockhash:%,header:%,filter:%}}",
+			JSON_SCAN(json_to_sha256, &blkid.shad.sha),
+			JSON_SCAN_TAL(tmpctx, json_tok_bin_from_hex, &header),
+			JSON_SCAN_TAL(tmpctx, json_tok_bin_from_hex, &filter));
+	if (err)
+		bitcoin_plugin_error(call->bitcoind, buf, toks,
+				     "getblockfilterbyheight",
+				     "bad 'result' field: %s", err);
+
+	/* A header with no transactions parses as a block. */
+	tal_arr_expand(&header, 0);
+	blk = bitcoin_block_from_raw(tmpctx, chainparams, take(header),
+				     tal_bytelen(header));
+	if (!blk || !bitcoin_blkid_eq(&blk->hdr.hash, &blkid))
+		bitcoin_plugin_error(call->bitcoind, buf, toks,
+				     "getblockfilterbyheight",
+				     "bad header");
+
+	db_begin_transaction(call->bitcoind->ld->wallet->db);
+	call->cb(call->bitcoind, &blkid, blk, filter, call->cb_arg);
+	db_commit_transaction(call->bitcoind->ld->wallet->db);
+	tal_free(call);
+}
+
+void bitcoind_getblockfilterbyheight_(struct bitcoind *bitcoind,
+				      u32 height,
+				      void (*cb)(struct bitcoind *bitcoind,
+						 struct bitcoin_blkid *blkid,
+						 struct bitcoin_block *blk,
+						 const u8 *filter,
+						 void *arg),
+				      void *cb_arg)
+{
+	struct jsonrpc_request *req;
+	struct getblockfilterbyheight_call *call
+		= tal(bitcoind, struct getblockfilterbyheight_call);
+
+	call->bitcoind = bitcoind;
+	call->height = height;
+	call->cb = cb;
+	call->cb_arg = cb_arg;
+
+	/* Elements has no BIP158 filters. */
+	if (!strmap_get(&bitcoind->pluginsmap, "getblockfilterbyheight")
+	    || bitcoind->blockfilters_failed
+	    || chainparams->is_elements) {
+		bitcoind_getrawblockbyheight(bitcoind, height,
+					     getblockfilter_fullblock, call);
+		return;
+	}
+
+	req = jsonrpc_request_start(bitcoind, "getblockfilterbyheight",
+				    NULL, true, bitcoind->log,
+				    NULL, getblockfilterbyheight_callback,
 				    call);
 	json_add_num(req->stream, "height", height);
 	jsonrpc_request_end(req);
@@ -566,6 +779,95 @@ void bitcoind_getutxout_(struct bitcoind *bitcoind,
 	bitcoin_plugin_send(bitcoind, req);
 }
 
+/* `getutxouts`
+ *
+ * Optional: like `getutxout`, but for an array of outpoints at once.
+ * {
+ *	"utxouts": [ { "amount": ..., "script": ... }, ... ]
+ * }
+ */
+
+struct getutxouts_call {
+	struct bitcoind *bitcoind;
+	size_t num;
+
+	void (*cb)(struct bitcoind *bitcoind,
+		   const struct bitcoin_tx_output **txouts, void *arg);
+	void *cb_arg;
+};
+
+static void getutxouts_callback(const char *buf, const jsmntok_t *toks,
+				const jsmntok_t *idtok,
+				struct getutxouts_call *call)
+{
+	const jsmntok_t *result, *arr = NULL, *t;
+	const struct bitcoin_tx_output **txouts;
+	size_t i;
+
+	result = json_get_member(buf, toks, "result");
+	if (result)
+		arr = json_get_member(buf, result, "utxouts");
+	if (!arr || arr->type != JSMN_ARRAY || arr->size != call->num)
+		bitcoin_plugin_error(call->bitcoind, buf, toks, "getutxouts",
+				     "bad 'utxouts' field");
+
+	txouts = tal_arrz(tmpctx, const struct bitcoin_tx_output *, call->num);
+	json_for_each_arr(i, t, arr) {
+		struct bitcoin_tx_output *txout;
+		const char *err;
+
+		if (!json_scan(tmpctx, buf, t, "{script:null}"))
+			continue;
+
+		txout = tal(txouts, struct bitcoin_tx_output);
+		err = json_scan(tmpctx, buf, t, "{script:%,amount:%}",
+				JSON_SCAN_TAL(txout, json_tok_bin_from_hex,
+					      &txout->script),
+				JSON_SCAN(json_to_sat, &txout->amount));
+		if (err)
+			bitcoin_plugin_error(call->bitcoind, buf, toks,
+					     "getutxouts",
+					     "bad 'utxouts[%zu]': %s", i, err);
+		txouts[i] = txout;
+	}
+
+	db_begin_transaction(call->bitcoind->ld->wallet->db);
+	call->cb(call->bitcoind, txouts, call->cb_arg);
+	db_commit_transaction(call->bitcoind->ld->wallet->db);
+
+	tal_free(call);
+}
+
+static void bitcoind_getutxouts(struct bitcoind *bitcoind,
+				struct filteredblock_outpoint **outpoints,
+				void (*cb)(struct bitcoind *,
+					   const struct bitcoin_tx_output **,
+					   void *),
+				void *cb_arg)
+{
+	struct jsonrpc_request *req;
+	struct getutxouts_call *call = tal(bitcoind, struct getutxouts_call);
+
+	call->bitcoind = bitcoind;
+	call->num = tal_count(outpoints);
+	call->cb = cb;
+	call->cb_arg = cb_arg;
+
+	req = jsonrpc_request_start(bitcoind, "getutxouts", NULL, true,
+				    bitcoind->log,
+				    NULL, getutxouts_callback, call);
+	json_array_start(req->stream, "outpoints");
+	for (size_t i = 0; i < tal_count(outpoints); i++) {
+		json_object_start(req->stream, NULL);
+		json_add_txid(req->stream, "txid", &outpoints[i]->outpoint.txid);
+		json_add_num(req->stream, "vout", outpoints[i]->outpoint.n);
+		json_object_end(req->stream);
+	}
+	json_array_end(req->stream);
+	jsonrpc_request_end(req);
+	bitcoin_plugin_send(bitcoind, req);
+}
+
 /* Context for the getfilteredblock call. Wraps the actual arguments while we
  * process the various steps. */
 struct filteredblock_call {
@@ -586,6 +888,24 @@ static void
 process_getfiltered_block_final(struct bitcoind *bitcoind,
 				const struct filteredblock_call *call);
 
+/* All outpoints checked at once, using getutxouts */
+static void
+process_getfilteredblock_step2_batch(struct bitcoind *bitcoind,
+				     const struct bitcoin_tx_output **outputs,
+				     void *arg)
+{
+	struct filteredblock_call *call = (struct filteredblock_call *)arg;
+
+	for (size_t i = 0; i < tal_count(outputs); i++) {
+		/* If this output is unspent, add it to the filteredblock result. */
+		if (outputs[i])
+			tal_arr_expand(&call->result->outpoints,
+				       tal_steal(call->result,
+						 call->outpoints[i]));
+	}
+	process_getfiltered_block_final(bitcoind, call);
+}
+
 static void
 process_getfilteredblock_step2(struct bitcoind *bitcoind,
 			       const struct bitcoin_tx_output *output,
@@ -615,7 +935,6 @@ static void process_getfilteredblock_step1(struct bitcoind *bitcoind,
 					   struct filteredblock_call *call)
 {
 	struct filteredblock_outpoint *o;
-	struct bitcoin_tx *tx;
 
 	/* If we were unable to fetch the block hash (bitcoind doesn't know
 	 * about a block at that height), we can short-circuit and just call
@@ -639,17 +958,25 @@ static void process_getfilteredblock_step1(struct bitcoind *bitcoind,
 	 * call->result if they are unspent. */
 
 	call->outpoints = tal_arr(call, struct filteredblock_outpoint *, 0);
-	for (size_t i = 0; i < tal_count(block->tx); i++) {
-		tx = block->tx[i];
-		for (size_t j = 0; j < tx->wtx->num_outputs; j++) {
-			const u8 *script = bitcoin_tx_output_get_script(NULL, tx, j);
-			struct amount_asset amount = bitcoin_tx_output_get_amount(tx, j);
-			if (amount_asset_is_main(&amount) && is_p2wsh(script, NULL)) {
+	for (size_t i = 0; i < tal_count(block->txs); i++) {
+		const struct bitcoin_block_tx *btx = &block->txs[i];
+		for (size_t j = 0; j < btx->num_outputs; j++) {
+			const struct bitcoin_block_output *out
+				= &block->outputs[btx->first_output + j];
+			u8 *script;
+
+			if (!out->is_main_asset
+			    || out->script_len != BITCOIN_SCRIPTPUBKEY_P2WSH_LEN)
+				continue;
+
+			script = tal_dup_arr(NULL, u8,
+					     out->script, out->script_len, 0);
+			if (is_p2wsh(script, NULL)) {
 				/* This is an interesting output, remember it. */
 				o = tal(call->outpoints, struct filteredblock_outpoint);
-				bitcoin_txid(tx, &o->outpoint.txid);
+				o->outpoint.txid = block->txids[i];
 				o->outpoint.n = j;
-				o->amount = amount_asset_to_sat(&amount);
+				o->amount = out->amount;
 				o->txindex = i;
 				o->scriptPubKey = tal_steal(o, script);
 				tal_arr_expand(&call->outpoints, o);
@@ -668,6 +995,12 @@ static void process_getfilteredblock_step1(struct bitcoind *bitcoind,
 		/* Otherwise we start iterating through call->outpoints and
 		 * store the one's that are unspent in
 		 * call->result->outpoints. */
+		if (strmap_get(&bitcoind->pluginsmap, "getutxouts")) {
+			bitcoind_getutxouts(bitcoind, call->outpoints,
+					    process_getfilteredblock_step2_batch,
+					    call);
+			return;
+		}
 		o = call->outpoints[call->current_outpoint];
 		bitcoind_getutxout(bitcoind, &o->outpoint,
 				  process_getfilteredblock_step2, call);
@@ -750,6 +1083,8 @@ struct bitcoind *new_bitcoind(const tal_t *ctx,
 	list_head_init(&bitcoind->pending_getfilteredblock);
 	tal_add_destructor(bitcoind, destroy_bitcoind);
 	bitcoind->synced = false;
+	bitcoind->rawblock_counter = 0;
+	bitcoind->blockfilters_failed = false;
 
 	return bitcoind;
 }
@@ -35,6 +35,12 @@ struct bitcoind {
 	/* Map each method to a plugin, so we can have multiple plugins
 	 * handling different functionalities. */
 	STRMAP(struct plugin *) pluginsmap;
+
+	/* To give each writerawblockbyheight a unique file. */
+	u64 rawblock_counter;
+
+	/* Set if getblockfilterbyheight failed: we stop trying it. */
+	bool blockfilters_failed;
 };
 
 /* A single outpoint in a filtered block */
@@ -135,6 +141,26 @@ void bitcoind_getrawblockbyheight_(struct bitcoind *bitcoind,
 							  struct bitcoin_block *),\
 				      (arg))
 
+/* If @filter is non-NULL, @blk only has the header: otherwise (no filter
+ * from the backend) @blk is the full block. */
+void bitcoind_getblockfilterbyheight_(struct bitcoind *bitcoind,
+				      u32 height,
+				      void (*cb)(struct bitcoind *bitcoind,
+						 struct bitcoin_blkid *blkid,
+						 struct bitcoin_block *blk,
+						 const u8 *filter,
+						 void *arg),
+				      void *arg);
+#define bitcoind_getblockfilterbyheight(bitcoind_, height_, cb, arg)	\
+	bitcoind_getblockfilterbyheight_((bitcoind_), (height_),		\
+					 typesafe_cb_preargs(void, void *,	\
+							     (cb), (arg),	\
+							     struct bitcoind *,	\
+							     struct bitcoin_blkid *, \
+							     struct bitcoin_block *, \
+							     const u8 *),	\
+					 (arg))
+
 void bitcoind_getutxout_(struct bitcoind *bitcoind,
 			 const struct bitcoin_outpoint *outpoint,
 			 void (*cb)(struct bitcoind *,
@@ -1,4 +1,5 @@
 #include "config.h"
+#include <bitcoin/blockfilter.h>
 #include <bitcoin/feerate.h>
 #include <bitcoin/script.h>
 #include <bitcoin/tx.h>
@@ -10,6 +11,7 @@
 #include <common/json_param.h>
 #include <common/memleak.h>
 #include <common/timeout.h>
+#include <common/trace_probe.h>
 #include <common/type_to_string.h>
 #include <db/exec.h>
 #include <lightningd/bitcoind.h>
@@ -58,25 +60,27 @@ static bool we_broadcast(const struct chain_topology *topo,
 
 static void filter_block_txs(struct chain_topology *topo, struct block *b)
 {
+	struct bitcoin_block *blk = b->blk;
 	size_t i;
 	struct amount_sat owned;
 
-	/* Now we see if any of those txs are interesting. */
-	for (i = 0; i < tal_count(b->full_txs); i++) {
-		const struct bitcoin_tx *tx = b->full_txs[i];
-		struct bitcoin_txid txid;
+	/* Now we see if any of those txs are interesting: we only decode
+	 * the ones which are. */
+	for (i = 0; i < tal_count(blk->txs); i++) {
+		const struct bitcoin_block_tx *btx = &blk->txs[i];
+		const struct bitcoin_txid *txid = &blk->txids[i];
+		struct bitcoin_tx *tx;
 		size_t j;
 		bool is_coinbase = i == 0;
 
 		/* Tell them if it spends a txo we care about. */
-		for (j = 0; j < tx->wtx->num_inputs; j++) {
-			struct bitcoin_outpoint out;
+		for (j = 0; j < btx->num_inputs; j++) {
 			struct txowatch *txo;
-			bitcoin_tx_input_get_txid(tx, j, &out.txid);
-			out.n = tx->wtx->inputs[j].index;
 
-			txo = txowatch_hash_get(topo->txowatches, &out);
+			txo = txowatch_hash_get(topo->txowatches,
+						&blk->inputs[btx->first_input + j]);
 			if (txo) {
+				tx = bitcoin_block_tx(blk, i);
 				wallet_transaction_add(topo->ld->wallet,
 						       tx->wtx, b->height, i);
 				txowatch_fire(txo, tx, j, b);
@@ -84,24 +88,32 @@ static void filter_block_txs(struct chain_topology *topo, struct block *b)
 		}
 
 		owned = AMOUNT_SAT(0);
-		txid = b->txids[i];
-		if (txfilter_match(topo->bitcoind->ld->owned_txfilter, tx)) {
+		for (j = 0; j < btx->num_outputs; j++) {
+			const struct bitcoin_block_output *out
+				= &blk->outputs[btx->first_output + j];
+			if (!out->script_len)
+				continue;
+			if (!txfilter_scriptpubkey_matches(topo->bitcoind->ld->owned_txfilter,
+							   out->script,
+							   out->script_len))
+				continue;
+			tx = bitcoin_block_tx(blk, i);
 			wallet_extract_owned_outputs(topo->bitcoind->ld->wallet,
 						     tx->wtx, is_coinbase, &b->height, &owned);
 			wallet_transaction_add(topo->ld->wallet, tx->wtx,
 					       b->height, i);
+			break;
 		}
 
 		/* We did spends first, in case that tells us to watch tx. */
-		if (watching_txid(topo, &txid) || we_broadcast(topo, &txid)) {
+		if (watching_txid(topo, txid) || we_broadcast(topo, txid)) {
+			tx = bitcoin_block_tx(blk, i);
 			wallet_transaction_add(topo->ld->wallet,
 					       tx->wtx, b->height, i);
+			txwatch_inform(topo, txid, tx, b->height);
 		}
-
-		txwatch_inform(topo, &txid, tx);
 	}
-	b->full_txs = tal_free(b->full_txs);
-	b->txids = tal_free(b->txids);
+	b->blk = tal_free(b->blk);
 }
 
 size_t get_tx_depth(const struct chain_topology *topo,
@@ -147,6 +159,11 @@ static void broadcast_remainder(struct bitcoind *bitcoind,
 			   broadcast_remainder, txs);
 }
 
+/* A tx bitcoind has accepted (or refused) is probably still in its mempool
+ * (or still refused) next block, so back off exponentially up to this many
+ * blocks.  Penalty txs live here too, so don't make this too large. */
+#define MAX_REBROADCAST_BACKOFF 8
+
 /* FIXME: This is dumb.  We can group txs and avoid bothering bitcoind
  * if any one tx is in the main chain. */
 static void rebroadcast_txs(struct chain_topology *topo)
@@ -155,6 +172,7 @@ static void rebroadcast_txs(struct chain_topology *topo)
 	struct txs_to_broadcast *txs;
 	struct outgoing_tx *otx;
 	struct outgoing_tx_map_iter it;
+	u32 height = get_block_height(topo);
 
 	txs = tal(topo, struct txs_to_broadcast);
 	txs->cmd_id = tal_arr(txs, const char *, 0);
@@ -164,9 +182,14 @@ static void rebroadcast_txs(struct chain_topology *topo)
 
 	for (otx = outgoing_tx_map_first(topo->outgoing_txs, &it); otx;
 	     otx = outgoing_tx_map_next(topo->outgoing_txs, &it)) {
+		if (height < otx->rebroadcast_height)
+			continue;
 		if (wallet_transaction_height(topo->ld->wallet, &otx->txid))
 			continue;
 
+		otx->rebroadcast_height = height + otx->rebroadcast_backoff;
+		if (otx->rebroadcast_backoff < MAX_REBROADCAST_BACKOFF)
+			otx->rebroadcast_backoff *= 2;
 		tal_arr_expand(&txs->txs, tal_strdup(txs, otx->hextx));
 		tal_arr_expand(&txs->cmd_id,
 			       otx->cmd_id ? tal_strdup(txs, otx->cmd_id) : NULL);
@@ -214,6 +237,8 @@ static void broadcast_done(struct bitcoind *bitcoind,
 		tal_free(otx);
 	} else {
 		/* For continual rebroadcasting, until channel freed. */
+		otx->rebroadcast_height = get_block_height(bitcoind->ld->topology) + 1;
+		otx->rebroadcast_backoff = 1;
 		tal_steal(otx->channel, otx);
 		outgoing_tx_map_add(bitcoind->ld->topology->outgoing_txs, notleak(otx));
 		tal_add_destructor2(otx, destroy_outgoing_tx, bitcoind->ld->topology);
@@ -338,11 +363,14 @@ static void update_feerates(struct bitcoind *bitcoind,
 			    struct chain_topology *topo)
 {
 	u32 old_feerates[NUM_FEERATES];
+	u32 smoothing_secs = topo->ld->config.feerate_smoothing_secs;
 	/* Smoothing factor alpha for simple exponential smoothing. The goal is to
 	 * have the feerate account for 90 percent of the values polled in the last
-	 * 2 minutes. The following will do that in a polling interval
-	 * independent manner. */
-	double alpha = 1 - pow(0.1,(double)topo->poll_seconds / 120);
+	 * feerate-smoothing-time (default 2 minutes). The following will do that
+	 * in a polling interval independent manner. */
+	double alpha = smoothing_secs
+		? 1 - pow(0.1, (double)topo->poll_seconds / smoothing_secs)
+		: 1;
 	bool notify_feerate_changed = false;
 
 	for (size_t i = 0; i < NUM_FEERATES; i++) {
@@ -641,8 +669,8 @@ static void updates_complete(struct chain_topology *topo)
 }
 
 static void record_wallet_spend(struct lightningd *ld,
-				struct bitcoin_outpoint *outpoint,
-				struct bitcoin_txid *txid,
+				const struct bitcoin_outpoint *outpoint,
+				const struct bitcoin_txid *txid,
 				u32 tx_blockheight)
 {
 	struct utxo *utxo;
@@ -666,19 +694,19 @@ static void record_wallet_spend(struct lightningd *ld,
  */
 static void topo_update_spends(struct chain_topology *topo, struct block *b)
 {
+	const struct bitcoin_block *blk = b->blk;
 	const struct short_channel_id *spent_scids;
-	for (size_t i = 0; i < tal_count(b->full_txs); i++) {
-		const struct bitcoin_tx *tx = b->full_txs[i];
+	for (size_t i = 0; i < tal_count(blk->txs); i++) {
+		const struct bitcoin_block_tx *btx = &blk->txs[i];
 
-		for (size_t j = 0; j < tx->wtx->num_inputs; j++) {
-			struct bitcoin_outpoint outpoint;
-
-			bitcoin_tx_input_get_outpoint(tx, j, &outpoint);
+		for (size_t j = 0; j < btx->num_inputs; j++) {
+			const struct bitcoin_outpoint *outpoint
+				= &blk->inputs[btx->first_input + j];
 
 			if (wallet_outpoint_spend(topo->ld->wallet, tmpctx,
-						  b->height, &outpoint))
-				record_wallet_spend(topo->ld, &outpoint,
-						    &b->txids[i], b->height);
+						  b->height, outpoint))
+				record_wallet_spend(topo->ld, outpoint,
+						    &blk->txids[i], b->height);
 
 		}
 	}
@@ -692,25 +720,30 @@ static void topo_update_spends(struct chain_topology *topo, struct block *b)
 
 static void topo_add_utxos(struct chain_topology *topo, struct block *b)
 {
-	for (size_t i = 0; i < tal_count(b->full_txs); i++) {
-		const struct bitcoin_tx *tx = b->full_txs[i];
+	const struct bitcoin_block *blk = b->blk;
+
+	for (size_t i = 0; i < tal_count(blk->txs); i++) {
+		const struct bitcoin_block_tx *btx = &blk->txs[i];
 		struct bitcoin_outpoint outpoint;
 
-		bitcoin_txid(tx, &outpoint.txid);
+		outpoint.txid = blk->txids[i];
 		for (outpoint.n = 0;
-		     outpoint.n < tx->wtx->num_outputs;
+		     outpoint.n < btx->num_outputs;
 		     outpoint.n++) {
-			if (tx->wtx->outputs[outpoint.n].features
-			    & WALLY_TX_IS_COINBASE)
-				continue;
+			const struct bitcoin_block_output *out
+				= &blk->outputs[btx->first_output + outpoint.n];
+			u8 *script;
 
-			const u8 *script = bitcoin_tx_output_get_script(tmpctx, tx, outpoint.n);
-			struct amount_asset amt = bitcoin_tx_output_get_amount(tx, outpoint.n);
+			if (!out->is_main_asset
+			    || out->script_len != BITCOIN_SCRIPTPUBKEY_P2WSH_LEN)
+				continue;
 
-			if (amount_asset_is_main(&amt) && is_p2wsh(script, NULL)) {
+			script = tal_dup_arr(tmpctx, u8,
+					     out->script, out->script_len, 0);
+			if (is_p2wsh(script, NULL)) {
 				wallet_utxoset_add(topo->ld->wallet, &outpoint,
 						   b->height, i, script,
-						   amount_asset_to_sat(&amt));
+						   out->amount);
 			}
 		}
 	}
@@ -718,6 +751,8 @@ static void topo_add_utxos(struct chain_topology *topo, struct block *b)
 
 static void add_tip(struct chain_topology *topo, struct block *b)
 {
+	TRACE_PROBE2(block_add_start, b->height, tal_count(b->blk->txs));
+
 	/* Attach to tip; b is now the tip. */
 	assert(b->height == topo->tip->height + 1);
 	b->prev = topo->tip;
@@ -733,6 +768,8 @@ static void add_tip(struct chain_topology *topo, struct block *b)
 
 	block_map_add(topo->block_map, b);
 	topo->max_blockheight = b->height;
+
+	TRACE_PROBE1(block_add_end, b->height);
 }
 
 static struct block *new_block(struct chain_topology *topo,
@@ -753,90 +790,314 @@ static struct block *new_block(struct chain_topology *topo,
 
 	b->hdr = blk->hdr;
 
-	b->full_txs = tal_steal(b, blk->tx);
-	b->txids = tal_steal(b, blk->txids);
+	b->blk = tal_steal(b, blk);
 
 	return b;
 }
 
-static void remove_tip(struct chain_topology *topo)
+/* Roll back every block above fork, in one go. */
+static void remove_tips(struct chain_topology *topo, struct block *fork)
 {
-	struct block *b = topo->tip;
-	struct bitcoin_txid *txs;
-	size_t n;
-	const struct short_channel_id *removed_scids;
+	struct wallet *w = topo->ld->wallet;
+	const struct short_channel_id **removed_scids;
+	struct block *b;
+
+	log_debug(topo->log, "Reorg: rolling back %u blocks to %u: %s",
+		  topo->tip->height - fork->height, fork->height,
+		  type_to_string(tmpctx, struct bitcoin_blkid, &fork->blkid));
+	TRACE_PROBE2(block_reorg, topo->tip->height, fork->height);
+
+	removed_scids = tal_arr(tmpctx, const struct short_channel_id *, 0);
+	for (b = topo->tip; b != fork; b = b->prev) {
+		struct bitcoin_txid *txs;
+
+		txs = wallet_transactions_by_height(tmpctx, w, b->height);
+		/* Notify that txs are kicked out (their height will be set
+		 * NULL in db) */
+		for (size_t i = 0; i < tal_count(txs); i++)
+			txwatch_fire(topo, &txs[i], 0);
+
+		/* Grab these before we delete blocks from db */
+		tal_arr_expand(&removed_scids,
+			       wallet_utxoset_get_created(tmpctx, w, b->height));
+	}
+	wallet_blocks_rollback(w, fork->height);
+
+	/* These may have unconfirmed txs: reconfirm as we add blocks. */
+	watch_for_utxo_reconfirmation(topo, w);
 
-	log_debug(topo->log, "Removing stale block %u: %s",
-			  topo->tip->height,
+	for (size_t i = 0; topo->tip != fork; i++) {
+		b = topo->tip;
+		log_debug(topo->log, "Removing stale block %u: %s",
+			  b->height,
 			  type_to_string(tmpctx, struct bitcoin_blkid, &b->blkid));
+		topo->tip = b->prev;
+		block_map_del(topo->block_map, b);
+
+		/* These no longer exist, so gossipd drops any reference to
+		 * them just as if they were spent. */
+		gossipd_notify_spends(topo->bitcoind->ld, b->height,
+				      removed_scids[i]);
+		tal_free(b);
+	}
+}
 
-	/* Move tip back one. */
-	topo->tip = b->prev;
+/* How many blocks below our tip we ask about at once, looking for where
+ * the new chain forks from ours. */
+#define REORG_PROBE_MAX 8
+
+struct reorg_probe {
+	struct reorg *reorg;
+	u32 height;
+	/* What the new chain has at height (NULL if nothing) */
+	struct bitcoin_blkid *blkid;
+};
+
+struct reorg {
+	struct chain_topology *topo;
+	/* Descending heights, starting just below the tip. */
+	struct reorg_probe *probes;
+	size_t outstanding;
+};
 
-	if (!topo->tip)
+static void got_reorg_probe(struct bitcoind *bitcoind UNUSED,
+			    struct bitcoin_blkid *blkid,
+			    struct bitcoin_block *blk UNUSED,
+			    struct reorg_probe *probe)
+{
+	struct reorg *reorg = probe->reorg;
+	struct chain_topology *topo = reorg->topo;
+	struct block *b;
+
+	probe->blkid = tal_dup_or_null(reorg, struct bitcoin_blkid, blkid);
+	if (--reorg->outstanding)
+		return;
+
+	/* The highest block the new chain still agrees with is the fork
+	 * point; failing that, everything we asked about is stale too. */
+	b = topo->tip->prev;
+	for (size_t i = 0; i < tal_count(reorg->probes); i++, b = b->prev) {
+		assert(b->height == reorg->probes[i].height);
+		if (reorg->probes[i].blkid
+		    && bitcoin_blkid_eq(reorg->probes[i].blkid, &b->blkid))
+			break;
+		if (!b->prev)
+			fatal("Initial block %u (%s) reorganized out!",
+			      b->height,
+			      type_to_string(tmpctx, struct bitcoin_blkid,
+					     &b->blkid));
+	}
+	tal_free(reorg);
+
+	remove_tips(topo, b);
+	try_extend_tip(topo);
+}
+
+/* The next block doesn't follow our tip: ask for the blocks below it to
+ * find out how far back the new chain forks from ours. */
+static void start_reorg(struct chain_topology *topo)
+{
+	struct reorg *reorg;
+	size_t n = 0;
+
+	if (!topo->tip->prev)
 		fatal("Initial block %u (%s) reorganized out!",
-		      b->height,
-		      type_to_string(tmpctx, struct bitcoin_blkid, &b->blkid));
+		      topo->tip->height,
+		      type_to_string(tmpctx, struct bitcoin_blkid,
+				     &topo->tip->blkid));
+
+	for (struct block *b = topo->tip->prev;
+	     b && n < REORG_PROBE_MAX;
+	     b = b->prev)
+		n++;
+
+	reorg = tal(topo, struct reorg);
+	reorg->topo = topo;
+	reorg->probes = tal_arr(reorg, struct reorg_probe, n);
+	reorg->outstanding = n;
+	for (size_t i = 0; i < n; i++) {
+		reorg->probes[i].reorg = reorg;
+		reorg->probes[i].height = topo->tip->height - 1 - i;
+		reorg->probes[i].blkid = NULL;
+		bitcoind_getrawblockbyheight(topo->bitcoind,
+					     reorg->probes[i].height,
+					     got_reorg_probe,
+					     &reorg->probes[i]);
+	}
+}
 
-	txs = wallet_transactions_by_height(b, topo->ld->wallet, b->height);
-	n = tal_count(txs);
+/* We keep up to this many getrawblockbyheight requests in flight while
+ * catching up, so we're not bound by the backend's latency. */
+#define BLOCK_PREFETCH_MAX 8
 
-	/* Notify that txs are kicked out (their height will be set NULL in db) */
-	for (size_t i = 0; i < n; i++)
-		txwatch_fire(topo, &txs[i], 0);
+/* A block we asked for, in height order in topo->block_fetches */
+struct block_fetch {
+	struct list_node list;
+	struct chain_topology *topo;
+	u32 height;
+	/* Has the answer come back? */
+	bool done;
+	/* Removed from the list: just free when answer comes. */
+	bool stale;
+	/* NULL if there's no such block (yet). */
+	struct bitcoin_blkid *blkid;
+	struct bitcoin_block *blk;
+	/* With use-blockfilters: if set, blk is only the header. */
+	const u8 *filter;
+};
 
-	/* Grab these before we delete block from db */
-	removed_scids = wallet_utxoset_get_created(tmpctx, topo->ld->wallet,
-						   b->height);
-	wallet_block_remove(topo->ld->wallet, b);
+/* Abandon all outstanding fetches: the tip moved, or there's no more. */
+static void discard_block_fetches(struct chain_topology *topo)
+{
+	struct block_fetch *f;
 
-	/* This may have unconfirmed txs: reconfirm as we add blocks. */
-	watch_for_utxo_reconfirmation(topo, topo->ld->wallet);
-	block_map_del(topo->block_map, b);
+	while ((f = list_pop(&topo->block_fetches, struct block_fetch, list))) {
+		if (f->done)
+			tal_free(f);
+		else
+			f->stale = true;
+	}
+}
+
+/* Could this block contain anything we care about?  We only ask once
+ * we've processed all the blocks before it, since they can add watches. */
+static bool blockfilter_matches(struct chain_topology *topo,
+				const struct block_fetch *f)
+{
+	const u8 **scripts;
 
-	/* These no longer exist, so gossipd drops any reference to them just
-	 * as if they were spent. */
-	gossipd_notify_spends(topo->bitcoind->ld, b->height, removed_scids);
-	tal_free(b);
+	/* The utxoset (public channel funding outputs): topo_update_spends
+	 * needs to see them spent, to tell gossipd the channel closed. */
+	scripts = wallet_utxoset_unspent_scripts(tmpctx, topo->ld->wallet);
+	if (!watch_scripts(topo, &scripts))
+		return true;
+	txfilter_append_scripts(topo->ld->owned_txfilter, &scripts);
+
+	return blockfilter_match_any(f->blkid, f->filter,
+				     tal_bytelen(f->filter), scripts);
 }
 
 static void get_new_block(struct bitcoind *bitcoind,
 			  struct bitcoin_blkid *blkid,
 			  struct bitcoin_block *blk,
-			  struct chain_topology *topo)
+			  struct block_fetch *f);
+
+/* Process fetched blocks in order, as long as we have the next one. */
+static void process_block_fetches(struct chain_topology *topo)
 {
-	if (!blkid && !blk) {
-		/* No such block, we're done. */
-		updates_complete(topo);
-		return;
-	}
-	assert(blkid && blk);
+	struct block_fetch *f;
+
+	while ((f = list_top(&topo->block_fetches, struct block_fetch, list))
+	       && f->done) {
+		if (!f->blkid) {
+			/* No such block, we're done. */
+			discard_block_fetches(topo);
+			updates_complete(topo);
+			return;
+		}
 
-	/* Annotate all transactions with the chainparams */
-	for (size_t i = 0; i < tal_count(blk->tx); i++)
-		blk->tx[i]->chainparams = chainparams;
+		/* Unexpected predecessor?  Find the fork, roll back to it,
+		 * then fetch from there. */
+		if (f->height != topo->tip->height + 1
+		    || !bitcoin_blkid_eq(&topo->tip->blkid,
+					 &f->blk->hdr.prev_hash)) {
+			discard_block_fetches(topo);
+			start_reorg(topo);
+			return;
+		}
 
-	/* Unexpected predecessor?  Free predecessor, refetch it. */
-	if (!bitcoin_blkid_eq(&topo->tip->blkid, &blk->hdr.prev_hash))
-		remove_tip(topo);
-	else {
-		add_tip(topo, new_block(topo, blk, topo->tip->height + 1));
+		/* Interesting?  We need the whole thing after all. */
+		if (f->filter && blockfilter_matches(topo, f)) {
+			log_debug(topo->log, "Block filter for %u matched",
+				  f->height);
+			f->done = false;
+			f->filter = tal_free(f->filter);
+			f->blkid = tal_free(f->blkid);
+			f->blk = tal_free(f->blk);
+			bitcoind_getrawblockbyheight(topo->bitcoind, f->height,
+						     get_new_block, f);
+			return;
+		}
+
+		list_del_from(&topo->block_fetches, &f->list);
+		tal_steal(tmpctx, f);
+
+		add_tip(topo, new_block(topo, f->blk, topo->tip->height + 1));
 
 		/* tell plugins a new block was processed */
 		notify_block_added(topo->ld, topo->tip);
 	}
 
-	/* Try for next one. */
+	/* Try for next ones. */
 	try_extend_tip(topo);
 }
 
+static void get_new_block_or_filter(struct bitcoind *bitcoind,
+				    struct bitcoin_blkid *blkid,
+				    struct bitcoin_block *blk,
+				    const u8 *filter,
+				    struct block_fetch *f)
+{
+	if (f->stale) {
+		tal_free(f);
+		return;
+	}
+
+	f->done = true;
+	if (!blkid && !blk) {
+		f->blkid = NULL;
+		f->blk = NULL;
+	} else {
+		assert(blkid && blk);
+		f->blkid = tal_dup(f, struct bitcoin_blkid, blkid);
+		f->blk = tal_steal(f, blk);
+	}
+	f->filter = tal_dup_talarr(f, u8, filter);
+
+	process_block_fetches(f->topo);
+}
+
+static void get_new_block(struct bitcoind *bitcoind,
+			  struct bitcoin_blkid *blkid,
+			  struct bitcoin_block *blk,
+			  struct block_fetch *f)
+{
+	get_new_block_or_filter(bitcoind, blkid, blk, NULL, f);
+}
+
 static void try_extend_tip(struct chain_topology *topo)
 {
+	struct block_fetch *last;
+	u32 next;
+
 	topo->extend_timer = NULL;
 	if (topo->stopping)
 		return;
-	bitcoind_getrawblockbyheight(topo->bitcoind, topo->tip->height + 1,
-				     get_new_block, topo);
+
+	last = list_tail(&topo->block_fetches, struct block_fetch, list);
+	next = last ? last->height + 1 : topo->tip->height + 1;
+
+	/* Always ask for the next block; only ask for more than one if we
+	 * know they exist. */
+	while (list_empty(&topo->block_fetches)
+	       || (next <= topo->headercount
+		   && next <= topo->tip->height + BLOCK_PREFETCH_MAX)) {
+		struct block_fetch *f = tal(topo, struct block_fetch);
+
+		f->topo = topo;
+		f->height = next++;
+		f->done = f->stale = false;
+		f->filter = NULL;
+		list_add_tail(&topo->block_fetches, &f->list);
+		if (topo->ld->config.use_blockfilters)
+			bitcoind_getblockfilterbyheight(topo->bitcoind,
+							f->height,
+							get_new_block_or_filter,
+							f);
+		else
+			bitcoind_getrawblockbyheight(topo->bitcoind, f->height,
+						     get_new_block, f);
+	}
 }
 
 static void init_topo(struct bitcoind *bitcoind UNUSED,
@@ -845,6 +1106,8 @@ static void init_topo(struct bitcoind *bitcoind UNUSED,
 		      struct chain_topology *topo)
 {
 	topo->root = new_block(topo, blk, topo->max_blockheight);
+	/* We never look at the root block's transactions. */
+	topo->root->blk = tal_free(topo->root->blk);
 	block_map_add(topo->block_map, topo->root);
 	topo->tip = topo->root;
 	topo->prev_tip = topo->tip->blkid;
@@ -969,6 +1232,7 @@ struct chain_topology *new_topology(struct lightningd *ld, struct log *log)
 	topo->extend_timer = NULL;
 	topo->stopping = false;
 	list_head_init(topo->sync_waiters);
+	list_head_init(&topo->block_fetches);
 
 	return topo;
 }
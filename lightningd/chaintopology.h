@@ -23,6 +23,8 @@ struct outgoing_tx {
 	struct bitcoin_txid txid;
 	const char *cmd_id;
 	void (*failed_or_success)(struct channel *channel, bool success, const char *err);
+	/* Don't rebroadcast until this block, then wait twice as long. */
+	u32 rebroadcast_height, rebroadcast_backoff;
 };
 
 struct block {
@@ -40,9 +42,8 @@ struct block {
 	/* Key for hash table */
 	struct bitcoin_blkid blkid;
 
-	/* Full copy of txs (freed in filter_block_txs) */
-	struct bitcoin_tx **full_txs;
-	struct bitcoin_txid *txids;
+	/* The parsed block (freed in filter_block_txs) */
+	struct bitcoin_block *blk;
 };
 
 /* Hash blocks by sha */
@@ -128,6 +129,9 @@ struct chain_topology {
 
 	/* Are we stopped? */
 	bool stopping;
+
+	/* struct block_fetch, blocks we've requested, in height order. */
+	struct list_head block_fetches;
 };
 
 /* Information relevant to locating a TX in a blockchain. */
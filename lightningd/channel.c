@@ -15,6 +15,7 @@
 #include <lightningd/notification.h>
 #include <lightningd/opening_common.h>
 #include <lightningd/peer_control.h>
+#include <lightningd/routehint.h>
 #include <lightningd/subd.h>
 #include <wallet/txfilter.h>
 #include <wire/peer_wire.h>
@@ -206,6 +207,7 @@ struct channel *new_unsaved_channel(struct peer *peer,
 	channel->unsaved_dbid = wallet_get_channel_dbid(ld->wallet);
 	/* A zero value database id means it's not saved in the database yet */
 	channel->dbid = 0;
+	channel->change_index = ++ld->channel_change_index;
 	channel->error = NULL;
 	channel->openchannel_signed_cmd = NULL;
 	channel->state = DUALOPEND_OPEN_INIT;
@@ -223,6 +225,7 @@ struct channel *new_unsaved_channel(struct peer *peer,
 	channel->open_attempt = NULL;
 
 	channel->last_htlc_sigs = NULL;
+	channel->last_tx_unloaded = false;
 	channel->remote_channel_ready = false;
 	channel->scid = NULL;
 	channel->next_index[LOCAL] = 1;
@@ -401,6 +404,7 @@ struct channel *new_channel(struct peer *peer, u64 dbid,
 	channel->peer = peer;
 	channel->dbid = dbid;
 	channel->unsaved_dbid = 0;
+	channel->change_index = ++peer->ld->channel_change_index;
 	channel->error = NULL;
 	channel->open_attempt = NULL;
 	channel->openchannel_signed_cmd = NULL;
@@ -459,6 +463,7 @@ struct channel *new_channel(struct peer *peer, u64 dbid,
 	}
 	channel->last_sig = *last_sig;
 	channel->last_htlc_sigs = tal_steal(channel, last_htlc_sigs);
+	channel->last_tx_unloaded = false;
 	channel->channel_info = *channel_info;
 	channel->fee_states = dup_fee_states(channel, fee_states);
 	channel->shutdown_scriptpubkey[REMOTE]
@@ -732,6 +737,45 @@ void channel_set_last_tx(struct channel *channel,
 	channel->last_sig = *sig;
 	tal_free(channel->last_tx);
 	channel->last_tx = tal_steal(channel, tx);
+	channel->last_tx_unloaded = false;
+}
+
+void channel_unload_last_tx(struct channel *channel)
+{
+	/* Stub channels never had one. */
+	if (!channel->last_tx)
+		return;
+
+	channel->last_tx = tal_free(channel->last_tx);
+	channel->last_htlc_sigs = tal_free(channel->last_htlc_sigs);
+	channel->last_tx_unloaded = true;
+}
+
+struct bitcoin_tx *channel_last_tx(const struct channel *channel)
+{
+	if (!channel->last_tx_unloaded)
+		return channel->last_tx;
+
+	return wallet_channel_last_tx_load(tmpctx, channel->peer->ld->wallet,
+					   channel->dbid);
+}
+
+const struct bitcoin_signature *channel_last_htlc_sigs(const struct channel *channel)
+{
+	if (!channel->last_tx_unloaded)
+		return channel->last_htlc_sigs;
+
+	return wallet_htlc_sigs_load(tmpctx, channel->peer->ld->wallet,
+				     channel->dbid,
+				     channel_has(channel, OPT_ANCHOR_OUTPUTS));
+}
+
+void channel_changed(struct channel *channel)
+{
+	struct lightningd *ld = channel->peer->ld;
+
+	channel->change_index = ++ld->channel_change_index;
+	notify_channel_changed(ld, channel);
 }
 
 void channel_set_state(struct channel *channel,
@@ -763,9 +807,11 @@ void channel_set_state(struct channel *channel,
 		      channel_state_name(channel), channel_state_str(old_state));
 
 	channel->state = state;
+	routehint_cache_invalidate(channel->peer->ld);
 
 	/* TODO(cdecker) Selectively save updated fields to DB */
 	wallet_channel_save(channel->peer->ld->wallet, channel);
+	channel_changed(channel);
 
 	/* plugin notification channel_state_changed and DB entry */
 	if (state != old_state) {  /* see issue #4029 */
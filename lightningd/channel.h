@@ -94,6 +94,9 @@ struct channel {
 	/* Populated by new_unsaved_channel */
 	u64 unsaved_dbid;
 
+	/* When we last changed, from ld->channel_change_index. */
+	u64 change_index;
+
 	/* Error message (iff in error state) */
 	u8 *error;
 
@@ -165,6 +168,9 @@ struct channel {
 	struct bitcoin_tx *last_tx;
 	struct bitcoin_signature last_sig;
 	const struct bitcoin_signature *last_htlc_sigs;
+	/* Once onchaind has them, last_tx and last_htlc_sigs only live in
+	 * the db: use channel_last_tx() / channel_last_htlc_sigs(). */
+	bool last_tx_unloaded;
 
 	/* Keys for channel */
 	struct channel_info channel_info;
@@ -398,6 +404,9 @@ void channel_internal_error(struct channel *channel, const char *fmt, ...);
 /* Clean up any in-progress commands for a channel */
 void channel_cleanup_commands(struct channel *channel, const char *why);
 
+/* Something listpeerchannels shows changed: bump change_index and notify. */
+void channel_changed(struct channel *channel);
+
 void channel_set_state(struct channel *channel,
 		       enum channel_state old_state,
 		       enum channel_state state,
@@ -442,6 +451,16 @@ void channel_set_last_tx(struct channel *channel,
 			 struct bitcoin_tx *tx,
 			 const struct bitcoin_signature *sig);
 
+/* Onchain channels don't need their (large) last commitment tx and
+ * HTLC signatures in memory: drop them, they're still in the db. */
+void channel_unload_last_tx(struct channel *channel);
+
+/* Get last_tx: if it was unloaded, this is a fresh copy off tmpctx. */
+struct bitcoin_tx *channel_last_tx(const struct channel *channel);
+
+/* Likewise, for last_htlc_sigs. */
+const struct bitcoin_signature *channel_last_htlc_sigs(const struct channel *channel);
+
 static inline bool channel_can_add_htlc(const struct channel *channel)
 {
 	return channel->state == CHANNELD_NORMAL;
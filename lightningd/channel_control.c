@@ -706,6 +706,9 @@ bool peer_start_channeld(struct channel *channel,
 		return false;
 	}
 
+	/* Don't hand channeld penalty bases it can never use. */
+	wallet_penalty_base_delete_revoked(ld->wallet, channel->dbid,
+					   num_revocations);
 	pbases = wallet_penalty_base_load_for_channel(
 	    tmpctx, channel->peer->ld->wallet, channel->dbid);
 
@@ -753,6 +756,7 @@ bool peer_start_channeld(struct channel *channel,
 				       &ld->id,
 				       &channel->peer->id,
 				       cfg->commit_time_ms,
+				       cfg->commit_batch_ms,
 				       cfg->cltv_expiry_delta,
 				       channel->last_was_revoke,
 				       channel->last_sent_commit,
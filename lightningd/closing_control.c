@@ -54,11 +54,12 @@ static void
 resolve_one_close_command(struct close_command *cc, bool cooperative)
 {
 	struct json_stream *result = json_stream_success(cc->cmd);
+	const struct bitcoin_tx *last_tx = channel_last_tx(cc->channel);
 
-	json_add_tx(result, "tx", cc->channel->last_tx);
-	if (!invalid_last_tx(cc->channel->last_tx)) {
+	json_add_tx(result, "tx", last_tx);
+	if (!invalid_last_tx(last_tx)) {
 		struct bitcoin_txid txid;
-		bitcoin_txid(cc->channel->last_tx, &txid);
+		bitcoin_txid(last_tx, &txid);
 		json_add_txid(result, "txid", &txid);
 	}
 	if (cooperative)
@@ -311,6 +311,7 @@ static void try_connect(const tal_t *ctx,
 {
 	struct delayed_reconnect *d;
 	struct peer *peer;
+	u64 fuzz_usec;
 
 	/* Don't stack, unless this is an instant reconnect */
 	d = delayed_reconnect_map_get(ld->delayed_reconnect_map, id);
@@ -354,10 +355,14 @@ static void try_connect(const tal_t *ctx,
 	}
 
 	/* We fuzz the timer by up to 1 second, to avoid getting into
-	 * simultanous-reconnect deadlocks with peer. */
+	 * simultanous-reconnect deadlocks with peer.  For longer delays
+	 * we fuzz by up to a quarter of the delay: otherwise peers which
+	 * all disconnected at once (e.g. we lost network) back off in
+	 * lockstep and all retry within the same second, every time. */
+	fuzz_usec = seconds_delay > 4 ? seconds_delay * 250000ULL : 1000000;
 	notleak(new_reltimer(ld->timers, d,
 			     timerel_add(time_from_sec(seconds_delay),
-					 time_from_usec(pseudorand(1000000))),
+					 time_from_usec(pseudorand(fuzz_usec))),
 			     do_connect, d));
 }
 
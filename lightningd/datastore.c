@@ -121,28 +121,25 @@ static char *datastore_key_fmt(const tal_t *ctx, const char **key)
 	return ret;
 }
 
-static struct command_result *json_datastore(struct command *cmd,
-					     const char *buffer,
-					     const jsmntok_t *obj UNNEEDED,
-					     const jsmntok_t *params)
-{
-	struct json_stream *response;
-	const char **key, *strdata, **k;
+/* One datastore update: checked first, then applied. */
+struct datastore_op {
+	const char **key;
 	u8 *data;
+	enum ds_mode mode;
+	u64 *generation;
+	/* Filled in by datastore_op_check */
 	const u8 *prevdata;
-	enum ds_mode *mode;
-	u64 *generation, actual_gen;
-	struct db_stmt *stmt;
-
-	if (!param(cmd, buffer, params,
-		   p_req("key", param_list_or_string, &key),
-		   p_opt("string", param_escaped_string, &strdata),
-		   p_opt("hex", param_bin_from_hex, &data),
-		   p_opt_def("mode", param_mode, &mode, DS_MUST_NOT_EXIST),
-		   p_opt("generation", param_u64, &generation),
-		   NULL))
-		return command_param_failed();
+	u64 actual_gen;
+};
 
+static struct command_result *datastore_op_init(struct command *cmd,
+						struct datastore_op *op,
+						const char **key,
+						const char *strdata,
+						u8 *data,
+						enum ds_mode mode,
+						u64 *generation)
+{
 	if (strdata) {
 		if (data)
 			return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
@@ -154,32 +151,45 @@ static struct command_result *json_datastore(struct command *cmd,
 					    "Must have either hex or string");
 	}
 
-	if (generation && !(*mode & DS_MUST_EXIST))
+	if (generation && !(mode & DS_MUST_EXIST))
 		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
 				    "generation only valid with must-replace"
 				    " or must-append");
 
+	op->key = key;
+	op->data = data;
+	op->mode = mode;
+	op->generation = generation;
+	return NULL;
+}
+
+static struct command_result *datastore_op_check(struct command *cmd,
+						 struct datastore_op *op)
+{
+	const char **k;
+	struct db_stmt *stmt;
+
 	/* Fetch, and make sure we don't have children! */
-	stmt = wallet_datastore_first(cmd, cmd->ld->wallet, key,
-				      &k, &prevdata, &actual_gen);
+	stmt = wallet_datastore_first(cmd, cmd->ld->wallet, op->key,
+				      &k, &op->prevdata, &op->actual_gen);
 	tal_free(stmt);
 
 	/* We use prevdata as a "does it exist?" flag */
 	if (!stmt)
-		prevdata = NULL;
-	else if (!datastore_key_eq(k, key)) {
-		prevdata = tal_free(prevdata);
+		op->prevdata = NULL;
+	else if (!datastore_key_eq(k, op->key)) {
+		op->prevdata = tal_free(op->prevdata);
 		/* Make sure we don't have a child! */
-		if (datastore_key_startswith(k, key))
+		if (datastore_key_startswith(k, op->key))
 			return command_fail(cmd, DATASTORE_UPDATE_HAS_CHILDREN,
 					    "Key has children already");
 	}
 
 	/* We have to make sure that parents don't exist. */
-	if (!prevdata) {
-		for (size_t i = 1; i < tal_count(key); i++) {
+	if (!op->prevdata) {
+		for (size_t i = 1; i < tal_count(op->key); i++) {
 			const char **parent;
-			parent = tal_dup_arr(cmd, const char *, key, i, 0);
+			parent = tal_dup_arr(cmd, const char *, op->key, i, 0);
 
 			stmt = wallet_datastore_first(cmd, cmd->ld->wallet,
 						      parent, &k, NULL, NULL);
@@ -193,36 +203,163 @@ static struct command_result *json_datastore(struct command *cmd,
 		}
 	}
 
-	if ((*mode & DS_MUST_NOT_EXIST) && prevdata)
+	if ((op->mode & DS_MUST_NOT_EXIST) && op->prevdata)
 		return command_fail(cmd, DATASTORE_UPDATE_ALREADY_EXISTS,
 				    "Key already exists");
 
-	if ((*mode & DS_MUST_EXIST) && !prevdata)
+	if ((op->mode & DS_MUST_EXIST) && !op->prevdata)
 		return command_fail(cmd, DATASTORE_UPDATE_DOES_NOT_EXIST,
 				    "Key does not exist");
 
-	if (generation && actual_gen != *generation)
+	if (op->generation && op->actual_gen != *op->generation)
 		return command_fail(cmd, DATASTORE_UPDATE_WRONG_GENERATION,
 				    "generation is different");
 
-	if ((*mode & DS_APPEND) && prevdata) {
-		size_t prevlen = tal_bytelen(prevdata);
-		u8 *newdata = tal_arr(cmd, u8, prevlen + tal_bytelen(data));
-		memcpy(newdata, prevdata, prevlen);
-		memcpy(newdata + prevlen, data, tal_bytelen(data));
-		data = newdata;
+	return NULL;
+}
+
+static void datastore_op_apply(struct command *cmd, struct datastore_op *op)
+{
+	if ((op->mode & DS_APPEND) && op->prevdata) {
+		size_t prevlen = tal_bytelen(op->prevdata);
+		u8 *newdata = tal_arr(cmd, u8,
+				      prevlen + tal_bytelen(op->data));
+		memcpy(newdata, op->prevdata, prevlen);
+		memcpy(newdata + prevlen, op->data, tal_bytelen(op->data));
+		op->data = newdata;
 	}
 
-	if (prevdata) {
-		wallet_datastore_update(cmd->ld->wallet, key, data);
-		actual_gen++;
+	if (op->prevdata) {
+		wallet_datastore_update(cmd->ld->wallet, op->key, op->data);
+		op->actual_gen++;
 	} else {
-		wallet_datastore_create(cmd->ld->wallet, key, data);
-		actual_gen = 0;
+		wallet_datastore_create(cmd->ld->wallet, op->key, op->data);
+		op->actual_gen = 0;
 	}
+}
+
+static struct command_result *json_datastore(struct command *cmd,
+					     const char *buffer,
+					     const jsmntok_t *obj UNNEEDED,
+					     const jsmntok_t *params)
+{
+	struct json_stream *response;
+	const char **key, *strdata;
+	u8 *data;
+	enum ds_mode *mode;
+	u64 *generation;
+	struct datastore_op *op = tal(cmd, struct datastore_op);
+	struct command_result *ret;
+
+	if (!param(cmd, buffer, params,
+		   p_req("key", param_list_or_string, &key),
+		   p_opt("string", param_escaped_string, &strdata),
+		   p_opt("hex", param_bin_from_hex, &data),
+		   p_opt_def("mode", param_mode, &mode, DS_MUST_NOT_EXIST),
+		   p_opt("generation", param_u64, &generation),
+		   NULL))
+		return command_param_failed();
+
+	ret = datastore_op_init(cmd, op, key, strdata, data, *mode,
+				generation);
+	if (ret)
+		return ret;
+
+	ret = datastore_op_check(cmd, op);
+	if (ret)
+		return ret;
+
+	datastore_op_apply(cmd, op);
 
 	response = json_stream_success(cmd);
-	json_add_datastore(response, key, data, actual_gen);
+	json_add_datastore(response, op->key, op->data, op->actual_gen);
+	return command_success(cmd, response);
+}
+
+static struct command_result *param_datastore_ops(struct command *cmd,
+						  const char *name,
+						  const char *buffer,
+						  const jsmntok_t *tok,
+						  struct datastore_op **ops)
+{
+	size_t i;
+	const jsmntok_t *t;
+
+	if (tok->type != JSMN_ARRAY || tok->size == 0)
+		return command_fail_badparam(cmd, name, buffer, tok,
+					     "should be a non-empty array");
+
+	*ops = tal_arr(cmd, struct datastore_op, tok->size);
+	json_for_each_arr(i, t, tok) {
+		const char **key, *strdata;
+		u8 *data;
+		enum ds_mode *mode;
+		u64 *generation;
+		struct command_result *ret;
+
+		if (!param(cmd, buffer, t,
+			   p_req("key", param_list_or_string, &key),
+			   p_opt("string", param_escaped_string, &strdata),
+			   p_opt("hex", param_bin_from_hex, &data),
+			   p_opt_def("mode", param_mode, &mode,
+				     DS_MUST_NOT_EXIST),
+			   p_opt("generation", param_u64, &generation),
+			   NULL))
+			return command_param_failed();
+
+		ret = datastore_op_init(cmd, &(*ops)[i], key, strdata, data,
+					*mode, generation);
+		if (ret)
+			return ret;
+	}
+	return NULL;
+}
+
+static struct command_result *json_datastorebatch(struct command *cmd,
+						  const char *buffer,
+						  const jsmntok_t *obj UNNEEDED,
+						  const jsmntok_t *params)
+{
+	struct json_stream *response;
+	struct datastore_op *ops;
+	struct command_result *ret;
+
+	if (!param(cmd, buffer, params,
+		   p_req("entries", param_datastore_ops, &ops),
+		   NULL))
+		return command_param_failed();
+
+	/* Each is checked against the db alone, so they mustn't interact. */
+	for (size_t i = 0; i < tal_count(ops); i++) {
+		for (size_t j = i + 1; j < tal_count(ops); j++) {
+			if (datastore_key_startswith(ops[i].key, ops[j].key)
+			    || datastore_key_startswith(ops[j].key, ops[i].key))
+				return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+						    "Keys %s and %s overlap",
+						    datastore_key_fmt(tmpctx,
+								      ops[i].key),
+						    datastore_key_fmt(tmpctx,
+								      ops[j].key));
+		}
+	}
+
+	/* Failing doesn't undo db changes, so check all before any. */
+	for (size_t i = 0; i < tal_count(ops); i++) {
+		ret = datastore_op_check(cmd, &ops[i]);
+		if (ret)
+			return ret;
+	}
+
+	response = json_stream_success(cmd);
+	json_array_start(response, "datastore");
+	for (size_t i = 0; i < tal_count(ops); i++) {
+		datastore_op_apply(cmd, &ops[i]);
+		json_object_start(response, NULL);
+		json_add_datastore(response, ops[i].key, ops[i].data,
+				   ops[i].actual_gen);
+		json_object_end(response);
+	}
+	json_array_end(response);
 	return command_success(cmd, response);
 }
 
@@ -232,7 +369,7 @@ static struct command_result *json_listdatastore(struct command *cmd,
 						 const jsmntok_t *params)
 {
 	struct json_stream *response;
-	const char **key, **k, **prev_k = NULL;
+	const char **key, **k;
 	const u8 *data;
 	u64 generation;
 	struct db_stmt *stmt;
@@ -249,40 +386,99 @@ static struct command_result *json_listdatastore(struct command *cmd,
 	response = json_stream_success(cmd);
 	json_array_start(response, "datastore");
 
-	for (stmt = wallet_datastore_first(cmd, cmd->ld->wallet, key,
-					   &k, &data, &generation);
-	     stmt;
-	     stmt = wallet_datastore_next(cmd, cmd->ld->wallet,
-					  stmt, &k, &data,
-					  &generation)) {
+	stmt = wallet_datastore_first(cmd, cmd->ld->wallet, key,
+				      &k, &data, &generation);
+	while (stmt) {
 		log_debug(cmd->ld->log, "Got %s",
 			  datastore_key_fmt(tmpctx, k));
 
 		/* Don't list children, except implicitly */
 		if (tal_count(k) > tal_count(key) + 1) {
+			const char **child;
+
 			log_debug(cmd->ld->log, "Too long");
-			if (!prev_k || !datastore_key_startswith(k, prev_k)) {
-				prev_k = tal_dup_arr(cmd, const char *, k,
-						     tal_count(key) + 1, 0);
-				json_object_start(response, NULL);
-				json_add_datastore(response, prev_k, NULL, 0);
-				json_object_end(response);
-			}
-		} else if (key && !datastore_key_startswith(k, key)) {
-			log_debug(cmd->ld->log, "Not interested");
+			child = tal_dup_arr(cmd, const char *, k,
+					    tal_count(key) + 1, 0);
+			json_object_start(response, NULL);
+			json_add_datastore(response, child, NULL, 0);
+			json_object_end(response);
+
+			/* Skip over the rest of its children. */
 			tal_free(stmt);
-			break;
+			stmt = wallet_datastore_after(cmd, cmd->ld->wallet,
+						      key, child,
+						      &k, &data, &generation);
 		} else {
 			log_debug(cmd->ld->log, "Printing");
 			json_object_start(response, NULL);
 			json_add_datastore(response, k, data, generation);
 			json_object_end(response);
+			stmt = wallet_datastore_next(cmd, cmd->ld->wallet,
+						     stmt, &k, &data,
+						     &generation);
 		}
 	}
 	json_array_end(response);
 	return command_success(cmd, response);
 }
 
+static struct command_result *param_keys(struct command *cmd,
+					 const char *name,
+					 const char *buffer,
+					 const jsmntok_t *tok,
+					 const char ****keys)
+{
+	size_t i;
+	const jsmntok_t *t;
+
+	if (tok->type != JSMN_ARRAY || tok->size == 0)
+		return command_fail_badparam(cmd, name, buffer, tok,
+					     "should be a non-empty array");
+
+	*keys = tal_arr(cmd, const char **, tok->size);
+	json_for_each_arr(i, t, tok) {
+		struct command_result *ret;
+
+		ret = param_list_or_string(cmd, name, buffer, t, &(*keys)[i]);
+		if (ret)
+			return ret;
+	}
+	return NULL;
+}
+
+static struct command_result *json_listdatastorebatch(struct command *cmd,
+						      const char *buffer,
+						      const jsmntok_t *obj UNNEEDED,
+						      const jsmntok_t *params)
+{
+	struct json_stream *response;
+	const char ***keys, **k;
+	const u8 *data;
+	u64 generation;
+	struct db_stmt *stmt;
+
+	if (!param(cmd, buffer, params,
+		   p_req("keys", param_keys, &keys),
+		   NULL))
+		return command_param_failed();
+
+	response = json_stream_success(cmd);
+	json_array_start(response, "datastore");
+	for (size_t i = 0; i < tal_count(keys); i++) {
+		stmt = wallet_datastore_first(cmd, cmd->ld->wallet, keys[i],
+					      &k, &data, &generation);
+		tal_free(stmt);
+		/* Only exact matches: listdatastore does children. */
+		if (!stmt || !datastore_key_eq(k, keys[i]))
+			continue;
+		json_object_start(response, NULL);
+		json_add_datastore(response, k, data, generation);
+		json_object_end(response);
+	}
+	json_array_end(response);
+	return command_success(cmd, response);
+}
+
 static struct command_result *json_deldatastore(struct command *cmd,
 						 const char *buffer,
 						 const jsmntok_t *obj UNNEEDED,
@@ -328,6 +524,14 @@ static const struct json_command datastore_command = {
 };
 AUTODATA(json_command, &datastore_command);
 
+static const struct json_command datastorebatch_command = {
+	"datastorebatch",
+	"utility",
+	json_datastorebatch,
+	"Add or update many {entries} in the data store at once",
+};
+AUTODATA(json_command, &datastorebatch_command);
+
 static const struct json_command deldatastore_command = {
 	"deldatastore",
 	"utility",
@@ -343,3 +547,11 @@ static const struct json_command listdatastore_command = {
 	"List the datastore, optionally only {key}",
 };
 AUTODATA(json_command, &listdatastore_command);
+
+static const struct json_command listdatastorebatch_command = {
+	"listdatastorebatch",
+	"utility",
+	json_listdatastorebatch,
+	"Get many {keys} from the data store at once",
+};
+AUTODATA(json_command, &listdatastorebatch_command);
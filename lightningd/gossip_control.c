@@ -18,6 +18,7 @@
 #include <lightningd/lightningd.h>
 #include <lightningd/peer_control.h>
 #include <lightningd/subd.h>
+#include <wallet/txfilter.h>
 
 static void got_txout(struct bitcoind *bitcoind,
 		      const struct bitcoin_tx_output *output,
@@ -68,6 +69,16 @@ static void got_filteredblock(struct bitcoind *bitcoind,
 	}
 
 	if (fbo) {
+		/* With block filters we have the header of most blocks, so
+		 * wallet_filteredblock_add() won't have added this to the
+		 * utxoset: do it now, so we notice when it's spent. */
+		if (bitcoind->ld->config.use_blockfilters
+		    && bitcoind->ld->topology->max_blockheight > fb->height
+		    && !outpointfilter_matches(bitcoind->ld->wallet->utxoset_outpoints,
+					       &fbo->outpoint))
+			wallet_utxoset_add(bitcoind->ld->wallet, &fbo->outpoint,
+					   fb->height, fbo->txindex,
+					   fbo->scriptPubKey, fbo->amount);
 		txo.amount = fbo->amount;
 		txo.script = (u8 *)fbo->scriptPubKey;
 		got_txout(bitcoind, &txo, scid);
@@ -96,11 +107,13 @@ static void get_txout(struct subd *gossip, const u8 *msg)
 			      towire_gossipd_get_txout_reply(
 				  scid, scid, op->sat, op->scriptpubkey));
 		tal_free(scid);
-	} else if (wallet_have_block(gossip->ld->wallet, blockheight)) {
+	} else if (!gossip->ld->config.use_blockfilters
+		   && wallet_have_block(gossip->ld->wallet, blockheight)) {
 		/* We should have known about this outpoint since its header
 		 * is in the DB. The fact that we don't means that this is
 		 * either a spent outpoint or an invalid one. Return a
-		 * failure. */
+		 * failure.  (With block filters, we skip most blocks, so
+		 * we don't know their outputs.) */
 		subd_send_msg(gossip, take(towire_gossipd_get_txout_reply(
 						   NULL, scid, AMOUNT_SAT(0), NULL)));
 		tal_free(scid);
@@ -263,7 +276,9 @@ void gossip_init(struct lightningd *ld, int connectd_fd)
 	    IFDEV(ld->dev_gossip_time ? &ld->dev_gossip_time: NULL, NULL),
 	    IFDEV(ld->dev_fast_gossip, false),
 	    IFDEV(ld->dev_fast_gossip_prune, false),
-	    ld->config.ip_discovery);
+	    ld->config.ip_discovery,
+	    ld->config.channel_update_rate,
+	    ld->config.gossip_fast_sync_peers);
 
 	subd_req(ld->gossip, ld->gossip, take(msg), -1, 0,
 		 gossipd_init_done, NULL);
@@ -1,6 +1,8 @@
 #include "config.h"
 #include <ccan/err/err.h>
 #include <ccan/fdpass/fdpass.h>
+#include <ccan/list/list.h>
+#include <common/daemon_conn.h>
 #include <common/ecdh.h>
 #include <common/errcode.h>
 #include <common/hsm_encryption.h>
@@ -11,6 +13,7 @@
 #include <common/jsonrpc_errors.h>
 #include <common/type_to_string.h>
 #include <errno.h>
+#include <hsmd/capabilities.h>
 #include <hsmd/hsmd_wiregen.h>
 #include <lightningd/hsm_control.h>
 #include <lightningd/jsonrpc.h>
@@ -77,6 +80,105 @@ static unsigned int hsm_msg(struct subd *hsmd,
 	return 0;
 }
 
+/*~ Most hsmd requests are synchronous, over ld->hsm_fd: fine for a local
+ * hsmd, but with a remote signer every one stalls us for a round trip.
+ * Requests whose answer can wait (e.g. for JSON commands) use their own
+ * hsmd connection instead, so we can pipeline them: hsmd answers each
+ * client's requests in order, so the oldest in flight gets each reply. */
+struct hsm_async {
+	struct lightningd *ld;
+	struct daemon_conn *dc;
+	struct list_head inflight;
+};
+
+struct hsm_async_req {
+	struct list_node list;
+	/* Freed (and cb cleared) if the caller's ctx goes away */
+	struct hsm_async_owner *owner;
+	void (*cb)(struct lightningd *ld, const u8 *reply, void *arg);
+	void *arg;
+};
+
+struct hsm_async_owner {
+	struct hsm_async_req *req;
+};
+
+static void destroy_hsm_async_owner(struct hsm_async_owner *owner)
+{
+	owner->req->owner = NULL;
+	owner->req->cb = NULL;
+}
+
+static void destroy_hsm_async_req(struct hsm_async_req *req)
+{
+	if (req->owner) {
+		tal_del_destructor(req->owner, destroy_hsm_async_owner);
+		tal_free(req->owner);
+	}
+}
+
+static struct io_plan *hsm_async_reply(struct io_conn *conn,
+				       const u8 *msg,
+				       struct hsm_async *async)
+{
+	struct hsm_async_req *req;
+
+	req = list_pop(&async->inflight, struct hsm_async_req, list);
+	if (!req)
+		fatal("Unexpected reply from HSM: %s", tal_hex(tmpctx, msg));
+
+	tal_steal(tmpctx, req);
+	if (req->cb)
+		req->cb(async->ld, msg, req->arg);
+	return daemon_conn_read_next(conn, async->dc);
+}
+
+void hsm_req_(const tal_t *ctx,
+	      struct lightningd *ld,
+	      const u8 *msg TAKES,
+	      void (*cb)(struct lightningd *, const u8 *, void *),
+	      void *arg)
+{
+	struct hsm_async_req *req = tal(ld->hsm_async, struct hsm_async_req);
+
+	req->cb = cb;
+	req->arg = arg;
+	req->owner = tal(ctx, struct hsm_async_owner);
+	req->owner->req = req;
+	tal_add_destructor(req->owner, destroy_hsm_async_owner);
+	tal_add_destructor(req, destroy_hsm_async_req);
+	list_add_tail(&ld->hsm_async->inflight, &req->list);
+
+	daemon_conn_send(ld->hsm_async->dc, take(msg));
+}
+
+/* As with a failed read on ld->hsm_fd: nothing in flight can be answered. */
+static void hsm_async_gone(struct daemon_conn *dc UNUSED)
+{
+	fatal("HSM connection closed unexpectedly");
+}
+
+static void destroy_hsm_async(struct hsm_async *async)
+{
+	/* We're shutting down: closing our end is expected. */
+	tal_del_destructor(async->dc, hsm_async_gone);
+	tal_free(async->dc);
+}
+
+static struct hsm_async *hsm_async_new(struct lightningd *ld)
+{
+	struct hsm_async *async = tal(ld, struct hsm_async);
+
+	async->ld = ld;
+	list_head_init(&async->inflight);
+	async->dc = daemon_conn_new(async,
+				    hsm_get_global_fd(ld, HSM_CAP_MASTER),
+				    hsm_async_reply, NULL, async);
+	tal_add_destructor(async->dc, hsm_async_gone);
+	tal_add_destructor(async, destroy_hsm_async);
+	return async;
+}
+
 struct ext_key *hsm_init(struct lightningd *ld)
 {
 	u8 *msg;
@@ -104,7 +206,7 @@ struct ext_key *hsm_init(struct lightningd *ld)
 	}
 
 	ld->hsm_fd = fds[0];
-	u32 min_version = 3; /* payment modifiers need hsmd_preapprove_{invoice,keysend} */
+	u32 min_version = 5; /* v4: hsmd_sign_remote_htlc_txs, v5: hsmd_ecdh_batch_req */
 	if (!wire_sync_write(ld->hsm_fd, towire_hsmd_init(tmpctx,
 							 &chainparams->bip32_key_version,
 							 chainparams,
@@ -153,9 +255,29 @@ struct ext_key *hsm_init(struct lightningd *ld)
 	if (!fromwire_hsmd_derive_secret_reply(msg, &ld->invoicesecret_base))
 		err(EXITCODE_HSM_GENERIC_ERROR, "Bad derive_secret_reply");
 
+	ld->hsm_async = hsm_async_new(ld);
 	return bip32_base;
 }
 
+static void derive_secret_reply(struct lightningd *ld,
+				const u8 *msg,
+				struct command *cmd)
+{
+	struct json_stream *response;
+	struct secret secret;
+
+	if (!fromwire_hsmd_derive_secret_reply(msg, &secret)) {
+		was_pending(command_fail(cmd, LIGHTNINGD,
+					 "Bad reply from HSM: %s",
+					 tal_hex(tmpctx, msg)));
+		return;
+	}
+
+	response = json_stream_success(cmd);
+	json_add_secret(response, "secret", &secret);
+	was_pending(command_success(cmd, response));
+}
+
 static struct command_result *json_makesecret(struct command *cmd,
 					   const char *buffer,
 					   const jsmntok_t *obj UNNEEDED,
@@ -163,8 +285,6 @@ static struct command_result *json_makesecret(struct command *cmd,
 {
 	u8 *data;
 	const char *strdata;
-	struct json_stream *response;
-	struct secret secret;
 
 	if (!param(cmd, buffer, params,
 		   p_opt("hex", param_bin_from_hex, &data),
@@ -185,20 +305,8 @@ static struct command_result *json_makesecret(struct command *cmd,
 
 
 	u8 *msg = towire_hsmd_derive_secret(cmd, data);
-	if (!wire_sync_write(cmd->ld->hsm_fd, take(msg)))
-		return command_fail(cmd, LIGHTNINGD,
-                     "Could not write to HSM: %s", strerror(errno));
-
-
-	msg = wire_sync_read(tmpctx, cmd->ld->hsm_fd);
-	if (!fromwire_hsmd_derive_secret_reply(msg, &secret))
-		return command_fail(cmd, LIGHTNINGD,
-                     "Bad reply from HSM: %s", strerror(errno));
-
-
-	response = json_stream_success(cmd);
-	json_add_secret(response, "secret", &secret);
-	return command_success(cmd, response);
+	hsm_req(cmd, cmd->ld, take(msg), derive_secret_reply, cmd);
+	return command_still_pending(cmd);
 }
 
 static const struct json_command makesecret_command = {
@@ -2,6 +2,8 @@
 #define LIGHTNING_LIGHTNINGD_HSM_CONTROL_H
 #include "config.h"
 #include <ccan/short_types/short_types.h>
+#include <ccan/tal/tal.h>
+#include <ccan/typesafe_cb/typesafe_cb.h>
 
 struct lightningd;
 struct node_id;
@@ -17,4 +19,19 @@ int hsm_get_client_fd(struct lightningd *ld,
 int hsm_get_global_fd(struct lightningd *ld, int capabilities);
 
 struct ext_key *hsm_init(struct lightningd *ld);
+
+/* Send @msg to hsmd without waiting for the reply: @cb gets it later
+ * (unless @ctx is freed first).  Many can be in flight at once. */
+#define hsm_req(ctx, ld, msg, cb, arg)					\
+	hsm_req_((ctx), (ld), (msg),					\
+		 typesafe_cb_preargs(void, void *, (cb), (arg),		\
+				     struct lightningd *,		\
+				     const u8 *),			\
+		 (arg))
+
+void hsm_req_(const tal_t *ctx,
+	      struct lightningd *ld,
+	      const u8 *msg TAKES,
+	      void (*cb)(struct lightningd *, const u8 *, void *),
+	      void *arg);
 #endif /* LIGHTNING_LIGHTNINGD_HSM_CONTROL_H */
@@ -159,6 +159,8 @@ struct htlc_in *new_htlc_in(const tal_t *ctx,
 	hin->payload = NULL;
 
 	hin->received_time = time_now();
+	memset(hin->stage_time, 0, sizeof(hin->stage_time));
+	hin->stage_time[FORWARD_STAGE_RECEIVED] = time_mono();
 
 	return htlc_in_check(hin, "new_htlc_in");
 }
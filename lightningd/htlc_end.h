@@ -14,6 +14,22 @@ struct htlc_key {
 
 #define HTLC_INVALID_ID (-1ULL)
 
+/* Stages of an incoming HTLC's life, for getforwardlatency. */
+enum forward_stage {
+	/* channeld told us about it. */
+	FORWARD_STAGE_RECEIVED,
+	/* It's irrevocably committed, so we call the htlc_accepted hook. */
+	FORWARD_STAGE_HOOK_START,
+	FORWARD_STAGE_HOOK_END,
+	/* We offered it to the outgoing channeld. */
+	FORWARD_STAGE_OFFERED,
+	/* The outgoing HTLC is irrevocably committed. */
+	FORWARD_STAGE_COMMITTED,
+	/* We told the incoming channeld to fulfill or fail it. */
+	FORWARD_STAGE_RESOLVED,
+};
+#define NUM_FORWARD_STAGE (FORWARD_STAGE_RESOLVED + 1)
+
 /* Incoming HTLC */
 struct htlc_in {
 	/* The database primary key for this htlc. Must be 0 until it
@@ -46,6 +62,10 @@ struct htlc_in {
 	 * it, and the resolution time, in the forwards table. */
         struct timeabs received_time;
 
+	/* When we reached each forward_stage (zero if not, or from before
+	 * we restarted). */
+	struct timemono stage_time[NUM_FORWARD_STAGE];
+
 	/* If it was blinded. */
 	struct pubkey *blinding;
 	/* true if we supplied the preimage */
@@ -23,10 +23,27 @@ static void htlc_set_hin_destroyed(struct htlc_in *hin,
 	abort();
 }
 
-static void destroy_htlc_set(struct htlc_set *set,
-			     struct htlc_set_map *map)
+static void destroy_htlc_set(struct htlc_set *set)
 {
-	htlc_set_map_del(map, set);
+	htlc_set_map_del(set->ld->htlc_sets, set);
+	list_del(&set->expiry_list);
+}
+
+static void htlc_set_timer_fired(struct lightningd *ld);
+
+/* Every set gets the same timeout, so the list is in expiry order and
+ * one timer (for the first) does for all of them. */
+static void arm_htlc_set_timer(struct lightningd *ld, struct timemono now)
+{
+	struct htlc_set *first;
+
+	first = list_top(&ld->htlc_sets_by_expiry, struct htlc_set, expiry_list);
+	if (!first)
+		return;
+
+	ld->htlc_set_timer = new_reltimer(ld->timers, ld,
+					  timemono_between(first->expiry, now),
+					  htlc_set_timer_fired, ld);
 }
 
 /* BOLT #4:
@@ -35,9 +52,19 @@ static void destroy_htlc_set(struct htlc_set *set,
  *...
  *   - SHOULD use `mpp_timeout` for the failure message.
  */
-static void timeout_htlc_set(struct htlc_set *set)
+static void htlc_set_timer_fired(struct lightningd *ld)
 {
-	htlc_set_fail(set, take(towire_mpp_timeout(NULL)));
+	struct timemono now = time_mono();
+	struct htlc_set *set;
+
+	ld->htlc_set_timer = NULL;
+	while ((set = list_top(&ld->htlc_sets_by_expiry,
+			       struct htlc_set, expiry_list)) != NULL) {
+		if (time_less_(now.ts, set->expiry.ts))
+			break;
+		htlc_set_fail(set, take(towire_mpp_timeout(NULL)));
+	}
+	arm_htlc_set_timer(ld, now);
 }
 
 void htlc_set_fail(struct htlc_set *set, const u8 *failmsg TAKES)
@@ -75,6 +102,7 @@ static struct htlc_set *new_htlc_set(struct lightningd *ld,
 	struct htlc_set *set;
 
 	set = tal(ld, struct htlc_set);
+	set->ld = ld;
 	set->total_msat = total_msat;
 	set->payment_hash = hin->payment_hash;
 	set->so_far = AMOUNT_MSAT(0);
@@ -87,10 +115,12 @@ static struct htlc_set *new_htlc_set(struct lightningd *ld,
 	 *   - SHOULD wait for at least 60 seconds after the initial
 	 *     HTLC.
 	 */
-	set->timeout = new_reltimer(ld->timers, set, time_from_sec(70),
-				    timeout_htlc_set, set);
+	set->expiry = timemono_add(time_mono(), time_from_sec(70));
+	list_add_tail(&ld->htlc_sets_by_expiry, &set->expiry_list);
+	if (!ld->htlc_set_timer)
+		arm_htlc_set_timer(ld, time_mono());
 	htlc_set_map_add(ld->htlc_sets, set);
-	tal_add_destructor2(set, destroy_htlc_set, ld->htlc_sets);
+	tal_add_destructor(set, destroy_htlc_set);
 	return set;
 }
 
@@ -204,7 +234,7 @@ void htlc_set_add(struct lightningd *ld,
 
 	if (amount_msat_eq(set->so_far, total_msat)) {
 		/* Disable timer now, in case invoice_hook is slow! */
-		tal_free(set->timeout);
+		list_del_init(&set->expiry_list);
 		invoice_try_pay(ld, set, details);
 		return;
 	}
@@ -4,6 +4,8 @@
 #include <ccan/crypto/sha256/sha256.h>
 #include <ccan/crypto/siphash24/siphash24.h>
 #include <ccan/htable/htable_type.h>
+#include <ccan/list/list.h>
+#include <ccan/time/time.h>
 #include <common/amount.h>
 #include <common/pseudorand.h>
 #include <common/utils.h>
@@ -14,10 +16,13 @@ struct lightningd;
 
 /* Set of incoming HTLCs for multi-part-payments */
 struct htlc_set {
+	struct lightningd *ld;
 	struct amount_msat total_msat, so_far;
 	struct sha256 payment_hash;
 	struct htlc_in **htlcs;
-	struct oneshot *timeout;
+	/* In ld->htlc_sets_by_expiry until complete (or timed out). */
+	struct list_node expiry_list;
+	struct timemono expiry;
 };
 
 static inline const struct sha256 *keyof_htlc_set(const struct htlc_set *set)
@@ -27,7 +32,7 @@ static inline const struct sha256 *keyof_htlc_set(const struct htlc_set *set)
 
 static inline size_t hash_payment_hash(const struct sha256 *payment_hash)
 {
-	return siphash24(siphash_seed(), payment_hash, sizeof(&payment_hash));
+	return siphash24(siphash_seed(), payment_hash, sizeof(*payment_hash));
 }
 
 static inline bool htlc_set_eq(const struct htlc_set *set,
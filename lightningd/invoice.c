@@ -20,6 +20,7 @@
 #include <errno.h>
 #include <hsmd/hsmd_wiregen.h>
 #include <lightningd/channel.h>
+#include <lightningd/hsm_control.h>
 #include <lightningd/invoice.h>
 #include <lightningd/notification.h>
 #include <lightningd/plugin_hook.h>
@@ -83,16 +84,15 @@ static void json_add_invoice(struct json_stream *response,
 {
 	json_object_start(response, fieldname);
 	json_add_invoice_fields(response, inv);
+	json_add_u64(response, "created_index", inv->created_index);
 	json_object_end(response);
 }
 
 static struct command_result *tell_waiter(struct command *cmd,
-					  const struct invoice *inv)
+					  const struct invoice_details *details)
 {
 	struct json_stream *response;
-	const struct invoice_details *details;
 
-	details = wallet_invoice_details(cmd, cmd->ld->wallet, *inv);
 	if (details->state == PAID) {
 		response = json_stream_success(cmd);
 		json_add_invoice_fields(response, details);
@@ -111,10 +111,12 @@ static void tell_waiter_deleted(struct command *cmd)
 	was_pending(command_fail(cmd, LIGHTNINGD,
 				 "Invoice deleted during wait"));
 }
-static void wait_on_invoice(const struct invoice *invoice, void *cmd)
+static void wait_on_invoice(const struct invoice *invoice,
+			    const struct invoice_details *details,
+			    void *cmd)
 {
 	if (invoice)
-		tell_waiter((struct command *) cmd, invoice);
+		tell_waiter((struct command *) cmd, details);
 	else
 		tell_waiter_deleted((struct command *) cmd);
 }
@@ -690,6 +692,8 @@ struct invoice_info {
 	struct bolt11 *b11;
 	struct json_escape *label;
 	struct chanhints *chanhints;
+	/* What the gossip_store looked like when we asked listincoming */
+	struct routehint_cache *cache;
 };
 
 /* Add routehints based on listincoming results: NULL means success. */
@@ -831,20 +835,13 @@ done:
 	return NULL;
 }
 
+/* Sign and store the invoice: NULL (and *details set) means success. */
 static struct command_result *
-invoice_complete(struct invoice_info *info,
-		 bool warning_no_listincoming,
-		 bool warning_mpp,
-		 bool warning_capacity,
-		 bool warning_deadends,
-		 bool warning_offline,
-		 bool warning_private_unused)
+invoice_store(struct invoice_info *info,
+	      const struct invoice_details **details)
 {
-	struct json_stream *response;
 	struct invoice invoice;
 	char *b11enc;
-	const struct invoice_details *details;
-	struct secret payment_secret;
 	struct wallet *wallet = info->cmd->ld->wallet;
 
 	b11enc = bolt11_encode(info, info->b11, false,
@@ -875,9 +872,22 @@ invoice_complete(struct invoice_info *info,
 	}
 
 	/* Get details */
-	details = wallet_invoice_details(info, wallet, invoice);
+	*details = wallet_invoice_details(info, wallet, invoice);
+	return NULL;
+}
+
+static void json_add_new_invoice(struct json_stream *response,
+				 struct invoice_info *info,
+				 const struct invoice_details *details,
+				 bool warning_no_listincoming,
+				 bool warning_mpp,
+				 bool warning_capacity,
+				 bool warning_deadends,
+				 bool warning_offline,
+				 bool warning_private_unused)
+{
+	struct secret payment_secret;
 
-	response = json_stream_success(info->cmd);
 	json_add_sha256(response, "payment_hash", &details->rhash);
 	json_add_u64(response, "expires_at", details->expiry_time);
 	json_add_string(response, "bolt11", details->invstring);
@@ -908,17 +918,42 @@ invoice_complete(struct invoice_info *info,
 	if (warning_private_unused)
 		json_add_string(response, "warning_private_unused",
 				"Insufficient incoming capacity, once private channels were excluded (try exposeprivatechannels=true?)");
+}
 
+static struct command_result *
+invoice_complete(struct invoice_info *info,
+		 bool warning_no_listincoming,
+		 bool warning_mpp,
+		 bool warning_capacity,
+		 bool warning_deadends,
+		 bool warning_offline,
+		 bool warning_private_unused)
+{
+	struct json_stream *response;
+	const struct invoice_details *details;
+	struct command_result *ret;
+
+	ret = invoice_store(info, &details);
+	if (ret)
+		return ret;
+
+	response = json_stream_success(info->cmd);
+	json_add_new_invoice(response, info, details,
+			     warning_no_listincoming,
+			     warning_mpp,
+			     warning_capacity,
+			     warning_deadends,
+			     warning_offline,
+			     warning_private_unused);
 	return command_success(info->cmd, response);
 }
 
-/* Return from "listincoming". */
-static void listincoming_done(const char *buffer,
-			      const jsmntok_t *toks,
-			      const jsmntok_t *idtok UNUSED,
-			      struct invoice_info *info)
+/* Complete the invoice using listincoming results. */
+static struct command_result *
+invoice_with_routehints(struct invoice_info *info,
+			const char *buffer,
+			const jsmntok_t *toks)
 {
-	struct lightningd *ld = info->cmd->ld;
 	struct command_result *ret;
 	bool warning_mpp, warning_capacity, warning_deadends, warning_offline, warning_private_unused;
 
@@ -929,17 +964,30 @@ static void listincoming_done(const char *buffer,
 			     &warning_offline,
 			     &warning_private_unused);
 	if (ret)
-		return;
+		return ret;
+
+	return invoice_complete(info,
+				false,
+				warning_mpp,
+				warning_capacity,
+				warning_deadends,
+				warning_offline,
+				warning_private_unused);
+}
+
+/* Return from "listincoming". */
+static void listincoming_done(const char *buffer,
+			      const jsmntok_t *toks,
+			      const jsmntok_t *idtok UNUSED,
+			      struct invoice_info *info)
+{
+	struct lightningd *ld = info->cmd->ld;
+
+	routehint_cache_set(ld, info->cache, buffer, toks);
 
 	/* We're actually outside a db transaction here: spooky! */
 	db_begin_transaction(ld->wallet->db);
-	invoice_complete(info,
-			 false,
-			 warning_mpp,
-			 warning_capacity,
-			 warning_deadends,
-			 warning_offline,
-			 warning_private_unused);
+	invoice_with_routehints(info, buffer, toks);
 	db_commit_transaction(ld->wallet->db);
 }
 
@@ -1074,6 +1122,74 @@ static struct command_result *param_preimage(struct command *cmd,
 	return NULL;
 }
 
+/* Check the parameters and fill in info->b11: NULL means success. */
+static struct command_result *invoice_setup(struct invoice_info *info,
+					    struct amount_msat *msat,
+					    const char *desc_val,
+					    u64 expiry,
+					    const struct preimage *preimage,
+					    u32 cltv,
+					    bool hashonly)
+{
+	struct command *cmd = info->cmd;
+	struct sha256 rhash;
+	struct secret payment_secret;
+
+	if (strlen(info->label->s) > INVOICE_MAX_LABEL_LEN) {
+		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+				    "Label '%s' over %u bytes", info->label->s,
+				    INVOICE_MAX_LABEL_LEN);
+	}
+
+	if (strlen(desc_val) > BOLT11_FIELD_BYTE_LIMIT && !hashonly) {
+		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+				    "Descriptions greater than %d bytes "
+				    "not yet supported "
+				    "(description length %zu)",
+				    BOLT11_FIELD_BYTE_LIMIT,
+				    strlen(desc_val));
+	}
+
+	if (preimage)
+		info->payment_preimage = *preimage;
+	else
+		/* Generate random secret preimage. */
+		randombytes_buf(&info->payment_preimage,
+				sizeof(info->payment_preimage));
+	/* Generate preimage hash. */
+	sha256(&rhash, &info->payment_preimage, sizeof(info->payment_preimage));
+	/* Generate payment secret. */
+	invoice_secret(&info->payment_preimage, &payment_secret);
+
+	info->b11 = new_bolt11(info, msat);
+	info->b11->chain = chainparams;
+	info->b11->timestamp = time_now().ts.tv_sec;
+	info->b11->payment_hash = rhash;
+	info->b11->receiver_id = cmd->ld->id;
+	info->b11->min_final_cltv_expiry = cltv;
+	info->b11->expiry = expiry;
+	info->b11->description = tal_steal(info->b11, desc_val);
+	/* BOLT #11:
+	 * * `h` (23): `data_length` 52. 256-bit description of purpose of payment (SHA256).
+	 *...
+	 * A writer:
+	 *...
+	 *    - MUST include either exactly one `d` or exactly one `h` field.
+	 */
+	if (hashonly) {
+		info->b11->description_hash = tal(info->b11, struct sha256);
+		sha256(info->b11->description_hash, desc_val, strlen(desc_val));
+	} else
+		info->b11->description_hash = NULL;
+	info->b11->payment_secret = tal_dup(info->b11, struct secret,
+					    &payment_secret);
+	info->b11->features = tal_dup_talarr(info->b11, u8,
+					     cmd->ld->our_features
+					     ->bits[BOLT11_FEATURE]);
+	info->b11->routes = NULL;
+	return NULL;
+}
+
 static struct command_result *json_invoice(struct command *cmd,
 					   const char *buffer,
 					   const jsmntok_t *obj UNNEEDED,
@@ -1085,12 +1201,13 @@ static struct command_result *json_invoice(struct command *cmd,
 	const char *desc_val;
 	const u8 **fallback_scripts = NULL;
 	u64 *expiry;
-	struct sha256 rhash;
-	struct secret payment_secret;
 	struct preimage *preimage;
 	u32 *cltv;
 	struct jsonrpc_request *req;
 	struct plugin *plugin;
+	struct command_result *r;
+	const char *incoming_buf;
+	const jsmntok_t *incoming_toks;
 	bool *hashonly;
 #if DEVELOPER
 	const jsmntok_t *routes;
@@ -1117,20 +1234,10 @@ static struct command_result *json_invoice(struct command *cmd,
 		   NULL))
 		return command_param_failed();
 
-	if (strlen(info->label->s) > INVOICE_MAX_LABEL_LEN) {
-		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
-				    "Label '%s' over %u bytes", info->label->s,
-				    INVOICE_MAX_LABEL_LEN);
-	}
-
-	if (strlen(desc_val) > BOLT11_FIELD_BYTE_LIMIT && !*hashonly) {
-		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
-				    "Descriptions greater than %d bytes "
-				    "not yet supported "
-				    "(description length %zu)",
-				    BOLT11_FIELD_BYTE_LIMIT,
-				    strlen(desc_val));
-	}
+	r = invoice_setup(info, msatoshi_val, desc_val, *expiry, preimage,
+			  *cltv, *hashonly);
+	if (r)
+		return r;
 
 	if (fallbacks) {
 		size_t i;
@@ -1138,58 +1245,20 @@ static struct command_result *json_invoice(struct command *cmd,
 
 		fallback_scripts = tal_arr(cmd, const u8 *, fallbacks->size);
 		json_for_each_arr(i, t, fallbacks) {
-			struct command_result *r;
-
 			r = parse_fallback(cmd, buffer, t, &fallback_scripts[i]);
 			if (r)
 				return r;
 		}
+		info->b11->fallbacks = tal_steal(info->b11, fallback_scripts);
 	}
 
-	if (preimage)
-		info->payment_preimage = *preimage;
-	else
-		/* Generate random secret preimage. */
-		randombytes_buf(&info->payment_preimage,
-				sizeof(info->payment_preimage));
-	/* Generate preimage hash. */
-	sha256(&rhash, &info->payment_preimage, sizeof(info->payment_preimage));
-	/* Generate payment secret. */
-	invoice_secret(&info->payment_preimage, &payment_secret);
-
-	info->b11 = new_bolt11(info, msatoshi_val);
-	info->b11->chain = chainparams;
-	info->b11->timestamp = time_now().ts.tv_sec;
-	info->b11->payment_hash = rhash;
-	info->b11->receiver_id = cmd->ld->id;
-	info->b11->min_final_cltv_expiry = *cltv;
-	info->b11->expiry = *expiry;
-	info->b11->description = tal_steal(info->b11, desc_val);
-	/* BOLT #11:
-	 * * `h` (23): `data_length` 52. 256-bit description of purpose of payment (SHA256).
-	 *...
-	 * A writer:
-	 *...
-	 *    - MUST include either exactly one `d` or exactly one `h` field.
-	 */
-	if (*hashonly) {
-		info->b11->description_hash = tal(info->b11, struct sha256);
-		sha256(info->b11->description_hash, desc_val, strlen(desc_val));
-	} else
-		info->b11->description_hash = NULL;
-	info->b11->payment_secret = tal_dup(info->b11, struct secret,
-					    &payment_secret);
-	info->b11->features = tal_dup_talarr(info->b11, u8,
-					     cmd->ld->our_features
-					     ->bits[BOLT11_FEATURE]);
-
 #if DEVELOPER
 	info->b11->routes = unpack_routes(info->b11, buffer, routes);
-#else
-	info->b11->routes = NULL;
 #endif
-	if (fallback_scripts)
-		info->b11->fallbacks = tal_steal(info->b11, fallback_scripts);
+
+	/* Nothing changed since the last listincoming?  Don't ask again. */
+	if (routehint_cache_get(cmd->ld, &incoming_buf, &incoming_toks))
+		return invoice_with_routehints(info, incoming_buf, incoming_toks);
 
 	/* We can't generate routehints without listincoming. */
 	plugin = find_plugin_for_command(cmd->ld, "listincoming");
@@ -1198,6 +1267,7 @@ static struct command_result *json_invoice(struct command *cmd,
 					false, false, false, false, false);
 	}
 
+	info->cache = routehint_cache_start(info);
 	req = jsonrpc_request_start(info, "listincoming",
 				    cmd->id, plugin->non_numeric_ids,
 				    command_log(cmd),
@@ -1219,11 +1289,231 @@ static const struct json_command invoice_command = {
 	"(default autogenerated)"};
 AUTODATA(json_command, &invoice_command);
 
+/* One invoice from an invoicebatch */
+struct batch_invoice {
+	struct invoice_info *info;
+	bool warning_mpp, warning_capacity, warning_deadends,
+		warning_offline, warning_private_unused;
+};
+
+struct invoice_batch {
+	struct command *cmd;
+	struct batch_invoice *invoices;
+	/* What the gossip_store looked like when we asked listincoming */
+	struct routehint_cache *cache;
+};
+
+static struct command_result *param_invoice_batch(struct command *cmd,
+						  const char *name,
+						  const char *buffer,
+						  const jsmntok_t *tok,
+						  struct batch_invoice **invoices)
+{
+	size_t i;
+	const jsmntok_t *t;
+
+	if (tok->type != JSMN_ARRAY || tok->size == 0)
+		return command_fail_badparam(cmd, name, buffer, tok,
+					     "should be a non-empty array");
+
+	*invoices = tal_arrz(cmd, struct batch_invoice, tok->size);
+	json_for_each_arr(i, t, tok) {
+		struct invoice_info *info;
+		struct amount_msat *msatoshi_val;
+		const char *desc_val;
+		u64 *expiry;
+		struct preimage *preimage;
+		u32 *cltv;
+		bool *hashonly;
+		struct command_result *r;
+
+		info = tal(*invoices, struct invoice_info);
+		info->cmd = cmd;
+		info->chanhints = NULL;
+		info->cache = NULL;
+
+		if (!param(cmd, buffer, t,
+			   p_req("amount_msat", param_positive_msat_or_any,
+				 &msatoshi_val),
+			   p_req("label", param_label, &info->label),
+			   p_req("description", param_escaped_string, &desc_val),
+			   p_opt_def("expiry", param_u64, &expiry, 3600*24*7),
+			   p_opt("preimage", param_preimage, &preimage),
+			   p_opt_def("cltv", param_number, &cltv,
+				     cmd->ld->config.cltv_final),
+			   p_opt_def("deschashonly", param_bool, &hashonly, false),
+			   NULL))
+			return command_param_failed();
+
+		r = invoice_setup(info, msatoshi_val, desc_val, *expiry,
+				  preimage, *cltv, *hashonly);
+		if (r)
+			return r;
+		(*invoices)[i].info = info;
+	}
+	return NULL;
+}
+
+/* Create the whole batch, using listincoming results if we have them. */
+static struct command_result *
+invoice_batch_complete(struct invoice_batch *batch,
+		       const char *buffer,
+		       const jsmntok_t *toks)
+{
+	struct command *cmd = batch->cmd;
+	struct wallet *wallet = cmd->ld->wallet;
+	const struct invoice_details **details;
+	struct json_stream *response;
+	struct command_result *ret;
+	size_t n = tal_count(batch->invoices);
+
+	/* We can't take back the ones we've stored, so check them all first. */
+	for (size_t i = 0; i < n; i++) {
+		const struct invoice_info *info = batch->invoices[i].info;
+		struct invoice invoice;
+
+		if (wallet_invoice_find_by_label(wallet, &invoice, info->label))
+			return command_fail(cmd, INVOICE_LABEL_ALREADY_EXISTS,
+					    "Duplicate label '%s'",
+					    info->label->s);
+		if (wallet_invoice_find_by_rhash(wallet, &invoice,
+						 &info->b11->payment_hash))
+			return command_fail(cmd,
+					    INVOICE_PREIMAGE_ALREADY_EXISTS,
+					    "preimage already used");
+
+		for (size_t j = 0; j < i; j++) {
+			const struct invoice_info *prev = batch->invoices[j].info;
+
+			if (json_escape_eq(prev->label, info->label))
+				return command_fail(cmd,
+						    INVOICE_LABEL_ALREADY_EXISTS,
+						    "Duplicate label '%s'",
+						    info->label->s);
+			if (sha256_eq(&prev->b11->payment_hash,
+				      &info->b11->payment_hash))
+				return command_fail(cmd,
+						    INVOICE_PREIMAGE_ALREADY_EXISTS,
+						    "preimage already used");
+		}
+	}
+
+	/* Each one gets its own selection: select_inchan_mpp round-robins. */
+	for (size_t i = 0; toks && i < n; i++) {
+		struct batch_invoice *inv = &batch->invoices[i];
+
+		ret = add_routehints(inv->info, buffer, toks,
+				     &inv->warning_mpp,
+				     &inv->warning_capacity,
+				     &inv->warning_deadends,
+				     &inv->warning_offline,
+				     &inv->warning_private_unused);
+		if (ret)
+			return ret;
+	}
+
+	details = tal_arr(tmpctx, const struct invoice_details *, n);
+	for (size_t i = 0; i < n; i++) {
+		ret = invoice_store(batch->invoices[i].info, &details[i]);
+		if (ret)
+			return ret;
+	}
+
+	response = json_stream_success(cmd);
+	json_array_start(response, "invoices");
+	for (size_t i = 0; i < n; i++) {
+		const struct batch_invoice *inv = &batch->invoices[i];
+
+		json_object_start(response, NULL);
+		json_add_escaped_string(response, "label", inv->info->label);
+		json_add_new_invoice(response, inv->info, details[i],
+				     toks == NULL,
+				     inv->warning_mpp,
+				     inv->warning_capacity,
+				     inv->warning_deadends,
+				     inv->warning_offline,
+				     inv->warning_private_unused);
+		json_object_end(response);
+	}
+	json_array_end(response);
+	return command_success(cmd, response);
+}
+
+/* Return from "listincoming" for invoicebatch. */
+static void listincoming_batch_done(const char *buffer,
+				    const jsmntok_t *toks,
+				    const jsmntok_t *idtok UNUSED,
+				    struct invoice_batch *batch)
+{
+	struct lightningd *ld = batch->cmd->ld;
+
+	routehint_cache_set(ld, batch->cache, buffer, toks);
+
+	/* We're actually outside a db transaction here: spooky! */
+	db_begin_transaction(ld->wallet->db);
+	invoice_batch_complete(batch, buffer, toks);
+	db_commit_transaction(ld->wallet->db);
+}
+
+static struct command_result *json_invoicebatch(struct command *cmd,
+						const char *buffer,
+						const jsmntok_t *obj UNNEEDED,
+						const jsmntok_t *params)
+{
+	struct invoice_batch *batch;
+	struct chanhints *chanhints;
+	struct jsonrpc_request *req;
+	struct plugin *plugin;
+	const char *incoming_buf;
+	const jsmntok_t *incoming_toks;
+
+	batch = tal(cmd, struct invoice_batch);
+	batch->cmd = cmd;
+
+	if (!param(cmd, buffer, params,
+		   p_req("invoices", param_invoice_batch, &batch->invoices),
+		   p_opt("exposeprivatechannels", param_chanhints, &chanhints),
+		   NULL))
+		return command_param_failed();
+
+	for (size_t i = 0; i < tal_count(batch->invoices); i++)
+		batch->invoices[i].info->chanhints = chanhints;
+
+	/* One listincoming (at most) for the lot. */
+	if (routehint_cache_get(cmd->ld, &incoming_buf, &incoming_toks))
+		return invoice_batch_complete(batch, incoming_buf, incoming_toks);
+
+	plugin = find_plugin_for_command(cmd->ld, "listincoming");
+	if (!plugin)
+		return invoice_batch_complete(batch, NULL, NULL);
+
+	batch->cache = routehint_cache_start(batch);
+	req = jsonrpc_request_start(batch, "listincoming",
+				    cmd->id, plugin->non_numeric_ids,
+				    command_log(cmd),
+				    NULL, listincoming_batch_done,
+				    batch);
+	jsonrpc_request_end(req);
+	plugin_request_send(plugin, req);
+	return command_still_pending(cmd);
+}
+
+static const struct json_command invoicebatch_command = {
+	"invoicebatch",
+	"payment",
+	json_invoicebatch,
+	"Create an invoice for each of {invoices}, each with {amount_msat}, "
+	"{label} and {description}, and optional {expiry}, {preimage}, "
+	"{cltv} and {deschashonly}, with optional {exposeprivatechannels}"};
+AUTODATA(json_command, &invoicebatch_command);
+
 static void json_add_invoices(struct json_stream *response,
 			      struct wallet *wallet,
 			      const struct json_escape *label,
 			      const struct sha256 *payment_hash,
-			      const struct sha256 *local_offer_id)
+			      const struct sha256 *local_offer_id,
+			      u64 start,
+			      const u32 *limit)
 {
 	struct invoice_iterator it;
 	const struct invoice_details *details;
@@ -1245,16 +1535,10 @@ static void json_add_invoices(struct json_stream *response,
 		}
 	} else {
 		memset(&it, 0, sizeof(it));
-		while (wallet_invoice_iterate(wallet, &it)) {
+		while (wallet_invoice_iterate(wallet, &it, local_offer_id,
+					      start, limit)) {
 			details = wallet_invoice_iterator_deref(response,
 								wallet, &it);
-			/* FIXME: db can filter this better! */
-			if (local_offer_id) {
-				if (!details->local_offer_id
-				    || !sha256_eq(local_offer_id,
-						  details->local_offer_id))
-					continue;
-			}
 			json_add_invoice(response, NULL, details);
 		}
 	}
@@ -1270,6 +1554,8 @@ static struct command_result *json_listinvoices(struct command *cmd,
 	struct wallet *wallet = cmd->ld->wallet;
 	const char *invstring;
 	struct sha256 *payment_hash, *offer_id;
+	u64 *start;
+	u32 *limit;
 	char *fail;
 
 	if (!param(cmd, buffer, params,
@@ -1277,6 +1563,8 @@ static struct command_result *json_listinvoices(struct command *cmd,
 		   p_opt("invstring", param_string, &invstring),
 		   p_opt("payment_hash", param_sha256, &payment_hash),
 		   p_opt("offer_id", param_sha256, &offer_id),
+		   p_opt_def("start", param_u64, &start, 0),
+		   p_opt("limit", param_u32, &limit),
 		   NULL))
 		return command_param_failed();
 
@@ -1311,7 +1599,8 @@ static struct command_result *json_listinvoices(struct command *cmd,
 
 	response = json_stream_success(cmd);
 	json_array_start(response, "invoices");
-	json_add_invoices(response, wallet, label, payment_hash, offer_id);
+	json_add_invoices(response, wallet, label, payment_hash, offer_id,
+			  *start, limit);
 	json_array_end(response);
 	return command_success(cmd, response);
 }
@@ -1321,7 +1610,7 @@ static const struct json_command listinvoices_command = {
 	"payment",
 	json_listinvoices,
 	"Show invoice matching {label}, {invstring}, {payment_hash} or {offerid} (or all, if "
-	"no query parameter specified)"
+	"no query parameter specified), at most {limit} starting at created_index {start}"
 };
 AUTODATA(json_command, &listinvoices_command);
 
@@ -1505,7 +1794,7 @@ static struct command_result *json_waitinvoice(struct command *cmd,
 
 	/* If paid or expired return immediately */
 	if (details->state == PAID || details->state == EXPIRED) {
-		return tell_waiter(cmd, &i);
+		return tell_waiter(cmd, details);
 	} else {
 		/* There is an unpaid one matching, let's wait... */
 		fixme_ignore(command_still_pending(cmd));
@@ -1809,14 +2098,34 @@ static const struct json_command createinvoice_command = {
 
 AUTODATA(json_command, &createinvoice_command);
 
+static void preapprove_invoice_reply(struct lightningd *ld,
+				     const u8 *msg,
+				     struct command *cmd)
+{
+	bool approved;
+
+	if (!fromwire_hsmd_preapprove_invoice_reply(msg, &approved)) {
+		was_pending(command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+					 "HSM gave bad preapprove_invoice_reply %s",
+					 tal_hex(msg, msg)));
+		return;
+	}
+
+	if (!approved) {
+		was_pending(command_fail(cmd, PAY_INVOICE_PREAPPROVAL_DECLINED,
+					 "invoice was declined"));
+		return;
+	}
+
+	was_pending(command_success(cmd, json_stream_success(cmd)));
+}
+
 static struct command_result *json_preapproveinvoice(struct command *cmd,
 						     const char *buffer,
 						     const jsmntok_t *obj UNNEEDED,
 						     const jsmntok_t *params)
 {
 	const char *invstring;
-	struct json_stream *response;
-	bool approved;
 
 	if (!param(cmd, buffer, params,
 		   /* FIXME: parameter should be invstring now */
@@ -1831,19 +2140,8 @@ static struct command_result *json_preapproveinvoice(struct command *cmd,
 
 	u8 *msg = towire_hsmd_preapprove_invoice(NULL, invstring);
 
-	if (!wire_sync_write(cmd->ld->hsm_fd, take(msg)))
-		fatal("Could not write to HSM: %s", strerror(errno));
-
-	msg = wire_sync_read(tmpctx, cmd->ld->hsm_fd);
-        if (!fromwire_hsmd_preapprove_invoice_reply(msg, &approved))
-		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
-				    "HSM gave bad preapprove_invoice_reply %s", tal_hex(msg, msg));
-
-	if (!approved)
-		return command_fail(cmd, PAY_INVOICE_PREAPPROVAL_DECLINED, "invoice was declined");
-
-	response = json_stream_success(cmd);
-	return command_success(cmd, response);
+	hsm_req(cmd, cmd->ld, take(msg), preapprove_invoice_reply, cmd);
+	return command_still_pending(cmd);
 }
 
 static const struct json_command preapproveinvoice_command = {
@@ -1854,6 +2152,28 @@ static const struct json_command preapproveinvoice_command = {
 };
 AUTODATA(json_command, &preapproveinvoice_command);
 
+static void preapprove_keysend_reply(struct lightningd *ld,
+				     const u8 *msg,
+				     struct command *cmd)
+{
+	bool approved;
+
+	if (!fromwire_hsmd_preapprove_keysend_reply(msg, &approved)) {
+		was_pending(command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+					 "HSM gave bad preapprove_keysend_reply %s",
+					 tal_hex(msg, msg)));
+		return;
+	}
+
+	if (!approved) {
+		was_pending(command_fail(cmd, PAY_KEYSEND_PREAPPROVAL_DECLINED,
+					 "keysend was declined"));
+		return;
+	}
+
+	was_pending(command_success(cmd, json_stream_success(cmd)));
+}
+
 static struct command_result *json_preapprovekeysend(struct command *cmd,
 						     const char *buffer,
 						     const jsmntok_t *obj UNNEEDED,
@@ -1863,9 +2183,6 @@ static struct command_result *json_preapprovekeysend(struct command *cmd,
 	struct sha256 *payment_hash;
 	struct amount_msat *amount;
 
-	struct json_stream *response;
-	bool approved;
-
 	if (!param(cmd, buffer, params,
 		   p_req("destination", param_node_id, &destination),
 		   p_req("payment_hash", param_sha256, &payment_hash),
@@ -1875,19 +2192,8 @@ static struct command_result *json_preapprovekeysend(struct command *cmd,
 
 	u8 *msg = towire_hsmd_preapprove_keysend(NULL, destination, payment_hash, *amount);
 
-	if (!wire_sync_write(cmd->ld->hsm_fd, take(msg)))
-		fatal("Could not write to HSM: %s", strerror(errno));
-
-	msg = wire_sync_read(tmpctx, cmd->ld->hsm_fd);
-        if (!fromwire_hsmd_preapprove_keysend_reply(msg, &approved))
-		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
-				    "HSM gave bad preapprove_keysend_reply %s", tal_hex(msg, msg));
-
-	if (!approved)
-		return command_fail(cmd, PAY_KEYSEND_PREAPPROVAL_DECLINED, "keysend was declined");
-
-	response = json_stream_success(cmd);
-	return command_success(cmd, response);
+	hsm_req(cmd, cmd->ld, take(msg), preapprove_keysend_reply, cmd);
+	return command_still_pending(cmd);
 }
 
 static const struct json_command preapprovekeysend_command = {
@@ -24,6 +24,7 @@ void *io_loop_with_timers(struct lightningd *ld)
 		/*~ Notice that timers are called here in the event loop like
 		 * anything else, so there are no weird concurrency issues. */
 		if (expired) {
+			ld->generation++;
 			/* This routine is legal in early startup, too. */
 			if (ld->wallet)
 				db_begin_transaction(ld->wallet->db);
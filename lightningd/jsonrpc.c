@@ -16,6 +16,7 @@
 #include "config.h"
 #include <ccan/asort/asort.h>
 #include <ccan/err/err.h>
+#include <ccan/ilog/ilog.h>
 #include <ccan/io/io.h>
 #include <ccan/json_escape/json_escape.h>
 #include <ccan/json_out/json_out.h>
@@ -91,6 +92,10 @@ struct json_connection {
 	 * Since multiple streams could start returning data at once, we
 	 * always service these in order, freeing once empty. */
 	struct json_stream **js_arr;
+
+	/* Size of the last response, to pre-size the next one: clients
+	 * tend to issue the same commands over and over. */
+	size_t js_size_hint;
 };
 
 /**
@@ -106,6 +111,24 @@ struct jsonrpc {
 	/* Map from json command names to usage strings: we don't put this inside
 	 * struct json_command as it's good practice to have those const. */
 	STRMAP(const char *) usagemap;
+
+	/* Statistics for each command name (kept even if it's removed). */
+	STRMAP(struct call_stats *) statsmap;
+
+	/* Responses of cacheable commands, by command_cache_key() */
+	STRMAP(struct cached_response *) cachemap;
+	size_t num_cached;
+	tal_t *cache_ctx;
+};
+
+/* We don't want unlimited combinations of params cached. */
+#define MAX_CACHED_RESPONSES 32
+
+struct cached_response {
+	/* Only valid if ld->generation is still this. */
+	u64 generation;
+	/* The contents of "result" */
+	const char *result;
 };
 
 /* The command itself usually owns the stream, because jcon may get closed.
@@ -116,6 +139,9 @@ static struct json_stream *jcon_new_json_stream(const tal_t *ctx,
 {
 	struct json_stream *js = new_json_stream(ctx, writer, jcon->log);
 
+	if (jcon->js_size_hint)
+		json_stream_reserve(js, jcon->js_size_hint);
+
 	/* Wake writer to start streaming, in case it's not already. */
 	io_wake(jcon);
 
@@ -142,8 +168,12 @@ static void destroy_jcon(struct json_connection *jcon)
 {
 	struct command *c;
 
-	list_for_each(&jcon->commands, c, list)
+	list_for_each(&jcon->commands, c, list) {
 		c->jcon = NULL;
+		/* Don't leave them waiting for output to drain! */
+		if (c->json_stream)
+			json_stream_drained(c->json_stream);
+	}
 
 	/* Make sure this happens last! */
 	tal_free(jcon->log);
@@ -435,6 +465,80 @@ static const struct json_command *find_cmd(const struct jsonrpc *rpc,
 	return NULL;
 }
 
+void call_stats_add(struct call_stats *stats,
+		    struct timerel elapsed,
+		    bool failed,
+		    size_t bytes_in, size_t bytes_out)
+{
+	u64 usec = time_to_usec(elapsed);
+	size_t bucket = ilog64(usec);
+
+	if (bucket >= CALL_STATS_BUCKETS)
+		bucket = CALL_STATS_BUCKETS - 1;
+	stats->hist[bucket]++;
+
+	stats->calls++;
+	if (failed)
+		stats->failures++;
+	stats->bytes_in += bytes_in;
+	stats->bytes_out += bytes_out;
+	stats->total_usec += usec;
+	if (usec > stats->max_usec)
+		stats->max_usec = usec;
+}
+
+u64 call_stats_percentile(const struct call_stats *stats,
+			  unsigned int percent)
+{
+	u64 seen = 0, target = (stats->calls * percent + 99) / 100;
+
+	for (size_t i = 0; i < CALL_STATS_BUCKETS; i++) {
+		seen += stats->hist[i];
+		if (seen >= target) {
+			u64 bound = (1ULL << i) - 1;
+			return bound < stats->max_usec ? bound : stats->max_usec;
+		}
+	}
+	return stats->max_usec;
+}
+
+void json_add_call_stats(struct json_stream *js,
+			 const struct call_stats *stats)
+{
+	json_add_u64(js, "calls", stats->calls);
+	json_add_u64(js, "failures", stats->failures);
+	json_add_u64(js, "bytes_in", stats->bytes_in);
+	json_add_u64(js, "bytes_out", stats->bytes_out);
+	json_add_u64(js, "total_usec", stats->total_usec);
+	json_add_u64(js, "p50_usec", call_stats_percentile(stats, 50));
+	json_add_u64(js, "p99_usec", call_stats_percentile(stats, 99));
+	json_add_u64(js, "max_usec", stats->max_usec);
+	json_add_u64(js, "db_usec", stats->db_usec);
+}
+
+static struct call_stats *command_stats(struct jsonrpc *rpc,
+					const char *name)
+{
+	struct call_stats *stats = strmap_get(&rpc->statsmap, name);
+
+	if (!stats) {
+		stats = talz(rpc, struct call_stats);
+		strmap_add(&rpc->statsmap, tal_strdup(stats, name), stats);
+	}
+	return stats;
+}
+
+static void command_record_stats(const struct command *cmd,
+				 const struct json_stream *result)
+{
+	/* Malformed, or unknown command? */
+	if (!cmd->stats)
+		return;
+
+	call_stats_add(cmd->stats, timemono_since(cmd->start), cmd->failed,
+		       cmd->bytes_in, json_stream_total_len(result));
+}
+
 /* This can be called directly on shutdown, even with unfinished cmd */
 static void destroy_command(struct command *cmd)
 {
@@ -450,6 +554,7 @@ struct command_result *command_raw_complete(struct command *cmd,
 					    struct json_stream *result)
 {
 	json_stream_close(result, cmd);
+	command_record_stats(cmd, result);
 
 	/* If we have a jcon, it will free result for us. */
 	if (cmd->jcon)
@@ -459,6 +564,58 @@ struct command_result *command_raw_complete(struct command *cmd,
 	return &complete;
 }
 
+static const char *command_cache_key(const tal_t *ctx,
+				     const struct command *cmd,
+				     const char *buffer,
+				     const jsmntok_t *request,
+				     const jsmntok_t *params)
+{
+	const jsmntok_t *filter = json_get_member(buffer, request, "filter");
+
+	return tal_fmt(ctx, "%s %.*s %.*s",
+		       cmd->json_cmd->name,
+		       json_tok_full_len(params), json_tok_full(buffer, params),
+		       filter ? json_tok_full_len(filter) : 0,
+		       filter ? json_tok_full(buffer, filter) : "");
+}
+
+/* We've closed the "result" object: save it if nothing changed meanwhile */
+static void command_cache_result(const struct command *cmd,
+				 const struct json_stream *result)
+{
+	struct jsonrpc *rpc = cmd->ld->jsonrpc;
+	struct cached_response *c;
+	const char *p;
+	size_t len;
+
+	if (cmd->generation != cmd->ld->generation)
+		return;
+
+	/* If it paused, some has already been written out. */
+	if (json_stream_total_len(result) != json_stream_buffered(result))
+		return;
+
+	c = strmap_get(&rpc->cachemap, cmd->cache_key);
+	if (!c) {
+		if (rpc->num_cached == MAX_CACHED_RESPONSES) {
+			strmap_clear(&rpc->cachemap);
+			tal_free(rpc->cache_ctx);
+			rpc->cache_ctx = tal(rpc, char);
+			strmap_init(&rpc->cachemap);
+			rpc->num_cached = 0;
+		}
+		c = tal(rpc->cache_ctx, struct cached_response);
+		c->result = NULL;
+		strmap_add(&rpc->cachemap, tal_strdup(c, cmd->cache_key), c);
+		rpc->num_cached++;
+	}
+
+	p = json_out_contents(result->jout, &len);
+	tal_free(c->result);
+	c->result = tal_strndup(c, p + cmd->result_off, len - cmd->result_off);
+	c->generation = cmd->generation;
+}
+
 struct command_result *command_success(struct command *cmd,
 				       struct json_stream *result)
 {
@@ -475,6 +632,8 @@ struct command_result *command_success(struct command *cmd,
 	}
 
 	json_object_end(result);
+	if (cmd->cache_key)
+		command_cache_result(cmd, result);
 	json_object_end(result);
 
 	return command_raw_complete(cmd, result);
@@ -484,6 +643,7 @@ struct command_result *command_failed(struct command *cmd,
 				      struct json_stream *result)
 {
 	assert(cmd->json_stream == result);
+	cmd->failed = true;
 	/* Have to close error */
 	json_object_end(result);
 	json_object_end(result);
@@ -523,6 +683,67 @@ struct command_result *command_still_pending(struct command *cmd)
 	return &pending;
 }
 
+bool command_output_full(const struct command *cmd)
+{
+	/* Without a jcon, nobody will ever drain it! */
+	if (!cmd->jcon || !cmd->json_stream)
+		return false;
+	return json_stream_buffered(cmd->json_stream) > COMMAND_OUTPUT_HIGHWATER;
+}
+
+bool command_should_pause(const struct command *cmd)
+{
+	if (command_output_full(cmd))
+		return true;
+
+	/* Waiting only lets others run if there's something to write. */
+	if (!cmd->jcon || !cmd->json_stream
+	    || json_stream_buffered(cmd->json_stream) == 0)
+		return false;
+
+	return time_greater(timemono_since(cmd->slice_start),
+			    time_from_msec(COMMAND_TIMESLICE_MSEC));
+}
+
+struct output_wait {
+	struct command *cmd;
+	struct command_result *(*cb)(struct command *cmd, void *arg);
+	void *arg;
+};
+
+static void output_wait_resume(struct output_wait *ow)
+{
+	struct command *cmd = ow->cmd;
+	struct command_result *(*cb)(struct command *cmd, void *arg) = ow->cb;
+	void *arg = ow->arg;
+
+	tal_free(ow);
+	cmd->slice_start = time_mono();
+	cb(cmd, arg);
+}
+
+static void output_wait_drained(struct output_wait *ow)
+{
+	/* We're called from inside the reader (or jcon destructor): let
+	 * the caller continue from a clean context (with a db transaction). */
+	new_reltimer(ow->cmd->ld->timers, ow, time_from_msec(0),
+		     output_wait_resume, ow);
+}
+
+struct command_result *command_wait_for_output_(struct command *cmd,
+						struct command_result *(*cb)(struct command *,
+									     void *),
+						void *arg)
+{
+	struct output_wait *ow = tal(cmd, struct output_wait);
+
+	ow->cmd = cmd;
+	ow->cb = cb;
+	ow->arg = arg;
+	json_stream_on_drain(cmd->json_stream, output_wait_drained, ow);
+	return command_still_pending(cmd);
+}
+
 static void json_command_malformed(struct json_connection *jcon,
 				   const char *id,
 				   const char *error)
@@ -613,6 +834,10 @@ struct json_stream *json_stream_success(struct command *cmd)
 	struct json_stream *r = json_start(cmd);
 	json_object_start(r, "result");
 
+	/* Remember where the result's '{' is, in case we cache it. */
+	if (cmd->cache_key)
+		cmd->result_off = json_stream_buffered(r) - 1;
+
 	/* We have results?  OK, start filtering */
 	if (cmd->filter)
 		json_stream_attach_filter(r, cmd->filter);
@@ -651,9 +876,37 @@ static struct command_result *command_exec(struct json_connection *jcon,
                                            const jsmntok_t *params)
 {
 	struct command_result *res;
+	/* Command may complete (and be freed) before we return. */
+	struct call_stats *stats = cmd->stats;
+	struct db *db = cmd->ld->wallet->db;
+	struct timerel db_start;
+
+	if (cmd->json_cmd->cacheable) {
+		struct cached_response *c;
+
+		cmd->cache_key = command_cache_key(cmd, cmd, buffer,
+						   request, params);
+		c = strmap_get(&cmd->ld->jsonrpc->cachemap, cmd->cache_key);
+		if (c && c->generation == cmd->ld->generation) {
+			struct json_stream *js = json_start(cmd);
+			json_add_jsonstr(js, "result",
+					 c->result, strlen(c->result));
+			json_object_end(js);
+			return command_raw_complete(cmd, js);
+		}
+	} else {
+		/* This might change things! */
+		cmd->ld->generation++;
+	}
+	cmd->generation = cmd->ld->generation;
 
+	db_start = db_time_spent(db);
+	cmd->slice_start = time_mono();
 	res = cmd->json_cmd->dispatch(cmd, buffer, request, params);
 
+	/* We can only attribute db time spent synchronously. */
+	stats->db_usec += time_to_usec(time_sub(db_time_spent(db), db_start));
+
 	assert(res == &param_failed
 	       || res == &complete
 	       || res == &pending
@@ -738,6 +991,8 @@ static void replace_command(struct rpc_command_hook_payload *p,
 			      buffer + method->start);
 		goto fail;
 	}
+	p->cmd->stats = command_stats(p->cmd->ld->jsonrpc,
+				      p->cmd->json_cmd->name);
 
 	// deprecated phase to give the possibility to all to migrate and stay safe
 	// from this more restrictive change.
@@ -777,6 +1032,7 @@ static void rpc_command_hook_final(struct rpc_command_hook_payload *p STEALS)
 		json_add_jsonstr(s, "error",
 				 p->custom_error, strlen(p->custom_error));
 		json_object_end(s);
+		p->cmd->failed = true;
 		return was_pending(command_raw_complete(p->cmd, s));
 	}
 	if (p->custom_replace != NULL)
@@ -936,6 +1192,12 @@ parse_request(struct json_connection *jcon, const jsmntok_t tok[])
 			    json_tok_full_len(id));
 	c->mode = CMD_NORMAL;
 	c->filter = NULL;
+	c->json_cmd = NULL;
+	c->stats = NULL;
+	c->start = time_mono();
+	c->bytes_in = json_tok_full_len(tok);
+	c->failed = false;
+	c->cache_key = NULL;
 	list_add_tail(&jcon->commands, &c->list);
 	tal_add_destructor(c, destroy_command);
 
@@ -972,6 +1234,7 @@ parse_request(struct json_connection *jcon, const jsmntok_t tok[])
 				    json_tok_full_len(method),
 				    json_tok_full(jcon->buffer, method));
 	}
+	c->stats = command_stats(jcon->ld->jsonrpc, c->json_cmd->name);
 
 	rpc_hook = tal(c, struct rpc_command_hook_payload);
 	rpc_hook->cmd = c;
@@ -1031,6 +1294,12 @@ static struct io_plan *stream_out_complete(struct io_conn *conn,
 					   struct json_stream *js,
 					   struct json_connection *jcon)
 {
+	/* Bigger responses get paused and drained at the highwater mark
+	 * anyway, so there's no point reserving more than that. */
+	jcon->js_size_hint = json_stream_total_len(js);
+	if (jcon->js_size_hint > COMMAND_OUTPUT_HIGHWATER)
+		jcon->js_size_hint = COMMAND_OUTPUT_HIGHWATER;
+
 	jcon_remove_json_stream(jcon, js);
 	tal_free(js);
 
@@ -1092,9 +1361,9 @@ again:
 	}
 	parse_request(jcon, jcon->input_toks);
 
-	/* Remove first {}. */
+	/* Remove first {} (only move what's actually been read!) */
 	memmove(jcon->buffer, jcon->buffer + jcon->input_toks[0].end,
-		tal_count(jcon->buffer) - jcon->input_toks[0].end);
+		jcon->used - jcon->input_toks[0].end);
 	jcon->used -= jcon->input_toks[0].end;
 
 	/* Reset parser. */
@@ -1147,6 +1416,7 @@ static struct io_plan *jcon_connected(struct io_conn *conn,
 	jcon->input_toks = toks_alloc(jcon);
 	jcon->notifications_enabled = false;
 	jcon->db_batching = false;
+	jcon->js_size_hint = 0;
 	list_head_init(&jcon->commands);
 
 	/* We want to log on destruction, so we free this in destructor. */
@@ -1240,6 +1510,8 @@ static bool jsonrpc_command_add_perm(struct lightningd *ld,
 static void destroy_jsonrpc(struct jsonrpc *jsonrpc)
 {
 	strmap_clear(&jsonrpc->usagemap);
+	strmap_clear(&jsonrpc->statsmap);
+	strmap_clear(&jsonrpc->cachemap);
 }
 
 #if DEVELOPER
@@ -1247,6 +1519,8 @@ static void memleak_help_jsonrpc(struct htable *memtable,
 				 struct jsonrpc *jsonrpc)
 {
 	memleak_scan_strmap(memtable, &jsonrpc->usagemap);
+	memleak_scan_strmap(memtable, &jsonrpc->statsmap);
+	memleak_scan_strmap(memtable, &jsonrpc->cachemap);
 }
 #endif /* DEVELOPER */
 
@@ -1256,6 +1530,10 @@ void jsonrpc_setup(struct lightningd *ld)
 
 	ld->jsonrpc = tal(ld, struct jsonrpc);
 	strmap_init(&ld->jsonrpc->usagemap);
+	strmap_init(&ld->jsonrpc->statsmap);
+	strmap_init(&ld->jsonrpc->cachemap);
+	ld->jsonrpc->num_cached = 0;
+	ld->jsonrpc->cache_ctx = tal(ld->jsonrpc, char);
 	ld->jsonrpc->commands = tal_arr(ld->jsonrpc, struct json_command *, 0);
 	for (size_t i=0; i<num_cmdlist; i++) {
 		if (!jsonrpc_command_add_perm(ld, ld->jsonrpc, commands[i]))
@@ -1564,3 +1842,41 @@ static const struct json_command batching_command = {
 	"Database transaction batching {enable}",
 };
 AUTODATA(json_command, &batching_command);
+
+static bool json_add_method_stats(const char *name,
+				  struct call_stats *stats,
+				  struct json_stream *js)
+{
+	json_object_start(js, NULL);
+	json_add_string(js, "method", name);
+	json_add_call_stats(js, stats);
+	json_object_end(js);
+	return true;
+}
+
+static struct command_result *json_getrpcstats(struct command *cmd,
+					       const char *buffer,
+					       const jsmntok_t *obj UNNEEDED,
+					       const jsmntok_t *params)
+{
+	struct json_stream *response;
+
+	if (!param(cmd, buffer, params, NULL))
+		return command_param_failed();
+
+	response = json_stream_success(cmd);
+	json_array_start(response, "commands");
+	strmap_iterate(&cmd->ld->jsonrpc->statsmap, json_add_method_stats,
+		       response);
+	json_array_end(response);
+	json_add_plugin_hook_stats(response);
+	return command_success(cmd, response);
+}
+
+static const struct json_command getrpcstats_command = {
+	"getrpcstats",
+	"utility",
+	json_getrpcstats,
+	"Show call counts, latencies and sizes for each command and plugin hook",
+};
+AUTODATA(json_command, &getrpcstats_command);
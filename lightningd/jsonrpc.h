@@ -2,6 +2,7 @@
 #define LIGHTNING_LIGHTNINGD_JSONRPC_H
 #include "config.h"
 #include <ccan/list/list.h>
+#include <ccan/time/time.h>
 #include <common/autodata.h>
 #include <common/json_stream.h>
 #include <common/status_levels.h>
@@ -43,6 +44,19 @@ struct command {
 	struct json_stream *json_stream;
 	/* Optional output field filter. */
 	struct json_filter *filter;
+	/* For getrpcstats: where to record, when we started, how big the
+	 * request was, and did we fail? */
+	struct call_stats *stats;
+	struct timemono start;
+	size_t bytes_in;
+	bool failed;
+	/* When we last started running (for command_should_pause) */
+	struct timemono slice_start;
+	/* If non-NULL, save the result under this key, if ld->generation
+	 * is still @generation when we finish. */
+	const char *cache_key;
+	u64 generation;
+	size_t result_off;
 };
 
 /**
@@ -61,8 +75,36 @@ struct json_command {
 	const char *description;
 	bool deprecated;
 	const char *verbose;
+	/* Can we answer identical requests from a cache, as long as
+	 * ld->generation hasn't changed?  Only for read-only commands! */
+	bool cacheable;
 };
 
+/* Latency histogram buckets: bucket i counts calls under 2^i usec. */
+#define CALL_STATS_BUCKETS 32
+
+/* Statistics for a kind of call (a JSON command, or a plugin's hook) */
+struct call_stats {
+	u64 calls, failures;
+	u64 bytes_in, bytes_out;
+	u64 total_usec, max_usec, db_usec;
+	u64 hist[CALL_STATS_BUCKETS];
+};
+
+/* Record one completed call in @stats. */
+void call_stats_add(struct call_stats *stats,
+		    struct timerel elapsed,
+		    bool failed,
+		    size_t bytes_in, size_t bytes_out);
+
+/* Upper bound of the bucket containing the @percent'th percentile */
+u64 call_stats_percentile(const struct call_stats *stats,
+			  unsigned int percent);
+
+/* Add the fields of @stats (with p50 and p99 estimates) to @js. */
+void json_add_call_stats(struct json_stream *js,
+			 const struct call_stats *stats);
+
 struct jsonrpc_notification {
 	/* The topic that this notification is for. Internally this
 	 * will be serialized as "method", hence the different name
@@ -134,6 +176,43 @@ struct command_result *command_failed(struct command *cmd,
 struct command_result *command_still_pending(struct command *cmd)
 	 WARN_UNUSED_RESULT;
 
+/* Once this much output is buffered, big list commands should pause. */
+#define COMMAND_OUTPUT_HIGHWATER (64 * 1024)
+
+/* Has this command buffered enough output that it should wait? */
+bool command_output_full(const struct command *cmd);
+
+/* Once a command has run this long, big list commands should pause. */
+#define COMMAND_TIMESLICE_MSEC 10
+
+/* Should this command call command_wait_for_output, to let others run?
+ * True if its output is full, or it's run for too long since it started
+ * (or last resumed) and has output to wait for. */
+bool command_should_pause(const struct command *cmd);
+
+/**
+ * command_wait_for_output - pause command until its output is written.
+ * @cmd: the command (which must have started its json_stream)
+ * @cb: the callback to continue the command.
+ * @arg: the argument to @cb.
+ *
+ * This lets commands which produce huge responses generate them
+ * incrementally, rather than building them all in memory.  Note that
+ * the world may change before @cb is called!
+ */
+#define command_wait_for_output(cmd, cb, arg)				\
+	command_wait_for_output_((cmd),					\
+				 typesafe_cb_preargs(struct command_result *, \
+						     void *, (cb), (arg), \
+						     struct command *),	\
+				 (arg))
+
+struct command_result *command_wait_for_output_(struct command *cmd,
+						struct command_result *(*cb)(struct command *,
+									     void *),
+						void *arg)
+	WARN_UNUSED_RESULT;
+
 /* For low-level JSON stream access: */
 struct json_stream *json_stream_raw_for_cmd(struct command *cmd);
 void json_stream_log_suppress_for_cmd(struct json_stream *js,
@@ -69,7 +69,9 @@
 #include <lightningd/io_loop_with_timers.h>
 #include <lightningd/lightningd.h>
 #include <lightningd/onchain_control.h>
+#include <lightningd/peer_htlcs.h>
 #include <lightningd/plugin.h>
+#include <lightningd/plugin_hook.h>
 #include <lightningd/subd.h>
 #include <sys/resource.h>
 #include <wallet/txfilter.h>
@@ -188,6 +190,10 @@ static struct lightningd *new_lightningd(const tal_t *ctx)
 	 * in limbo until we get all the parts, or we time them out. */
 	ld->htlc_sets = tal(ld, struct htlc_set_map);
 	htlc_set_map_init(ld->htlc_sets);
+	list_head_init(&ld->htlc_sets_by_expiry);
+	ld->htlc_set_timer = NULL;
+	ld->forward_stats = new_forward_stats(ld);
+	memset(ld->forwards_by_status, 0, sizeof(ld->forwards_by_status));
 
 	/*~ We have a multi-entry log-book infrastructure: we define a 10MB log
 	 * book to hold all the entries (and trims as necessary), and multiple
@@ -278,13 +284,27 @@ static struct lightningd *new_lightningd(const tal_t *ctx)
 	/*~ This is set when a JSON RPC command comes in to shut us down. */
 	ld->stop_conn = NULL;
 
+	/*~ This is bumped by anything which might change our state, so
+	 * JSON RPC can tell if a cached response is still good. */
+	ld->generation = 0;
+
+	/*~ Each channel remembers when it last changed, in this count, so
+	 * `listpeerchannels since` can skip the ones which haven't. */
+	ld->channel_change_index = 0;
+
 	/*~ This is used to signal that `hsm_secret` is encrypted, and will
 	 * be set to `true` if the `--encrypted-hsm` option is passed at startup.
 	 */
 	ld->encrypted_hsm = false;
 
-	/* This is used to override subdaemons */
+	/*~ Big list commands can be answered by a postgres read replica,
+	 * if it's no more than this many seconds behind. */
+	ld->wallet_replica_dsn = NULL;
+	ld->wallet_replica_max_lag = 5;
+
+	/* This is used to override subdaemons, and how they're scheduled */
 	strmap_init(&ld->alt_subdaemons);
+	strmap_init(&ld->subdaemon_scheds);
 	tal_add_destructor(ld, destroy_alt_subdaemons);
 	memleak_add_helper(ld, memleak_help_alt_subdaemons);
 
@@ -313,6 +333,10 @@ static struct lightningd *new_lightningd(const tal_t *ctx)
 	 * each invoice we generate has a different set of channels.  */
 	ld->rr_counter = 0;
 
+	/*~ Invoices reuse the last listincoming reply until our channels
+	 * or the gossip change. */
+	ld->routehint_cache = NULL;
+
 	/*~ Because fee estimates on testnet and regtest are unreliable,
 	 * we allow overriding them with --force-feerates, in which
 	 * case this is a pointer to an enum feerate-indexed array of values */
@@ -346,6 +370,7 @@ bool is_subdaemon(const char *sdname)
 static void destroy_alt_subdaemons(struct lightningd *ld)
 {
 	strmap_clear(&ld->alt_subdaemons);
+	strmap_clear(&ld->subdaemon_scheds);
 }
 
 #if DEVELOPER
@@ -353,6 +378,7 @@ static void memleak_help_alt_subdaemons(struct htable *memtable,
 					struct lightningd *ld)
 {
 	memleak_scan_strmap(memtable, &ld->alt_subdaemons);
+	memleak_scan_strmap(memtable, &ld->subdaemon_scheds);
 }
 #endif /* DEVELOPER */
 
@@ -588,9 +614,9 @@ again:
 	if (peer_node_id_map_first(ld->peers, &it))
 		goto again;
 
-	/*~ Commit the transaction.  Note that the db is actually
-	 * single-threaded, so commits never fail and we don't need
-	 * spin-and-retry logic everywhere. */
+	/*~ Commit the transaction.  Note that only this thread ever writes
+	 * the db (see the threading rules in db/db_sqlite3.c), so commits
+	 * never fail and we don't need spin-and-retry logic everywhere. */
 	db_commit_transaction(ld->wallet->db);
 }
 
@@ -598,11 +624,14 @@ static void shutdown_global_subdaemons(struct lightningd *ld)
 {
 	/* Let everyone shutdown cleanly. */
 	close(ld->hsm_fd);
+	ld->hsm_async = tal_free(ld->hsm_async);
 
 	/*~ The three "global" daemons, which we shutdown explicitly: we
-	 * give them 10 seconds to exit gracefully before killing them.  */
-	ld->connectd = subd_shutdown(ld->connectd, 10);
-	ld->gossip = subd_shutdown(ld->gossip, 10);
+	 * give them 10 seconds to exit gracefully before killing them.
+	 * connectd and gossipd can flush in parallel; hsmd goes last, in
+	 * case either still wants a signature on the way out. */
+	struct subd **subds[] = { &ld->connectd, &ld->gossip };
+	subd_shutdown_many(subds, ARRAY_SIZE(subds), 10);
 	ld->hsm = subd_shutdown(ld->hsm, 10);
 }
 
@@ -697,11 +726,84 @@ static void pidfile_create(const struct lightningd *ld)
 	write_all(pid_fd, pid, strlen(pid));
 }
 
+/*~ With --group-commit-time, db_commit_transaction() doesn't actually
+ * commit, so we can merge many transactions into a single fsync.  This is
+ * only safe if nothing which depends on that state (e.g. telling channeld
+ * it can send revoke_and_ack) leaves before it's durable.  Since ccan/io
+ * only writes once poll() says a fd is writable, we get that by polling
+ * for input only while we accumulate, then committing before we allow any
+ * output.
+ *
+ * Batched db_write plugins also get the changes without us waiting, so we
+ * can't commit until they've acked; we have to keep writing to them while
+ * we wait, of course.  Only their db_write requests go out meanwhile:
+ * notifications and other requests to them are held in the plugin's queue
+ * (see plugin_hook_db_write_holds) until we've flushed. */
+static struct lightningd *group_commit_ld;
+
+static bool group_commit_accumulate(struct lightningd *ld,
+				    struct pollfd *fds, nfds_t nfds,
+				    int timeout, int *ret)
+{
+	static bool accumulating;
+	static struct timemono start;
+	short events[nfds];
+	bool acked = plugin_hook_db_write_synced();
+
+	if (!accumulating) {
+		accumulating = true;
+		start = time_mono();
+	}
+
+	if (acked
+	    && time_greater(timemono_since(start),
+			    time_from_msec(ld->config.group_commit_ms)))
+		goto flush;
+
+	for (size_t i = 0; i < nfds; i++) {
+		events[i] = fds[i].events;
+		if (!plugin_hook_db_write_uses_fd(fds[i].fd))
+			fds[i].events &= ~POLLOUT;
+	}
+	*ret = daemon_poll(fds, nfds, acked ? 0 : timeout);
+	for (size_t i = 0; i < nfds; i++)
+		fds[i].events = events[i];
+
+	if (*ret != 0 || !acked)
+		return true;
+
+flush:
+	accumulating = false;
+	return false;
+}
+
 /*~ ccan/io allows overriding the poll() function that is the very core
  * of the event loop it runs for us.  We override it so that we can do
  * extra sanity checks, and it's also a good point to free the tmpctx. */
 static int io_poll_lightningd(struct pollfd *fds, nfds_t nfds, int timeout)
 {
+	if (group_commit_ld) {
+		struct db *db = group_commit_ld->wallet->db;
+
+		/* Inside a transaction means a nested loop (e.g. the db_write
+		 * hook): that has to make progress, so leave it alone. */
+		if (db_commit_pending(db) && !db_in_transaction(db)) {
+			int ret;
+
+			if (group_commit_accumulate(group_commit_ld,
+						    fds, nfds, timeout, &ret))
+				return ret;
+			db_commit_flush(db);
+
+			/* Don't sleep before writing what we held back. */
+			if (plugin_hook_db_write_release())
+				timeout = 0;
+		}
+	}
+
+	/* Debug logging is only flushed when we're about to wait. */
+	log_flush();
+
 	/* These checks and freeing tmpctx are common to all daemons. */
 	return daemon_poll(fds, nfds, timeout);
 }
@@ -906,6 +1008,7 @@ int main(int argc, char *argv[])
 	int exit_code = 0;
 	char **orig_argv;
 	bool try_reexec;
+	bool db_write_batched, db_write_all_batched;
 
 	/*~ We fork out new processes very very often; every channel gets its
 	 * own process, for example, and we have `hsmd` and `gossipd` and
@@ -1221,6 +1324,19 @@ int main(int argc, char *argv[])
 	/*~ This sets up the ecdh() function in ecdh_hsmd to talk to hsmd */
 	ecdh_hsmd_setup(ld->hsm_fd, hsm_ecdh_failed);
 
+	/*~ From now on, we can merge commits if asked to.  Plugins which
+	 * get every db_write synchronously expect each one to be committed,
+	 * so that's incompatible (unless they use batch mode). */
+	db_write_batched = plugin_hook_db_write_batched(&db_write_all_batched);
+	if (!db_write_all_batched) {
+		if (ld->config.group_commit_ms)
+			log_unusual(ld->log, "Disabling group-commit-time:"
+				    " a db_write plugin does not use batch mode");
+	} else if (ld->config.group_commit_ms || db_write_batched) {
+		db_set_group_commit(ld->wallet->db, true);
+		group_commit_ld = ld;
+	}
+
 	/*~ The root of every backtrace (almost).  This is our main event
 	 *  loop. */
 	void *io_loop_ret = io_loop_with_timers(ld);
@@ -1232,6 +1348,14 @@ int main(int argc, char *argv[])
 	log_debug(ld->log, "io_loop_with_timers: %s", __func__);
 
 stop:
+	/* Make everything durable; shutdown doesn't need to be fast. */
+	if (group_commit_ld) {
+		group_commit_ld = NULL;
+		plugin_hook_db_write_drain();
+		db_set_group_commit(ld->wallet->db, false);
+		plugin_hook_db_write_release();
+	}
+
 	/* Stop *new* JSON RPC requests. */
 	jsonrpc_stop_listening(ld->jsonrpc);
 
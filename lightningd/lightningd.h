@@ -46,9 +46,28 @@ struct config {
 	/* How long between changing commit and sending COMMIT message. */
 	u32 commit_time_ms;
 
+	/* How long channeld may keep delaying commits while busy (0 = don't) */
+	u32 commit_batch_ms;
+
+	/* How long we may merge db commits before making them durable
+	 * (0 = commit every transaction immediately). */
+	u32 group_commit_ms;
+
+	/* Put the sqlite3 wallet into write-ahead-log mode. */
+	bool sqlite3_wal;
+
+	/* Max channel_updates per second we release (0 = unlimited) */
+	u32 channel_update_rate;
+
+	/* Peers to fetch gossip from in parallel with an empty store */
+	u32 gossip_fast_sync_peers;
+
 	/* Do we let the opener set any fee rate they want */
 	bool ignore_fee_limits;
 
+	/* How far back feerate smoothing should reach (0 = no smoothing) */
+	u32 feerate_smoothing_secs;
+
 	/* Number of blocks to rescan from the current head, or absolute
 	 * blockheight if rescan >= 500'000 */
 	s32 rescan;
@@ -85,10 +104,24 @@ struct config {
 
 	/* Require peer to send confirmed inputs */
 	bool require_confirmed_inputs;
+
+	/* Only fetch blocks whose compact filter matches what we watch */
+	bool use_blockfilters;
 };
 
 typedef STRMAP(const char *) alt_subdaemon_map;
 
+/* --subdaemon-sched: how to schedule a subdaemon, applied before exec */
+struct subdaemon_sched {
+	/* As given, for listconfigs */
+	const char *arg;
+	/* Nice value to run at */
+	int nice;
+	/* CPUs to restrict it to, or NULL */
+	u32 *cpus;
+};
+typedef STRMAP(struct subdaemon_sched *) subdaemon_sched_map;
+
 enum lightningd_state {
 	LD_STATE_RUNNING,
 	LD_STATE_SHUTDOWN,
@@ -116,6 +149,14 @@ struct lightningd {
 	 * transaction. */
 	struct jsonrpc *jsonrpc;
 
+	/* Bumped on every event (subdaemon or plugin message, timer, or
+	 * JSON command) which might change state: if it hasn't moved, a
+	 * cacheable command would give the same answer. */
+	u64 generation;
+
+	/* Last channel->change_index handed out. */
+	u64 channel_change_index;
+
 	/* Configuration file name */
 	char *config_filename;
 	/* Configuration settings. */
@@ -180,6 +221,8 @@ struct lightningd {
 	/* Bearer of all my secrets. */
 	int hsm_fd;
 	struct subd *hsm;
+	/* For requests we don't wait for: see hsm_req() */
+	struct hsm_async *hsm_async;
 
 	/* Daemon for routing */
  	struct subd *gossip;
@@ -209,6 +252,14 @@ struct lightningd {
 
 	/* Sets of HTLCs we are holding onto for MPP. */
 	struct htlc_set_map *htlc_sets;
+	/* Those sets in order of expiry, and one timer for the first. */
+	struct list_head htlc_sets_by_expiry;
+	struct oneshot *htlc_set_timer;
+
+	/* How long forwarded HTLCs take at each stage. */
+	struct forward_stats *forward_stats;
+	/* Forwards recorded in each status since startup, for getmetrics. */
+	u64 forwards_by_status[FORWARD_LOCAL_FAILED + 1];
 
 	struct wallet *wallet;
 
@@ -316,7 +367,13 @@ struct lightningd {
 
 	struct plugins *plugins;
 
+	/* Last listincoming reply, so invoices needn't ask every time. */
+	struct routehint_cache *routehint_cache;
+
 	char *wallet_dsn;
+	/* Optional read replica for list commands, and how stale it may be */
+	char *wallet_replica_dsn;
+	u32 wallet_replica_max_lag;
 
 	bool encrypted_hsm;
 
@@ -326,6 +383,7 @@ struct lightningd {
 	struct list_head waitblockheight_commands;
 
 	alt_subdaemon_map alt_subdaemons;
+	subdaemon_sched_map subdaemon_scheds;
 
 	enum lightningd_state state;
 
@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include <lightningd/log.h>
 #include <lightningd/notification.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 
@@ -22,6 +23,9 @@
 /* Once we're up and running, this is set up. */
 struct log *crashlog;
 
+/* Debug and io lines written but not yet flushed: see log_flush(). */
+static bool log_unflushed;
+
 struct print_filter {
 	struct list_node list;
 
@@ -43,6 +47,11 @@ struct log_book {
 	FILE **outfiles;
 	bool print_timestamps;
 
+	/* --log-queue: if non-zero, a thread writes to outfiles. */
+	unsigned int queue_len;
+	/* --log-queue-drop: drop (rather than wait) if that's full. */
+	bool queue_drop;
+
 	struct log_entry *log;
 	/* Prefix this to every entry as you output */
 	const char *prefix;
@@ -126,6 +135,193 @@ static const char *level_prefix(enum log_level level)
 	abort();
 }
 
+/*~ With --log-queue, a separate thread does the fwrite and fflush, so a
+ * slow disk (or a log file on a network filesystem) doesn't stall our
+ * main loop.  It follows the same rules as the sqlite3 threads (see
+ * db/db_sqlite3.c): we format each line here and hand it over malloc'ed,
+ * and the thread only touches the queue (under lock) and the FILEs, never
+ * tal, the log book or ccan/io. */
+struct log_line {
+	struct log_line *next;
+	char *text;
+};
+
+struct log_writer {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	/* Signalled when a line is queued, or we want it to stop. */
+	pthread_cond_t queued_cond;
+	/* Signalled when the thread takes the queue, or goes idle. */
+	pthread_cond_t space_cond;
+
+	/* The thread writes to these: we only change them (log rotation)
+	 * while it's idle and we hold lock. */
+	FILE **files;
+	size_t num_files;
+	/* Used if there are no log files. */
+	FILE *stdout_only[1];
+
+	/* Main thread only. */
+	bool drop;
+	size_t dropped, dropped_total;
+
+	/* The rest are protected by lock. */
+	struct log_line *head, **tail;
+	size_t len, max;
+	bool busy, stop;
+};
+
+static struct log_writer *log_writer;
+
+static void *log_writer_thread(void *arg)
+{
+	struct log_writer *w = arg;
+	struct log_line *batch, *next;
+
+	pthread_mutex_lock(&w->lock);
+	for (;;) {
+		while (!w->head && !w->stop) {
+			w->busy = false;
+			pthread_cond_broadcast(&w->space_cond);
+			pthread_cond_wait(&w->queued_cond, &w->lock);
+		}
+		/* We drain the queue before stopping. */
+		batch = w->head;
+		if (!batch)
+			break;
+		w->head = NULL;
+		w->tail = &w->head;
+		w->len = 0;
+		w->busy = true;
+		pthread_cond_broadcast(&w->space_cond);
+		pthread_mutex_unlock(&w->lock);
+
+		/* One flush per batch, however many lines it has. */
+		for (; batch; batch = next) {
+			next = batch->next;
+			for (size_t i = 0; i < w->num_files; i++)
+				fputs(batch->text, w->files[i]);
+			free(batch->text);
+			free(batch);
+		}
+		for (size_t i = 0; i < w->num_files; i++)
+			fflush(w->files[i]);
+
+		pthread_mutex_lock(&w->lock);
+	}
+	w->busy = false;
+	pthread_cond_broadcast(&w->space_cond);
+	pthread_mutex_unlock(&w->lock);
+	return NULL;
+}
+
+/* Returns false if it's full and we're allowed to drop this. */
+static bool log_writer_queue(struct log_writer *w,
+			     const char *text, enum log_level level)
+{
+	struct log_line *l;
+
+	pthread_mutex_lock(&w->lock);
+	while (w->len >= w->max) {
+		/* With --log-queue-drop, only BROKEN waits for room. */
+		if (w->drop && level < LOG_BROKEN) {
+			pthread_mutex_unlock(&w->lock);
+			return false;
+		}
+		pthread_cond_wait(&w->space_cond, &w->lock);
+	}
+
+	l = malloc(sizeof(*l));
+	l->text = strdup(text);
+	l->next = NULL;
+	*w->tail = l;
+	w->tail = &l->next;
+	w->len++;
+	pthread_cond_signal(&w->queued_cond);
+	pthread_mutex_unlock(&w->lock);
+	return true;
+}
+
+/* Wait for the thread to write out everything queued: with lock held.
+ * If @secs is non-zero, give up after that long (we're crashing). */
+static void log_writer_wait_idle(struct log_writer *w, int secs)
+{
+	struct timespec until;
+
+	clock_gettime(CLOCK_REALTIME, &until);
+	until.tv_sec += secs;
+	while (w->head || w->busy) {
+		if (!secs)
+			pthread_cond_wait(&w->space_cond, &w->lock);
+		else if (pthread_cond_timedwait(&w->space_cond, &w->lock,
+						&until) != 0)
+			break;
+	}
+}
+
+/* Called on the way out: don't lose the last lines (which are often the
+ * most interesting ones). */
+static void log_writer_drain(void)
+{
+	if (!log_writer)
+		return;
+	pthread_mutex_lock(&log_writer->lock);
+	log_writer_wait_idle(log_writer, 5);
+	pthread_mutex_unlock(&log_writer->lock);
+}
+
+static void log_writer_start(struct log_book *lr)
+{
+	struct log_writer *w = tal(lr, struct log_writer);
+
+	if (lr->outfiles) {
+		w->files = lr->outfiles;
+		w->num_files = tal_count(lr->outfiles);
+	} else {
+		w->stdout_only[0] = stdout;
+		w->files = w->stdout_only;
+		w->num_files = 1;
+	}
+	w->drop = lr->queue_drop;
+	w->dropped = w->dropped_total = 0;
+	w->head = NULL;
+	w->tail = &w->head;
+	w->len = 0;
+	w->max = lr->queue_len;
+	w->busy = w->stop = false;
+	pthread_mutex_init(&w->lock, NULL);
+	pthread_cond_init(&w->queued_cond, NULL);
+	pthread_cond_init(&w->space_cond, NULL);
+	if (pthread_create(&w->thread, NULL, log_writer_thread, w) != 0)
+		err(1, "Could not start --log-queue thread");
+
+	log_writer = w;
+	/* exit() doesn't wait for threads. */
+	atexit(log_writer_drain);
+}
+
+static void log_to_writer(struct log_writer *w,
+			  const char *log_prefix,
+			  const char *tstamp,
+			  enum log_level level,
+			  const char *entry)
+{
+	if (w->dropped) {
+		const char *notice;
+
+		notice = tal_fmt(tmpctx, "%s%s%s lightningd: dropped %zu log"
+				 " lines (%zu in total): log-queue full\n",
+				 log_prefix, tstamp, level_prefix(LOG_UNUSUAL),
+				 w->dropped, w->dropped_total);
+		if (log_writer_queue(w, notice, level))
+			w->dropped = 0;
+	}
+	if (!log_writer_queue(w, entry, level)) {
+		w->dropped++;
+		w->dropped_total++;
+	}
+}
+
 static void log_to_files(const char *log_prefix,
 			 const char *entry_prefix,
 			 enum log_level level,
@@ -170,6 +366,24 @@ static void log_to_files(const char *log_prefix,
 					entry_prefix, str);
 	}
 
+	if (log_writer) {
+		log_to_writer(log_writer, log_prefix, tstamp, level, entry);
+		return;
+	}
+
+	/* At debug level we can write thousands of lines per second: a
+	 * write() for each is a real cost.  Anything important (and
+	 * so anything before a crash) still goes out immediately. */
+	if (level < LOG_INFORM) {
+		/* Default if nothing set is stdout */
+		if (!outfiles)
+			fwrite(entry, strlen(entry), 1, stdout);
+		for (size_t i = 0; i < tal_count(outfiles); i++)
+			fwrite(entry, strlen(entry), 1, outfiles[i]);
+		log_unflushed = true;
+		return;
+	}
+
 	/* Default if nothing set is stdout */
 	if (!outfiles) {
 		fwrite(entry, strlen(entry), 1, stdout);
@@ -179,6 +393,16 @@ static void log_to_files(const char *log_prefix,
 		fwrite(entry, strlen(entry), 1, outfiles[i]);
 		fflush(outfiles[i]);
 	}
+	log_unflushed = false;
+}
+
+void log_flush(void)
+{
+	if (log_unflushed) {
+		/* NULL means all output streams, which includes stdout. */
+		fflush(NULL);
+		log_unflushed = false;
+	}
 }
 
 static size_t mem_used(const struct log_entry *e)
@@ -284,6 +508,8 @@ struct log_book *new_log_book(struct lightningd *ld, size_t max_mem)
 	node_id_map_init(lr->cache);
 	lr->log = tal_arr(lr, struct log_entry, 128);
 	lr->print_timestamps = true;
+	lr->queue_len = 0;
+	lr->queue_drop = false;
 	tal_add_destructor(lr, destroy_log_book);
 
 	return lr;
@@ -410,6 +636,25 @@ static void maybe_print(struct log *log, const struct log_entry *l)
 			     log->lr->outfiles);
 }
 
+/* Common tail of logv and log_str, once l->log is set. */
+static void log_entry_finish(struct log *log, struct log_entry *l,
+			     bool call_notifier)
+{
+	size_t log_len = strlen(l->log);
+
+	/* Sanitize any non-printable characters, and replace with '?' */
+	for (size_t i=0; i<log_len; i++)
+		if (l->log[i] < ' ' || l->log[i] >= 0x7f)
+			l->log[i] = '?';
+
+	maybe_print(log, l);
+
+	add_entry(log, &l);
+
+	if (call_notifier)
+		notify_warning(log->lr->ld, l);
+}
+
 void logv(struct log *log, enum log_level level,
 	  const struct node_id *node_id,
 	  bool call_notifier,
@@ -423,20 +668,24 @@ void logv(struct log *log, enum log_level level,
 	if (vasprintf(&l->log, fmt, ap) == -1)
 		abort();
 
-	size_t log_len = strlen(l->log);
-
-	/* Sanitize any non-printable characters, and replace with '?' */
-	for (size_t i=0; i<log_len; i++)
-		if (l->log[i] < ' ' || l->log[i] >= 0x7f)
-			l->log[i] = '?';
-
-	maybe_print(log, l);
+	log_entry_finish(log, l, call_notifier);
+	errno = save_errno;
+}
 
-	add_entry(log, &l);
+void log_str(struct log *log, enum log_level level,
+	     const struct node_id *node_id,
+	     bool call_notifier,
+	     const char *str)
+{
+	int save_errno = errno;
+	struct log_entry *l = new_log_entry(log, level, node_id);
 
-	if (call_notifier)
-		notify_warning(log->lr->ld, l);
+	/* Save a tal header, by using raw malloc. */
+	l->log = strdup(str);
+	if (!l->log)
+		abort();
 
+	log_entry_finish(log, l, call_notifier);
 	errno = save_errno;
 }
 
@@ -647,6 +896,11 @@ static struct io_plan *setup_read(struct io_conn *conn, struct lightningd *ld);
 static struct io_plan *rotate_log(struct io_conn *conn, struct lightningd *ld)
 {
 	log_info(ld->log, "Ending log due to SIGHUP");
+	/* The thread mustn't be writing while we swap the files. */
+	if (log_writer) {
+		pthread_mutex_lock(&log_writer->lock);
+		log_writer_wait_idle(log_writer, 0);
+	}
 	for (size_t i = 0; i < tal_count(ld->log->lr->outfiles); i++) {
 		if (streq(ld->logfiles[i], "-"))
 			continue;
@@ -655,6 +909,8 @@ static struct io_plan *rotate_log(struct io_conn *conn, struct lightningd *ld)
 		if (!ld->log->lr->outfiles[i])
 			err(1, "failed to reopen log file %s", ld->logfiles[i]);
 	}
+	if (log_writer)
+		pthread_mutex_unlock(&log_writer->lock);
 
 	log_info(ld->log, "Started log due to SIGHUP");
 	return setup_read(conn, ld);
@@ -744,6 +1000,12 @@ void opt_register_logging(struct lightningd *ld)
 			       "log prefix");
 	opt_register_early_arg("--log-file=<file>", arg_log_to_file, NULL, ld,
 			       "Also log to file (- for stdout)");
+	opt_register_early_arg("--log-queue", opt_set_uintval, opt_show_uintval,
+			       &ld->log->lr->queue_len,
+			       "Write logs from a separate thread, queueing up to this many lines (0 to write directly)");
+	opt_register_early_noarg("--log-queue-drop", opt_set_bool,
+				 &ld->log->lr->queue_drop,
+				 "If --log-queue is full, drop lines (except BROKEN) rather than waiting");
 }
 
 void logging_options_parsed(struct log_book *lr)
@@ -754,6 +1016,9 @@ void logging_options_parsed(struct log_book *lr)
 		*lr->default_print_level = DEFAULT_LOGLEVEL;
 	}
 
+	if (lr->queue_len)
+		log_writer_start(lr);
+
 	/* Catch up, since before we were only printing BROKEN msgs */
 	for (size_t i = 0; i < lr->num_entries; i++) {
 		const struct log_entry *l = &lr->log[i];
@@ -815,6 +1080,8 @@ void log_backtrace_exit(void)
 	if (!crashlog)
 		return;
 
+	log_writer_drain();
+
 	/* We expect to be in config dir. */
 	snprintf(logfile, sizeof(logfile), "crash.log.%s", timebuf);
 
@@ -846,6 +1113,7 @@ void fatal_vfmt(const char *fmt, va_list ap)
 		exit(1);
 
 	logv(crashlog, LOG_BROKEN, NULL, true, fmt, ap2);
+	log_writer_drain();
 	abort();
 	/* va_copy() must be matched with va_end(), even if unreachable. */
 	va_end(ap2);
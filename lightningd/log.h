@@ -42,6 +42,14 @@ void log_(struct log *log, enum log_level level,
 	PRINTF_FMT(5,6);
 void logv(struct log *log, enum log_level level, const struct node_id *node_id,
 	  bool call_notifier, const char *fmt, va_list ap);
+/* Like log_(), for an already-formatted string (eg. from a subdaemon) */
+void log_str(struct log *log, enum log_level level,
+	     const struct node_id *node_id,
+	     bool call_notifier,
+	     const char *str);
+
+/* Flush any buffered debug-level output to the log files */
+void log_flush(void);
 
 const char *log_prefix(const struct log *log);
 enum log_level log_print_level(struct log *log, const struct node_id *node_id);
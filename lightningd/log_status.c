@@ -25,7 +25,9 @@ bool log_status_msg(struct log *log,
 		if (level != LOG_IO_IN && level != LOG_IO_OUT) {
 			call_notifier = (level == LOG_BROKEN ||
 			         level == LOG_UNUSUAL)? true : false;
-			log_(log, level, node_id, call_notifier, "%s", entry);
+			/* Subdaemon already did the formatting, in parallel
+			 * with us: don't run it through vasprintf again. */
+			log_str(log, level, node_id, call_notifier, entry);
 			return true;
 		}
 		/* FIXME: This would be far more efficient to copy to log in place, rather than doing the additional allocation in fromwire. */
@@ -88,6 +88,55 @@ static const struct json_command dev_memdump_command = {
 };
 AUTODATA(json_command, &dev_memdump_command);
 
+static struct command_result *json_memstats(struct command *cmd,
+					    const char *buffer,
+					    const jsmntok_t *obj UNNEEDED,
+					    const jsmntok_t *params)
+{
+	struct json_stream *response;
+	struct memstat *stats;
+	unsigned int *limit;
+	size_t total_count = 0, total_bytes = 0;
+
+	if (!param(cmd, buffer, params,
+		   p_opt_def("limit", param_number, &limit, 100),
+		   NULL))
+		return command_param_failed();
+
+	stats = memstats(cmd, NULL);
+	for (size_t i = 0; i < tal_count(stats); i++) {
+		total_count += stats[i].count;
+		total_bytes += stats[i].bytes;
+	}
+
+	response = json_stream_success(cmd);
+	json_add_u64(response, "total_allocations", total_count);
+	json_add_u64(response, "total_bytes", total_bytes);
+	json_array_start(response, "memstats");
+	for (size_t i = 0; i < tal_count(stats) && i < *limit; i++) {
+		json_object_start(response, NULL);
+		if (stats[i].label)
+			json_add_string(response, "label", stats[i].label);
+		if (stats[i].parent_label)
+			json_add_string(response, "parent_label",
+					stats[i].parent_label);
+		json_add_u64(response, "count", stats[i].count);
+		json_add_u64(response, "bytes", stats[i].bytes);
+		json_object_end(response);
+	}
+	json_array_end(response);
+
+	return command_success(cmd, response);
+}
+
+static const struct json_command dev_memstats_command = {
+	"dev-memstats",
+	"developer",
+	json_memstats,
+	"Show live memory use grouped by allocation label and parent label"
+};
+AUTODATA(json_command, &dev_memstats_command);
+
 static int json_add_syminfo(void *data, uintptr_t pc UNUSED,
 			    const char *filename, int lineno,
 			    const char *function)
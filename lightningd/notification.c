@@ -1,9 +1,11 @@
 #include "config.h"
 #include <common/configdir.h>
+#include <common/timeout.h>
 #include <common/type_to_string.h>
 #include <lightningd/channel.h>
 #include <lightningd/coin_mvts.h>
 #include <lightningd/notification.h>
+#include <lightningd/peer_control.h>
 
 static struct notification *find_notification_by_topic(const char* topic)
 {
@@ -64,6 +66,9 @@ void notify_connect(struct lightningd *ld,
 			  bool,
 			  const struct wireaddr_internal *) = connect_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, connect_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, connect_notification_gen.topic);
 	serialize(n->stream, nodeid, incoming, addr);
@@ -85,6 +90,9 @@ void notify_disconnect(struct lightningd *ld, struct node_id *nodeid)
 	void (*serialize)(struct json_stream *,
 			  struct node_id *) = disconnect_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, disconnect_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, disconnect_notification_gen.topic);
 	serialize(n->stream, nodeid);
@@ -123,6 +131,9 @@ void notify_warning(struct lightningd *ld, struct log_entry *l)
 	void (*serialize)(struct json_stream *,
 			  struct log_entry *) = warning_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, warning_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, warning_notification_gen.topic);
 	serialize(n->stream, l);
@@ -154,6 +165,9 @@ void notify_invoice_payment(struct lightningd *ld, struct amount_msat amount,
 			  struct preimage,
 			  const struct json_escape *) = invoice_payment_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, invoice_payment_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, invoice_payment_notification_gen.topic);
 	serialize(n->stream, amount, preimage, label);
@@ -189,6 +203,9 @@ void notify_invoice_creation(struct lightningd *ld, struct amount_msat *amount,
 			  struct preimage,
 			  const struct json_escape *) = invoice_creation_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, invoice_creation_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, invoice_creation_notification_gen.topic);
 	serialize(n->stream, amount, preimage, label);
@@ -226,6 +243,9 @@ void notify_channel_opened(struct lightningd *ld, struct node_id *node_id,
 			  struct bitcoin_txid *,
 			  bool) = channel_opened_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, channel_opened_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, channel_opened_notification_gen.topic);
 	serialize(n->stream, node_id, funding_sat, funding_txid, channel_ready);
@@ -285,6 +305,9 @@ void notify_channel_state_changed(struct lightningd *ld,
 			  enum state_change,
 			  char *message) = channel_state_changed_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, channel_state_changed_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, channel_state_changed_notification_gen.topic);
 	serialize(n->stream, peer_id, cid, scid, timestamp, old_state, new_state, cause, message);
@@ -292,6 +315,48 @@ void notify_channel_state_changed(struct lightningd *ld,
 	plugins_notify(ld->plugins, take(n));
 }
 
+static void channel_changed_notification_serialize(struct json_stream *stream,
+						   const struct channel *channel)
+{
+	struct amount_msat total;
+
+	json_object_start(stream, "channel_changed");
+	json_add_node_id(stream, "peer_id", &channel->peer->id);
+	json_add_channel_id(stream, "channel_id", &channel->cid);
+	if (channel->scid)
+		json_add_short_channel_id(stream, "short_channel_id",
+					  channel->scid);
+	else
+		json_add_null(stream, "short_channel_id");
+	json_add_u64(stream, "change_index", channel->change_index);
+	json_add_string(stream, "state", channel_state_name(channel));
+	json_add_bool(stream, "peer_connected",
+		      channel->peer->connected == PEER_CONNECTED);
+	json_add_amount_msat_only(stream, "to_us_msat", channel->our_msat);
+	if (amount_sat_to_msat(&total, channel->funding_sats))
+		json_add_amount_msat_only(stream, "total_msat", total);
+	json_object_end(stream);
+}
+
+REGISTER_NOTIFICATION(channel_changed,
+		      channel_changed_notification_serialize)
+
+void notify_channel_changed(struct lightningd *ld,
+			    const struct channel *channel)
+{
+	void (*serialize)(struct json_stream *,
+			  const struct channel *) = channel_changed_notification_gen.serialize;
+
+	if (!plugins_anyone_cares(ld->plugins, channel_changed_notification_gen.topic))
+		return;
+
+	struct jsonrpc_notification *n
+		= jsonrpc_notification_start(NULL, channel_changed_notification_gen.topic);
+	serialize(n->stream, channel);
+	jsonrpc_notification_end(n);
+	plugins_notify(ld->plugins, take(n));
+}
+
 static void forward_event_notification_serialize(struct json_stream *stream,
 						 const struct htlc_in *in,
 						 const struct short_channel_id *scid_out,
@@ -335,9 +400,9 @@ static void forward_event_notification_serialize(struct json_stream *stream,
 	cur->resolved_time = tal_steal(cur, resolved_time);
 	cur->forward_style = forward_style;
 	cur->htlc_id_in = in->key.id;
+	cur->created_index = 0;
 
-	json_add_forwarding_object(stream, "forward_event",
-				   cur, &in->payment_hash);
+	json_add_forwarding_object(stream, "forward_event", cur, in);
 }
 
 REGISTER_NOTIFICATION(forward_event,
@@ -361,6 +426,9 @@ void notify_forward_event(struct lightningd *ld,
 			  struct timeabs *,
 			  enum forward_style) = forward_event_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, forward_event_notification_gen.topic))
+		return;
+
 	struct jsonrpc_notification *n
 		= jsonrpc_notification_start(NULL, forward_event_notification_gen.topic);
 	serialize(n->stream, in, scid_out, amount_out, state, failcode, resolved_time, forward_style);
@@ -385,6 +453,9 @@ void notify_sendpay_success(struct lightningd *ld,
 	void (*serialize)(struct json_stream *,
 			  const struct wallet_payment *) = sendpay_success_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, "sendpay_success"))
+		return;
+
 	struct jsonrpc_notification *n =
 	    jsonrpc_notification_start(NULL, "sendpay_success");
 	serialize(n->stream, payment);
@@ -434,6 +505,9 @@ void notify_sendpay_failure(struct lightningd *ld,
 			  const struct routing_failure *,
 			  const char *) = sendpay_failure_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, "sendpay_failure"))
+		return;
+
 	struct jsonrpc_notification *n =
 	    jsonrpc_notification_start(NULL, "sendpay_failure");
 	serialize(n->stream, payment, pay_errcode, onionreply, fail, errmsg);
@@ -442,7 +516,7 @@ void notify_sendpay_failure(struct lightningd *ld,
 }
 
 static void json_mvt_id(struct json_stream *stream, enum mvt_type mvt_type,
-			struct mvt_id *id)
+			const struct mvt_id *id)
 {
 	switch (mvt_type) {
 		case CHAIN_MVT:
@@ -476,10 +550,11 @@ static void json_mvt_id(struct json_stream *stream, enum mvt_type mvt_type,
 	abort();
 }
 
-static void coin_movement_notification_serialize(struct json_stream *stream,
-						 struct coin_mvt *mvt)
+static void json_add_coin_mvt(struct json_stream *stream,
+			      const char *fieldname,
+			      const struct coin_mvt *mvt)
 {
-	json_object_start(stream, "coin_movement");
+	json_object_start(stream, fieldname);
 	json_add_num(stream, "version", mvt->version);
 	json_add_node_id(stream, "node_id", mvt->node_id);
 	if (mvt->peer_id)
@@ -528,20 +603,75 @@ static void coin_movement_notification_serialize(struct json_stream *stream,
 	json_object_end(stream);
 }
 
+static void coin_movement_notification_serialize(struct json_stream *stream,
+						 struct coin_mvt *mvt)
+{
+	json_add_coin_mvt(stream, "coin_movement", mvt);
+}
+
 REGISTER_NOTIFICATION(coin_movement,
 		      coin_movement_notification_serialize);
 
+/* Adds one movement to the "coin_movements" array. */
+static void coin_movements_notification_serialize(struct json_stream *stream,
+						  struct coin_mvt *mvt)
+{
+	json_add_coin_mvt(stream, NULL, mvt);
+}
+
+REGISTER_NOTIFICATION(coin_movements,
+		      coin_movements_notification_serialize);
+
+/* The coin_movements notification we're building this io_loop iteration */
+static struct jsonrpc_notification *coin_mvts_batch;
+static struct oneshot *coin_mvts_timer;
+
+static void coin_mvts_batch_send(struct lightningd *ld)
+{
+	coin_mvts_timer = NULL;
+	notify_coin_mvts_flush(ld);
+}
+
+void notify_coin_mvts_flush(struct lightningd *ld)
+{
+	if (!coin_mvts_batch)
+		return;
+
+	coin_mvts_timer = tal_free(coin_mvts_timer);
+	json_array_end(coin_mvts_batch->stream);
+	jsonrpc_notification_end(coin_mvts_batch);
+	plugins_notify(ld->plugins, take(coin_mvts_batch));
+	coin_mvts_batch = NULL;
+}
+
 void notify_coin_mvt(struct lightningd *ld,
 		     const struct coin_mvt *mvt)
 {
 	void (*serialize)(struct json_stream *,
 			  const struct coin_mvt *) = coin_movement_notification_gen.serialize;
 
-	struct jsonrpc_notification *n =
-		jsonrpc_notification_start(NULL, "coin_movement");
-	serialize(n->stream, mvt);
-	jsonrpc_notification_end(n);
-	plugins_notify(ld->plugins, take(n));
+	if (plugins_anyone_cares(ld->plugins, "coin_movement")) {
+		struct jsonrpc_notification *n =
+			jsonrpc_notification_start(NULL, "coin_movement");
+		serialize(n->stream, mvt);
+		jsonrpc_notification_end(n);
+		plugins_notify(ld->plugins, take(n));
+	}
+
+	if (!plugins_anyone_cares(ld->plugins, "coin_movements"))
+		return;
+
+	/* Gather up everything from this io_loop iteration, in order. */
+	serialize = coin_movements_notification_gen.serialize;
+	if (!coin_mvts_batch) {
+		coin_mvts_batch = jsonrpc_notification_start(ld,
+							     "coin_movements");
+		json_array_start(coin_mvts_batch->stream, "coin_movements");
+		coin_mvts_timer = new_reltimer(ld->timers, ld,
+					       time_from_msec(0),
+					       coin_mvts_batch_send, ld);
+	}
+	serialize(coin_mvts_batch->stream, mvt);
 }
 
 static void balance_snapshot_notification_serialize(struct json_stream *stream, struct balance_snapshot *snap)
@@ -577,6 +707,9 @@ void notify_balance_snapshot(struct lightningd *ld,
 	void (*serialize)(struct json_stream *,
 			  const struct balance_snapshot *) = balance_snapshot_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, "balance_snapshot"))
+		return;
+
 	struct jsonrpc_notification *n =
 		jsonrpc_notification_start(NULL, "balance_snapshot");
 	serialize(n->stream, snap);
@@ -603,6 +736,9 @@ void notify_block_added(struct lightningd *ld,
 	void (*serialize)(struct json_stream *,
 			  const struct block *block) = block_added_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, "block_added"))
+		return;
+
 	struct jsonrpc_notification *n =
 		jsonrpc_notification_start(NULL, "block_added");
 	serialize(n->stream, block);
@@ -631,6 +767,9 @@ void notify_openchannel_peer_sigs(struct lightningd *ld,
 			  const struct channel_id *cid,
 			  const struct wally_psbt *) = openchannel_peer_sigs_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, "openchannel_peer_sigs"))
+		return;
+
 	struct jsonrpc_notification *n =
 		jsonrpc_notification_start(NULL, "openchannel_peer_sigs");
 	serialize(n->stream, cid, psbt);
@@ -655,6 +794,9 @@ void notify_channel_open_failed(struct lightningd *ld,
 	void (*serialize)(struct json_stream *,
 			  const struct channel_id *) = channel_open_failed_notification_gen.serialize;
 
+	if (!plugins_anyone_cares(ld->plugins, "channel_open_failed"))
+		return;
+
 	struct jsonrpc_notification *n =
 		jsonrpc_notification_start(NULL, "channel_open_failed");
 	serialize(n->stream, cid);
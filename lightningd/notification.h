@@ -7,6 +7,7 @@
 #include <lightningd/plugin.h>
 
 struct balance_snapshot;
+struct channel;
 struct onionreply;
 struct wally_psbt;
 
@@ -60,6 +61,9 @@ void notify_channel_state_changed(struct lightningd *ld,
 				  enum state_change cause,
 				  char *message);
 
+void notify_channel_changed(struct lightningd *ld,
+			    const struct channel *channel);
+
 void notify_forward_event(struct lightningd *ld,
 			  const struct htlc_in *in,
 			  /* May be NULL if we don't know. */
@@ -84,6 +88,9 @@ void notify_sendpay_failure(struct lightningd *ld,
 void notify_coin_mvt(struct lightningd *ld,
 		     const struct coin_mvt *mvt);
 
+/* Send any coin_movements still waiting for the end of this iteration. */
+void notify_coin_mvts_flush(struct lightningd *ld);
+
 void notify_balance_snapshot(struct lightningd *ld,
 			     const struct balance_snapshot *snap);
 
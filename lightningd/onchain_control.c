@@ -607,6 +607,7 @@ enum watch_result onchaind_funding_spent(struct channel *channel,
 {
 	u8 *msg;
 	struct bitcoin_txid our_last_txid;
+	struct bitcoin_tx *last_tx;
 	struct lightningd *ld = channel->peer->ld;
 	struct pubkey final_key;
 	int hsmfd;
@@ -679,10 +680,13 @@ enum watch_result onchaind_funding_spent(struct channel *channel,
 		return KEEP_WATCHING;
 	}
 
+	/* Onchain channels we loaded have left this in the db. */
+	last_tx = channel_last_tx(channel);
+
 	/* This could be a mutual close, but it doesn't matter.
 	 * We don't need this for stub channels as well */
 	if (!is_stub_scid(channel->scid))
-		bitcoin_txid(channel->last_tx, &our_last_txid);
+		bitcoin_txid(last_tx, &our_last_txid);
 	else
 	/* Dummy txid for stub channel to make valgrind happy. */
 		bitcoin_txid_from_hex("80cea306607b708a03a1854520729d"
@@ -702,9 +706,9 @@ enum watch_result onchaind_funding_spent(struct channel *channel,
 			/* We have at least one data point: the last tx's feerate. */
 			struct amount_sat fee = channel->funding_sats;
 			for (size_t j = 0;
-			     j < channel->last_tx->wtx->num_outputs; j++) {
+			     j < last_tx->wtx->num_outputs; j++) {
 				struct amount_asset asset =
-					bitcoin_tx_output_get_amount(channel->last_tx, j);
+					bitcoin_tx_output_get_amount(last_tx, j);
 				struct amount_sat amt;
 				assert(amount_asset_is_main(&asset));
 				amt = amount_asset_to_sat(&asset);
@@ -716,7 +720,7 @@ enum watch_result onchaind_funding_spent(struct channel *channel,
 								  &channel->funding_sats),
 						   type_to_string(tmpctx,
 								  struct bitcoin_tx,
-								  channel->last_tx));
+								  last_tx));
 					return KEEP_WATCHING;
 				}
 			}
@@ -765,7 +769,7 @@ enum watch_result onchaind_funding_spent(struct channel *channel,
 				  blockheight,
 				  /* FIXME: config for 'reasonable depth' */
 				  3,
-				  channel->last_htlc_sigs,
+				  channel_last_htlc_sigs(channel),
 				  channel->min_possible_feerate,
 				  channel->max_possible_feerate,
 				  channel->future_per_commitment_point,
@@ -777,6 +781,9 @@ enum watch_result onchaind_funding_spent(struct channel *channel,
 				  feerate_min(ld, NULL));
 	subd_send_msg(channel->owner, take(msg));
 
+	/* onchaind has everything it needs now: don't keep a copy. */
+	channel_unload_last_tx(channel);
+
 	watch_tx_and_outputs(channel, tx);
 
 	/* We keep watching until peer finally deleted, for reorgs. */
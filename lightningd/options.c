@@ -22,6 +22,7 @@
 #include <lightningd/options.h>
 #include <lightningd/plugin.h>
 #include <lightningd/subd.h>
+#include <sched.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 
@@ -389,6 +390,92 @@ static char *opt_subdaemon(const char *arg, struct lightningd *ld)
 	return NULL;
 }
 
+#ifdef __linux__
+/* Parses "0-3,6" into an array of CPU numbers */
+static char *parse_cpulist(const tal_t *ctx, const char *arg, u32 **cpus)
+{
+	char **ranges = tal_strsplit(tmpctx, arg, ",", STR_NO_EMPTY);
+
+	*cpus = tal_arr(ctx, u32, 0);
+	for (size_t i = 0; ranges[i]; i++) {
+		char *endp;
+		unsigned long first, last;
+
+		first = last = strtoul(ranges[i], &endp, 10);
+		if (endp == ranges[i])
+			return tal_fmt(NULL, "bad CPU list '%s'", arg);
+		if (*endp == '-') {
+			const char *start = endp + 1;
+			last = strtoul(start, &endp, 10);
+			if (endp == start)
+				return tal_fmt(NULL, "bad CPU list '%s'", arg);
+		}
+		if (*endp || last < first)
+			return tal_fmt(NULL, "bad CPU list '%s'", arg);
+		if (last >= CPU_SETSIZE)
+			return tal_fmt(NULL, "CPU %lu is too large", last);
+		for (u32 cpu = first; cpu <= last; cpu++)
+			tal_arr_expand(cpus, cpu);
+	}
+	if (tal_count(*cpus) == 0)
+		return tal_fmt(NULL, "empty CPU list");
+	return NULL;
+}
+#endif /* __linux__ */
+
+static char *opt_subdaemon_sched(const char *arg, struct lightningd *ld)
+{
+	char *subdaemon, *endp, *err;
+	const char *p;
+	struct subdaemon_sched *sched;
+	long nice;
+
+	/* example arg: "gossipd:10:2-3" */
+	size_t colonoff = strcspn(arg, ":");
+	if (!arg[colonoff])
+		return tal_fmt(NULL, "argument must contain ':'");
+
+	subdaemon = tal_strndup(ld, arg, colonoff);
+	if (!is_subdaemon(subdaemon)) {
+		err = tal_fmt(NULL, "\"%s\" is not a subdaemon", subdaemon);
+		tal_free(subdaemon);
+		return err;
+	}
+
+	/* Make the value a tal-child of the subdaemon */
+	sched = tal(subdaemon, struct subdaemon_sched);
+	sched->arg = tal_strdup(sched, arg);
+	sched->cpus = NULL;
+
+	p = arg + colonoff + 1;
+	nice = strtol(p, &endp, 10);
+	if (endp == p || (*endp && *endp != ':')
+	    || nice < -20 || nice > 19) {
+		tal_free(subdaemon);
+		return tal_fmt(NULL, "nice value must be between -20 and 19");
+	}
+	sched->nice = nice;
+
+	if (*endp == ':') {
+#ifdef __linux__
+		err = parse_cpulist(sched, endp + 1, &sched->cpus);
+		if (err) {
+			tal_free(subdaemon);
+			return err;
+		}
+#else
+		tal_free(subdaemon);
+		return tal_fmt(NULL, "CPU lists are only supported on Linux");
+#endif
+	}
+
+	/* Replace any previous setting for this subdaemon. */
+	tal_free(strmap_del(&ld->subdaemon_scheds, subdaemon, NULL));
+	strmap_add(&ld->subdaemon_scheds, subdaemon, sched);
+
+	return NULL;
+}
+
 static char *opt_add_bind_addr(const char *arg, struct lightningd *ld)
 {
 	struct wireaddr_internal addr;
@@ -506,6 +593,12 @@ static char *opt_disable_plugin(const char *arg, struct lightningd *ld)
 	return NULL;
 }
 
+static char *opt_lazy_plugin(const char *arg, struct lightningd *ld)
+{
+	plugin_lazy(ld->plugins, arg);
+	return NULL;
+}
+
 static char *opt_add_plugin_dir(const char *arg, struct lightningd *ld)
 {
 	return add_plugin_dir(ld->plugins, arg, false);
@@ -830,6 +923,21 @@ static const struct config testnet_config = {
 	/* Send commit 10msec after receiving; almost immediately. */
 	.commit_time_ms = 10,
 
+	/* Don't keep delaying commits for bursts. */
+	.commit_batch_ms = 0,
+
+	/* Every transaction is durable on its own. */
+	.group_commit_ms = 0,
+
+	/* Leave the sqlite3 journal mode alone. */
+	.sqlite3_wal = false,
+
+	/* Send our channel_updates as fast as we make them. */
+	.channel_update_rate = 0,
+
+	/* Sync gossip from one peer at a time. */
+	.gossip_fast_sync_peers = 0,
+
 	/* Allow dust payments */
 	.fee_base = 1,
 	/* Take 0.001% */
@@ -838,6 +946,9 @@ static const struct config testnet_config = {
 	/* Testnet sucks */
 	.ignore_fee_limits = true,
 
+	/* Most of the weight on the last two minutes of estimates */
+	.feerate_smoothing_secs = 120,
+
 	/* Rescan 5 hours of blocks on testnet, it's reorg happy */
 	.rescan = 30,
 
@@ -860,6 +971,8 @@ static const struct config testnet_config = {
 	.allowdustreserve = false,
 
 	.require_confirmed_inputs = false,
+
+	.use_blockfilters = false,
 };
 
 /* aka. "Dude, where's my coins?" */
@@ -901,6 +1014,21 @@ static const struct config mainnet_config = {
 	/* Send commit 10msec after receiving; almost immediately. */
 	.commit_time_ms = 10,
 
+	/* Don't keep delaying commits for bursts. */
+	.commit_batch_ms = 0,
+
+	/* Every transaction is durable on its own. */
+	.group_commit_ms = 0,
+
+	/* Leave the sqlite3 journal mode alone. */
+	.sqlite3_wal = false,
+
+	/* Send our channel_updates as fast as we make them. */
+	.channel_update_rate = 0,
+
+	/* Sync gossip from one peer at a time. */
+	.gossip_fast_sync_peers = 0,
+
 	/* Discourage dust payments */
 	.fee_base = 1000,
 	/* Take 0.001% */
@@ -909,6 +1037,9 @@ static const struct config mainnet_config = {
 	/* Mainnet should have more stable fees */
 	.ignore_fee_limits = false,
 
+	/* Most of the weight on the last two minutes of estimates */
+	.feerate_smoothing_secs = 120,
+
 	/* Rescan 2.5 hours of blocks on startup, it's not so reorg happy */
 	.rescan = 15,
 
@@ -931,6 +1062,8 @@ static const struct config mainnet_config = {
 	.allowdustreserve = false,
 
 	.require_confirmed_inputs = false,
+
+	.use_blockfilters = false,
 };
 
 static void check_config(struct lightningd *ld)
@@ -1127,6 +1260,9 @@ static void register_opts(struct lightningd *ld)
 	opt_register_early_arg("--disable-plugin", opt_disable_plugin,
 			       NULL, ld,
 			       "Disable a particular plugin by filename/name");
+	opt_register_early_arg("--lazy-plugin", opt_lazy_plugin,
+			       NULL, ld,
+			       "Don't initialize a plugin by filename/name at startup until one of its methods or hooks is used");
 
 	opt_register_early_arg("--important-plugin", opt_important_plugin,
 			       NULL, ld,
@@ -1211,13 +1347,49 @@ static void register_opts(struct lightningd *ld)
 			 opt_set_u32, opt_show_u32,
 			 &ld->config.commit_time_ms,
 			 "Time after changes before sending out COMMIT");
+	opt_register_arg("--commit-batch-time=<milliseconds>",
+			 opt_set_u32, opt_show_u32,
+			 &ld->config.commit_batch_ms,
+			 "Maximum time to keep delaying COMMIT while changes keep arriving (0 to disable)");
+	opt_register_arg("--group-commit-time=<milliseconds>",
+			 opt_set_u32, opt_show_u32,
+			 &ld->config.group_commit_ms,
+			 "Maximum time to merge database commits (0 to disable)");
+	opt_register_arg("--wallet-replica", opt_set_talstr, NULL,
+			 &ld->wallet_replica_dsn,
+			 "Read replica of a postgres wallet, for list commands");
+	opt_register_arg("--wallet-replica-max-lag=<seconds>",
+			 opt_set_u32, opt_show_u32,
+			 &ld->wallet_replica_max_lag,
+			 "Don't use wallet-replica while it is further behind than this");
+	opt_register_noarg("--sqlite3-wal", opt_set_bool,
+			   &ld->config.sqlite3_wal,
+			   "Use write-ahead logging for the sqlite3 wallet");
 	opt_register_arg("--fee-base", opt_set_u32, opt_show_u32,
 			 &ld->config.fee_base,
 			 "Millisatoshi minimum to charge for HTLC");
+	opt_register_arg("--feerate-smoothing-time=<seconds>",
+			 opt_set_u32, opt_show_u32,
+			 &ld->config.feerate_smoothing_secs,
+			 "Smooth feerate estimates over this long (0 to disable)");
 	opt_register_arg("--rescan", opt_set_s32, opt_show_s32,
 			 &ld->config.rescan,
 			 "Number of blocks to rescan from the current head, or "
 			 "absolute blockheight if negative");
+	opt_register_arg("--use-blockfilters", opt_set_bool_arg, opt_show_bool,
+			 &ld->config.use_blockfilters,
+			 "Check compact block filters, and only fetch blocks"
+			 " which match (needs backend support)");
+	opt_register_arg("--channel-update-rate=<per-second>",
+			 opt_set_u32, opt_show_u32,
+			 &ld->config.channel_update_rate,
+			 "Spread bursts of our channel_updates out to at most"
+			 " this many per second (0 = unlimited)");
+	opt_register_arg("--gossip-fast-sync=<peers>",
+			 opt_set_u32, opt_show_u32,
+			 &ld->config.gossip_fast_sync_peers,
+			 "With no gossip yet, fetch it from this many peers in"
+			 " parallel (0 = stream from one peer)");
 	opt_register_arg("--fee-per-satoshi", opt_set_u32, opt_show_u32,
 			 &ld->config.fee_per_satoshi,
 			 "Microsatoshi fee for every satoshi in HTLC");
@@ -1299,6 +1471,12 @@ static void register_opts(struct lightningd *ld)
 			 "For example, "
 			 "--subdaemon=hsmd:remote_signer "
 			 "would use a hypothetical remote signing subdaemon.");
+	opt_register_arg("--subdaemon-sched", opt_subdaemon_sched, NULL,
+			 ld, "Arg specified as SUBDAEMON:NICE[:CPUS]. "
+			 "Runs the subdaemon at the given nice value, "
+			 "and (on Linux) only on the given CPUs, "
+			 "e.g. --subdaemon-sched=gossipd:10:2-3. "
+			 "This option may be specified multiple times.");
 
 	opt_register_arg("--experimental-websocket-port",
 			 opt_set_websocket_port, NULL,
@@ -1592,6 +1770,24 @@ static void json_add_opt_subdaemons(struct json_stream *response,
 	strmap_iterate(alt_subdaemons, json_add_opt_alt_subdaemon, &args);
 }
 
+static bool json_add_opt_subdaemon_sched(const char *member,
+					 struct subdaemon_sched *sched,
+					 struct json_add_opt_alt_subdaemon_args *argp)
+{
+	json_add_string(argp->response, argp->name0, sched->arg);
+	return true;
+}
+
+static void json_add_opt_subdaemon_scheds(struct json_stream *response,
+					  const char *name0,
+					  subdaemon_sched_map *scheds)
+{
+	struct json_add_opt_alt_subdaemon_args args;
+	args.name0 = name0;
+	args.response = response;
+	strmap_iterate(scheds, json_add_opt_subdaemon_sched, &args);
+}
+
 static void add_config(struct lightningd *ld,
 		       struct json_stream *response,
 		       const struct opt_table *opt,
@@ -1721,6 +1917,10 @@ static void add_config(struct lightningd *ld,
 			json_add_opt_subdaemons(response, name0,
 						    &ld->alt_subdaemons);
 			return;
+		} else if (opt->cb_arg == (void *)opt_subdaemon_sched) {
+			json_add_opt_subdaemon_scheds(response, name0,
+						      &ld->subdaemon_scheds);
+			return;
 		} else if (opt->cb_arg == (void *)opt_add_proxy_addr) {
 			if (ld->proxyaddr)
 				answer = fmt_wireaddr(name0, ld->proxyaddr);
@@ -1730,6 +1930,8 @@ static void add_config(struct lightningd *ld,
 			json_add_opt_log_levels(response, ld->log);
 		} else if (opt->cb_arg == (void *)opt_disable_plugin) {
 			json_add_opt_disable_plugins(response, ld->plugins);
+		} else if (opt->cb_arg == (void *)opt_lazy_plugin) {
+			json_add_opt_lazy_plugins(response, ld->plugins);
 		} else if (opt->cb_arg == (void *)opt_force_feerates) {
 			answer = fmt_force_feerates(name0, ld->force_feerates);
 		} else if (opt->cb_arg == (void *)opt_set_websocket_port) {
@@ -891,7 +891,7 @@ send_payment_core(struct lightningd *ld,
 	struct command_result *invreq_err;
 
 	/* Now, do we already have one or more payments? */
-	payments = wallet_payment_list(tmpctx, ld->wallet, rhash);
+	payments = wallet_payment_list(tmpctx, ld->wallet, rhash, NULL, 0, NULL);
 	for (size_t i = 0; i < tal_count(payments); i++) {
 		log_debug(ld->log, "Payment %zu/%zu: %s %s",
 			  i, tal_count(payments),
@@ -1566,12 +1566,16 @@ static struct command_result *json_listsendpays(struct command *cmd,
 	struct sha256 *rhash;
 	const char *invstring;
 	enum wallet_payment_status *status;
+	u64 *start;
+	u32 *limit;
 
 	if (!param(cmd, buffer, params,
 		   /* FIXME: parameter should be invstring now */
 		   p_opt("bolt11", param_string, &invstring),
 		   p_opt("payment_hash", param_sha256, &rhash),
 		   p_opt("status", param_payment_status, &status),
+		   p_opt_def("start", param_u64, &start, 0),
+		   p_opt("limit", param_u32, &limit),
 		   NULL))
 		return command_param_failed();
 
@@ -1603,13 +1607,12 @@ static struct command_result *json_listsendpays(struct command *cmd,
 		}
 	}
 
-	payments = wallet_payment_list(cmd, cmd->ld->wallet, rhash);
+	payments = wallet_payment_list(cmd, cmd->ld->wallet, rhash, status,
+				       *start, limit);
 	response = json_stream_success(cmd);
 
 	json_array_start(response, "payments");
 	for (size_t i = 0; i < tal_count(payments); i++) {
-		if (status && payments[i]->status != *status)
-			continue;
 		json_object_start(response, NULL);
 		json_add_payment_fields(response, payments[i]);
 		json_object_end(response);
@@ -1623,7 +1626,8 @@ static const struct json_command listsendpays_command = {
 	"listsendpays",
 	"payment",
 	json_listsendpays,
-	"Show sendpay, old and current, optionally limiting to {bolt11} or {payment_hash}."
+	"Show sendpay, old and current, optionally limiting to {bolt11} or {payment_hash}, "
+	"and to at most {limit} starting at id {start}."
 };
 AUTODATA(json_command, &listsendpays_command);
 
@@ -1675,7 +1679,8 @@ static struct command_result *json_delpay(struct command *cmd,
 		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
 				    "Must set both partid and groupid, or neither");
 
-	payments = wallet_payment_list(cmd, cmd->ld->wallet, payment_hash);
+	payments = wallet_payment_list(cmd, cmd->ld->wallet, payment_hash,
+				       NULL, 0, NULL);
 
 	if (tal_count(payments) == 0)
 		return command_fail(cmd, PAY_NO_SUCH_PAYMENT, "Unknown payment with payment_hash: %s",
@@ -1727,6 +1732,41 @@ static const struct json_command delpay_command = {
 };
 AUTODATA(json_command, &delpay_command);
 
+static struct command_result *json_delpays(struct command *cmd,
+					   const char *buffer,
+					   const jsmntok_t *obj UNNEEDED,
+					   const jsmntok_t *params)
+{
+	struct json_stream *response;
+	enum wallet_payment_status *status;
+	u64 *before;
+	u32 *limit;
+	u64 deleted;
+
+	if (!param(cmd, buffer, params,
+		   p_req("status", param_payment_status_nopending, &status),
+		   p_req("before", param_u64, &before),
+		   p_opt_def("limit", param_u32, &limit, UINT32_MAX),
+		   NULL))
+		return command_param_failed();
+
+	deleted = wallet_payments_delete_before(cmd->ld->wallet, *status,
+						*before,
+						*limit);
+
+	response = json_stream_success(cmd);
+	json_add_u64(response, "deleted", deleted);
+	return command_success(cmd, response);
+}
+
+static const struct json_command delpays_command = {
+	"delpays",
+	"payment",
+	json_delpays,
+	"Delete payments with {status} created before UNIX time {before}, at most [limit]",
+};
+AUTODATA(json_command, &delpays_command);
+
 static struct command_result *json_createonion(struct command *cmd,
 						const char *buffer,
 						const jsmntok_t *obj UNNEEDED,
@@ -4,6 +4,7 @@
 #include <bitcoin/script.h>
 #include <bitcoin/tx.h>
 #include <ccan/array_size/array_size.h>
+#include <ccan/asort/asort.h>
 #include <ccan/cast/cast.h>
 #include <ccan/io/io.h>
 #include <ccan/mem/mem.h>
@@ -295,6 +296,7 @@ void drop_to_chain(struct lightningd *ld, struct channel *channel,
 		   bool cooperative)
 {
 	struct channel_inflight *inflight;
+	struct bitcoin_tx *last_tx = channel_last_tx(channel);
 	const char *cmd_id;
 
 	/* If this was triggered by a close command, get a copy of the cmd id */
@@ -311,7 +313,7 @@ void drop_to_chain(struct lightningd *ld, struct channel *channel,
 		log_broken(channel->log,
 			   "Cannot broadcast our commitment tx:"
 			   " they have a future one");
-	} else if (invalid_last_tx(channel->last_tx)) {
+	} else if (invalid_last_tx(last_tx)) {
 		log_broken(channel->log,
 			   "Cannot broadcast our commitment tx:"
 			   " it's invalid! (ancient channel?)");
@@ -323,7 +325,7 @@ void drop_to_chain(struct lightningd *ld, struct channel *channel,
 						   inflight->last_tx,
 						   &inflight->last_sig);
 		} else
-			sign_and_send_last(ld, channel, cmd_id, channel->last_tx,
+			sign_and_send_last(ld, channel, cmd_id, last_tx,
 					   &channel->last_sig);
 	}
 
@@ -696,6 +698,22 @@ struct amount_msat channel_amount_receivable(const struct channel *channel)
 	return receivable;
 }
 
+static bool wants_channel_stats(const struct json_stream *response)
+{
+	static const char *fields[] = {
+		"in_payments_offered", "in_offered_msat", "in_msatoshi_offered",
+		"in_payments_fulfilled", "in_fulfilled_msat", "in_msatoshi_fulfilled",
+		"out_payments_offered", "out_offered_msat", "out_msatoshi_offered",
+		"out_payments_fulfilled", "out_fulfilled_msat", "out_msatoshi_fulfilled",
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(fields); i++) {
+		if (json_stream_wants(response, fields[i]))
+			return true;
+	}
+	return false;
+}
+
 static void json_add_channel(struct lightningd *ld,
 			     struct json_stream *response, const char *key,
 			     const struct channel *channel,
@@ -707,20 +725,28 @@ static void json_add_channel(struct lightningd *ld,
 	struct amount_sat peer_funded_sats;
 	struct state_change_entry *state_changes;
 	u32 feerate;
+	const struct bitcoin_tx *last_tx;
 
 	json_object_start(response, key);
 	if (peer) {
 		json_add_node_id(response, "peer_id", &peer->id);
 		json_add_bool(response, "peer_connected", peer->connected == PEER_CONNECTED);
+		json_add_u64(response, "change_index", channel->change_index);
 	}
 	json_add_string(response, "state", channel_state_name(channel));
-	if (channel->last_tx && !invalid_last_tx(channel->last_tx)) {
+	/* For onchain channels, this comes from the db. */
+	if (json_stream_wants(response, "scratch_txid")
+	    || json_stream_wants(response, "last_tx_fee_msat"))
+		last_tx = channel_last_tx(channel);
+	else
+		last_tx = NULL;
+	if (last_tx && !invalid_last_tx(last_tx)) {
 		struct bitcoin_txid txid;
-		bitcoin_txid(channel->last_tx, &txid);
+		bitcoin_txid(last_tx, &txid);
 
 		json_add_txid(response, "scratch_txid", &txid);
 		json_add_amount_sat_msat(response, "last_tx_fee_msat",
-					 bitcoin_tx_compute_fee(channel->last_tx));
+					 bitcoin_tx_compute_fee(last_tx));
 	}
 
 	json_object_start(response, "feerate");
@@ -977,14 +1003,18 @@ static void json_add_channel(struct lightningd *ld,
 				   "our_reserve_msat");
 
 	/* append spendable to JSON output */
-	json_add_amount_msat_compat(response,
-				    channel_amount_spendable(channel),
-				    "spendable_msatoshi", "spendable_msat");
+	if (json_stream_wants(response, "spendable_msat")
+	    || json_stream_wants(response, "spendable_msatoshi"))
+		json_add_amount_msat_compat(response,
+					    channel_amount_spendable(channel),
+					    "spendable_msatoshi", "spendable_msat");
 
 	/* append receivable to JSON output */
-	json_add_amount_msat_compat(response,
-				    channel_amount_receivable(channel),
-				    "receivable_msatoshi", "receivable_msat");
+	if (json_stream_wants(response, "receivable_msat")
+	    || json_stream_wants(response, "receivable_msatoshi"))
+		json_add_amount_msat_compat(response,
+					    channel_amount_receivable(channel),
+					    "receivable_msatoshi", "receivable_msat");
 
 	json_add_amount_msat_compat(response,
 				    channel->our_config.htlc_minimum,
@@ -1008,7 +1038,11 @@ static void json_add_channel(struct lightningd *ld,
 	json_add_num(response, "max_accepted_htlcs",
 		     channel->our_config.max_accepted_htlcs);
 
-	state_changes = wallet_state_change_get(ld->wallet, tmpctx, channel->dbid);
+	if (json_stream_wants(response, "state_changes"))
+		state_changes = wallet_state_change_get(ld->wallet, tmpctx,
+							channel->dbid);
+	else
+		state_changes = NULL;
 	json_array_start(response, "state_changes");
 	for (size_t i = 0; i < tal_count(state_changes); i++) {
 		json_object_start(response, NULL);
@@ -1036,8 +1070,13 @@ static void json_add_channel(struct lightningd *ld,
 		json_add_string(response, NULL, channel->billboard.transient);
 	json_array_end(response);
 
-	/* Provide channel statistics */
-	wallet_channel_stats_load(ld->wallet, channel->dbid, &channel_stats);
+	/* Provide channel statistics (this is a db query, so skip it if
+	 * they're all filtered out: the json_add_* do nothing then). */
+	if (wants_channel_stats(response))
+		wallet_channel_stats_load(ld->wallet, channel->dbid,
+					  &channel_stats);
+	else
+		memset(&channel_stats, 0, sizeof(channel_stats));
 	json_add_u64(response, "in_payments_offered",
 		     channel_stats.in_payments_offered);
 	json_add_amount_msat_compat(response,
@@ -1063,7 +1102,8 @@ static void json_add_channel(struct lightningd *ld,
 				    "out_msatoshi_fulfilled",
 				    "out_fulfilled_msat");
 
-	json_add_htlcs(ld, response, channel);
+	if (json_stream_wants(response, "htlcs"))
+		json_add_htlcs(ld, response, channel);
 	json_object_end(response);
 }
 
@@ -1185,6 +1225,15 @@ send_error:
 							  error)));
 }
 
+/* peer_connected shows up in every one of their channels. */
+static void peer_channels_changed(struct peer *peer)
+{
+	struct channel *channel;
+
+	list_for_each(&peer->channels, channel, list)
+		channel_changed(channel);
+}
+
 static void peer_connected_hook_final(struct peer_connected_hook_payload *payload STEALS)
 {
 	struct lightningd *ld = payload->ld;
@@ -1219,6 +1268,7 @@ static void peer_connected_hook_final(struct peer_connected_hook_payload *payloa
 	/* Now we finally consider ourselves connected! */
 	assert(peer->connected == PEER_CONNECTING);
 	peer->connected = PEER_CONNECTED;
+	peer_channels_changed(peer);
 
 	/* Succeed any connect() commands */
 	connect_succeeded(ld, peer, payload->incoming, &payload->addr);
@@ -1657,6 +1707,7 @@ void peer_disconnect_done(struct lightningd *ld, const u8 *msg)
 		assert(p->connectd_counter == connectd_counter);
 		log_peer_debug(ld->log, &id, "peer_disconnect_done");
 		p->connected = PEER_DISCONNECTED;
+		peer_channels_changed(p);
 	}
 
 	/* If you were trying to connect, it failed. */
@@ -1771,6 +1822,7 @@ static void update_channel_from_inflight(struct lightningd *ld,
 			       inflight->funding->total_funds);
 
 	wallet_channel_save(ld->wallet, channel);
+	channel_changed(channel);
 }
 
 static enum watch_result funding_depth_cb(struct lightningd *ld,
@@ -1846,6 +1898,7 @@ static enum watch_result funding_depth_cb(struct lightningd *ld,
 			channel->scid = tal(channel, struct short_channel_id);
 			*channel->scid = scid;
 			wallet_channel_save(ld->wallet, channel);
+			channel_changed(channel);
 
 		} else if (!short_channel_id_eq(channel->scid, &scid) &&
 			   !is_stub_scid(channel->scid)) {
@@ -1870,6 +1923,7 @@ static enum watch_result funding_depth_cb(struct lightningd *ld,
 
 			*channel->scid = scid;
 			wallet_channel_save(ld->wallet, channel);
+			channel_changed(channel);
 			return KEEP_WATCHING;
 		}
 	}
@@ -2084,21 +2138,72 @@ static const struct json_command staticbackup_command = {
 /* Comment added to satisfice AUTODATA */
 AUTODATA(json_command, &staticbackup_command);
 
+/* With @since, only channels which changed after it (and no half-opened
+ * ones: they only have a change_index once they're real). */
 static void json_add_peerchannels(struct lightningd *ld,
 				  struct json_stream *response,
-				  const struct peer *peer)
+				  const struct peer *peer,
+				  const u64 *since)
 {
 	struct channel *channel;
 
-	json_add_uncommitted_channel(response, peer->uncommitted_channel, peer);
+	if (!since)
+		json_add_uncommitted_channel(response, peer->uncommitted_channel, peer);
 	list_for_each(&peer->channels, channel, list) {
-		if (channel_unsaved(channel))
-			json_add_unsaved_channel(response, channel, peer);
-		else
+		if (since && channel->change_index <= *since)
+			continue;
+		if (channel_unsaved(channel)) {
+			if (!since)
+				json_add_unsaved_channel(response, channel, peer);
+		} else
 			json_add_channel(ld, response, NULL, channel, peer);
 	}
 }
 
+/* Peers we still have to list, if we had to wait for output to drain. */
+struct listpeerchannels_info {
+	struct node_id *ids;
+	size_t next;
+	const u64 *since;
+	/* Everything up to here is in this response, even if we pause. */
+	u64 change_index;
+};
+
+static struct command_result *
+listpeerchannels_done(struct command *cmd,
+		      struct json_stream *response,
+		      u64 change_index)
+{
+	json_array_end(response);
+	json_add_u64(response, "change_index", change_index);
+	return command_success(cmd, response);
+}
+
+static struct command_result *
+listpeerchannels_continue(struct command *cmd,
+			  struct listpeerchannels_info *info)
+{
+	struct json_stream *response = cmd->json_stream;
+
+	while (info->next < tal_count(info->ids)) {
+		/* It may have vanished while we were waiting. */
+		struct peer *peer = peer_by_id(cmd->ld,
+					       &info->ids[info->next++]);
+		if (peer)
+			json_add_peerchannels(cmd->ld, response, peer,
+					      info->since);
+
+		/* Don't build up the whole thing in memory, or hog the
+		 * loop while HTLCs are waiting. */
+		if (command_should_pause(cmd))
+			return command_wait_for_output(cmd,
+						       listpeerchannels_continue,
+						       info);
+	}
+
+	return listpeerchannels_done(cmd, response, info->change_index);
+}
+
 static struct command_result *json_listpeerchannels(struct command *cmd,
 						    const char *buffer,
 						    const jsmntok_t *obj UNNEEDED,
@@ -2107,40 +2212,53 @@ static struct command_result *json_listpeerchannels(struct command *cmd,
 	struct node_id *peer_id;
 	struct peer *peer;
 	struct json_stream *response;
+	struct listpeerchannels_info *info;
+	struct peer_node_id_map_iter it;
+	u64 *since;
 
 	/* FIME: filter by status */
 	if (!param(cmd, buffer, params,
 		   p_opt("id", param_node_id, &peer_id),
+		   p_opt("since", param_u64, &since),
 		   NULL))
 		return command_param_failed();
 
+	/* A change_index from before we restarted: they need everything. */
+	if (since && *since > cmd->ld->channel_change_index)
+		since = tal_free(since);
+
 	response = json_stream_success(cmd);
 	json_array_start(response, "channels");
 
 	if (peer_id) {
 		peer = peer_by_id(cmd->ld, peer_id);
 		if (peer)
-			json_add_peerchannels(cmd->ld, response, peer);
-	} else {
-		struct peer_node_id_map_iter it;
-
-		for (peer = peer_node_id_map_first(cmd->ld->peers, &it);
-		     peer;
-		     peer = peer_node_id_map_next(cmd->ld->peers, &it)) {
-			json_add_peerchannels(cmd->ld, response, peer);
-		}
+			json_add_peerchannels(cmd->ld, response, peer, since);
+		return listpeerchannels_done(cmd, response,
+					     cmd->ld->channel_change_index);
 	}
 
-	json_array_end(response);
+	/* We may pause, and the peers map can change, so snapshot ids. */
+	info = tal(cmd, struct listpeerchannels_info);
+	info->ids = tal_arr(info, struct node_id, 0);
+	info->next = 0;
+	info->since = since;
+	info->change_index = cmd->ld->channel_change_index;
+	for (peer = peer_node_id_map_first(cmd->ld->peers, &it);
+	     peer;
+	     peer = peer_node_id_map_next(cmd->ld->peers, &it)) {
+		tal_arr_expand(&info->ids, peer->id);
+	}
 
-	return command_success(cmd, response);
+	return listpeerchannels_continue(cmd, info);
 }
 
 static const struct json_command listpeerchannels_command = {
 	"listpeerchannels",
 	"network",
 	json_listpeerchannels,
-	"Show channels with direct peers."
+	"Show channels with direct peers.",
+	.cacheable = true,
 };
 AUTODATA(json_command, &listpeerchannels_command);
 
@@ -2228,32 +2346,98 @@ static void setup_peer(struct peer *peer, u32 delay)
 	}
 }
 
+static int cmp_peer_ptr(struct peer *const *a, struct peer *const *b,
+			void *unused)
+{
+	if ((uintptr_t)*a < (uintptr_t)*b)
+		return -1;
+	return (uintptr_t)*a > (uintptr_t)*b;
+}
+
+static int cmp_peer_ptr_bsearch(const void *a, const void *b)
+{
+	return cmp_peer_ptr(a, b, NULL);
+}
+
+/* Sorted (by pointer) array of peers with HTLCs in flight; may have dups. */
+static struct peer **peers_with_htlcs(const tal_t *ctx, struct lightningd *ld)
+{
+	struct peer **peers = tal_arr(ctx, struct peer *, 0);
+	struct htlc_in_map_iter ini;
+	struct htlc_out_map_iter outi;
+	struct htlc_in *hin;
+	struct htlc_out *hout;
+
+	for (hin = htlc_in_map_first(ld->htlcs_in, &ini);
+	     hin;
+	     hin = htlc_in_map_next(ld->htlcs_in, &ini))
+		tal_arr_expand(&peers, hin->key.channel->peer);
+
+	for (hout = htlc_out_map_first(ld->htlcs_out, &outi);
+	     hout;
+	     hout = htlc_out_map_next(ld->htlcs_out, &outi))
+		tal_arr_expand(&peers, hout->key.channel->peer);
+
+	asort(peers, tal_count(peers), cmp_peer_ptr, NULL);
+	return peers;
+}
+
 void setup_peers(struct lightningd *ld)
 {
 	struct peer *p;
 	/* Avoid thundering herd: after first five, delay by 1 second. */
 	int delay = -5;
 	struct peer_node_id_map_iter it;
-
-	for (p = peer_node_id_map_first(ld->peers, &it);
-	     p;
-	     p = peer_node_id_map_next(ld->peers, &it)) {
-		setup_peer(p, delay > 0 ? delay : 0);
-		delay++;
+	struct peer **busy = peers_with_htlcs(tmpctx, ld);
+
+	/* Peers with HTLCs in flight get the early slots: until they're
+	 * back those HTLCs can't be resolved (and may be timing out). */
+	for (size_t pass = 0; pass < 2; pass++) {
+		for (p = peer_node_id_map_first(ld->peers, &it);
+		     p;
+		     p = peer_node_id_map_next(ld->peers, &it)) {
+			bool has_htlcs = bsearch(&p, busy, tal_count(busy),
+						 sizeof(*busy),
+						 cmp_peer_ptr_bsearch) != NULL;
+			if (has_htlcs != (pass == 0))
+				continue;
+			setup_peer(p, delay > 0 ? delay : 0);
+			delay++;
+		}
 	}
 }
 
+static int cmp_dbid(const u64 *a, const u64 *b)
+{
+	if (*a < *b)
+		return -1;
+	return *a > *b;
+}
+
+static bool channel_has_htlcs(const u64 *dbids, const struct channel *channel)
+{
+	return bsearch(&channel->dbid, dbids, tal_count(dbids), sizeof(*dbids),
+		       (int (*)(const void *, const void *))cmp_dbid) != NULL;
+}
+
 /* Pull peers, channels and HTLCs from db, and wire them up. */
 struct htlc_in_map *load_channels_from_wallet(struct lightningd *ld)
 {
 	struct peer *peer;
 	struct htlc_in_map *unconnected_htlcs_in = tal(ld, struct htlc_in_map);
 	struct peer_node_id_map_iter it;
+	const u64 *htlc_dbids;
 
 	/* Load channels from database */
 	if (!wallet_init_channels(ld->wallet))
 		fatal("Could not load channels from the database");
 
+	/* Most channels have no HTLCs in flight (especially closed ones
+	 * waiting onchain), so don't query each of them separately. */
+	htlc_dbids = wallet_channels_with_htlcs(tmpctx, ld->wallet);
+	log_debug(ld->log, "%zu channels have unresolved HTLCs",
+		  tal_count(htlc_dbids));
+
 	/* First we load the incoming htlcs */
 	for (peer = peer_node_id_map_first(ld->peers, &it);
 	     peer;
@@ -2261,6 +2445,8 @@ struct htlc_in_map *load_channels_from_wallet(struct lightningd *ld)
 		struct channel *channel;
 
 		list_for_each(&peer->channels, channel, list) {
+			if (!channel_has_htlcs(htlc_dbids, channel))
+				continue;
 			if (!wallet_htlcs_load_in_for_channel(ld->wallet,
 							      channel,
 							      ld->htlcs_in)) {
@@ -2279,6 +2465,8 @@ struct htlc_in_map *load_channels_from_wallet(struct lightningd *ld)
 		struct channel *channel;
 
 		list_for_each(&peer->channels, channel, list) {
+			if (!channel_has_htlcs(htlc_dbids, channel))
+				continue;
 			if (!wallet_htlcs_load_out_for_channel(ld->wallet,
 							       channel,
 							       ld->htlcs_out,
@@ -2473,7 +2661,8 @@ static const struct json_command getinfo_command = {
     "getinfo",
 	"utility",
     json_getinfo,
-    "Show information about this node"
+    "Show information about this node",
+    .cacheable = true,
 };
 AUTODATA(json_command, &getinfo_command);
 
@@ -2719,6 +2908,7 @@ static void set_channel_config(struct command *cmd, struct channel *channel,
 
 	/* save values to database */
 	wallet_channel_save(cmd->ld->wallet, channel);
+	channel_changed(channel);
 
 	/* write JSON response entry */
 	json_object_start(response, NULL);
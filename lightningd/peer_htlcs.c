@@ -1,15 +1,19 @@
 #include "config.h"
+#include <ccan/array_size/array_size.h>
+#include <ccan/asort/asort.h>
 #include <ccan/cast/cast.h>
 #include <ccan/tal/str/str.h>
 #include <channeld/channeld_wiregen.h>
 #include <common/blinding.h>
 #include <common/configdir.h>
 #include <common/ecdh.h>
+#include <common/ecdh_hsmd.h>
 #include <common/json_command.h>
 #include <common/json_param.h>
 #include <common/onion_decode.h>
 #include <common/onionreply.h>
 #include <common/timeout.h>
+#include <common/trace_probe.h>
 #include <common/type_to_string.h>
 #include <db/exec.h>
 #include <gossipd/gossipd_wiregen.h>
@@ -61,6 +65,9 @@ static bool htlc_in_update_state(struct channel *channel,
 	if (!state_update_ok(channel, hin->hstate, newstate, hin->key.id, "in"))
 		return false;
 
+	TRACE_PROBE4(htlc_in_state, channel->dbid, hin->key.id,
+		     hin->hstate, newstate);
+
 	wallet_htlc_update(channel->peer->ld->wallet,
 			   hin->dbid, newstate, hin->preimage,
 			   max_unsigned(channel->next_index[LOCAL],
@@ -80,6 +87,9 @@ static bool htlc_out_update_state(struct channel *channel,
 			     "out"))
 		return false;
 
+	TRACE_PROBE4(htlc_out_state, channel->dbid, hout->key.id,
+		     hout->hstate, newstate);
+
 	bool we_filled = false;
 	wallet_htlc_update(channel->peer->ld->wallet, hout->dbid, newstate,
 			   hout->preimage,
@@ -175,6 +185,74 @@ static void tell_channeld_htlc_failed(const struct htlc_in *hin,
 		      take(towire_channeld_fail_htlc(NULL, failed_htlc)));
 }
 
+struct forward_stats {
+	/* Time from the previous stage we saw to this one. */
+	struct call_stats stage[NUM_FORWARD_STAGE];
+	/* Time from receipt to resolution, for forwards. */
+	struct call_stats total;
+};
+
+struct forward_stats *new_forward_stats(const tal_t *ctx)
+{
+	return talz(ctx, struct forward_stats);
+}
+
+static const char *forward_stage_name(enum forward_stage stage)
+{
+	switch (stage) {
+	case FORWARD_STAGE_RECEIVED:
+		return "received";
+	case FORWARD_STAGE_HOOK_START:
+		return "hook_start";
+	case FORWARD_STAGE_HOOK_END:
+		return "hook_end";
+	case FORWARD_STAGE_OFFERED:
+		return "offered";
+	case FORWARD_STAGE_COMMITTED:
+		return "committed";
+	case FORWARD_STAGE_RESOLVED:
+		return "resolved";
+	}
+	abort();
+}
+
+static bool stage_reached(const struct htlc_in *hin, enum forward_stage stage)
+{
+	return hin->stage_time[stage].ts.tv_sec != 0
+		|| hin->stage_time[stage].ts.tv_nsec != 0;
+}
+
+/* Note that @hin reached @stage, and how long it took to get there. */
+static void htlc_in_reached(struct htlc_in *hin, enum forward_stage stage)
+{
+	struct forward_stats *stats = hin->key.channel->peer->ld->forward_stats;
+	struct timemono now = time_mono();
+
+	if (stage_reached(hin, stage))
+		return;
+	hin->stage_time[stage] = now;
+
+	/* Only forwards get offered: don't mix in payments to us. */
+	if (stage == FORWARD_STAGE_RESOLVED
+	    && !stage_reached(hin, FORWARD_STAGE_OFFERED))
+		return;
+
+	for (int prev = stage - 1; prev >= 0; prev--) {
+		if (!stage_reached(hin, prev))
+			continue;
+		call_stats_add(&stats->stage[stage],
+			       timemono_between(now, hin->stage_time[prev]),
+			       false, 0, 0);
+		break;
+	}
+
+	if (stage == FORWARD_STAGE_RESOLVED
+	    && stage_reached(hin, FORWARD_STAGE_RECEIVED))
+		call_stats_add(&stats->total,
+			       timemono_between(now, hin->stage_time[FORWARD_STAGE_RECEIVED]),
+			       false, 0, 0);
+}
+
 static void fail_in_htlc(struct htlc_in *hin,
 			 const struct onionreply *failonion TAKES)
 {
@@ -182,6 +260,7 @@ static void fail_in_htlc(struct htlc_in *hin,
 	assert(!hin->preimage);
 
 	hin->failonion = dup_onionreply(hin, failonion);
+	htlc_in_reached(hin, FORWARD_STAGE_RESOLVED);
 
 	/* We update state now to signal it's in progress, for persistence. */
 	htlc_in_update_state(hin->key.channel, hin, SENT_REMOVE_HTLC);
@@ -210,6 +289,7 @@ static void local_fail_in_htlc_badonion(struct htlc_in *hin,
 
 	assert(badonion & BADONION);
 	hin->badonion = badonion;
+	htlc_in_reached(hin, FORWARD_STAGE_RESOLVED);
 	/* We update state now to signal it's in progress, for persistence. */
 	htlc_in_update_state(hin->key.channel, hin, SENT_REMOVE_HTLC);
 	htlc_in_check(hin, __func__);
@@ -359,6 +439,7 @@ void fulfill_htlc(struct htlc_in *hin, const struct preimage *preimage)
 	}
 
 	hin->preimage = tal_dup(hin, struct preimage, preimage);
+	htlc_in_reached(hin, FORWARD_STAGE_RESOLVED);
 
 	/* We update state now to signal it's in progress, for persistence. */
 	htlc_in_update_state(channel, hin, SENT_REMOVE_HTLC);
@@ -660,10 +741,31 @@ const u8 *send_htlc_out(const tal_t *ctx,
 					onion_routing_packet, blinding);
 	subd_req(out->peer->ld, out->owner, take(msg), -1, 0, rcvd_htlc_reply,
 		 *houtp);
+	if (in)
+		htlc_in_reached(in, FORWARD_STAGE_OFFERED);
 
 	return NULL;
 }
 
+/* channel_amount_spendable() walks every HTLC we have, so for choosing
+ * among parallel channels we sort by this cheap upper bound on it first. */
+struct forward_candidate {
+	struct channel *channel;
+	struct amount_msat max_spendable;
+	size_t idx;
+};
+
+static int cmp_forward_candidate(const struct forward_candidate *a,
+				 const struct forward_candidate *b,
+				 void *unused)
+{
+	if (amount_msat_greater(a->max_spendable, b->max_spendable))
+		return -1;
+	if (amount_msat_less(a->max_spendable, b->max_spendable))
+		return 1;
+	return a->idx < b->idx ? -1 : a->idx > b->idx;
+}
+
 /* What's the best channel to this peer?
  * If @hint is set, channel must match that one. */
 static struct channel *best_channel(struct lightningd *ld,
@@ -673,15 +775,15 @@ static struct channel *best_channel(struct lightningd *ld,
 {
 	struct amount_msat best_spendable = AMOUNT_MSAT(0);
 	struct channel *channel, *best = hint;
+	struct forward_candidate *cands;
+	size_t idx = 0, best_idx = 0;
 
-	/* Seek channel with largest spendable! */
+	cands = tal_arr(tmpctx, struct forward_candidate, 0);
 	list_for_each(&next_peer->channels, channel, list) {
-		struct amount_msat spendable;
+		struct forward_candidate c;
+		idx++;
 		if (!channel_can_add_htlc(channel))
 			continue;
-		spendable = channel_amount_spendable(channel);
-		if (!amount_msat_greater(spendable, best_spendable))
-			continue;
 
 		/* Don't override if fees differ... */
 		if (hint) {
@@ -695,8 +797,35 @@ static struct channel *best_channel(struct lightningd *ld,
 				     channel->channel_info.their_config.htlc_minimum))
 			continue;
 
-		best = channel;
-		best_spendable = spendable;
+		c.channel = channel;
+		c.idx = idx;
+		if (!amount_msat_sub_sat(&c.max_spendable,
+					 channel->our_msat,
+					 channel->channel_info.their_config.channel_reserve))
+			continue;
+		tal_arr_expand(&cands, c);
+	}
+
+	/* Seek channel with largest spendable (first one, if equal)! */
+	asort(cands, tal_count(cands), cmp_forward_candidate, NULL);
+	for (size_t i = 0; i < tal_count(cands); i++) {
+		struct amount_msat spendable;
+
+		/* Nothing left can beat (or tie earlier than) this one. */
+		if (amount_msat_less(cands[i].max_spendable, best_spendable))
+			break;
+		if (amount_msat_eq(cands[i].max_spendable, best_spendable)
+		    && cands[i].idx > best_idx)
+			break;
+
+		spendable = channel_amount_spendable(cands[i].channel);
+		if (amount_msat_greater(spendable, best_spendable)
+		    || (amount_msat_eq(spendable, best_spendable)
+			&& best_idx && cands[i].idx < best_idx)) {
+			best = cands[i].channel;
+			best_spendable = spendable;
+			best_idx = cands[i].idx;
+		}
 	}
 	return best;
 }
@@ -1139,6 +1268,7 @@ htlc_accepted_hook_final(struct htlc_accepted_hook_payload *request STEALS)
 	struct htlc_in *hin = request->hin;
 	struct channel *channel = request->channel;
 
+	htlc_in_reached(hin, FORWARD_STAGE_HOOK_END);
 	request->hin->status = tal_free(request->hin->status);
 
 	/* Hand the payload to the htlc_in since we'll want to have that info
@@ -1183,7 +1313,8 @@ static bool ecdh_maybe_blinding(const struct pubkey *ephemeral_key,
 		struct secret hmac;
 		struct secret blinding_ss;
 
-		ecdh(blinding, &blinding_ss);
+		/* onion_decode() will want this again, too. */
+		ecdh_blinding(blinding, &blinding_ss);
 		/* b(i) = HMAC256("blinded_node_id", ss(i)) * k(i) */
 		subkey_from_hmac("blinded_node_id", &blinding_ss, &hmac);
 
@@ -1411,6 +1542,7 @@ static bool peer_accepted_htlc(const tal_t *ctx,
 	hook_payload->fwd_channel_id
 		= calc_forwarding_channel(ld, hook_payload);
 
+	htlc_in_reached(hin, FORWARD_STAGE_HOOK_START);
 	plugin_hook_call_htlc_accepted(ld, NULL, hook_payload);
 
 	/* Falling through here is ok, after all the HTLC locked */
@@ -1933,6 +2065,9 @@ static bool update_out_htlc(struct channel *channel,
 		tal_del_destructor(hout, destroy_hout_subd_died);
 		hout->timeout = tal_free(hout->timeout);
 		tal_steal(ld, hout);
+	} else if (newstate == SENT_ADD_ACK_REVOCATION) {
+		if (hout->in)
+			htlc_in_reached(hout->in, FORWARD_STAGE_COMMITTED);
 	} else if (newstate == RCVD_REMOVE_ACK_REVOCATION) {
 		remove_htlc_out(channel, hout);
 	}
@@ -2088,6 +2223,7 @@ void peer_sending_commitsig(struct channel *channel, const u8 *msg)
 	tal_free(channel->last_sent_commit);
 	channel->last_sent_commit = tal_steal(channel, changed_htlcs);
 	wallet_channel_save(ld->wallet, channel);
+	channel_changed(channel);
 
 	if (pbase)
 		wallet_penalty_base_add(ld->wallet, channel->dbid, pbase);
@@ -2097,14 +2233,57 @@ void peer_sending_commitsig(struct channel *channel, const u8 *msg)
 		      take(towire_channeld_sending_commitsig_reply(msg)));
 }
 
+/* An added HTLC's onion, and its shared secret if we already have it */
+struct added_onion {
+	struct onionpacket *op;
+	const struct secret *ss;
+};
+
+/* Parse the onions of all their new HTLCs, and do the ECDH for all the
+ * unblinded ones in a single hsmd round trip. */
+static struct added_onion *parse_added_onions(const tal_t *ctx,
+					      const struct added_htlc *added)
+{
+	struct added_onion *onions;
+	struct pubkey *points;
+	size_t *idx;
+	struct secret *ss;
+	enum onion_wire failcode;
+
+	onions = tal_arr(ctx, struct added_onion, tal_count(added));
+	points = tal_arr(tmpctx, struct pubkey, 0);
+	idx = tal_arr(tmpctx, size_t, 0);
+	for (size_t i = 0; i < tal_count(added); i++) {
+		onions[i].op = parse_onionpacket(onions,
+						 added[i].onion_routing_packet,
+						 sizeof(added[i].onion_routing_packet),
+						 &failcode);
+		onions[i].ss = NULL;
+		/* Blinded ones need an ECDH first, to tweak the point */
+		if (onions[i].op && !added[i].blinding) {
+			tal_arr_expand(&points, onions[i].op->ephemeralkey);
+			tal_arr_expand(&idx, i);
+		}
+	}
+
+	/* A single one is done by channel_added_their_htlc as normal. */
+	if (tal_count(points) < 2)
+		return onions;
+
+	ss = ecdh_batch(onions, points);
+	for (size_t i = 0; i < tal_count(idx); i++)
+		onions[idx[i]].ss = &ss[i];
+	return onions;
+}
+
 static bool channel_added_their_htlc(struct channel *channel,
-				     const struct added_htlc *added)
+				     const struct added_htlc *added,
+				     const struct added_onion *onion)
 {
 	struct lightningd *ld = channel->peer->ld;
 	struct htlc_in *hin;
 	struct secret shared_secret;
-	struct onionpacket *op;
-	enum onion_wire failcode;
+	struct onionpacket *op = onion->op;
 
 	/* BOLT #2:
 	 *
@@ -2128,10 +2307,9 @@ static bool channel_added_their_htlc(struct channel *channel,
 
 	/* Do the work of extracting shared secret now if possible. */
 	/* FIXME: We do this *again* in peer_accepted_htlc! */
-	op = parse_onionpacket(tmpctx, added->onion_routing_packet,
-			       sizeof(added->onion_routing_packet),
-			       &failcode);
-	if (op) {
+	if (onion->ss)
+		shared_secret = *onion->ss;
+	else if (op) {
 		if (!ecdh_maybe_blinding(&op->ephemeralkey,
 					 added->blinding,
 					 &shared_secret)) {
@@ -2220,6 +2398,7 @@ void peer_got_commitsig(struct channel *channel, const u8 *msg)
 	struct height_states *blockheight_states;
 	struct bitcoin_signature commit_sig, *htlc_sigs;
 	struct added_htlc *added;
+	struct added_onion *onions;
 	struct fulfilled_htlc *fulfilled;
 	struct failed_htlc **failed;
 	struct changed_htlc *changed;
@@ -2275,8 +2454,9 @@ void peer_got_commitsig(struct channel *channel, const u8 *msg)
 		  tal_count(failed), tal_count(changed));
 
 	/* New HTLCs */
+	onions = parse_added_onions(tmpctx, added);
 	for (i = 0; i < tal_count(added); i++) {
-		if (!channel_added_their_htlc(channel, &added[i]))
+		if (!channel_added_their_htlc(channel, &added[i], &onions[i]))
 			return;
 	}
 
@@ -2316,6 +2496,7 @@ void peer_got_commitsig(struct channel *channel, const u8 *msg)
 		return;
 
 	wallet_channel_save(ld->wallet, channel);
+	channel_changed(channel);
 
 	tal_free(channel->last_htlc_sigs);
 	channel->last_htlc_sigs = tal_steal(channel, htlc_sigs);
@@ -2497,9 +2678,15 @@ void peer_got_revoke(struct channel *channel, const u8 *msg)
 					     : fromwire_peektype(failmsgs[i]));
 	}
 	wallet_channel_save(ld->wallet, channel);
+	channel_changed(channel);
 
-	if (penalty_tx == NULL)
+	if (penalty_tx == NULL) {
+		/* Their to_local was too small to be worth penalizing. */
+		if (pbase)
+			wallet_penalty_base_delete(ld->wallet, channel->dbid,
+						   pbase->commitment_num);
 		return;
+	}
 
 	payload = tal(tmpctx, struct commitment_revocation_payload);
 	payload->commitment_txid = pbase->txid;
@@ -2876,13 +3063,13 @@ AUTODATA(json_command, &dev_ignore_htlcs);
 void json_add_forwarding_object(struct json_stream *response,
 				const char *fieldname,
 				const struct forwarding *cur,
-				const struct sha256 *payment_hash)
+				const struct htlc_in *in)
 {
 	json_object_start(response, fieldname);
 
 	/* Only for forward_event */
-	if (payment_hash)
-		json_add_sha256(response, "payment_hash", payment_hash);
+	if (in)
+		json_add_sha256(response, "payment_hash", &in->payment_hash);
 	json_add_short_channel_id(response, "in_channel", &cur->channel_in);
 
 #ifdef COMPAT_V0121
@@ -2912,6 +3099,10 @@ void json_add_forwarding_object(struct json_stream *response,
 	}
 	json_add_string(response, "status", forward_status_name(cur->status));
 
+	/* Not known for forward_event notifications */
+	if (cur->created_index != 0)
+		json_add_u64(response, "created_index", cur->created_index);
+
 	if (cur->failcode != 0) {
 		json_add_num(response, "failcode", cur->failcode);
 		json_add_string(response, "failreason",
@@ -2936,6 +3127,21 @@ void json_add_forwarding_object(struct json_stream *response,
 	if (cur->resolved_time)
 		json_add_timeabs(response, "resolved_time", *cur->resolved_time);
 #endif
+
+	/* Only for forward_event: how long after receipt each stage was. */
+	if (in && stage_reached(in, FORWARD_STAGE_RECEIVED)) {
+		json_object_start(response, "stages_usec");
+		for (enum forward_stage i = FORWARD_STAGE_HOOK_START;
+		     i < NUM_FORWARD_STAGE;
+		     i++) {
+			if (!stage_reached(in, i))
+				continue;
+			json_add_u64(response, forward_stage_name(i),
+				     time_to_usec(timemono_between(in->stage_time[i],
+								   in->stage_time[FORWARD_STAGE_RECEIVED])));
+		}
+		json_object_end(response);
+	}
 	json_object_end(response);
 }
 
@@ -2943,11 +3149,15 @@ static void listforwardings_add_forwardings(struct json_stream *response,
 					    struct wallet *wallet,
 					    enum forward_status status,
 					    const struct short_channel_id *chan_in,
-					    const struct short_channel_id *chan_out)
+					    const struct short_channel_id *chan_out,
+					    u64 start,
+					    const u32 *limit)
 {
 	const struct forwarding *forwardings;
 
-	forwardings = wallet_forwarded_payments_get(wallet, tmpctx, status, chan_in, chan_out);
+	forwardings = wallet_forwarded_payments_get(wallet, tmpctx, status,
+						    chan_in, chan_out,
+						    start, limit);
 
 	json_array_start(response, "forwards");
 	for (size_t i=0; i<tal_count(forwardings); i++) {
@@ -2984,17 +3194,34 @@ static struct command_result *json_listforwards(struct command *cmd,
 	struct json_stream *response;
 	struct short_channel_id *chan_in, *chan_out;
 	enum forward_status *status;
+	u64 *start;
+	u32 *limit;
 
 	if (!param(cmd, buffer, params,
 		   p_opt_def("status", param_forward_status, &status,
 			     FORWARD_ANY),
 		   p_opt("in_channel", param_short_channel_id, &chan_in),
 		   p_opt("out_channel", param_short_channel_id, &chan_out),
+		   p_opt("start", param_u64, &start),
+		   p_opt("limit", param_u32, &limit),
 		   NULL))
 		return command_param_failed();
 
+	/* Old forwards without a created_index would be on every page. */
+	if ((start || limit) && !wallet_forwards_indexed(cmd->ld->wallet))
+		return command_fail(cmd, LIGHTNINGD,
+				    "Older forwards are still being given a"
+				    " created_index: try start/limit again"
+				    " once that is done");
+
+	if (!start) {
+		start = tal(cmd, u64);
+		*start = 0;
+	}
+
 	response = json_stream_success(cmd);
-	listforwardings_add_forwardings(response, cmd->ld->wallet, *status, chan_in, chan_out);
+	listforwardings_add_forwardings(response, cmd->ld->wallet, *status,
+					chan_in, chan_out, *start, limit);
 
 	return command_success(cmd, response);
 }
@@ -3003,10 +3230,190 @@ static const struct json_command listforwards_command = {
 	"listforwards",
 	"channels",
 	json_listforwards,
-	"List all forwarded payments and their information optionally filtering by [status], [in_channel] and [out_channel]"
+	"List all forwarded payments and their information optionally filtering by [status], [in_channel] and [out_channel], "
+	"returning at most [limit] starting at created_index [start]"
 };
 AUTODATA(json_command, &listforwards_command);
 
+static void json_add_stage_stats(struct json_stream *response,
+				 const char *stage,
+				 const struct call_stats *stats)
+{
+	json_object_start(response, NULL);
+	json_add_string(response, "stage", stage);
+	json_add_u64(response, "count", stats->calls);
+	json_add_u64(response, "total_usec", stats->total_usec);
+	json_add_u64(response, "p50_usec", call_stats_percentile(stats, 50));
+	json_add_u64(response, "p90_usec", call_stats_percentile(stats, 90));
+	json_add_u64(response, "p99_usec", call_stats_percentile(stats, 99));
+	json_add_u64(response, "max_usec", stats->max_usec);
+	json_object_end(response);
+}
+
+static struct command_result *json_getforwardlatency(struct command *cmd,
+						     const char *buffer,
+						     const jsmntok_t *obj UNNEEDED,
+						     const jsmntok_t *params)
+{
+	const struct forward_stats *stats = cmd->ld->forward_stats;
+	struct json_stream *response;
+
+	if (!param(cmd, buffer, params, NULL))
+		return command_param_failed();
+
+	response = json_stream_success(cmd);
+	json_array_start(response, "stages");
+	for (enum forward_stage i = FORWARD_STAGE_HOOK_START;
+	     i < NUM_FORWARD_STAGE;
+	     i++)
+		json_add_stage_stats(response, forward_stage_name(i),
+				     &stats->stage[i]);
+	json_add_stage_stats(response, "total", &stats->total);
+	json_array_end(response);
+	return command_success(cmd, response);
+}
+
+static const struct json_command getforwardlatency_command = {
+	"getforwardlatency",
+	"channels",
+	json_getforwardlatency,
+	"Show how long incoming HTLCs spend reaching each stage of forwarding"
+};
+AUTODATA(json_command, &getforwardlatency_command);
+
+static struct command_result *json_getmetrics(struct command *cmd,
+					      const char *buffer,
+					      const jsmntok_t *obj UNNEEDED,
+					      const jsmntok_t *params)
+{
+	struct lightningd *ld = cmd->ld;
+	struct json_stream *response;
+	struct peer_node_id_map_iter it;
+	struct htlc_in_map_iter ini;
+	struct htlc_out_map_iter outi;
+	struct peer *peer;
+	struct htlc_in *hin;
+	struct htlc_out *hout;
+	u64 num_peers = 0, num_connected = 0;
+	u64 channels[CHANNEL_STATE_MAX + 1] = { 0 };
+	u64 htlcs_in[HTLC_STATE_INVALID] = { 0 };
+	u64 htlcs_out[HTLC_STATE_INVALID] = { 0 };
+
+	if (!param(cmd, buffer, params, NULL))
+		return command_param_failed();
+
+	for (peer = peer_node_id_map_first(ld->peers, &it);
+	     peer;
+	     peer = peer_node_id_map_next(ld->peers, &it)) {
+		struct channel *channel;
+
+		num_peers++;
+		if (peer->connected == PEER_CONNECTED)
+			num_connected++;
+		list_for_each(&peer->channels, channel, list)
+			channels[channel->state]++;
+	}
+
+	for (hin = htlc_in_map_first(ld->htlcs_in, &ini);
+	     hin;
+	     hin = htlc_in_map_next(ld->htlcs_in, &ini))
+		htlcs_in[hin->hstate]++;
+
+	for (hout = htlc_out_map_first(ld->htlcs_out, &outi);
+	     hout;
+	     hout = htlc_out_map_next(ld->htlcs_out, &outi))
+		htlcs_out[hout->hstate]++;
+
+	response = json_stream_success(cmd);
+	json_object_start(response, "peers");
+	json_add_u64(response, "total", num_peers);
+	json_add_u64(response, "connected", num_connected);
+	json_object_end(response);
+	/* States with nothing in them are omitted. */
+	json_object_start(response, "channels");
+	for (size_t i = 0; i < ARRAY_SIZE(channels); i++) {
+		if (channels[i])
+			json_add_u64(response, channel_state_str(i),
+				     channels[i]);
+	}
+	json_object_end(response);
+	json_object_start(response, "htlcs_in");
+	for (size_t i = 0; i < ARRAY_SIZE(htlcs_in); i++) {
+		if (htlcs_in[i])
+			json_add_u64(response, htlc_state_name(i), htlcs_in[i]);
+	}
+	json_object_end(response);
+	json_object_start(response, "htlcs_out");
+	for (size_t i = 0; i < ARRAY_SIZE(htlcs_out); i++) {
+		if (htlcs_out[i])
+			json_add_u64(response, htlc_state_name(i), htlcs_out[i]);
+	}
+	json_object_end(response);
+	json_object_start(response, "forwards");
+	for (size_t i = 0; i < ARRAY_SIZE(ld->forwards_by_status); i++)
+		json_add_u64(response, forward_status_name(i),
+			     ld->forwards_by_status[i]);
+	json_object_end(response);
+	return command_success(cmd, response);
+}
+
+static const struct json_command getmetrics_command = {
+	"getmetrics",
+	"utility",
+	json_getmetrics,
+	"Show counts of peers, channels and HTLCs by state, and forwards since startup"
+};
+AUTODATA(json_command, &getmetrics_command);
+
+static struct command_result *json_listforwardrollups(struct command *cmd,
+						      const char *buffer,
+						      const jsmntok_t *obj UNNEEDED,
+						      const jsmntok_t *params)
+{
+	struct json_stream *response;
+	struct short_channel_id *chan_in, *chan_out;
+	const struct forward_rollup *rollups;
+
+	if (!param(cmd, buffer, params,
+		   p_opt("in_channel", param_short_channel_id, &chan_in),
+		   p_opt("out_channel", param_short_channel_id, &chan_out),
+		   NULL))
+		return command_param_failed();
+
+	rollups = wallet_forward_rollups_get(cmd->ld->wallet, tmpctx,
+					     chan_in, chan_out);
+
+	response = json_stream_success(cmd);
+	json_array_start(response, "forwardrollups");
+	for (size_t i = 0; i < tal_count(rollups); i++) {
+		const struct forward_rollup *r = &rollups[i];
+		json_object_start(response, NULL);
+		json_add_short_channel_id(response, "in_channel",
+					  &r->channel_in);
+		if (r->channel_out.u64 != 0)
+			json_add_short_channel_id(response, "out_channel",
+						  &r->channel_out);
+		json_add_string(response, "status",
+				forward_status_name(r->status));
+		json_add_u64(response, "hour_start", r->hour_start.ts.tv_sec);
+		json_add_u64(response, "count", r->count);
+		json_add_amount_msat_only(response, "in_msat", r->msat_in);
+		json_add_amount_msat_only(response, "out_msat", r->msat_out);
+		json_object_end(response);
+	}
+	json_array_end(response);
+
+	return command_success(cmd, response);
+}
+
+static const struct json_command listforwardrollups_command = {
+	"listforwardrollups",
+	"channels",
+	json_listforwardrollups,
+	"List hourly totals of deleted forwards, optionally filtering by [in_channel] and [out_channel]"
+};
+AUTODATA(json_command, &listforwardrollups_command);
+
 static struct command_result *param_forward_delstatus(struct command *cmd,
 						      const char *name,
 						      const char *buffer,
@@ -3072,6 +3479,41 @@ static const struct json_command delforward_command = {
 };
 AUTODATA(json_command, &delforward_command);
 
+static struct command_result *json_delforwards(struct command *cmd,
+					       const char *buffer,
+					       const jsmntok_t *obj UNNEEDED,
+					       const jsmntok_t *params)
+{
+	struct json_stream *response;
+	enum forward_status *status;
+	u64 *before;
+	u32 *limit;
+	u64 deleted;
+
+	if (!param(cmd, buffer, params,
+		   p_req("status", param_forward_delstatus, &status),
+		   p_req("before", param_u64, &before),
+		   p_opt_def("limit", param_u32, &limit, UINT32_MAX),
+		   NULL))
+		return command_param_failed();
+
+	deleted = wallet_forwards_delete_before(cmd->ld->wallet, *status,
+						*before,
+						*limit);
+
+	response = json_stream_success(cmd);
+	json_add_u64(response, "deleted", deleted);
+	return command_success(cmd, response);
+}
+
+static const struct json_command delforwards_command = {
+	"delforwards",
+	"channels",
+	json_delforwards,
+	"Delete forwarded payments with {status} resolved before UNIX time {before}, at most about [limit]"
+};
+AUTODATA(json_command, &delforwards_command);
+
 static struct command_result *param_channel(struct command *cmd,
 					    const char *name,
 					    const char *buffer,
@@ -39,6 +39,9 @@ void peer_got_revoke(struct channel *channel, const u8 *msg);
 void update_per_commit_point(struct channel *channel,
 			     const struct pubkey *per_commitment_point);
 
+/* For getforwardlatency: time spent reaching each forward_stage. */
+struct forward_stats *new_forward_stats(const tal_t *ctx);
+
 /* Returns NULL on success, otherwise failmsg*/
 const u8 *send_htlc_out(const tal_t *ctx,
 			struct channel *out,
@@ -76,11 +79,12 @@ void local_fail_in_htlc_needs_update(struct htlc_in *hin,
 
 /* This json process will be used as the serialize method for
  * forward_event_notification_gen and be used in
- * `listforwardings_add_forwardings()`. */
+ * `listforwardings_add_forwardings()`.  @in is only set for
+ * forward_event. */
 void json_add_forwarding_object(struct json_stream *response,
 				const char *fieldname,
 				const struct forwarding *cur,
-				const struct sha256 *payment_hash);
+				const struct htlc_in *in);
 
 /* Helper to create (common) WIRE_INCORRECT_OR_UNKNOWN_PAYMENT_DETAILS */
 #define failmsg_incorrect_or_unknown(ctx, ld, hin) \
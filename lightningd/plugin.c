@@ -3,6 +3,7 @@
 #include <ccan/ccan/tal/grab_file/grab_file.h>
 #include <ccan/crc32c/crc32c.h>
 #include <ccan/io/io.h>
+#include <ccan/json_out/json_out.h>
 #include <ccan/mem/mem.h>
 #include <ccan/opt/opt.h>
 #include <ccan/pipecmd/pipecmd.h>
@@ -12,6 +13,7 @@
 #include <common/configdir.h>
 #include <common/features.h>
 #include <common/json_command.h>
+#include <common/json_filter.h>
 #include <common/memleak.h>
 #include <common/timeout.h>
 #include <common/version.h>
@@ -82,6 +84,7 @@ struct plugins *plugins_new(const tal_t *ctx, struct log_book *log_book,
 	p->startup = true;
 	p->plugin_cmds = tal_arr(p, struct plugin_command *, 0);
 	p->blacklist = tal_arr(p, const char *, 0);
+	p->lazy = tal_arr(p, const char *, 0);
 	p->plugin_idx = 0;
 #if DEVELOPER
 	p->dev_builtin_plugins_unimportant = false;
@@ -132,6 +135,20 @@ static bool plugins_all_in_state(const struct plugins *plugins,
 	return true;
 }
 
+/* Lazy plugins we haven't needed yet don't count. */
+static bool plugins_all_initted(const struct plugins *plugins)
+{
+	const struct plugin *p;
+
+	list_for_each(&plugins->plugins, p, list) {
+		if (p->plugin_state == NEEDS_INIT && p->lazy)
+			continue;
+		if (p->plugin_state != INIT_COMPLETE)
+			return false;
+	}
+	return true;
+}
+
 /* Once they've all replied with their manifests, we can order them. */
 static void check_plugins_manifests(struct plugins *plugins)
 {
@@ -170,7 +187,7 @@ static void check_plugins_initted(struct plugins *plugins)
 {
 	struct plugin_command **plugin_cmds;
 
-	if (!plugins_all_in_state(plugins, INIT_COMPLETE))
+	if (!plugins_all_initted(plugins))
 		return;
 
 	/* Clear commands first, in case callbacks add new ones.
@@ -188,7 +205,7 @@ static void check_plugins_initted(struct plugins *plugins)
 struct command_result *plugin_register_all_complete(struct lightningd *ld,
 						    struct plugin_command *pcmd)
 {
-	if (plugins_all_in_state(ld->plugins, INIT_COMPLETE))
+	if (plugins_all_initted(ld->plugins))
 		return plugin_cmd_all_complete(ld->plugins, pcmd);
 
 	tal_arr_expand(&ld->plugins->plugin_cmds, pcmd);
@@ -200,6 +217,7 @@ static void destroy_plugin(struct plugin *p)
 	struct plugin_rpccall *call;
 
 	list_del(&p->list);
+	p->plugins->ld->generation++;
 
 	/* Terminate all pending RPC calls with an error. */
 	list_for_each(&p->pending_rpccalls, call, list) {
@@ -290,11 +308,14 @@ struct plugin *plugin_register(struct plugins *plugins, const char* path TAKES,
 
 	p->plugin_state = UNCONFIGURED;
 	p->js_arr = tal_arr(p, struct json_stream *, 0);
+	p->js_urgent = tal_arr(p, struct json_stream *, 0);
 	p->used = 0;
 	p->notification_topics = tal_arr(p, const char *, 0);
 	p->subscriptions = NULL;
+	p->subscription_filters = NULL;
 	p->dynamic = false;
 	p->non_numeric_ids = false;
+	p->lazy = false;
 	p->index = plugins->plugin_idx++;
 
 	p->log = new_log(p, plugins->log_book, NULL, "plugin-%s", p->shortname);
@@ -351,6 +372,28 @@ void plugin_blacklist(struct plugins *plugins, const char *name)
 		       tal_strdup(plugins->blacklist, name));
 }
 
+void plugin_lazy(struct plugins *plugins, const char *name)
+{
+	tal_arr_expand(&plugins->lazy, tal_strdup(plugins->lazy, name));
+}
+
+static bool plugin_is_lazy(const struct plugin *plugin)
+{
+	const struct plugins *plugins = plugin->plugins;
+
+	/* Important plugins (e.g. bcli) are needed from the start. */
+	if (plugin->important)
+		return false;
+	/* We can't send init while talking to db_write plugins exclusively */
+	if (plugin_hook_registered(plugin, "db_write"))
+		return false;
+
+	for (size_t i = 0; i < tal_count(plugins->lazy); i++)
+		if (plugin_paths_match(plugin->cmd, plugins->lazy[i]))
+			return true;
+	return false;
+}
+
 bool plugin_blacklisted(struct plugins *plugins, const char *name)
 {
 	for (size_t i = 0; i < tal_count(plugins->blacklist); i++)
@@ -520,7 +563,8 @@ static const char *plugin_notification_handle(struct plugin *plugin,
 			    "\"%s\" it hasn't declared in its manifest, not "
 			    "forwarding to subscribers.",
 			    methname);
-	} else if (notifications_have_topic(plugin->plugins, methname)) {
+	} else if (notifications_have_topic(plugin->plugins, methname)
+		   && plugins_anyone_cares(plugin->plugins, methname)) {
 		n = jsonrpc_notification_start(NULL, methname);
 		json_add_string(n->stream, "origin", plugin->shortname);
 		json_add_tok(n->stream, "payload", paramstok, plugin->buffer);
@@ -708,7 +752,7 @@ static const char *plugin_read_json_one(struct plugin *plugin,
 	} else {
 		/* Move this object out of the buffer */
 		memmove(plugin->buffer, plugin->buffer + plugin->toks[0].end,
-			tal_count(plugin->buffer) - plugin->toks[0].end);
+			plugin->used - plugin->toks[0].end);
 		plugin->used -= plugin->toks[0].end;
 		jsmn_init(&plugin->parser);
 		toks_reset(plugin->toks);
@@ -739,6 +783,8 @@ static struct io_plan *plugin_read_json(struct io_conn *conn,
 
 	/* Read and process all messages from the connection */
 	if (have_full) {
+		/* Whatever this is, it may change our state. */
+		plugin->plugins->ld->generation++;
 		do {
 			bool destroyed;
 			const char *err;
@@ -769,6 +815,17 @@ static struct io_plan *plugin_read_json(struct io_conn *conn,
 static struct io_plan *plugin_write_json(struct io_conn *conn,
 					 struct plugin *plugin);
 
+static struct io_plan *plugin_urgent_complete(struct io_conn *conn,
+					     struct json_stream *js,
+					     struct plugin *plugin)
+{
+	assert(tal_count(plugin->js_urgent) > 0);
+	tal_arr_remove(&plugin->js_urgent, 0);
+	tal_free(js);
+
+	return plugin_write_json(conn, plugin);
+}
+
 static struct io_plan *plugin_stream_complete(struct io_conn *conn, struct json_stream *js, struct plugin *plugin)
 {
 	assert(tal_count(plugin->js_arr) > 0);
@@ -784,7 +841,14 @@ static struct io_plan *plugin_stream_complete(struct io_conn *conn, struct json_
 static struct io_plan *plugin_write_json(struct io_conn *conn,
 					 struct plugin *plugin)
 {
-	if (tal_count(plugin->js_arr)) {
+	if (tal_count(plugin->js_urgent))
+		return json_stream_output(plugin->js_urgent[0],
+					  plugin->stdin_conn,
+					  plugin_urgent_complete, plugin);
+
+	/* Anything else could reflect changes which aren't durable yet
+	 * (plugin_hook_db_write_release() wakes us once they are). */
+	if (tal_count(plugin->js_arr) && !plugin_hook_db_write_holds(plugin)) {
 		return json_stream_output(plugin->js_arr[0], plugin->stdin_conn, plugin_stream_complete, plugin);
 	}
 
@@ -1220,6 +1284,7 @@ static const char *plugin_rpcmethod_add(struct plugin *plugin,
 	} else
 		cmd->deprecated = false;
 
+	cmd->cacheable = false;
 	cmd->dispatch = plugin_rpcmethod_dispatch;
 	if (!jsonrpc_command_add(plugin->plugins->ld->jsonrpc, cmd, usage)) {
 		struct plugin *p =
@@ -1269,16 +1334,43 @@ static const char *plugin_subscriptions_add(struct plugin *plugin,
 
 	if (!subscriptions) {
 		plugin->subscriptions = NULL;
+		plugin->subscription_filters = NULL;
 		return NULL;
 	}
 	plugin->subscriptions = tal_arr(plugin, char *, 0);
+	plugin->subscription_filters = tal_arr(plugin, struct json_filter *, 0);
 	if (subscriptions->type != JSMN_ARRAY) {
 		return tal_fmt(plugin, "\"result.subscriptions\" is not an array");
 	}
 
 	for (int i = 0; i < subscriptions->size; i++) {
 		char *topic;
+		struct json_filter *filter = NULL;
 		const jsmntok_t *s = json_get_arr(subscriptions, i);
+
+		/* Can be { "name": topic, "filter": { ... } } */
+		if (s->type == JSMN_OBJECT) {
+			const jsmntok_t *filtertok, *badtok;
+			const char *err;
+
+			filtertok = json_get_member(buffer, s, "filter");
+			if (filtertok) {
+				filter = json_filter_parse(plugin, buffer,
+							   filtertok, &err,
+							   &badtok);
+				if (!filter)
+					return tal_fmt(plugin,
+						       "result.subscriptions[%d].filter %s: '%.*s'",
+						       i, err,
+						       json_tok_full_len(badtok),
+						       json_tok_full(buffer, badtok));
+			}
+			s = json_get_member(buffer, s, "name");
+			if (!s)
+				return tal_fmt(plugin,
+					       "result.subscriptions[%d] has no name",
+					       i);
+		}
 		if (s->type != JSMN_STRING) {
 			return tal_fmt(plugin,
 				       "result.subscriptions[%d] is not a string: '%.*s'", i,
@@ -1292,6 +1384,7 @@ static const char *plugin_subscriptions_add(struct plugin *plugin,
 		 * types that we don't know about yet. */
 		topic = json_strdup(plugin, plugin->buffer, s);
 		tal_arr_expand(&plugin->subscriptions, topic);
+		tal_arr_expand(&plugin->subscription_filters, filter);
 	}
 	return NULL;
 }
@@ -1309,9 +1402,10 @@ static const char *plugin_hooks_add(struct plugin *plugin, const char *buffer,
 	json_for_each_arr(i, t, hookstok) {
 		char *name;
 		struct plugin_hook *hook;
+		bool parallel = false, batch = false;
 
 		if (t->type == JSMN_OBJECT) {
-			const jsmntok_t *nametok;
+			const jsmntok_t *nametok, *paralleltok, *batchtok;
 
 			nametok = json_get_member(buffer, t, "name");
 			if (!nametok)
@@ -1321,6 +1415,20 @@ static const char *plugin_hooks_add(struct plugin *plugin, const char *buffer,
 			name = json_strdup(tmpctx, buffer, nametok);
 			beforetok = json_get_member(buffer, t, "before");
 			aftertok = json_get_member(buffer, t, "after");
+			paralleltok = json_get_member(buffer, t, "parallel");
+			if (paralleltok
+			    && !json_to_bool(buffer, paralleltok, &parallel))
+				return tal_fmt(plugin,
+					       "parallel must be a boolean in hook obj %.*s",
+					       json_tok_full_len(t),
+					       json_tok_full(buffer, t));
+			batchtok = json_get_member(buffer, t, "batch");
+			if (batchtok
+			    && !json_to_bool(buffer, batchtok, &batch))
+				return tal_fmt(plugin,
+					       "batch must be a boolean in hook obj %.*s",
+					       json_tok_full_len(t),
+					       json_tok_full(buffer, t));
 		} else {
 			/* FIXME: deprecate in 3 releases after v0.9.2! */
 			name = json_strdup(tmpctx, plugin->buffer, t);
@@ -1336,7 +1444,8 @@ static const char *plugin_hooks_add(struct plugin *plugin, const char *buffer,
 				    name);
 		}
 
-		plugin_hook_add_deps(hook, plugin, buffer, beforetok, aftertok);
+		plugin_hook_add_deps(hook, plugin, buffer, beforetok, aftertok,
+				     parallel, batch);
 		tal_free(name);
 	}
 	return NULL;
@@ -1922,21 +2031,29 @@ plugin_config(struct plugin *plugin)
 				    plugin->log, NULL, plugin_config_cb, plugin);
 	plugin_populate_init_request(plugin, req);
 	jsonrpc_request_end(req);
-	plugin_request_send(plugin, req);
+	/* Before sending, so plugin_request_send doesn't call us again! */
 	plugin->plugin_state = AWAITING_INIT_RESPONSE;
+	plugin_request_send(plugin, req);
 }
 
 bool plugins_config(struct plugins *plugins)
 {
 	struct plugin *p;
 	list_for_each(&plugins->plugins, p, list) {
-		if (p->plugin_state == NEEDS_INIT)
-			plugin_config(p);
+		if (p->plugin_state != NEEDS_INIT)
+			continue;
+		/* Lazy plugins get init when first needed (plugin_request_send) */
+		if (plugins->startup && plugin_is_lazy(p)) {
+			log_debug(p->log, "Lazy: not starting until used");
+			p->lazy = true;
+			continue;
+		}
+		plugin_config(p);
 	}
 
 	/* Wait for them to configure, before continuing: large
-	 * nodes can take a while to startup! */
-	if (plugins->startup) {
+	 * nodes can take a while to startup!  (Unless they're all lazy) */
+	if (plugins->startup && !plugins_all_initted(plugins)) {
 		/* This happens if an important plugin fails init,
 		 * or if they call shutdown now. */
 		if (io_loop_with_timers(plugins->ld) == plugins->ld)
@@ -2021,6 +2138,15 @@ void json_add_opt_plugins(struct json_stream *response,
 	json_add_opt_plugins_array(response, "important-plugins", plugins, true);
 }
 
+void json_add_opt_lazy_plugins(struct json_stream *response,
+			       const struct plugins *plugins)
+{
+	json_array_start(response, "lazy-plugin");
+	for (size_t i = 0; i < tal_count(plugins->lazy); i++)
+		json_add_string(response, NULL, plugins->lazy[i]);
+	json_array_end(response);
+}
+
 void json_add_opt_disable_plugins(struct json_stream *response,
 				  const struct plugins *plugins)
 {
@@ -2034,21 +2160,65 @@ void json_add_opt_disable_plugins(struct json_stream *response,
  * Determine whether a plugin is subscribed to a given topic/method.
  */
 static bool plugin_subscriptions_contains(struct plugin *plugin,
-					  const char *method)
+					  const char *method,
+					  struct json_filter **filter)
 {
-	for (size_t i = 0; i < tal_count(plugin->subscriptions); i++)
-		if (streq(method, plugin->subscriptions[i]))
+	for (size_t i = 0; i < tal_count(plugin->subscriptions); i++) {
+		if (streq(method, plugin->subscriptions[i])) {
+			if (filter)
+				*filter = plugin->subscription_filters[i];
 			return true;
+		}
+	}
 
 	return false;
 }
 
+/* Copy notification, with the params filtered as plugin asked */
+static struct json_stream *
+notification_filtered(struct plugin *p,
+		      const struct jsonrpc_notification *n,
+		      struct json_filter *filter)
+{
+	struct json_stream *js;
+	const char *buf;
+	size_t len, i;
+	const jsmntok_t *toks, *params, *t;
+
+	buf = json_out_contents(n->stream->jout, &len);
+	toks = json_parse_simple(tmpctx, buf, len);
+	params = json_get_member(buf, toks, "params");
+
+	js = new_json_stream(p, NULL, p->log);
+	json_object_start(js, NULL);
+	json_add_string(js, "jsonrpc", "2.0");
+	json_add_string(js, "method", n->method);
+	json_object_start(js, "params");
+	/* The filter ends where it started, so we can reuse it. */
+	js->filter = filter;
+	json_for_each_obj(i, t, params)
+		json_add_tok(js, json_strdup(tmpctx, buf, t), t + 1, buf);
+	js->filter = NULL;
+	json_object_end(js);
+	json_object_end(js);
+	json_stream_append(js, "\n\n", strlen("\n\n"));
+	return js;
+}
+
 bool plugin_single_notify(struct plugin *p,
 			  const struct jsonrpc_notification *n TAKES)
 {
 	bool interested;
-	if (plugin_subscriptions_contains(p, n->method)) {
-		plugin_send(p, json_stream_dup(p, n->stream, p->log));
+	struct json_filter *filter;
+
+	/* A lazy plugin we haven't started yet misses out. */
+	if (p->plugin_state == NEEDS_INIT && p->lazy)
+		interested = false;
+	else if (plugin_subscriptions_contains(p, n->method, &filter)) {
+		if (filter)
+			plugin_send(p, notification_filtered(p, n, filter));
+		else
+			plugin_send(p, json_stream_dup(p, n->stream, p->log));
 		interested = true;
 	} else
 		interested = false;
@@ -2059,6 +2229,21 @@ bool plugin_single_notify(struct plugin *p,
 	return interested;
 }
 
+bool plugins_anyone_cares(struct plugins *plugins, const char *method)
+{
+	struct plugin *p;
+
+	/* If we're shutting down, ld->plugins will be NULL */
+	if (!plugins)
+		return false;
+
+	list_for_each(&plugins->plugins, p, list) {
+		if (plugin_subscriptions_contains(p, method, NULL))
+			return true;
+	}
+	return false;
+}
+
 void plugins_notify(struct plugins *plugins,
 		    const struct jsonrpc_notification *n TAKES)
 {
@@ -2081,20 +2266,46 @@ static void destroy_request(struct jsonrpc_request *req,
 	strmap_del(&plugin->plugins->pending_requests, req->id, NULL);
 }
 
-void plugin_request_send(struct plugin *plugin,
-			 struct jsonrpc_request *req TAKES)
+static void plugin_request_send_(struct plugin *plugin,
+				 struct jsonrpc_request *req TAKES,
+				 bool urgent)
 {
+	/* Someone needs this lazy plugin now: init goes first. */
+	if (plugin->plugin_state == NEEDS_INIT && plugin->lazy) {
+		log_info(plugin->log, "Lazy plugin needed for %s: starting",
+			 req->method);
+		plugin_config(plugin);
+	}
+
 	/* Add to map so we can find it later when routing the response */
 	tal_steal(plugin, req);
 	strmap_add(&plugin->plugins->pending_requests, req->id, req);
 	/* Add destructor in case plugin dies. */
 	tal_add_destructor2(req, destroy_request, plugin);
-	plugin_send(plugin, req->stream);
+	/* It mustn't overtake getmanifest or init, though. */
+	if (urgent && plugin->plugin_state == INIT_COMPLETE) {
+		tal_steal(plugin->js_urgent, req->stream);
+		tal_arr_expand(&plugin->js_urgent, req->stream);
+		io_wake(plugin);
+	} else
+		plugin_send(plugin, req->stream);
 	/* plugin_send steals the stream, so remove the dangling
 	 * pointer here */
 	req->stream = NULL;
 }
 
+void plugin_request_send(struct plugin *plugin,
+			 struct jsonrpc_request *req TAKES)
+{
+	plugin_request_send_(plugin, req, false);
+}
+
+void plugin_request_send_urgent(struct plugin *plugin,
+				struct jsonrpc_request *req TAKES)
+{
+	plugin_request_send_(plugin, req, true);
+}
+
 void *plugins_exclusive_loop(struct plugin **plugins)
 {
 	void *ret;
@@ -2144,6 +2355,9 @@ void shutdown_plugins(struct lightningd *ld)
 {
 	struct plugin *p, *next;
 
+	/* Don't lose the last few coin movements. */
+	notify_coin_mvts_flush(ld);
+
 	/* Tell them all to shutdown; if they care. */
 	list_for_each_safe(&ld->plugins->plugins, p, next, list) {
 		/* Kill immediately, deletes self from list. */
@@ -58,6 +58,9 @@ struct plugin {
 	 * returning data at once, we always service these in order,
 	 * freeing once empty. */
 	struct json_stream **js_arr;
+	/* db_write hook requests: these go before anything in js_arr, and
+	 * aren't held back while a group commit is pending. */
+	struct json_stream **js_urgent;
 
 	struct log *log;
 
@@ -72,6 +75,8 @@ struct plugin {
 
 	/* An array of subscribed topics */
 	char **subscriptions;
+	/* Optional filter for the params of each (NULL if none) */
+	struct json_filter **subscription_filters;
 
 	/* An array of currently pending RPC method calls, to be killed if the
 	 * plugin exits. */
@@ -84,6 +89,10 @@ struct plugin {
 	/* Can this handle non-numeric JSON ids? */
 	bool non_numeric_ids;
 
+	/* Marked with --lazy-plugin: at startup, we don't send init (or
+	 * notifications) until a method or hook is called. */
+	bool lazy;
+
 	/* Parameters for dynamically-started plugins. */
 	const char *parambuf;
 	const jsmntok_t *params;
@@ -116,6 +125,9 @@ struct plugins {
 	/* Blacklist of plugins from --disable-plugin */
 	const char **blacklist;
 
+	/* Plugins from --lazy-plugin */
+	const char **lazy;
+
 	/* Index to show what order they were added in */
 	u64 plugin_idx;
 
@@ -215,6 +227,14 @@ void plugin_blacklist(struct plugins *plugins, const char *name);
  */
 bool plugin_blacklisted(struct plugins *plugins, const char *name);
 
+/**
+ * Don't initialize a plugin at startup until it's used.
+ *
+ * @param plugins: Plugin context
+ * @param arg: The basename or fullname of the executable for this plugin
+ */
+void plugin_lazy(struct plugins *plugins, const char *name);
+
 /**
  * Kick off initialization of a plugin.
  * @p: plugin
@@ -292,6 +312,12 @@ void json_add_opt_plugins(struct json_stream *response,
 void json_add_opt_disable_plugins(struct json_stream *response,
 				  const struct plugins *plugins);
 
+/**
+ * Add the lazy-plugin options to listconfigs.
+ */
+void json_add_opt_lazy_plugins(struct json_stream *response,
+			       const struct plugins *plugins);
+
 /**
  * Used by db hooks which can't have any other I/O while talking to
  * hooked plugins.
@@ -323,6 +349,13 @@ void clear_plugins(struct plugins *plugins);
 bool plugin_single_notify(struct plugin *p,
 			  const struct jsonrpc_notification *n TAKES);
 
+/**
+ * Is any plugin subscribed to this notification topic?
+ *
+ * Lets callers skip building notifications nobody will see.
+ */
+bool plugins_anyone_cares(struct plugins *plugins, const char *method);
+
 /**
  * Send notification to all interested plugins.
  */
@@ -335,6 +368,13 @@ void plugins_notify(struct plugins *plugins,
 void plugin_request_send(struct plugin *plugin,
 			 struct jsonrpc_request *req TAKES);
 
+/**
+ * Send a jsonrpc_request ahead of anything else queued for the plugin
+ * (for the db_write hook, which group commit waits for).
+ */
+void plugin_request_send_urgent(struct plugin *plugin,
+				struct jsonrpc_request *req TAKES);
+
 /**
  * Callback called when parsing options. It just stores the value in
  * the plugin_opt
@@ -3,6 +3,8 @@
 #include <ccan/tal/str/str.h>
 #include <common/json_parse.h>
 #include <common/memleak.h>
+#include <common/timeout.h>
+#include <common/trace_probe.h>
 #include <db/exec.h>
 #include <db/utils.h>
 #include <lightningd/plugin_hook.h>
@@ -19,12 +21,47 @@ struct plugin_hook_request {
 	struct lightningd *ld;
 };
 
+/* A queued change set for a batched db_write plugin. */
+struct db_write_set {
+	u32 data_version;
+	const char **writes;
+};
+
 struct hook_instance {
 	/* What plugin registered */
 	struct plugin *plugin;
 
+	/* Which hook this is */
+	const struct plugin_hook *hook;
+
 	/* Dependencies it asked for. */
 	const char **before, **after;
+
+	/* Can it be called at the same time as its neighbours? */
+	bool parallel;
+
+	/* Does it want calls batched up? */
+	bool batch;
+
+	/* If so, calls waiting for batch_timer. */
+	struct plugin_hook_call_link **batched;
+	struct oneshot *batch_timer;
+
+	/* For batched db_write: change sets not sent yet, how many requests
+	 * are awaiting acks, and are we blocked waiting for them all? */
+	struct db_write_set *db_unsent;
+	size_t db_inflight;
+	bool db_waiting;
+
+	/* For getrpcstats */
+	struct call_stats stats;
+};
+
+/* A batched call in flight. */
+struct hook_batch {
+	const struct plugin_hook *hook;
+	/* Entries are NULLed if they're freed while we process reply */
+	struct plugin_hook_call_link **links;
 };
 
 /* A link in the plugin_hook call chain (there's a joke in there about
@@ -36,7 +73,17 @@ struct hook_instance {
 struct plugin_hook_call_link {
 	struct list_node list;
 	struct plugin *plugin;
+	/* NULL if chain finished while we were still waiting for reply. */
 	struct plugin_hook_request *req;
+	/* The plugin's registration (for parallel and batch flags) */
+	struct hook_instance *instance;
+	/* Have we sent (or batched) the request yet?  When, and how big? */
+	bool sent;
+	struct timemono sent_time;
+	size_t bytes_out;
+	/* If it replied before it was its turn, here's the reply. */
+	const char *buffer;
+	const jsmntok_t *toks;
 };
 
 static struct plugin_hook **get_hooks(size_t *num)
@@ -64,6 +111,10 @@ static struct plugin_hook *plugin_hook_by_name(const char *name)
 static void destroy_hook_instance(struct hook_instance *h,
 				  struct plugin_hook *hook)
 {
+	/* Don't leave plugin_hook_db_write_drain() waiting forever. */
+	if (h->db_waiting)
+		io_break(h);
+
 	for (size_t i = 0; i < tal_count(hook->hooks); i++) {
 		if (h == hook->hooks[i]) {
 			tal_arr_remove(&hook->hooks, i);
@@ -95,18 +146,39 @@ struct plugin_hook *plugin_hook_register(struct plugin *plugin, const char *meth
 	 * register them. */
 	h = tal(plugin, struct hook_instance);
 	h->plugin = plugin;
+	h->hook = hook;
 	h->before = tal_arr(h, const char *, 0);
 	h->after = tal_arr(h, const char *, 0);
+	h->parallel = false;
+	h->batch = false;
+	h->batched = tal_arr(h, struct plugin_hook_call_link *, 0);
+	h->batch_timer = NULL;
+	h->db_unsent = tal_arr(h, struct db_write_set, 0);
+	h->db_inflight = 0;
+	h->db_waiting = false;
+	memset(&h->stats, 0, sizeof(h->stats));
 	tal_add_destructor2(h, destroy_hook_instance, hook);
 
 	tal_arr_expand(&hook->hooks, h);
 	return hook;
 }
 
+bool plugin_hook_registered(const struct plugin *plugin, const char *method)
+{
+	const struct plugin_hook *hook = plugin_hook_by_name(method);
+
+	if (!hook)
+		return false;
+	for (size_t i = 0; i < tal_count(hook->hooks); i++)
+		if (hook->hooks[i]->plugin == plugin)
+			return true;
+	return false;
+}
+
 /* Mutual recursion */
 static void plugin_hook_call_next(struct plugin_hook_request *ph_req);
-static void plugin_hook_callback(const char *buffer, const jsmntok_t *toks,
-				 const jsmntok_t *idtok,
+static void plugin_hook_callback(const char *buffer,
+				 const jsmntok_t *resulttok,
 				 struct plugin_hook_request *r);
 
 /* We get notified if a plugin was killed while it was part of a call
@@ -134,7 +206,8 @@ static void plugin_hook_killed(struct plugin_hook_call_link *link)
 		/* Call next will unlink, so we don't need to. This is treated
 		 * equivalent to the plugin returning a continue-result.
 		 */
-		plugin_hook_callback(NULL, NULL, NULL, link->req);
+		link->req->plugin = link->plugin;
+		plugin_hook_callback(NULL, NULL, link->req);
 	} else {
 		/* The plugin is in the list waiting to be called, just remove
 		 * it from the list. */
@@ -149,25 +222,28 @@ bool plugin_hook_continue(void *unused, const char *buffer, const jsmntok_t *tok
 }
 
 /**
- * Callback to be passed to the jsonrpc_request.
+ * Called with the result from the head of the call chain.
  *
- * Unbundles the arguments, deserializes the response and dispatches
- * it to the hook callback.
+ * Deserializes the response and dispatches it to the hook callback
+ * (or the next plugin in the chain).  @buffer is NULL if plugin died.
  */
-static void plugin_hook_callback(const char *buffer, const jsmntok_t *toks,
-				 const jsmntok_t *idtok,
+static void plugin_hook_callback(const char *buffer,
+				 const jsmntok_t *resulttok,
 				 struct plugin_hook_request *r)
 {
-	const jsmntok_t *resulttok;
 	struct db *db = r->db;
-	struct plugin_hook_call_link *last, *it;
+	struct plugin_hook_call_link *last, *it, *next;
 	bool in_transaction = false;
 
 	/* Pop the head off the call chain and continue with the next */
 	last = list_pop(&r->call_chain, struct plugin_hook_call_link, list);
 	assert(last != NULL);
 	tal_del_destructor(last, plugin_hook_killed);
-	tal_free(last);
+	/* If we're processing its saved reply, we need that a bit longer */
+	if (last->buffer)
+		tal_steal(tmpctx, last);
+	else
+		tal_free(last);
 
 	/* Actually, if it dies during shutdown, *don't* process result! */
 	if (!buffer && r->ld->state == LD_STATE_SHUTDOWN) {
@@ -180,13 +256,6 @@ static void plugin_hook_callback(const char *buffer, const jsmntok_t *toks,
 		  r->plugin->shortname, r->hook->name);
 
 	if (buffer) {
-		resulttok = json_get_member(buffer, toks, "result");
-
-		if (!resulttok)
-			fatal("Plugin for %s returned non-result response %.*s",
-			      r->hook->name, toks->end - toks->start,
-			      buffer + toks->start);
-
 		db_begin_transaction(db);
 		if (!r->hook->deserialize_cb(r->cb_arg, buffer,
 					     resulttok)) {
@@ -195,9 +264,6 @@ static void plugin_hook_callback(const char *buffer, const jsmntok_t *toks,
 			goto cleanup;
 		}
 		in_transaction = true;
-	} else {
-		/* plugin died */
-		resulttok = NULL;
 	}
 
 	if (!list_empty(&r->call_chain)) {
@@ -214,35 +280,231 @@ static void plugin_hook_callback(const char *buffer, const jsmntok_t *toks,
 	db_commit_transaction(db);
 
 cleanup:
+	TRACE_PROBE2(plugin_hook_end, r->hook->name, r);
+
 	/* We need to remove the destructors from the remaining
 	 * call-chain, otherwise they'd still be called when the
 	 * plugin dies or we shut down. */
-	list_for_each(&r->call_chain, it, list) {
+	list_for_each_safe(&r->call_chain, it, next, list) {
 		tal_del_destructor(it, plugin_hook_killed);
-		tal_steal(r, it);
+		list_del(&it->list);
+		/* A parallel call we're still waiting for: the reply
+		 * will free it (or the plugin will, if it dies). */
+		if (it->sent && !it->buffer)
+			it->req = NULL;
+		else
+			tal_steal(r, it);
 	}
 
 	tal_free(r);
 }
 
-static void plugin_hook_call_next(struct plugin_hook_request *ph_req)
+/* A result for this link: might not be its turn yet, if called in parallel. */
+static void plugin_hook_link_result(struct plugin_hook_call_link *link,
+				    const char *buffer,
+				    const jsmntok_t *resulttok)
+{
+	struct plugin_hook_request *r = link->req;
+
+	call_stats_add(&link->instance->stats, timemono_since(link->sent_time),
+		       false, json_tok_full_len(resulttok), link->bytes_out);
+
+	/* Chain finished without needing us. */
+	if (!r) {
+		tal_free(link);
+		return;
+	}
+
+	if (link != list_top(&r->call_chain, struct plugin_hook_call_link,
+			     list)) {
+		log_debug(r->ld->log,
+			  "Plugin %s returned early from %s hook call",
+			  link->plugin->shortname, r->hook->name);
+		link->buffer = tal_dup_arr(link, char, buffer,
+					   resulttok->end, 0);
+		link->toks = tal_dup_arr(link, jsmntok_t, resulttok,
+					 json_next(resulttok) - resulttok, 0);
+		return;
+	}
+
+	r->plugin = link->plugin;
+	plugin_hook_callback(buffer, resulttok, r);
+}
+
+static const jsmntok_t *hook_result(const struct plugin_hook *hook,
+				    const char *buffer,
+				    const jsmntok_t *toks)
+{
+	const jsmntok_t *resulttok = json_get_member(buffer, toks, "result");
+
+	if (!resulttok)
+		fatal("Plugin for %s returned non-result response %.*s",
+		      hook->name, toks->end - toks->start,
+		      buffer + toks->start);
+	return resulttok;
+}
+
+/* Callback to be passed to the jsonrpc_request. */
+static void plugin_hook_link_callback(const char *buffer, const jsmntok_t *toks,
+				      const jsmntok_t *idtok,
+				      struct plugin_hook_call_link *link)
+{
+	plugin_hook_link_result(link, buffer,
+				hook_result(link->instance->hook, buffer, toks));
+}
+
+static void clear_batch_slot(struct plugin_hook_call_link *link,
+			     struct plugin_hook_call_link **slot)
+{
+	*slot = NULL;
+}
+
+/* Callback for a batched jsonrpc_request: we get an array of results. */
+static void plugin_hook_batch_callback(const char *buffer,
+				       const jsmntok_t *toks,
+				       const jsmntok_t *idtok,
+				       struct hook_batch *b)
+{
+	const jsmntok_t *resulttok, *arr, *t, **elems;
+	size_t i, n = tal_count(b->links);
+
+	resulttok = hook_result(b->hook, buffer, toks);
+	arr = json_get_member(buffer, resulttok, "batch");
+	if (!arr || arr->type != JSMN_ARRAY || (size_t)arr->size != n)
+		fatal("Plugin for %s returned bad batch response %.*s",
+		      b->hook->name, toks->end - toks->start,
+		      buffer + toks->start);
+
+	/* Processing one result can do anything, even kill the plugin
+	 * (freeing its buffer, and the remaining links). */
+	tal_steal(tmpctx, b);
+	elems = tal_arr(b, const jsmntok_t *, n);
+	json_for_each_arr(i, t, arr) {
+		elems[i] = t;
+		tal_add_destructor2(b->links[i], clear_batch_slot,
+				    &b->links[i]);
+	}
+
+	for (i = 0; i < n; i++) {
+		struct plugin_hook_call_link *link = b->links[i];
+		if (!link)
+			continue;
+		tal_del_destructor2(link, clear_batch_slot, &b->links[i]);
+		plugin_hook_link_result(link, buffer, elems[i]);
+	}
+}
+
+static void plugin_hook_batch_send(struct hook_instance *h)
+{
+	struct hook_batch *b = tal(h->plugin, struct hook_batch);
+	struct jsonrpc_request *req;
+	struct lightningd *ld = NULL;
+
+	h->batch_timer = NULL;
+	b->hook = h->hook;
+	b->links = tal_arr(b, struct plugin_hook_call_link *, 0);
+	for (size_t i = 0; i < tal_count(h->batched); i++) {
+		struct plugin_hook_call_link *link = h->batched[i];
+		/* Chain already finished without it? */
+		if (!link->req) {
+			tal_free(link);
+			continue;
+		}
+		ld = link->req->ld;
+		tal_arr_expand(&b->links, link);
+	}
+	tal_resize(&h->batched, 0);
+
+	if (tal_count(b->links) == 0) {
+		tal_free(b);
+		return;
+	}
+
+	log_debug(ld->log, "Calling %s hook of plugin %s with batch of %zu",
+		  h->hook->name, h->plugin->shortname, tal_count(b->links));
+	req = jsonrpc_request_start(NULL, h->hook->name, NULL,
+				    h->plugin->non_numeric_ids,
+				    plugin_get_log(h->plugin),
+				    NULL,
+				    plugin_hook_batch_callback, b);
+
+	json_array_start(req->stream, "batch");
+	for (size_t i = 0; i < tal_count(b->links); i++) {
+		size_t start = json_stream_total_len(req->stream);
+		json_object_start(req->stream, NULL);
+		h->hook->serialize_payload(b->links[i]->req->cb_arg,
+					   req->stream, h->plugin);
+		json_object_end(req->stream);
+		b->links[i]->bytes_out = json_stream_total_len(req->stream)
+			- start;
+	}
+	json_array_end(req->stream);
+	jsonrpc_request_end(req);
+	plugin_request_send(h->plugin, req);
+}
+
+static void plugin_hook_send(struct plugin_hook_request *ph_req,
+			     struct plugin_hook_call_link *link)
 {
 	struct jsonrpc_request *req;
 	const struct plugin_hook *hook = ph_req->hook;
-	assert(!list_empty(&ph_req->call_chain));
-	ph_req->plugin = list_top(&ph_req->call_chain, struct plugin_hook_call_link, list)->plugin;
+	struct hook_instance *h = link->instance;
+
+	link->sent = true;
+	link->sent_time = time_mono();
+
+	/* Batch up all the calls we make this io_loop iteration. */
+	if (h->batch) {
+		tal_arr_expand(&h->batched, link);
+		if (!h->batch_timer)
+			h->batch_timer = new_reltimer(ph_req->ld->timers, h,
+						      time_from_msec(0),
+						      plugin_hook_batch_send,
+						      h);
+		return;
+	}
 
 	log_debug(ph_req->ld->log, "Calling %s hook of plugin %s",
-		  ph_req->hook->name, ph_req->plugin->shortname);
+		  ph_req->hook->name, link->plugin->shortname);
 	req = jsonrpc_request_start(NULL, hook->name, ph_req->cmd_id,
-				    ph_req->plugin->non_numeric_ids,
-				    plugin_get_log(ph_req->plugin),
+				    link->plugin->non_numeric_ids,
+				    plugin_get_log(link->plugin),
 				    NULL,
-				    plugin_hook_callback, ph_req);
+				    plugin_hook_link_callback, link);
 
-	hook->serialize_payload(ph_req->cb_arg, req->stream, ph_req->plugin);
+	hook->serialize_payload(ph_req->cb_arg, req->stream, link->plugin);
 	jsonrpc_request_end(req);
-	plugin_request_send(ph_req->plugin, req);
+	link->bytes_out = json_stream_total_len(req->stream);
+	plugin_request_send(link->plugin, req);
+}
+
+static void plugin_hook_call_next(struct plugin_hook_request *ph_req)
+{
+	struct plugin_hook_call_link *link;
+
+	assert(!list_empty(&ph_req->call_chain));
+	link = list_top(&ph_req->call_chain, struct plugin_hook_call_link, list);
+	ph_req->plugin = link->plugin;
+
+	/* Called in parallel, and it already replied? */
+	if (link->buffer) {
+		plugin_hook_callback(link->buffer, link->toks, ph_req);
+		return;
+	}
+
+	/* Called in parallel, still waiting. */
+	if (link->sent)
+		return;
+
+	plugin_hook_send(ph_req, link);
+
+	/* Parallel plugins next to each other don't wait for each other
+	 * (but we still process their replies in order). */
+	if (!link->instance->parallel)
+		return;
+	while ((link = list_next(&ph_req->call_chain, link, list)) != NULL
+	       && link->instance->parallel)
+		plugin_hook_send(ph_req, link);
 }
 
 bool plugin_hook_call_(struct lightningd *ld, const struct plugin_hook *hook,
@@ -267,6 +529,9 @@ bool plugin_hook_call_(struct lightningd *ld, const struct plugin_hook *hook,
 		else
 			ph_req->cmd_id = NULL;
 
+		/* The request pointer pairs this with plugin_hook_end */
+		TRACE_PROBE2(plugin_hook_start, hook->name, ph_req);
+
 		list_head_init(&ph_req->call_chain);
 		for (size_t i=0; i<tal_count(hook->hooks); i++) {
 			/* We allocate this off of the plugin so we get notified if the plugin dies. */
@@ -274,6 +539,9 @@ bool plugin_hook_call_(struct lightningd *ld, const struct plugin_hook *hook,
 				   struct plugin_hook_call_link);
 			link->plugin = hook->hooks[i]->plugin;
 			link->req = ph_req;
+			link->instance = hook->hooks[i];
+			link->sent = false;
+			link->buffer = NULL;
 			tal_add_destructor(link, plugin_hook_killed);
 			list_add_tail(&ph_req->call_chain, &link->list);
 		}
@@ -297,11 +565,30 @@ bool plugin_hook_call_(struct lightningd *ld, const struct plugin_hook *hook,
 static struct plugin_hook db_write_hook = {"db_write", NULL, NULL};
 AUTODATA(hooks, &db_write_hook);
 
+/* With "batch": true, db_write calls don't block: we stream change sets
+ * to the plugin, and the caller holds the db commit (and all output)
+ * until plugin_hook_db_write_synced().  Up to this many requests can be
+ * in flight before we queue change sets to send together... */
+#define DB_WRITE_MAX_INFLIGHT 4
+/* ... and if that queue gets this long, we wait for the plugin. */
+#define DB_WRITE_MAX_UNSENT 256
+
+/* A batched `db_write` request in flight. */
+struct db_write_batch_req {
+	struct hook_instance *instance;
+	size_t num_sets;
+	struct timemono sent_time;
+	size_t bytes_out;
+};
+
 /* A `db_write` for one particular plugin hook.  */
 struct db_write_hook_req {
 	struct plugin *plugin;
+	struct hook_instance *instance;
 	struct plugin_hook_request *ph_req;
 	size_t *num_hooks;
+	struct timemono sent_time;
+	size_t bytes_out;
 };
 
 static void db_hook_response(const char *buffer, const jsmntok_t *toks,
@@ -311,6 +598,15 @@ static void db_hook_response(const char *buffer, const jsmntok_t *toks,
 	const jsmntok_t *resulttok;
 
 	resulttok = json_get_member(buffer, toks, "result");
+	/* Batch plugins reply with a single-entry batch. */
+	if (resulttok && dwh_req->instance->batch) {
+		resulttok = json_get_member(buffer, resulttok, "batch");
+		if (resulttok && resulttok->type == JSMN_ARRAY
+		    && resulttok->size == 1)
+			resulttok = json_get_arr(resulttok, 0);
+		else
+			resulttok = NULL;
+	}
 	if (!resulttok)
 		fatal("Plugin '%s' returned an invalid response to the "
 		      "db_write hook: %.*s",
@@ -335,6 +631,10 @@ static void db_hook_response(const char *buffer, const jsmntok_t *toks,
 		      json_tok_full_len(toks),
 		      json_tok_full(buffer, toks));
 
+	call_stats_add(&dwh_req->instance->stats,
+		       timemono_since(dwh_req->sent_time),
+		       false, json_tok_full_len(toks), dwh_req->bytes_out);
+
 	assert((*dwh_req->num_hooks) != 0);
 	--(*dwh_req->num_hooks);
 	/* If there are other runners, do not exit yet.  */
@@ -346,6 +646,211 @@ static void db_hook_response(const char *buffer, const jsmntok_t *toks,
 	io_break(dwh_req->ph_req);
 }
 
+static bool db_write_instance_synced(const struct hook_instance *h)
+{
+	return h->db_inflight == 0 && tal_count(h->db_unsent) == 0;
+}
+
+static void db_write_batch_send(struct hook_instance *h);
+
+static void db_write_batch_response(const char *buffer,
+				    const jsmntok_t *toks,
+				    const jsmntok_t *idtok,
+				    struct db_write_batch_req *b)
+{
+	struct hook_instance *h = b->instance;
+	const jsmntok_t *resulttok, *arr, *t;
+	size_t i;
+
+	resulttok = json_get_member(buffer, toks, "result");
+	arr = resulttok ? json_get_member(buffer, resulttok, "batch") : NULL;
+	if (!arr || arr->type != JSMN_ARRAY || arr->size != b->num_sets)
+		fatal("Plugin '%s' returned an invalid response to the "
+		      "batched db_write hook: %.*s",
+		      h->plugin->cmd,
+		      json_tok_full_len(toks),
+		      json_tok_full(buffer, toks));
+
+	json_for_each_arr(i, t, arr) {
+		const jsmntok_t *r = json_get_member(buffer, t, "result");
+		if (!r || !json_tok_streq(buffer, r, "continue"))
+			fatal("Plugin '%s' returned failed db_write: %.*s.",
+			      h->plugin->cmd,
+			      json_tok_full_len(toks),
+			      json_tok_full(buffer, toks));
+	}
+
+	call_stats_add(&h->stats, timemono_since(b->sent_time),
+		       false, json_tok_full_len(toks), b->bytes_out);
+	tal_free(b);
+
+	assert(h->db_inflight != 0);
+	h->db_inflight--;
+	if (tal_count(h->db_unsent) != 0)
+		db_write_batch_send(h);
+	else if (h->db_waiting && db_write_instance_synced(h)) {
+		log_debug(h->plugin->plugins->ld->log, "io_break: %s", __func__);
+		io_break(h);
+	}
+}
+
+/* Send all the change sets queued for this plugin, as one request. */
+static void db_write_batch_send(struct hook_instance *h)
+{
+	struct db_write_batch_req *b = tal(h, struct db_write_batch_req);
+	struct jsonrpc_request *req;
+
+	b->instance = h;
+	b->num_sets = tal_count(h->db_unsent);
+	req = jsonrpc_request_start(NULL, h->hook->name, NULL,
+				    h->plugin->non_numeric_ids,
+				    NULL, NULL,
+				    db_write_batch_response, b);
+	json_array_start(req->stream, "batch");
+	for (size_t i = 0; i < tal_count(h->db_unsent); i++) {
+		const struct db_write_set *set = &h->db_unsent[i];
+
+		json_object_start(req->stream, NULL);
+		json_add_num(req->stream, "data_version", set->data_version);
+		json_array_start(req->stream, "writes");
+		for (size_t j = 0; j < tal_count(set->writes); j++)
+			json_add_string(req->stream, NULL, set->writes[j]);
+		json_array_end(req->stream);
+		json_object_end(req->stream);
+		tal_free(set->writes);
+	}
+	json_array_end(req->stream);
+	jsonrpc_request_end(req);
+	tal_resize(&h->db_unsent, 0);
+
+	b->sent_time = time_mono();
+	b->bytes_out = json_stream_total_len(req->stream);
+	h->db_inflight++;
+	plugin_request_send_urgent(h->plugin, req);
+}
+
+/* Block until this plugin has acked everything we sent it. */
+static void db_write_instance_wait(struct hook_instance *h)
+{
+	struct plugin **plugins;
+	void *ret;
+
+	if (db_write_instance_synced(h))
+		return;
+
+	plugins = notleak(tal_arr(NULL, struct plugin *, 1));
+	plugins[0] = h->plugin;
+	h->db_waiting = true;
+
+	/* As in plugin_hook_db_sync, we may be called while already
+	 * breaking out of an io_loop. */
+	ret = plugins_exclusive_loop(plugins);
+	if (ret != h) {
+		void *ret2 = plugins_exclusive_loop(plugins);
+		assert(ret2 == h);
+		io_break(ret);
+	}
+	tal_free(plugins);
+
+	/* Careful: plugin may have died, freeing h. */
+	for (size_t i = 0; i < tal_count(db_write_hook.hooks); i++) {
+		if (db_write_hook.hooks[i] == h)
+			h->db_waiting = false;
+	}
+}
+
+static void db_write_batch_add(struct hook_instance *h,
+			       u32 data_version, const char **changes)
+{
+	struct db_write_set set;
+
+	set.data_version = data_version;
+	set.writes = tal_dup_talarr(h, const char *, changes);
+	for (size_t i = 0; i < tal_count(set.writes); i++)
+		set.writes[i] = tal_strdup(set.writes, set.writes[i]);
+	tal_arr_expand(&h->db_unsent, set);
+
+	if (h->db_inflight < DB_WRITE_MAX_INFLIGHT)
+		db_write_batch_send(h);
+	else if (tal_count(h->db_unsent) >= DB_WRITE_MAX_UNSENT)
+		db_write_instance_wait(h);
+}
+
+bool plugin_hook_db_write_synced(void)
+{
+	for (size_t i = 0; i < tal_count(db_write_hook.hooks); i++) {
+		if (!db_write_instance_synced(db_write_hook.hooks[i]))
+			return false;
+	}
+	return true;
+}
+
+bool plugin_hook_db_write_batched(bool *all)
+{
+	bool any = false;
+
+	*all = true;
+	for (size_t i = 0; i < tal_count(db_write_hook.hooks); i++) {
+		if (db_write_hook.hooks[i]->batch)
+			any = true;
+		else
+			*all = false;
+	}
+	return any;
+}
+
+bool plugin_hook_db_write_uses_fd(int fd)
+{
+	for (size_t i = 0; i < tal_count(db_write_hook.hooks); i++) {
+		const struct plugin *p = db_write_hook.hooks[i]->plugin;
+		if (p->stdin_conn && io_conn_fd(p->stdin_conn) == fd)
+			return true;
+	}
+	return false;
+}
+
+bool plugin_hook_db_write_holds(const struct plugin *plugin)
+{
+	const struct lightningd *ld = plugin->plugins->ld;
+
+	/* Until init is done, everything goes out in order (see
+	 * plugin_request_send_urgent). */
+	if (plugin->plugin_state != INIT_COMPLETE
+	    || !ld->wallet || !db_commit_pending(ld->wallet->db))
+		return false;
+
+	for (size_t i = 0; i < tal_count(db_write_hook.hooks); i++) {
+		if (db_write_hook.hooks[i]->plugin == plugin)
+			return true;
+	}
+	return false;
+}
+
+bool plugin_hook_db_write_release(void)
+{
+	bool woken = false;
+
+	for (size_t i = 0; i < tal_count(db_write_hook.hooks); i++) {
+		struct plugin *p = db_write_hook.hooks[i]->plugin;
+		if (tal_count(p->js_arr)) {
+			io_wake(p);
+			woken = true;
+		}
+	}
+	return woken;
+}
+
+void plugin_hook_db_write_drain(void)
+{
+	/* Waiting can free instances, so restart each time. */
+	for (size_t i = 0; i < tal_count(db_write_hook.hooks); i++) {
+		if (!db_write_instance_synced(db_write_hook.hooks[i])) {
+			db_write_instance_wait(db_write_hook.hooks[i]);
+			i = -1;
+		}
+	}
+}
+
 void plugin_hook_db_sync(struct db *db)
 {
 	const struct plugin_hook *hook = &db_write_hook;
@@ -353,18 +858,38 @@ void plugin_hook_db_sync(struct db *db)
 	struct plugin_hook_request *ph_req;
 	void *ret;
 	struct plugin **plugins;
+	struct hook_instance **instances;
 	size_t i;
 	size_t num_hooks;
+	u32 data_version;
 
 	const char **changes = db_changes(db);
-	num_hooks = tal_count(hook->hooks);
-	if (num_hooks == 0)
+	if (tal_count(hook->hooks) == 0)
+		return;
+
+	data_version = db_data_version_get(db);
+
+	/* Batched hooks only need the changes before we actually commit,
+	 * but we can only delay that under group commit. */
+	instances = notleak(tal_arr(NULL, struct hook_instance *, 0));
+	for (i = 0; i < tal_count(hook->hooks); ++i) {
+		if (hook->hooks[i]->batch && db_group_commit(db))
+			db_write_batch_add(hook->hooks[i],
+					   data_version, changes);
+		else
+			tal_arr_expand(&instances, hook->hooks[i]);
+	}
+
+	num_hooks = tal_count(instances);
+	if (num_hooks == 0) {
+		tal_free(instances);
 		return;
+	}
 
 	plugins = notleak(tal_arr(NULL, struct plugin *,
 				  num_hooks));
 	for (i = 0; i < num_hooks; ++i)
-		plugins[i] = hook->hooks[i]->plugin;
+		plugins[i] = instances[i]->plugin;
 
 	ph_req = notleak(tal(hook->hooks, struct plugin_hook_request));
 	ph_req->hook = hook;
@@ -376,6 +901,7 @@ void plugin_hook_db_sync(struct db *db)
 		struct db_write_hook_req *dwh_req;
 		dwh_req = tal(ph_req, struct db_write_hook_req);
 		dwh_req->plugin = plugins[i];
+		dwh_req->instance = instances[i];
 		dwh_req->ph_req = ph_req;
 		dwh_req->num_hooks = &num_hooks;
 
@@ -387,16 +913,26 @@ void plugin_hook_db_sync(struct db *db)
 					    db_hook_response,
 					    dwh_req);
 
-		json_add_num(req->stream, "data_version",
-			     db_data_version_get(db));
+		/* Batch plugins always get the batch format. */
+		if (instances[i]->batch) {
+			json_array_start(req->stream, "batch");
+			json_object_start(req->stream, NULL);
+		}
+		json_add_num(req->stream, "data_version", data_version);
 
 		json_array_start(req->stream, "writes");
 		for (size_t j = 0; j < tal_count(changes); j++)
 			json_add_string(req->stream, NULL, changes[j]);
 		json_array_end(req->stream);
+		if (instances[i]->batch) {
+			json_object_end(req->stream);
+			json_array_end(req->stream);
+		}
 		jsonrpc_request_end(req);
 
-		plugin_request_send(plugins[i], req);
+		dwh_req->sent_time = time_mono();
+		dwh_req->bytes_out = json_stream_total_len(req->stream);
+		plugin_request_send_urgent(plugins[i], req);
 	}
 
 	/* We can be called on way out of an io_loop, which is already breaking.
@@ -411,6 +947,7 @@ void plugin_hook_db_sync(struct db *db)
 	}
 	assert(num_hooks == 0);
 	tal_free(plugins);
+	tal_free(instances);
 	tal_free(ph_req);
 }
 
@@ -432,7 +969,9 @@ void plugin_hook_add_deps(struct plugin_hook *hook,
 			  struct plugin *plugin,
 			  const char *buffer,
 			  const jsmntok_t *before,
-			  const jsmntok_t *after)
+			  const jsmntok_t *after,
+			  bool parallel,
+			  bool batch)
 {
 	struct hook_instance *h = NULL;
 
@@ -447,6 +986,8 @@ void plugin_hook_add_deps(struct plugin_hook *hook,
 
 	add_deps(&h->before, buffer, before);
 	add_deps(&h->after, buffer, after);
+	h->parallel = parallel;
+	h->batch = batch;
 }
 
 struct hook_node {
@@ -575,3 +1116,22 @@ struct plugin **plugin_hooks_make_ordered(const tal_t *ctx)
 
 	return ret;
 }
+
+void json_add_plugin_hook_stats(struct json_stream *js)
+{
+	size_t num_hooks;
+	struct plugin_hook **hooks = get_hooks(&num_hooks);
+
+	json_array_start(js, "hooks");
+	for (size_t i = 0; i < num_hooks; i++) {
+		for (size_t j = 0; j < tal_count(hooks[i]->hooks); j++) {
+			const struct hook_instance *h = hooks[i]->hooks[j];
+			json_object_start(js, NULL);
+			json_add_string(js, "hook", hooks[i]->name);
+			json_add_string(js, "plugin", h->plugin->shortname);
+			json_add_call_stats(js, &h->stats);
+			json_object_end(js);
+		}
+	}
+	json_array_end(js);
+}
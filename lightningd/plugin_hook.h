@@ -110,17 +110,47 @@ bool plugin_hook_continue(void *arg, const char *buffer, const jsmntok_t *toks);
 struct plugin_hook *plugin_hook_register(struct plugin *plugin,
 					 const char *method);
 
+/* Has this plugin registered this hook? */
+bool plugin_hook_registered(const struct plugin *plugin, const char *method);
+
 /* Special sync plugin hook for db. */
 void plugin_hook_db_sync(struct db *db);
 
-/* Add dependencies for this hook. */
+/* Have all batched db_write plugins acked every change set?  Until they
+ * have, the db must not be durably committed. */
+bool plugin_hook_db_write_synced(void);
+
+/* Are any db_write plugins batched?  Sets @all if they all are. */
+bool plugin_hook_db_write_batched(bool *all);
+
+/* Is @fd one we must still write to while waiting for acks? */
+bool plugin_hook_db_write_uses_fd(int fd);
+
+/* Is this a db_write plugin, and a group commit pending?  Then only its
+ * db_write requests go out: the rest waits for plugin_hook_db_write_release. */
+bool plugin_hook_db_write_holds(const struct plugin *plugin);
+
+/* After a commit, wake db_write plugins with held output.  Returns true if
+ * there were any. */
+bool plugin_hook_db_write_release(void);
+
+/* Wait for all batched db_write plugins to ack. */
+void plugin_hook_db_write_drain(void);
+
+/* Add dependencies for this hook, and whether it can be called in parallel
+ * or batched. */
 void plugin_hook_add_deps(struct plugin_hook *hook,
 			  struct plugin *plugin,
 			  const char *buffer,
 			  const jsmntok_t *before,
-			  const jsmntok_t *after);
+			  const jsmntok_t *after,
+			  bool parallel,
+			  bool batch);
 
 /* Returns array of plugins which cannot be ordered (empty on success) */
 struct plugin **plugin_hooks_make_ordered(const tal_t *ctx);
 
+/* Add "hooks" array of statistics for each plugin's hook (getrpcstats) */
+void json_add_plugin_hook_stats(struct json_stream *js);
+
 #endif /* LIGHTNING_LIGHTNINGD_PLUGIN_HOOK_H */
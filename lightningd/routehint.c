@@ -1,5 +1,7 @@
 #include "config.h"
+#include <ccan/tal/str/str.h>
 #include <common/bolt11.h>
+#include <common/gossip_constants.h>
 #include <common/json_parse.h>
 #include <common/type_to_string.h>
 #include <gossipd/gossipd_wiregen.h>
@@ -7,6 +9,86 @@
 #include <lightningd/lightningd.h>
 #include <lightningd/peer_control.h>
 #include <lightningd/routehint.h>
+#include <sys/stat.h>
+
+/* The last listincoming reply: everything in it comes from the gossmap,
+ * and the balances and states we combine it with are always read live. */
+struct routehint_cache {
+	const char *buf;
+	jsmntok_t *toks;
+	/* The gossip_store only ever grows, or is replaced on compaction. */
+	dev_t store_dev;
+	ino_t store_ino;
+	off_t store_size;
+};
+
+static bool stat_gossip_store(struct stat *st)
+{
+	return stat(GOSSIP_STORE_FILENAME, st) == 0;
+}
+
+struct routehint_cache *routehint_cache_start(const tal_t *ctx)
+{
+	struct routehint_cache *cache;
+	struct stat st;
+
+	if (!stat_gossip_store(&st))
+		return NULL;
+
+	cache = tal(ctx, struct routehint_cache);
+	cache->buf = NULL;
+	cache->toks = NULL;
+	cache->store_dev = st.st_dev;
+	cache->store_ino = st.st_ino;
+	cache->store_size = st.st_size;
+	return cache;
+}
+
+void routehint_cache_set(struct lightningd *ld,
+			 struct routehint_cache *cache,
+			 const char *buf, const jsmntok_t *toks)
+{
+	routehint_cache_invalidate(ld);
+	if (!cache)
+		return;
+
+	cache->buf = tal_strndup(cache, buf + toks->start,
+				 toks->end - toks->start);
+	/* Rebase the tokens onto our copy of just this reply. */
+	cache->toks = json_tok_copy(cache, toks);
+	for (size_t i = 0; i < tal_count(cache->toks); i++) {
+		cache->toks[i].start -= toks->start;
+		cache->toks[i].end -= toks->start;
+	}
+	ld->routehint_cache = tal_steal(ld, cache);
+}
+
+bool routehint_cache_get(struct lightningd *ld,
+			 const char **buf, const jsmntok_t **toks)
+{
+	struct stat st;
+
+	if (!ld->routehint_cache)
+		return false;
+
+	/* Any new gossip could change fees or capacities in the reply. */
+	if (!stat_gossip_store(&st)
+	    || st.st_dev != ld->routehint_cache->store_dev
+	    || st.st_ino != ld->routehint_cache->store_ino
+	    || st.st_size != ld->routehint_cache->store_size) {
+		routehint_cache_invalidate(ld);
+		return false;
+	}
+
+	*buf = ld->routehint_cache->buf;
+	*toks = ld->routehint_cache->toks;
+	return true;
+}
+
+void routehint_cache_invalidate(struct lightningd *ld)
+{
+	ld->routehint_cache = tal_free(ld->routehint_cache);
+}
 
 static bool scid_in_arr(const struct short_channel_id *scidarr,
 			const struct short_channel_id *scid)
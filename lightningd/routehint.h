@@ -8,6 +8,7 @@
 #include <stdbool.h>
 
 struct lightningd;
+struct routehint_cache;
 struct short_channel_id;
 
 struct routehint_candidate {
@@ -42,4 +43,35 @@ routehint_candidates(const tal_t *ctx,
 		     struct amount_msat *deadend_capacity,
 		     struct amount_msat *offline_capacity);
 
+/**
+ * routehint_cache_start - note the gossip_store before calling listincoming.
+ * @ctx: tal context to allocate return off
+ *
+ * Returns NULL if there's no gossip_store to compare against later.
+ */
+struct routehint_cache *routehint_cache_start(const tal_t *ctx);
+
+/**
+ * routehint_cache_set - remember a listincoming reply for later invoices.
+ * @ld: lightningd
+ * @cache: from routehint_cache_start before the call (may be NULL).
+ * @buf, @toks: output of listincoming command (copied)
+ */
+void routehint_cache_set(struct lightningd *ld,
+			 struct routehint_cache *cache,
+			 const char *buf, const jsmntok_t *toks);
+
+/**
+ * routehint_cache_get - get the remembered listincoming reply, if still valid.
+ * @ld: lightningd
+ * @buf, @toks: set to the cached output, valid until the cache is invalidated.
+ *
+ * Returns false if there is none, or the gossip_store has changed since.
+ */
+bool routehint_cache_get(struct lightningd *ld,
+			 const char **buf, const jsmntok_t **toks);
+
+/* Forget the listincoming reply: call when one of our channels changes state. */
+void routehint_cache_invalidate(struct lightningd *ld);
+
 #endif /* LIGHTNING_LIGHTNINGD_ROUTEHINT_H */
@@ -3,10 +3,9 @@
 #include <common/configdir.h>
 #include <common/json_command.h>
 #include <common/json_param.h>
-#include <errno.h>
 #include <hsmd/hsmd_wiregen.h>
+#include <lightningd/hsm_control.h>
 #include <lightningd/plugin.h>
-#include <wire/wire_sync.h>
 
 /* These tables copied from zbase32 src:
  * copyright 2002-2007 Zooko "Zooko" Wilcox-O'Hearn
@@ -57,33 +56,15 @@ static const u8 *from_zbase32(const tal_t *ctx, const char *msg)
 	return len == tal_bytelen(u8arr) ? u8arr : tal_free(u8arr);
 }
 
-static struct command_result *json_signmessage(struct command *cmd,
-					       const char *buffer,
-					       const jsmntok_t *obj UNNEEDED,
-					       const jsmntok_t *params)
+static void sign_message_reply(struct lightningd *ld,
+			       const u8 *msg,
+			       struct command *cmd)
 {
-	const char *message;
 	secp256k1_ecdsa_recoverable_signature rsig;
 	struct json_stream *response;
-	u8 sig[65], *msg;
+	u8 sig[65];
 	int recid;
 
-	if (!param(cmd, buffer, params,
-		   p_req("message", param_string, &message),
-		   NULL))
-		return command_param_failed();
-
-	if (strlen(message) > 65535)
-		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
-				    "Message must be < 64k");
-
-	msg = towire_hsmd_sign_message(NULL,
-				      tal_dup_arr(tmpctx, u8, (u8 *)message,
-						  strlen(message), 0));
-	if (!wire_sync_write(cmd->ld->hsm_fd, take(msg)))
-		fatal("Could not write to HSM: %s", strerror(errno));
-
-	msg = wire_sync_read(tmpctx, cmd->ld->hsm_fd);
 	if (!fromwire_hsmd_sign_message_reply(msg, &rsig))
 		fatal("HSM gave bad hsm_sign_message_reply %s",
 		      tal_hex(msg, msg));
@@ -105,7 +86,31 @@ static struct command_result *json_signmessage(struct command *cmd,
 	sig[0] += 31;
 	json_add_string(response, "zbase",
 			to_zbase32(response, sig, sizeof(sig)));
-	return command_success(cmd, response);
+	was_pending(command_success(cmd, response));
+}
+
+static struct command_result *json_signmessage(struct command *cmd,
+					       const char *buffer,
+					       const jsmntok_t *obj UNNEEDED,
+					       const jsmntok_t *params)
+{
+	const char *message;
+	u8 *msg;
+
+	if (!param(cmd, buffer, params,
+		   p_req("message", param_string, &message),
+		   NULL))
+		return command_param_failed();
+
+	if (strlen(message) > 65535)
+		return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+				    "Message must be < 64k");
+
+	msg = towire_hsmd_sign_message(NULL,
+				      tal_dup_arr(tmpctx, u8, (u8 *)message,
+						  strlen(message), 0));
+	hsm_req(cmd, cmd->ld, take(msg), sign_message_reply, cmd);
+	return command_still_pending(cmd);
 }
 
 static const struct json_command json_signmessage_cmd = {
@@ -1,6 +1,9 @@
 #include "config.h"
+#include <ccan/array_size/array_size.h>
 #include <ccan/closefrom/closefrom.h>
+#include <ccan/crypto/siphash24/siphash24.h>
 #include <ccan/err/err.h>
+#include <ccan/htable/htable_type.h>
 #include <ccan/io/fdpass/fdpass.h>
 #include <ccan/mem/mem.h>
 #include <ccan/noerr/noerr.h>
@@ -8,6 +11,7 @@
 #include <ccan/tal/str/str.h>
 #include <common/memleak.h>
 #include <common/peer_status_wiregen.h>
+#include <common/pseudorand.h>
 #include <common/status_wiregen.h>
 #include <common/version.h>
 #include <db/exec.h>
@@ -17,6 +21,8 @@
 #include <lightningd/log_status.h>
 #include <lightningd/peer_fd.h>
 #include <lightningd/subd.h>
+#include <sched.h>
+#include <sys/resource.h>
 #include <sys/socket.h>
 #include <sys/wait.h>
 #include <wire/wire_io.h>
@@ -101,6 +107,7 @@ static bool shuffle_fds(int **fds, size_t num_fds)
 }
 
 struct subd_req {
+	/* Inside subd_req_queue->reqs */
 	struct list_node list;
 
 	/* Callback for a reply. */
@@ -113,6 +120,32 @@ struct subd_req {
 	void *disabler;
 };
 
+/* Outstanding requests of one type, oldest first. */
+struct subd_req_queue {
+	int type;
+	struct list_head reqs;
+};
+
+static int subd_req_queue_type(const struct subd_req_queue *q)
+{
+	return q->type;
+}
+
+static size_t req_type_hash(int type)
+{
+	return siphash24(siphash_seed(), &type, sizeof(type));
+}
+
+static bool subd_req_queue_type_eq(const struct subd_req_queue *q, int type)
+{
+	return q->type == type;
+}
+
+/* Defines struct subd_req_map */
+HTABLE_DEFINE_TYPE(struct subd_req_queue,
+		   subd_req_queue_type, req_type_hash, subd_req_queue_type_eq,
+		   subd_req_map);
+
 static void destroy_subd_req(struct subd_req *sr)
 {
 	list_del(&sr->list);
@@ -144,8 +177,20 @@ static struct subd_req *add_req(const tal_t *ctx,
 						void *),
 				void *replycb_data)
 {
-	struct subd_req *sr = tal(sd, struct subd_req);
+	struct subd_req *sr;
+	struct subd_req_queue *q;
+
+	/* Queues last as long as sd: there are only a few request types. */
+	q = subd_req_map_get(sd->reqs, type);
+	if (!q) {
+		q = tal(sd, struct subd_req_queue);
+		q->type = type;
+		list_head_init(&q->reqs);
+		subd_req_map_add(sd->reqs, q);
+	}
 
+	/* Off q, so freeing sd frees these before their list head. */
+	sr = tal(q, struct subd_req);
 	sr->type = type;
 	sr->replycb = replycb;
 	sr->replycb_data = replycb_data;
@@ -162,26 +207,36 @@ static struct subd_req *add_req(const tal_t *ctx,
 	assert(strends(sd->msgname(sr->type + SUBD_REPLY_OFFSET), "_REPLY"));
 
 	/* Keep in FIFO order: we sent in order, so replies will be too. */
-	list_add_tail(&sd->reqs, &sr->list);
+	list_add_tail(&q->reqs, &sr->list);
 	tal_add_destructor(sr, destroy_subd_req);
 
 	return sr;
 }
 
+static struct subd_req *oldest_req(struct subd *sd, int type)
+{
+	struct subd_req_queue *q = subd_req_map_get(sd->reqs, type);
+
+	if (!q)
+		return NULL;
+	return list_top(&q->reqs, struct subd_req, list);
+}
+
 /* Caller must free. */
 static struct subd_req *get_req(struct subd *sd, int reply_type)
 {
 	struct subd_req *sr;
 
-	list_for_each(&sd->reqs, sr, list) {
-		if (sr->type + SUBD_REPLY_OFFSET == reply_type)
-			return sr;
-		/* If it's a fail, and that's a valid type. */
-		if (sr->type + SUBD_REPLYFAIL_OFFSET == reply_type
-		    && strends(sd->msgname(reply_type), "_REPLYFAIL")) {
-			sr->num_reply_fds = 0;
-			return sr;
-		}
+	/* add_req() checked this is a _REPLY, so it can't be a _REPLYFAIL */
+	sr = oldest_req(sd, reply_type - SUBD_REPLY_OFFSET);
+	if (sr)
+		return sr;
+
+	/* If it's a fail, and that's a valid type. */
+	sr = oldest_req(sd, reply_type - SUBD_REPLYFAIL_OFFSET);
+	if (sr && strends(sd->msgname(reply_type), "_REPLYFAIL")) {
+		sr->num_reply_fds = 0;
+		return sr;
 	}
 	return NULL;
 }
@@ -198,11 +253,35 @@ static void close_taken_fds(va_list *ap)
 	}
 }
 
+/* In the child: apply any --subdaemon-sched.  Sets errno on failure. */
+static bool apply_sched(const struct subdaemon_sched *sched)
+{
+	if (!sched)
+		return true;
+
+	if (setpriority(PRIO_PROCESS, 0, sched->nice) != 0)
+		return false;
+
+#ifdef __linux__
+	if (sched->cpus) {
+		cpu_set_t set;
+
+		CPU_ZERO(&set);
+		for (size_t i = 0; i < tal_count(sched->cpus); i++)
+			CPU_SET(sched->cpus[i], &set);
+		if (sched_setaffinity(0, sizeof(set), &set) != 0)
+			return false;
+	}
+#endif
+	return true;
+}
+
 /* We use sockets, not pipes, because fds are bidir. */
 static int subd(const char *path, const char *name,
 		const char *debug_subdaemon,
 		int *msgfd,
 		bool io_logging,
+		const struct subdaemon_sched *sched,
 		va_list *ap)
 {
 	int childmsg[2], execfail[2];
@@ -252,6 +331,9 @@ static int subd(const char *path, const char *name,
 		/* Make (fairly!) sure all other fds are closed. */
 		closefrom(tal_count(fds));
 
+		if (!apply_sched(sched))
+			goto child_errno_fail;
+
 		num_args = 0;
 		args[num_args++] = tal_strdup(NULL, path);
 		if (io_logging)
@@ -486,6 +568,8 @@ static struct io_plan *sd_msg_read(struct io_conn *conn, struct subd *sd)
 
 	/* Everything we do, we wrap in a database transaction */
 	db_begin_transaction(db);
+	/* And may change our state. */
+	sd->ld->generation++;
 
 	if (type == -1)
 		goto malformed;
@@ -594,6 +678,7 @@ static void destroy_subd(struct subd *sd)
 
 	fail_if_subd_fails = IFDEV(sd->ld->dev_subdaemon_fail, false);
 	list_del_from(&sd->ld->subds, &sd->list);
+	sd->ld->generation++;
 
 	/* lightningd may have already done waitpid() */
 	if (sd->wstatus != NULL) {
@@ -664,13 +749,18 @@ static void destroy_subd(struct subd *sd)
 
 static struct io_plan *msg_send_next(struct io_conn *conn, struct subd *sd)
 {
-	const u8 *msg;
+	const u8 *msg, **msgs;
 	int fd;
 
 	/* Don't send if we haven't read version! */
 	if (!sd->rcvd_version)
 		return msg_queue_wait(conn, sd->outq, msg_send_next, sd);
 
+	/* Send everything up to the next fd in one go. */
+	msgs = msg_dequeue_batch(NULL, sd->outq);
+	if (msgs)
+		return io_write_wire_batch(conn, take(msgs), msg_send_next, sd);
+
 	/* Nothing to do?  Wait for msg_enqueue. */
 	msg = msg_dequeue(sd->outq);
 	if (!msg)
@@ -743,6 +833,7 @@ static struct subd *new_subd(const tal_t *ctx,
 		       /* We only turn on subdaemon io logging if we're going
 			* to print it: too stressful otherwise! */
 		       log_print_level(sd->log, node_id) < LOG_DBG,
+		       strmap_get(&ld->subdaemon_scheds, shortname),
 		       ap);
 	if (sd->pid == (pid_t)-1) {
 		log_unusual(ld->log, "subd %s failed: %s",
@@ -765,7 +856,8 @@ static struct subd *new_subd(const tal_t *ctx,
 	sd->wstatus = NULL;
 	list_add(&ld->subds, &sd->list);
 	tal_add_destructor(sd, destroy_subd);
-	list_head_init(&sd->reqs);
+	sd->reqs = tal(sd, struct subd_req_map);
+	subd_req_map_init(sd->reqs);
 	sd->channel = channel;
 	sd->rcvd_version = false;
 	sd->node_id = tal_dup_or_null(sd, struct node_id, node_id);
@@ -869,37 +961,60 @@ static void discard_alarm(int sig UNNEEDED)
 {
 }
 
-struct subd *subd_shutdown(struct subd *sd, unsigned int seconds)
+void subd_shutdown_many(struct subd **sds[], size_t num, unsigned int seconds)
 {
 	struct sigaction sa, old;
+	bool timed_out = false;
+
+	/* Close them all first, so they exit in parallel. */
+	for (size_t i = 0; i < num; i++) {
+		struct subd *sd = *sds[i];
+		if (!sd)
+			continue;
 
-	log_debug(sd->log, "Shutting down");
+		log_debug(sd->log, "Shutting down");
 
-	tal_del_destructor(sd, destroy_subd);
+		tal_del_destructor(sd, destroy_subd);
 
-	/* This should make it exit; steal so it stays around. */
-	tal_steal(sd->ld, sd);
-	sd->conn = tal_free(sd->conn);
+		/* This should make it exit; steal so it stays around. */
+		tal_steal(sd->ld, sd);
+		sd->conn = tal_free(sd->conn);
+	}
 
-	/* Set up alarm to wake us up if child doesn't exit. */
+	/* Set up alarm to wake us up if children don't exit. */
 	sa.sa_handler = discard_alarm;
 	sigemptyset(&sa.sa_mask);
 	sa.sa_flags = 0;
 	sigaction(SIGALRM, &sa, &old);
 	alarm(seconds);
 
-	if (waitpid(sd->pid, NULL, 0) > 0) {
-		alarm(0);
-		sigaction(SIGALRM, &old, NULL);
-		list_del_from(&sd->ld->subds, &sd->list);
-		return tal_free(sd);
+	for (size_t i = 0; i < num; i++) {
+		struct subd *sd = *sds[i];
+		if (!sd)
+			continue;
+
+		/* Once the alarm has gone off, don't wait any more. */
+		if (waitpid(sd->pid, NULL, timed_out ? WNOHANG : 0) > 0) {
+			list_del_from(&sd->ld->subds, &sd->list);
+		} else {
+			timed_out = true;
+			/* Didn't die?  This will kill it harder */
+			sd->must_not_exit = false;
+			destroy_subd(sd);
+		}
+		*sds[i] = tal_free(sd);
 	}
 
+	alarm(0);
 	sigaction(SIGALRM, &old, NULL);
-	/* Didn't die?  This will kill it harder */
-	sd->must_not_exit = false;
-	destroy_subd(sd);
-	return tal_free(sd);
+}
+
+struct subd *subd_shutdown(struct subd *sd, unsigned int seconds)
+{
+	struct subd **sds[] = { &sd };
+
+	subd_shutdown_many(sds, ARRAY_SIZE(sds), seconds);
+	return sd;
 }
 
 void subd_shutdown_nonglobals(struct lightningd *ld)
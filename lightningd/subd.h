@@ -75,8 +75,8 @@ struct subd {
 	/* Messages queue up here. */
 	struct msg_queue *outq;
 
-	/* Callbacks for replies. */
-	struct list_head reqs;
+	/* Callbacks for replies, by request type. */
+	struct subd_req_map *reqs;
 
 	/* Did lightningd already wait for this pid? */
 	int *wstatus;
@@ -224,6 +224,17 @@ void subd_release_channel(struct subd *owner, const void *channel);
  */
 struct subd *subd_shutdown(struct subd *subd, unsigned int seconds);
 
+/**
+ * subd_shutdown_many - subd_shutdown() several subdaemons at once.
+ * @sds: pointers to the subds to shutdown (each is set to NULL).
+ * @num: number of @sds.
+ * @seconds: maximum seconds to wait for them all to exit.
+ *
+ * They're all told to exit before we wait for any of them, so this takes
+ * as long as the slowest, not the sum.
+ */
+void subd_shutdown_many(struct subd **sds[], size_t num, unsigned int seconds);
+
 /**
  * subd_shutdown_nonglobals - kill all per-peer subds
  * @ld: lightningd
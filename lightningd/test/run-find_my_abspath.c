@@ -37,6 +37,12 @@ void daemon_shutdown(void)
 /* Generated stub for db_begin_transaction_ */
 void db_begin_transaction_(struct db *db UNNEEDED, const char *location UNNEEDED)
 { fprintf(stderr, "db_begin_transaction_ called!\n"); abort(); }
+/* Generated stub for db_commit_flush */
+void db_commit_flush(struct db *db UNNEEDED)
+{ fprintf(stderr, "db_commit_flush called!\n"); abort(); }
+/* Generated stub for db_commit_pending */
+bool db_commit_pending(const struct db *db UNNEEDED)
+{ fprintf(stderr, "db_commit_pending called!\n"); abort(); }
 /* Generated stub for db_commit_transaction */
 void db_commit_transaction(struct db *db UNNEEDED)
 { fprintf(stderr, "db_commit_transaction called!\n"); abort(); }
@@ -46,6 +52,9 @@ s64 db_get_intvar(struct db *db UNNEEDED, char *varname UNNEEDED, s64 defval UNN
 /* Generated stub for db_in_transaction */
 bool db_in_transaction(struct db *db UNNEEDED)
 { fprintf(stderr, "db_in_transaction called!\n"); abort(); }
+/* Generated stub for db_set_group_commit */
+void db_set_group_commit(struct db *db UNNEEDED, bool enable UNNEEDED)
+{ fprintf(stderr, "db_set_group_commit called!\n"); abort(); }
 /* Generated stub for discard_key */
 void discard_key(struct secret *key TAKES UNNEEDED)
 { fprintf(stderr, "discard_key called!\n"); abort(); }
@@ -142,6 +151,9 @@ void log_backtrace_exit(void)
 /* Generated stub for log_backtrace_print */
 void log_backtrace_print(const char *fmt UNNEEDED, ...)
 { fprintf(stderr, "log_backtrace_print called!\n"); abort(); }
+/* Generated stub for log_flush */
+void log_flush(void)
+{ fprintf(stderr, "log_flush called!\n"); abort(); }
 /* Generated stub for log_prefix */
 const char *log_prefix(const struct log *log UNNEEDED)
 { fprintf(stderr, "log_prefix called!\n"); abort(); }
@@ -153,6 +165,9 @@ bool log_status_msg(struct log *log UNNEEDED,
  		    const struct node_id *node_id UNNEEDED,
 		    const u8 *msg UNNEEDED)
 { fprintf(stderr, "log_status_msg called!\n"); abort(); }
+/* Generated stub for new_forward_stats */
+struct forward_stats *new_forward_stats(const tal_t *ctx UNNEEDED)
+{ fprintf(stderr, "new_forward_stats called!\n"); abort(); }
 /* Generated stub for new_log */
 struct log *new_log(const tal_t *ctx UNNEEDED, struct log_book *record UNNEEDED,
 		    const struct node_id *default_node_id UNNEEDED,
@@ -170,6 +185,21 @@ struct chain_topology *new_topology(struct lightningd *ld UNNEEDED, struct log *
 /* Generated stub for onchaind_replay_channels */
 void onchaind_replay_channels(struct lightningd *ld UNNEEDED)
 { fprintf(stderr, "onchaind_replay_channels called!\n"); abort(); }
+/* Generated stub for plugin_hook_db_write_batched */
+bool plugin_hook_db_write_batched(bool *all UNNEEDED)
+{ fprintf(stderr, "plugin_hook_db_write_batched called!\n"); abort(); }
+/* Generated stub for plugin_hook_db_write_drain */
+void plugin_hook_db_write_drain(void)
+{ fprintf(stderr, "plugin_hook_db_write_drain called!\n"); abort(); }
+/* Generated stub for plugin_hook_db_write_release */
+bool plugin_hook_db_write_release(void)
+{ fprintf(stderr, "plugin_hook_db_write_release called!\n"); abort(); }
+/* Generated stub for plugin_hook_db_write_synced */
+bool plugin_hook_db_write_synced(void)
+{ fprintf(stderr, "plugin_hook_db_write_synced called!\n"); abort(); }
+/* Generated stub for plugin_hook_db_write_uses_fd */
+bool plugin_hook_db_write_uses_fd(int fd UNNEEDED)
+{ fprintf(stderr, "plugin_hook_db_write_uses_fd called!\n"); abort(); }
 /* Generated stub for plugins_config */
 bool plugins_config(struct plugins *plugins UNNEEDED)
 { fprintf(stderr, "plugins_config called!\n"); abort(); }
@@ -58,6 +58,9 @@ void broadcast_tx(struct chain_topology *topo UNNEEDED,
 /* Generated stub for channel_change_state_reason_str */
 const char *channel_change_state_reason_str(enum state_change reason UNNEEDED)
 { fprintf(stderr, "channel_change_state_reason_str called!\n"); abort(); }
+/* Generated stub for channel_changed */
+void channel_changed(struct channel *channel UNNEEDED)
+{ fprintf(stderr, "channel_changed called!\n"); abort(); }
 /* Generated stub for channel_cleanup_commands */
 void channel_cleanup_commands(struct channel *channel UNNEEDED, const char *why UNNEEDED)
 { fprintf(stderr, "channel_cleanup_commands called!\n"); abort(); }
@@ -90,6 +93,9 @@ void channel_internal_error(struct channel *channel UNNEEDED, const char *fmt UN
 /* Generated stub for channel_last_funding_feerate */
 u32 channel_last_funding_feerate(const struct channel *channel UNNEEDED)
 { fprintf(stderr, "channel_last_funding_feerate called!\n"); abort(); }
+/* Generated stub for channel_last_tx */
+struct bitcoin_tx *channel_last_tx(const struct channel *channel UNNEEDED)
+{ fprintf(stderr, "channel_last_tx called!\n"); abort(); }
 /* Generated stub for channel_set_last_tx */
 void channel_set_last_tx(struct channel *channel UNNEEDED,
 			 struct bitcoin_tx *tx UNNEEDED,
@@ -138,6 +144,9 @@ struct log *command_log(struct command *cmd UNNEEDED)
 struct command_result *command_param_failed(void)
 
 { fprintf(stderr, "command_param_failed called!\n"); abort(); }
+/* Generated stub for command_should_pause */
+bool command_should_pause(const struct command *cmd UNNEEDED)
+{ fprintf(stderr, "command_should_pause called!\n"); abort(); }
 /* Generated stub for command_still_pending */
 struct command_result *command_still_pending(struct command *cmd)
 
@@ -147,6 +156,13 @@ struct command_result *command_success(struct command *cmd UNNEEDED,
 				       struct json_stream *response)
 
 { fprintf(stderr, "command_success called!\n"); abort(); }
+/* Generated stub for command_wait_for_output_ */
+struct command_result *command_wait_for_output_(struct command *cmd UNNEEDED,
+						struct command_result *(*cb)(struct command * UNNEEDED,
+									     void *) UNNEEDED,
+						void *arg UNNEEDED)
+
+{ fprintf(stderr, "command_wait_for_output_ called!\n"); abort(); }
 /* Generated stub for connect_any_cmd_id */
 const char *connect_any_cmd_id(const tal_t *ctx UNNEEDED,
 			       struct lightningd *ld UNNEEDED, const struct peer *peer UNNEEDED)
@@ -282,6 +298,13 @@ u32 get_feerate(const struct fee_states *fee_states UNNEEDED,
 /* Generated stub for hash_htlc_key */
 size_t hash_htlc_key(const struct htlc_key *htlc_key UNNEEDED)
 { fprintf(stderr, "hash_htlc_key called!\n"); abort(); }
+/* Generated stub for hsm_req_ */
+void hsm_req_(const tal_t *ctx UNNEEDED,
+	      struct lightningd *ld UNNEEDED,
+	      const u8 *msg TAKES UNNEEDED,
+	      void (*cb)(struct lightningd * UNNEEDED, const u8 * UNNEEDED, void *) UNNEEDED,
+	      void *arg UNNEEDED)
+{ fprintf(stderr, "hsm_req_ called!\n"); abort(); }
 /* Generated stub for htlc_is_trimmed */
 bool htlc_is_trimmed(enum side htlc_owner UNNEEDED,
 		     struct amount_msat htlc_amount UNNEEDED,
@@ -483,6 +506,9 @@ struct json_stream *json_stream_fail(struct command *cmd UNNEEDED,
 /* Generated stub for json_stream_success */
 struct json_stream *json_stream_success(struct command *cmd UNNEEDED)
 { fprintf(stderr, "json_stream_success called!\n"); abort(); }
+/* Generated stub for json_stream_wants */
+bool json_stream_wants(const struct json_stream *js UNNEEDED, const char *fieldname UNNEEDED)
+{ fprintf(stderr, "json_stream_wants called!\n"); abort(); }
 /* Generated stub for json_to_address_scriptpubkey */
 enum address_parse_result json_to_address_scriptpubkey(const tal_t *ctx UNNEEDED,
 			     const struct chainparams *chainparams UNNEEDED,
@@ -826,6 +852,9 @@ void wallet_channel_save(struct wallet *w UNNEEDED, struct channel *chan UNNEEDE
 /* Generated stub for wallet_channel_stats_load */
 void wallet_channel_stats_load(struct wallet *w UNNEEDED, u64 cdbid UNNEEDED, struct channel_stats *stats UNNEEDED)
 { fprintf(stderr, "wallet_channel_stats_load called!\n"); abort(); }
+/* Generated stub for wallet_channels_with_htlcs */
+u64 *wallet_channels_with_htlcs(const tal_t *ctx UNNEEDED, struct wallet *wallet UNNEEDED)
+{ fprintf(stderr, "wallet_channels_with_htlcs called!\n"); abort(); }
 /* Generated stub for wallet_channeltxs_add */
 void wallet_channeltxs_add(struct wallet *w UNNEEDED, struct channel *chan UNNEEDED,
 			    const int type UNNEEDED, const struct bitcoin_txid *txid UNNEEDED,
@@ -892,7 +921,10 @@ bool wallet_invoice_find_unpaid(struct wallet *wallet UNNEEDED,
 { fprintf(stderr, "wallet_invoice_find_unpaid called!\n"); abort(); }
 /* Generated stub for wallet_invoice_iterate */
 bool wallet_invoice_iterate(struct wallet *wallet UNNEEDED,
-			    struct invoice_iterator *it UNNEEDED)
+			    struct invoice_iterator *it UNNEEDED,
+			    const struct sha256 *local_offer_id UNNEEDED,
+			    u64 start UNNEEDED,
+			    const u32 *limit UNNEEDED)
 { fprintf(stderr, "wallet_invoice_iterate called!\n"); abort(); }
 /* Generated stub for wallet_invoice_iterator_deref */
 const struct invoice_details *wallet_invoice_iterator_deref(const tal_t *ctx UNNEEDED,
@@ -908,14 +940,18 @@ bool wallet_invoice_resolve(struct wallet *wallet UNNEEDED,
 void wallet_invoice_waitany(const tal_t *ctx UNNEEDED,
 			    struct wallet *wallet UNNEEDED,
 			    u64 lastpay_index UNNEEDED,
-			    void (*cb)(const struct invoice * UNNEEDED, void*) UNNEEDED,
+			    void (*cb)(const struct invoice * UNNEEDED,
+				       const struct invoice_details * UNNEEDED,
+				       void *) UNNEEDED,
 			    void *cbarg UNNEEDED)
 { fprintf(stderr, "wallet_invoice_waitany called!\n"); abort(); }
 /* Generated stub for wallet_invoice_waitone */
 void wallet_invoice_waitone(const tal_t *ctx UNNEEDED,
 			    struct wallet *wallet UNNEEDED,
 			    struct invoice invoice UNNEEDED,
-			    void (*cb)(const struct invoice * UNNEEDED, void*) UNNEEDED,
+			    void (*cb)(const struct invoice * UNNEEDED,
+				       const struct invoice_details * UNNEEDED,
+				       void *) UNNEEDED,
 			    void *cbarg UNNEEDED)
 { fprintf(stderr, "wallet_invoice_waitone called!\n"); abort(); }
 /* Generated stub for wallet_offer_find */
@@ -13,6 +13,9 @@ void db_begin_transaction_(struct db *db UNNEEDED, const char *location UNNEEDED
 /* Generated stub for db_commit_transaction */
 void db_commit_transaction(struct db *db UNNEEDED)
 { fprintf(stderr, "db_commit_transaction called!\n"); abort(); }
+/* Generated stub for db_time_spent */
+struct timerel db_time_spent(const struct db *db UNNEEDED)
+{ fprintf(stderr, "db_time_spent called!\n"); abort(); }
 /* Generated stub for deprecated_apis */
 bool deprecated_apis;
 /* Generated stub for fatal */
@@ -28,6 +31,9 @@ bool fromwire_channel_id(const u8 **cursor UNNEEDED, size_t *max UNNEEDED,
 /* Generated stub for fromwire_node_id */
 void fromwire_node_id(const u8 **cursor UNNEEDED, size_t *max UNNEEDED, struct node_id *id UNNEEDED)
 { fprintf(stderr, "fromwire_node_id called!\n"); abort(); }
+/* Generated stub for json_add_plugin_hook_stats */
+void json_add_plugin_hook_stats(struct json_stream *js UNNEEDED)
+{ fprintf(stderr, "json_add_plugin_hook_stats called!\n"); abort(); }
 /* Generated stub for json_to_jsonrpc_errcode */
 bool json_to_jsonrpc_errcode(const char *buffer UNNEEDED, const jsmntok_t *tok UNNEEDED,
 			     enum jsonrpc_errcode *errcode UNNEEDED)
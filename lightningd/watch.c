@@ -27,6 +27,7 @@
  * WE ASSUME NO MALLEABILITY!  This requires segregated witness.
  */
 #include "config.h"
+#include <bitcoin/script.h>
 #include <common/type_to_string.h>
 #include <lightningd/chaintopology.h>
 #include <lightningd/channel.h>
@@ -43,6 +44,9 @@ struct txowatch {
 	/* Output to watch. */
 	struct bitcoin_outpoint out;
 
+	/* Its scriptpubkey, once we've looked it up (for block filters). */
+	const u8 *script;
+
 	/* A new tx. */
 	enum watch_result (*cb)(struct channel *channel,
 				const struct bitcoin_tx *tx,
@@ -62,6 +66,9 @@ struct txwatch {
 	/* May be NULL if we haven't seen it yet. */
 	const struct bitcoin_tx *tx;
 
+	/* Height of the block it's in, or 0 if not (yet) mined. */
+	u32 height;
+
 	unsigned int depth;
 
 	/* A new depth (0 if kicked out, otherwise 1 = tip, etc.) */
@@ -135,6 +142,7 @@ struct txwatch *watch_txid(const tal_t *ctx,
 	w->depth = 0;
 	w->txid = *txid;
 	w->tx = NULL;
+	w->height = wallet_transaction_height(topo->ld->wallet, txid);
 	w->channel = channel;
 	w->cb = cb;
 
@@ -198,6 +206,7 @@ struct txowatch *watch_txo(const tal_t *ctx,
 
 	w->topo = topo;
 	w->out = *outpoint;
+	w->script = NULL;
 	w->channel = channel;
 	w->cb = cb;
 
@@ -245,8 +254,17 @@ void txwatch_fire(struct chain_topology *topo,
 		  const struct bitcoin_txid *txid,
 		  unsigned int depth)
 {
+	struct txwatch_hash_iter i;
 	struct txwatch *txw;
 
+	/* A depth of 0 means it was reorged out. */
+	if (depth == 0) {
+		for (txw = txwatch_hash_getfirst(topo->txwatches, txid, &i);
+		     txw;
+		     txw = txwatch_hash_getnext(topo->txwatches, txid, &i))
+			txw->height = 0;
+	}
+
 	txw = txwatch_hash_get(topo->txwatches, txid);
 
 	if (txw)
@@ -292,8 +310,12 @@ void watch_topology_changed(struct chain_topology *topo)
 		     w = txwatch_hash_next(topo->txwatches, &i)) {
 			u32 depth;
 
-			depth = get_tx_depth(topo, &w->txid);
-			if (depth) {
+			/* We track the height ourselves, rather than asking
+			 * the db about every watch on every block. */
+			if (!w->height || w->height > topo->tip->height)
+				continue;
+			depth = topo->tip->height - w->height + 1;
+			if (depth != w->depth) {
 				if (!w->tx)
 					w->tx = wallet_transaction_get(w, topo->ld->wallet,
 								       &w->txid);
@@ -305,12 +327,90 @@ void watch_topology_changed(struct chain_topology *topo)
 
 void txwatch_inform(const struct chain_topology *topo,
 		    const struct bitcoin_txid *txid,
-		    const struct bitcoin_tx *tx_may_steal)
+		    const struct bitcoin_tx *tx_may_steal,
+		    u32 blockheight)
 {
+	struct txwatch_hash_iter i;
 	struct txwatch *txw;
 
+	for (txw = txwatch_hash_getfirst(topo->txwatches, txid, &i);
+	     txw;
+	     txw = txwatch_hash_getnext(topo->txwatches, txid, &i))
+		txw->height = blockheight;
+
 	txw = txwatch_hash_get(topo->txwatches, txid);
 
 	if (txw && !txw->tx)
 		txw->tx = tal_steal(txw, tx_may_steal);
 }
+
+/* Add the outputs of @tx we could see in a block filter. */
+static bool add_tx_scripts(const struct bitcoin_tx *tx, const u8 ***scripts)
+{
+	bool added = false;
+
+	for (size_t i = 0; i < tx->wtx->num_outputs; i++) {
+		const u8 *script = bitcoin_tx_output_get_script(*scripts, tx, i);
+
+		/* BIP158 leaves out empty and OP_RETURN outputs. */
+		if (tal_bytelen(script) == 0 || script[0] == OP_RETURN)
+			continue;
+		tal_arr_expand(scripts, script);
+		added = true;
+	}
+	return added;
+}
+
+static const u8 *txowatch_script(struct txowatch *w)
+{
+	const struct txwatch *txw;
+	const struct bitcoin_tx *tx;
+
+	if (w->script)
+		return w->script;
+
+	txw = txwatch_hash_get(w->topo->txwatches, &w->out.txid);
+	if (txw && txw->tx)
+		tx = txw->tx;
+	else
+		tx = wallet_transaction_get(tmpctx, w->topo->ld->wallet,
+					    &w->out.txid);
+	if (!tx || w->out.n >= tx->wtx->num_outputs)
+		return NULL;
+
+	w->script = bitcoin_tx_output_get_script(w, tx, w->out.n);
+	return w->script;
+}
+
+bool watch_scripts(struct chain_topology *topo, const u8 ***scripts)
+{
+	struct txowatch_hash_iter oi;
+	struct txowatch *ow;
+	struct txwatch_hash_iter i;
+	struct txwatch *w;
+
+	/* Filters contain the scripts spent by inputs, too. */
+	for (ow = txowatch_hash_first(topo->txowatches, &oi);
+	     ow;
+	     ow = txowatch_hash_next(topo->txowatches, &oi)) {
+		const u8 *script = txowatch_script(ow);
+		if (!script)
+			return false;
+		tal_arr_expand(scripts, script);
+	}
+
+	for (w = txwatch_hash_first(topo->txwatches, &i);
+	     w;
+	     w = txwatch_hash_next(topo->txwatches, &i)) {
+		/* Already in the chain: only a reorg shows it to us again,
+		 * and that resets the depth. */
+		if (w->depth)
+			continue;
+		if (!w->tx)
+			w->tx = wallet_transaction_get(w, topo->ld->wallet,
+						       &w->txid);
+		if (!w->tx || !add_tx_scripts(w->tx, scripts))
+			return false;
+	}
+	return true;
+}
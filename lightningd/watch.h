@@ -75,9 +75,16 @@ bool watching_txid(const struct chain_topology *topo,
 		   const struct bitcoin_txid *txid);
 
 /* FIXME: Implement bitcoin_tx_dup() so we tx arg can be TAKEN */
+/* Tell txwatches for @txid that it was mined in block @blockheight. */
 void txwatch_inform(const struct chain_topology *topo,
 		    const struct bitcoin_txid *txid,
-		    const struct bitcoin_tx *tx_may_steal);
+		    const struct bitcoin_tx *tx_may_steal,
+		    u32 blockheight);
 
 void watch_topology_changed(struct chain_topology *topo);
+
+/* Append the scripts of every watched txo and (unconfirmed) tx to @scripts,
+ * for matching against compact block filters.  Returns false if we don't
+ * know some of them, so every block has to be looked at in full. */
+bool watch_scripts(struct chain_topology *topo, const u8 ***scripts);
 #endif /* LIGHTNING_LIGHTNINGD_WATCH_H */
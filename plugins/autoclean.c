@@ -227,9 +227,8 @@ static struct command_result *listinvoices_done(struct command *cmd,
 			cinfo->num_uncleaned++;
 	}
 
-	if (cinfo->cleanup_reqs_remaining)
-		return command_still_pending(cmd);
-	return clean_finished(cinfo);
+	/* Our own request is done (deletes may still be pending). */
+	return clean_finished_one(cinfo);
 }
 
 static struct command_result *listsendpays_done(struct command *cmd,
@@ -289,9 +288,8 @@ static struct command_result *listsendpays_done(struct command *cmd,
 		}
 	}
 
- 	if (cinfo->cleanup_reqs_remaining)
-		return command_still_pending(cmd);
-	return clean_finished(cinfo);
+	/* Our own request is done (deletes may still be pending). */
+	return clean_finished_one(cinfo);
 }
 
 static struct command_result *listforwards_done(struct command *cmd,
@@ -368,9 +366,116 @@ static struct command_result *listforwards_done(struct command *cmd,
 		}
 	}
 
- 	if (cinfo->cleanup_reqs_remaining)
+	/* Our own request is done (deletes may still be pending). */
+	return clean_finished_one(cinfo);
+}
+
+/* For the timer, we don't need to list everything: lightningd can
+ * delete old ones in bulk.  We do it in chunks, so we don't hold up
+ * lightningd (one chunk is one db transaction) for too long. */
+#define PURGE_CHUNK 1000
+#define PURGE_CHUNK_DELAY_MSEC 100
+
+static const struct purge_target {
+	enum subsystem subsystem;
+	const char *method;
+	const char *status;
+} purge_targets[] = {
+	{ SUCCEEDEDFORWARDS, "delforwards", "settled" },
+	{ FAILEDFORWARDS, "delforwards", "failed" },
+	{ FAILEDFORWARDS, "delforwards", "local_failed" },
+	{ SUCCEEDEDPAYS, "delpays", "complete" },
+	{ FAILEDPAYS, "delpays", "failed" },
+};
+
+struct purge {
+	struct clean_info *cinfo;
+	size_t target;
+	u64 now;
+};
+
+static struct command_result *purge_send(struct purge *purge);
+
+static void purge_chunk_timer(struct purge *purge)
+{
+	purge_send(purge);
+	timer_complete(plugin);
+}
+
+static struct command_result *purge_done(struct command *cmd,
+					 const char *buf,
+					 const jsmntok_t *result,
+					 struct purge *purge)
+{
+	const struct purge_target *t = &purge_targets[purge->target];
+	u64 deleted;
+
+	if (!json_to_u64(buf, json_get_member(buf, result, "deleted"),
+			 &deleted))
+		plugin_err(plugin, "Bad %s response '%.*s'", t->method,
+			   json_tok_full_len(result),
+			   json_tok_full(buf, result));
+
+	purge->cinfo->num_cleaned[t->subsystem] += deleted;
+
+	/* Probably more where those came from: give others a turn first. */
+	if (deleted >= PURGE_CHUNK) {
+		plugin_timer(plugin, time_from_msec(PURGE_CHUNK_DELAY_MSEC),
+			     purge_chunk_timer, purge);
 		return command_still_pending(cmd);
-	return clean_finished(cinfo);
+	}
+
+	purge->target++;
+	return purge_send(purge);
+}
+
+static struct command_result *purge_failed(struct command *cmd,
+					   const char *buf,
+					   const jsmntok_t *result,
+					   struct purge *purge)
+{
+	return cmd_failed(cmd, buf, result,
+			  purge_targets[purge->target].method);
+}
+
+static struct command_result *purge_send(struct purge *purge)
+{
+	struct out_req *req;
+	const struct purge_target *t;
+	u64 age;
+
+	/* Skip over ones we don't care about. */
+	while (purge->target < ARRAY_SIZE(purge_targets)
+	       && purge->cinfo->subsystem_age[purge_targets[purge->target].subsystem] == 0)
+		purge->target++;
+
+	if (purge->target == ARRAY_SIZE(purge_targets)) {
+		struct clean_info *cinfo = purge->cinfo;
+		tal_free(purge);
+		return clean_finished_one(cinfo);
+	}
+
+	t = &purge_targets[purge->target];
+	age = purge->cinfo->subsystem_age[t->subsystem];
+	req = jsonrpc_request_start(plugin, NULL, t->method,
+				    purge_done, purge_failed, purge);
+	json_add_string(req->js, "status", t->status);
+	/* Same as the listing: anything at least age seconds old. */
+	json_add_u64(req->js, "before",
+		     age < purge->now ? purge->now - age + 1 : 0);
+	json_add_u32(req->js, "limit", PURGE_CHUNK);
+	return send_outreq(plugin, req);
+}
+
+static void purge_start(struct clean_info *cinfo)
+{
+	struct purge *purge = tal(plugin, struct purge);
+
+	purge->cinfo = cinfo;
+	purge->target = 0;
+	purge->now = time_now().ts.tv_sec;
+	cinfo->cleanup_reqs_remaining++;
+	purge_send(purge);
 }
 
 static struct command_result *listsendpays_failed(struct command *cmd,
@@ -400,13 +505,27 @@ static struct command_result *listforwards_failed(struct command *cmd,
 static struct command_result *do_clean(struct clean_info *cinfo)
 {
 	struct out_req *req = NULL;
+	bool pending = false;
 
 	cinfo->cleanup_reqs_remaining = 0;
 	cinfo->num_uncleaned = 0;
 	memset(cinfo->num_cleaned, 0, sizeof(cinfo->num_cleaned));
 
-	if (cinfo->subsystem_age[SUCCEEDEDPAYS] != 0
-	    || cinfo->subsystem_age[FAILEDPAYS] != 0) {
+	/* autoclean-once reports what it left behind, so it has to look
+	 * at everything; the timer can simply delete in bulk. */
+	if (!cinfo->cmd
+	    && (cinfo->subsystem_age[SUCCEEDEDFORWARDS] != 0
+		|| cinfo->subsystem_age[FAILEDFORWARDS] != 0
+		|| cinfo->subsystem_age[SUCCEEDEDPAYS] != 0
+		|| cinfo->subsystem_age[FAILEDPAYS] != 0)) {
+		purge_start(cinfo);
+		pending = true;
+	}
+
+	if (cinfo->cmd
+	    && (cinfo->subsystem_age[SUCCEEDEDPAYS] != 0
+		|| cinfo->subsystem_age[FAILEDPAYS] != 0)) {
+		cinfo->cleanup_reqs_remaining++;
 		req = jsonrpc_request_start(plugin, NULL, "listsendpays",
 					    listsendpays_done, listsendpays_failed,
 					    cinfo);
@@ -415,21 +534,24 @@ static struct command_result *do_clean(struct clean_info *cinfo)
 
 	if (cinfo->subsystem_age[EXPIREDINVOICES] != 0
 	    || cinfo->subsystem_age[PAIDINVOICES] != 0) {
+		cinfo->cleanup_reqs_remaining++;
 		req = jsonrpc_request_start(plugin, NULL, "listinvoices",
 					    listinvoices_done, listinvoices_failed,
 					    cinfo);
 		send_outreq(plugin, req);
 	}
 
-	if (cinfo->subsystem_age[SUCCEEDEDFORWARDS] != 0
-	    || cinfo->subsystem_age[FAILEDFORWARDS] != 0) {
+	if (cinfo->cmd
+	    && (cinfo->subsystem_age[SUCCEEDEDFORWARDS] != 0
+		|| cinfo->subsystem_age[FAILEDFORWARDS] != 0)) {
+		cinfo->cleanup_reqs_remaining++;
 		req = jsonrpc_request_start(plugin, NULL, "listforwards",
 					    listforwards_done, listforwards_failed,
 					    cinfo);
 		send_outreq(plugin, req);
 	}
 
-	if (req)
+	if (req || pending)
 		return command_still_pending(NULL);
 	else
 		return clean_finished(cinfo);
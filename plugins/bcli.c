@@ -1,17 +1,25 @@
 #include "config.h"
 #include <bitcoin/base58.h>
 #include <ccan/array_size/array_size.h>
+#include <ccan/base64/base64.h>
 #include <ccan/cast/cast.h>
 #include <ccan/io/io.h>
+#include <ccan/json_escape/json_escape.h>
+#include <ccan/mem/mem.h>
 #include <ccan/pipecmd/pipecmd.h>
 #include <ccan/read_write_all/read_write_all.h>
+#include <ccan/str/hex/hex.h>
 #include <ccan/tal/grab_file/grab_file.h>
 #include <ccan/tal/str/str.h>
 #include <common/json_param.h>
 #include <common/json_stream.h>
 #include <common/memleak.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
 #include <plugins/libplugin.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 /* Bitcoind's web server has a default of 4 threads, with queue depth 16.
  * It will *fail* rather than queue beyond that, so we must not stress it!
@@ -70,6 +78,13 @@ struct bitcoind {
 	/* Whether we fake fees (regtest) */
 	bool fake_fees;
 
+	/* Talk JSON-RPC to bitcoind directly, instead of bitcoin-cli? */
+	bool rpc_http;
+	/* One keep-alive connection for each priority level. */
+	struct rpc_conn *rpc_conns[BITCOIND_NUM_PRIO];
+	/* Where they connect to (resolved once, at startup). */
+	struct addrinfo *rpc_addrs;
+
 #if DEVELOPER
 	/* Override in case we're developer mode for testing*/
 	bool no_fake_fees;
@@ -84,6 +99,9 @@ struct bitcoin_cli {
 	int *exitstatus;
 	pid_t pid;
 	const char **args;
+	/* Method and its parameters, for the HTTP JSON-RPC mode */
+	const char *method;
+	const char **params;
 	struct timeabs start;
 	enum bitcoind_prio prio;
 	char *output;
@@ -166,6 +184,7 @@ static struct io_plan *output_init(struct io_conn *conn, struct bitcoin_cli *bcl
 }
 
 static void next_bcli(enum bitcoind_prio prio);
+static void next_rpc_batch(enum bitcoind_prio prio);
 
 /* For printing: simple string of args (no secrets!) */
 static char *args_string(const tal_t *ctx, const char **args)
@@ -238,10 +257,37 @@ static void bcli_failure(struct bitcoin_cli *bcli,
 	plugin_timer(bcli->cmd->plugin, time_from_sec(1), retry_bcli, bcli);
 }
 
+/* We have bitcoin-cli's (or equivalent) exit status and output. */
+static void bcli_complete(struct bitcoin_cli *bcli, int exitstatus)
+{
+	struct command_result *res;
+	enum bitcoind_prio prio = bcli->prio;
+
+	/* Implicit nonzero_exit_ok == false */
+	if (!bcli->exitstatus) {
+		if (exitstatus != 0) {
+			bcli_failure(bcli, exitstatus);
+			bitcoind->num_requests[prio]--;
+			return;
+		}
+	} else
+		*bcli->exitstatus = exitstatus;
+
+	if (exitstatus == 0)
+		bitcoind->error_count = 0;
+
+	bitcoind->num_requests[prio]--;
+
+	res = bcli->process(bcli);
+	if (!res)
+		bcli_failure(bcli, exitstatus);
+	else
+		tal_free(bcli);
+}
+
 static void bcli_finished(struct io_conn *conn UNUSED, struct bitcoin_cli *bcli)
 {
 	int ret, status;
-	struct command_result *res;
 	enum bitcoind_prio prio = bcli->prio;
 	u64 msec = time_to_msec(time_between(time_now(), bcli->start));
 
@@ -264,29 +310,389 @@ static void bcli_finished(struct io_conn *conn UNUSED, struct bitcoin_cli *bcli)
 		           bcli_args(bcli),
 		           WTERMSIG(status));
 
-	/* Implicit nonzero_exit_ok == false */
-	if (!bcli->exitstatus) {
-		if (WEXITSTATUS(status) != 0) {
-			bcli_failure(bcli, WEXITSTATUS(status));
-			bitcoind->num_requests[prio]--;
-			goto done;
-		}
-	} else
-		*bcli->exitstatus = WEXITSTATUS(status);
+	bcli_complete(bcli, WEXITSTATUS(status));
+	next_bcli(prio);
+}
 
-	if (WEXITSTATUS(status) == 0)
-		bitcoind->error_count = 0;
+/* When talking to bitcoind directly (--bitcoin-rpc-http), we keep one
+ * HTTP/1.1 keep-alive connection per priority level, and send whatever is
+ * pending on it as a single JSON-RPC batch. */
+struct rpc_conn {
+	enum bitcoind_prio prio;
+	/* NULL if not connected. */
+	struct io_conn *conn;
+	/* Has conn finished connecting?  Which address does it use? */
+	bool connected;
+	const struct addrinfo *addr;
+	/* The batch currently being sent/answered (empty if idle). */
+	struct bitcoin_cli **inflight;
+	/* The HTTP request for it, and has it been sent yet? */
+	char *request;
+	bool request_pending;
+	/* The response, as it arrives. */
+	char *buf;
+	size_t len, new_read;
+};
 
-	bitcoind->num_requests[bcli->prio]--;
+/* Like bitcoin-cli, some parameters are JSON values, not strings
+ * (see bitcoin/src/rpc/client.cpp). */
+static const struct {
+	const char *method;
+	size_t paramnum;
+} rpc_nonstring_params[] = {
+	{ "getblockhash", 0 },
+	{ "getblock", 1 },
+	{ "getblockheader", 1 },
+	{ "gettxout", 1 },
+	{ "gettxout", 2 },
+	{ "estimatesmartfee", 0 },
+	{ "sendrawtransaction", 1 },
+};
 
-	res = bcli->process(bcli);
-	if (!res)
-		bcli_failure(bcli, WEXITSTATUS(status));
+static bool rpc_param_is_json(const char *method, size_t paramnum)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(rpc_nonstring_params); i++) {
+		if (streq(rpc_nonstring_params[i].method, method)
+		    && rpc_nonstring_params[i].paramnum == paramnum)
+			return true;
+	}
+	return false;
+}
+
+static char *rpc_batch_body(const tal_t *ctx, struct bitcoin_cli **batch)
+{
+	char *body = tal_strdup(ctx, "[");
+
+	for (size_t i = 0; i < tal_count(batch); i++) {
+		const struct bitcoin_cli *bcli = batch[i];
+
+		tal_append_fmt(&body,
+			       "%s{\"jsonrpc\":\"1.0\",\"id\":%zu,"
+			       "\"method\":\"%s\",\"params\":[",
+			       i ? "," : "", i, bcli->method);
+		for (size_t j = 0; j < tal_count(bcli->params); j++) {
+			const char *sep = j ? "," : "";
+			if (rpc_param_is_json(bcli->method, j))
+				tal_append_fmt(&body, "%s%s", sep,
+					       bcli->params[j]);
+			else
+				tal_append_fmt(&body, "%s\"%s\"", sep,
+					       json_escape(tmpctx,
+							   bcli->params[j])->s);
+		}
+		tal_append_fmt(&body, "]}");
+	}
+	tal_append_fmt(&body, "]");
+	return body;
+}
+
+static char *rpc_http_request(const tal_t *ctx, const char *body)
+{
+	char *auth = tal_fmt(tmpctx, "%s:%s",
+			     bitcoind->rpcuser, bitcoind->rpcpass);
+	char *auth64 = tal_arr(tmpctx, char,
+			       base64_encoded_length(strlen(auth)) + 1);
+
+	base64_encode(auth64, tal_count(auth64), auth, strlen(auth));
+	return tal_fmt(ctx,
+		       "POST / HTTP/1.1\r\n"
+		       "Host: %s\r\n"
+		       "Connection: keep-alive\r\n"
+		       "Authorization: Basic %s\r\n"
+		       "Content-Type: application/json\r\n"
+		       "Content-Length: %zu\r\n"
+		       "\r\n"
+		       "%s",
+		       bitcoind->rpcconnect ? bitcoind->rpcconnect : "127.0.0.1",
+		       auth64, strlen(body), body);
+}
+
+/* Resolve --bitcoin-rpcconnect/--bitcoin-rpcport.  This blocks, so we only
+ * do it once (at startup, where we've waited for bitcoind anyway). */
+static struct addrinfo *rpc_resolve(struct plugin *p)
+{
+	struct addrinfo hints, *ai;
+	const char *host;
+	char port[16];
+	int e;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if (bitcoind->rpcport)
+		snprintf(port, sizeof(port), "%s", bitcoind->rpcport);
 	else
-		tal_free(bcli);
+		snprintf(port, sizeof(port), "%d", chainparams->rpc_port);
+
+	host = bitcoind->rpcconnect ? bitcoind->rpcconnect : "127.0.0.1";
+	e = getaddrinfo(host, port, &hints, &ai);
+	if (e != 0)
+		plugin_err(p, "Could not resolve bitcoind address %s:%s: %s",
+			   host, port, gai_strerror(e));
+	return ai;
+}
 
-done:
-	next_bcli(prio);
+/* Give these back for retry, like a bitcoin-cli which couldn't connect
+ * (exit status 1). */
+static void rpc_fail_all(struct bitcoin_cli **batch)
+{
+	for (size_t i = 0; i < tal_count(batch); i++) {
+		bcli_failure(batch[i], 1);
+		bitcoind->num_requests[batch[i]->prio]--;
+	}
+}
+
+/* Turn a JSON-RPC reply into what bitcoin-cli would have given us. */
+static void rpc_complete(struct bitcoin_cli *bcli,
+			 const char *buf, const jsmntok_t *reply)
+{
+	const jsmntok_t *result, *error;
+	int exitstatus = 0;
+
+	result = json_get_member(buf, reply, "result");
+	error = json_get_member(buf, reply, "error");
+
+	if (error && !json_tok_is_null(buf, error)) {
+		const jsmntok_t *code, *message;
+		int c = 1;
+
+		code = json_get_member(buf, error, "code");
+		message = json_get_member(buf, error, "message");
+		if (code)
+			json_to_int(buf, code, &c);
+		exitstatus = abs(c);
+		bcli->output = tal_fmt(bcli,
+				       "error code: %d\nerror message:\n%.*s\n",
+				       c,
+				       message ? message->end - message->start : 0,
+				       message ? buf + message->start : "");
+	} else if (!result || json_tok_is_null(buf, result)) {
+		bcli->output = tal_strdup(bcli, "");
+	} else if (result->type == JSMN_STRING) {
+		bcli->output = tal_fmt(bcli, "%.*s\n",
+				       result->end - result->start,
+				       buf + result->start);
+	} else {
+		bcli->output = tal_fmt(bcli, "%.*s\n",
+				       json_tok_full_len(result),
+				       json_tok_full(buf, result));
+	}
+	bcli->output_bytes = strlen(bcli->output);
+
+	bcli_complete(bcli, exitstatus);
+}
+
+static bool rpc_process_response(struct rpc_conn *rc,
+				 const char *body, size_t bodylen)
+{
+	struct bitcoin_cli **batch = rc->inflight, **unanswered;
+	const jsmntok_t *toks, *t;
+	size_t i;
+
+	toks = json_parse_simple(tmpctx, body, bodylen);
+	if (!toks || toks->type != JSMN_ARRAY) {
+		plugin_log(batch[0]->cmd->plugin, LOG_UNUSUAL,
+			   "bitcoind gave bad JSON-RPC batch response '%.*s'",
+			   (int)bodylen, body);
+		return false;
+	}
+
+	/* rc->inflight stays set while we call process(), so any new
+	 * requests wait for the next batch. */
+	json_for_each_arr(i, t, toks) {
+		const jsmntok_t *idtok = json_get_member(body, t, "id");
+		u64 id;
+
+		if (!idtok || !json_to_u64(body, idtok, &id)
+		    || id >= tal_count(batch) || !batch[id])
+			continue;
+		rpc_complete(batch[id], body, t);
+		batch[id] = NULL;
+	}
+
+	/* Anything it didn't answer gets retried */
+	unanswered = tal_arr(tmpctx, struct bitcoin_cli *, 0);
+	for (i = 0; i < tal_count(batch); i++) {
+		if (batch[i])
+			tal_arr_expand(&unanswered, batch[i]);
+	}
+	tal_resize(&rc->inflight, 0);
+	rpc_fail_all(unanswered);
+	return true;
+}
+
+static struct io_plan *rpc_idle(struct io_conn *conn, struct rpc_conn *rc);
+
+static struct io_plan *rpc_read_response(struct io_conn *conn,
+					 struct rpc_conn *rc)
+{
+	const char *hdrend, *clen, *connclose, *body;
+	size_t bodylen;
+	int status;
+
+	rc->len += rc->new_read;
+	/* Keep a nul terminator, for strcasestr */
+	rc->buf[rc->len] = '\0';
+
+	hdrend = memmem(rc->buf, rc->len, "\r\n\r\n", 4);
+	if (!hdrend)
+		goto more;
+
+	clen = strcasestr(rc->buf, "\r\nContent-Length:");
+	if (!clen || clen > hdrend) {
+		plugin_log(rc->inflight[0]->cmd->plugin, LOG_UNUSUAL,
+			   "bitcoind gave no Content-Length");
+		return io_close(conn);
+	}
+	bodylen = strtoul(clen + strlen("\r\nContent-Length:"), NULL, 10);
+	body = hdrend + 4;
+	if (body + bodylen > rc->buf + rc->len)
+		goto more;
+
+	if (sscanf(rc->buf, "HTTP/1.%*c %d", &status) != 1)
+		status = -1;
+	if (status == 401)
+		plugin_err(rc->inflight[0]->cmd->plugin,
+			   "bitcoind refused our --bitcoin-rpcuser"
+			   " and --bitcoin-rpcpassword");
+
+	connclose = strcasestr(rc->buf, "\r\nConnection: close");
+	if (!rpc_process_response(rc, body, bodylen))
+		return io_close(conn);
+
+	/* We never pipeline, so there's nothing after this. */
+	rc->len = 0;
+	if (connclose && connclose < hdrend)
+		return io_close(conn);
+
+	next_rpc_batch(rc->prio);
+	return rpc_idle(conn, rc);
+
+more:
+	if (tal_count(rc->buf) - rc->len < 2)
+		tal_resize(&rc->buf, tal_count(rc->buf) * 2);
+	return io_read_partial(conn, rc->buf + rc->len,
+			       tal_count(rc->buf) - rc->len - 1,
+			       &rc->new_read, rpc_read_response, rc);
+}
+
+static struct io_plan *rpc_send_request(struct io_conn *conn,
+					struct rpc_conn *rc)
+{
+	rc->request_pending = false;
+	rc->len = rc->new_read = 0;
+	return io_write(conn, rc->request, strlen(rc->request),
+			rpc_read_response, rc);
+}
+
+/* Wait for next_rpc_batch to give us something to send. */
+static struct io_plan *rpc_idle(struct io_conn *conn, struct rpc_conn *rc)
+{
+	if (rc->request_pending)
+		return rpc_send_request(conn, rc);
+	return io_wait(conn, rc, rpc_idle, rc);
+}
+
+static struct io_plan *rpc_connected(struct io_conn *conn,
+				    struct rpc_conn *rc)
+{
+	rc->connected = true;
+	return rpc_idle(conn, rc);
+}
+
+static struct io_plan *rpc_conn_init(struct io_conn *conn,
+				     struct rpc_conn *rc)
+{
+	return io_connect(conn, rc->addr, rpc_connected, rc);
+}
+
+static void rpc_conn_closed(struct io_conn *conn, struct rpc_conn *rc)
+{
+	struct bitcoin_cli **batch = rc->inflight;
+
+	if (!rc->connected) {
+		if (tal_count(batch))
+			plugin_log(batch[0]->cmd->plugin, LOG_UNUSUAL,
+				   "Could not connect to bitcoind: %s",
+				   strerror(errno));
+		/* Try its next address (if any) next time. */
+		rc->addr = rc->addr->ai_next;
+		if (!rc->addr)
+			rc->addr = bitcoind->rpc_addrs;
+	}
+
+	rc->conn = NULL;
+	rc->request_pending = false;
+	rc->inflight = tal_arr(rc, struct bitcoin_cli *, 0);
+	rpc_fail_all(batch);
+	tal_free(batch);
+
+	/* If there's anything else, reconnect. */
+	next_rpc_batch(rc->prio);
+}
+
+static void next_rpc_batch(enum bitcoind_prio prio)
+{
+	struct rpc_conn *rc = bitcoind->rpc_conns[prio];
+	struct bitcoin_cli *bcli, **batch;
+	int fd;
+
+	/* Still waiting for answers to the last batch? */
+	if (tal_count(rc->inflight) || list_empty(&bitcoind->pending[prio]))
+		return;
+
+	/* bitcoind's work queue is 16 deep by default, so that's our limit */
+	while (tal_count(rc->inflight) < BITCOIND_MAX_PARALLEL * 4
+	       && (bcli = list_pop(&bitcoind->pending[prio],
+				   struct bitcoin_cli, list)) != NULL) {
+		bcli->start = time_now();
+		bitcoind->num_requests[prio]++;
+		list_add_tail(&bitcoind->current, &bcli->list);
+		tal_add_destructor(bcli, destroy_bcli);
+		tal_arr_expand(&rc->inflight, bcli);
+	}
+
+	/* We connect asynchronously: bitcoind may well be remote.  The
+	 * request goes out once rpc_connected() calls rpc_idle(). */
+	if (!rc->conn) {
+		fd = socket(rc->addr->ai_family, rc->addr->ai_socktype,
+			    rc->addr->ai_protocol);
+		if (fd < 0) {
+			plugin_log(rc->inflight[0]->cmd->plugin, LOG_UNUSUAL,
+				   "Could not connect to bitcoind: %s",
+				   strerror(errno));
+			batch = rc->inflight;
+			rc->inflight = tal_arr(rc, struct bitcoin_cli *, 0);
+			rpc_fail_all(batch);
+			tal_free(batch);
+			return;
+		}
+		rc->connected = false;
+		/* We don't keep a pointer to this, but it's not a leak */
+		rc->conn = notleak(io_new_conn(rc, fd, rpc_conn_init, rc));
+		io_set_finish(rc->conn, rpc_conn_closed, rc);
+	}
+
+	tal_free(rc->request);
+	rc->request = rpc_http_request(rc, rpc_batch_body(tmpctx, rc->inflight));
+	rc->request_pending = true;
+	io_wake(rc);
+}
+
+static struct rpc_conn *new_rpc_conn(const tal_t *ctx, enum bitcoind_prio prio)
+{
+	struct rpc_conn *rc = tal(ctx, struct rpc_conn);
+
+	rc->prio = prio;
+	rc->conn = NULL;
+	rc->connected = false;
+	rc->addr = bitcoind->rpc_addrs;
+	rc->inflight = tal_arr(rc, struct bitcoin_cli *, 0);
+	rc->request = NULL;
+	rc->request_pending = false;
+	rc->buf = tal_arr(rc, char, 1000);
+	rc->len = rc->new_read = 0;
+	return rc;
 }
 
 static void next_bcli(enum bitcoind_prio prio)
@@ -295,6 +701,11 @@ static void next_bcli(enum bitcoind_prio prio)
 	struct io_conn *conn;
 	int in;
 
+	if (bitcoind->rpc_http) {
+		next_rpc_batch(prio);
+		return;
+	}
+
 	if (bitcoind->num_requests[prio] >= BITCOIND_MAX_PARALLEL)
 		return;
 
@@ -337,6 +748,8 @@ start_bitcoin_cliv(const tal_t *ctx,
 		   va_list ap)
 {
 	struct bitcoin_cli *bcli = tal(bitcoind, struct bitcoin_cli);
+	const char *arg;
+	va_list ap2;
 
 	bcli->process = process;
 	bcli->cmd = cmd;
@@ -347,6 +760,13 @@ start_bitcoin_cliv(const tal_t *ctx,
 	else
 		bcli->exitstatus = NULL;
 
+	bcli->method = method;
+	bcli->params = tal_arr(bcli, const char *, 0);
+	va_copy(ap2, ap);
+	while ((arg = va_arg(ap2, const char *)) != NULL)
+		tal_arr_expand(&bcli->params, arg);
+	va_end(ap2);
+
 	bcli->args = gather_argsv(bcli, method, ap);
 	bcli->stash = stash;
 
@@ -392,41 +812,110 @@ static struct command_result *command_err_bcli_badjson(struct bitcoin_cli *bcli,
 	return command_done_err(bcli->cmd, BCLI_ERROR, err, NULL);
 }
 
-static struct command_result *process_getutxout(struct bitcoin_cli *bcli)
+/* Sets *txout to NULL if it's spent, returns error message on failure. */
+static const char *parse_getutxout(struct bitcoin_cli *bcli,
+				   struct bitcoin_tx_output **txout)
 {
 	const jsmntok_t *tokens;
-	struct json_stream *response;
-	struct bitcoin_tx_output output;
+	struct bitcoin_tx_output *output;
 	const char *err;
 
 	/* As of at least v0.15.1.0, bitcoind returns "success" but an empty
 	   string on a spent txout. */
 	if (*bcli->exitstatus != 0 || bcli->output_bytes == 0) {
-		response = jsonrpc_stream_success(bcli->cmd);
-		json_add_null(response, "amount");
-		json_add_null(response, "script");
-
-		return command_finished(bcli->cmd, response);
+		*txout = NULL;
+		return NULL;
 	}
 
 	tokens = json_parse_simple(bcli->output, bcli->output,
 				   bcli->output_bytes);
-	if (!tokens) {
-		return command_err_bcli_badjson(bcli, "cannot parse");
-	}
+	if (!tokens)
+		return "cannot parse";
 
+	output = tal(bcli, struct bitcoin_tx_output);
 	err = json_scan(tmpctx, bcli->output, tokens,
 		       "{value:%,scriptPubKey:{hex:%}}",
 		       JSON_SCAN(json_to_bitcoin_amount,
-				 &output.amount.satoshis), /* Raw: bitcoind */
-		       JSON_SCAN_TAL(bcli, json_tok_bin_from_hex,
-				     &output.script));
+				 &output->amount.satoshis), /* Raw: bitcoind */
+		       JSON_SCAN_TAL(output, json_tok_bin_from_hex,
+				     &output->script));
+	if (err)
+		return err;
+
+	*txout = output;
+	return NULL;
+}
+
+static void json_add_utxout(struct json_stream *response,
+			    const struct bitcoin_tx_output *output)
+{
+	if (!output) {
+		json_add_null(response, "amount");
+		json_add_null(response, "script");
+		return;
+	}
+	json_add_sats(response, "amount", output->amount);
+	json_add_string(response, "script", tal_hex(response, output->script));
+}
+
+static struct command_result *process_getutxout(struct bitcoin_cli *bcli)
+{
+	struct json_stream *response;
+	struct bitcoin_tx_output *output;
+	const char *err;
+
+	err = parse_getutxout(bcli, &output);
 	if (err)
 		return command_err_bcli_badjson(bcli, err);
 
 	response = jsonrpc_stream_success(bcli->cmd);
-	json_add_sats(response, "amount", output.amount);
-	json_add_string(response, "script", tal_hex(response, output.script));
+	json_add_utxout(response, output);
+
+	return command_finished(bcli->cmd, response);
+}
+
+struct getutxouts_stash {
+	size_t num_remaining;
+	/* First failure, if any: we only report it once all are done. */
+	const char *err;
+	/* NULL if spent. */
+	struct bitcoin_tx_output **outputs;
+};
+
+struct getutxouts_one {
+	struct getutxouts_stash *stash;
+	size_t idx;
+};
+
+static struct command_result *process_getutxouts_one(struct bitcoin_cli *bcli)
+{
+	struct getutxouts_one *one = bcli->stash;
+	struct getutxouts_stash *stash = one->stash;
+	struct json_stream *response;
+	const char *err;
+
+	err = parse_getutxout(bcli, &stash->outputs[one->idx]);
+	if (err && !stash->err)
+		stash->err = tal_fmt(stash, "%s: bad JSON: %s (%.*s)",
+				     bcli_args(bcli), err,
+				     (int)bcli->output_bytes, bcli->output);
+	tal_steal(stash->outputs, stash->outputs[one->idx]);
+
+	/* The others still refer to cmd, so we can't finish it yet. */
+	if (--stash->num_remaining != 0)
+		return command_still_pending(bcli->cmd);
+
+	if (stash->err)
+		return command_done_err(bcli->cmd, BCLI_ERROR, stash->err, NULL);
+
+	response = jsonrpc_stream_success(bcli->cmd);
+	json_array_start(response, "utxouts");
+	for (size_t i = 0; i < tal_count(stash->outputs); i++) {
+		json_object_start(response, NULL);
+		json_add_utxout(response, stash->outputs[i]);
+		json_object_end(response);
+	}
+	json_array_end(response);
 
 	return command_finished(bcli->cmd, response);
 }
@@ -472,11 +961,21 @@ enum feerate_levels {
 #define FEERATE_LEVEL_MAX (FEERATE_SLOW)
 
 struct estimatefees_stash {
-	u32 cursor;
+	/* How many estimatesmartfee calls haven't returned yet. */
+	size_t num_remaining;
+	/* First failure, if any: we only report it once all are done. */
+	const char *err;
+	/* Did any of them fail to give an estimate? */
+	bool no_estimate;
 	/* FIXME: We use u64 but lightningd will store them as u32. */
 	u64 perkb[FEERATE_LEVEL_MAX+1];
 };
 
+struct estimatefees_one {
+	struct estimatefees_stash *stash;
+	enum feerate_levels level;
+};
+
 static struct command_result *
 estimatefees_null_response(struct bitcoin_cli *bcli)
 {
@@ -494,22 +993,24 @@ estimatefees_null_response(struct bitcoin_cli *bcli)
 	return command_finished(bcli->cmd, response);
 }
 
-static struct command_result *
-estimatefees_parse_feerate(struct bitcoin_cli *bcli, u64 *feerate)
+/* Returns error message on failure; sets *estimated to false if bitcoind
+ * couldn't give an estimate. */
+static const char *estimatefees_parse_feerate(struct bitcoin_cli *bcli,
+					      u64 *feerate, bool *estimated)
 {
 	const jsmntok_t *tokens;
 
+	*estimated = true;
 	tokens = json_parse_simple(bcli->output,
 				   bcli->output, bcli->output_bytes);
-	if (!tokens) {
-		return command_err_bcli_badjson(bcli, "cannot parse");
-	}
+	if (!tokens)
+		return "cannot parse";
 
 	if (json_scan(tmpctx, bcli->output, tokens, "{feerate:%}",
 		      JSON_SCAN(json_to_bitcoin_amount, feerate)) != NULL) {
 		/* Paranoia: if it had a feerate, but was malformed: */
 		if (json_get_member(bcli->output, tokens, "feerate"))
-			return command_err_bcli_badjson(bcli, "cannot scan");
+			return "cannot scan";
 		/* Regtest fee estimation is generally awful: Fake it at min. */
 		if (bitcoind->fake_fees) {
 			*feerate = 1000;
@@ -517,7 +1018,7 @@ estimatefees_parse_feerate(struct bitcoin_cli *bcli, u64 *feerate)
 		}
 		/* We return null if estimation failed, and bitcoin-cli will
 		 * exit with 0 but no feerate field on failure. */
-		return estimatefees_null_response(bcli);
+		*estimated = false;
 	}
 
 	return NULL;
@@ -554,8 +1055,47 @@ struct getrawblock_stash {
 	const char *block_hash;
 	u32 block_height;
 	const char *block_hex;
+	/* For writerawblockbyheight: where to put the raw block. */
+	const char *path;
 };
 
+/* Write the raw block to stash->path, rather than sending hex over JSON */
+static struct command_result *write_rawblock(struct bitcoin_cli *bcli)
+{
+	struct json_stream *response;
+	struct getrawblock_stash *stash = bcli->stash;
+	size_t hexlen = strlen(stash->block_hex);
+	size_t len = hex_data_size(hexlen);
+	u8 *raw = tal_arr(tmpctx, u8, len);
+	int fd;
+
+	if (!hex_decode(stash->block_hex, hexlen, raw, len))
+		return command_err_bcli_badjson(bcli, "bad block hex");
+
+	fd = open(stash->path, O_WRONLY|O_CREAT|O_TRUNC, 0600);
+	if (fd < 0)
+		return command_done_err(bcli->cmd, BCLI_ERROR,
+					tal_fmt(tmpctx, "Opening %s: %s",
+						stash->path, strerror(errno)),
+					NULL);
+	if (!write_all(fd, raw, len)) {
+		int e = errno;
+		close(fd);
+		unlink(stash->path);
+		return command_done_err(bcli->cmd, BCLI_ERROR,
+					tal_fmt(tmpctx, "Writing %s: %s",
+						stash->path, strerror(e)),
+					NULL);
+	}
+	close(fd);
+
+	response = jsonrpc_stream_success(bcli->cmd);
+	json_add_string(response, "blockhash", stash->block_hash);
+	json_add_u64(response, "size", len);
+
+	return command_finished(bcli->cmd, response);
+}
+
 static struct command_result *process_getrawblock(struct bitcoin_cli *bcli)
 {
 	struct json_stream *response;
@@ -564,6 +1104,9 @@ static struct command_result *process_getrawblock(struct bitcoin_cli *bcli)
 	strip_trailing_whitespace(bcli->output, bcli->output_bytes);
 	stash->block_hex = tal_steal(stash, bcli->output);
 
+	if (stash->path)
+		return write_rawblock(bcli);
+
 	response = jsonrpc_stream_success(bcli->cmd);
 	json_add_string(response, "blockhash", stash->block_hash);
 	json_add_string(response, "block", stash->block_hex);
@@ -578,7 +1121,8 @@ getrawblockbyheight_notfound(struct bitcoin_cli *bcli)
 
 	response = jsonrpc_stream_success(bcli->cmd);
 	json_add_null(response, "blockhash");
-	json_add_null(response, "block");
+	if (!((struct getrawblock_stash *)bcli->stash)->path)
+		json_add_null(response, "block");
 
 	return command_finished(bcli->cmd, response);
 }
@@ -616,11 +1160,28 @@ static struct command_result *process_getblockhash(struct bitcoin_cli *bcli)
  * Calls `getblockhash` then `getblock` to retrieve it from bitcoin_cli.
  * Will return early with null fields if block isn't known (yet).
  */
+static struct command_result *start_getrawblock(struct command *cmd,
+						u32 height, const char *path)
+{
+	struct getrawblock_stash *stash;
+
+	stash = tal(cmd, struct getrawblock_stash);
+	stash->block_height = height;
+	stash->path = tal_steal(stash, path);
+
+	start_bitcoin_cli(NULL, cmd, process_getblockhash, true,
+			  BITCOIND_LOW_PRIO, stash,
+			  "getblockhash",
+			  take(tal_fmt(NULL, "%u", stash->block_height)),
+			  NULL);
+
+	return command_still_pending(cmd);
+}
+
 static struct command_result *getrawblockbyheight(struct command *cmd,
                                                   const char *buf,
                                                   const jsmntok_t *toks)
 {
-	struct getrawblock_stash *stash;
 	u32 *height;
 
 	/* bitcoin-cli wants a string. */
@@ -629,11 +1190,141 @@ static struct command_result *getrawblockbyheight(struct command *cmd,
 	           NULL))
 		return command_param_failed();
 
-	stash = tal(cmd, struct getrawblock_stash);
+	return start_getrawblock(cmd, *height, NULL);
+}
+
+/* Same as getrawblockbyheight, but writes the raw block into the file
+ * lightningd asks for, so it doesn't travel as hex inside JSON.
+ */
+static struct command_result *writerawblockbyheight(struct command *cmd,
+						    const char *buf,
+						    const jsmntok_t *toks)
+{
+	u32 *height;
+	const char *path;
+
+	if (!param(cmd, buf, toks,
+	           p_req("height", param_number, &height),
+	           p_req("path", param_string, &path),
+	           NULL))
+		return command_param_failed();
+
+	return start_getrawblock(cmd, *height, path);
+}
+
+struct getblockfilter_stash {
+	u32 block_height;
+	const char *block_hash;
+	const char *filter_hex;
+};
+
+static struct command_result *process_getblockheader(struct bitcoin_cli *bcli)
+{
+	struct json_stream *response;
+	struct getblockfilter_stash *stash = bcli->stash;
+
+	strip_trailing_whitespace(bcli->output, bcli->output_bytes);
+	if (strlen(bcli->output) != 80 * 2)
+		return command_err_bcli_badjson(bcli, "bad header");
+
+	response = jsonrpc_stream_success(bcli->cmd);
+	json_add_string(response, "blockhash", stash->block_hash);
+	json_add_string(response, "header", bcli->output);
+	json_add_string(response, "filter", stash->filter_hex);
+
+	return command_finished(bcli->cmd, response);
+}
+
+static struct command_result *process_getblockfilter(struct bitcoin_cli *bcli)
+{
+	const jsmntok_t *tokens;
+	struct getblockfilter_stash *stash = bcli->stash;
+	const char *err;
+
+	/* Most likely bitcoind wasn't started with -blockfilterindex:
+	 * that's not worth retrying, the caller can fetch the block. */
+	if (*bcli->exitstatus != 0) {
+		strip_trailing_whitespace(bcli->output, bcli->output_bytes);
+		return command_done_err(bcli->cmd, BCLI_ERROR,
+					tal_fmt(tmpctx, "%s: %s",
+						bcli_args(bcli), bcli->output),
+					NULL);
+	}
+
+	tokens = json_parse_simple(bcli->output,
+				   bcli->output, bcli->output_bytes);
+	if (!tokens)
+		return command_err_bcli_badjson(bcli, "cannot parse");
+
+	err = json_scan(tmpctx, bcli->output, tokens, "{filter:%}",
+			JSON_SCAN_TAL(stash, json_strdup, &stash->filter_hex));
+	if (err)
+		return command_err_bcli_badjson(bcli, err);
+
+	start_bitcoin_cli(NULL, bcli->cmd, process_getblockheader, false,
+			  BITCOIND_HIGH_PRIO, stash,
+			  "getblockheader",
+			  stash->block_hash,
+			  /* Non-verbose: raw header. */
+			  "false",
+			  NULL);
+
+	return command_still_pending(bcli->cmd);
+}
+
+static struct command_result *
+process_getblockhash_for_filter(struct bitcoin_cli *bcli)
+{
+	struct json_stream *response;
+	struct getblockfilter_stash *stash = bcli->stash;
+
+	/* If it failed with error 8, give an empty response. */
+	if (bcli->exitstatus && *bcli->exitstatus != 0) {
+		/* Other error means we have to retry. */
+		if (*bcli->exitstatus != 8)
+			return NULL;
+		response = jsonrpc_stream_success(bcli->cmd);
+		json_add_null(response, "blockhash");
+		json_add_null(response, "header");
+		json_add_null(response, "filter");
+		return command_finished(bcli->cmd, response);
+	}
+
+	strip_trailing_whitespace(bcli->output, bcli->output_bytes);
+	stash->block_hash = tal_strdup(stash, bcli->output);
+	if (strlen(stash->block_hash) != 64)
+		return command_err_bcli_badjson(bcli, "bad blockhash");
+
+	start_bitcoin_cli(NULL, bcli->cmd, process_getblockfilter, true,
+			  BITCOIND_HIGH_PRIO, stash,
+			  "getblockfilter",
+			  stash->block_hash,
+			  "basic",
+			  NULL);
+
+	return command_still_pending(bcli->cmd);
+}
+
+/* Get the BIP158 basic filter and header of the block at a given height,
+ * so lightningd only has to fetch the full block if it's interesting.
+ * Needs bitcoind to run with -blockfilterindex.
+ */
+static struct command_result *getblockfilterbyheight(struct command *cmd,
+						     const char *buf,
+						     const jsmntok_t *toks)
+{
+	struct getblockfilter_stash *stash;
+	u32 *height;
+
+	if (!param(cmd, buf, toks,
+	           p_req("height", param_number, &height),
+	           NULL))
+		return command_param_failed();
+
+	stash = tal(cmd, struct getblockfilter_stash);
 	stash->block_height = *height;
-	tal_free(height);
 
-	start_bitcoin_cli(NULL, cmd, process_getblockhash, true,
+	start_bitcoin_cli(NULL, cmd, process_getblockhash_for_filter, true,
 			  BITCOIND_LOW_PRIO, stash,
 			  "getblockhash",
 			  take(tal_fmt(NULL, "%u", stash->block_height)),
@@ -660,9 +1351,6 @@ static struct command_result *getchaininfo(struct command *cmd,
 	return command_still_pending(cmd);
 }
 
-/* Mutual recursion. */
-static struct command_result *estimatefees_done(struct bitcoin_cli *bcli);
-
 struct estimatefee_params {
 	u32 blocks;
 	const char *style;
@@ -675,24 +1363,40 @@ static const struct estimatefee_params estimatefee_params[] = {
 	[FEERATE_SLOW] = { 100, "ECONOMICAL" },
 };
 
-static struct command_result *estimatefees_next(struct command *cmd,
-						struct estimatefees_stash *stash)
+static struct command_result *estimatefees_done(struct bitcoin_cli *bcli)
 {
+	struct estimatefees_one *one = bcli->stash;
+	struct estimatefees_stash *stash = one->stash;
 	struct json_stream *response;
+	bool estimated;
+	const char *err;
 
-	if (stash->cursor < ARRAY_SIZE(stash->perkb)) {
-		start_bitcoin_cli(NULL, cmd, estimatefees_done, true,
-				  BITCOIND_LOW_PRIO, stash,
-				  "estimatesmartfee",
-				  take(tal_fmt(NULL, "%u",
-					       estimatefee_params[stash->cursor].blocks)),
-				  estimatefee_params[stash->cursor].style,
-				  NULL);
-
-		return command_still_pending(cmd);
+	/* If we cannot estimate fees, we give nulls. */
+	if (*bcli->exitstatus != 0)
+		stash->no_estimate = true;
+	else {
+		err = estimatefees_parse_feerate(bcli, &stash->perkb[one->level],
+						 &estimated);
+		if (err && !stash->err)
+			stash->err = tal_fmt(stash, "%s: bad JSON: %s (%.*s)",
+					     bcli_args(bcli), err,
+					     (int)bcli->output_bytes,
+					     bcli->output);
+		else if (!estimated)
+			stash->no_estimate = true;
 	}
 
-	response = jsonrpc_stream_success(cmd);
+	/* The others still refer to cmd, so we can't finish it yet. */
+	if (--stash->num_remaining != 0)
+		return command_still_pending(bcli->cmd);
+
+	if (stash->err)
+		return command_done_err(bcli->cmd, BCLI_ERROR, stash->err, NULL);
+
+	if (stash->no_estimate)
+		return estimatefees_null_response(bcli);
+
+	response = jsonrpc_stream_success(bcli->cmd);
 	json_add_u64(response, "opening", stash->perkb[FEERATE_NORMAL]);
 	json_add_u64(response, "mutual_close", stash->perkb[FEERATE_SLOW]);
 	json_add_u64(response, "unilateral_close",
@@ -713,12 +1417,15 @@ static struct command_result *estimatefees_next(struct command *cmd,
 	json_add_u64(response, "max_acceptable",
 		     stash->perkb[FEERATE_HIGHEST]
 		     * bitcoind->max_fee_multiplier);
-	return command_finished(cmd, response);
+	return command_finished(bcli->cmd, response);
 }
 
 /* Get the current feerates. We use an urgent feerate for unilateral_close and max,
  * a slightly less urgent feerate for htlc_resolution and penalty transactions,
  * a slow feerate for min, and a normal one for all others.
+ *
+ * We ask for all the estimates at once: with bitcoin-rpc-http they go to
+ * bitcoind as a single batch.
  */
 static struct command_result *estimatefees(struct command *cmd,
 					   const char *buf UNUSED,
@@ -729,25 +1436,24 @@ static struct command_result *estimatefees(struct command *cmd,
 	if (!param(cmd, buf, toks, NULL))
 		return command_param_failed();
 
-	stash->cursor = 0;
-	return estimatefees_next(cmd, stash);
-}
-
-static struct command_result *estimatefees_done(struct bitcoin_cli *bcli)
-{
-	struct command_result *err;
-	struct estimatefees_stash *stash = bcli->stash;
+	stash->num_remaining = ARRAY_SIZE(stash->perkb);
+	stash->err = NULL;
+	stash->no_estimate = false;
+	for (size_t i = 0; i < ARRAY_SIZE(stash->perkb); i++) {
+		struct estimatefees_one *one = tal(stash, struct estimatefees_one);
 
-	/* If we cannot estimate fees, no need to continue bothering bitcoind. */
-	if (*bcli->exitstatus != 0)
-		return estimatefees_null_response(bcli);
-
-	err = estimatefees_parse_feerate(bcli, &stash->perkb[stash->cursor]);
-	if (err)
-		return err;
+		one->stash = stash;
+		one->level = i;
+		start_bitcoin_cli(NULL, cmd, estimatefees_done, true,
+				  BITCOIND_LOW_PRIO, one,
+				  "estimatesmartfee",
+				  take(tal_fmt(NULL, "%u",
+					       estimatefee_params[i].blocks)),
+				  estimatefee_params[i].style,
+				  NULL);
+	}
 
-	stash->cursor++;
-	return estimatefees_next(bcli->cmd, stash);
+	return command_still_pending(cmd);
 }
 
 /* Send a transaction to the Bitcoin network.
@@ -810,6 +1516,62 @@ static struct command_result *getutxout(struct command *cmd,
 	return command_still_pending(cmd);
 }
 
+/* Look up many outputs at once, eg. to check channel announcements. */
+static struct command_result *getutxouts(struct command *cmd,
+					 const char *buf,
+					 const jsmntok_t *toks)
+{
+	const jsmntok_t *outpoints, *t;
+	struct getutxouts_stash *stash;
+	const char **txids, **vouts;
+	size_t i;
+
+	if (!param(cmd, buf, toks,
+	           p_req("outpoints", param_array, &outpoints),
+	           NULL))
+		return command_param_failed();
+
+	/* Check them all before we start any. */
+	txids = tal_arr(cmd, const char *, outpoints->size);
+	vouts = tal_arr(cmd, const char *, outpoints->size);
+	json_for_each_arr(i, t, outpoints) {
+		const char *err;
+
+		err = json_scan(tmpctx, buf, t, "{txid:%,vout:%}",
+				JSON_SCAN_TAL(txids, json_strdup, &txids[i]),
+				JSON_SCAN_TAL(vouts, json_strdup, &vouts[i]));
+		if (err)
+			return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+					    "outpoints[%zu]: %s", i, err);
+	}
+
+	stash = tal(cmd, struct getutxouts_stash);
+	stash->num_remaining = outpoints->size;
+	stash->err = NULL;
+	stash->outputs = tal_arrz(stash, struct bitcoin_tx_output *,
+				  outpoints->size);
+
+	if (stash->num_remaining == 0) {
+		struct json_stream *response = jsonrpc_stream_success(cmd);
+		json_array_start(response, "utxouts");
+		json_array_end(response);
+		return command_finished(cmd, response);
+	}
+
+	for (i = 0; i < outpoints->size; i++) {
+		struct getutxouts_one *one = tal(stash, struct getutxouts_one);
+
+		one->stash = stash;
+		one->idx = i;
+		/* Bulk lookups (eg. gossip) shouldn't starve other requests. */
+		start_bitcoin_cli(NULL, cmd, process_getutxouts_one, true,
+				  BITCOIND_LOW_PRIO, one,
+				  "gettxout", txids[i], vouts[i], NULL);
+	}
+
+	return command_still_pending(cmd);
+}
+
 static void bitcoind_failure(struct plugin *p, const char *error_message)
 {
 	const char **cmd = gather_args(bitcoind, "echo", NULL);
@@ -933,6 +1695,15 @@ static const char *init(struct plugin *p, const char *buffer UNUSED,
 {
 	wait_and_check_bitcoind(p);
 
+	if (bitcoind->rpc_http) {
+		if (!bitcoind->rpcuser || !bitcoind->rpcpass)
+			plugin_err(p, "--bitcoin-rpc-http needs --bitcoin-rpcuser"
+				   " and --bitcoin-rpcpassword");
+		bitcoind->rpc_addrs = rpc_resolve(p);
+		for (size_t i = 0; i < BITCOIND_NUM_PRIO; i++)
+			bitcoind->rpc_conns[i] = new_rpc_conn(bitcoind, i);
+	}
+
 	/* Usually we fake up fees in regtest */
 	if (streq(chainparams->network_name, "regtest"))
 		bitcoind->fake_fees = IFDEV(!bitcoind->no_fake_fees, true);
@@ -956,6 +1727,21 @@ static const struct plugin_command commands[] = {
 		"",
 		getrawblockbyheight
 	},
+	{
+		"writerawblockbyheight",
+		"bitcoin",
+		"Write the bitcoin block at a given height to {path}",
+		"",
+		writerawblockbyheight
+	},
+	{
+		"getblockfilterbyheight",
+		"bitcoin",
+		"Get the BIP158 basic filter, and header, of the bitcoin block"
+		" at a given height",
+		"",
+		getblockfilterbyheight
+	},
 	{
 		"getchaininfo",
 		"bitcoin",
@@ -986,6 +1772,14 @@ static const struct plugin_command commands[] = {
 		"",
 		getutxout
 	},
+	{
+		"getutxouts",
+		"bitcoin",
+		"Get information about several outputs, given an array of"
+		" {outpoints} each with a {txid} and a {vout}",
+		"",
+		getutxouts
+	},
 };
 
 static struct bitcoind *new_bitcoind(const tal_t *ctx)
@@ -1007,6 +1801,7 @@ static struct bitcoind *new_bitcoind(const tal_t *ctx)
 	bitcoind->rpcport = NULL;
 	bitcoind->max_fee_multiplier = 10;
 	bitcoind->commit_fee_percent = 100;
+	bitcoind->rpc_http = false;
 #if DEVELOPER
 	bitcoind->no_fake_fees = false;
 #endif
@@ -1048,6 +1843,11 @@ int main(int argc, char *argv[])
 				  "string",
 				  "bitcoind RPC host's port",
 				  charp_option, &bitcoind->rpcport),
+		    plugin_option("bitcoin-rpc-http",
+				  "flag",
+				  "Talk JSON-RPC to bitcoind directly over a"
+				  " persistent connection, not via bitcoin-cli",
+				  flag_option, &bitcoind->rpc_http),
 		    plugin_option("bitcoin-retry-timeout",
 				  "string",
 				  "how long to keep retrying to contact bitcoind"
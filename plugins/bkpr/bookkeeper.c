@@ -1276,6 +1276,17 @@ static struct command_result *lookup_invoice_desc(struct command *cmd,
 						  struct sha256 *payment_hash STEALS)
 {
 	struct out_req *req;
+	const char *desc;
+
+	/* Each part of a multi-part payment is its own event: if we
+	 * already looked this one up, don't ask lightningd again. */
+	db_begin_transaction(db);
+	desc = find_payment_hash_desc(tmpctx, db, payment_hash);
+	if (desc)
+		add_payment_hash_desc(db, payment_hash, desc);
+	db_commit_transaction(db);
+	if (desc)
+		return notification_handled(cmd);
 
 	/* Otherwise will go away when event is cleaned up */
 	tal_steal(cmd, payment_hash);
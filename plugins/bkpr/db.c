@@ -101,7 +101,32 @@ static struct migration db_migrations[] = {
 	{SQL("ALTER TABLE chain_events ADD ev_desc TEXT DEFAULT NULL;"), NULL},
 	{SQL("ALTER TABLE channel_events ADD ev_desc TEXT DEFAULT NULL;"), NULL},
 	{SQL("ALTER TABLE channel_events ADD rebalance_id BIGINT DEFAULT NULL;"), NULL},
-	{NULL, migration_remove_dupe_lease_fees}
+	{NULL, migration_remove_dupe_lease_fees},
+	/* Balances, income and per-tx lookups otherwise scan every event */
+	{SQL("CREATE INDEX chain_events_account_idx"
+	     " ON chain_events (account_id);"), NULL},
+	{SQL("CREATE INDEX chain_events_timestamp_idx"
+	     " ON chain_events (timestamp);"), NULL},
+	{SQL("CREATE INDEX chain_events_utxo_txid_idx"
+	     " ON chain_events (utxo_txid);"), NULL},
+	{SQL("CREATE INDEX chain_events_spending_txid_idx"
+	     " ON chain_events (spending_txid);"), NULL},
+	{SQL("CREATE INDEX channel_events_account_idx"
+	     " ON channel_events (account_id);"), NULL},
+	{SQL("CREATE INDEX channel_events_timestamp_idx"
+	     " ON channel_events (timestamp);"), NULL},
+	{SQL("CREATE INDEX channel_events_payment_id_idx"
+	     " ON channel_events (payment_id);"), NULL},
+	/* Per-account listings also sort by timestamp: (account_id,
+	 * timestamp) serves both, and covers the account_id lookups */
+	{SQL("DROP INDEX chain_events_account_idx;"), NULL},
+	{SQL("CREATE INDEX chain_events_account_timestamp_idx"
+	     " ON chain_events (account_id, timestamp);"), NULL},
+	{SQL("DROP INDEX channel_events_account_idx;"), NULL},
+	{SQL("CREATE INDEX channel_events_account_timestamp_idx"
+	     " ON channel_events (account_id, timestamp);"), NULL},
+	{SQL("CREATE INDEX onchain_fees_timestamp_idx"
+	     " ON onchain_fees (timestamp);"), NULL},
 };
 
 static bool db_migrate(struct plugin *p, struct db *db, bool *created)
@@ -210,7 +235,7 @@ struct db *db_setup(const tal_t *ctx, struct plugin *p,
 
 	/* Set global for db_fatal */
 	plugin = p;
-	db = db_open(ctx, db_dsn);
+	db = db_open(ctx, db_dsn, false);
 	db->report_changes_fn = NULL;
 
 	db_begin_transaction(db);
@@ -653,6 +653,45 @@ void add_payment_hash_desc(struct db *db,
 	db_exec_prepared_v2(take(stmt));
 }
 
+char *find_payment_hash_desc(const tal_t *ctx,
+			     struct db *db,
+			     struct sha256 *payment_hash)
+{
+	struct db_stmt *stmt;
+	char *desc;
+
+	stmt = db_prepare_v2(db, SQL("SELECT"
+				     "  ev_desc"
+				     " FROM channel_events"
+				     " WHERE payment_id = ?"
+				     " AND ev_desc IS NOT NULL"
+				     " LIMIT 1"));
+	db_bind_sha256(stmt, 0, payment_hash);
+	db_query_prepared(stmt);
+	if (db_step(stmt))
+		desc = db_col_strdup(ctx, stmt, "ev_desc");
+	else
+		desc = NULL;
+	tal_free(stmt);
+
+	if (desc)
+		return desc;
+
+	stmt = db_prepare_v2(db, SQL("SELECT"
+				     "  ev_desc"
+				     " FROM chain_events"
+				     " WHERE payment_id = ?"
+				     " AND ev_desc IS NOT NULL"
+				     " LIMIT 1"));
+	db_bind_sha256(stmt, 0, payment_hash);
+	db_query_prepared(stmt);
+	if (db_step(stmt))
+		desc = db_col_strdup(ctx, stmt, "ev_desc");
+	tal_free(stmt);
+
+	return desc;
+}
+
 struct chain_event *find_chain_event_by_id(const tal_t *ctx,
 					   struct db *db,
 					   u64 event_db_id)
@@ -1057,8 +1096,8 @@ struct onchain_fee **list_chain_fees_timebox(const tal_t *ctx, struct db *db,
 				     " FROM onchain_fees of"
 				     " LEFT OUTER JOIN accounts a"
 				     " ON a.id = of.account_id"
-				     " WHERE timestamp > ?"
-				     "  AND timestamp <= ?"
+				     " WHERE of.timestamp > ?"
+				     "  AND of.timestamp <= ?"
 				     " ORDER BY "
 				     "  of.timestamp"
 				     ", of.account_id"
@@ -202,6 +202,11 @@ void add_payment_hash_desc(struct db *db,
 			   struct sha256 *payment_hash,
 			   const char *desc);
 
+/* Find the description already recorded for this payment_hash, if any */
+char *find_payment_hash_desc(const tal_t *ctx,
+			     struct db *db,
+			     struct sha256 *payment_hash);
+
 /* When we make external deposits from the wallet, we don't
  * count them until any output that was spent *into* them is
  * confirmed onchain.
@@ -256,7 +256,7 @@ static struct db *create_test_db(void)
 	char *dsn;
 
 	dsn = tmp_dsn(NULL);
-	db = db_open(NULL, dsn);
+	db = db_open(NULL, dsn, false);
 	db->data_version = 0;
 	db->report_changes_fn = NULL;
 
@@ -1,6 +1,7 @@
 #include "config.h"
 #include <ccan/array_size/array_size.h>
 #include <ccan/cast/cast.h>
+#include <ccan/crypto/sha256/sha256.h>
 #include <ccan/err/err.h>
 #include <ccan/json_out/json_out.h>
 #include <ccan/noerr/noerr.h>
@@ -32,6 +33,11 @@
 static struct secret secret;
 static bool peer_backup;
 
+/* Hash of the channels we last wrote out (not the timestamp), so
+ * state changes which don't alter the backup don't rewrite it. */
+static struct sha256 last_scb_hash;
+static bool have_last_scb_hash;
+
 /* Helper to fetch out SCB from the RPC call */
 static bool json_to_scb_chan(const char *buffer,
 			     const jsmntok_t *tok,
@@ -478,10 +484,27 @@ static struct command_result *after_staticbackup(struct command *cmd,
 	struct scb_chan **scb_chan;
 	const jsmntok_t *scbs = json_get_member(buf, params, "scb");
 	struct out_req *req;
+	struct sha256 scb_hash;
+	const u8 *scb_data;
+
 	json_to_scb_chan(buf, scbs, &scb_chan);
+
+	/* Nothing changed?  Don't rewrite the file, or resend it to
+	 * every peer. */
+	scb_data = towire_static_chan_backup(tmpctx, VERSION, 0,
+					     cast_const2(const struct scb_chan **,
+							 scb_chan));
+	sha256(&scb_hash, scb_data, tal_bytelen(scb_data));
+	if (have_last_scb_hash && sha256_eq(&scb_hash, &last_scb_hash)) {
+		plugin_log(cmd->plugin, LOG_DBG, "SCB unchanged");
+		return notification_handled(cmd);
+	}
+
 	plugin_log(cmd->plugin, LOG_INFORM, "Updating the SCB");
 
 	update_scb(cmd->plugin, scb_chan);
+	last_scb_hash = scb_hash;
+	have_last_scb_hash = true;
 	struct info *info = tal(cmd, struct info);
 	info->idx = 0;
 	req = jsonrpc_request_start(cmd->plugin,
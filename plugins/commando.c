@@ -137,43 +137,54 @@ struct reply {
 	size_t off, len;
 };
 
-/* Calls itself repeatedly: first time, result is NULL */
-static struct command_result *send_response(struct command *command UNUSED,
-					    const char *buf UNUSED,
-					    const jsmntok_t *result,
-					    struct reply *reply)
+static struct command_result *sent_response_part(struct command *command UNUSED,
+						 const char *buf UNUSED,
+						 const jsmntok_t *result UNUSED,
+						 void *unused)
+{
+	return command_done();
+}
+
+/* lightningd handles our requests in order, so we can hand it every
+ * part at once rather than waiting for each sendcustommsg to return. */
+static struct command_result *send_response(struct reply *reply)
 {
-	size_t msglen = reply->len - reply->off;
-	u8 *cmd_msg;
 	enum commando_msgtype msgtype;
-	struct out_req *req;
 
-	/* Limit is 64k, but there's a little overhead */
-	if (msglen > 65000) {
-		msglen = 65000;
-		msgtype = COMMANDO_MSG_REPLY_CONTINUES;
-	} else {
-		if (msglen == 0) {
-			tal_free(reply);
-			return command_done();
-		}
-		msgtype = COMMANDO_MSG_REPLY_TERM;
+	if (reply->len == 0) {
+		tal_free(reply);
+		return command_done();
 	}
 
-	cmd_msg = tal_arr(NULL, u8, 0);
-	towire_u16(&cmd_msg, msgtype);
-	towire_u64(&cmd_msg, reply->incoming->id);
-	towire(&cmd_msg, reply->buf + reply->off, msglen);
-	reply->off += msglen;
-
-	req = jsonrpc_request_start(plugin, NULL, "sendcustommsg",
-				    send_response, send_response,
-				    reply);
-	json_add_node_id(req->js, "node_id", &reply->incoming->peer);
-	json_add_hex_talarr(req->js, "msg", cmd_msg);
-	tal_free(cmd_msg);
-	send_outreq(plugin, req);
-
+	do {
+		size_t msglen = reply->len - reply->off;
+		u8 *cmd_msg;
+		struct out_req *req;
+
+		/* Limit is 64k, but there's a little overhead */
+		if (msglen > 65000) {
+			msglen = 65000;
+			msgtype = COMMANDO_MSG_REPLY_CONTINUES;
+		} else
+			msgtype = COMMANDO_MSG_REPLY_TERM;
+
+		cmd_msg = tal_arr(NULL, u8, 0);
+		towire_u16(&cmd_msg, msgtype);
+		towire_u64(&cmd_msg, reply->incoming->id);
+		towire(&cmd_msg, reply->buf + reply->off, msglen);
+		reply->off += msglen;
+
+		req = jsonrpc_request_start(plugin, NULL, "sendcustommsg",
+					    sent_response_part,
+					    sent_response_part,
+					    NULL);
+		json_add_node_id(req->js, "node_id", &reply->incoming->peer);
+		json_add_hex_talarr(req->js, "msg", cmd_msg);
+		tal_free(cmd_msg);
+		send_outreq(plugin, req);
+	} while (msgtype == COMMANDO_MSG_REPLY_CONTINUES);
+
+	tal_free(reply);
 	return command_done();
 }
 
@@ -211,7 +222,7 @@ static struct command_result *cmd_done(struct command *command,
 	}
 	reply->off = 0;
 
-	return send_response(command, NULL, NULL, reply);
+	return send_response(reply);
 }
 
 static void commando_error(struct commando *incoming,
@@ -235,7 +246,7 @@ static void commando_error(struct commando *incoming,
 	reply->off = 0;
 	reply->len = tal_bytelen(reply->buf) - 1;
 
-	send_response(NULL, NULL, NULL, reply);
+	send_response(reply);
 }
 
 struct cond_info {
@@ -536,8 +536,8 @@ static struct pubkey *path_to_node(const tal_t *ctx,
 	if (!src)
 		return NULL;
 
-	dij = dijkstra(tmpctx, gossmap, dst, AMOUNT_MSAT(0), 0,
-		       can_carry_onionmsg, route_score_shorter, NULL);
+	dij = dijkstra_to(tmpctx, gossmap, dst, src, AMOUNT_MSAT(0), 0,
+			  can_carry_onionmsg, route_score_shorter, NULL);
 
 	r = route_from_dijkstra(tmpctx, gossmap, dij, src, AMOUNT_MSAT(0), 0);
 	if (!r)
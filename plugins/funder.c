@@ -743,6 +743,49 @@ listfunds_failed(struct command *cmd,
 	return command_hook_success(cmd);
 }
 
+static struct command_result *
+listfunds_done(struct command *cmd,
+	       const char *buf,
+	       const jsmntok_t *resp,
+	       struct open_info *info)
+{
+	const jsmntok_t *tok = json_get_member(buf, resp, "error");
+
+	if (tok)
+		return listfunds_failed(cmd, buf, tok, info);
+	return listfunds_success(cmd, buf,
+				 json_get_member(buf, resp, "result"), info);
+}
+
+/* Every open (and RBF) asks for our funds: on a node with many channels
+ * the full `listfunds` is mostly channel data we never look at, so only
+ * ask for the output fields listfunds_success uses. */
+static struct command_result *
+send_listfunds(struct command *cmd, struct open_info *info)
+{
+	struct out_req *req;
+
+	req = jsonrpc_request_whole_object_start(cmd->plugin, cmd,
+						 "listfunds",
+						 json_id_prefix(tmpctx, cmd),
+						 &listfunds_done, info);
+	json_object_start(req->js, "params");
+	json_object_end(req->js);
+	json_object_start(req->js, "filter");
+	json_array_start(req->js, "outputs");
+	json_object_start(req->js, NULL);
+	json_add_bool(req->js, "amount_msat", true);
+	json_add_bool(req->js, "status", true);
+	json_add_bool(req->js, "reserved", true);
+	json_add_bool(req->js, "txid", true);
+	json_add_bool(req->js, "output", true);
+	json_add_bool(req->js, "redeemscript", true);
+	json_object_end(req->js);
+	json_array_end(req->js);
+	json_object_end(req->js);
+	return send_outreq(cmd->plugin, req);
+}
+
 static struct command_result *
 json_openchannel2_call(struct command *cmd,
 		       const char *buf,
@@ -755,7 +798,6 @@ json_openchannel2_call(struct command *cmd,
 	u32 to_self_delay, max_accepted_htlcs;
 	u16 channel_flags;
 	const char *err;
-	struct out_req *req;
 
 	err = json_scan(tmpctx, buf, params,
 			"{openchannel2:"
@@ -866,13 +908,7 @@ json_openchannel2_call(struct command *cmd,
 	}
 
 	/* Figure out what our funds are */
-	req = jsonrpc_request_start(cmd->plugin, cmd,
-				    "listfunds",
-				    &listfunds_success,
-				    &listfunds_failed,
-				    info);
-
-	return send_outreq(cmd->plugin, req);
+	return send_listfunds(cmd, info);
 }
 
 static struct command_result *
@@ -881,7 +917,6 @@ datastore_list_fail(struct command *cmd,
 		    const jsmntok_t *error,
 		    struct open_info *info)
 {
-	struct out_req *req;
 
 	/* Oops, something's broken */
 	plugin_log(cmd->plugin, LOG_BROKEN,
@@ -891,12 +926,7 @@ datastore_list_fail(struct command *cmd,
 
 	/* Figure out what our funds are... same flow
 	 * as with openchannel2 callback.  */
-	req = jsonrpc_request_start(cmd->plugin, cmd,
-				    "listfunds",
-				    &listfunds_success,
-				    &listfunds_failed,
-				    info);
-	return send_outreq(cmd->plugin, req);
+	return send_listfunds(cmd, info);
 }
 
 static struct command_result *
@@ -905,7 +935,6 @@ datastore_list_success(struct command *cmd,
 		       const jsmntok_t *result,
 		       struct open_info *info)
 {
-	struct out_req *req;
 	const char *key, *err;
 	const u8 *utxos_bin;
 	size_t len, i;
@@ -960,12 +989,7 @@ datastore_list_success(struct command *cmd,
 		tal_arr_expand(&info->prev_outs, outpoint);
 	}
 
-	req = jsonrpc_request_start(cmd->plugin, cmd,
-				    "listfunds",
-				    &listfunds_success,
-				    &listfunds_failed,
-				    info);
-	return send_outreq(cmd->plugin, req);
+	return send_listfunds(cmd, info);
 }
 
 /* Peer has asked us to RBF */
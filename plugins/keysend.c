@@ -13,8 +13,11 @@
 
 #define PREIMAGE_TLV_TYPE 5482373484
 #define KEYSEND_FEATUREBIT 55
+/* 22 is the Rust-Lightning default and the highest minimum we know of. */
+#define KEYSEND_FINAL_CLTV 22
 static unsigned int maxdelay_default;
 static struct node_id my_id;
+static u32 blockheight;
 
 /*****************************************************************************
  * Keysend modifier
@@ -164,13 +167,17 @@ static const char *init(struct plugin *p, const char *buf UNUSED,
 			const jsmntok_t *config UNUSED)
 {
 	rpc_scan(p, "getinfo", take(json_out_obj(NULL, NULL, NULL)),
-		 "{id:%}", JSON_SCAN(json_to_node_id, &my_id));
+		 "{id:%,blockheight:%}",
+		 JSON_SCAN(json_to_node_id, &my_id),
+		 JSON_SCAN(json_to_u32, &blockheight));
 
 	rpc_scan(p, "listconfigs",
 		 take(json_out_obj(NULL, "config", "max-locktime-blocks")),
 		 "{max-locktime-blocks:%}",
 		 JSON_SCAN(json_to_number, &maxdelay_default));
 
+	liquidity_hints_load(p);
+
 	return NULL;
 }
 
@@ -187,91 +194,418 @@ struct payment_modifier *pay_mods[] = {
     NULL,
 };
 
-static struct command_result *json_keysend(struct command *cmd, const char *buf,
-					   const jsmntok_t *params)
-{
-	struct payment *p;
-	const char *label;
-	struct amount_msat *exemptfee, *msat;
+struct keysend_params {
 	struct node_id *destination;
+	struct amount_msat *msat;
+	const char *label;
+	struct amount_msat *exemptfee;
 	u64 *maxfee_pct_millionths;
 	u32 *maxdelay;
 	unsigned int *retryfor;
 	struct route_info **hints;
 	struct tlv_field *extra_fields;
-
 #if DEVELOPER
 	bool *use_shadow;
 #endif
-	if (!param(cmd, buf, params,
-		   p_req("destination", param_node_id, &destination),
-		   p_req("amount_msat|msatoshi", param_msat, &msat),
-		   p_opt("label", param_string, &label),
-		   p_opt_def("maxfeepercent", param_millionths,
-			     &maxfee_pct_millionths, 500000),
-		   p_opt_def("retry_for", param_number, &retryfor, 60),
-		   p_opt_def("maxdelay", param_number, &maxdelay,
-			     maxdelay_default),
-		   p_opt_def("exemptfee", param_msat, &exemptfee, AMOUNT_MSAT(5000)),
-		   p_opt("extratlvs", param_extra_tlvs, &extra_fields),
-		   p_opt("routehints", param_routehint_array, &hints),
-#if DEVELOPER
-		   p_opt_def("use_shadow", param_bool, &use_shadow, true),
-#endif
-		   NULL))
-		return command_param_failed();
+};
+
+/* The full payment state machine, with routing, retries and so on. */
+static struct command_result *keysend_pay(struct command *cmd,
+					  const char *buf,
+					  const jsmntok_t *params,
+					  struct keysend_params *kp)
+{
+	struct payment *p;
 
 	p = payment_new(cmd, cmd, NULL /* No parent */, pay_mods);
 	p->local_id = &my_id;
 	p->json_buffer = tal_dup_talarr(p, const char, buf);
 	p->json_toks = params;
-	p->destination = tal_steal(p, destination);
+	p->destination = tal_steal(p, kp->destination);
 	p->payment_secret = NULL;
 	p->payment_metadata = NULL;
 	p->blindedpath = NULL;
 	p->blindedpay = NULL;
-	p->amount = *msat;
-	p->routes = tal_steal(p, hints);
-	// 22 is the Rust-Lightning default and the highest minimum we know of.
-	p->min_final_cltv_expiry = 22;
+	p->amount = *kp->msat;
+	p->routes = tal_steal(p, kp->hints);
+	p->min_final_cltv_expiry = KEYSEND_FINAL_CLTV;
 	p->features = NULL;
 	p->invstring = NULL;
 	/* Don't try to use invstring to hand to sendonion! */
 	p->invstring_used = true;
 	p->why = "Initial attempt";
-	p->constraints.cltv_budget = *maxdelay;
-	p->deadline = timeabs_add(time_now(), time_from_sec(*retryfor));
+	p->constraints.cltv_budget = *kp->maxdelay;
+	p->deadline = timeabs_add(time_now(), time_from_sec(*kp->retryfor));
 	p->getroute->riskfactorppm = 10000000;
 
-	if (node_id_eq(&my_id, p->destination)) {
-		return command_fail(
-		    cmd, JSONRPC2_INVALID_PARAMS,
-		    "We are the destination. Keysend cannot be used to send funds to yourself");
-	}
-
 	if (!amount_msat_fee(&p->constraints.fee_budget, p->amount, 0,
-			     *maxfee_pct_millionths / 100)) {
+			     *kp->maxfee_pct_millionths / 100)) {
 		return command_fail(
 		    cmd, JSONRPC2_INVALID_PARAMS,
 		    "Overflow when computing fee budget, fee rate too high.");
 	}
 
-	p->constraints.cltv_budget = *maxdelay;
+	p->constraints.cltv_budget = *kp->maxdelay;
 
 	payment_mod_keysend_get_data(p)->extra_tlvs =
-	    tal_steal(p, extra_fields);
+	    tal_steal(p, kp->extra_fields);
 
-	payment_mod_exemptfee_get_data(p)->amount = *exemptfee;
+	payment_mod_exemptfee_get_data(p)->amount = *kp->exemptfee;
 #if DEVELOPER
-	payment_mod_shadowroute_get_data(p)->use_shadow = *use_shadow;
+	payment_mod_shadowroute_get_data(p)->use_shadow = *kp->use_shadow;
 #endif
-	p->label = tal_steal(p, label);
+	p->label = tal_steal(p, kp->label);
 	payment_start(p);
 	/* We're keeping this around now */
 	tal_steal(cmd->plugin, notleak(p));
 	return command_still_pending(cmd);
 }
 
+/*****************************************************************************
+ * Direct keysend
+ * ==============
+ *
+ * Paying a peer we have a channel with needs no route, no fees and no
+ * retries, so we skip the modifiers and go straight to createonion and
+ * sendonion, remembering the channel for next time.  Anything unexpected
+ * (no channel, the cached channel can't take it, the peer fails it) falls
+ * back to keysend_pay(), which sorts it out and reports properly.
+ */
+
+/* Peer -> channel we last paid them over. */
+struct keysend_channel {
+	struct node_id peer;
+	struct short_channel_id scid;
+};
+static struct keysend_channel *keysend_channels;
+
+static struct keysend_channel *keysend_channel_find(const struct node_id *peer)
+{
+	for (size_t i = 0; i < tal_count(keysend_channels); i++) {
+		if (node_id_eq(&keysend_channels[i].peer, peer))
+			return &keysend_channels[i];
+	}
+	return NULL;
+}
+
+static void keysend_channel_forget(const struct node_id *peer)
+{
+	struct keysend_channel *kc = keysend_channel_find(peer);
+
+	if (kc)
+		tal_arr_remove(&keysend_channels, kc - keysend_channels);
+}
+
+struct keysend_direct {
+	struct command *cmd;
+	const char *buf;
+	const jsmntok_t *params;
+	struct keysend_params *kp;
+	struct short_channel_id scid;
+	struct preimage preimage;
+	struct sha256 payment_hash;
+	struct timeabs start_time;
+	/* preapprovekeysend and createonion run in parallel */
+	size_t pending;
+	struct createonion_response *onion;
+	const char *failreason;
+};
+
+static struct command_result *keysend_direct_fallback(struct keysend_direct *kd)
+{
+	plugin_log(kd->cmd->plugin, LOG_DBG,
+		   "Direct keysend to %s failed, trying the long way",
+		   node_id_to_hexstr(tmpctx, kd->kp->destination));
+	keysend_channel_forget(kd->kp->destination);
+	return keysend_pay(kd->cmd, kd->buf, kd->params, kd->kp);
+}
+
+static struct command_result *keysend_direct_failed(struct command *cmd,
+						    const char *buf,
+						    const jsmntok_t *toks,
+						    struct keysend_direct *kd)
+{
+	return keysend_direct_fallback(kd);
+}
+
+static struct command_result *keysend_direct_done(struct command *cmd,
+						  const char *buf,
+						  const jsmntok_t *toks,
+						  struct keysend_direct *kd)
+{
+	struct json_stream *ret, *n;
+	struct amount_msat sent;
+	const jsmntok_t *senttok = json_get_member(buf, toks,
+						   "amount_sent_msat");
+
+	if (!senttok || !json_to_msat(buf, senttok, &sent))
+		sent = *kd->kp->msat;
+
+	/* Same as payment_finished() */
+	ret = jsonrpc_stream_success(cmd);
+	json_add_node_id(ret, "destination", kd->kp->destination);
+	json_add_sha256(ret, "payment_hash", &kd->payment_hash);
+	json_add_timeabs(ret, "created_at", kd->start_time);
+	json_add_num(ret, "parts", 1);
+	json_add_amount_msat_compat(ret, *kd->kp->msat, "msatoshi",
+				    "amount_msat");
+	json_add_amount_msat_compat(ret, sent, "msatoshi_sent",
+				    "amount_sent_msat");
+	json_add_preimage(ret, "payment_preimage", &kd->preimage);
+	json_add_string(ret, "status", "complete");
+
+	n = plugin_notification_start(cmd->plugin, "pay_success");
+	json_add_sha256(n, "payment_hash", &kd->payment_hash);
+	plugin_notification_end(cmd->plugin, n);
+
+	return command_finished(cmd, ret);
+}
+
+static struct command_result *keysend_direct_sent(struct command *cmd,
+						  const char *buf,
+						  const jsmntok_t *toks,
+						  struct keysend_direct *kd)
+{
+	struct out_req *req;
+
+	req = jsonrpc_request_start(cmd->plugin, cmd, "waitsendpay",
+				    keysend_direct_done,
+				    keysend_direct_failed, kd);
+	json_add_sha256(req->js, "payment_hash", &kd->payment_hash);
+	json_add_num(req->js, "partid", 0);
+	json_add_u64(req->js, "groupid", 0);
+	return send_outreq(cmd->plugin, req);
+}
+
+static struct command_result *keysend_direct_ready(struct keysend_direct *kd)
+{
+	struct command *cmd = kd->cmd;
+	struct out_req *req;
+
+	if (--kd->pending != 0)
+		return command_still_pending(cmd);
+
+	if (kd->failreason)
+		return command_fail(cmd, PAY_STOPPED_RETRYING, "%s",
+				    kd->failreason);
+	if (!kd->onion)
+		return keysend_direct_fallback(kd);
+
+	req = jsonrpc_request_start(cmd->plugin, cmd, "sendonion",
+				    keysend_direct_sent,
+				    keysend_direct_failed, kd);
+	json_add_hex_talarr(req->js, "onion", kd->onion->onion);
+	json_object_start(req->js, "first_hop");
+	json_add_amount_msat_only(req->js, "amount_msat", *kd->kp->msat);
+	json_add_num(req->js, "delay", KEYSEND_FINAL_CLTV);
+	json_add_node_id(req->js, "id", kd->kp->destination);
+	json_add_short_channel_id(req->js, "channel", &kd->scid);
+	json_object_end(req->js);
+	json_add_sha256(req->js, "payment_hash", &kd->payment_hash);
+	json_add_amount_msat_only(req->js, "amount_msat", *kd->kp->msat);
+	json_array_start(req->js, "shared_secrets");
+	for (size_t i = 0; i < tal_count(kd->onion->shared_secrets); i++)
+		json_add_secret(req->js, NULL, &kd->onion->shared_secrets[i]);
+	json_array_end(req->js);
+	json_add_num(req->js, "partid", 0);
+	json_add_u64(req->js, "groupid", 0);
+	if (kd->kp->label)
+		json_add_string(req->js, "label", kd->kp->label);
+	json_add_node_id(req->js, "destination", kd->kp->destination);
+	return send_outreq(cmd->plugin, req);
+}
+
+static struct command_result *keysend_direct_approved(struct command *cmd,
+						      const char *buf,
+						      const jsmntok_t *toks,
+						      struct keysend_direct *kd)
+{
+	return keysend_direct_ready(kd);
+}
+
+static struct command_result *keysend_direct_unapproved(struct command *cmd,
+							const char *buf,
+							const jsmntok_t *toks,
+							struct keysend_direct *kd)
+{
+	/* Same as preapprovekeysend_rpc_failure */
+	kd->failreason = tal_fmt(kd, "Failing payment due to a failed RPC call: %.*s",
+				 toks->end - toks->start, buf + toks->start);
+	return keysend_direct_ready(kd);
+}
+
+static struct command_result *keysend_direct_onion(struct command *cmd,
+						   const char *buf,
+						   const jsmntok_t *toks,
+						   struct keysend_direct *kd)
+{
+	kd->onion = json_to_createonion_response(kd, buf, toks);
+	return keysend_direct_ready(kd);
+}
+
+static struct command_result *keysend_direct_noonion(struct command *cmd,
+						     const char *buf,
+						     const jsmntok_t *toks,
+						     struct keysend_direct *kd)
+{
+	return keysend_direct_ready(kd);
+}
+
+static struct command_result *keysend_direct_send(struct keysend_direct *kd)
+{
+	struct command *cmd = kd->cmd;
+	struct tlv_tlv_payload *payload;
+	struct out_req *req;
+	u8 *tlv, *onionpayload, *assocdata;
+
+	randombytes_buf(&kd->preimage, sizeof(kd->preimage));
+	ccan_sha256(&kd->payment_hash, &kd->preimage, sizeof(kd->preimage));
+	kd->start_time = time_now();
+	kd->pending = 2;
+	kd->onion = NULL;
+	kd->failreason = NULL;
+
+	req = jsonrpc_request_start(cmd->plugin, cmd, "preapprovekeysend",
+				    keysend_direct_approved,
+				    keysend_direct_unapproved, kd);
+	json_add_node_id(req->js, "destination", kd->kp->destination);
+	json_add_sha256(req->js, "payment_hash", &kd->payment_hash);
+	json_add_amount_msat_only(req->js, "amount_msat", *kd->kp->msat);
+	send_outreq(cmd->plugin, req);
+
+	/* Same fields as payment_add_hop_onion_payload and keysend_cb. */
+	payload = tlv_tlv_payload_new(tmpctx);
+	tlvstream_set_tu64(&payload->fields, TLV_TLV_PAYLOAD_AMT_TO_FORWARD,
+			   kd->kp->msat->millisatoshis); /* Raw: TLV payload generation*/
+	tlvstream_set_tu32(&payload->fields, TLV_TLV_PAYLOAD_OUTGOING_CLTV_VALUE,
+			   blockheight + KEYSEND_FINAL_CLTV + 1);
+	tlvstream_set_raw(&payload->fields, PREIMAGE_TLV_TYPE,
+			  &kd->preimage, sizeof(kd->preimage));
+	for (size_t i = 0; i < tal_count(kd->kp->extra_fields); i++) {
+		struct tlv_field *f = &kd->kp->extra_fields[i];
+		tlvstream_set_raw(&payload->fields, f->numtype, f->value,
+				  f->length);
+	}
+	tlv = tal_arr(tmpctx, u8, 0);
+	towire_tlvstream_raw(&tlv, payload->fields);
+	onionpayload = tal_arr(tmpctx, u8, 0);
+	towire_bigsize(&onionpayload, tal_bytelen(tlv));
+	towire(&onionpayload, tlv, tal_bytelen(tlv));
+	assocdata = tal_arr(tmpctx, u8, 0);
+	towire_sha256(&assocdata, &kd->payment_hash);
+
+	req = jsonrpc_request_start(cmd->plugin, cmd, "createonion",
+				    keysend_direct_onion,
+				    keysend_direct_noonion, kd);
+	json_array_start(req->js, "hops");
+	json_object_start(req->js, NULL);
+	json_add_node_id(req->js, "pubkey", kd->kp->destination);
+	json_add_hex_talarr(req->js, "payload", onionpayload);
+	json_object_end(req->js);
+	json_array_end(req->js);
+	json_add_hex_talarr(req->js, "assocdata", assocdata);
+	return send_outreq(cmd->plugin, req);
+}
+
+static struct command_result *
+keysend_direct_listpeerchannels(struct command *cmd,
+				const char *buf,
+				const jsmntok_t *toks,
+				struct keysend_direct *kd)
+{
+	struct listpeers_channel **channels
+		= json_to_listpeers_channels(tmpctx, buf, toks);
+	struct keysend_channel kc;
+
+	for (size_t i = 0; i < tal_count(channels); i++) {
+		struct listpeers_channel *chan = channels[i];
+
+		if (!chan->connected
+		    || !streq(chan->state, "CHANNELD_NORMAL")
+		    || amount_msat_less(chan->spendable_msat, *kd->kp->msat))
+			continue;
+
+		kd->scid = chan->scid ? *chan->scid : *chan->alias[LOCAL];
+		kc.peer = *kd->kp->destination;
+		kc.scid = kd->scid;
+		if (!keysend_channels)
+			keysend_channels = notleak(tal_arr(NULL,
+							   struct keysend_channel,
+							   0));
+		tal_arr_expand(&keysend_channels, kc);
+		return keysend_direct_send(kd);
+	}
+
+	/* Not a (usable) peer: do it properly. */
+	return keysend_pay(cmd, kd->buf, kd->params, kd->kp);
+}
+
+static struct command_result *keysend_direct(struct command *cmd,
+					     const char *buf,
+					     const jsmntok_t *params,
+					     struct keysend_params *kp)
+{
+	struct keysend_direct *kd = tal(cmd, struct keysend_direct);
+	struct keysend_channel *kc;
+	struct out_req *req;
+
+	kd->cmd = cmd;
+	kd->buf = buf;
+	kd->params = params;
+	kd->kp = kp;
+
+	kc = keysend_channel_find(kp->destination);
+	if (kc) {
+		kd->scid = kc->scid;
+		return keysend_direct_send(kd);
+	}
+
+	req = jsonrpc_request_start(cmd->plugin, cmd, "listpeerchannels",
+				    keysend_direct_listpeerchannels,
+				    keysend_direct_listpeerchannels, kd);
+	json_add_node_id(req->js, "id", kp->destination);
+	return send_outreq(cmd->plugin, req);
+}
+
+/*
+ * End of direct keysend
+ *****************************************************************************/
+
+static struct command_result *json_keysend(struct command *cmd, const char *buf,
+					   const jsmntok_t *params)
+{
+	struct keysend_params *kp = tal(cmd, struct keysend_params);
+
+	if (!param(cmd, buf, params,
+		   p_req("destination", param_node_id, &kp->destination),
+		   p_req("amount_msat|msatoshi", param_msat, &kp->msat),
+		   p_opt("label", param_string, &kp->label),
+		   p_opt_def("maxfeepercent", param_millionths,
+			     &kp->maxfee_pct_millionths, 500000),
+		   p_opt_def("retry_for", param_number, &kp->retryfor, 60),
+		   p_opt_def("maxdelay", param_number, &kp->maxdelay,
+			     maxdelay_default),
+		   p_opt_def("exemptfee", param_msat, &kp->exemptfee, AMOUNT_MSAT(5000)),
+		   p_opt("extratlvs", param_extra_tlvs, &kp->extra_fields),
+		   p_opt("routehints", param_routehint_array, &kp->hints),
+#if DEVELOPER
+		   p_opt_def("use_shadow", param_bool, &kp->use_shadow, true),
+#endif
+		   NULL))
+		return command_param_failed();
+
+	if (node_id_eq(&my_id, kp->destination)) {
+		return command_fail(
+		    cmd, JSONRPC2_INVALID_PARAMS,
+		    "We are the destination. Keysend cannot be used to send funds to yourself");
+	}
+
+	/* Routehints mean they're not (publicly) a peer. */
+	if (!kp->hints && *kp->maxdelay >= KEYSEND_FINAL_CLTV)
+		return keysend_direct(cmd, buf, params, kp);
+	return keysend_pay(cmd, buf, params, kp);
+}
+
 static const struct plugin_command commands[] = {
     {
 	    "keysend",
@@ -539,6 +873,22 @@ static const struct plugin_hook hooks[] = {
 	},
 };
 
+static struct command_result *block_added_notify(struct command *cmd,
+						 const char *buf,
+						 const jsmntok_t *params)
+{
+	json_scan(cmd, buf, params, "{block:{height:%}}",
+		  JSON_SCAN(json_to_u32, &blockheight));
+	return notification_handled(cmd);
+}
+
+static const struct plugin_notification notifications[] = {
+	{
+		"block_added",
+		block_added_notify,
+	},
+};
+
 static const char *notification_topics[] = {
 	"pay_success",
 	"pay_failure",
@@ -554,6 +904,7 @@ int main(int argc, char *argv[])
 	set_feature_bit(&features->bits[NODE_ANNOUNCE_FEATURE], KEYSEND_FEATUREBIT);
 
 	plugin_main(argv, init, PLUGIN_STATIC, true, features, commands,
-		    ARRAY_SIZE(commands), NULL, 0, hooks, ARRAY_SIZE(hooks),
+		    ARRAY_SIZE(commands), notifications, ARRAY_SIZE(notifications),
+		    hooks, ARRAY_SIZE(hooks),
 		    notification_topics, ARRAY_SIZE(notification_topics), NULL);
 }
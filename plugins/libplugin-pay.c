@@ -1,8 +1,12 @@
 #include "config.h"
 #include <ccan/array_size/array_size.h>
+#include <ccan/cast/cast.h>
+#include <ccan/crypto/siphash24/siphash24.h>
+#include <ccan/htable/htable_type.h>
 #include <ccan/tal/str/str.h>
 #include <common/blindedpay.h>
 #include <common/dijkstra.h>
+#include <common/gossip_constants.h>
 #include <common/gossmap.h>
 #include <common/json_stream.h>
 #include <common/memleak.h>
@@ -12,6 +16,7 @@
 #include <errno.h>
 #include <math.h>
 #include <plugins/libplugin-pay.h>
+#include <sodium.h>
 #include <sys/types.h>
 #include <wire/peer_wire.h>
 
@@ -27,6 +32,7 @@ static void init_gossmap(struct plugin *plugin)
 	if (!global_gossmap)
 		plugin_err(plugin, "Could not load gossmap %s: %s",
 			   GOSSIP_STORE_FILENAME, strerror(errno));
+	gossmap_enable_edges(global_gossmap);
 	if (num_channel_updates_rejected)
 		plugin_log(plugin, LOG_DBG,
 			   "gossmap ignored %zu channel updates",
@@ -42,6 +48,18 @@ struct gossmap *get_gossmap(struct plugin *plugin)
 	return global_gossmap;
 }
 
+/* Retries (and other parts of the same size) usually only exclude more
+ * channels than last time, so we keep the last tree and repair it. */
+struct dijkstra_cache {
+	struct dijkstra *dij;
+	u32 dst_idx;
+	struct amount_msat amount;
+	double riskfactor;
+	u64 gossmap_generation;
+	/* Value of root->chanhints_seq when we calculated this. */
+	u64 chanhints_seq;
+};
+
 struct payment *payment_new(tal_t *ctx, struct command *cmd,
 			    struct payment *parent,
 			    struct payment_modifier **mods)
@@ -56,6 +74,7 @@ struct payment *payment_new(tal_t *ctx, struct command *cmd,
 	p->cmd = cmd;
 	p->start_time = time_now();
 	p->result = NULL;
+	p->settled = NULL;
 	p->why = NULL;
 	p->getroute = tal(p, struct getroute_request);
 	p->label = NULL;
@@ -64,7 +83,10 @@ struct payment *payment_new(tal_t *ctx, struct command *cmd,
 	p->abort = false;
 	p->invstring_used = false;
 	p->route = NULL;
+	p->createonion_request = NULL;
+	p->createonion_response = NULL;
 	p->temp_exclusion = NULL;
+	p->chanhints_applied = 0;
 	p->failroute_retry = false;
 	p->routetxt = NULL;
 	p->max_htlcs = UINT32_MAX;
@@ -103,6 +125,8 @@ struct payment *payment_new(tal_t *ctx, struct command *cmd,
 		p->plugin = cmd->plugin;
 		p->channel_hints = tal_arr(p, struct channel_hint, 0);
 		p->excluded_nodes = tal_arr(p, struct node_id, 0);
+		p->dijkstra_cache = NULL;
+		p->chanhints_seq = 0;
 		p->id = next_id++;
 		p->description = NULL;
 		/* Caller must set this.  */
@@ -204,6 +228,10 @@ struct payment_tree_result payment_collect_result(struct payment *p)
 {
 	struct payment_tree_result res;
 	size_t numchildren = tal_count(p->children);
+
+	if (p->settled)
+		return *p->settled;
+
 	res.sent = AMOUNT_MSAT(0);
 	res.attempts = 1;
 	res.treestates = p->step;
@@ -353,6 +381,10 @@ static void channel_hints_update(struct payment *p,
 			}
 			if (htlc_budget != NULL) {
 				assert(hint->local);
+				/* More budget makes cached routes stale */
+				if (*htlc_budget > hint->local->htlc_budget)
+					root->dijkstra_cache
+						= tal_free(root->dijkstra_cache);
 				hint->local->htlc_budget = *htlc_budget;
 				modified = true;
 			}
@@ -397,6 +429,266 @@ static void channel_hints_update(struct payment *p,
 			   &newhint.estimated_capacity));
 }
 
+/* What we've learned about remote channels' liquidity, kept across payments
+ * (and restarts, in the datastore) so each payment doesn't rediscover the same
+ * depleted channels.  Own channels come from listpeerchannels instead. */
+struct liquidity_hint {
+	struct short_channel_id_dir scid;
+	bool enabled;
+	/* Only if enabled */
+	struct amount_msat estimated_capacity;
+	/* When we learned it. */
+	u64 timestamp;
+};
+
+static const struct short_channel_id_dir *
+liquidity_hint_keyof(const struct liquidity_hint *lh)
+{
+	return &lh->scid;
+}
+
+static size_t liquidity_hint_hash(const struct short_channel_id_dir *scidd)
+{
+	struct siphash24_ctx ctx;
+
+	siphash24_init(&ctx, siphash_seed());
+	siphash24_u64(&ctx, scidd->scid.u64);
+	siphash24_u8(&ctx, scidd->dir);
+	return siphash24_done(&ctx);
+}
+
+static bool liquidity_hint_eq(const struct liquidity_hint *lh,
+			      const struct short_channel_id_dir *scidd)
+{
+	return short_channel_id_eq(&lh->scid.scid, &scidd->scid)
+		&& lh->scid.dir == scidd->dir;
+}
+
+HTABLE_DEFINE_TYPE(struct liquidity_hint, liquidity_hint_keyof,
+		   liquidity_hint_hash, liquidity_hint_eq,
+		   liquidity_hint_map);
+
+static struct liquidity_hint_map *liquidity_hints;
+static bool liquidity_hints_dirty;
+
+/* Liquidity moves: after this many seconds we assume a channel has refilled
+ * to its full capacity (linearly), or been re-enabled. */
+#define LIQUIDITY_HINT_LIFETIME (60 * 60)
+
+/* Shared by pay and keysend: each merges with what's stored before saving. */
+#define LIQUIDITY_HINTS_VERSION 1
+#define LIQUIDITY_HINTS_DATASTORE "pay/liquidity"
+
+static struct liquidity_hint_map *liquidity_hints_map(void)
+{
+	if (!liquidity_hints) {
+		liquidity_hints = notleak(tal(NULL, struct liquidity_hint_map));
+		liquidity_hint_map_init(liquidity_hints);
+	}
+	return liquidity_hints;
+}
+
+static struct liquidity_hint *liquidity_hint_get(const struct short_channel_id scid,
+						 int direction)
+{
+	struct liquidity_hint_map *map = liquidity_hints_map();
+	struct short_channel_id_dir scidd;
+	struct liquidity_hint *lh;
+
+	scidd.scid = scid;
+	scidd.dir = direction;
+	lh = liquidity_hint_map_get(map, &scidd);
+	if (lh)
+		return lh;
+
+	lh = tal(map, struct liquidity_hint);
+	lh->scid = scidd;
+	lh->timestamp = 0;
+	liquidity_hint_map_add(map, lh);
+	return lh;
+}
+
+static void liquidity_hint_set(struct liquidity_hint *lh,
+			       bool enabled,
+			       const struct amount_msat *estimated_capacity,
+			       u64 timestamp)
+{
+	lh->enabled = enabled;
+	lh->estimated_capacity = enabled ? *estimated_capacity : AMOUNT_MSAT(0);
+	lh->timestamp = timestamp;
+	liquidity_hints_dirty = true;
+}
+
+/* We learned this from a failure: newer knowledge replaces the old. */
+static void liquidity_hints_learn(const struct short_channel_id scid,
+				  int direction, bool enabled,
+				  const struct amount_msat *estimated_capacity)
+{
+	liquidity_hint_set(liquidity_hint_get(scid, direction),
+			   enabled, estimated_capacity, time_now().ts.tv_sec);
+}
+
+/* Seed a new root payment's channel_hints (with decay), and forget
+ * anything expired. */
+static void liquidity_hints_apply(struct payment *p)
+{
+	struct gossmap *gossmap = get_gossmap(p->plugin);
+	u64 now = time_now().ts.tv_sec;
+	struct liquidity_hint_map_iter it;
+	struct liquidity_hint *lh;
+
+	if (!liquidity_hints)
+		return;
+
+	for (lh = liquidity_hint_map_first(liquidity_hints, &it);
+	     lh;
+	     lh = liquidity_hint_map_next(liquidity_hints, &it)) {
+		const struct gossmap_chan *c;
+		struct amount_sat capacity;
+		struct amount_msat cap, estimate;
+		u64 age = now - lh->timestamp;
+
+		c = gossmap_find_chan(gossmap, &lh->scid.scid);
+		if (!c
+		    || age >= LIQUIDITY_HINT_LIFETIME
+		    || lh->timestamp > now
+		    || !gossmap_chan_get_capacity(gossmap, c, &capacity)
+		    || !amount_sat_to_msat(&cap, capacity)) {
+			liquidity_hint_map_delval(liquidity_hints, &it);
+			tal_free(lh);
+			liquidity_hints_dirty = true;
+			continue;
+		}
+
+		/* A refilled hint stays until it expires, so an older copy
+		 * in the datastore can't override it when we merge. */
+		if (lh->enabled) {
+			/* Refill linearly towards capacity. */
+			struct amount_msat refill;
+			if (!amount_msat_scale(&refill, cap,
+					       (double)age / LIQUIDITY_HINT_LIFETIME)
+			    || !amount_msat_add(&estimate,
+						lh->estimated_capacity,
+						refill))
+				continue;
+			if (amount_msat_greater_eq(estimate, cap))
+				continue;
+		}
+
+		channel_hints_update(p, lh->scid.scid, lh->scid.dir,
+				     lh->enabled, false,
+				     lh->enabled ? &estimate : NULL, NULL);
+	}
+}
+
+/* Merge stored hints into ours: the newer timestamp wins. */
+static void liquidity_hints_merge(const u8 *data)
+{
+	size_t max = tal_bytelen(data);
+
+	if (!data || fromwire_u16(&data, &max) != LIQUIDITY_HINTS_VERSION)
+		return;
+
+	while (data && max) {
+		struct short_channel_id scid;
+		u8 dir;
+		bool enabled;
+		struct amount_msat estimate;
+		u64 timestamp;
+		struct liquidity_hint *lh;
+
+		fromwire_short_channel_id(&data, &max, &scid);
+		dir = fromwire_u8(&data, &max);
+		enabled = fromwire_bool(&data, &max);
+		estimate = fromwire_amount_msat(&data, &max);
+		timestamp = fromwire_u64(&data, &max);
+		if (!data || dir > 1)
+			break;
+
+		lh = liquidity_hint_get(scid, dir);
+		if (lh->timestamp < timestamp)
+			liquidity_hint_set(lh, enabled, &estimate, timestamp);
+	}
+}
+
+static struct command_result *liquidity_hints_merged(struct command *cmd,
+						     const u8 *data,
+						     struct plugin *plugin)
+{
+	struct liquidity_hint_map_iter it;
+	struct liquidity_hint *lh;
+	u8 *out;
+
+	/* The other plugin (pay or keysend) may have saved since we loaded. */
+	liquidity_hints_merge(data);
+
+	out = tal_arr(tmpctx, u8, 0);
+	towire_u16(&out, LIQUIDITY_HINTS_VERSION);
+	for (lh = liquidity_hint_map_first(liquidity_hints_map(), &it);
+	     lh;
+	     lh = liquidity_hint_map_next(liquidity_hints_map(), &it)) {
+		towire_short_channel_id(&out, &lh->scid.scid);
+		towire_u8(&out, lh->scid.dir);
+		towire_bool(&out, lh->enabled);
+		towire_amount_msat(&out, lh->estimated_capacity);
+		towire_u64(&out, lh->timestamp);
+	}
+	jsonrpc_set_datastore_binary(plugin, NULL, LIQUIDITY_HINTS_DATASTORE,
+				     out, "create-or-replace",
+				     NULL, NULL, NULL);
+	liquidity_hints_dirty = false;
+	return command_done();
+}
+
+static void liquidity_hints_save(struct plugin *plugin)
+{
+	if (!liquidity_hints_dirty)
+		return;
+
+	jsonrpc_get_datastore_binary(plugin, NULL, LIQUIDITY_HINTS_DATASTORE,
+				     liquidity_hints_merged, plugin);
+}
+
+static struct command_result *liquidity_hints_loaded(struct command *cmd,
+						     const u8 *data,
+						     void *unused)
+{
+	/* Don't overwrite anything we've learned since starting. */
+	liquidity_hints_merge(data);
+	return command_done();
+}
+
+void liquidity_hints_load(struct plugin *plugin)
+{
+	jsonrpc_get_datastore_binary(plugin, NULL, LIQUIDITY_HINTS_DATASTORE,
+				     liquidity_hints_loaded, NULL);
+}
+
+/* It carried amount just now, so any estimate below that is stale. */
+static void liquidity_hints_carried(const struct short_channel_id scid,
+				    int direction, struct amount_msat amount)
+{
+	struct short_channel_id_dir scidd;
+	struct liquidity_hint *lh;
+
+	if (!liquidity_hints)
+		return;
+
+	scidd.scid = scid;
+	scidd.dir = direction;
+	lh = liquidity_hint_map_get(liquidity_hints, &scidd);
+	if (!lh)
+		return;
+
+	/* We don't remove it: that would let an older copy in the datastore
+	 * resurrect it when we next merge.  Record that it's unlimited. */
+	if (!lh->enabled
+	    || amount_msat_less(lh->estimated_capacity, amount)) {
+		struct amount_msat unlimited = AMOUNT_MSAT(UINT64_MAX);
+		liquidity_hint_set(lh, true, &unlimited, time_now().ts.tv_sec);
+	}
+}
+
 static void payment_exclude_most_expensive(struct payment *p)
 {
 	struct route_hop *e = &p->route[0];
@@ -587,6 +879,13 @@ apply_changes:
 			abort();
 		}
 	}
+
+	if (!remove)
+		p->chanhints_applied = ++root->chanhints_seq;
+	else if (root->dijkstra_cache
+		 && p->chanhints_applied <= root->dijkstra_cache->chanhints_seq)
+		/* This gives back capacity which the cached tree never saw. */
+		root->dijkstra_cache = tal_free(root->dijkstra_cache);
 	return true;
 }
 
@@ -758,6 +1057,56 @@ static u64 route_score(u32 distance,
 	return costs;
 }
 
+/* Dijkstra using payment_route_can_carry and route_score, reusing (and
+ * repairing) the one from the last attempt if we can. */
+static const struct dijkstra *payment_dijkstra(struct gossmap *gossmap,
+					       const struct gossmap_node *src,
+					       const struct gossmap_node *dst,
+					       struct amount_msat amount,
+					       double riskfactor,
+					       struct payment *p)
+{
+	struct payment *root = payment_root(p);
+	struct dijkstra_cache *dc = root->dijkstra_cache;
+	u32 dst_idx = gossmap_node_idx(gossmap, dst);
+
+	/* Temporary exclusions come and go, so they don't only ever get
+	 * stricter. */
+	if (tal_count(p->temp_exclusion) != 0)
+		return dijkstra_to(tmpctx, gossmap, dst, src, amount, riskfactor,
+				   payment_route_can_carry, route_score, p);
+
+	if (dc
+	    && dc->dst_idx == dst_idx
+	    && amount_msat_eq(dc->amount, amount)
+	    && dc->riskfactor == riskfactor
+	    && dc->gossmap_generation == gossmap_generation(gossmap)) {
+		size_t num = dijkstra_repair(dc->dij, gossmap, riskfactor,
+					     payment_route_can_carry,
+					     route_score, p);
+		paymod_log(p, LOG_DBG,
+			   "Reusing previous route search (%zu nodes recalculated)",
+			   num);
+		return dc->dij;
+	}
+
+	tal_free(dc);
+	dc = root->dijkstra_cache = tal(root, struct dijkstra_cache);
+	dc->dst_idx = dst_idx;
+	dc->amount = amount;
+	dc->riskfactor = riskfactor;
+	dc->gossmap_generation = gossmap_generation(gossmap);
+	dc->chanhints_seq = root->chanhints_seq;
+	dc->dij = cast_const(struct dijkstra *,
+			     dijkstra(dc, gossmap, dst, amount, riskfactor,
+				      payment_route_can_carry, route_score, p));
+	return dc->dij;
+}
+
+/* Note that shards are routed one at a time, on purpose: each route
+ * found is applied to the channel hints (payment_chanhints_apply_route)
+ * before the next shard looks, so they don't all pile onto the same
+ * channels.  dijkstra() also keeps its heap state in globals. */
 static struct route_hop *route(const tal_t *ctx,
 			       struct gossmap *gossmap,
 			       const struct gossmap_node *src,
@@ -778,15 +1127,14 @@ static struct route_hop *route(const tal_t *ctx,
 			  struct payment *);
 
 	can_carry = payment_route_can_carry;
-	dij = dijkstra(tmpctx, gossmap, dst, amount, riskfactor,
-		       can_carry, route_score, p);
+	dij = payment_dijkstra(gossmap, src, dst, amount, riskfactor, p);
 	r = route_from_dijkstra(ctx, gossmap, dij, src, amount, final_delay);
 	if (!r) {
 		/* Try using disabled channels too */
 		/* FIXME: is there somewhere we can annotate this for paystatus? */
 		can_carry = payment_route_can_carry_even_disabled;
-		dij = dijkstra(tmpctx, gossmap, dst, amount, riskfactor,
-			       can_carry, route_score, p);
+		dij = dijkstra_to(tmpctx, gossmap, dst, src, amount, riskfactor,
+				  can_carry, route_score, p);
 		r = route_from_dijkstra(ctx, gossmap, dij, src,
 					amount, final_delay);
 		if (!r) {
@@ -799,8 +1147,8 @@ static struct route_hop *route(const tal_t *ctx,
 	if (tal_count(r) > max_hops) {
 		tal_free(r);
 		/* FIXME: is there somewhere we can annotate this for paystatus? */
-		dij = dijkstra(tmpctx, gossmap, dst, amount, riskfactor,
-			       can_carry, route_score_shorter, p);
+		dij = dijkstra_to(tmpctx, gossmap, dst, src, amount, riskfactor,
+				  can_carry, route_score_shorter, p);
 		r = route_from_dijkstra(ctx, gossmap, dij, src,
 					amount, final_delay);
 		if (!r) {
@@ -1301,6 +1649,9 @@ handle_intermediate_failure(struct command *cmd,
 		channel_hints_update(root, errchan->scid,
 				     errchan->direction, false, false, NULL,
 				     NULL);
+		if (errchan != &p->route[0])
+			liquidity_hints_learn(errchan->scid, errchan->direction,
+					      false, NULL);
 		break;
 
 	case WIRE_TEMPORARY_CHANNEL_FAILURE: {
@@ -1318,6 +1669,9 @@ handle_intermediate_failure(struct command *cmd,
 		channel_hints_update(root, errchan->scid,
 				     errchan->direction, true, false,
 				     &estimated, NULL);
+		if (errchan != &p->route[0])
+			liquidity_hints_learn(errchan->scid, errchan->direction,
+					      true, &estimated);
 		goto error;
 	}
 
@@ -1821,6 +2175,8 @@ static void payment_finished(struct payment *p);
 static bool payment_is_finished(const struct payment *p)
 {
 top:
+	if (p->settled)
+		return true;
 	if (p->step == PAYMENT_STEP_FAILED || p->step == PAYMENT_STEP_SUCCESS || p->abort)
 		return true;
 	else if (p->step == PAYMENT_STEP_SPLIT || p->step == PAYMENT_STEP_RETRY) {
@@ -1849,6 +2205,9 @@ static enum payment_step payment_aggregate_states(struct payment *p)
 {
 	enum payment_step agg = p->step;
 
+	if (p->settled)
+		return p->settled->treestates;
+
 	for (size_t i=0; i<tal_count(p->children); i++)
 		agg |= payment_aggregate_states(p->children[i]);
 
@@ -1934,6 +2293,23 @@ static void payment_notify_failure(struct payment *p, const char *error_message)
 	plugin_notification_end(p->plugin, n);
 }
 
+/* A failed attempt has applied what it learned to the channel hints by
+ * now: all we still need of it is its result, for paystatus and the
+ * attempts in our reply.  Drop the rest, since big MPP payments can have
+ * hundreds of these. */
+static void payment_compact_failed(struct payment *p)
+{
+	p->route = tal_free(p->route);
+	p->createonion_request = tal_free(p->createonion_request);
+	p->createonion_response = tal_free(p->createonion_response);
+
+	/* Some modifiers share their parent's data rather than copying it */
+	for (size_t i = 0; i < tal_count(p->modifier_data); i++) {
+		if (tal_parent(p->modifier_data[i]) == p)
+			p->modifier_data[i] = tal_free(p->modifier_data[i]);
+	}
+}
+
 /* This function is called whenever a payment ends up in a final state, or all
  * leafs in the subtree rooted in the payment are all in a final state. It is
  * called only once, and it is guaranteed to be called in post-order
@@ -1952,10 +2328,22 @@ static void payment_finished(struct payment *p)
 	assert((result.leafstates & PAYMENT_STEP_SUCCESS) == 0 ||
 	       result.preimage != NULL);
 
+	/* If every leaf below us is done, this result is final (we can be
+	 * called early with pending children, when aborting). */
+	if (!p->settled
+	    && (result.leafstates
+		& ~(PAYMENT_STEP_FAILED | PAYMENT_STEP_SUCCESS)) == 0) {
+		p->settled = tal_dup(p, struct payment_tree_result, &result);
+		if (p->parent != NULL && p->step == PAYMENT_STEP_FAILED
+		    && tal_count(p->children) == 0)
+			payment_compact_failed(p);
+	}
+
 	if (p->parent == NULL) {
 		/* We are about to reply, unset the pointer to the cmd so we
 		 * don't attempt to return a response twice. */
 		p->cmd = NULL;
+		liquidity_hints_save(p->plugin);
 		if (cmd == NULL) {
 			/* This is the tree root, but we already reported
 			 * success or failure, so noop. */
@@ -2409,6 +2797,9 @@ static void local_channel_hints_cb(void *d UNUSED, struct payment *p)
 	if (p->parent != NULL || p->step != PAYMENT_STEP_INITIALIZED)
 		return payment_continue(p);
 
+	/* Start with what previous payments learned about the network. */
+	liquidity_hints_apply(p);
+
 	req = jsonrpc_request_start(p->plugin, NULL, "listpeerchannels",
 				    local_channel_hints_listpeerchannels,
 				    local_channel_hints_listpeerchannels, p);
@@ -2496,9 +2887,9 @@ static struct route_info **filter_routehints(struct gossmap *map,
 		}
 
 		distance = dijkstra_distance(
-		    dijkstra(tmpctx, map, entrynode, AMOUNT_MSAT(1), 1,
-			     payment_route_can_carry_even_disabled,
-			     route_score_cheaper, p),
+		    dijkstra_to(tmpctx, map, entrynode, src, AMOUNT_MSAT(1), 1,
+				payment_route_can_carry_even_disabled,
+				route_score_cheaper, p),
 		    gossmap_node_idx(map, src));
 
 		if (distance == UINT_MAX) {
@@ -2738,10 +3129,10 @@ static void routehint_check_reachable(struct payment *p)
 	if (dst == NULL)
 		d->destination_reachable = false;
 	else if (src != NULL) {
-		dij = dijkstra(tmpctx, gossmap, dst, AMOUNT_MSAT(1000),
-			       10 / 1000000.0,
-			       payment_route_can_carry_even_disabled,
-			       route_score_cheaper, p);
+		dij = dijkstra_to(tmpctx, gossmap, dst, src, AMOUNT_MSAT(1000),
+				  10 / 1000000.0,
+				  payment_route_can_carry_even_disabled,
+				  route_score_cheaper, p);
 		r = route_from_dijkstra(tmpctx, gossmap, dij, src,
 					AMOUNT_MSAT(1000), 0);
 
@@ -3539,6 +3930,34 @@ static struct amount_msat fuzzed_near(struct amount_msat target,
 	return res;
 }
 
+/* Start a child of p to pay part of its amount. */
+static void payment_start_part(struct payment *p, struct amount_msat amount,
+			       char **partids)
+{
+	double multiplier;
+	struct payment *c = payment_new(p, NULL, p, p->modifiers);
+
+	c->amount = amount;
+
+	/* Now adjust the constraints so we don't multiply them
+	 * when splitting. */
+	multiplier = amount_msat_ratio(c->amount, p->amount);
+	if (!amount_msat_scale(&c->constraints.fee_budget,
+			       c->constraints.fee_budget,
+			       multiplier))
+		abort(); /* multiplier < 1! */
+	payment_start(c);
+	/* Why the wordy "new partid n" that we repeat for
+	 * each payment?
+	 * So that you can search the logs for the
+	 * creation of a partid by just "new partid n".
+	 */
+	if (streq(*partids, ""))
+		tal_append_fmt(partids, "new partid %"PRIu32, c->partid);
+	else
+		tal_append_fmt(partids, ", new partid %"PRIu32, c->partid);
+}
+
 static void presplit_cb(struct presplit_mod_data *d, struct payment *p)
 {
 	struct payment *root = payment_root(p);
@@ -3615,40 +4034,19 @@ static void presplit_cb(struct presplit_mod_data *d, struct payment *p)
 		/* Ok, we know we should split, so split here and then skip this
 		 * payment and start the children instead. */
 		while (!amount_msat_eq(amt, AMOUNT_MSAT(0))) {
-			double multiplier;
-
-			struct payment *c =
-			    payment_new(p, NULL, p, p->modifiers);
-
 			/* Get ~ target, but don't exceed amt */
-			c->amount = fuzzed_near(target, amt);
+			struct amount_msat part = fuzzed_near(target, amt);
 
-			if (!amount_msat_sub(&amt, amt, c->amount))
+			if (!amount_msat_sub(&amt, amt, part))
 				paymod_err(
 				    p,
 				    "Cannot subtract %s from %s in splitter",
 				    type_to_string(tmpctx, struct amount_msat,
-						   &c->amount),
+						   &part),
 				    type_to_string(tmpctx, struct amount_msat,
 						   &amt));
 
-			/* Now adjust the constraints so we don't multiply them
-			 * when splitting. */
-			multiplier = amount_msat_ratio(c->amount, p->amount);
-			if (!amount_msat_scale(&c->constraints.fee_budget,
-					       c->constraints.fee_budget,
-					       multiplier))
-				abort(); /* multiplier < 1! */
-			payment_start(c);
-			/* Why the wordy "new partid n" that we repeat for
-			 * each payment?
-			 * So that you can search the logs for the
-			 * creation of a partid by just "new partid n".
-			 */
-			if (count == 0)
-				tal_append_fmt(&partids, "new partid %"PRIu32, c->partid);
-			else
-				tal_append_fmt(&partids, ", new partid %"PRIu32, c->partid);
+			payment_start_part(p, part, &partids);
 			count++;
 		}
 
@@ -3814,6 +4212,210 @@ static void adaptive_splitter_cb(struct adaptive_split_mod_data *d, struct payme
 REGISTER_PAYMENT_MODIFIER(adaptive_splitter, struct adaptive_split_mod_data *,
 			  adaptive_splitter_data_init, adaptive_splitter_cb);
 
+/*****************************************************************************
+ * flowsplit -- Split the payment along a flow through the network.
+ *
+ * Rather than splitting into fixed sizes and letting the adaptive splitter
+ * find out what fits, this (optional) modifier picks the parts up front.
+ * It repeatedly finds the best route (route_score already includes the
+ * linearized uncertainty cost) among channels with estimated capacity left,
+ * sends as much as the narrowest channel on it should take, and deducts that
+ * from every channel on the route: a greedy successive-shortest-path
+ * min-cost flow.  If that doesn't cover the amount within our HTLC budget
+ * we leave it to presplit.
+ */
+
+static struct flowsplit_mod_data *flowsplit_data_init(struct payment *p)
+{
+	struct flowsplit_mod_data *d;
+	if (p->parent == NULL) {
+		d = tal(p, struct flowsplit_mod_data);
+		d->disable = true;
+		return d;
+	} else {
+		return payment_mod_flowsplit_get_data(p->parent);
+	}
+}
+
+struct flowsplit_ctx {
+	struct payment *p;
+	/* Estimated capacity still unused, indexed by 2 * chan_idx + dir
+	 * (-1ULL if we haven't looked yet). */
+	u64 *residual;
+};
+
+static u64 *flowsplit_residual(const struct gossmap *map,
+			       const struct gossmap_chan *c,
+			       int dir,
+			       struct flowsplit_ctx *fc)
+{
+	u64 *r = &fc->residual[gossmap_chan_idx(map, c) * 2 + dir];
+
+	if (*r == -1ULL) {
+		struct short_channel_id scid = gossmap_chan_scid(map, c);
+		const struct channel_hint *hint;
+		struct amount_sat capacity;
+
+		hint = find_hint(payment_root(fc->p)->channel_hints,
+				 &scid, dir);
+		if (hint)
+			*r = hint->estimated_capacity.millisatoshis; /* Raw: flow */
+		else if (gossmap_chan_get_capacity(map, c, &capacity))
+			/* If the liquidity is uniformly distributed, half
+			 * the capacity gets through half the time. */
+			*r = capacity.satoshis * 1000 / 2; /* Raw: flow */
+		else
+			*r = 0;
+
+		if (*r > fp16_to_u64(c->half[dir].htlc_max))
+			*r = fp16_to_u64(c->half[dir].htlc_max);
+	}
+	return r;
+}
+
+static bool flowsplit_can_carry(const struct gossmap *map,
+				const struct gossmap_chan *c,
+				int dir,
+				struct amount_msat amount,
+				struct flowsplit_ctx *fc)
+{
+	if (amount.millisatoshis > *flowsplit_residual(map, c, dir, fc)) /* Raw: flow */
+		return false;
+
+	return payment_route_can_carry(map, c, dir, amount, fc->p);
+}
+
+/* Returns up to max_parts amounts which add up to p->amount, or NULL. */
+static struct amount_msat *flowsplit_parts(const tal_t *ctx,
+					   struct payment *p,
+					   size_t max_parts)
+{
+	struct gossmap *gossmap = get_gossmap(p->plugin);
+	const struct gossmap_node *src, *dst;
+	double riskfactor = p->getroute->riskfactorppm / 1000000.0;
+	struct amount_msat remaining = p->amount, *parts;
+	struct flowsplit_ctx fc;
+
+	src = gossmap_find_node(gossmap, p->local_id);
+	dst = gossmap_find_node(gossmap, p->getroute->destination);
+	if (!src || !dst)
+		return NULL;
+
+	fc.p = p;
+	fc.residual = tal_arr(tmpctx, u64, gossmap_max_chan_idx(gossmap) * 2);
+	memset(fc.residual, 0xFF, tal_bytelen(fc.residual));
+
+	parts = tal_arr(ctx, struct amount_msat, 0);
+	while (!amount_msat_zero(remaining)) {
+		const struct dijkstra *dij;
+		struct route_hop *r;
+		struct amount_msat want, part;
+		u64 fee;
+
+		if (tal_count(parts) == max_parts)
+			return tal_free(parts);
+
+		/* Look for a route which can take its share of the rest. */
+		want = amount_msat_div(remaining,
+				       max_parts - tal_count(parts));
+		if (amount_msat_less(want, MPP_ADAPTIVE_LOWER_LIMIT))
+			want = MPP_ADAPTIVE_LOWER_LIMIT;
+		if (amount_msat_greater(want, remaining))
+			want = remaining;
+
+		dij = dijkstra_to(tmpctx, gossmap, dst, src, want, riskfactor,
+				  flowsplit_can_carry, route_score, &fc);
+		r = route_from_dijkstra(tmpctx, gossmap, dij, src, want, 0);
+		if (!r)
+			return tal_free(parts);
+
+		/* We can send as much as the narrowest channel takes (less
+		 * the fees from there on, which we assume are the same). */
+		part = remaining;
+		for (size_t i = 0; i < tal_count(r); i++) {
+			const struct gossmap_chan *c
+				= gossmap_find_chan(gossmap, &r[i].scid);
+			u64 *residual = flowsplit_residual(gossmap, c,
+							   r[i].direction,
+							   &fc);
+			fee = r[i].amount.millisatoshis - want.millisatoshis; /* Raw: flow */
+			if (*residual - fee < part.millisatoshis) /* Raw: flow */
+				part.millisatoshis = *residual - fee; /* Raw: flow */
+		}
+
+		for (size_t i = 0; i < tal_count(r); i++) {
+			const struct gossmap_chan *c
+				= gossmap_find_chan(gossmap, &r[i].scid);
+			u64 *residual = flowsplit_residual(gossmap, c,
+							   r[i].direction,
+							   &fc);
+			fee = r[i].amount.millisatoshis - want.millisatoshis; /* Raw: flow */
+			*residual -= part.millisatoshis + fee; /* Raw: flow */
+		}
+
+		tal_arr_expand(&parts, part);
+		if (!amount_msat_sub(&remaining, remaining, part))
+			abort();
+	}
+	return parts;
+}
+
+static void flowsplit_cb(struct flowsplit_mod_data *d, struct payment *p)
+{
+	struct amount_msat *parts;
+	char *partids;
+	u32 htlcs;
+
+	if (d->disable || p->parent != NULL || !payment_supports_mpp(p)
+	    || p->step != PAYMENT_STEP_INITIALIZED)
+		return payment_continue(p);
+
+	/* Not worth splitting: presplit wouldn't either. */
+	if (amount_msat_less_eq(p->amount, amount_msat(MPP_TARGET_SIZE)))
+		return payment_continue(p);
+
+	/* Same HTLC budget as presplit, so adaptive_splitter has room. */
+	htlcs = payment_max_htlcs(p);
+	if (htlcs >= PRESPLIT_MAX_HTLC_SHARE)
+		htlcs /= PRESPLIT_MAX_HTLC_SHARE;
+	if (htlcs > PRESPLIT_MAX_SPLITS)
+		htlcs = PRESPLIT_MAX_SPLITS;
+	if (htlcs == 0)
+		return payment_continue(p);
+
+	parts = flowsplit_parts(tmpctx, p, htlcs);
+	if (!parts) {
+		paymod_log(p, LOG_DBG,
+			   "Could not find a flow for %s in %u parts,"
+			   " leaving it to presplit",
+			   type_to_string(tmpctx, struct amount_msat,
+					  &p->amount),
+			   htlcs);
+		return payment_continue(p);
+	}
+
+	/* Opt in to MPP: see presplit_cb */
+	payment_root(p)->partid++;
+	payment_root(p)->next_partid++;
+
+	payment_set_step(p, PAYMENT_STEP_SPLIT);
+	partids = tal_strdup(tmpctx, "");
+	for (size_t i = 0; i < tal_count(parts); i++)
+		payment_start_part(p, parts[i], &partids);
+
+	p->result = NULL;
+	p->route = NULL;
+	p->why = tal_fmt(p,
+			 "Split into %zu sub-payments using estimated "
+			 "channel capacities",
+			 tal_count(parts));
+	paymod_log(p, LOG_INFORM, "%s: %s", p->why, partids);
+	payment_continue(p);
+}
+
+REGISTER_PAYMENT_MODIFIER(flowsplit, struct flowsplit_mod_data *,
+			  flowsplit_data_init, flowsplit_cb);
+
 
 /*****************************************************************************
  * payee_incoming_limit
@@ -4006,3 +4608,225 @@ static void route_exclusions_step_cb(struct route_exclusions_data *d,
 
 REGISTER_PAYMENT_MODIFIER(route_exclusions, struct route_exclusions_data *,
 	route_exclusions_data_init, route_exclusions_step_cb);
+
+/* A probe is an HTLC with a random payment_hash: the destination can't claim
+ * it, and how far it got tells us about the liquidity of the channels on the
+ * way.  Unlike a payment, there's no retrying: we want this route's answer. */
+struct probe {
+	struct probe_batch *batch;
+	struct node_id destination;
+	struct amount_msat amount;
+	struct sha256 payment_hash;
+	struct route_hop *route;
+	/* Set once it's finished */
+	const char *status;
+	struct payment_result *result;
+};
+
+struct probe_batch {
+	struct command *cmd;
+	const struct node_id *local_id;
+	struct probe *probes;
+	/* Next probe to send, and how many are outstanding. */
+	size_t next, inflight, maxinflight;
+	u32 final_cltv;
+};
+
+static struct command_result *probe_batch_done(struct probe_batch *b)
+{
+	struct json_stream *js;
+
+	liquidity_hints_save(b->cmd->plugin);
+
+	js = jsonrpc_stream_success(b->cmd);
+	json_array_start(js, "probes");
+	for (size_t i = 0; i < tal_count(b->probes); i++) {
+		const struct probe *pr = &b->probes[i];
+		const struct payment_result *r = pr->result;
+
+		json_object_start(js, NULL);
+		json_add_node_id(js, "destination", &pr->destination);
+		json_add_amount_msat_only(js, "amount_msat", pr->amount);
+		json_add_string(js, "status", pr->status);
+		if (pr->route)
+			json_add_num(js, "hops", tal_count(pr->route));
+		if (r && r->erring_index)
+			json_add_u32(js, "erring_index", *r->erring_index);
+		if (r && r->erring_channel)
+			json_add_short_channel_id(js, "erring_channel",
+						  r->erring_channel);
+		if (r && r->erring_direction)
+			json_add_num(js, "erring_direction",
+				     *r->erring_direction);
+		if (r && r->failcodename)
+			json_add_string(js, "failcodename", r->failcodename);
+		json_object_end(js);
+	}
+	json_array_end(js);
+	return command_finished(b->cmd, js);
+}
+
+static bool probe_send(struct probe *pr);
+
+/* Keep up to maxinflight probes outstanding, until we're done. */
+static struct command_result *probe_next(struct probe_batch *b)
+{
+	while (b->inflight < b->maxinflight
+	       && b->next < tal_count(b->probes)) {
+		if (probe_send(&b->probes[b->next++]))
+			b->inflight++;
+	}
+
+	if (b->inflight == 0)
+		return probe_batch_done(b);
+	return command_still_pending(b->cmd);
+}
+
+static struct command_result *probe_finished(struct probe *pr,
+					     const char *status)
+{
+	pr->status = status;
+	pr->batch->inflight--;
+	return probe_next(pr->batch);
+}
+
+static struct command_result *probe_result(struct command *cmd,
+					   const char *buffer,
+					   const jsmntok_t *toks,
+					   struct probe *pr)
+{
+	size_t n = tal_count(pr->route);
+	struct route_hop *errchan;
+	struct amount_msat estimated;
+	u32 erring_index;
+
+	pr->result = tal_sendpay_result_from_json(pr->batch->probes, buffer,
+						  toks);
+	if (!pr->result || !pr->result->erring_index)
+		return probe_finished(pr, "failed");
+
+	/* Everything before the node which failed carried it (we don't
+	 * remember our own channels, though: see liquidity_hints). */
+	erring_index = *pr->result->erring_index;
+	for (size_t i = 1; i < erring_index && i < n; i++)
+		liquidity_hints_carried(pr->route[i].scid,
+					pr->route[i].direction,
+					pr->route[i].amount);
+
+	if (erring_index == n) {
+		if (pr->result->failcode == WIRE_INCORRECT_OR_UNKNOWN_PAYMENT_DETAILS)
+			return probe_finished(pr, "reachable");
+		return probe_finished(pr, "failed");
+	}
+
+	if (erring_index == 0 || erring_index > n)
+		return probe_finished(pr, "failed");
+
+	/* Same as handle_intermediate_failure */
+	errchan = &pr->route[erring_index];
+	switch (pr->result->failcode) {
+	case WIRE_PERMANENT_CHANNEL_FAILURE:
+	case WIRE_CHANNEL_DISABLED:
+	case WIRE_UNKNOWN_NEXT_PEER:
+	case WIRE_REQUIRED_CHANNEL_FEATURE_MISSING:
+		liquidity_hints_learn(errchan->scid, errchan->direction,
+				      false, NULL);
+		break;
+	case WIRE_TEMPORARY_CHANNEL_FAILURE:
+		if (!amount_msat_sub(&estimated, errchan->amount,
+				     AMOUNT_MSAT(1)))
+			abort();
+		liquidity_hints_learn(errchan->scid, errchan->direction,
+				      true, &estimated);
+		break;
+	default:
+		break;
+	}
+	return probe_finished(pr, "failed");
+}
+
+static struct command_result *probe_sent(struct command *cmd,
+					 const char *buffer,
+					 const jsmntok_t *toks,
+					 struct probe *pr)
+{
+	struct out_req *req;
+
+	req = jsonrpc_request_start(cmd->plugin, cmd, "waitsendpay",
+				    probe_result, probe_result, pr);
+	json_add_sha256(req->js, "payment_hash", &pr->payment_hash);
+	return send_outreq(cmd->plugin, req);
+}
+
+/* Returns false (having set the status) if we couldn't send it at all. */
+static bool probe_send(struct probe *pr)
+{
+	struct probe_batch *b = pr->batch;
+	struct plugin *plugin = b->cmd->plugin;
+	struct gossmap *gossmap = get_gossmap(plugin);
+	const struct gossmap_node *src, *dst;
+	const struct dijkstra *dij;
+	struct out_req *req;
+
+	src = gossmap_find_node(gossmap, b->local_id);
+	dst = gossmap_find_node(gossmap, &pr->destination);
+	if (!src || !dst || src == dst) {
+		pr->status = "noroute";
+		return false;
+	}
+
+	/* We want to know about the route a payment would take. */
+	dij = dijkstra_to(tmpctx, gossmap, dst, src, pr->amount, 10.0,
+			  route_can_carry, route_score_cheaper, NULL);
+	pr->route = route_from_dijkstra(b->probes, gossmap, dij, src,
+					pr->amount, b->final_cltv);
+	if (!pr->route || tal_count(pr->route) > ROUTING_MAX_HOPS) {
+		pr->route = tal_free(pr->route);
+		pr->status = "noroute";
+		return false;
+	}
+
+	randombytes_buf(&pr->payment_hash, sizeof(pr->payment_hash));
+	req = jsonrpc_request_start(plugin, b->cmd, "sendpay",
+				    probe_sent, probe_result, pr);
+	json_array_start(req->js, "route");
+	for (size_t i = 0; i < tal_count(pr->route); i++) {
+		json_object_start(req->js, NULL);
+		json_add_node_id(req->js, "id", &pr->route[i].node_id);
+		json_add_short_channel_id(req->js, "channel",
+					  &pr->route[i].scid);
+		json_add_num(req->js, "direction", pr->route[i].direction);
+		json_add_amount_msat_only(req->js, "amount_msat",
+					  pr->route[i].amount);
+		json_add_num(req->js, "delay", pr->route[i].delay);
+		json_object_end(req->js);
+	}
+	json_array_end(req->js);
+	json_add_sha256(req->js, "payment_hash", &pr->payment_hash);
+	send_outreq(plugin, req);
+	return true;
+}
+
+struct command_result *probe_targets(struct command *cmd,
+				     const struct node_id *local_id,
+				     const struct probe_target *targets,
+				     size_t maxinflight, u32 final_cltv)
+{
+	struct probe_batch *b = tal(cmd, struct probe_batch);
+
+	b->cmd = cmd;
+	b->local_id = local_id;
+	b->next = b->inflight = 0;
+	b->maxinflight = maxinflight;
+	b->final_cltv = final_cltv;
+	b->probes = tal_arr(b, struct probe, tal_count(targets));
+	for (size_t i = 0; i < tal_count(targets); i++) {
+		b->probes[i].batch = b;
+		b->probes[i].destination = targets[i].destination;
+		b->probes[i].amount = targets[i].amount;
+		b->probes[i].route = NULL;
+		b->probes[i].status = NULL;
+		b->probes[i].result = NULL;
+	}
+	return probe_next(b);
+}
@@ -260,8 +260,22 @@ struct payment {
 	/* Optional temporarily excluded channels/nodes (i.e. this routehint) */
 	struct node_id *temp_exclusion;
 
+	/* Last route search, so retries can repair it rather than
+	 * starting from scratch (root only). */
+	struct dijkstra_cache *dijkstra_cache;
+
+	/* Counts applications of routes to channel_hints (root only) */
+	u64 chanhints_seq;
+
+	/* What chanhints_seq was when we applied our route. */
+	u64 chanhints_applied;
+
 	struct payment_result *result;
 
+	/* Once nothing in this subtree can change any more, its
+	 * payment_collect_result(), so we don't walk it again. */
+	struct payment_tree_result *settled;
+
 	/* Did something happen that will cause all future attempts to fail?
 	 * This usually means that the final node reported that it can't be
 	 * reached, or in MPP payments there are no more paths we can
@@ -426,6 +440,10 @@ struct adaptive_split_mod_data {
 	u32 htlc_budget;
 };
 
+struct flowsplit_mod_data {
+	bool disable;
+};
+
 struct route_exclusions_data {
 	struct route_exclusion **exclusions;
 };
@@ -439,6 +457,8 @@ REGISTER_PAYMENT_MODIFIER_HEADER(directpay, struct direct_pay_data);
 extern struct payment_modifier waitblockheight_pay_mod;
 REGISTER_PAYMENT_MODIFIER_HEADER(presplit, struct presplit_mod_data);
 REGISTER_PAYMENT_MODIFIER_HEADER(adaptive_splitter, struct adaptive_split_mod_data);
+/* Disabled by default: splits using estimated capacities instead of presplit. */
+REGISTER_PAYMENT_MODIFIER_HEADER(flowsplit, struct flowsplit_mod_data);
 
 /* For the root payment we can seed the channel_hints with the result from
  * `listpeers`, hence avoid channels that we know have insufficient capacity
@@ -487,4 +507,20 @@ struct payment_tree_result payment_collect_result(struct payment *p);
 /* For special effects, like inspecting your own routes. */
 struct gossmap *get_gossmap(struct plugin *plugin);
 
+/* Load channel liquidity learned by previous runs (call from init). */
+void liquidity_hints_load(struct plugin *plugin);
+
+struct probe_target {
+	struct node_id destination;
+	struct amount_msat amount;
+};
+
+/* Send an HTLC nobody can claim to each target (at most maxinflight at a
+ * time) and learn channel liquidity from how far each one gets.  Completes
+ * cmd with the results. */
+struct command_result *probe_targets(struct command *cmd,
+				     const struct node_id *local_id,
+				     const struct probe_target *targets,
+				     size_t maxinflight, u32 final_cltv);
+
 #endif /* LIGHTNING_PLUGINS_LIBPLUGIN_PAY_H */
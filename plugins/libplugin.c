@@ -49,7 +49,7 @@ struct plugin {
 
 	/* To read from lightningd */
 	char *buffer;
-	size_t used, len_read;
+	size_t used, len_read, read_offset;
 	jsmn_parser parser;
 	jsmntok_t *toks;
 
@@ -1040,23 +1040,35 @@ static bool rpc_read_response_one(struct plugin *plugin)
 	return true;
 
 compact:
-	memmove(plugin->rpc_buffer, plugin->rpc_buffer + plugin->rpc_read_offset,
-		plugin->rpc_used - plugin->rpc_read_offset);
-	plugin->rpc_used -= plugin->rpc_read_offset;
-	plugin->rpc_read_offset = 0;
+	/* Don't shuffle a large partial response on every read! */
+	if (plugin->rpc_read_offset) {
+		memmove(plugin->rpc_buffer,
+			plugin->rpc_buffer + plugin->rpc_read_offset,
+			plugin->rpc_used - plugin->rpc_read_offset);
+		plugin->rpc_used -= plugin->rpc_read_offset;
+		plugin->rpc_read_offset = 0;
+	}
 	return false;
 }
 
 static struct io_plan *rpc_conn_read_response(struct io_conn *conn,
 					      struct plugin *plugin)
 {
+	/* Our JSON parser restarts a partial token from its start, so a
+	 * giant response (e.g. a 2MB hex string) would be re-parsed on
+	 * every read.  A response can't complete without a '}' though. */
+	bool have_full = memchr(plugin->rpc_buffer + plugin->rpc_used, '}',
+				plugin->rpc_len_read);
+
 	plugin->rpc_used += plugin->rpc_len_read;
 	if (plugin->rpc_used == tal_count(plugin->rpc_buffer))
 		tal_resize(&plugin->rpc_buffer, plugin->rpc_used * 2);
 
 	/* Read and process all messages from the connection */
-	while (rpc_read_response_one(plugin))
-		;
+	if (have_full) {
+		while (rpc_read_response_one(plugin))
+			;
+	}
 
 	/* Read more, if there is. */
 	return io_read_partial(plugin->io_rpc_conn,
@@ -1537,29 +1549,30 @@ void plugin_set_memleak_handler(struct plugin *plugin,
 static void ld_command_handle(struct plugin *plugin,
 			      const jsmntok_t *toks)
 {
+	const char *buf = plugin->buffer + plugin->read_offset;
 	const jsmntok_t *methtok, *paramstok, *filtertok;
 	struct command *cmd;
 
-	methtok = json_get_member(plugin->buffer, toks, "method");
-	paramstok = json_get_member(plugin->buffer, toks, "params");
-	filtertok = json_get_member(plugin->buffer, toks, "filter");
+	methtok = json_get_member(buf, toks, "method");
+	paramstok = json_get_member(buf, toks, "params");
+	filtertok = json_get_member(buf, toks, "filter");
 
 	if (!methtok || !paramstok)
 		plugin_err(plugin, "Malformed JSON-RPC notification missing "
 			   "\"method\" or \"params\": %.*s",
 			   json_tok_full_len(toks),
-			   json_tok_full(plugin->buffer, toks));
+			   json_tok_full(buf, toks));
 
 	cmd = tal(plugin, struct command);
 	cmd->plugin = plugin;
 	cmd->usage_only = false;
 	cmd->filter = NULL;
-	cmd->methodname = json_strdup(cmd, plugin->buffer, methtok);
-	cmd->id = json_get_id(cmd, plugin->buffer, toks);
+	cmd->methodname = json_strdup(cmd, buf, methtok);
+	cmd->id = json_get_id(cmd, buf, toks);
 
 	if (!plugin->manifested) {
 		if (streq(cmd->methodname, "getmanifest")) {
-			handle_getmanifest(cmd, plugin->buffer, paramstok);
+			handle_getmanifest(cmd, buf, paramstok);
 			plugin->manifested = true;
 			return;
 		}
@@ -1569,7 +1582,7 @@ static void ld_command_handle(struct plugin *plugin,
 
 	if (!plugin->initialized) {
 		if (streq(cmd->methodname, "init")) {
-			handle_init(cmd, plugin->buffer, paramstok);
+			handle_init(cmd, buf, paramstok);
 			plugin->initialized = true;
 			return;
 		}
@@ -1588,7 +1601,7 @@ static void ld_command_handle(struct plugin *plugin,
 			if (streq(cmd->methodname,
 				  plugin->notif_subs[i].name)) {
 				plugin->notif_subs[i].handle(cmd,
-							     plugin->buffer,
+							     buf,
 							     paramstok);
 				return;
 			}
@@ -1602,13 +1615,13 @@ static void ld_command_handle(struct plugin *plugin,
 
 		plugin_err(plugin, "Unregistered notification %.*s",
 			   json_tok_full_len(methtok),
-			   json_tok_full(plugin->buffer, methtok));
+			   json_tok_full(buf, methtok));
 	}
 
 	for (size_t i = 0; i < plugin->num_hook_subs; i++) {
 		if (streq(cmd->methodname, plugin->hook_subs[i].name)) {
 			plugin->hook_subs[i].handle(cmd,
-						    plugin->buffer,
+						    buf,
 						    paramstok);
 			return;
 		}
@@ -1616,7 +1629,7 @@ static void ld_command_handle(struct plugin *plugin,
 
 	if (filtertok) {
 		/* On error, this fails cmd */
-		if (parse_filter(cmd, "filter", plugin->buffer, filtertok)
+		if (parse_filter(cmd, "filter", buf, filtertok)
 		    != NULL)
 			return;
 	}
@@ -1624,7 +1637,7 @@ static void ld_command_handle(struct plugin *plugin,
 	for (size_t i = 0; i < plugin->num_commands; i++) {
 		if (streq(cmd->methodname, plugin->commands[i].name)) {
 			plugin->commands[i].handle(cmd,
-						   plugin->buffer,
+						   buf,
 						   paramstok);
 			return;
 		}
@@ -1642,23 +1655,25 @@ static bool ld_read_json_one(struct plugin *plugin)
 	bool complete;
 
 	if (!json_parse_input(&plugin->parser, &plugin->toks,
-			      plugin->buffer, plugin->used,
+			      plugin->buffer + plugin->read_offset,
+			      plugin->used - plugin->read_offset,
 			      &complete)) {
 		plugin_err(plugin, "Failed to parse JSON response '%.*s'",
-			   (int)plugin->used, plugin->buffer);
+			   (int)(plugin->used - plugin->read_offset),
+			   plugin->buffer + plugin->read_offset);
 		return false;
 	}
 
 	if (!complete) {
 		/* We need more. */
-		return false;
+		goto compact;
 	}
 
 	/* Empty buffer? (eg. just whitespace). */
 	if (tal_count(plugin->toks) == 1) {
 		toks_reset(plugin->toks);
 		jsmn_init(&plugin->parser);
-		plugin->used = 0;
+		plugin->used = plugin->read_offset = 0;
 		return false;
 	}
 
@@ -1666,26 +1681,41 @@ static bool ld_read_json_one(struct plugin *plugin)
 	 * check for "jsonrpc" here. */
 	ld_command_handle(plugin, plugin->toks);
 
-	/* Move this object out of the buffer */
-	memmove(plugin->buffer, plugin->buffer + plugin->toks[0].end,
-		tal_count(plugin->buffer) - plugin->toks[0].end);
-	plugin->used -= plugin->toks[0].end;
+	/* Skip over this object; we compact once the burst is handled */
+	plugin->read_offset += plugin->toks[0].end;
 	toks_reset(plugin->toks);
 	jsmn_init(&plugin->parser);
-
 	return true;
+
+compact:
+	/* As in rpc_read_response_one: one memmove per read, not one per
+	 * message when lightningd sends us a burst of notifications. */
+	if (plugin->read_offset) {
+		memmove(plugin->buffer,
+			plugin->buffer + plugin->read_offset,
+			plugin->used - plugin->read_offset);
+		plugin->used -= plugin->read_offset;
+		plugin->read_offset = 0;
+	}
+	return false;
 }
 
 static struct io_plan *ld_read_json(struct io_conn *conn,
 				    struct plugin *plugin)
 {
+	/* As in rpc_conn_read_response: nothing completes without a '}' */
+	bool have_full = memchr(plugin->buffer + plugin->used, '}',
+				plugin->len_read);
+
 	plugin->used += plugin->len_read;
 	if (plugin->used && plugin->used == tal_count(plugin->buffer))
 		tal_resize(&plugin->buffer, plugin->used * 2);
 
 	/* Read and process all messages from the connection */
-	while (ld_read_json_one(plugin))
-		;
+	if (have_full) {
+		while (ld_read_json_one(plugin))
+			;
+	}
 
 	/* Now read more from the connection */
 	return io_read_partial(plugin->stdin_conn,
@@ -1780,6 +1810,7 @@ static struct plugin *new_plugin(const tal_t *ctx,
 	p->buffer = tal_arr(p, char, 64);
 	list_head_init(&p->js_list);
 	p->used = 0;
+	p->read_offset = 0;
 	p->len_read = 0;
 	jsmn_init(&p->parser);
 	p->toks = toks_alloc(p);
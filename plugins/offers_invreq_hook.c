@@ -8,6 +8,7 @@
 #include <common/invoice_path_id.h>
 #include <common/iso4217.h>
 #include <common/json_stream.h>
+#include <common/memleak.h>
 #include <common/overflows.h>
 #include <common/type_to_string.h>
 #include <plugins/offers.h>
@@ -254,8 +255,16 @@ struct chaninfo {
 	struct amount_msat capacity, htlc_min, htlc_max;
 	u32 feebase, feeppm, cltv;
 	bool public;
+	/* Peer is known to support route blinding */
+	bool blinding;
 };
 
+/* Every invoice_request needs our incoming channels: a popular offer
+ * can get many, so we don't ask lightningd every time. */
+#define INCOMING_CACHE_SECONDS 10
+static struct chaninfo *incoming_cache;
+static struct timeabs incoming_cache_time;
+
 /* FIXME: This is naive:
  * - Only creates if we have no public channels.
  * - Always creates a path from direct neighbor.
@@ -264,69 +273,31 @@ struct chaninfo {
  */
 /* (We only create if we have to, because our code doesn't handle
  * making a payment if the blinded path starts with ourselves!) */
-static struct command_result *listincoming_done(struct command *cmd,
-						const char *buf,
-						const jsmntok_t *result,
-						struct invreq *ir)
+static struct command_result *add_incoming_path(struct command *cmd,
+						struct invreq *ir,
+						const struct chaninfo *chans)
 {
-	const jsmntok_t *arr, *t;
-	size_t i;
 	struct chaninfo *best = NULL;
 	bool any_public = false;
 
-	arr = json_get_member(buf, result, "incoming");
-	json_for_each_arr(i, t, arr) {
-		struct chaninfo ci;
-		const jsmntok_t *pftok;
-		u8 *features;
-		const char *err;
-		struct amount_msat feebase;
+	for (size_t i = 0; i < tal_count(chans); i++) {
+		const struct chaninfo *ci = &chans[i];
 
-		err = json_scan(tmpctx, buf, t,
-				"{id:%,"
-				"incoming_capacity_msat:%,"
-				"htlc_min_msat:%,"
-				"htlc_max_msat:%,"
-				"fee_base_msat:%,"
-				"fee_proportional_millionths:%,"
-				"cltv_expiry_delta:%,"
-				"short_channel_id:%,"
-				"public:%}",
-				JSON_SCAN(json_to_pubkey, &ci.id),
-				JSON_SCAN(json_to_msat, &ci.capacity),
-				JSON_SCAN(json_to_msat, &ci.htlc_min),
-				JSON_SCAN(json_to_msat, &ci.htlc_max),
-				JSON_SCAN(json_to_msat, &feebase),
-				JSON_SCAN(json_to_u32, &ci.feeppm),
-				JSON_SCAN(json_to_u32, &ci.cltv),
-				JSON_SCAN(json_to_short_channel_id, &ci.scid),
-				JSON_SCAN(json_to_bool, &ci.public));
-		if (err) {
-			plugin_log(cmd->plugin, LOG_BROKEN,
-				   "Could not parse listincoming: %s",
-				   err);
-			continue;
-		}
-		ci.feebase = feebase.millisatoshis; /* Raw: feebase */
-		any_public |= ci.public;
+		any_public |= ci->public;
 
 		/* Not presented if there's no channel_announcement for peer:
 		 * we could use listpeers, but if it's private we probably
 		 * don't want to blinded route through it! */
-		pftok = json_get_member(buf, t, "peer_features");
-		if (!pftok)
-			continue;
-		features = json_tok_bin_from_hex(tmpctx, buf, pftok);
-		if (!feature_offered(features, OPT_ROUTE_BLINDING))
+		if (!ci->blinding)
 			continue;
 
-		if (amount_msat_less(ci.htlc_max,
+		if (amount_msat_less(ci->htlc_max,
 				     amount_msat(*ir->inv->invoice_amount)))
 			continue;
 
 		/* Only pick a private one if no public candidates. */
-		if (!best || (!best->public && ci.public))
-			best = tal_dup(tmpctx, struct chaninfo, &ci);
+		if (!best || (!best->public && ci->public))
+			best = tal_dup(tmpctx, struct chaninfo, ci);
 	}
 
 	/* If there are any public channels, don't add. */
@@ -417,11 +388,77 @@ done:
 	return create_invoicereq(cmd, ir);
 }
 
+static struct command_result *listincoming_done(struct command *cmd,
+						const char *buf,
+						const jsmntok_t *result,
+						struct invreq *ir)
+{
+	const jsmntok_t *arr, *t;
+	size_t i;
+
+	tal_free(incoming_cache);
+	incoming_cache = notleak(tal_arr(cmd->plugin, struct chaninfo, 0));
+	incoming_cache_time = time_now();
+
+	arr = json_get_member(buf, result, "incoming");
+	json_for_each_arr(i, t, arr) {
+		struct chaninfo ci;
+		const jsmntok_t *pftok;
+		u8 *features;
+		const char *err;
+		struct amount_msat feebase;
+
+		err = json_scan(tmpctx, buf, t,
+				"{id:%,"
+				"incoming_capacity_msat:%,"
+				"htlc_min_msat:%,"
+				"htlc_max_msat:%,"
+				"fee_base_msat:%,"
+				"fee_proportional_millionths:%,"
+				"cltv_expiry_delta:%,"
+				"short_channel_id:%,"
+				"public:%}",
+				JSON_SCAN(json_to_pubkey, &ci.id),
+				JSON_SCAN(json_to_msat, &ci.capacity),
+				JSON_SCAN(json_to_msat, &ci.htlc_min),
+				JSON_SCAN(json_to_msat, &ci.htlc_max),
+				JSON_SCAN(json_to_msat, &feebase),
+				JSON_SCAN(json_to_u32, &ci.feeppm),
+				JSON_SCAN(json_to_u32, &ci.cltv),
+				JSON_SCAN(json_to_short_channel_id, &ci.scid),
+				JSON_SCAN(json_to_bool, &ci.public));
+		if (err) {
+			plugin_log(cmd->plugin, LOG_BROKEN,
+				   "Could not parse listincoming: %s",
+				   err);
+			continue;
+		}
+		ci.feebase = feebase.millisatoshis; /* Raw: feebase */
+
+		pftok = json_get_member(buf, t, "peer_features");
+		if (pftok) {
+			features = json_tok_bin_from_hex(tmpctx, buf, pftok);
+			ci.blinding = feature_offered(features,
+						      OPT_ROUTE_BLINDING);
+		} else
+			ci.blinding = false;
+		tal_arr_expand(&incoming_cache, ci);
+	}
+
+	return add_incoming_path(cmd, ir, incoming_cache);
+}
+
 static struct command_result *add_blindedpaths(struct command *cmd,
 					       struct invreq *ir)
 {
 	struct out_req *req;
 
+	/* (An empty list is likely a node still opening channels) */
+	if (tal_count(incoming_cache) != 0
+	    && time_less(time_between(time_now(), incoming_cache_time),
+			 time_from_sec(INCOMING_CACHE_SECONDS)))
+		return add_incoming_path(cmd, ir, incoming_cache);
+
 	req = jsonrpc_request_start(cmd->plugin, cmd, "listincoming",
 				    listincoming_done, listincoming_done, ir);
 	return send_outreq(cmd->plugin, req);
@@ -23,6 +23,7 @@ static struct node_id my_id;
 static unsigned int maxdelay_default;
 static bool exp_offers;
 static bool disablempp = false;
+static bool flowsplit = false;
 
 static LIST_HEAD(payments);
 
@@ -587,6 +588,8 @@ static const char *init(struct plugin *p,
 		 JSON_SCAN(json_to_number, &maxdelay_default),
 		 JSON_SCAN(json_to_bool, &exp_offers));
 
+	liquidity_hints_load(p);
+
 #if DEVELOPER
 	plugin_set_memleak_handler(p, memleak_mark_payments);
 #endif
@@ -943,7 +946,7 @@ struct payment_modifier *paymod_mods[] = {
 	/* NOTE: The order in which these three paymods are executed is
 	 * significant!
 	 * routehints *must* execute first before payee_incoming_limit
-	 * which *must* execute bfore presplit.
+	 * which *must* execute bfore flowsplit and presplit.
 	 *
 	 * FIXME: Giving an ordered list of paymods to the paymod
 	 * system is the wrong interface, given that the order in
@@ -959,6 +962,7 @@ struct payment_modifier *paymod_mods[] = {
 	 */
 	&routehints_pay_mod,
 	&payee_incoming_limit_pay_mod,
+	&flowsplit_pay_mod,
 	&presplit_pay_mod,
 	&waitblockheight_pay_mod,
 	&retry_pay_mod,
@@ -1236,6 +1240,7 @@ static struct command_result *json_pay(struct command *cmd,
 	}
 
 	shadow_route = payment_mod_shadowroute_get_data(p);
+	payment_mod_flowsplit_get_data(p)->disable = disablempp || !flowsplit;
 	payment_mod_presplit_get_data(p)->disable = disablempp;
 	payment_mod_adaptive_splitter_get_data(p)->disable = disablempp;
 	payment_mod_route_exclusions_get_data(p)->exclusions = exclusions;
@@ -1260,6 +1265,56 @@ static struct command_result *json_pay(struct command *cmd,
 	return send_outreq(cmd->plugin, req);
 }
 
+static struct command_result *
+param_probe_target_array(struct command *cmd, const char *name,
+			 const char *buffer, const jsmntok_t *tok,
+			 struct probe_target **targets)
+{
+	size_t i;
+	const jsmntok_t *t;
+
+	if (tok->type != JSMN_ARRAY || tok->size == 0)
+		return command_fail_badparam(cmd, name, buffer, tok,
+					     "must be a non-empty array");
+
+	*targets = tal_arr(cmd, struct probe_target, tok->size);
+	json_for_each_arr(i, t, tok) {
+		struct node_id *destination;
+		struct amount_msat *msat;
+
+		if (!param(cmd, buffer, t,
+			   p_req("destination", param_node_id, &destination),
+			   p_req("amount_msat", param_msat, &msat),
+			   NULL))
+			return command_param_failed();
+
+		(*targets)[i].destination = *destination;
+		(*targets)[i].amount = *msat;
+	}
+	return NULL;
+}
+
+static struct command_result *json_probe(struct command *cmd,
+					 const char *buffer,
+					 const jsmntok_t *params)
+{
+	struct probe_target *targets;
+	u32 *maxinflight, *final_cltv;
+
+	if (!param(cmd, buffer, params,
+		   p_req("targets", param_probe_target_array, &targets),
+		   p_opt_def("maxinflight", param_number, &maxinflight, 8),
+		   p_opt_def("final_cltv", param_number, &final_cltv, 18),
+		   NULL))
+		return command_param_failed();
+
+	if (*maxinflight == 0)
+		return command_fail_badparam(cmd, "maxinflight", buffer,
+					     params, "must be non-zero");
+
+	return probe_targets(cmd, &my_id, targets, *maxinflight, *final_cltv);
+}
+
 static const struct plugin_command commands[] = {
 	{
 		"paystatus",
@@ -1281,6 +1336,13 @@ static const struct plugin_command commands[] = {
 		"Attempt to pay the {bolt11} invoice.",
 		json_pay
 	},
+	{
+		"probe",
+		"payment",
+		"Probe routes to each of {targets} ({destination}, {amount_msat}), {maxinflight} at a time",
+		"Sends unpayable HTLCs to learn the liquidity of channels on the way.",
+		json_probe
+	},
 };
 
 static const char *notification_topics[] = {
@@ -1297,5 +1359,9 @@ int main(int argc, char *argv[])
 		    plugin_option("disable-mpp", "flag",
 				  "Disable multi-part payments.",
 				  flag_option, &disablempp),
+		    plugin_option("flow-split", "flag",
+				  "Split multi-part payments using estimated"
+				  " channel capacities.",
+				  flag_option, &flowsplit),
 		    NULL);
 }
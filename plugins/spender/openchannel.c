@@ -69,6 +69,18 @@ static bool update_parent_psbt(const tal_t *ctx,
 	struct psbt_changeset *changes;
 	struct wally_psbt *clone, *new_node_copy;
 
+	/* Most peers stop changing anything after the first round or two:
+	 * don't clone the whole (shared) parent just to find that out. */
+	changes = psbt_get_changeset(NULL, old_node_psbt, new_node_psbt);
+	if (tal_count(changes->added_ins) == 0
+	    && tal_count(changes->rm_ins) == 0
+	    && tal_count(changes->added_outs) == 0
+	    && tal_count(changes->rm_outs) == 0) {
+		tal_free(changes);
+		return true;
+	}
+	tal_free(changes);
+
 	/* Clone the parent, so we don't make any changes to it
 	 * until we've succesfully done everything */
 
@@ -843,13 +855,13 @@ perform_openchannel_update(struct multifundchannel_command *mfc)
 						     "openchannel_init_parent",
 						     dest->error_message);
 		}
-		/* Get everything sorted correctly */
-		psbt_sort_by_serial_id(mfc->psbt);
 
 		tal_free(dest->psbt);
 		dest->psbt = dest->updated_psbt;
 		dest->updated_psbt = NULL;
 	}
+	/* Get everything sorted correctly */
+	psbt_sort_by_serial_id(mfc->psbt);
 
 	/* Next we update the view of every destination with the
 	 * parent viewset */
@@ -1,6 +1,7 @@
 /* Brilliant or insane?  You decide! */
 #include "config.h"
 #include <ccan/array_size/array_size.h>
+#include <ccan/asort/asort.h>
 #include <ccan/err/err.h>
 #include <ccan/strmap/strmap.h>
 #include <ccan/tal/str/str.h>
@@ -115,8 +116,11 @@ static STRMAP(struct table_desc *) tablemap;
 static size_t max_dbmem = 500000000;
 static struct sqlite3 *db;
 static const char *dbfilename;
+static u32 max_rows;
 static int gosstore_fd = -1;
 static size_t gosstore_nodes_off = 0, gosstore_channels_off = 0;
+/* Channels seen updated in gossip_store, still to be re-queried. */
+static struct short_channel_id *channels_to_refresh;
 static u64 next_rowid = 1;
 
 /* It was tempting to put these in the schema, but they're really
@@ -317,6 +321,7 @@ static struct command_result *refresh_complete(struct command *cmd,
 	char *errmsg;
 	int err, num_cols;
 	size_t num_rows;
+	bool truncated = false;
 	struct json_stream *ret;
 
 	num_cols = sqlite3_column_count(dbq->stmt);
@@ -327,6 +332,12 @@ static struct command_result *refresh_complete(struct command *cmd,
 	errmsg = NULL;
 
 	while ((err = sqlite3_step(dbq->stmt)) == SQLITE_ROW) {
+		/* The whole response is built in memory, so don't let
+		 * a careless query run us out of it. */
+		if (max_rows && num_rows == max_rows) {
+			truncated = true;
+			break;
+		}
 		if (!ret) {
 			ret = jsonrpc_stream_success(cmd);
 			json_array_start(ret, "rows");
@@ -376,7 +387,7 @@ static struct command_result *refresh_complete(struct command *cmd,
 		json_array_end(ret);
 		num_rows++;
 	}
-	if (err != SQLITE_DONE)
+	if (err != SQLITE_DONE && !truncated)
 		errmsg = tal_fmt(cmd, "Executing statement: %s",
 				 sqlite3_errmsg(db));
 
@@ -400,6 +411,10 @@ static struct command_result *refresh_complete(struct command *cmd,
 		}
 		json_array_end(ret);
 	}
+	if (truncated)
+		json_add_str_fmt(ret, "warning_truncated",
+				 "Only the first %u rows returned (sqlmaxrows)",
+				 max_rows);
 	return command_finished(cmd, ret);
 }
 
@@ -645,17 +660,34 @@ static struct command_result *default_list_done(struct command *cmd,
 	int err;
 	char *errmsg;
 
+	/* Otherwise sqlite commits every single row insert separately,
+	 * which is most of the cost for large tables like forwards. */
+	err = sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, &errmsg);
+	if (err != SQLITE_OK) {
+		return command_fail(cmd, LIGHTNINGD, "starting '%s' update failed: %s",
+				    td->name, errmsg);
+	}
+
 	/* FIXME: this is where a wait / pagination API is useful! */
 	err = sqlite3_exec(db, tal_fmt(tmpctx, "DELETE FROM %s;", td->name),
 			   NULL, NULL, &errmsg);
 	if (err != SQLITE_OK) {
+		sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
 		return command_fail(cmd, LIGHTNINGD, "cleaning '%s' failed: %s",
 				    td->name, errmsg);
 	}
 
 	ret = process_json_result(cmd, buf, result, td);
-	if (ret)
+	if (ret) {
+		sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
 		return ret;
+	}
+
+	err = sqlite3_exec(db, "COMMIT;", NULL, NULL, &errmsg);
+	if (err != SQLITE_OK) {
+		return command_fail(cmd, LIGHTNINGD, "committing '%s' failed: %s",
+				    td->name, errmsg);
+	}
 
 	return one_refresh_done(cmd, dbq);
 }
@@ -742,12 +774,35 @@ static struct command_result *listchannels_one_done(struct command *cmd,
 	return channels_refresh(cmd, td, dbq);
 }
 
+static int cmp_scid(const struct short_channel_id *a,
+		    const struct short_channel_id *b,
+		    void *unused)
+{
+	if (a->u64 < b->u64)
+		return -1;
+	return a->u64 > b->u64;
+}
+
+/* Sort and remove duplicates */
+static void uniq_scids(struct short_channel_id **scids)
+{
+	size_t n = 0;
+
+	asort(*scids, tal_count(*scids), cmp_scid, NULL);
+	for (size_t i = 0; i < tal_count(*scids); i++) {
+		if (n && short_channel_id_eq(&(*scids)[n-1], &(*scids)[i]))
+			continue;
+		(*scids)[n++] = (*scids)[i];
+	}
+	tal_resize(scids, n);
+}
+
 static struct command_result *channels_refresh(struct command *cmd,
 						const struct table_desc *td,
 						struct db_query *dbq)
 {
 	struct out_req *req;
-	size_t msglen;
+	size_t msglen, num_pending;
 	u16 type, flags;
 
 	if (gosstore_fd == -1) {
@@ -760,11 +815,13 @@ static struct command_result *channels_refresh(struct command *cmd,
 	/* First time, set off to end and load from scratch */
 	if (gosstore_channels_off == 0) {
 		gosstore_channels_off = find_gossip_store_end(gosstore_fd, 1);
+		tal_resize(&channels_to_refresh, 0);
 		return default_refresh(cmd, td, dbq);
 	}
 
 	plugin_log(cmd->plugin, LOG_DBG, "Refreshing channels @%zu...",
 		   gosstore_channels_off);
+	num_pending = tal_count(channels_to_refresh);
 
 	/* OK, try catching up! */
 	while (gossip_store_readhdr(gosstore_fd, gosstore_channels_off,
@@ -795,17 +852,9 @@ static struct command_result *channels_refresh(struct command *cmd,
 				break;
 			}
 
-			plugin_log(cmd->plugin, LOG_DBG, "Refreshing channel: %s",
-				   type_to_string(tmpctx, struct short_channel_id, &scid));
-			/* FIXME: sqlite 3.24.0 (2018-06-04) added UPSERT, but
-			 * we don't require it. */
-			delete_channel_from_db(cmd, scid);
-			req = jsonrpc_request_start(cmd->plugin, cmd, "listchannels",
-						    listchannels_one_done,
-						    forward_error,
-						    dbq);
-			json_add_short_channel_id(req->js, "short_channel_id", &scid);
-			return send_outreq(cmd->plugin, req);
+			/* Busy channels get many updates between queries:
+			 * collect them all, and only ask about each once. */
+			tal_arr_expand(&channels_to_refresh, scid);
 		} else if (type == WIRE_GOSSIP_STORE_DELETE_CHAN) {
 			/* This can fail if entry not fully written yet. */
 			if (!extract_scid(gosstore_fd, off, type, &scid)) {
@@ -818,6 +867,29 @@ static struct command_result *channels_refresh(struct command *cmd,
 		}
 	}
 
+	if (tal_count(channels_to_refresh) != num_pending)
+		uniq_scids(&channels_to_refresh);
+
+	/* If it was deleted since, listchannels simply won't return it. */
+	if (tal_count(channels_to_refresh) != 0) {
+		struct short_channel_id scid;
+
+		scid = channels_to_refresh[tal_count(channels_to_refresh) - 1];
+		tal_resize(&channels_to_refresh,
+			   tal_count(channels_to_refresh) - 1);
+		plugin_log(cmd->plugin, LOG_DBG, "Refreshing channel: %s",
+			   type_to_string(tmpctx, struct short_channel_id, &scid));
+		/* FIXME: sqlite 3.24.0 (2018-06-04) added UPSERT, but
+		 * we don't require it. */
+		delete_channel_from_db(cmd, scid);
+		req = jsonrpc_request_start(cmd->plugin, cmd, "listchannels",
+					    listchannels_one_done,
+					    forward_error,
+					    dbq);
+		json_add_short_channel_id(req->js, "short_channel_id", &scid);
+		return send_outreq(cmd->plugin, req);
+	}
+
 	return one_refresh_done(cmd, dbq);
 }
 
@@ -1445,6 +1517,7 @@ static void init_indices(struct plugin *plugin)
 static void memleak_mark_tablemap(struct plugin *p, struct htable *memtable)
 {
 	memleak_ptr(memtable, dbfilename);
+	memleak_ptr(memtable, channels_to_refresh);
 	memleak_scan_strmap(memtable, &tablemap);
 }
 #endif
@@ -1455,6 +1528,7 @@ static const char *init(struct plugin *plugin,
 	db = sqlite_setup(plugin);
 	init_tablemap(plugin);
 	init_indices(plugin);
+	channels_to_refresh = tal_arr(plugin, struct short_channel_id, 0);
 
 #if DEVELOPER
 	plugin_set_memleak_handler(plugin, memleak_mark_tablemap);
@@ -1580,5 +1654,9 @@ int main(int argc, char *argv[])
 				  "string",
 				  "Use on-disk sqlite3 file instead of in memory (e.g. debugging)",
 				  charp_option, &dbfilename),
+		    plugin_option("sqlmaxrows",
+				  "int",
+				  "Maximum rows to return from a query (0 = no limit)",
+				  u32_option, &max_rows),
 		    NULL);
 }
@@ -15,6 +15,9 @@ u8 **blinded_onion_hops(const tal_t *ctx UNNEEDED,
 			struct amount_msat total_amount UNNEEDED,
 			const struct blinded_path *path UNNEEDED)
 { fprintf(stderr, "blinded_onion_hops called!\n"); abort(); }
+/* Generated stub for command_done */
+struct command_result *command_done(void)
+{ fprintf(stderr, "command_done called!\n"); abort(); }
 /* Generated stub for command_finished */
 struct command_result *command_finished(struct command *cmd UNNEEDED, struct json_stream *response UNNEEDED)
 { fprintf(stderr, "command_finished called!\n"); abort(); }
@@ -181,6 +184,18 @@ int json_tok_full_len(const jsmntok_t *t UNNEEDED)
 /* Generated stub for json_tok_streq */
 bool json_tok_streq(const char *buffer UNNEEDED, const jsmntok_t *tok UNNEEDED, const char *str UNNEEDED)
 { fprintf(stderr, "json_tok_streq called!\n"); abort(); }
+/* Generated stub for jsonrpc_get_datastore_ */
+struct command_result *jsonrpc_get_datastore_(struct plugin *plugin UNNEEDED,
+					      struct command *cmd UNNEEDED,
+					      const char *path UNNEEDED,
+					      struct command_result *(*string_cb)(struct command *command UNNEEDED,
+									   const char *val UNNEEDED,
+									   void *arg) UNNEEDED,
+					      struct command_result *(*binary_cb)(struct command *command UNNEEDED,
+									   const u8 *val UNNEEDED,
+									   void *arg) UNNEEDED,
+					      void *arg UNNEEDED)
+{ fprintf(stderr, "jsonrpc_get_datastore_ called!\n"); abort(); }
 /* Generated stub for jsonrpc_request_start_ */
 struct out_req *jsonrpc_request_start_(struct plugin *plugin UNNEEDED,
 				       struct command *cmd UNNEEDED,
@@ -196,6 +211,23 @@ struct out_req *jsonrpc_request_start_(struct plugin *plugin UNNEEDED,
 								       void *arg) UNNEEDED,
 				       void *arg UNNEEDED)
 { fprintf(stderr, "jsonrpc_request_start_ called!\n"); abort(); }
+/* Generated stub for jsonrpc_set_datastore_ */
+struct command_result *jsonrpc_set_datastore_(struct plugin *plugin UNNEEDED,
+					      struct command *cmd UNNEEDED,
+					      const char *path UNNEEDED,
+					      const void *value UNNEEDED,
+					      bool value_is_string UNNEEDED,
+					      const char *mode UNNEEDED,
+					      struct command_result *(*cb)(struct command *command UNNEEDED,
+									   const char *buf UNNEEDED,
+									   const jsmntok_t *result UNNEEDED,
+									   void *arg) UNNEEDED,
+					      struct command_result *(*errcb)(struct command *command UNNEEDED,
+									      const char *buf UNNEEDED,
+									      const jsmntok_t *result UNNEEDED,
+									      void *arg) UNNEEDED,
+					      void *arg UNNEEDED)
+{ fprintf(stderr, "jsonrpc_set_datastore_ called!\n"); abort(); }
 /* Generated stub for jsonrpc_stream_fail */
 struct json_stream *jsonrpc_stream_fail(struct command *cmd UNNEEDED,
 					int code UNNEEDED,
@@ -3,6 +3,7 @@
 #include <ccan/crypto/siphash24/siphash24.h>
 #include <ccan/htable/htable_type.h>
 #include <ccan/json_escape/json_escape.h>
+#include <ccan/list/list.h>
 #include <ccan/tal/str/str.h>
 #include <common/dijkstra.h>
 #include <common/gossmap.h>
@@ -110,6 +111,217 @@ static void json_add_route_hop(struct json_stream *js,
 	json_object_end(js);
 }
 
+/* Popular destinations get asked for over and over: we remember the
+ * channels we chose for them, until the gossmap changes. */
+struct route_cache_entry {
+	/* In route_cache, most recently used first */
+	struct list_node list;
+	struct node_id src, dst;
+	/* Fees, risk and htlc limits all depend on the amount, so the best
+	 * route for one amount can be a poor (or wrong) one for another. */
+	struct amount_msat amount;
+	double riskfactor;
+	u32 max_hops;
+	struct short_channel_id_dir *path;
+};
+
+#define ROUTE_CACHE_MAX 128
+static LIST_HEAD(route_cache);
+static size_t route_cache_num;
+static u64 route_cache_generation;
+
+static void route_cache_del(struct route_cache_entry *e)
+{
+	list_del_from(&route_cache, &e->list);
+	route_cache_num--;
+	tal_free(e);
+}
+
+static struct route_cache_entry *route_cache_find(const struct gossmap *gossmap,
+						  const struct node_id *src,
+						  const struct node_id *dst,
+						  struct amount_msat msat,
+						  double riskfactor,
+						  u32 max_hops)
+{
+	struct route_cache_entry *e, *next;
+
+	/* Any change to the graph could mean a better route. */
+	if (gossmap_generation(gossmap) != route_cache_generation) {
+		list_for_each_safe(&route_cache, e, next, list)
+			route_cache_del(e);
+		route_cache_generation = gossmap_generation(gossmap);
+		return NULL;
+	}
+
+	list_for_each(&route_cache, e, list) {
+		if (amount_msat_eq(e->amount, msat)
+		    && e->riskfactor == riskfactor
+		    && e->max_hops == max_hops
+		    && node_id_eq(&e->dst, dst)
+		    && node_id_eq(&e->src, src)) {
+			list_del_from(&route_cache, &e->list);
+			list_add(&route_cache, &e->list);
+			return e;
+		}
+	}
+	return NULL;
+}
+
+static void route_cache_add(const struct node_id *src,
+			    const struct node_id *dst,
+			    struct amount_msat msat,
+			    double riskfactor,
+			    u32 max_hops,
+			    const struct route_hop *route)
+{
+	struct route_cache_entry *e;
+
+	if (route_cache_num == ROUTE_CACHE_MAX)
+		route_cache_del(list_tail(&route_cache,
+					  struct route_cache_entry, list));
+
+	e = notleak(tal(NULL, struct route_cache_entry));
+	e->src = *src;
+	e->dst = *dst;
+	e->amount = msat;
+	e->riskfactor = riskfactor;
+	e->max_hops = max_hops;
+	e->path = tal_arr(e, struct short_channel_id_dir, tal_count(route));
+	for (size_t i = 0; i < tal_count(route); i++) {
+		e->path[i].scid = route[i].scid;
+		e->path[i].dir = route[i].direction;
+	}
+	list_add(&route_cache, &e->list);
+	route_cache_num++;
+}
+
+/* Recalculate amounts and delays along a cached path (the cltv can
+ * differ), the same way route_from_dijkstra does.  NULL if it can't carry
+ * msat any more. */
+static struct route_hop *route_from_path(const tal_t *ctx,
+					 const struct gossmap *gossmap,
+					 const struct short_channel_id_dir *path,
+					 struct amount_msat msat,
+					 u32 cltv)
+{
+	struct route_hop *hops = tal_arr(ctx, struct route_hop,
+					 tal_count(path));
+
+	for (size_t i = tal_count(path); i > 0; i--) {
+		struct route_hop *hop = &hops[i - 1];
+		struct gossmap_chan *c;
+		const struct half_chan *h;
+
+		c = gossmap_find_chan(gossmap, &path[i - 1].scid);
+		if (!c || !route_can_carry(gossmap, c, path[i - 1].dir, msat,
+					   NULL))
+			return tal_free(hops);
+
+		hop->scid = path[i - 1].scid;
+		hop->direction = path[i - 1].dir;
+		gossmap_node_get_id(gossmap,
+				    gossmap_nth_node(gossmap, c, !hop->direction),
+				    &hop->node_id);
+		hop->amount = msat;
+		hop->delay = cltv;
+
+		h = &c->half[hop->direction];
+		if (!amount_msat_add_fee(&msat, h->base_fee,
+					 h->proportional_fee))
+			return tal_free(hops);
+		cltv += h->delay;
+	}
+	return hops;
+}
+
+/* Find a route from src to dst.  If dij is non-NULL, it's a complete
+ * dijkstra() from dst with these parameters, which we use instead of
+ * calculating our own.  On failure, returns NULL and sets *errcode and
+ * *errmsg.  Any working state is allocated off @ctx too. */
+static struct route_hop *find_route(const tal_t *ctx,
+				    struct command *cmd,
+				    struct gossmap *gossmap,
+				    const struct gossmap_node *src,
+				    const struct gossmap_node *dst,
+				    const struct dijkstra *dij,
+				    struct amount_msat msat,
+				    double riskfactor,
+				    u32 cltv,
+				    u32 max_hops,
+				    struct route_exclusion **excluded,
+				    enum jsonrpc_errcode *errcode,
+				    const char **errmsg)
+{
+	struct route_hop *route;
+	struct route_cache_entry *cached = NULL;
+	struct node_id srcid, dstid;
+
+	gossmap_node_get_id(gossmap, src, &srcid);
+	gossmap_node_get_id(gossmap, dst, &dstid);
+
+	/* Exclusions are per-request, so we don't cache those. */
+	if (!tal_count(excluded)) {
+		cached = route_cache_find(gossmap, &srcid, &dstid, msat,
+					  riskfactor, max_hops);
+		if (cached) {
+			route = route_from_path(ctx, gossmap, cached->path,
+						msat, cltv);
+			if (route) {
+				plugin_log(plugin, LOG_DBG,
+					   "Reusing cached route to %s",
+					   type_to_string(tmpctx, struct node_id,
+							  &dstid));
+				return route;
+			}
+			route_cache_del(cached);
+		}
+	}
+
+	fuzz = 0;
+	/* We only care about src, so don't explore the whole graph. */
+	if (!dij)
+		dij = dijkstra_to(ctx, gossmap, dst, src, msat, riskfactor,
+				  can_carry, route_score_fuzz, excluded);
+	route = route_from_dijkstra(ctx, gossmap, dij, src, msat, cltv);
+	if (!route) {
+		*errcode = PAY_ROUTE_NOT_FOUND;
+		*errmsg = "Could not find a route";
+		return NULL;
+	}
+
+	/* If it's too far, fall back to using shortest path. */
+	if (tal_count(route) > max_hops) {
+		plugin_notify_message(cmd, LOG_INFORM, "Cheapest route %zu hops: seeking shorter (no fuzz)",
+				      tal_count(route));
+		tal_free(route);
+		dij = dijkstra_to(ctx, gossmap, dst, src, msat, riskfactor,
+				  can_carry, route_score_shorter, excluded);
+		route = route_from_dijkstra(ctx, gossmap, dij, src, msat, cltv);
+		if (tal_count(route) > max_hops) {
+			*errcode = PAY_ROUTE_NOT_FOUND;
+			*errmsg = tal_fmt(ctx, "Shortest route was %zu",
+					  tal_count(route));
+			return tal_free(route);
+		}
+	}
+
+	if (!tal_count(excluded))
+		route_cache_add(&srcid, &dstid, msat, riskfactor, max_hops,
+				route);
+	return route;
+}
+
+static void json_add_route(struct json_stream *js,
+			   const struct route_hop *route)
+{
+	json_array_start(js, "route");
+	for (size_t i = 0; i < tal_count(route); i++) {
+		json_add_route_hop(js, NULL, &route[i]);
+	}
+	json_array_end(js);
+}
+
 static struct command_result *json_getroute(struct command *cmd,
 					    const char *buffer,
 					    const jsmntok_t *params)
@@ -122,11 +334,12 @@ static struct command_result *json_getroute(struct command *cmd,
 	u64 *riskfactor_millionths, *fuzz_millionths;
 	struct route_exclusion **excluded;
 	u32 *max_hops;
-	const struct dijkstra *dij;
 	struct route_hop *route;
 	struct gossmap_node *src, *dst;
 	struct json_stream *js;
 	struct gossmap *gossmap;
+	enum jsonrpc_errcode errcode;
+	const char *errmsg;
 
 	if (!param(cmd, buffer, params,
 		   p_req("id", param_node_id, &destination),
@@ -161,31 +374,228 @@ static struct command_result *json_getroute(struct command *cmd,
 				    "%s: unknown destination node_id (no public channels?)",
 				    type_to_string(tmpctx, struct node_id, destination));
 
-	fuzz = 0;
-	dij = dijkstra(tmpctx, gossmap, dst, *msat,
-		       *riskfactor_millionths / 1000000.0,
-		       can_carry, route_score_fuzz, excluded);
-	route = route_from_dijkstra(dij, gossmap, dij, src, *msat, *cltv);
+	route = find_route(tmpctx, cmd, gossmap, src, dst, NULL, *msat,
+			   *riskfactor_millionths / 1000000.0, *cltv,
+			   *max_hops, excluded, &errcode, &errmsg);
 	if (!route)
-		return command_fail(cmd, PAY_ROUTE_NOT_FOUND, "Could not find a route");
+		return command_fail(cmd, errcode, "%s", errmsg);
 
-	/* If it's too far, fall back to using shortest path. */
-	if (tal_count(route) > *max_hops) {
-		plugin_notify_message(cmd, LOG_INFORM, "Cheapest route %zu hops: seeking shorter (no fuzz)",
-				      tal_count(route));
-		dij = dijkstra(tmpctx, gossmap, dst, *msat,
-			       *riskfactor_millionths / 1000000.0,
-			       can_carry, route_score_shorter, excluded);
-		route = route_from_dijkstra(dij, gossmap, dij, src, *msat, *cltv);
-		if (tal_count(route) > *max_hops)
-			return command_fail(cmd, PAY_ROUTE_NOT_FOUND, "Shortest route was %zu",
-					    tal_count(route));
+	js = jsonrpc_stream_success(cmd);
+	json_add_route(js, route);
+
+	return command_finished(cmd, js);
+}
+
+/* One entry in a getroutes batch. */
+struct route_query {
+	struct node_id destination;
+	struct node_id source;
+	struct amount_msat msat;
+	u64 riskfactor_millionths;
+	u32 cltv;
+	u32 max_hops;
+	struct route_exclusion **excluded;
+};
+
+static struct command_result *
+param_route_query_array(struct command *cmd, const char *name,
+			const char *buffer, const jsmntok_t *tok,
+			struct route_query **queries)
+{
+	size_t i;
+	const jsmntok_t *t;
+
+	if (tok->type != JSMN_ARRAY)
+		return command_fail_badparam(cmd, name, buffer, tok,
+					     "must be an array");
+
+	*queries = tal_arr(cmd, struct route_query, tok->size);
+	json_for_each_arr(i, t, tok) {
+		struct route_query *q = &(*queries)[i];
+		struct node_id *destination, *source;
+		struct amount_msat *msat;
+		u64 *riskfactor_millionths;
+		u32 *cltv, *max_hops;
+
+		if (!param(cmd, buffer, t,
+			   p_req("id", param_node_id, &destination),
+			   p_req("amount_msat", param_msat, &msat),
+			   p_req("riskfactor", param_millionths,
+				 &riskfactor_millionths),
+			   p_opt_def("cltv", param_number, &cltv, 9),
+			   p_opt_def("fromid", param_node_id, &source, local_id),
+			   p_opt("exclude", param_route_exclusion_array,
+				 &q->excluded),
+			   p_opt_def("maxhops", param_number, &max_hops,
+				     ROUTING_MAX_HOPS),
+			   NULL))
+			return command_param_failed();
+
+		q->destination = *destination;
+		q->source = *source;
+		q->msat = *msat;
+		q->riskfactor_millionths = *riskfactor_millionths;
+		q->cltv = *cltv;
+		q->max_hops = *max_hops;
 	}
+	return NULL;
+}
+
+/* Queries without exclusions to the same destination, amount and riskfactor
+ * can all use one complete dijkstra (from different sources). */
+struct shared_dijkstra_key {
+	struct node_id destination;
+	struct amount_msat msat;
+	u64 riskfactor_millionths;
+};
+
+struct shared_dijkstra {
+	struct shared_dijkstra_key key;
+	/* How many queries use this, and how many are yet to be answered. */
+	size_t num_queries, remaining;
+	const struct dijkstra *dij;
+};
+
+static const struct shared_dijkstra_key *
+shared_dijkstra_keyof(const struct shared_dijkstra *sd)
+{
+	return &sd->key;
+}
+
+static size_t shared_dijkstra_key_hash(const struct shared_dijkstra_key *key)
+{
+	struct siphash24_ctx ctx;
+
+	siphash24_init(&ctx, siphash_seed());
+	siphash24_update(&ctx, key->destination.k, sizeof(key->destination.k));
+	siphash24_u64(&ctx, key->msat.millisatoshis); /* Raw: hashing */
+	siphash24_u64(&ctx, key->riskfactor_millionths);
+	return siphash24_done(&ctx);
+}
+
+static bool shared_dijkstra_eq(const struct shared_dijkstra *sd,
+			       const struct shared_dijkstra_key *key)
+{
+	return node_id_eq(&sd->key.destination, &key->destination)
+		&& amount_msat_eq(sd->key.msat, key->msat)
+		&& sd->key.riskfactor_millionths == key->riskfactor_millionths;
+}
+
+HTABLE_DEFINE_TYPE(struct shared_dijkstra, shared_dijkstra_keyof,
+		   shared_dijkstra_key_hash, shared_dijkstra_eq,
+		   shared_dijkstra_map);
+
+/* Returns which shared_dijkstra each query belongs to (NULL if it has
+ * exclusions). */
+static struct shared_dijkstra **
+group_route_queries(const tal_t *ctx, const struct route_query *queries)
+{
+	struct shared_dijkstra_map *map = tal(tmpctx, struct shared_dijkstra_map);
+	struct shared_dijkstra **groups;
+
+	shared_dijkstra_map_init_sized(map, tal_count(queries));
+	groups = tal_arr(ctx, struct shared_dijkstra *, tal_count(queries));
+	for (size_t i = 0; i < tal_count(queries); i++) {
+		struct shared_dijkstra_key key;
+		struct shared_dijkstra *sd;
+
+		if (tal_count(queries[i].excluded)) {
+			groups[i] = NULL;
+			continue;
+		}
+		key.destination = queries[i].destination;
+		key.msat = queries[i].msat;
+		key.riskfactor_millionths = queries[i].riskfactor_millionths;
+		sd = shared_dijkstra_map_get(map, &key);
+		if (!sd) {
+			sd = tal(groups, struct shared_dijkstra);
+			sd->key = key;
+			sd->num_queries = sd->remaining = 0;
+			sd->dij = NULL;
+			shared_dijkstra_map_add(map, sd);
+		}
+		sd->num_queries++;
+		sd->remaining++;
+		groups[i] = sd;
+	}
+	shared_dijkstra_map_clear(map);
+	return groups;
+}
+
+static struct command_result *json_getroutes(struct command *cmd,
+					     const char *buffer,
+					     const jsmntok_t *params)
+{
+	struct route_query *queries;
+	struct shared_dijkstra **groups;
+	struct json_stream *js;
+	struct gossmap *gossmap;
+
+	if (!param(cmd, buffer, params,
+		   p_req("queries", param_route_query_array, &queries),
+		   NULL))
+		return command_param_failed();
+
+	/* Everyone gets the same view of the network. */
+	gossmap = get_gossmap();
+	groups = group_route_queries(tmpctx, queries);
 
 	js = jsonrpc_stream_success(cmd);
-	json_array_start(js, "route");
-	for (size_t i = 0; i < tal_count(route); i++) {
-		json_add_route_hop(js, NULL, &route[i]);
+	json_array_start(js, "routes");
+	for (size_t i = 0; i < tal_count(queries); i++) {
+		const struct route_query *q = &queries[i];
+		struct shared_dijkstra *sd = groups[i];
+		double riskfactor = q->riskfactor_millionths / 1000000.0;
+		struct gossmap_node *src, *dst;
+		struct route_hop *route = NULL;
+		enum jsonrpc_errcode errcode;
+		const char *errmsg;
+		/* dijkstra state is O(nodes): don't let it pile up. */
+		const tal_t *qctx = tal(NULL, char);
+
+		src = gossmap_find_node(gossmap, &q->source);
+		dst = gossmap_find_node(gossmap, &q->destination);
+		if (!src) {
+			errcode = JSONRPC2_INVALID_PARAMS;
+			errmsg = tal_fmt(qctx, "%s: unknown source node_id (no public channels?)",
+					 type_to_string(qctx, struct node_id,
+							&q->source));
+		} else if (!dst) {
+			errcode = JSONRPC2_INVALID_PARAMS;
+			errmsg = tal_fmt(qctx, "%s: unknown destination node_id (no public channels?)",
+					 type_to_string(qctx, struct node_id,
+							&q->destination));
+		} else {
+			/* If other queries will want this too, do the whole
+			 * graph once. */
+			if (sd && sd->num_queries > 1 && !sd->dij) {
+				fuzz = 0;
+				sd->dij = dijkstra(sd, gossmap, dst, q->msat,
+						   riskfactor, can_carry,
+						   route_score_fuzz, q->excluded);
+			}
+			route = find_route(qctx, cmd, gossmap, src, dst,
+					   sd ? sd->dij : NULL,
+					   q->msat, riskfactor,
+					   q->cltv, q->max_hops, q->excluded,
+					   &errcode, &errmsg);
+		}
+
+		json_object_start(js, NULL);
+		if (route) {
+			json_add_route(js, route);
+		} else {
+			json_object_start(js, "error");
+			json_add_jsonrpc_errcode(js, "code", errcode);
+			json_add_string(js, "message", errmsg);
+			json_object_end(js);
+		}
+		json_object_end(js);
+
+		tal_free(qctx);
+		/* Last one using this shared dijkstra? */
+		if (sd && --sd->remaining == 0)
+			sd->dij = tal_free(sd->dij);
 	}
 	json_array_end(js);
 
@@ -195,11 +605,89 @@ static struct command_result *json_getroute(struct command *cmd,
 HTABLE_DEFINE_TYPE(struct node_id, node_id_keyof, node_id_hash, node_id_eq,
 		   node_map);
 
+static struct command_result *param_feature_bit(struct command *cmd,
+						const char *name,
+						const char *buffer,
+						const jsmntok_t *tok,
+						u32 **fbit)
+{
+	struct command_result *ret = param_u32(cmd, name, buffer, tok, fbit);
+	if (ret)
+		return ret;
+
+	/* Feature bitmaps are length-prefixed with a u16 */
+	if (**fbit >= 65535 * 8)
+		return command_fail_badparam(cmd, name, buffer, tok,
+					     "should be a valid feature bit");
+	return NULL;
+}
+
+struct listchannels_opts {
+	struct node_id *source;
+	struct node_id *destination;
+	struct short_channel_id *scid;
+	/* Filters, checked before we output anything */
+	u32 *feature;
+	struct amount_msat *min_capacity, *max_capacity;
+	bool *active;
+	struct amount_msat *max_base_fee;
+	u32 *max_fee_ppm;
+	u32 *updated_since;
+};
+
+/* Do the per-channel filters let this one through? */
+static bool chan_wanted(const struct listchannels_opts *opts,
+			struct gossmap *gossmap,
+			const struct gossmap_chan *c,
+			struct amount_sat capacity)
+{
+	struct amount_msat capacity_msat;
+
+	if (opts->feature
+	    && gossmap_chan_get_feature(gossmap, c, *opts->feature) == -1)
+		return false;
+
+	if (!opts->min_capacity && !opts->max_capacity)
+		return true;
+
+	if (!amount_sat_to_msat(&capacity_msat, capacity))
+		abort();
+	if (opts->min_capacity
+	    && amount_msat_less(capacity_msat, *opts->min_capacity))
+		return false;
+	if (opts->max_capacity
+	    && amount_msat_greater(capacity_msat, *opts->max_capacity))
+		return false;
+	return true;
+}
+
+/* Do the per-direction filters let this one through? */
+static bool halfchan_wanted(const struct listchannels_opts *opts,
+			    bool active,
+			    u32 timestamp,
+			    u32 fee_base_msat,
+			    u32 fee_proportional_millionths)
+{
+	if (opts->active && *opts->active != active)
+		return false;
+	if (opts->updated_since && timestamp < *opts->updated_since)
+		return false;
+	if (opts->max_base_fee
+	    && amount_msat_greater(amount_msat(fee_base_msat),
+				   *opts->max_base_fee))
+		return false;
+	if (opts->max_fee_ppm
+	    && fee_proportional_millionths > *opts->max_fee_ppm)
+		return false;
+	return true;
+}
+
 /* To avoid multiple fetches, we represent directions as a bitmap
  * so we can do two at once. */
 static void json_add_halfchan(struct json_stream *response,
 			      struct gossmap *gossmap,
 			      const struct node_map *connected,
+			      const struct listchannels_opts *opts,
 			      const struct gossmap_chan *c,
 			      int dirbits)
 {
@@ -209,6 +697,13 @@ static void json_add_halfchan(struct json_stream *response,
 	struct amount_sat capacity;
 	bool local_disable;
 
+	/* This can theoretically happen on partial write races. */
+	if (!gossmap_chan_get_capacity(gossmap, c, &capacity))
+		capacity = AMOUNT_SAT(0);
+
+	if (!chan_wanted(opts, gossmap, c, capacity))
+		return;
+
 	/* These are channel (not per-direction) properties */
 	chanfeatures = gossmap_chan_get_features(tmpctx, gossmap, c);
 	scid = gossmap_chan_scid(gossmap, c);
@@ -216,10 +711,6 @@ static void json_add_halfchan(struct json_stream *response,
 		gossmap_node_get_id(gossmap, gossmap_nth_node(gossmap, c, i),
 				    &node_id[i]);
 
-	/* This can theoretically happen on partial write races. */
-	if (!gossmap_chan_get_capacity(gossmap, c, &capacity))
-		capacity = AMOUNT_SAT(0);
-
 	/* Local channels are not "active" unless peer is connected. */
 	if (node_id_eq(&node_id[0], &local_id))
 		local_disable = !node_map_get(connected, &node_id[1]);
@@ -240,13 +731,6 @@ static void json_add_halfchan(struct json_stream *response,
 		if (!gossmap_chan_set(c, dir))
 			continue;
 
-		json_object_start(response, NULL);
-		json_add_node_id(response, "source", &node_id[dir]);
-		json_add_node_id(response, "destination", &node_id[!dir]);
-		json_add_short_channel_id(response, "short_channel_id", &scid);
-		json_add_num(response, "direction", dir);
-		json_add_bool(response, "public", !c->private);
-
 		gossmap_chan_get_update_details(gossmap, c, dir,
 						&timestamp,
 						&message_flags,
@@ -256,6 +740,20 @@ static void json_add_halfchan(struct json_stream *response,
 						&htlc_minimum_msat,
 						&htlc_maximum_msat);
 
+		if (!halfchan_wanted(opts,
+				     c->half[dir].enabled && !local_disable,
+				     timestamp,
+				     fee_base_msat,
+				     fee_proportional_millionths))
+			continue;
+
+		json_object_start(response, NULL);
+		json_add_node_id(response, "source", &node_id[dir]);
+		json_add_node_id(response, "destination", &node_id[!dir]);
+		json_add_short_channel_id(response, "short_channel_id", &scid);
+		json_add_num(response, "direction", dir);
+		json_add_bool(response, "public", !c->private);
+
 		json_add_amount_sat_compat(response, capacity,
 					   "satoshis", "amount_msat");
 		json_add_num(response, "message_flags", message_flags);
@@ -277,12 +775,6 @@ static void json_add_halfchan(struct json_stream *response,
 	}
 }
 
-struct listchannels_opts {
-	struct node_id *source;
-	struct node_id *destination;
-	struct short_channel_id *scid;
-};
-
 /* We record which local channels are valid; we could record which are
  * invalid, but our testsuite has some weirdness where it has local
  * channels in the store it knows nothing about. */
@@ -346,7 +838,7 @@ static struct command_result *listpeerchannels_done(struct command *cmd,
 	if (opts->scid) {
 		c = gossmap_find_chan(gossmap, opts->scid);
 		if (c)
-			json_add_halfchan(js, gossmap, connected, c, 3);
+			json_add_halfchan(js, gossmap, connected, opts, c, 3);
 	} else if (opts->source) {
 		struct gossmap_node *src;
 
@@ -355,7 +847,7 @@ static struct command_result *listpeerchannels_done(struct command *cmd,
 			for (size_t i = 0; i < src->num_chans; i++) {
 				int dir;
 				c = gossmap_nth_chan(gossmap, src, i, &dir);
-				json_add_halfchan(js, gossmap, connected,
+				json_add_halfchan(js, gossmap, connected, opts,
 						  c, 1 << dir);
 			}
 		}
@@ -367,7 +859,7 @@ static struct command_result *listpeerchannels_done(struct command *cmd,
 			for (size_t i = 0; i < dst->num_chans; i++) {
 				int dir;
 				c = gossmap_nth_chan(gossmap, dst, i, &dir);
-				json_add_halfchan(js, gossmap, connected,
+				json_add_halfchan(js, gossmap, connected, opts,
 						  c, 1 << !dir);
 			}
 		}
@@ -375,7 +867,7 @@ static struct command_result *listpeerchannels_done(struct command *cmd,
 		for (c = gossmap_first_chan(gossmap);
 		     c;
 		     c = gossmap_next_chan(gossmap, c)) {
-			json_add_halfchan(js, gossmap, connected, c, 3);
+			json_add_halfchan(js, gossmap, connected, opts, c, 3);
 		}
 	}
 
@@ -396,6 +888,13 @@ static struct command_result *json_listchannels(struct command *cmd,
 			 &opts->scid),
 		   p_opt("source", param_node_id, &opts->source),
 		   p_opt("destination", param_node_id, &opts->destination),
+		   p_opt("feature", param_feature_bit, &opts->feature),
+		   p_opt("min_capacity_msat", param_msat, &opts->min_capacity),
+		   p_opt("max_capacity_msat", param_msat, &opts->max_capacity),
+		   p_opt("active", param_bool, &opts->active),
+		   p_opt("max_base_fee_msat", param_msat, &opts->max_base_fee),
+		   p_opt("max_fee_ppm", param_u32, &opts->max_fee_ppm),
+		   p_opt("updated_since", param_u32, &opts->updated_since),
 		   NULL))
 		return command_param_failed();
 
@@ -480,16 +979,36 @@ out:
 	json_object_end(js);
 }
 
+/* Checked straight from the gossmap, before we parse anything. */
+static bool node_wanted(const struct gossmap *gossmap,
+			const struct gossmap_node *n,
+			const u32 *feature,
+			const u32 *updated_since)
+{
+	u32 timestamp;
+
+	if (feature && gossmap_node_get_feature(gossmap, n, *feature) == -1)
+		return false;
+	if (updated_since
+	    && (!gossmap_node_get_timestamp(gossmap, n, &timestamp)
+		|| timestamp < *updated_since))
+		return false;
+	return true;
+}
+
 static struct command_result *json_listnodes(struct command *cmd,
 					     const char *buffer,
 					     const jsmntok_t *params)
 {
 	struct node_id *id;
+	u32 *feature, *updated_since;
 	struct json_stream *js;
 	struct gossmap *gossmap;
 
 	if (!param(cmd, buffer, params,
 		   p_opt("id", param_node_id, &id),
+		   p_opt("feature", param_feature_bit, &feature),
+		   p_opt("updated_since", param_u32, &updated_since),
 		   NULL))
 		return command_param_failed();
 
@@ -498,13 +1017,14 @@ static struct command_result *json_listnodes(struct command *cmd,
 	json_array_start(js, "nodes");
 	if (id) {
 		struct gossmap_node *n = gossmap_find_node(gossmap, id);
-		if (n)
+		if (n && node_wanted(gossmap, n, feature, updated_since))
 			json_add_node(js, gossmap, n);
 	} else {
 		for (struct gossmap_node *n = gossmap_first_node(gossmap);
 		     n;
 		     n = gossmap_next_node(gossmap, n)) {
-			json_add_node(js, gossmap, n);
+			if (node_wanted(gossmap, n, feature, updated_since))
+				json_add_node(js, gossmap, n);
 		}
 	}
 	json_array_end(js);
@@ -625,6 +1145,8 @@ static const char *init(struct plugin *p,
 	if (!global_gossmap)
 		plugin_err(plugin, "Could not load gossmap %s: %s",
 			   GOSSIP_STORE_FILENAME, strerror(errno));
+	/* getroute is our main user: keep edges flat for dijkstra. */
+	gossmap_enable_edges(global_gossmap);
 
 	if (num_cupdates_rejected)
 		plugin_log(plugin, LOG_DBG,
@@ -649,6 +1171,15 @@ static const struct plugin_command commands[] = {
 		"Set the {maxhops} the route can take (default 20).",
 		json_getroute,
 	},
+	{
+		"getroutes",
+		"channels",
+		"Primitive route command for many routes at once",
+		"Show a route for each of {queries}, an array of objects with the "
+		"same fields as getroute (except {fuzzpercent}). Failed queries "
+		"return an {error} object instead of a {route}.",
+		json_getroutes,
+	},
 	{
 		"listchannels",
 		"channels",
@@ -1,6 +1,7 @@
 #include "config.h"
 #include <bitcoin/psbt.h>
 #include <ccan/array_size/array_size.h>
+#include <ccan/tal/str/str.h>
 #include <common/addr.h>
 #include <common/json_param.h>
 #include <common/json_stream.h>
@@ -17,6 +18,14 @@ struct tx_output {
 	bool is_to_external;
 };
 
+/* Queued batchwithdraw commands, all sent in one transaction: output i
+ * of the batch pays cmds[i]. */
+struct withdraw_batch {
+	struct command **cmds;
+	/* Where newaddr_done put the change output, or -1 */
+	int change_outnum;
+};
+
 struct txprepare {
 	struct tx_output *outputs;
 	struct amount_sat output_total;
@@ -38,6 +47,9 @@ struct txprepare {
 
 	/* Keep track if upgrade, so we can report on finish */
 	bool is_upgrade;
+
+	/* For batchwithdraw, the commands we're sending for. */
+	struct withdraw_batch *batch;
 };
 
 struct unreleased_tx {
@@ -46,10 +58,26 @@ struct unreleased_tx {
 	struct wally_tx *tx;
 	struct wally_psbt *psbt;
 	bool is_upgrade;
+	struct withdraw_batch *batch;
 };
 
 static LIST_HEAD(unreleased_txs);
 
+struct queued_withdraw {
+	struct list_node list;
+	struct command *cmd;
+	const u8 *script;
+	struct amount_sat amount;
+};
+
+/* batchwithdraw commands waiting for the next batch. */
+static LIST_HEAD(withdraw_queue);
+static size_t withdraw_queue_len;
+static struct plugin_timer *withdraw_timer;
+
+static u32 withdraw_batch_delay = 10;
+static u32 withdraw_batch_max = 100;
+
 static struct wally_psbt *json_tok_psbt(const tal_t *ctx,
 					const char *buffer,
 					const jsmntok_t *tok)
@@ -129,6 +157,33 @@ static struct command_result *param_outputs(struct command *cmd,
 	return NULL;
 }
 
+static void discard_result(struct command_result *ret)
+{
+}
+
+/* The change output (if any) was inserted among the ones we were given */
+static u32 batch_outnum(const struct withdraw_batch *batch, size_t i)
+{
+	if (batch->change_outnum != -1 && i >= batch->change_outnum)
+		return i + 1;
+	return i;
+}
+
+static struct json_stream *withdraw_success(struct command *cmd,
+					    const struct unreleased_tx *utx,
+					    size_t batch_idx)
+{
+	struct json_stream *out;
+
+	out = jsonrpc_stream_success(cmd);
+	json_add_hex_talarr(out, "tx", linearize_wtx(tmpctx, utx->tx));
+	json_add_txid(out, "txid", &utx->txid);
+	json_add_psbt(out, "psbt", utx->psbt);
+	if (utx->batch)
+		json_add_u32(out, "outnum", batch_outnum(utx->batch, batch_idx));
+	return out;
+}
+
 /* Called after lightningd has broadcast the transaction. */
 static struct command_result *sendpsbt_done(struct command *cmd,
 					    const char *buf,
@@ -137,10 +192,19 @@ static struct command_result *sendpsbt_done(struct command *cmd,
 {
 	struct json_stream *out;
 
-	out = jsonrpc_stream_success(cmd);
-	json_add_hex_talarr(out, "tx", linearize_wtx(tmpctx, utx->tx));
-	json_add_txid(out, "txid", &utx->txid);
-	json_add_psbt(out, "psbt", utx->psbt);
+	/* cmds[0] is cmd itself: the others are just waiting for this. */
+	if (utx->batch) {
+		for (size_t i = 1; i < tal_count(utx->batch->cmds); i++) {
+			struct command *bcmd = utx->batch->cmds[i];
+			utx->batch->cmds[i] = NULL;
+			discard_result(command_finished(bcmd,
+							withdraw_success(bcmd,
+									 utx,
+									 i)));
+		}
+	}
+
+	out = withdraw_success(cmd, utx, 0);
 	if (utx->is_upgrade)
 		json_add_num(out, "upgraded_outs", utx->tx->num_inputs);
 	return command_finished(cmd, out);
@@ -215,6 +279,7 @@ static struct command_result *finish_txprepare(struct command *cmd,
 
 	utx = tal(NULL, struct unreleased_tx);
 	utx->is_upgrade = txp->is_upgrade;
+	utx->batch = txp->batch;
 	utx->psbt = tal_steal(utx, txp->psbt);
 	psbt_txid(utx, txp->psbt, &utx->txid, &utx->tx);
 
@@ -255,6 +320,8 @@ static struct command_result *newaddr_done(struct command *cmd,
 		txp->outputs + pos,
 		sizeof(txp->outputs[0]) * (num - pos));
 
+	if (txp->batch)
+		txp->batch->change_outnum = pos;
 	txp->outputs[pos].amount = txp->change_amount;
 	txp->outputs[pos].is_to_external = false;
 	if (json_to_address_scriptpubkey(txp, chainparams, buf, addr,
@@ -418,6 +485,7 @@ static struct command_result *json_txprepare(struct command *cmd,
 		return command_param_failed();
 
 	txp->is_upgrade = false;
+	txp->batch = NULL;
 	return txprepare_continue(cmd, txp, feerate, minconf, utxos, false, false);
 }
 
@@ -545,9 +613,126 @@ static struct command_result *json_withdraw(struct command *cmd,
 		+ bitcoin_tx_output_weight(tal_bytelen(scriptpubkey));
 
 	txp->is_upgrade = false;
+	txp->batch = NULL;
 	return txprepare_continue(cmd, txp, feerate, minconf, utxos, true, false);
 }
 
+/* If the first command of the batch fails, so do the rest. */
+static void destroy_withdraw_batch(struct withdraw_batch *batch)
+{
+	for (size_t i = 1; i < tal_count(batch->cmds); i++) {
+		if (!batch->cmds[i])
+			continue;
+		discard_result(command_fail(batch->cmds[i], LIGHTNINGD,
+					    "Batched withdrawal failed:"
+					    " see the error for id %s",
+					    batch->cmds[0]->id));
+	}
+}
+
+static void destroy_queued_withdraw(struct queued_withdraw *qw)
+{
+	list_del_from(&withdraw_queue, &qw->list);
+	withdraw_queue_len--;
+}
+
+/* Turn everything queued into one withdrawal, run by the oldest command. */
+static void flush_withdraw_queue(struct plugin *plugin)
+{
+	struct queued_withdraw *qw;
+	struct withdraw_batch *batch;
+	struct txprepare *txp;
+	struct command *cmd;
+	size_t i;
+
+	withdraw_timer = tal_free(withdraw_timer);
+	if (list_empty(&withdraw_queue))
+		return;
+
+	cmd = list_top(&withdraw_queue, struct queued_withdraw, list)->cmd;
+	txp = tal(cmd, struct txprepare);
+	batch = txp->batch = tal(txp, struct withdraw_batch);
+	batch->cmds = tal_arr(batch, struct command *, withdraw_queue_len);
+	batch->change_outnum = -1;
+	txp->outputs = tal_arr(txp, struct tx_output, withdraw_queue_len);
+	txp->all_output_idx = -1;
+	txp->output_total = AMOUNT_SAT(0);
+	txp->weight = bitcoin_tx_core_weight(1, withdraw_queue_len);
+
+	i = 0;
+	while ((qw = list_top(&withdraw_queue, struct queued_withdraw, list))
+	       != NULL) {
+		batch->cmds[i] = qw->cmd;
+		txp->outputs[i].amount = qw->amount;
+		txp->outputs[i].script = tal_steal(txp->outputs, qw->script);
+		txp->outputs[i].is_to_external = true;
+		txp->weight += bitcoin_tx_output_weight(tal_bytelen(qw->script));
+		/* json_batchwithdraw checked this can't overflow */
+		if (!amount_sat_add(&txp->output_total, txp->output_total,
+				    qw->amount))
+			abort();
+		tal_free(qw);
+		i++;
+	}
+	tal_add_destructor(batch, destroy_withdraw_batch);
+
+	plugin_log(plugin, LOG_DBG, "Sending %zu batched withdrawals",
+		   tal_count(batch->cmds));
+	txp->is_upgrade = false;
+	discard_result(txprepare_continue(cmd, txp, NULL, NULL, NULL,
+					  true, false));
+}
+
+static void withdraw_timer_fired(struct plugin *plugin)
+{
+	/* Timer is freed after this callback returns. */
+	withdraw_timer = NULL;
+	flush_withdraw_queue(plugin);
+	timer_complete(plugin);
+}
+
+static struct command_result *json_batchwithdraw(struct command *cmd,
+						 const char *buffer,
+						 const jsmntok_t *params)
+{
+	struct queued_withdraw *qw = tal(cmd, struct queued_withdraw), *q;
+	struct amount_sat *amount, total;
+
+	if (!param(cmd, buffer, params,
+		   p_req("destination", param_bitcoin_address, &qw->script),
+		   p_req("satoshi", param_sat, &amount),
+		   NULL))
+		return command_param_failed();
+
+	if (amount_sat_less(*amount, chainparams->dust_limit))
+		return command_fail(cmd, FUND_OUTPUT_IS_DUST,
+				    "Output %s would be dust",
+				    type_to_string(tmpctx, struct amount_sat,
+						   amount));
+
+	/* Don't let one request make the whole batch fail. */
+	total = *amount;
+	list_for_each(&withdraw_queue, q, list) {
+		if (!amount_sat_add(&total, total, q->amount))
+			return command_fail(cmd, JSONRPC2_INVALID_PARAMS,
+					    "Output amount overflow");
+	}
+
+	qw->cmd = cmd;
+	qw->amount = *amount;
+	list_add_tail(&withdraw_queue, &qw->list);
+	withdraw_queue_len++;
+	tal_add_destructor(qw, destroy_queued_withdraw);
+
+	if (withdraw_queue_len >= withdraw_batch_max)
+		flush_withdraw_queue(cmd->plugin);
+	else if (!withdraw_timer)
+		withdraw_timer = plugin_timer(cmd->plugin,
+					      time_from_sec(withdraw_batch_delay),
+					      withdraw_timer_fired, cmd->plugin);
+	return command_still_pending(cmd);
+}
+
 struct listfunds_info {
 	struct txprepare *txp;
 	const char *feerate;
@@ -638,6 +823,7 @@ static struct command_result *newaddr_sweep_done(struct command *cmd,
 
 	info->txp = tal(info, struct txprepare);
 	info->txp->is_upgrade = true;
+	info->txp->batch = NULL;
 
 	/* Add output for 'all' to txp */
 	info->txp->outputs = tal_arr(info->txp, struct tx_output, 1);
@@ -720,6 +906,13 @@ static const struct plugin_command commands[] = {
 		"Send to {destination} {satoshi} (or 'all') at optional {feerate} using utxos from {minconf} or {utxos}.",
 		json_withdraw
 	},
+	{
+		"batchwithdraw",
+		"bitcoin",
+		"Queue a withdrawal to {destination}, sent with others in one transaction",
+		"Send {satoshi} to {destination} in the next batch transaction (sent every withdraw-batch-delay seconds, or once withdraw-batch-max are queued).",
+		json_batchwithdraw
+	},
 	{
 		"upgradewallet",
 		"bitcoin",
@@ -733,6 +926,7 @@ static const struct plugin_command commands[] = {
 static void mark_unreleased_txs(struct plugin *plugin, struct htable *memtable)
 {
 	memleak_scan_list_head(memtable, &unreleased_txs);
+	memleak_scan_list_head(memtable, &withdraw_queue);
 }
 #endif
 
@@ -749,5 +943,16 @@ int main(int argc, char *argv[])
 {
 	setup_locale();
 	plugin_main(argv, init, PLUGIN_RESTARTABLE, true, NULL, commands,
-		    ARRAY_SIZE(commands), NULL, 0, NULL, 0, NULL, 0, NULL);
+		    ARRAY_SIZE(commands), NULL, 0, NULL, 0, NULL, 0,
+		    plugin_option("withdraw-batch-delay",
+				  "int",
+				  "Seconds to queue batchwithdraw requests before"
+				  " sending them in one transaction",
+				  u32_option, &withdraw_batch_delay),
+		    plugin_option("withdraw-batch-max",
+				  "int",
+				  "Send queued batchwithdraw requests as soon as"
+				  " this many are queued",
+				  u32_option, &withdraw_batch_max),
+		    NULL);
 }
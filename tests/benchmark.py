@@ -2,8 +2,10 @@ from concurrent import futures
 from fixtures import *  # noqa: F401,F403
 from time import time
 from tqdm import tqdm
+from utils import wait_for
 
 
+import os
 import pytest
 import random
 
@@ -52,6 +54,73 @@ def test_single_hop(node_factory, executor):
     print("Done. %d payments performed in %f seconds (%f payments per second)" % (num_payments, diff, num_payments / diff))
 
 
+def percentiles(samples):
+    samples = sorted(samples)
+    return {p: samples[min(len(samples) - 1, len(samples) * p // 100)]
+            for p in (50, 90, 99)}
+
+
+def test_forward_throughput(node_factory, bitcoind):
+    """Sustained forwarding through one node, from many senders at once.
+
+    Tune with BENCH_SENDERS, BENCH_CHANNELS (between the forwarder and
+    the recipient), BENCH_PAYMENTS and BENCH_CONCURRENCY.
+    """
+    num_senders = int(os.getenv('BENCH_SENDERS', '4'))
+    num_channels = int(os.getenv('BENCH_CHANNELS', '1'))
+    num_forwards = int(os.getenv('BENCH_PAYMENTS', '2000'))
+    concurrency = int(os.getenv('BENCH_CONCURRENCY', '100'))
+
+    senders = node_factory.get_nodes(num_senders)
+    l2, l3 = node_factory.get_nodes(2)
+    for src in senders:
+        src.rpc.connect(l2.info['id'], 'localhost', l2.port)
+        src.fundchannel(l2, 10**7, wait_for_active=False)
+    l2.rpc.connect(l3.info['id'], 'localhost', l3.port)
+    for _ in range(num_channels):
+        l2.fundchannel(l3, 10**7, wait_for_active=False)
+
+    # Bury them deep enough to be announced, and wait for the gossip.
+    bitcoind.generate_block(5)
+    num_chans = 2 * (num_senders + num_channels)
+    for src in senders:
+        wait_for(lambda: len(src.rpc.listchannels()['channels']) == num_chans)
+
+    print("Collecting invoices")
+    invoices = [l3.rpc.invoice(1000, 'fwd-{}'.format(i), 'desc')
+                for i in tqdm(range(num_forwards))]
+    routes = [src.rpc.getroute(l3.info['id'], 1000, 1)['route']
+              for src in senders]
+
+    sem = futures.ThreadPoolExecutor(max_workers=concurrency)
+
+    def do_pay(i):
+        src, route = senders[i % num_senders], routes[i % num_senders]
+        inv = invoices[i]
+        start = time()
+        src.rpc.sendpay(route, inv['payment_hash'],
+                        payment_secret=inv['payment_secret'])
+        src.rpc.waitsendpay(inv['payment_hash'])
+        return time() - start
+
+    print("Forwarding payments")
+    start_time = time()
+    fs = [sem.submit(do_pay, i) for i in range(num_forwards)]
+    latencies = [f.result() for f in tqdm(futures.as_completed(fs),
+                                          total=len(fs))]
+    diff = time() - start_time
+    sem.shutdown()
+
+    print("Done. %d forwards in %f seconds (%f forwards per second)"
+          % (num_forwards, diff, num_forwards / diff))
+    for p, v in percentiles(latencies).items():
+        print("end-to-end p%d: %.1f msec" % (p, v * 1000))
+    for s in l2.rpc.getforwardlatency()['stages']:
+        print("forwarder %s: count %d p50 %dus p90 %dus p99 %dus max %dus"
+              % (s['stage'], s['count'], s['p50_usec'], s['p90_usec'],
+                 s['p99_usec'], s['max_usec']))
+
+
 def test_single_payment(node_factory, benchmark):
     l1, l2 = node_factory.line_graph(2)
 
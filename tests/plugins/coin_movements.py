@@ -19,6 +19,22 @@ def notify_coin_movement(plugin, coin_movement, **kwargs):
         f.write(json.dumps(coin_movement) + ',')
 
 
+@plugin.subscribe("coin_movements")
+def notify_coin_movements(plugin, coin_movements, **kwargs):
+    with open('batched_moves.json', 'a') as f:
+        f.write(json.dumps(coin_movements) + ',')
+
+
+@plugin.method('listcoinmoves_batched')
+def return_batched_moves(plugin):
+    result = []
+    if os.path.exists('batched_moves.json'):
+        with open('batched_moves.json', 'r') as f:
+            jd = f.read()
+        result = json.loads('[' + jd[:-1] + ']')
+    return {'batches': result}
+
+
 @plugin.method('listcoinmoves_plugin')
 def return_moves(plugin):
     result = []
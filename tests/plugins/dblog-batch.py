@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Like dblog.py, but registers the db_write hook in batch mode.
+"""
+from pyln.client import Plugin, RpcError
+import sqlite3
+
+plugin = Plugin()
+plugin.sqlite_pre_init_cmds = []
+plugin.initted = False
+plugin.data_version = None
+
+
+@plugin.init()
+def init(configuration, options, plugin):
+    if not plugin.get_option('dblog-file'):
+        raise RpcError("No dblog-file specified")
+    plugin.conn = sqlite3.connect(plugin.get_option('dblog-file'),
+                                  isolation_level=None)
+    plugin.conn.execute("PRAGMA foreign_keys = ON;")
+    plugin.conn.execute("BEGIN TRANSACTION;")
+    for c in plugin.sqlite_pre_init_cmds:
+        plugin.conn.execute(c)
+    plugin.conn.execute("COMMIT;")
+
+    plugin.initted = True
+    plugin.log("initialized {}".format(configuration))
+
+
+@plugin.hook('db_write', batch=True)
+def db_write(plugin, batch, **kwargs):
+    plugin.log("got batch of {}".format(len(batch)))
+    for b in batch:
+        # Change sets must arrive in order.
+        if plugin.data_version is not None:
+            assert b['data_version'] == plugin.data_version + 1
+        plugin.data_version = b['data_version']
+
+        if not plugin.initted:
+            plugin.sqlite_pre_init_cmds += b['writes']
+        else:
+            plugin.conn.execute("BEGIN TRANSACTION;")
+            for c in b['writes']:
+                plugin.conn.execute(c)
+            plugin.conn.execute("COMMIT;")
+
+    return {"batch": [{"result": "continue"}] * len(batch)}
+
+
+plugin.add_option('dblog-file', None, 'The db file to create.')
+plugin.run()
@@ -0,0 +1,16 @@
+#!/usr/bin/env python3
+"""This plugin subscribes to forward_event, but only wants some fields.
+"""
+from pyln.client import Plugin
+
+plugin = Plugin()
+
+
+@plugin.subscribe("forward_event",
+                  filter={"forward_event": {"status": True,
+                                            "payment_hash": True}})
+def on_forward_event(plugin, forward_event, **kwargs):
+    plugin.log("filtered forward_event: {}".format(sorted(forward_event.keys())))
+
+
+plugin.run()
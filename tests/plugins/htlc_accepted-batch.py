@@ -0,0 +1,15 @@
+#!/usr/bin/env python3
+"""A plugin which gets htlc_accepted calls in batches.
+"""
+from pyln.client import Plugin
+
+plugin = Plugin()
+
+
+@plugin.hook('htlc_accepted', batch=True)
+def on_htlc_accepted(batch, plugin, **kwargs):
+    plugin.log("htlc_accepted batch of {}".format(len(batch)))
+    return {'batch': [{'result': 'continue'} for _ in batch]}
+
+
+plugin.run()
@@ -0,0 +1,17 @@
+#!/usr/bin/env python3
+from pyln.client import Plugin
+import time
+
+"""A slow htlc_accepted hook which doesn't mind being called in parallel.
+"""
+plugin = Plugin()
+
+
+@plugin.hook('htlc_accepted', parallel=True)
+def on_htlc_accepted(htlc, plugin, **kwargs):
+    print("htlc_accepted called")
+    time.sleep(3)
+    return {'result': 'continue'}
+
+
+plugin.run()
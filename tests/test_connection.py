@@ -1943,6 +1943,32 @@ def test_listpeers_crash(node_factory, bitcoind, executor):
     fut.result()
 
 
+def test_listpeerchannels_since(node_factory):
+    l1, l2, l3 = node_factory.line_graph(3, wait_for_announce=True)
+
+    ret = l1.rpc.listpeerchannels()
+    idx = ret['change_index']
+    assert all(c['change_index'] <= idx for c in ret['channels'])
+
+    # Nothing changed.
+    assert l1.rpc.listpeerchannels(since=idx)['channels'] == []
+
+    # A payment changes the balance (and HTLCs) of that channel only.
+    inv = l3.rpc.invoice(100000, 'since', 'since')['bolt11']
+    l1.rpc.pay(inv)
+    ret = l1.rpc.listpeerchannels(since=idx)
+    assert [c['peer_id'] for c in ret['channels']] == [l2.info['id']]
+    assert ret['channels'][0]['change_index'] > idx
+
+    # Disconnecting touches the peer's channels.
+    idx = ret['change_index']
+    l1.rpc.disconnect(l2.info['id'], force=True)
+    wait_for(lambda: l1.rpc.listpeerchannels(since=idx)['channels'] != [])
+
+    # A since from the future (eg. before a restart) gets everything.
+    assert len(l1.rpc.listpeerchannels(since=idx + 10**9)['channels']) == 1
+
+
 @pytest.mark.openchannel('v1')
 @pytest.mark.openchannel('v2')
 def test_multifunding_one(node_factory, bitcoind):
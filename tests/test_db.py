@@ -442,6 +442,40 @@ def test_sqlite3_builtin_backup(bitcoind, node_factory):
     assert(len(l1.rpc.listfunds()['outputs']) == 1)
 
 
+@unittest.skipIf(os.getenv('TEST_DB_PROVIDER', 'sqlite3') != 'sqlite3', "Tests a feature unique to SQLITE3 backend")
+def test_sqlite3_wal(bitcoind, node_factory):
+    l1 = node_factory.get_node(start=False)
+    main_db_file = l1.db.path
+    backup_db_file = main_db_file + ".bak"
+
+    l1.daemon.opts['sqlite3-wal'] = None
+    l1.daemon.opts['wallet'] = "sqlite3://" + main_db_file + ':' + backup_db_file
+    l1.start()
+    assert os.path.exists(main_db_file + '-wal')
+    # The backup stays self-contained.
+    assert not os.path.exists(backup_db_file + '-wal')
+
+    addr = l1.rpc.newaddr()['bech32']
+    bitcoind.rpc.sendtoaddress(addr, 1)
+    bitcoind.generate_block(1)
+    wait_for(lambda: len(l1.rpc.listfunds()['outputs']) == 1)
+
+    # Clean shutdown checkpoints everything into the db file.
+    l1.stop()
+    assert not os.path.exists(main_db_file + '-wal')
+
+    del l1.daemon.opts['sqlite3-wal']
+    del l1.daemon.opts['wallet']
+    l1.start()
+    assert(len(l1.rpc.listfunds()['outputs']) == 1)
+    l1.stop()
+
+    # And the backup got it all too.
+    shutil.copyfile(backup_db_file, main_db_file)
+    l1.start()
+    assert(len(l1.rpc.listfunds()['outputs']) == 1)
+
+
 @unittest.skipIf(os.getenv('TEST_DB_PROVIDER', 'sqlite3') != 'sqlite3', "Don't know how to swap dbs in Postgres")
 def test_db_sanity_checks(bitcoind, node_factory):
     l1, l2 = node_factory.get_nodes(2, opts=[{'allow_broken_log': True,
@@ -511,9 +545,33 @@ def test_db_forward_migrate(bitcoind, node_factory):
     # The two null in_htlc_id are replaced with bogus entries!
     assert sum([f['in_htlc_id'] > 0xFFFFFFFFFFFF for f in l1.rpc.listforwards()['forwards']]) == 2
 
+    # Old forwards are numbered in the background, in received order.
+    l1.daemon.wait_for_log('Background migration bgmigrate_forwards_created_index complete')
+    assert [f['created_index'] for f in l1.rpc.listforwards()['forwards']] == [1, 2, 3, 4]
+
     # Make sure autoclean can handle these!
     l1.stop()
     l1.daemon.opts['autoclean-succeededforwards-age'] = 2
     l1.daemon.opts['autoclean-cycle'] = 1
     l1.start()
     wait_for(lambda: l1.rpc.listforwards()['forwards'] == [])
+
+
+def test_group_commit(node_factory, bitcoind):
+    """Payments flow normally with group commit, and survive a restart."""
+    opts = {'group-commit-time': 50}
+    l1, l2 = node_factory.line_graph(2, opts=opts, wait_for_announce=True)
+
+    assert l1.rpc.listconfigs()['group-commit-time'] == 50
+
+    for i in range(10):
+        inv = l2.rpc.invoice(1000 + i, 'gc{}'.format(i), 'group commit')
+        l1.rpc.pay(inv['bolt11'])
+
+    # A restart must not lose anything we told the other side about.
+    l1.restart()
+    l2.restart()
+    assert len([p for p in l1.rpc.listpays()['pays']
+                if p['status'] == 'complete']) == 10
+    assert len([i for i in l2.rpc.listinvoices()['invoices']
+                if i['status'] == 'paid']) == 10
@@ -487,6 +487,49 @@ def test_gossip_jsonrpc(node_factory):
     assert [c['public'] for c in l2.rpc.listchannels()['channels']] == [True, True]
 
 
+def test_listchannels_listnodes_filters(node_factory):
+    l1, l2, l3 = node_factory.line_graph(3, wait_for_announce=True,
+                                         opts=[{}, {}, {'fee-base': 2000,
+                                                        'fee-per-satoshi': 500}])
+    scid23 = l2.get_channel_scid(l3)
+    wait_for(lambda: len(l1.rpc.listchannels()['channels']) == 4)
+    wait_for(lambda: len([n for n in l1.rpc.listnodes()['nodes'] if 'last_timestamp' in n]) == 3)
+
+    chans = l1.rpc.listchannels()['channels']
+    # Filters are applied per direction.
+    assert l1.rpc.listchannels(max_base_fee_msat=1999)['channels'] == [c for c in chans if c['base_fee_millisatoshi'] <= 1999]
+    assert [c['short_channel_id'] for c in l1.rpc.listchannels(max_fee_ppm=499)['channels']].count(scid23) == 1
+    assert [c['source'] for c in l1.rpc.listchannels(source=l3.info['id'])['channels']] == [l3.info['id']]
+    assert l1.rpc.listchannels(source=l3.info['id'], max_fee_ppm=499)['channels'] == []
+
+    assert l1.rpc.listchannels(active=True)['channels'] == chans
+    assert l1.rpc.listchannels(active=False)['channels'] == []
+
+    capacity = chans[0]['amount_msat']
+    assert l1.rpc.listchannels(min_capacity_msat=capacity)['channels'] == chans
+    assert l1.rpc.listchannels(max_capacity_msat=capacity - 1)['channels'] == []
+
+    newest = max(c['last_update'] for c in chans)
+    assert l1.rpc.listchannels(updated_since=newest)['channels'] == [c for c in chans if c['last_update'] >= newest]
+    assert l1.rpc.listchannels(updated_since=newest + 1)['channels'] == []
+
+    # No channel features are defined yet.
+    assert l1.rpc.listchannels(feature=0)['channels'] == []
+
+    # All our nodes support var_onion_optin (bit 8/9).
+    nodes = l1.rpc.listnodes()['nodes']
+    assert l1.rpc.listnodes(feature=9)['nodes'] == nodes
+    assert l1.rpc.listnodes(feature=8)['nodes'] == nodes
+    assert l1.rpc.listnodes(feature=1000)['nodes'] == []
+    newest = max(n['last_timestamp'] for n in nodes)
+    assert l1.rpc.listnodes(updated_since=newest)['nodes'] == [n for n in nodes if n['last_timestamp'] >= newest]
+    assert l1.rpc.listnodes(updated_since=newest + 1)['nodes'] == []
+    assert l1.rpc.listnodes(l2.info['id'], updated_since=newest + 1)['nodes'] == []
+
+    with pytest.raises(RpcError, match=r'should be a valid feature bit'):
+        l1.rpc.listnodes(feature=65535 * 8)
+
+
 @pytest.mark.developer("Too slow without --dev-fast-gossip")
 def test_gossip_badsig(node_factory, bitcoind):
     """Make sure node announcement signatures are ok.
@@ -546,6 +589,26 @@ def test_gossip_weirdalias(node_factory, bitcoind):
 
 
 @pytest.mark.developer("needs DEVELOPER=1 for --dev-no-reconnect")
+@pytest.mark.developer("needs --dev-fast-gossip")
+def test_gossip_fast_sync(node_factory, bitcoind):
+    """A new node with gossip-fast-sync gets gossip from several peers at once"""
+    l1, l2, l3, l4 = node_factory.line_graph(4, wait_for_announce=True)
+
+    # Wait for all the gossip to get everywhere.
+    scids = sorted(c['short_channel_id'] for c in l1.rpc.listchannels()['channels'])
+    for n in (l2, l3, l4):
+        wait_for(lambda: sorted(c['short_channel_id'] for c in n.rpc.listchannels()['channels']) == scids)
+
+    l5 = node_factory.get_node(options={'gossip-fast-sync': 3})
+    for n in (l1, l2, l3):
+        l5.rpc.connect(n.info['id'], 'localhost', n.port)
+
+    l5.daemon.wait_for_log('seeker: state = FAST_SYNCING Fast sync of blocks .* from [23] peers')
+    l5.daemon.wait_for_log('seeker: fast sync complete')
+    wait_for(lambda: sorted(c['short_channel_id'] for c in l5.rpc.listchannels()['channels']) == scids)
+    wait_for(lambda: len(l5.rpc.listnodes()['nodes']) == 4)
+
+
 def test_gossip_persistence(node_factory, bitcoind):
     """Gossip for a while, restart and it should remember.
 
@@ -1482,6 +1545,78 @@ def test_getroute_exclude_duplicate(node_factory):
     assert route == route3
 
 
+def test_getroutes(node_factory):
+    """Test that getroutes answers like getroute, one query at a time"""
+    l1, l2, l3 = node_factory.line_graph(3, wait_for_announce=True)
+
+    route12 = l1.rpc.getroute(l2.info['id'], 1000, 1)['route']
+    route13 = l1.rpc.getroute(l3.info['id'], 1000, 1)['route']
+    route23 = l1.rpc.getroute(l3.info['id'], 1000, 1,
+                              fromid=l2.info['id'])['route']
+    chan_l2l3 = route13[1]['channel'] + '/' + str(route13[1]['direction'])
+
+    routes = l1.rpc.getroutes([{'id': l2.info['id'],
+                                'amount_msat': 1000, 'riskfactor': 1},
+                               # These two share one dijkstra.
+                               {'id': l3.info['id'],
+                                'amount_msat': 1000, 'riskfactor': 1},
+                               {'id': l3.info['id'], 'fromid': l2.info['id'],
+                                'amount_msat': 1000, 'riskfactor': 1},
+                               {'id': l3.info['id'], 'exclude': [chan_l2l3],
+                                'amount_msat': 1000, 'riskfactor': 1},
+                               {'id': '0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798',
+                                'amount_msat': 1000, 'riskfactor': 1}])['routes']
+    assert len(routes) == 5
+    assert routes[0]['route'] == route12
+    assert routes[1]['route'] == route13
+    assert routes[2]['route'] == route23
+    assert routes[3]['error']['code'] == 205
+    assert routes[4]['error']['code'] == -32602
+    assert 'unknown destination node_id' in routes[4]['error']['message']
+
+
+def test_getroute_cache(node_factory):
+    """getroute remembers routes, until the gossip changes"""
+    l1, l2, l3 = node_factory.line_graph(3, wait_for_announce=True)
+
+    route1 = l1.rpc.getroute(l3.info['id'], 1900, 1)['route']
+    # Same amount, so we reuse the path (with the new delays).
+    route2 = l1.rpc.getroute(l3.info['id'], 1900, 1, cltv=20)['route']
+    l1.daemon.wait_for_log('Reusing cached route to {}'.format(l3.info['id']))
+    assert [h['channel'] for h in route2] == [h['channel'] for h in route1]
+    assert route2[1]['amount_msat'] == 1900
+    assert route2[0]['amount_msat'] == 1900 + 1
+    assert route2[1]['delay'] == 20
+    assert route2[0]['delay'] == route1[0]['delay'] - route1[1]['delay'] + 20
+
+    # New gossip means we calculate it again.
+    scid23 = route1[1]['channel']
+    l2.rpc.setchannel(l3.info['id'], feebase=100)
+    wait_for(lambda: [c['base_fee_millisatoshi'] for c in l1.rpc.listchannels(scid23)['channels'] if c['source'] == l2.info['id']] == [100])
+    assert l1.rpc.getroute(l3.info['id'], 1900, 1)['route'][0]['amount_msat'] == 1900 + 100
+
+
+def test_getroute_cache_amount(node_factory, bitcoind):
+    """getroute doesn't reuse a route found for a different amount"""
+    l1, l2, l3 = node_factory.line_graph(3, wait_for_announce=True)
+
+    # A direct channel, but it only takes HTLCs up to 1500000msat.
+    l1.rpc.connect(l3.info['id'], 'localhost', l3.port)
+    scid13, _ = l1.fundchannel(l3, 1000000)
+    mine_funding_to_announce(bitcoind, [l1, l2, l3])
+    l1.rpc.setchannel(l3.info['id'], htlcmax=1500000)
+    wait_for(lambda: [c['htlc_maximum_msat'] for c in l1.rpc.listchannels(scid13)['channels'] if c['source'] == l1.info['id']] == [1500000])
+
+    # Too big for the direct channel, so this goes via l2...
+    route = l1.rpc.getroute(l3.info['id'], 1900000, 1)['route']
+    assert len(route) == 2
+
+    # ... but this one fits, so it's direct (even though both amounts
+    # are within the same power of two).
+    route = l1.rpc.getroute(l3.info['id'], 1100000, 1)['route']
+    assert [h['channel'] for h in route] == [scid13]
+
+
 @pytest.mark.developer("gossip propagation is slow without DEVELOPER=1")
 def test_getroute_exclude(node_factory, bitcoind):
     """Test getroute's exclude argument"""
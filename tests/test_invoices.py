@@ -67,6 +67,51 @@ def test_invoice(node_factory, chainparams):
     assert b11['min_final_cltv_expiry'] == 99
 
 
+def test_invoicebatch(node_factory):
+    l1, l2 = node_factory.line_graph(2, wait_for_announce=True)
+
+    invs = l2.rpc.invoicebatch([{'amount_msat': 1000 + i,
+                                 'label': 'batch{}'.format(i),
+                                 'description': 'pos {}'.format(i)}
+                                for i in range(10)]
+                               + [{'amount_msat': 'any',
+                                   'label': 'batchany',
+                                   'description': 'pos any',
+                                   'expiry': 60,
+                                   'cltv': 99}])['invoices']
+    assert [i['label'] for i in invs] == ['batch{}'.format(i) for i in range(10)] + ['batchany']
+
+    for i, inv in enumerate(invs[:10]):
+        b11 = l2.rpc.decodepay(inv['bolt11'])
+        assert b11['amount_msat'] == 1000 + i
+        assert b11['description'] == 'pos {}'.format(i)
+        assert b11['payment_hash'] == inv['payment_hash']
+        assert only_one(l2.rpc.listinvoices(inv['label'])['invoices'])['status'] == 'unpaid'
+
+    b11 = l2.rpc.decodepay(invs[10]['bolt11'])
+    assert 'amount_msat' not in b11
+    assert b11['expiry'] == 60
+    assert b11['min_final_cltv_expiry'] == 99
+
+    # They're all payable.
+    l1.rpc.pay(invs[3]['bolt11'])
+    assert only_one(l2.rpc.listinvoices('batch3')['invoices'])['status'] == 'paid'
+
+    # It's all or nothing.
+    with pytest.raises(RpcError, match=r'Duplicate label'):
+        l2.rpc.invoicebatch([{'amount_msat': 1000, 'label': 'batchnew', 'description': 'new'},
+                             {'amount_msat': 1000, 'label': 'batch1', 'description': 'old'}])
+    with pytest.raises(RpcError, match=r'Duplicate label'):
+        l2.rpc.invoicebatch([{'amount_msat': 1000, 'label': 'batchnew', 'description': 'new'},
+                             {'amount_msat': 1000, 'label': 'batchnew', 'description': 'new'}])
+    with pytest.raises(RpcError, match=r'preimage already used'):
+        l2.rpc.invoicebatch([{'amount_msat': 1000, 'label': 'batchnew', 'description': 'new',
+                              'preimage': '00' * 32},
+                             {'amount_msat': 1000, 'label': 'batchnew2', 'description': 'new',
+                              'preimage': '00' * 32}])
+    assert l2.rpc.listinvoices('batchnew')['invoices'] == []
+
+
 def test_invoice_zeroval(node_factory):
     """A zero value invoice is unpayable, did you mean 'any'?"""
     l1 = node_factory.get_node()
@@ -571,6 +616,30 @@ def test_waitanyinvoice_reversed(node_factory, executor):
     assert r['label'] == 'inv1'
 
 
+def test_waitinvoice_many_waiters(node_factory, executor):
+    """Every waiter on an invoice wakes up, and only those"""
+    l1, l2 = node_factory.line_graph(2)
+    inv1 = l2.rpc.invoice(1000, 'inv1', 'inv1')
+    l2.rpc.invoice(1000, 'inv2', 'inv2')
+
+    waitones = [executor.submit(l2.rpc.waitinvoice, 'inv1') for _ in range(3)]
+    waitanys = [executor.submit(l2.rpc.waitanyinvoice) for _ in range(2)]
+    other = executor.submit(l2.rpc.waitinvoice, 'inv2')
+    # One waitany gives up before anything is paid.
+    with pytest.raises(RpcError, match='Timed out'):
+        l2.rpc.waitanyinvoice(timeout=1)
+
+    l1.rpc.pay(inv1['bolt11'])
+    for f in waitones + waitanys:
+        assert f.result(timeout=5)['label'] == 'inv1'
+    time.sleep(1)
+    assert not other.done()
+
+    l2.rpc.delinvoice('inv2', 'unpaid')
+    with pytest.raises(RpcError, match='Invoice deleted during wait'):
+        other.result(timeout=5)
+
+
 def test_autocleaninvoice_deprecated(node_factory):
     l1 = node_factory.get_node(options={'allow-deprecated-apis': True})
 
@@ -707,6 +776,37 @@ def test_listinvoices_filter(node_factory):
         assert len(r['invoices']) == 0
 
 
+def test_listinvoices_pagination(node_factory):
+    """ Test paging through listinvoices with start and limit
+    """
+    l1 = node_factory.get_node()
+
+    for i in range(10):
+        l1.rpc.invoice(42, 'label{}'.format(i), 'desc')
+
+    # Delete one, to make sure it doesn't confuse us.
+    l1.rpc.delinvoice('label3', 'unpaid')
+
+    allinvs = l1.rpc.listinvoices()['invoices']
+    assert len(allinvs) == 9
+    indexes = [i['created_index'] for i in allinvs]
+    assert indexes == sorted(indexes)
+
+    pages = []
+    start = 0
+    while True:
+        page = l1.rpc.listinvoices(start=start, limit=4)['invoices']
+        if page == []:
+            break
+        assert len(page) <= 4
+        pages += page
+        start = page[-1]['created_index'] + 1
+    assert pages == allinvs
+
+    assert l1.rpc.listinvoices(limit=0)['invoices'] == []
+    assert l1.rpc.listinvoices(start=indexes[-1] + 1)['invoices'] == []
+
+
 def test_invoice_deschash(node_factory, chainparams):
     l1, l2 = node_factory.line_graph(2)
 
@@ -1043,6 +1043,29 @@ def test_cli(node_factory):
     assert [l for l in lines if not re.search(r'^help\[[0-9]*\].', l)] == ['format-hint=simple']
 
 
+def test_cli_stream(node_factory):
+    l1 = node_factory.get_node()
+    base = ['cli/lightning-cli',
+            '--network={}'.format(TEST_NETWORK),
+            '--lightning-dir={}'.format(l1.daemon.lightning_dir)]
+
+    # Streamed output matches the normal output, in every format.
+    for fmt in (['-J'], ['-H'], ['-F']):
+        for cmd in (['help', 'help'], ['listconfigs'], ['getinfo']):
+            normal = subprocess.check_output(base + fmt + cmd).decode('utf-8')
+            streamed = subprocess.check_output(base + ['--stream'] + fmt + cmd).decode('utf-8')
+            assert streamed == normal
+
+    # Raw is re-serialized, but it's the same JSON.
+    out = subprocess.check_output(base + ['-S', '-R', 'listconfigs']).decode('utf-8')
+    assert json.loads(out) == l1.rpc.listconfigs()
+
+    # Errors are still errors.
+    ret = subprocess.run(base + ['-S', 'unknown-command'], stdout=subprocess.PIPE)
+    assert ret.returncode == 1
+    assert json.loads(ret.stdout.decode('utf-8'))['code'] == -32601
+
+
 def test_cli_commando(node_factory):
     l1, l2 = node_factory.line_graph(2, fundchannel=False,
                                      opts={'log-level': 'io'})
@@ -1344,6 +1367,20 @@ def test_funding_reorg_remote_lags(node_factory, bitcoind):
     l2.daemon.wait_for_log(r'Deleting channel')
 
 
+def test_multiblock_reorg(node_factory, bitcoind):
+    """A reorg several blocks deep is rolled back in one go"""
+    l1 = node_factory.get_node()
+    bitcoind.generate_block(10)
+    sync_blockheight(bitcoind, [l1])
+    height = bitcoind.rpc.getblockcount()
+
+    # Replaces the last 5 blocks, and adds one.
+    bitcoind.simple_reorg(height - 4)
+    l1.daemon.wait_for_log(r'Reorg: rolling back 5 blocks to {}'
+                           .format(height - 5))
+    sync_blockheight(bitcoind, [l1])
+
+
 def test_rescan(node_factory, bitcoind):
     """Test the rescan option
     """
@@ -1388,6 +1425,38 @@ def test_rescan(node_factory, bitcoind):
     assert not l1.daemon.is_in_log(r'Adding block 102')
 
 
+@unittest.skipIf(TEST_NETWORK != 'regtest', "elementsd has no block filters")
+def test_use_blockfilters(node_factory, bitcoind):
+    """With use-blockfilters we only fetch blocks which can interest us"""
+    l1, l2 = node_factory.get_nodes(2, opts=[{'use-blockfilters': True}, {}])
+
+    # Nothing for us in these.
+    bitcoind.generate_block(5)
+    sync_blockheight(bitcoind, [l1])
+    assert not l1.daemon.is_in_log('Block filter for .* matched')
+
+    # A deposit to our wallet does.
+    l1.fundwallet(10**6)
+    l1.daemon.wait_for_log('Block filter for {} matched'
+                           .format(bitcoind.rpc.getblockcount()))
+
+    # Funding, and the close spending it, are seen too.
+    l1.connect(l2)
+    l1.rpc.fundchannel(l2.info['id'], 10**5)
+    bitcoind.generate_block(1, wait_for_mempool=1)
+    l1.daemon.wait_for_log('Block filter for {} matched'
+                           .format(bitcoind.rpc.getblockcount()))
+    bitcoind.generate_block(5)
+    l1.daemon.wait_for_log(' to CHANNELD_NORMAL')
+
+    l1.rpc.close(l2.info['id'])
+    bitcoind.generate_block(1, wait_for_mempool=1)
+    l1.daemon.wait_for_log(' to ONCHAIN')
+    l2.daemon.wait_for_log(' to ONCHAIN')
+
+    assert not l1.daemon.is_in_log('getblockfilterbyheight failed')
+
+
 def test_bitcoind_goes_backwards(node_factory, bitcoind):
     """Check that we refuse to acknowledge bitcoind giving a shorter chain without explicit rescan"""
     l1 = node_factory.get_node(may_fail=True, allow_broken_log=True)
@@ -2661,6 +2730,20 @@ def test_listforwards_and_listhtlcs(node_factory, bitcoind):
     c24_forwards = l2.rpc.listforwards(out_channel=c24)['forwards']
     assert len(c24_forwards) == 1
 
+    # Paging through gives them all, in order.
+    forwards = l2.rpc.listforwards()['forwards']
+    indexes = [f['created_index'] for f in forwards]
+    assert indexes == sorted(indexes)
+    paged = []
+    start = 0
+    while True:
+        page = l2.rpc.listforwards(start=start, limit=2)['forwards']
+        if page == []:
+            break
+        paged += page
+        start = page[-1]['created_index'] + 1
+    assert paged == forwards
+
     # listhtlcs on l1 is the same with or without id specifiers
     c1htlcs = l1.rpc.listhtlcs()['htlcs']
     assert l1.rpc.listhtlcs(c12)['htlcs'] == c1htlcs
@@ -2718,6 +2801,41 @@ def test_listforwards_and_listhtlcs(node_factory, bitcoind):
     l2.rpc.delforward(in_channel=c12, in_htlc_id=2, status='local_failed')
     assert l2.rpc.listforwards() == {'forwards': []}
 
+    # But their hourly totals remain.
+    rollups = l2.rpc.listforwardrollups(in_channel=c12)['forwardrollups']
+    assert sum(r['count'] for r in rollups) == 3
+    assert (sum(r['in_msat'] for r in rollups)
+            == sum(f['in_msat'] for f in all_forwards))
+    assert set((r.get('out_channel'), r['status']) for r in rollups) \
+        == set((f.get('out_channel'), f['status']) for f in all_forwards)
+    assert l2.rpc.listforwardrollups(out_channel=c24)['forwardrollups'] \
+        == [r for r in rollups if r.get('out_channel') == c24]
+    # Fees survive too.
+    assert l2.rpc.getinfo()['fees_collected_msat'] > 0
+
+
+@unittest.skipIf(not hasattr(os, 'sched_getaffinity'), "CPU lists need Linux")
+def test_subdaemon_sched(node_factory):
+    """--subdaemon-sched lowers a subdaemon's priority and pins it"""
+    l1 = node_factory.get_node(options={'subdaemon-sched': 'gossipd:10:0'})
+
+    gossipd = int(l1.subd_pid('gossipd'))
+    assert os.getpriority(os.PRIO_PROCESS, gossipd) == 10
+    assert os.sched_getaffinity(gossipd) == {0}
+
+    # Others are untouched.
+    connectd = int(l1.subd_pid('connectd'))
+    assert os.getpriority(os.PRIO_PROCESS, connectd) == os.getpriority(os.PRIO_PROCESS, 0)
+
+    assert l1.rpc.listconfigs()['subdaemon-sched'] == 'gossipd:10:0'
+
+    # Bad arguments are refused.
+    l1.stop()
+    l1.daemon.opts['subdaemon-sched'] = 'gossipd:20'
+    l1.daemon.start(wait_for_initialized=False, stderr_redir=True)
+    assert l1.daemon.wait() == 1
+    assert l1.daemon.is_in_stderr('nice value must be between -20 and 19')
+
 
 @pytest.mark.openchannel('v1')
 def test_version_reexec(node_factory, bitcoind):
@@ -3019,6 +3137,60 @@ def test_datastore_keylist(node_factory):
                                                                          'hex': b'ab2val2'.hex()}]}
 
 
+def test_datastorebatch(node_factory):
+    l1 = node_factory.get_node()
+
+    ret = l1.rpc.datastorebatch(entries=[{'key': ['a', 'b'], 'string': 'abval'},
+                                         {'key': 'c', 'hex': 'ff'}])
+    assert ret == {'datastore': [{'key': ['a', 'b'],
+                                  'generation': 0,
+                                  'string': 'abval',
+                                  'hex': b'abval'.hex()},
+                                 {'key': ['c'],
+                                  'generation': 0,
+                                  'hex': 'ff'}]}
+
+    # Keys in one batch can't overlap.
+    with pytest.raises(RpcError, match='overlap'):
+        l1.rpc.datastorebatch(entries=[{'key': ['d'], 'string': 'dval'},
+                                       {'key': ['d', 'e'], 'string': 'deval'}])
+
+    # One failure means nothing is written.
+    with pytest.raises(RpcError, match='1202'):
+        l1.rpc.datastorebatch(entries=[{'key': 'd', 'string': 'dval'},
+                                       {'key': 'c', 'hex': 'fe'}])
+    assert l1.rpc.listdatastore('d') == {'datastore': []}
+    assert l1.rpc.listdatastore('c')['datastore'][0]['hex'] == 'ff'
+
+    # Exact matches only, missing ones omitted.
+    ret = l1.rpc.listdatastorebatch(keys=[['c'], ['a'], ['a', 'b'], ['x']])
+    assert ret == {'datastore': [{'key': ['c'],
+                                  'generation': 0,
+                                  'hex': 'ff'},
+                                 {'key': ['a', 'b'],
+                                  'generation': 0,
+                                  'string': 'abval',
+                                  'hex': b'abval'.hex()}]}
+
+    # Deep children are each summarized once, in order.
+    for i in range(5):
+        l1.rpc.datastore(key=['a', 'b2', 'c', str(i)], string='deep')
+    l1.rpc.datastore(key=['a', 'b3'], string='ab3val')
+    assert l1.rpc.listdatastore('a') == {'datastore': [{'key': ['a', 'b'],
+                                                        'generation': 0,
+                                                        'string': 'abval',
+                                                        'hex': b'abval'.hex()},
+                                                       {'key': ['a', 'b2']},
+                                                       {'key': ['a', 'b3'],
+                                                        'generation': 0,
+                                                        'string': 'ab3val',
+                                                        'hex': b'ab3val'.hex()}]}
+    assert l1.rpc.listdatastore() == {'datastore': [{'key': ['a']},
+                                                    {'key': ['c'],
+                                                     'generation': 0,
+                                                     'hex': 'ff'}]}
+
+
 @unittest.skipIf(os.getenv('TEST_DB_PROVIDER', 'sqlite3') != 'sqlite3',
                  "This test requires sqlite3")
 def test_torv2_in_db(node_factory):
@@ -3077,6 +3249,34 @@ def test_field_filter(node_factory, chainparams):
     assert res == {"currency": chainparams['bip173_prefix']}
 
 
+def test_rpc_response_cache(node_factory):
+    """getinfo, listfunds and listpeerchannels may be answered from cache,
+    but never stale"""
+    l1, l2 = node_factory.get_nodes(2)
+
+    assert l1.rpc.getinfo() == l1.rpc.getinfo()
+    assert l1.rpc.getinfo()['num_peers'] == 0
+    assert l1.rpc.listpeerchannels() == {'channels': []}
+
+    # Filters are part of the request.
+    assert l1.rpc.call('getinfo', {}, filter={'id': True}) == {'id': l1.info['id']}
+    assert l1.rpc.getinfo()['num_peers'] == 0
+
+    l1.rpc.connect(l2.info['id'], 'localhost', l2.port)
+    assert l1.rpc.getinfo()['num_peers'] == 1
+
+    # Funds arriving are seen immediately.
+    before = l1.rpc.listfunds()
+    assert before['outputs'] == []
+    l1.fundwallet(10**6)
+    assert len(l1.rpc.listfunds()['outputs']) == 1
+
+    # So is a new channel.
+    l1.rpc.fundchannel(l2.info['id'], 10**5)
+    assert len(l1.rpc.listpeerchannels()['channels']) == 1
+    assert only_one(l1.rpc.listfunds()['channels'])['peer_id'] == l2.info['id']
+
+
 def test_checkmessage_pubkey_not_found(node_factory):
     l1 = node_factory.get_node()
 
@@ -3093,3 +3293,15 @@ def test_checkmessage_pubkey_not_found(node_factory):
     check_result = l1.rpc.checkmessage(msg, zbase, pubkey=pubkey)
     assert check_result["pubkey"] == pubkey
     assert check_result["verified"] is True
+
+
+@pytest.mark.developer("needs dev-memstats")
+def test_dev_memstats(node_factory):
+    l1 = node_factory.get_node()
+
+    stats = l1.rpc.call('dev-memstats', {'limit': 5})
+    assert len(stats['memstats']) == 5
+    assert stats['memstats'][0]['bytes'] >= stats['memstats'][-1]['bytes']
+    assert stats['total_bytes'] >= sum(s['bytes'] for s in stats['memstats'])
+    assert any(s.get('label') == 'struct lightningd'
+               for s in l1.rpc.call('dev-memstats', {'limit': 100000})['memstats'])
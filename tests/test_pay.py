@@ -698,6 +698,29 @@ def test_sendpay(node_factory):
     assert payments[-1]['payment_preimage'] == preimage3
 
 
+def test_commit_batching(node_factory):
+    """A burst of HTLCs shares commitment_signed rounds with commit-batch-time"""
+    opts = {'commit-time': 100, 'commit-batch-time': 2000}
+    l1, l2 = node_factory.line_graph(2, opts=opts)
+    assert l1.rpc.listconfigs()['commit-batch-time'] == 2000
+
+    num = 10
+    invs = [l2.rpc.invoice(1000, 'batch{}'.format(i), 'batch')
+            for i in range(num)]
+    route = l1.rpc.getroute(l2.info['id'], 1000, 1)['route']
+
+    before = len(l1.daemon.logs)
+    for inv in invs:
+        l1.rpc.sendpay(route, inv['payment_hash'],
+                       payment_secret=inv['payment_secret'])
+    for inv in invs:
+        l1.rpc.waitsendpay(inv['payment_hash'])
+
+    sent = [l for l in l1.daemon.logs[before:]
+            if 'Sending commit_sig with' in l]
+    assert len(sent) < num
+
+
 @unittest.skipIf(TEST_NETWORK != 'regtest', "The reserve computation is bitcoin specific")
 def test_sendpay_cant_afford(node_factory):
     # Set feerates the same so we don't have to wait for update.
@@ -3581,6 +3604,23 @@ def test_keysend(node_factory):
     # support it. It MUST fail.
     with pytest.raises(RpcError, match=r"Recipient [0-9a-f]{66} reported an invalid payload"):
         l3.rpc.keysend(l4.info['id'], amt)
+    # It tried directly first.
+    assert l3.daemon.is_in_log(r'Direct keysend to {} failed, trying the long way'.format(l4.info['id']))
+
+
+def test_keysend_direct(node_factory):
+    """Keysend to a peer skips routing, and remembers the channel"""
+    amt = 10000
+    l1, l2 = node_factory.line_graph(2, wait_for_announce=True)
+
+    for i in range(3):
+        ret = l1.rpc.keysend(l2.info['id'], amt)
+        assert ret['status'] == 'complete'
+        assert ret['parts'] == 1
+        assert ret['amount_sent_msat'] == Millisatoshi(amt)
+
+    assert len(l2.rpc.listinvoices()['invoices']) == 3
+    assert not l1.daemon.is_in_log('trying the long way')
 
 
 def test_keysend_strip_tlvs(node_factory):
@@ -3839,6 +3879,79 @@ def test_mpp_presplit(node_factory):
     assert only_one(l1.rpc.listpays()['pays'])['bolt11'] == inv['bolt11']
 
 
+def test_mpp_flowsplit(node_factory, bitcoind):
+    """Two paths which can each take about half of the payment: flow-split
+    should send one part down each, instead of presplit's fixed sizes.
+
+    ```dot
+    digraph {
+      l1 -> l2 -> l4;
+      l1 -> l3 -> l4;
+    }
+    """
+    amt = 7 * 10**8
+    l1, l2, l3, l4 = node_factory.get_nodes(4, opts=[{'flow-split': None},
+                                                     {}, {}, {}])
+    node_factory.join_nodes([l1, l2, l4], fundamount=10**6)
+    node_factory.join_nodes([l1, l3, l4], fundamount=10**6)
+    mine_funding_to_announce(bitcoind, [l1, l2, l3, l4])
+    wait_for(lambda: len(l1.rpc.listchannels()['channels']) == 8)
+
+    inv = l4.rpc.invoice(amt, 'lbl', 'desc')['bolt11']
+    p = l1.rpc.pay(inv)
+    assert p['parts'] >= 2
+    l1.daemon.wait_for_log(r'Split into 2 sub-payments using estimated channel capacities')
+
+
+def test_pay_saves_liquidity(node_factory, bitcoind):
+    """pay remembers remote channels which couldn't take the payment"""
+    l1, l2, l3 = node_factory.get_nodes(3)
+    l1.rpc.connect(l2.info['id'], 'localhost', l2.port)
+    l1.fundchannel(l2, 10**6, wait_for_active=False)
+    # l2 has nothing to send back to l3
+    l3.rpc.connect(l2.info['id'], 'localhost', l2.port)
+    l3.fundchannel(l2, 10**6, wait_for_active=False)
+    mine_funding_to_announce(bitcoind, [l1, l2, l3])
+    wait_for(lambda: len(l1.rpc.listchannels()['channels']) == 4)
+
+    inv = l3.rpc.invoice(10**8, 'lbl', 'desc')['bolt11']
+    with pytest.raises(RpcError):
+        l1.rpc.pay(inv)
+
+    wait_for(lambda: l1.rpc.listdatastore(['pay', 'liquidity'])['datastore'] != [])
+
+
+def test_probe(node_factory, bitcoind):
+    """probe sends unpayable HTLCs and remembers what it learns"""
+    l1, l2, l3 = node_factory.get_nodes(3)
+    l1.rpc.connect(l2.info['id'], 'localhost', l2.port)
+    l1.fundchannel(l2, 10**6, wait_for_active=False)
+    # l2 has nothing to send on to l3
+    l3.rpc.connect(l2.info['id'], 'localhost', l2.port)
+    scid23, _ = l3.fundchannel(l2, 10**6, wait_for_active=False)
+    mine_funding_to_announce(bitcoind, [l1, l2, l3])
+    wait_for(lambda: len(l1.rpc.listchannels()['channels']) == 4)
+
+    probes = l1.rpc.probe(targets=[{'destination': l2.info['id'], 'amount_msat': 10**7},
+                                   {'destination': l3.info['id'], 'amount_msat': 10**7},
+                                   {'destination': l1.info['id'], 'amount_msat': 10**7}],
+                          maxinflight=1)['probes']
+    assert [p['status'] for p in probes] == ['reachable', 'failed', 'noroute']
+    assert probes[0]['hops'] == 1
+    assert probes[1]['hops'] == 2
+    assert probes[1]['erring_index'] == 1
+    assert probes[1]['erring_channel'] == scid23
+    assert probes[1]['failcodename'] == 'WIRE_TEMPORARY_CHANNEL_FAILURE'
+
+    # Nothing was paid, and what we learned was saved.
+    assert [p['status'] for p in l1.rpc.listsendpays()['payments']] == ['failed'] * 2
+    assert l1.rpc.listdatastore(['pay', 'liquidity'])['datastore'] != []
+
+    with pytest.raises(RpcError, match='maxinflight'):
+        l1.rpc.probe(targets=[{'destination': l2.info['id'], 'amount_msat': 10**7}],
+                     maxinflight=0)
+
+
 def test_mpp_adaptive(node_factory, bitcoind):
     """We have two paths, both too small on their own, let's combine them.
 
@@ -4121,6 +4234,14 @@ def test_listsendpays_and_listpays_order(node_factory):
     created_at = [p['created_at'] for p in l1.rpc.listpays()['pays']]
     assert created_at == sorted(created_at)
 
+    # Paging through gives the same thing.
+    pays = l1.rpc.listsendpays()['payments']
+    assert l1.rpc.listsendpays(limit=2)['payments'] == pays[:2]
+    assert l1.rpc.listsendpays(start=pays[2]['id'], limit=2)['payments'] == pays[2:4]
+    assert l1.rpc.listsendpays(start=pays[4]['id'])['payments'] == pays[4:]
+    assert l1.rpc.listsendpays(start=pays[4]['id'] + 1)['payments'] == []
+    assert l1.rpc.listsendpays(status='complete', limit=3)['payments'] == pays[:3]
+
 
 @pytest.mark.developer("needs use_shadow")
 def test_mpp_waitblockheight_routehint_conflict(node_factory, bitcoind, executor):
@@ -354,6 +354,24 @@ def test_plugin_disable(node_factory):
     assert n.rpc.listconfigs()['disable-plugin'] == ['something-else.py', 'helloworld.py']
 
 
+def test_plugin_lazy(node_factory):
+    """--lazy-plugin defers init until a method is called"""
+    plugin_path = os.path.join(os.getcwd(), 'contrib/plugins/helloworld.py')
+    n = node_factory.get_node(options={'plugin': plugin_path,
+                                       'lazy-plugin': 'helloworld.py'})
+    assert n.rpc.listconfigs()['lazy-plugin'] == ['helloworld.py']
+    assert not n.daemon.is_in_log('Plugin helloworld.py initialized')
+    assert [p['active'] for p in n.rpc.plugin_list()['plugins']
+            if p['name'] == plugin_path] == [False]
+
+    # First call starts it, and then gets answered.
+    assert n.rpc.hello(name='Sun') == 'Hello Sun'
+    n.daemon.wait_for_logs(['Lazy plugin needed for hello: starting',
+                            'Plugin helloworld.py initialized'])
+    assert [p['active'] for p in n.rpc.plugin_list()['plugins']
+            if p['name'] == plugin_path] == [True]
+
+
 def test_plugin_hook(node_factory, executor):
     """The helloworld plugin registers a htlc_accepted hook.
 
@@ -574,6 +592,29 @@ def test_db_hook_multiple(node_factory, executor):
     assert [x for x in db1.iterdump()] == [x for x in db2.iterdump()]
 
 
+@unittest.skipIf(os.getenv('TEST_DB_PROVIDER', 'sqlite3') != 'sqlite3', "Only sqlite3 implements the db_write_hook currently")
+def test_db_hook_batch(node_factory, bitcoind):
+    """A batch db_write plugin gets change sets streamed, in order."""
+    dbfile = os.path.join(node_factory.directory, "dblog.sqlite3")
+    l1, l2 = node_factory.line_graph(2, opts=[{'plugin': os.path.join(os.getcwd(), 'tests/plugins/dblog-batch.py'),
+                                               'dblog-file': dbfile,
+                                               'group-commit-time': 20},
+                                              {}])
+
+    assert not l1.daemon.is_in_log('Disabling group-commit-time')
+    for i in range(10):
+        inv = l2.rpc.invoice(1000, 'batch{}'.format(i), 'db_write batch')
+        l1.rpc.pay(inv['bolt11'])
+
+    l1.stop()
+
+    # Databases should be identical.
+    db1 = sqlite3.connect(os.path.join(l1.daemon.lightning_dir, TEST_NETWORK, 'lightningd.sqlite3'))
+    db2 = sqlite3.connect(dbfile)
+
+    assert [x for x in db1.iterdump()] == [x for x in db2.iterdump()]
+
+
 def test_utf8_passthrough(node_factory, executor):
     l1 = node_factory.get_node(options={'plugin': os.path.join(os.getcwd(), 'tests/plugins/utf8.py'),
                                         'log-level': 'io'})
@@ -1264,6 +1305,17 @@ def test_channel_opened_notification(node_factory):
 
 
 @pytest.mark.developer("needs DEVELOPER=1")
+def test_forward_event_notification_filter(node_factory):
+    """A subscription filter means we only get the fields we asked for"""
+    plugin = os.path.join(os.path.dirname(__file__), 'plugins',
+                          'forward_event_filtered.py')
+    l1, l2, l3 = node_factory.line_graph(3, opts=[{}, {'plugin': plugin}, {}],
+                                         wait_for_announce=True)
+
+    l1.pay(l3, 100000)
+    l2.daemon.wait_for_log(r"filtered forward_event: \['payment_hash', 'status'\]")
+
+
 def test_forward_event_notification(node_factory, bitcoind, executor):
     """ test 'forward_event' notifications
     """
@@ -1354,36 +1406,61 @@ def test_forward_event_notification(node_factory, bitcoind, executor):
     for p in plugin_stats:
         del p['payment_hash']
 
-    # use stats to build what we expect went to plugin.
+    # Nor stage timings, which must be in chronological order.
+    for p in plugin_stats:
+        stages = p.pop('stages_usec')
+        assert 'offered' in stages
+        assert list(stages.values()) == sorted(stages.values())
+
+    # use stats to build what we expect went to plugin (which doesn't
+    # know the created_index).
     expect = stats[0].copy()
+    del expect['created_index']
     # First event won't have conclusion.
     del expect['resolved_time']
     del expect['out_htlc_id']
     expect['status'] = 'offered'
     assert plugin_stats[0] == expect
     expect = stats[0].copy()
+    del expect['created_index']
     del expect['out_htlc_id']
     assert plugin_stats[1] == expect
 
     expect = stats[1].copy()
+    del expect['created_index']
     del expect['resolved_time']
     del expect['out_htlc_id']
     expect['status'] = 'offered'
     assert plugin_stats[2] == expect
     expect = stats[1].copy()
+    del expect['created_index']
     del expect['out_htlc_id']
     assert plugin_stats[3] == expect
 
     expect = stats[2].copy()
+    del expect['created_index']
     del expect['failcode']
     del expect['failreason']
     del expect['out_htlc_id']
     expect['status'] = 'offered'
     assert plugin_stats[4] == expect
     expect = stats[2].copy()
+    del expect['created_index']
     del expect['out_htlc_id']
     assert plugin_stats[5] == expect
 
+    stages = {s['stage']: s for s in l2.rpc.getforwardlatency()['stages']}
+    assert stages['offered']['count'] >= 2
+    assert stages['total']['count'] >= 2
+    for s in stages.values():
+        assert s['p50_usec'] <= s['p90_usec'] <= s['p99_usec']
+        assert s['max_usec'] <= s['total_usec']
+
+    metrics = l2.rpc.getmetrics()
+    assert sum(metrics['forwards'].values()) == len(plugin_stats)
+    assert metrics['forwards']['local_failed'] == len([s for s in plugin_stats if s['status'] == 'local_failed'])
+    assert metrics['peers']['connected'] <= metrics['peers']['total']
+
 
 def test_sendpay_notifications(node_factory, bitcoind):
     """ test 'sendpay_success' and 'sendpay_failure' notifications
@@ -1489,6 +1566,37 @@ def test_rpc_command_hook(node_factory):
     l1.rpc.jsonschemas = schemas
 
 
+def test_getrpcstats(node_factory):
+    """getrpcstats counts commands, and the hooks they trigger"""
+    plugin = os.path.join(os.getcwd(), "tests/plugins/rpc_command_1.py")
+    l1 = node_factory.get_node(options={"plugin": plugin})
+
+    before = {c['method']: c for c in l1.rpc.getrpcstats()['commands']}
+    prev_calls = before.get('getinfo', {'calls': 0})['calls']
+    prev_failures = before.get('getinfo', {'failures': 0})['failures']
+
+    for _ in range(3):
+        l1.rpc.getinfo()
+    with pytest.raises(RpcError, match=r'unknown parameter'):
+        l1.rpc.call('getinfo', {'notaparam': 1})
+
+    stats = l1.rpc.getrpcstats()
+    getinfo = [c for c in stats['commands'] if c['method'] == 'getinfo'][0]
+    assert getinfo['calls'] == prev_calls + 4
+    assert getinfo['failures'] == prev_failures + 1
+    assert getinfo['bytes_in'] > 0
+    assert getinfo['bytes_out'] > 0
+    assert getinfo['p50_usec'] <= getinfo['p99_usec'] <= getinfo['max_usec']
+    assert getinfo['max_usec'] <= getinfo['total_usec']
+
+    # Every command went through rpc_command_1's hook.
+    hook = only_one([h for h in stats['hooks']
+                     if h['hook'] == 'rpc_command'
+                     and h['plugin'] == 'rpc_command_1.py'])
+    assert hook['calls'] >= 5
+    assert hook['bytes_out'] > 0
+
+
 def test_libplugin(node_factory):
     """Sanity checks for plugins made with libplugin"""
     plugin = os.path.join(os.getcwd(), "tests/plugins/test_libplugin")
@@ -1759,15 +1867,41 @@ def test_bcli(node_factory, bitcoind, chainparams):
     assert resp["blockhash"] is resp["block"] is None
     resp = l1.rpc.call("getrawblockbyheight", {"height": 50})
     assert resp["blockhash"] is not None and resp["blockhash"] is not None
+
+    # The binary variant writes the same block into a file.
+    path = os.path.join(l1.daemon.lightning_dir, "rawblock-test")
+    resp2 = l1.rpc.call("writerawblockbyheight", {"height": 50, "path": path})
+    assert resp2["blockhash"] == resp["blockhash"]
+    with open(path, "rb") as f:
+        raw = f.read()
+    assert resp2["size"] == len(raw)
+    assert raw.hex() == resp["block"]
+    resp = l1.rpc.call("writerawblockbyheight", {"height": 500, "path": path})
+    assert resp["blockhash"] is None
     # Some other bitcoind-failure cases for this call are covered in
     # tests/test_misc.py
 
+    # Compact block filters: bitcoind runs with -blockfilterindex.
+    if not chainparams['elements']:
+        resp = l1.rpc.call("getrawblockbyheight", {"height": 50})
+        resp2 = l1.rpc.call("getblockfilterbyheight", {"height": 50})
+        assert resp2["blockhash"] == resp["blockhash"]
+        assert resp2["header"] == resp["block"][:160]
+        assert resp2["filter"] == bitcoind.rpc.getblockfilter(resp["blockhash"])["filter"]
+        resp = l1.rpc.call("getblockfilterbyheight", {"height": 500})
+        assert resp["blockhash"] is resp["header"] is resp["filter"] is None
+
     l1.fundwallet(10**5)
     l1.connect(l2)
     fc = l1.rpc.fundchannel(l2.info["id"], 10**4 * 3)
     txo = l1.rpc.call("getutxout", {"txid": fc['txid'], "vout": fc['outnum']})
     assert (Millisatoshi(txo["amount"]) == Millisatoshi(10**4 * 3 * 10**3)
             and txo["script"].startswith("0020"))
+    # The batch version gives the same answers, in order.
+    resp = l1.rpc.call("getutxouts", {"outpoints": [
+        {"txid": fc['txid'], "vout": fc['outnum']},
+        {"txid": fc['txid'], "vout": 100}]})
+    assert resp["utxouts"] == [txo, {"amount": None, "script": None}]
     l1.rpc.close(l2.info["id"])
     # When output is spent, it should give us null !
     wait_for(lambda: l1.rpc.call("getutxout", {
@@ -1779,6 +1913,30 @@ def test_bcli(node_factory, bitcoind, chainparams):
     assert not resp["success"] and "decode failed" in resp["errmsg"]
 
 
+def test_bcli_rpc_http(node_factory, bitcoind, chainparams):
+    """bcli talking JSON-RPC to bitcoind itself, rather than via bitcoin-cli"""
+    l1, l2 = node_factory.get_nodes(2, opts=[{'bitcoin-rpc-http': None}, {}])
+
+    resp = l1.rpc.call("getchaininfo")
+    assert resp["chain"] == chainparams['name']
+
+    # Results are handed back just like bitcoin-cli would.
+    resp = l1.rpc.call("getrawblockbyheight", {"height": 500})
+    assert resp["blockhash"] is resp["block"] is None
+    resp = l1.rpc.call("getrawblockbyheight", {"height": 50})
+    assert resp["blockhash"] == bitcoind.rpc.getblockhash(50)
+    assert resp["block"] == bitcoind.rpc.getblock(resp["blockhash"], 0)
+
+    l1.fundwallet(10**5)
+    l1.connect(l2)
+    fc = l1.rpc.fundchannel(l2.info["id"], 10**4 * 3)
+    txo = l1.rpc.call("getutxout", {"txid": fc['txid'], "vout": fc['outnum']})
+    assert Millisatoshi(txo["amount"]) == Millisatoshi(10**4 * 3 * 10**3)
+
+    resp = l1.rpc.call("sendrawtransaction", {"tx": "dummy", "allowhighfees": False})
+    assert not resp["success"] and "decode failed" in resp["errmsg"]
+
+
 def test_hook_crash(node_factory, executor, bitcoind):
     """Verify that we fail over if a plugin crashes while handling a hook.
 
@@ -2089,6 +2247,24 @@ def test_coin_movement_notices(node_factory, bitcoind, chainparams):
     check_coin_moves(l2, chanid_3, l2_l3_mvts, chainparams)
 
 
+def test_coin_movements_batched(node_factory, bitcoind):
+    """coin_movements carries the same movements as coin_movement, in order"""
+    coin_plugin = os.path.join(os.getcwd(), 'tests/plugins/coin_movements.py')
+    l1, l2 = node_factory.line_graph(2, opts=[{'plugin': coin_plugin}, {}])
+
+    inv = l2.rpc.invoice(10**6, 'batched', 'desc')
+    l1.rpc.pay(inv['bolt11'])
+
+    def flattened():
+        batches = l1.rpc.call('listcoinmoves_batched')['batches']
+        assert all(len(b) > 0 for b in batches)
+        return [m for b in batches for m in b]
+
+    wait_for(lambda: flattened() == l1.rpc.call('listcoinmoves_plugin')['coin_moves'])
+    tags = [m['tags'] for m in flattened()]
+    assert ['invoice'] in tags
+
+
 def test_3847_repro(node_factory, bitcoind):
     """Reproduces the issue in #3847: duplicate response from plugin
 
@@ -2394,6 +2570,41 @@ def test_hook_dep_stable(node_factory):
     l2.daemon.wait_for_log(r"dep_b.py: htlc_accepted called")
 
 
+def test_hook_parallel(node_factory):
+    """Parallel hooks get called without waiting for each other"""
+    par_a = os.path.join(os.path.dirname(__file__), 'plugins/parallel_a.py')
+    par_b = os.path.join(os.path.dirname(__file__), 'plugins/parallel_b.py')
+    dep_a = os.path.join(os.path.dirname(__file__), 'plugins/dep_a.py')
+    l1, l2 = node_factory.line_graph(2, opts=[{},
+                                              {'plugin': [par_a, par_b, dep_a]}])
+
+    l1.pay(l2, 100000)
+
+    # Both get called before either returns...
+    l2.daemon.logsearch_start = 0
+    l2.daemon.wait_for_log(r"Calling htlc_accepted hook of plugin parallel_a.py")
+    l2.daemon.wait_for_log(r"Calling htlc_accepted hook of plugin parallel_b.py")
+    l2.daemon.wait_for_log(r"Plugin parallel_a.py returned from htlc_accepted hook call")
+    l2.daemon.wait_for_log(r"Plugin parallel_b.py returned from htlc_accepted hook call")
+    # ... but dep_a isn't parallel, so waits.
+    l2.daemon.wait_for_log(r"Calling htlc_accepted hook of plugin dep_a.py")
+
+
+def test_htlc_accepted_hook_batch(node_factory):
+    """A batch hook gets arrays of htlcs and returns arrays of results"""
+    plugin = os.path.join(os.path.dirname(__file__), 'plugins/htlc_accepted-batch.py')
+    l1, l2, l3 = node_factory.line_graph(3, opts=[{}, {'plugin': plugin}, {}],
+                                         wait_for_announce=True)
+
+    l1.pay(l3, 100000)
+    l2.daemon.wait_for_log(r"Calling htlc_accepted hook of plugin htlc_accepted-batch.py with batch of 1")
+    l2.daemon.wait_for_log(r"htlc_accepted batch of 1")
+
+    # Works for payments to l2 itself, too.
+    l1.pay(l2, 100000)
+    l2.daemon.wait_for_log(r"htlc_accepted batch of 1")
+
+
 def test_htlc_accepted_hook_failonion(node_factory):
     plugin = os.path.join(os.path.dirname(__file__), 'plugins/htlc_accepted-failonion.py')
     l1, l2 = node_factory.line_graph(2, opts=[{}, {'plugin': plugin}])
@@ -3142,6 +3353,36 @@ def test_autoclean(node_factory):
     assert l2.rpc.getinfo()['fees_collected_msat'] == amt_before
 
 
+def test_bulk_delete(node_factory):
+    l1, l2, l3 = node_factory.line_graph(3, wait_for_announce=True)
+
+    inv1 = l3.rpc.invoice(amount_msat=12300, label='inv1', description='description1')
+    inv2 = l3.rpc.invoice(amount_msat=12300, label='inv2', description='description2')
+    l1.rpc.pay(inv1['bolt11'])
+    l3.rpc.delinvoice('inv2', 'unpaid')
+    with pytest.raises(RpcError, match='WIRE_INCORRECT_OR_UNKNOWN_PAYMENT_DETAILS'):
+        l1.rpc.pay(inv2['bolt11'])
+
+    # Nothing that old.
+    assert l1.rpc.delpays('failed', 1)['deleted'] == 0
+    assert l2.rpc.delforwards('failed', 1)['deleted'] == 0
+
+    fees = l2.rpc.getinfo()['fees_collected_msat']
+    before = int(time.time()) + 1
+
+    assert l1.rpc.delpays('failed', before)['deleted'] == 1
+    assert [p['status'] for p in l1.rpc.listsendpays()['payments']] == ['complete']
+    assert l1.rpc.delpays(status='complete', before=before, limit=1)['deleted'] == 1
+    assert l1.rpc.listsendpays()['payments'] == []
+
+    assert l2.rpc.delforwards('failed', before)['deleted'] == 1
+    assert l2.rpc.delforwards('settled', before)['deleted'] == 1
+    assert l2.rpc.listforwards()['forwards'] == []
+    assert l2.rpc.getinfo()['fees_collected_msat'] == fees
+    rollups = l2.rpc.listforwardrollups()['forwardrollups']
+    assert sorted(r['status'] for r in rollups) == ['failed', 'settled']
+
+
 def test_autoclean_once(node_factory):
     l1, l2, l3 = node_factory.line_graph(3, opts={'may_reconnect': True},
                                          wait_for_announce=True)
@@ -3382,6 +3623,8 @@ def test_sql(node_factory, bitcoind):
                          'type': 'string'},
                         {'name': 'received_time',
                          'type': 'number'},
+                        {'name': 'created_index',
+                         'type': 'u64'},
                         {'name': 'out_channel',
                          'type': 'short_channel_id'},
                         {'name': 'out_htlc_id',
@@ -3426,6 +3669,8 @@ def test_sql(node_factory, bitcoind):
                          'type': 'string'},
                         {'name': 'expires_at',
                          'type': 'u64'},
+                        {'name': 'created_index',
+                         'type': 'u64'},
                         {'name': 'amount_msat',
                          'type': 'msat'},
                         {'name': 'bolt11',
@@ -3922,3 +4167,14 @@ def test_sql_deprecated(node_factory, bitcoind):
 
     #  ret = l1.rpc.sql("SELECT funding_local_msat, funding_remote_msat FROM peerchannels;")
     #  assert ret == {'rows': []}
+
+
+def test_sql_maxrows(node_factory):
+    l1 = node_factory.get_node(options={'sqlmaxrows': 2})
+
+    query = "SELECT 1 UNION SELECT 2 UNION SELECT 3"
+    ret = l1.rpc.sql(query)
+    assert ret['rows'] == [[1], [2]]
+    assert ret['warning_truncated'] == 'Only the first 2 rows returned (sqlmaxrows)'
+
+    assert l1.rpc.sql(query + " LIMIT 2") == {'rows': [[1], [2]]}
@@ -5,7 +5,7 @@ from fixtures import TEST_NETWORK
 from pyln.client import RpcError, Millisatoshi
 from shutil import copyfile
 from utils import (
-    only_one, wait_for, sync_blockheight, EXPERIMENTAL_FEATURES,
+    only_one, wait_for, sync_blockheight, EXPERIMENTAL_FEATURES, TIMEOUT,
     VALGRIND, check_coin_moves, TailableProc, scriptpubkey_addr,
     check_utxos_channel
 )
@@ -205,6 +205,43 @@ def test_withdraw(node_factory, bitcoind):
     l1.rpc.withdraw(l1.rpc.newaddr()["bech32"], 10**5, feerate="1000perkb")
 
 
+def test_batchwithdraw(node_factory, bitcoind, executor):
+    """batchwithdraw requests are queued and sent in one transaction"""
+    l1 = node_factory.get_node(options={'withdraw-batch-delay': 3600,
+                                        'withdraw-batch-max': 3})
+    addr = l1.rpc.newaddr()['bech32']
+    bitcoind.rpc.sendtoaddress(addr, 0.1)
+    bitcoind.generate_block(1)
+    wait_for(lambda: len(l1.rpc.listfunds()['outputs']) == 1)
+
+    waddrs = [bitcoind.rpc.getnewaddress() for _ in range(3)]
+    amounts = [100000, 200000, 300000]
+    futs = [executor.submit(l1.rpc.batchwithdraw, a, amt)
+            for a, amt in zip(waddrs[:2], amounts[:2])]
+    time.sleep(1)
+    assert not any(f.done() for f in futs)
+
+    # The third fills the batch.
+    futs.append(executor.submit(l1.rpc.batchwithdraw, waddrs[2], amounts[2]))
+    results = [f.result(TIMEOUT) for f in futs]
+
+    txid = results[0]['txid']
+    assert all(r['txid'] == txid for r in results)
+    assert len(set(r['outnum'] for r in results)) == 3
+
+    tx = bitcoind.rpc.decoderawtransaction(results[0]['tx'])
+    # Three withdrawals plus change.
+    assert len(tx['vout']) == 4
+    for r, a, amt in zip(results, waddrs, amounts):
+        out = tx['vout'][r['outnum']]
+        assert out['scriptPubKey']['address'] == a
+        assert out['value'] == Decimal(amt) / 10**8
+
+    # Can't queue dust.
+    with pytest.raises(RpcError, match=r'would be dust'):
+        l1.rpc.batchwithdraw(waddrs[0], 1)
+
+
 def test_minconf_withdraw(node_factory, bitcoind):
     """Issue 2518: ensure that ridiculous confirmation levels don't overflow
 
@@ -0,0 +1,94 @@
+#! /bin/sh
+# Runs tools/bench-gossipd.sh at several gossip_store sizes, writes the
+# results as CSV, and optionally compares them against a baseline CSV.
+# Needs bitcoind -regtest (bench-gossipd.sh starts one if not running).
+
+set -e
+
+SIZES="10000 100000 1000000"
+MCP_DIR=../million-channels-project/data/1M/gossip/
+OUTPUT=""
+BASELINE=""
+TOLERANCE=20
+BENCH_ARGS=""
+
+for arg; do
+    case "$arg" in
+	--sizes=*)
+	    SIZES="$(echo "${arg#*=}" | tr , ' ')"
+	    ;;
+	--mcp-dir=*)
+	    MCP_DIR="${arg#*=}"
+	    ;;
+	--output=*)
+	    OUTPUT="${arg#*=}"
+	    ;;
+	--baseline=*)
+	    BASELINE="${arg#*=}"
+	    ;;
+	--tolerance=*)
+	    TOLERANCE="${arg#*=}"
+	    ;;
+	--help)
+	    echo "Usage: tools/bench-gossipd-scaling.sh [--sizes=N,N...] [--mcp-dir=<directory>] [--output=<csv>] [--baseline=<csv>] [--tolerance=<percent>] [TARGETS]"
+	    echo "Sizes are the number of gossip messages loaded from the million-channels dataset (default: $SIZES)."
+	    echo "With --baseline, exits 1 if any result is more than --tolerance percent (default $TOLERANCE) worse."
+	    echo "A previous --output file makes a suitable --baseline."
+	    echo "TARGETS are passed to tools/bench-gossipd.sh."
+	    exit 0
+	    ;;
+	-*)
+	    echo "Unknown arg $arg" >&2
+	    exit 1
+	    ;;
+	*)
+	    BENCH_ARGS="$BENCH_ARGS $arg"
+	    ;;
+    esac
+done
+
+RESULTS="$(mktemp)"
+trap 'rm -f "$RESULTS"' 0
+
+for size in $SIZES; do
+    DIR="$(mktemp -d)"
+    ./devtools/create-gossipstore --csv "$MCP_DIR"/scidSatoshis.csv -i "$MCP_DIR"/1M.gossip --max="$size" -o "$DIR"/gossip_store
+    # bench-gossipd.sh --csv prints a header line, then values each
+    # followed by a comma (and no final newline).
+    # shellcheck disable=SC2086
+    tools/bench-gossipd.sh --dir="$DIR" --csv $BENCH_ARGS > "$DIR"/bench.csv
+    if [ ! -s "$RESULTS" ]; then
+	echo "messages,$(head -n1 "$DIR"/bench.csv)" > "$RESULTS"
+    fi
+    echo "$size,$(tail -n1 "$DIR"/bench.csv | sed 's/,$//')" >> "$RESULTS"
+    rm -rf "$DIR"
+done
+
+if [ -n "$OUTPUT" ]; then
+    cp "$RESULTS" "$OUTPUT"
+fi
+cat "$RESULTS"
+
+[ -n "$BASELINE" ] || exit 0
+
+# Every metric is "lower is better".  Match rows by size and columns by
+# name, so baselines survive adding targets or sizes.
+awk -F, -v tolerance="$TOLERANCE" '
+FNR == 1 { for (i = 1; i <= NF; i++) col[FILENAME, i] = $i; next }
+FILENAME == ARGV[1] {
+    for (i = 2; i <= NF; i++) base[$1, col[FILENAME, i]] = $i
+    next
+}
+{
+    for (i = 2; i <= NF; i++) {
+	name = col[FILENAME, i]
+	if (!(($1, name) in base) || base[$1, name] == "" || $i == "")
+	    continue
+	if ($i > base[$1, name] * (100 + tolerance) / 100) {
+	    printf "REGRESSION: %s at %s messages: %s (baseline %s)\n", name, $1, $i, base[$1, name]
+	    bad = 1
+	}
+    }
+}
+END { exit bad }
+' "$BASELINE" "$RESULTS"
@@ -270,6 +270,28 @@ class Type(FieldSet):
         # FIXME: omits 'pad'
     }
 
+    # On-wire size of fixed-size types (after remapping), so we can give
+    # offsets of fields which don't follow any variable-length ones.
+    wire_sizes = {
+        'u8': 1,
+        'u16': 2,
+        'u32': 4,
+        'u64': 8,
+        'bool': 1,
+        'amount_sat': 8,
+        'amount_msat': 8,
+        'secp256k1_ecdsa_signature': 64,
+        'bitcoin_blkid': 32,
+        'bitcoin_txid': 32,
+        'sha256': 32,
+        'channel_id': 32,
+        'secret': 32,
+        'preimage': 32,
+        'pubkey': 33,
+        'node_id': 33,
+        'short_channel_id': 8,
+    }
+
     # Types that are const pointer-to-pointers, such as chainparams, i.e.,
     # they set a reference to some const entry.
     const_ptr_ptr_types = [
@@ -397,6 +419,21 @@ class Message(FieldSet):
     def add_if(self, if_token):
         self.if_token = if_token
 
+    def fixed_offsets(self):
+        """ (field, offset) for each field at a fixed offset in the
+            message (including the 2-byte type), up to the first variable
+            length field. """
+        offsets = []
+        offset = 2
+        for f in self.fields.values():
+            if f.is_varlen() or f.is_optional or f.is_extension():
+                break
+            if f.type_obj.name not in Type.wire_sizes:
+                break
+            offsets.append((f, offset))
+            offset += Type.wire_sizes[f.type_obj.name] * f.count
+        return offsets
+
 
 class Tlv(object):
     def __init__(self, name):
@@ -545,6 +582,8 @@ class Master(object):
         else:
             stuff['messages'] = list(self.messages.values()) + list(self.extension_msgs.values())
         stuff['subtypes'] = subtypes
+        # Extension messages share names with the originals, so only these
+        stuff['offset_msgs'] = list(self.messages.values())
 
         for line in template.render(**stuff).splitlines():
             print(line.rstrip(), file=output)
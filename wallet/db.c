@@ -2,9 +2,12 @@
 #include <bitcoin/script.h>
 #include <ccan/array_size/array_size.h>
 #include <ccan/build_assert/build_assert.h>
+#include <ccan/cast/cast.h>
 #include <ccan/mem/mem.h>
 #include <ccan/tal/str/str.h>
 #include <common/key_derive.h>
+#include <common/memleak.h>
+#include <common/timeout.h>
 #include <common/version.h>
 #include <db/bindings.h>
 #include <db/common.h>
@@ -13,6 +16,7 @@
 #include <errno.h>
 #include <hsmd/hsmd_wiregen.h>
 #include <lightningd/channel.h>
+#include <lightningd/log.h>
 #include <lightningd/plugin_hook.h>
 #include <wallet/db.h>
 #include <wire/wire_sync.h>
@@ -71,6 +75,14 @@ static void fillin_missing_lease_satoshi(struct lightningd *ld,
 					 struct db *db,
 					 const struct migration_context *mc);
 
+static void migrate_forwards_add_created_index(struct lightningd *ld,
+					       struct db *db,
+					       const struct migration_context *mc);
+
+static void migrate_forward_fees_total(struct lightningd *ld,
+				       struct db *db,
+				       const struct migration_context *mc);
+
 /* Do not reorder or remove elements from this array, it is used to
  * migrate existing databases from a previous state, based on the
  * string indices */
@@ -953,6 +965,37 @@ static struct migration dbmigrations[] = {
     {SQL("ALTER TABLE channels ADD require_confirm_inputs_remote INTEGER DEFAULT 0;"), NULL},
     {SQL("ALTER TABLE channels ADD require_confirm_inputs_local INTEGER DEFAULT 0;"), NULL},
     {NULL, fillin_missing_lease_satoshi},
+    /* So listforwards can be paged through by start/limit */
+    {SQL("ALTER TABLE forwards ADD created_index BIGINT DEFAULT NULL;"),
+     migrate_forwards_add_created_index},
+    {SQL("CREATE INDEX forwards_created_index_idx ON forwards (created_index);"), NULL},
+    /* So listforwards filters don't scan the whole table. */
+    {SQL("CREATE INDEX forwards_state_idx ON forwards (state, created_index);"), NULL},
+    {SQL("CREATE INDEX forwards_in_channel_idx ON forwards (in_channel_scid, created_index);"), NULL},
+    {SQL("CREATE INDEX forwards_out_channel_idx ON forwards (out_channel_scid, created_index);"), NULL},
+    /* Hourly per-channel totals of forwards which have been deleted
+     * (usually by autoclean).  out_channel_scid is 0 for local_failed. */
+    {SQL("CREATE TABLE forward_rollups ("
+	 "in_channel_scid BIGINT"
+	 ", out_channel_scid BIGINT"
+	 ", hour_start BIGINT"
+	 ", state INTEGER"
+	 ", num_forwards BIGINT"
+	 ", in_msatoshi BIGINT"
+	 ", out_msatoshi BIGINT"
+	 ", PRIMARY KEY(in_channel_scid, out_channel_scid, hour_start, state))"), NULL},
+    /* So getinfo doesn't have to SUM every settled forward. */
+    {NULL, migrate_forward_fees_total},
+    /* So delforwards/delpays can find old entries efficiently. */
+    {SQL("CREATE INDEX forwards_state_resolved_idx ON forwards (state, resolved_time);"), NULL},
+    {SQL("CREATE INDEX payments_status_timestamp_idx ON payments (status, timestamp);"), NULL},
+    /* So expiring (and deleting expired) invoices doesn't scan them all. */
+    {SQL("CREATE INDEX invoices_state_expiry_idx ON invoices (state, expiry_time);"), NULL},
+    /* So sendpay/waitsendpay find a payment's latest group without
+     * scanning all its parts. */
+    {SQL("CREATE INDEX payments_hash_groupid_status_idx ON payments (payment_hash, groupid, status);"), NULL},
+    /* So the created_index backfill can walk forwards in order. */
+    {SQL("CREATE INDEX forwards_received_time_idx ON forwards (received_time);"), NULL},
 };
 
 /**
@@ -1029,7 +1072,7 @@ static bool db_migrate(struct lightningd *ld, struct db *db,
 struct db *db_setup(const tal_t *ctx, struct lightningd *ld,
 		    const struct ext_key *bip32_base)
 {
-	struct db *db = db_open(ctx, ld->wallet_dsn);
+	struct db *db = db_open(ctx, ld->wallet_dsn, ld->config.sqlite3_wal);
 	bool migrated;
 
 	db->report_changes_fn = plugin_hook_db_sync;
@@ -1047,6 +1090,11 @@ struct db *db_setup(const tal_t *ctx, struct lightningd *ld,
 	if (migrated && !db->config->vacuum_fn(db))
 		db_fatal("Error vacuuming db: %s", db->error);
 
+	if (ld->wallet_replica_dsn
+	    && !db_set_replica(db, ld->wallet_replica_dsn,
+			       ld->wallet_replica_max_lag))
+		db_fatal("Could not use --wallet-replica: %s", db->error);
+
 	return db;
 }
 
@@ -1596,3 +1644,159 @@ static void fillin_missing_lease_satoshi(struct lightningd *ld,
 	db_exec_prepared_v2(stmt);
 	tal_free(stmt);
 }
+
+/* Numbering existing forwards can take a long time on a big database,
+ * so we only reserve their numbers here: new forwards are numbered after
+ * them, and bgmigrate_forwards_created_index() fills them in later. */
+static void migrate_forwards_add_created_index(struct lightningd *ld,
+					       struct db *db,
+					       const struct migration_context *mc)
+{
+	struct db_stmt *stmt;
+	u64 count;
+
+	stmt = db_prepare_v2(db, SQL("SELECT COUNT(1) FROM forwards;"));
+	db_query_prepared(stmt);
+	db_step(stmt);
+	count = db_col_u64(stmt, "COUNT(1)");
+	tal_free(stmt);
+
+	db_set_intvar(db, "last_forward_created_index", count);
+	if (count)
+		db_set_intvar(db, "bgmigrate_forwards_created_index", 1);
+}
+
+/* Start the running total of forward fees from what we have. */
+static void migrate_forward_fees_total(struct lightningd *ld,
+				       struct db *db,
+				       const struct migration_context *mc)
+{
+	struct db_stmt *stmt;
+	u64 total;
+
+	stmt = db_prepare_v2(db, SQL("SELECT"
+				     " CAST(COALESCE(SUM(in_msatoshi - out_msatoshi), 0) AS BIGINT)"
+				     " FROM forwards "
+				     "WHERE state = ?;"));
+	db_bind_int(stmt, 0, wallet_forward_status_in_db(FORWARD_SETTLED));
+	db_query_prepared(stmt);
+	db_step(stmt);
+	total = db_col_u64(stmt, "CAST(COALESCE(SUM(in_msatoshi - out_msatoshi), 0) AS BIGINT)");
+	tal_free(stmt);
+
+	total += db_get_intvar(db, "deleted_forward_fees", 0);
+	db_set_intvar(db, "total_forward_fees", total);
+}
+
+/* Number (up to @max) existing forwards in the order we received them.
+ * The intvar is the next number to use; no received_time (ancient!)
+ * sorts first on sqlite and last on postgres, but gets done either way. */
+static bool bgmigrate_forwards_created_index(struct db *db, size_t max)
+{
+	struct db_stmt *stmt;
+	u64 created_index, since;
+	size_t done = 0;
+
+	created_index = db_get_intvar(db, "bgmigrate_forwards_created_index", 0);
+	since = db_get_intvar(db, "bgmigrate_forwards_created_index_time", 0);
+
+	/* Rows we've done at exactly @since have a created_index now, so
+	 * they're not returned again. */
+	stmt = db_prepare_v2(db, SQL("SELECT in_channel_scid, in_htlc_id, received_time"
+				     " FROM forwards"
+				     " WHERE created_index IS NULL"
+				     "   AND (received_time IS NULL OR received_time >= ?)"
+				     " ORDER BY received_time, in_channel_scid, in_htlc_id"
+				     " LIMIT ?;"));
+	db_bind_u64(stmt, 0, since);
+	db_bind_u64(stmt, 1, max);
+	db_query_prepared(stmt);
+	while (db_step(stmt)) {
+		struct db_stmt *update_stmt;
+
+		update_stmt = db_prepare_v2(db, SQL("UPDATE forwards SET"
+						    " created_index = ?"
+						    " WHERE in_channel_scid = ?"
+						    "   AND in_htlc_id = ?"));
+		db_bind_u64(update_stmt, 0, created_index++);
+		db_bind_u64(update_stmt, 1,
+			    db_col_u64(stmt, "in_channel_scid"));
+		db_bind_u64(update_stmt, 2, db_col_u64(stmt, "in_htlc_id"));
+		db_exec_prepared_v2(take(update_stmt));
+		if (!db_col_is_null(stmt, "received_time"))
+			since = db_col_u64(stmt, "received_time");
+		done++;
+	}
+	tal_free(stmt);
+
+	if (done < max) {
+		db_set_intvar(db, "bgmigrate_forwards_created_index_time", 0);
+		return true;
+	}
+	db_set_intvar(db, "bgmigrate_forwards_created_index", created_index);
+	db_set_intvar(db, "bgmigrate_forwards_created_index_time", since);
+	return false;
+}
+
+/* Data backfills which would keep us offline too long are scheduled by a
+ * migration above (which sets the intvar non-zero), and done a chunk at a
+ * time once we're running.  Readers must cope with rows not yet done: see
+ * db_background_migration_pending(). */
+struct background_migration {
+	const char *intvar;
+	/* Does up to max rows: returns true once there are none left. */
+	bool (*step)(struct db *db, size_t max);
+};
+
+static const struct background_migration background_migrations[] = {
+	{"bgmigrate_forwards_created_index", bgmigrate_forwards_created_index},
+};
+
+/* Small enough that we don't hold up anything else for long. */
+#define BACKGROUND_MIGRATION_ROWS 1000
+
+struct background_migrator {
+	struct db *db;
+	struct timers *timers;
+	struct log *log;
+};
+
+bool db_background_migration_pending(struct db *db, const char *intvar)
+{
+	return db_get_intvar(db, cast_const(char *, intvar), 0) != 0;
+}
+
+/* Timers are called inside a db transaction, so each chunk is atomic. */
+static void background_migrate(struct background_migrator *bm)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(background_migrations); i++) {
+		const struct background_migration *m = &background_migrations[i];
+
+		if (!db_background_migration_pending(bm->db, m->intvar))
+			continue;
+
+		if (m->step(bm->db, BACKGROUND_MIGRATION_ROWS)) {
+			db_set_intvar(bm->db, cast_const(char *, m->intvar), 0);
+			log_info(bm->log, "Background migration %s complete",
+				 m->intvar);
+		}
+		new_reltimer(bm->timers, bm, time_from_msec(10),
+			     background_migrate, bm);
+		return;
+	}
+	tal_free(bm);
+}
+
+void db_background_migrations_start(struct db *db, struct timers *timers,
+				    struct log *log)
+{
+	/* Only the timer points to it. */
+	struct background_migrator *bm
+		= notleak_with_children(tal(db, struct background_migrator));
+
+	bm->db = db;
+	bm->timers = timers;
+	bm->log = log;
+	/* Let startup finish first. */
+	new_reltimer(timers, bm, time_from_sec(1), background_migrate, bm);
+}
@@ -1,9 +1,12 @@
 #ifndef LIGHTNING_WALLET_DB_H
 #define LIGHTNING_WALLET_DB_H
 #include "config.h"
+#include <stdbool.h>
 
 struct ext_key;
 struct lightningd;
+struct log;
+struct timers;
 struct db_stmt;
 struct db;
 
@@ -22,4 +25,29 @@ struct db;
 struct db *db_setup(const tal_t *ctx, struct lightningd *ld,
 		    const struct ext_key *bip32_base);
 
+/**
+ * db_background_migrations_start - Finish data migrations while we run
+ *
+ * Some migrations only schedule a (long) data backfill, which is done
+ * in small chunks off a timer.
+ *
+ * Params:
+ *  @db: the database from db_setup()
+ *  @timers: the timers to use
+ *  @log: to log when each is complete
+ */
+void db_background_migrations_start(struct db *db, struct timers *timers,
+				    struct log *log);
+
+/**
+ * db_background_migration_pending - Is this backfill still running?
+ *
+ * If so, readers must cope with rows it hasn't reached yet.
+ *
+ * Params:
+ *  @db: the database
+ *  @intvar: the name of the background migration (its intvar)
+ */
+bool db_background_migration_pending(struct db *db, const char *intvar);
+
 #endif /* LIGHTNING_WALLET_DB_H */
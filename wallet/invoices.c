@@ -1,5 +1,10 @@
 #include "config.h"
+#include <ccan/crypto/siphash24/siphash24.h>
+#include <ccan/htable/htable_type.h>
+#include <ccan/intmap/intmap.h>
 #include <ccan/tal/str/str.h>
+#include <common/memleak.h>
+#include <common/pseudorand.h>
 #include <common/timeout.h>
 #include <db/bindings.h>
 #include <db/common.h>
@@ -16,69 +21,143 @@ struct invoice_waiter {
 	/* If !any, the specific invoice this is waiting on */
 	u64 id;
 
+	/* In invoices->any_waiters, or its invoices->waiters_by_id entry */
 	struct list_node list;
+	/* So the last one waiting on an invoice can remove its entry. */
+	struct invoices *invoices;
 
 	/* The callback to use */
-	void (*cb)(const struct invoice *, void*);
+	void (*cb)(const struct invoice *, const struct invoice_details *,
+		   void *);
 	void *cbarg;
 };
 
+/* Everyone waiting on one particular invoice. */
+struct invoice_waiters {
+	struct list_head waiters;
+};
+
+/* We keep all the unpaid invoices in memory, so accepting a payment
+ * doesn't need a db lookup. */
+struct unpaid_invoice {
+	u64 id;
+	struct sha256 rhash;
+	u64 expiry_time;
+	/* In invoices->expiries bucket for expiry_time */
+	struct list_node list;
+};
+
+/* All the unpaid invoices which expire in a given second. */
+struct expiry_bucket {
+	struct list_head invoices;
+};
+
+static const struct sha256 *unpaid_invoice_keyof(const struct unpaid_invoice *u)
+{
+	return &u->rhash;
+}
+
+static size_t rhash_hash(const struct sha256 *rhash)
+{
+	return siphash24(siphash_seed(), rhash, sizeof(*rhash));
+}
+
+static bool unpaid_invoice_eq(const struct unpaid_invoice *u,
+			      const struct sha256 *rhash)
+{
+	return sha256_eq(&u->rhash, rhash);
+}
+
+HTABLE_DEFINE_TYPE(struct unpaid_invoice,
+		   unpaid_invoice_keyof, rhash_hash, unpaid_invoice_eq,
+		   unpaid_invoice_map);
+
 struct invoices {
 	/* The database connection to use. */
 	struct db *db;
+	/* All UNPAID invoices, by payment_hash and by id. */
+	struct unpaid_invoice_map *unpaid;
+	UINTMAP(struct unpaid_invoice *) unpaid_by_id;
+	/* ... and by expiry_time: the first one is the next to expire. */
+	UINTMAP(struct expiry_bucket *) expiries;
 	/* The timers object to use for expirations. */
 	struct timers *timers;
-	/* Waiters waiting for invoices to be paid, expired, or deleted. */
-	struct list_head waiters;
-	/* Earliest time for some invoice to expire */
+	/* Waiters waiting for any invoice to be paid. */
+	struct list_head any_waiters;
+	/* Waiters waiting for one invoice to be paid, expired, or deleted,
+	 * by invoice id. */
+	UINTMAP(struct invoice_waiters *) waiters_by_id;
+	/* Highest pay_index handed out so far (0 if none). */
+	u64 max_pay_index;
+	/* When expiration_timer is set for */
 	u64 min_expiry_time;
 	/* Expiration timer */
 	struct oneshot *expiration_timer;
 };
 
-static void trigger_invoice_waiter(struct invoice_waiter *w,
-				   const struct invoice *invoice)
+/* Removes them from the index: NULL if nobody is waiting on id. */
+static struct invoice_waiters *take_invoice_waiters(struct invoices *invoices,
+						    u64 id)
 {
-	w->triggered = true;
-	w->cb(invoice, w->cbarg);
+	struct invoice_waiters *ws = uintmap_get(&invoices->waiters_by_id, id);
+
+	if (ws) {
+		uintmap_del(&invoices->waiters_by_id, id);
+		tal_steal(tmpctx, ws);
+	}
+	return ws;
 }
 
-static void trigger_invoice_waiter_resolve(struct invoices *invoices,
-					   u64 id,
-					   const struct invoice *invoice)
+static void trigger_invoice_waiters(struct list_head *waiters,
+				    const struct invoice *invoice,
+				    const struct invoice_details *details)
 {
 	struct invoice_waiter *w;
-	struct invoice_waiter *n;
 
-	list_for_each_safe(&invoices->waiters, w, n, list) {
-		if (!w->any && w->id != id)
-			continue;
-		list_del_from(&invoices->waiters, &w->list);
+	while ((w = list_pop(waiters, struct invoice_waiter, list)) != NULL) {
 		tal_steal(tmpctx, w);
-		trigger_invoice_waiter(w, invoice);
+		w->triggered = true;
+		w->cb(invoice, details, w->cbarg);
 	}
 }
+
+static void trigger_invoice_waiter_resolve(struct invoices *invoices,
+					   u64 id,
+					   const struct invoice *invoice)
+{
+	struct invoice_waiters *ws = take_invoice_waiters(invoices, id);
+	const struct invoice_details *details;
+
+	if (!ws && list_empty(&invoices->any_waiters))
+		return;
+
+	/* Look it up once, however many are waiting. */
+	details = invoices_get_details(tmpctx, invoices, *invoice);
+	trigger_invoice_waiters(&invoices->any_waiters, invoice, details);
+	if (ws)
+		trigger_invoice_waiters(&ws->waiters, invoice, details);
+}
+
 static void
 trigger_invoice_waiter_expire_or_delete(struct invoices *invoices,
 					u64 id,
 					const struct invoice *invoice)
 {
-	struct invoice_waiter *w;
-	struct invoice_waiter *n;
+	struct invoice_waiters *ws = take_invoice_waiters(invoices, id);
 
-	list_for_each_safe(&invoices->waiters, w, n, list) {
-		if (w->any || w->id != id)
-			continue;
-		list_del_from(&invoices->waiters, &w->list);
-		tal_steal(tmpctx, w);
-		trigger_invoice_waiter(w, invoice);
-	}
+	if (!ws)
+		return;
+	trigger_invoice_waiters(&ws->waiters, invoice,
+				invoice ? invoices_get_details(tmpctx, invoices,
+							       *invoice)
+				: NULL);
 }
 
 static struct invoice_details *wallet_stmt2invoice_details(const tal_t *ctx,
 							   struct db_stmt *stmt)
 {
 	struct invoice_details *dtl = tal(ctx, struct invoice_details);
+	dtl->created_index = db_col_u64(stmt, "id");
 	dtl->state = db_col_int(stmt, "state");
 
 	db_col_preimage(stmt, "payment_key", &dtl->r);
@@ -139,6 +218,90 @@ static void update_db_expirations(struct invoices *invoices, u64 now)
 	db_exec_prepared_v2(take(stmt));
 }
 
+static void unpaid_add(struct invoices *invoices,
+		       u64 id, const struct sha256 *rhash, u64 expiry_time)
+{
+	struct unpaid_invoice *u = tal(invoices, struct unpaid_invoice);
+	struct expiry_bucket *b;
+
+	u->id = id;
+	u->rhash = *rhash;
+	u->expiry_time = expiry_time;
+	unpaid_invoice_map_add(invoices->unpaid, u);
+	uintmap_add(&invoices->unpaid_by_id, id, u);
+
+	b = uintmap_get(&invoices->expiries, expiry_time);
+	if (!b) {
+		b = tal(invoices, struct expiry_bucket);
+		list_head_init(&b->invoices);
+		uintmap_add(&invoices->expiries, expiry_time, b);
+	}
+	list_add_tail(&b->invoices, &u->list);
+}
+
+static void expiry_bucket_del(struct invoices *invoices,
+			      struct unpaid_invoice *u)
+{
+	struct expiry_bucket *b;
+
+	list_del(&u->list);
+	b = uintmap_get(&invoices->expiries, u->expiry_time);
+	if (list_empty(&b->invoices)) {
+		uintmap_del(&invoices->expiries, u->expiry_time);
+		tal_free(b);
+	}
+}
+
+/* Returns false if it wasn't unpaid. */
+static bool unpaid_del(struct invoices *invoices, u64 id)
+{
+	struct unpaid_invoice *u;
+
+	u = uintmap_del(&invoices->unpaid_by_id, id);
+	if (!u)
+		return false;
+	unpaid_invoice_map_del(invoices->unpaid, u);
+	expiry_bucket_del(invoices, u);
+	tal_free(u);
+	return true;
+}
+
+static void destroy_invoices(struct invoices *invoices)
+{
+	uintmap_clear(&invoices->unpaid_by_id);
+	uintmap_clear(&invoices->expiries);
+	uintmap_clear(&invoices->waiters_by_id);
+}
+
+static void load_unpaid(struct invoices *invoices)
+{
+	struct db_stmt *stmt;
+
+	stmt = db_prepare_v2(invoices->db, SQL("SELECT id, payment_hash, expiry_time"
+					       "  FROM invoices"
+					       " WHERE state = ?;"));
+	db_bind_int(stmt, 0, UNPAID);
+	db_query_prepared(stmt);
+	while (db_step(stmt)) {
+		struct sha256 rhash;
+
+		db_col_sha256(stmt, "payment_hash", &rhash);
+		unpaid_add(invoices, db_col_u64(stmt, "id"), &rhash,
+			   db_col_u64(stmt, "expiry_time"));
+	}
+	tal_free(stmt);
+}
+
+#if DEVELOPER
+static void memleak_help_invoices(struct htable *memtable,
+				  struct invoices *invoices)
+{
+	memleak_scan_htable(memtable, &invoices->unpaid->raw);
+	memleak_scan_uintmap(memtable, &invoices->expiries);
+	memleak_scan_uintmap(memtable, &invoices->waiters_by_id);
+}
+#endif /* DEVELOPER */
+
 static void install_expiration_timer(struct invoices *invoices);
 
 struct invoices *invoices_new(const tal_t *ctx,
@@ -150,65 +313,70 @@ struct invoices *invoices_new(const tal_t *ctx,
 	invs->db = db;
 	invs->timers = timers;
 
-	list_head_init(&invs->waiters);
+	list_head_init(&invs->any_waiters);
+	uintmap_init(&invs->waiters_by_id);
+	/* next_pay_index is the one we'll hand out next. */
+	invs->max_pay_index = db_get_intvar(db, "next_pay_index", 1) - 1;
 
 	invs->expiration_timer = NULL;
 
+	invs->unpaid = tal(invs, struct unpaid_invoice_map);
+	unpaid_invoice_map_init(invs->unpaid);
+	uintmap_init(&invs->unpaid_by_id);
+	uintmap_init(&invs->expiries);
+	tal_add_destructor(invs, destroy_invoices);
+	memleak_add_helper(invs, memleak_help_invoices);
+
 	update_db_expirations(invs, time_now().ts.tv_sec);
+	load_unpaid(invs);
 	install_expiration_timer(invs);
 	return invs;
 }
 
-struct invoice_id_node {
-	struct list_node list;
-	u64 id;
-};
-
 static void trigger_expiration(struct invoices *invoices)
 {
-	struct list_head idlist;
-	struct invoice_id_node *idn;
 	u64 now = time_now().ts.tv_sec;
-	struct db_stmt *stmt;
-	struct invoice i;
+	UINTMAP(struct unpaid_invoice *) expired;
+	struct expiry_bucket *b;
+	u64 expiry_time, id;
 
 	/* Free current expiration timer */
 	invoices->expiration_timer = tal_free(invoices->expiration_timer);
 
-	/* Acquire all expired invoices and save them in a list */
-	list_head_init(&idlist);
-	stmt = db_prepare_v2(invoices->db, SQL("SELECT id"
-					       "  FROM invoices"
-					       " WHERE state = ?"
-					       "   AND expiry_time <= ?"));
-	db_bind_int(stmt, 0, UNPAID);
-	db_bind_u64(stmt, 1, now);
-	db_query_prepared(stmt);
+	/* Expire them all in the db at once */
+	update_db_expirations(invoices, now);
 
-	while (db_step(stmt)) {
-		idn = tal(tmpctx, struct invoice_id_node);
-		list_add_tail(&idlist, &idn->list);
-		idn->id = db_col_u64(stmt, "id");
+	/* Take every invoice due by now out of the index */
+	uintmap_init(&expired);
+	while ((b = uintmap_first(&invoices->expiries, &expiry_time)) != NULL
+	       && expiry_time <= now) {
+		struct unpaid_invoice *u;
+
+		while ((u = list_top(&b->invoices, struct unpaid_invoice, list)) != NULL) {
+			uintmap_del(&invoices->unpaid_by_id, u->id);
+			unpaid_invoice_map_del(invoices->unpaid, u);
+			/* This frees b once it's empty */
+			expiry_bucket_del(invoices, u);
+			uintmap_add(&expired, u->id, tal_steal(tmpctx, u));
+		}
 	}
-	tal_free(stmt);
 
-	/* Expire all those invoices */
-	update_db_expirations(invoices, now);
+	/* Trigger expirations (waitanyinvoice waiters don't care) */
+	for (struct unpaid_invoice *u = uintmap_first(&expired, &id);
+	     u;
+	     u = uintmap_after(&expired, &id)) {
+		struct invoice i;
 
-	/* Trigger expirations */
-	list_for_each(&idlist, idn, list) {
-		/* Trigger expiration */
-		i.id = idn->id;
-		trigger_invoice_waiter_expire_or_delete(invoices, idn->id, &i);
+		i.id = id;
+		trigger_invoice_waiter_expire_or_delete(invoices, id, &i);
 	}
+	uintmap_clear(&expired);
 
 	install_expiration_timer(invoices);
 }
 
 static void install_expiration_timer(struct invoices *invoices)
 {
-	bool res;
-	struct db_stmt *stmt;
 	struct timerel rel;
 	struct timeabs expiry;
 	struct timeabs now = time_now();
@@ -216,22 +384,9 @@ static void install_expiration_timer(struct invoices *invoices)
 	assert(!invoices->expiration_timer);
 
 	/* Find unpaid invoice with nearest expiry time */
-	stmt = db_prepare_v2(invoices->db, SQL("SELECT MIN(expiry_time)"
-					       "  FROM invoices"
-					       " WHERE state = ?;"));
-	db_bind_int(stmt, 0, UNPAID);
-
-	db_query_prepared(stmt);
-
-	res = db_step(stmt);
-	assert(res);
-
-	if (db_col_is_null(stmt, "MIN(expiry_time)"))
+	if (!uintmap_first(&invoices->expiries, &invoices->min_expiry_time))
 		/* Nothing to install */
-		goto done;
-
-	invoices->min_expiry_time = db_col_u64(stmt,
-					       "MIN(expiry_time)");
+		return;
 
 	memset(&expiry, 0, sizeof(expiry));
 	expiry.ts.tv_sec = invoices->min_expiry_time;
@@ -249,8 +404,6 @@ static void install_expiration_timer(struct invoices *invoices)
 						  rel,
 						  &trigger_expiration,
 						  invoices);
-done:
-	tal_free(stmt);
 }
 
 bool invoices_create(struct invoices *invoices,
@@ -317,6 +470,7 @@ bool invoices_create(struct invoices *invoices,
 	db_exec_prepared_v2(stmt);
 
 	pinvoice->id = db_last_insert_id_v2(take(stmt));
+	unpaid_add(invoices, pinvoice->id, rhash, expiry_time);
 
 	/* Install expiration trigger. */
 	if (!invoices->expiration_timer ||
@@ -361,6 +515,9 @@ bool invoices_find_by_rhash(struct invoices *invoices,
 {
 	struct db_stmt *stmt;
 
+	if (invoices_find_unpaid(invoices, pinvoice, rhash))
+		return true;
+
 	stmt = db_prepare_v2(invoices->db, SQL("SELECT id"
 					       "  FROM invoices"
 					       " WHERE payment_hash = ?;"));
@@ -381,23 +538,13 @@ bool invoices_find_unpaid(struct invoices *invoices,
 			  struct invoice *pinvoice,
 			  const struct sha256 *rhash)
 {
-	struct db_stmt *stmt;
-	stmt = db_prepare_v2(invoices->db, SQL("SELECT id"
-					       "  FROM invoices"
-					       " WHERE payment_hash = ?"
-					       "   AND state = ?;"));
-	db_bind_sha256(stmt, 0, rhash);
-	db_bind_int(stmt, 1, UNPAID);
-	db_query_prepared(stmt);
+	const struct unpaid_invoice *u;
 
-	if (!db_step(stmt)) {
-		tal_free(stmt);
+	u = unpaid_invoice_map_get(invoices->unpaid, rhash);
+	if (!u)
 		return false;
-	} else  {
-		pinvoice->id = db_col_u64(stmt, "id");
-		tal_free(stmt);
-		return true;
-	}
+	pinvoice->id = u->id;
+	return true;
 }
 
 bool invoices_delete(struct invoices *invoices, struct invoice invoice)
@@ -416,6 +563,7 @@ bool invoices_delete(struct invoices *invoices, struct invoice invoice)
 	if (changes != 1) {
 		return false;
 	}
+	unpaid_del(invoices, invoice.id);
 	/* Tell all the waiters about the fact that it was deleted. */
 	trigger_invoice_waiter_expire_or_delete(invoices, invoice.id, NULL);
 	return true;
@@ -451,14 +599,42 @@ void invoices_delete_expired(struct invoices *invoices,
 	db_exec_prepared_v2(take(stmt));
 }
 
+void invoices_expire_offer(struct invoices *invoices,
+			   const struct sha256 *local_offer_id)
+{
+	struct db_stmt *stmt;
+
+	stmt = db_prepare_v2(invoices->db, SQL("SELECT id"
+					       "  FROM invoices"
+					       " WHERE state = ? AND local_offer_id = ?;"));
+	db_bind_int(stmt, 0, UNPAID);
+	db_bind_sha256(stmt, 1, local_offer_id);
+	db_query_prepared(stmt);
+	while (db_step(stmt))
+		unpaid_del(invoices, db_col_u64(stmt, "id"));
+	tal_free(stmt);
+
+	stmt = db_prepare_v2(invoices->db, SQL("UPDATE invoices"
+					       " SET state = ?"
+					       " WHERE state = ? AND local_offer_id = ?;"));
+	db_bind_int(stmt, 0, EXPIRED);
+	db_bind_int(stmt, 1, UNPAID);
+	db_bind_sha256(stmt, 2, local_offer_id);
+	db_exec_prepared_v2(take(stmt));
+}
+
 bool invoices_iterate(struct invoices *invoices,
-		      struct invoice_iterator *it)
+		      struct invoice_iterator *it,
+		      const struct sha256 *local_offer_id,
+		      u64 start,
+		      const u32 *limit)
 {
 	struct db_stmt *stmt;
 
 	if (!it->p) {
 		stmt = db_prepare_v2(invoices->db, SQL("SELECT"
-						       "  state"
+						       "  id"
+						       ", state"
 						       ", payment_key"
 						       ", payment_hash"
 						       ", label"
@@ -472,8 +648,21 @@ bool invoices_iterate(struct invoices *invoices,
 						       ", features"
 						       ", local_offer_id"
 						       " FROM invoices"
-						       " ORDER BY id;"));
-		db_query_prepared(stmt);
+						       " WHERE (1 = ? OR local_offer_id = ?)"
+						       "   AND id >= ?"
+						       " ORDER BY id"
+						       " LIMIT ?;"));
+		if (local_offer_id) {
+			db_bind_int(stmt, 0, 0);
+			db_bind_sha256(stmt, 1, local_offer_id);
+		} else {
+			db_bind_int(stmt, 0, 1);
+			db_bind_null(stmt, 1);
+		}
+		db_bind_u64(stmt, 2, start);
+		db_bind_u64(stmt, 3, limit ? *limit : INT64_MAX);
+		/* Only for listinvoices, so a replica will do. */
+		db_query_prepared_stale(stmt);
 		it->p = stmt;
 	} else
 		stmt = it->p;
@@ -497,14 +686,15 @@ invoices_iterator_deref(const tal_t *ctx, struct invoices *invoices UNUSED,
 	return wallet_stmt2invoice_details(ctx, (struct db_stmt*) it->p);
 }
 
-static s64 get_next_pay_index(struct db *db)
+static s64 get_next_pay_index(struct invoices *invoices)
 {
 	/* Equivalent to (next_pay_index++) */
 	s64 next_pay_index;
-	next_pay_index = db_get_intvar(db, "next_pay_index", 0);
+	next_pay_index = db_get_intvar(invoices->db, "next_pay_index", 0);
 	/* Variable should exist. */
 	assert(next_pay_index > 0);
-	db_set_intvar(db, "next_pay_index", next_pay_index + 1);
+	db_set_intvar(invoices->db, "next_pay_index", next_pay_index + 1);
+	invoices->max_pay_index = next_pay_index;
 	return next_pay_index;
 }
 
@@ -527,13 +717,14 @@ static enum invoice_status invoice_get_status(struct invoices *invoices, struct
 }
 
 /* If there's an associated offer, mark it used. */
-static void maybe_mark_offer_used(struct db *db, struct invoice invoice)
+static void maybe_mark_offer_used(struct invoices *invoices,
+				  struct invoice invoice)
 {
 	struct db_stmt *stmt;
 	struct sha256 local_offer_id;
 
 	stmt = db_prepare_v2(
-		db, SQL("SELECT local_offer_id FROM invoices WHERE id = ?;"));
+		invoices->db, SQL("SELECT local_offer_id FROM invoices WHERE id = ?;"));
 	db_bind_u64(stmt, 0, invoice.id);
 	db_query_prepared(stmt);
 
@@ -545,7 +736,7 @@ static void maybe_mark_offer_used(struct db *db, struct invoice invoice)
 	db_col_sha256(stmt, "local_offer_id", &local_offer_id);
 	tal_free(stmt);
 
-	wallet_offer_mark_used(db, &local_offer_id);
+	wallet_offer_mark_used(invoices->db, invoices, &local_offer_id);
 }
 
 bool invoices_resolve(struct invoices *invoices,
@@ -555,13 +746,13 @@ bool invoices_resolve(struct invoices *invoices,
 	struct db_stmt *stmt;
 	s64 pay_index;
 	u64 paid_timestamp;
-	enum invoice_status state = invoice_get_status(invoices, invoice);
 
-	if (state != UNPAID)
+	/* Only unpaid ones can be paid (and this removes it from the index) */
+	if (!unpaid_del(invoices, invoice.id))
 		return false;
 
 	/* Assign a pay-index. */
-	pay_index = get_next_pay_index(invoices->db);
+	pay_index = get_next_pay_index(invoices);
 	paid_timestamp = time_now().ts.tv_sec;
 
 	/* Update database. */
@@ -578,7 +769,7 @@ bool invoices_resolve(struct invoices *invoices,
 	db_bind_u64(stmt, 4, invoice.id);
 	db_exec_prepared_v2(take(stmt));
 
-	maybe_mark_offer_used(invoices->db, invoice);
+	maybe_mark_offer_used(invoices, invoice);
 
 	/* Tell all the waiters about the paid invoice. */
 	trigger_invoice_waiter_resolve(invoices, invoice.id, &invoice);
@@ -588,25 +779,52 @@ bool invoices_resolve(struct invoices *invoices,
 /* Called when an invoice waiter is destructed. */
 static void destroy_invoice_waiter(struct invoice_waiter *w)
 {
+	struct invoice_waiters *ws;
+
 	/* Already triggered. */
 	if (w->triggered)
 		return;
 	list_del(&w->list);
+	if (w->any)
+		return;
+
+	/* Last one waiting on this invoice?  (If they're being triggered
+	 * right now, it's already out of the index.) */
+	ws = uintmap_get(&w->invoices->waiters_by_id, w->id);
+	if (ws && list_empty(&ws->waiters)) {
+		uintmap_del(&w->invoices->waiters_by_id, w->id);
+		tal_free(ws);
+	}
 }
 
-/* Add an invoice waiter to the specified list of invoice waiters. */
+/* Add an invoice waiter to the waitany list, or the list for invoice id. */
 static void add_invoice_waiter(const tal_t *ctx,
-			       struct list_head *waiters,
+			       struct invoices *invoices,
 			       bool any,
 			       u64 id,
-			       void (*cb)(const struct invoice *, void*),
+			       void (*cb)(const struct invoice *,
+					  const struct invoice_details *,
+					  void *),
 			       void* cbarg)
 {
 	struct invoice_waiter *w = tal(ctx, struct invoice_waiter);
 	w->triggered = false;
 	w->any = any;
 	w->id = id;
-	list_add_tail(waiters, &w->list);
+	w->invoices = invoices;
+	if (any)
+		list_add_tail(&invoices->any_waiters, &w->list);
+	else {
+		struct invoice_waiters *ws;
+
+		ws = uintmap_get(&invoices->waiters_by_id, id);
+		if (!ws) {
+			ws = tal(invoices, struct invoice_waiters);
+			list_head_init(&ws->waiters);
+			uintmap_add(&invoices->waiters_by_id, id, ws);
+		}
+		list_add_tail(&ws->waiters, &w->list);
+	}
 	w->cb = cb;
 	w->cbarg = cbarg;
 	tal_add_destructor(w, &destroy_invoice_waiter);
@@ -616,12 +834,20 @@ static void add_invoice_waiter(const tal_t *ctx,
 void invoices_waitany(const tal_t *ctx,
 		      struct invoices *invoices,
 		      u64 lastpay_index,
-		      void (*cb)(const struct invoice *, void*),
+		      void (*cb)(const struct invoice *,
+				 const struct invoice_details *,
+				 void *),
 		      void *cbarg)
 {
 	struct db_stmt *stmt;
 	struct invoice invoice;
 
+	/* Nothing paid since then?  Don't bother asking the db. */
+	if (lastpay_index >= invoices->max_pay_index) {
+		add_invoice_waiter(ctx, invoices, true, 0, cb, cbarg);
+		return;
+	}
+
 	/* Look for an already-paid invoice. */
 	stmt = db_prepare_v2(invoices->db,
 			     SQL("SELECT id"
@@ -634,35 +860,41 @@ void invoices_waitany(const tal_t *ctx,
 
 	if (db_step(stmt)) {
 		invoice.id = db_col_u64(stmt, "id");
+		tal_free(stmt);
 
-		cb(&invoice, cbarg);
+		cb(&invoice, invoices_get_details(tmpctx, invoices, invoice),
+		   cbarg);
 	} else {
-		/* None found. */
-		add_invoice_waiter(ctx, &invoices->waiters,
-			   true, 0, cb, cbarg);
+		tal_free(stmt);
+		/* None found (it may have been deleted). */
+		add_invoice_waiter(ctx, invoices, true, 0, cb, cbarg);
 	}
-	tal_free(stmt);
 }
 
 
 void invoices_waitone(const tal_t *ctx,
 		      struct invoices *invoices,
 		      struct invoice invoice,
-		      void (*cb)(const struct invoice *, void*),
+		      void (*cb)(const struct invoice *,
+				 const struct invoice_details *,
+				 void *),
 		      void *cbarg)
 {
 	enum invoice_status state;
 
-	state = invoice_get_status(invoices, invoice);
+	if (uintmap_get(&invoices->unpaid_by_id, invoice.id))
+		state = UNPAID;
+	else
+		state = invoice_get_status(invoices, invoice);
 
 	if (state == PAID || state == EXPIRED) {
-		cb(&invoice, cbarg);
+		cb(&invoice, invoices_get_details(tmpctx, invoices, invoice),
+		   cbarg);
 		return;
 	}
 
 	/* Not yet paid. */
-	add_invoice_waiter(ctx, &invoices->waiters,
-			   false, invoice.id, cb, cbarg);
+	add_invoice_waiter(ctx, invoices, false, invoice.id, cb, cbarg);
 }
 
 struct invoice_details *invoices_get_details(const tal_t *ctx,
@@ -674,7 +906,8 @@ struct invoice_details *invoices_get_details(const tal_t *ctx,
 	struct invoice_details *details;
 
 	stmt = db_prepare_v2(invoices->db, SQL("SELECT"
-					       "  state"
+					       "  id"
+					       ", state"
 					       ", payment_key"
 					       ", payment_hash"
 					       ", label"
@@ -129,23 +129,39 @@ bool invoices_delete_description(struct invoices *invoices,
 void invoices_delete_expired(struct invoices *invoices,
 			     u64 max_expiry_time);
 
+/**
+ * invoices_expire_offer - Expire all unpaid invoices for an offer
+ *
+ * @invoices - the invoice handler.
+ * @local_offer_id - the offer which is no longer active.
+ */
+void invoices_expire_offer(struct invoices *invoices,
+			   const struct sha256 *local_offer_id);
+
 /**
  * invoices_iterate - Iterate over all existing invoices
  *
  * @invoices - the invoice handler.
  * @iterator - the iterator object to use.
+ * @local_offer_id - if non-NULL, only invoices for this offer.
+ * @start - only invoices with created_index >= start.
+ * @limit - if non-NULL, at most this many invoices.
  *
+ * The filters are only used on the first call.
  * Return false at end-of-sequence, true if still iterating.
  * Usage:
  *
  *   struct invoice_iterator it;
  *   memset(&it, 0, sizeof(it))
- *   while (invoices_iterate(wallet, &it)) {
+ *   while (invoices_iterate(wallet, &it, NULL, 0, NULL)) {
  *       ...
  *   }
  */
 bool invoices_iterate(struct invoices *invoices,
-		      struct invoice_iterator *it);
+		      struct invoice_iterator *it,
+		      const struct sha256 *local_offer_id,
+		      u64 start,
+		      const u32 *limit);
 
 /**
  * wallet_invoice_iterator_deref - Read the details of the
@@ -185,13 +201,15 @@ bool invoices_resolve(struct invoices *invoices,
  * @cb - the callback to invoke. If an invoice is already
  * paid with pay_index greater than lastpay_index, this
  * is called immediately, otherwise it is called during
- * an invoices_resolve call.
+ * an invoices_resolve call, with that invoice's details.
  * @cbarg - the callback data.
  */
 void invoices_waitany(const tal_t *ctx,
 		      struct invoices *invoices,
 		      u64 lastpay_index,
-		      void (*cb)(const struct invoice *, void*),
+		      void (*cb)(const struct invoice *,
+				 const struct invoice_details *,
+				 void *),
 		      void *cbarg);
 
 /**
@@ -205,15 +223,17 @@ void invoices_waitany(const tal_t *ctx,
  * @cb - the callback to invoice. If invoice is already paid
  * or expired, this is called immediately, otherwise it is
  * called during an invoices_resolve or invoices_delete call.
- * If the invoice was deleted, the callback is given a NULL
- * invoice.
+ * It's given the invoice's details, or if the invoice was
+ * deleted, a NULL invoice (and NULL details).
  * @cbarg - the callback data.
  *
  */
 void invoices_waitone(const tal_t *ctx,
 		      struct invoices *invoices,
 		      struct invoice invoice,
-		      void (*cb)(const struct invoice *, void*),
+		      void (*cb)(const struct invoice *,
+				 const struct invoice_details *,
+				 void *),
 		      void *cbarg);
 
 /**
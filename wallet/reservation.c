@@ -439,7 +439,8 @@ static struct command_result *json_fundpsbt(struct command *cmd,
 					      const jsmntok_t *obj UNNEEDED,
 					      const jsmntok_t *params)
 {
-	struct utxo **utxos;
+	struct utxo **utxos, **candidates;
+	size_t next_candidate;
 	u32 *feerate_per_kw;
 	u32 *minconf, *weight, *min_witness_weight;
 	struct amount_sat *amount, input, diff;
@@ -466,8 +467,13 @@ static struct command_result *json_fundpsbt(struct command *cmd,
 	all = amount_sat_eq(*amount, AMOUNT_SAT(-1ULL));
 	maxheight = minconf_to_maxheight(*minconf, cmd->ld);
 
-	/* We keep adding until we meet their output requirements. */
+	/* We keep adding until we meet their output requirements.  Read the
+	 * candidates once: wallets can have a great many. */
 	utxos = tal_arr(cmd, struct utxo *, 0);
+	candidates = wallet_find_utxos(cmd, cmd->ld->wallet,
+				       cmd->ld->topology->tip->height,
+				       maxheight, *nonwrapped);
+	next_candidate = 0;
 
 	input = AMOUNT_SAT(0);
 	while (!inputs_sufficient(input, *amount, *feerate_per_kw, *weight,
@@ -476,13 +482,10 @@ static struct command_result *json_fundpsbt(struct command *cmd,
 		struct amount_sat fee;
 		u32 utxo_weight;
 
-		utxo = wallet_find_utxo(utxos, cmd->ld->wallet,
-					cmd->ld->topology->tip->height,
-					&diff,
-					*feerate_per_kw,
-					maxheight,
-					*nonwrapped,
-					cast_const2(const struct utxo **, utxos));
+		if (next_candidate < tal_count(candidates))
+			utxo = candidates[next_candidate++];
+		else
+			utxo = NULL;
 		if (utxo) {
 			utxo_weight = utxo_spend_weight(utxo,
 							*min_witness_weight);
@@ -83,7 +83,7 @@ static struct db *create_test_db(void)
 
 	dsn = tal_fmt(NULL, "sqlite3://%s", filename);
 	tal_free(filename);
-	db = db_open(NULL, dsn);
+	db = db_open(NULL, dsn, false);
 	db->data_version = 0;
 	db->report_changes_fn = NULL;
 
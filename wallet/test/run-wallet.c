@@ -98,6 +98,9 @@ struct command_result *command_fail(struct command *cmd UNNEEDED, enum jsonrpc_e
 struct command_result *command_param_failed(void)
 
 { fprintf(stderr, "command_param_failed called!\n"); abort(); }
+/* Generated stub for command_should_pause */
+bool command_should_pause(const struct command *cmd UNNEEDED)
+{ fprintf(stderr, "command_should_pause called!\n"); abort(); }
 /* Generated stub for command_still_pending */
 struct command_result *command_still_pending(struct command *cmd)
 
@@ -107,6 +110,13 @@ struct command_result *command_success(struct command *cmd UNNEEDED,
 				       struct json_stream *response)
 
 { fprintf(stderr, "command_success called!\n"); abort(); }
+/* Generated stub for command_wait_for_output_ */
+struct command_result *command_wait_for_output_(struct command *cmd UNNEEDED,
+						struct command_result *(*cb)(struct command * UNNEEDED,
+									     void *) UNNEEDED,
+						void *arg UNNEEDED)
+
+{ fprintf(stderr, "command_wait_for_output_ called!\n"); abort(); }
 /* Generated stub for connect_any_cmd_id */
 const char *connect_any_cmd_id(const tal_t *ctx UNNEEDED,
 			       struct lightningd *ld UNNEEDED, const struct peer *peer UNNEEDED)
@@ -230,6 +240,10 @@ bool invoices_delete_description(struct invoices *invoices UNNEEDED,
 void invoices_delete_expired(struct invoices *invoices UNNEEDED,
 			     u64 max_expiry_time UNNEEDED)
 { fprintf(stderr, "invoices_delete_expired called!\n"); abort(); }
+/* Generated stub for invoices_expire_offer */
+void invoices_expire_offer(struct invoices *invoices UNNEEDED,
+			   const struct sha256 *local_offer_id UNNEEDED)
+{ fprintf(stderr, "invoices_expire_offer called!\n"); abort(); }
 /* Generated stub for invoices_find_by_label */
 bool invoices_find_by_label(struct invoices *invoices UNNEEDED,
 			    struct invoice *pinvoice UNNEEDED,
@@ -252,7 +266,10 @@ struct invoice_details *invoices_get_details(const tal_t *ctx UNNEEDED,
 { fprintf(stderr, "invoices_get_details called!\n"); abort(); }
 /* Generated stub for invoices_iterate */
 bool invoices_iterate(struct invoices *invoices UNNEEDED,
-		      struct invoice_iterator *it UNNEEDED)
+		      struct invoice_iterator *it UNNEEDED,
+		      const struct sha256 *local_offer_id UNNEEDED,
+		      u64 start UNNEEDED,
+		      const u32 *limit UNNEEDED)
 { fprintf(stderr, "invoices_iterate called!\n"); abort(); }
 /* Generated stub for invoices_iterator_deref */
 const struct invoice_details *invoices_iterator_deref(
@@ -273,14 +290,18 @@ bool invoices_resolve(struct invoices *invoices UNNEEDED,
 void invoices_waitany(const tal_t *ctx UNNEEDED,
 		      struct invoices *invoices UNNEEDED,
 		      u64 lastpay_index UNNEEDED,
-		      void (*cb)(const struct invoice * UNNEEDED, void*) UNNEEDED,
+		      void (*cb)(const struct invoice * UNNEEDED,
+				 const struct invoice_details * UNNEEDED,
+				 void *) UNNEEDED,
 		      void *cbarg UNNEEDED)
 { fprintf(stderr, "invoices_waitany called!\n"); abort(); }
 /* Generated stub for invoices_waitone */
 void invoices_waitone(const tal_t *ctx UNNEEDED,
 		      struct invoices *invoices UNNEEDED,
 		      struct invoice invoice UNNEEDED,
-		      void (*cb)(const struct invoice * UNNEEDED, void*) UNNEEDED,
+		      void (*cb)(const struct invoice * UNNEEDED,
+				 const struct invoice_details * UNNEEDED,
+				 void *) UNNEEDED,
 		      void *cbarg UNNEEDED)
 { fprintf(stderr, "invoices_waitone called!\n"); abort(); }
 /* Generated stub for json_add_address */
@@ -435,6 +456,9 @@ char *json_strdup(const tal_t *ctx UNNEEDED, const char *buffer UNNEEDED, const
 /* Generated stub for json_stream_success */
 struct json_stream *json_stream_success(struct command *cmd UNNEEDED)
 { fprintf(stderr, "json_stream_success called!\n"); abort(); }
+/* Generated stub for json_stream_wants */
+bool json_stream_wants(const struct json_stream *js UNNEEDED, const char *fieldname UNNEEDED)
+{ fprintf(stderr, "json_stream_wants called!\n"); abort(); }
 /* Generated stub for json_to_channel_id */
 bool json_to_channel_id(const char *buffer UNNEEDED, const jsmntok_t *tok UNNEEDED,
 			struct channel_id *cid UNNEEDED)
@@ -511,6 +535,10 @@ struct uncommitted_channel *new_uncommitted_channel(struct peer *peer UNNEEDED)
 /* Generated stub for notify_chain_mvt */
 void notify_chain_mvt(struct lightningd *ld UNNEEDED, const struct chain_coin_mvt *mvt UNNEEDED)
 { fprintf(stderr, "notify_chain_mvt called!\n"); abort(); }
+/* Generated stub for notify_channel_changed */
+void notify_channel_changed(struct lightningd *ld UNNEEDED,
+			    const struct channel *channel UNNEEDED)
+{ fprintf(stderr, "notify_channel_changed called!\n"); abort(); }
 /* Generated stub for notify_channel_mvt */
 void notify_channel_mvt(struct lightningd *ld UNNEEDED, const struct channel_coin_mvt *mvt UNNEEDED)
 { fprintf(stderr, "notify_channel_mvt called!\n"); abort(); }
@@ -700,6 +728,9 @@ const char *resolve_close_command(const tal_t *ctx UNNEEDED,
 				  struct lightningd *ld UNNEEDED, struct channel *channel UNNEEDED,
 				  bool cooperative UNNEEDED)
 { fprintf(stderr, "resolve_close_command called!\n"); abort(); }
+/* Generated stub for routehint_cache_invalidate */
+void routehint_cache_invalidate(struct lightningd *ld UNNEEDED)
+{ fprintf(stderr, "routehint_cache_invalidate called!\n"); abort(); }
 /* Generated stub for serialize_onionpacket */
 u8 *serialize_onionpacket(
 	const tal_t *ctx UNNEEDED,
@@ -985,12 +1016,15 @@ static struct wallet *create_test_wallet(struct lightningd *ld, const tal_t *ctx
 	close(fd);
 
 	dsn = tal_fmt(NULL, "sqlite3://%s", filename);
-	w->db = db_open(w, dsn);
+	w->db = db_open(w, dsn, false);
 	w->db->report_changes_fn = NULL;
 	tal_free(dsn);
 	tal_add_destructor2(w, cleanup_test_wallet, filename);
 
 	list_head_init(&w->unstored_payments);
+	list_head_init(&w->inflight_groups);
+	uintmap_init(&w->pending_htlc_updates);
+	db_set_precommit(w->db, wallet_htlc_flush, w);
 	w->ld = ld;
 	ld->wallet = w;
 
@@ -1062,6 +1096,8 @@ static bool test_wallet_outputs(struct lightningd *ld, const tal_t *ctx)
 		tal_arr_expand(&utxos, one_utxo);
 	}
 	CHECK(tal_count(utxos) == 2);
+	/* Getting them all at once gives the same set. */
+	CHECK(tal_count(wallet_find_utxos(tmpctx, w, 100, 0, false)) == 2);
 
 	if (utxos[0]->close_info)
 		u = *utxos[0];
@@ -1857,9 +1893,15 @@ static bool test_htlc_crud(struct lightningd *ld, const tal_t *ctx)
 		  "Saving two HTLCs with the same data must not succeed.");
 	CHECK(wallet_err);
 	wallet_err = tal_free(wallet_err);
-	CHECK_MSG(
-		transaction_wrap(w->db, wallet_htlc_update(w, out.dbid, SENT_ADD_ACK_REVOCATION, NULL, 0, 0, NULL, tal_arrz(tmpctx, u8, 100), false)),
-	    "Update outgoing HTLC with failmsg failed");
+
+	/* Several updates within a transaction only write the last. */
+	db_begin_transaction(w->db);
+	wallet_htlc_update(w, out.dbid, SENT_ADD_COMMIT, NULL, 0, 0, NULL, NULL, false);
+	wallet_htlc_update(w, out.dbid, SENT_ADD_ACK_REVOCATION, NULL, 0, 0, NULL, tal_arrz(tmpctx, u8, 100), false);
+	CHECK(uintmap_get(&w->pending_htlc_updates, out.dbid) != NULL);
+	db_commit_transaction(w->db);
+	CHECK_MSG(!wallet_err, "Update outgoing HTLC with failmsg failed");
+	CHECK(uintmap_empty(&w->pending_htlc_updates));
 
 	/* Attempt to load them from the DB again */
 	htlc_in_map_init(htlcs_in);
@@ -1885,6 +1927,7 @@ static bool test_htlc_crud(struct lightningd *ld, const tal_t *ctx)
 
 	CHECK(hin != NULL);
 	CHECK(hout != NULL);
+	CHECK(hout->hstate == SENT_ADD_ACK_REVOCATION);
 
 	/* Have to free manually, otherwise we get our dependencies
 	 * twisted */
@@ -1927,6 +1970,9 @@ static bool test_payment_crud(struct lightningd *ld, const tal_t *ctx)
 	CHECK(amount_msat_eq(t2->msatoshi_sent, t->msatoshi_sent));
 	CHECK(amount_msat_eq(t2->total_msat, t->total_msat));
 	CHECK(!t2->payment_preimage);
+	/* Served from the in-flight group, not the db */
+	CHECK(!list_empty(&w->inflight_groups));
+	CHECK(wallet_payment_get_groupid(w, &t->payment_hash) == t->groupid);
 
 	t->status = PAYMENT_COMPLETE;
 	t->payment_preimage = tal(w, struct preimage);
@@ -1942,6 +1988,9 @@ static bool test_payment_crud(struct lightningd *ld, const tal_t *ctx)
 	CHECK(amount_msat_eq(t2->msatoshi, t->msatoshi));
 	CHECK(amount_msat_eq(t2->msatoshi_sent, t->msatoshi_sent));
 	CHECK(preimage_eq(t->payment_preimage, t2->payment_preimage));
+	/* Nothing pending: we ask the db again */
+	CHECK(list_empty(&w->inflight_groups));
+	CHECK(wallet_payment_get_groupid(w, &t->payment_hash) == t->groupid);
 
 	db_commit_transaction(w->db);
 	return true;
@@ -27,10 +27,93 @@ static int scriptpubkey_eq(const u8 *a, const u8 *b)
 
 HTABLE_DEFINE_TYPE(u8, scriptpubkey_keyof, scriptpubkey_hash, scriptpubkey_eq, scriptpubkeyset);
 
+/* Bits in the prefilter per script in the set: with three probes that's a
+ * ~0.3% false positive rate, and 100,000 scripts fit in 256kB.  The size
+ * is always a power of two. */
+#define PREFILTER_BITS_PER_SCRIPT 16
+#define PREFILTER_MIN_BITS 1024
+
 struct txfilter {
 	struct scriptpubkeyset scriptpubkeyset;
+	/* Bloom filter over the standard scripts in the set, so most
+	 * outputs are rejected without hashing (or allocating) anything. */
+	u64 *prefilter;
+	size_t prefilter_entries;
 };
 
+/* Standard scripts already contain a hash: we can use that directly for
+ * the prefilter.  Returns NULL for anything else, which skips it. */
+static const u8 *script_hashpart(const u8 *script, size_t len)
+{
+	/* P2WPKH, P2WSH and P2TR */
+	if ((len == 22 && script[0] == 0x00 && script[1] == 20)
+	    || (len == 34 && script[0] == 0x00 && script[1] == 32)
+	    || (len == 34 && script[0] == 0x51 && script[1] == 32))
+		return script + 2;
+	/* P2SH */
+	if (len == 23 && script[0] == 0xa9 && script[1] == 20
+	    && script[22] == 0x87)
+		return script + 2;
+	/* P2PKH */
+	if (len == 25 && script[0] == 0x76 && script[1] == 0xa9
+	    && script[2] == 20 && script[23] == 0x88 && script[24] == 0xac)
+		return script + 3;
+	return NULL;
+}
+
+/* The three bits for this script: its hash is already uniform. */
+static size_t prefilter_bit(const u64 *prefilter, const u8 *hashpart,
+			    size_t probe)
+{
+	u32 v;
+
+	memcpy(&v, hashpart + probe * sizeof(v), sizeof(v));
+	return v & (tal_count(prefilter) * 64 - 1);
+}
+
+static void prefilter_add(u64 *prefilter, const u8 *hashpart)
+{
+	for (size_t i = 0; i < 3; i++) {
+		size_t bit = prefilter_bit(prefilter, hashpart, i);
+		prefilter[bit / 64] |= (u64)1 << (bit % 64);
+	}
+}
+
+static bool prefilter_maybe(const u64 *prefilter, const u8 *hashpart)
+{
+	for (size_t i = 0; i < 3; i++) {
+		size_t bit = prefilter_bit(prefilter, hashpart, i);
+		if (!(prefilter[bit / 64] & ((u64)1 << (bit % 64))))
+			return false;
+	}
+	return true;
+}
+
+/* Keep the prefilter sparse as the set grows, by rebuilding it bigger. */
+static void prefilter_resize(struct txfilter *filter)
+{
+	struct scriptpubkeyset_iter it;
+	const u8 *script;
+	size_t bits = tal_count(filter->prefilter) * 64;
+
+	if (filter->prefilter_entries * PREFILTER_BITS_PER_SCRIPT <= bits)
+		return;
+
+	while (filter->prefilter_entries * PREFILTER_BITS_PER_SCRIPT > bits)
+		bits *= 2;
+	tal_free(filter->prefilter);
+	filter->prefilter = tal_arrz(filter, u64, bits / 64);
+
+	for (script = scriptpubkeyset_first(&filter->scriptpubkeyset, &it);
+	     script;
+	     script = scriptpubkeyset_next(&filter->scriptpubkeyset, &it)) {
+		const u8 *hashpart = script_hashpart(script,
+						     tal_bytelen(script));
+		if (hashpart)
+			prefilter_add(filter->prefilter, hashpart);
+	}
+}
+
 static size_t outpoint_hash(const struct bitcoin_outpoint *out)
 {
 	struct siphash24_ctx ctx;
@@ -56,14 +139,22 @@ struct txfilter *txfilter_new(const tal_t *ctx)
 {
 	struct txfilter *filter = tal(ctx, struct txfilter);
 	scriptpubkeyset_init(&filter->scriptpubkeyset);
+	filter->prefilter = tal_arrz(filter, u64, PREFILTER_MIN_BITS / 64);
+	filter->prefilter_entries = 0;
 	return filter;
 }
 
 void txfilter_add_scriptpubkey(struct txfilter *filter, const u8 *script TAKES)
 {
-	scriptpubkeyset_add(
-	    &filter->scriptpubkeyset,
-	    notleak(tal_dup_talarr(filter, u8, script)));
+	const u8 *copy = notleak(tal_dup_talarr(filter, u8, script));
+	const u8 *hashpart = script_hashpart(copy, tal_bytelen(copy));
+
+	scriptpubkeyset_add(&filter->scriptpubkeyset, copy);
+	if (hashpart) {
+		filter->prefilter_entries++;
+		prefilter_add(filter->prefilter, hashpart);
+		prefilter_resize(filter);
+	}
 }
 
 void txfilter_add_derkey(struct txfilter *filter,
@@ -82,17 +173,46 @@ void txfilter_add_derkey(struct txfilter *filter,
 bool txfilter_match(const struct txfilter *filter, const struct bitcoin_tx *tx)
 {
 	for (size_t i = 0; i < tx->wtx->num_outputs; i++) {
-		const u8 *oscript = bitcoin_tx_output_get_script(tmpctx, tx, i);
+		const struct wally_tx_output *out = &tx->wtx->outputs[i];
 
-		if (!oscript)
+		/* Elements fee outputs have no script */
+		if (!out->script_len)
 			continue;
 
-		if (scriptpubkeyset_get(&filter->scriptpubkeyset, oscript))
+		if (txfilter_scriptpubkey_matches(filter, out->script,
+						  out->script_len))
 			return true;
 	}
 	return false;
 }
 
+bool txfilter_scriptpubkey_matches(const struct txfilter *filter,
+				   const u8 *script, size_t script_len)
+{
+	const u8 *hashpart = script_hashpart(script, script_len);
+	const u8 *key;
+
+	/* Almost every output in a block stops here. */
+	if (hashpart && !prefilter_maybe(filter->prefilter, hashpart))
+		return false;
+
+	/* Set is keyed by tal'd scripts */
+	key = tal_dup_arr(tmpctx, u8, script, script_len, 0);
+	return scriptpubkeyset_get(&filter->scriptpubkeyset, key) != NULL;
+}
+
+void txfilter_append_scripts(const struct txfilter *filter,
+			     const u8 ***scripts)
+{
+	struct scriptpubkeyset_iter it;
+	const u8 *script;
+
+	for (script = scriptpubkeyset_first(&filter->scriptpubkeyset, &it);
+	     script;
+	     script = scriptpubkeyset_next(&filter->scriptpubkeyset, &it))
+		tal_arr_expand(scripts, script);
+}
+
 void outpointfilter_add(struct outpointfilter *of,
 			const struct bitcoin_outpoint *outpoint)
 {
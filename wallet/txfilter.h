@@ -32,6 +32,20 @@ void txfilter_add_derkey(struct txfilter *filter,
  */
 bool txfilter_match(const struct txfilter *filter, const struct bitcoin_tx *tx);
 
+/**
+ * txfilter_scriptpubkey_matches -- Check whether a single scriptpubkey matches
+ */
+bool txfilter_scriptpubkey_matches(const struct txfilter *filter,
+				   const u8 *script, size_t script_len);
+
+/**
+ * txfilter_append_scripts -- Append all the scriptpubkeys to @scripts
+ *
+ * The scripts are owned by the filter, not @scripts.
+ */
+void txfilter_append_scripts(const struct txfilter *filter,
+			     const u8 ***scripts);
+
 /**
  * txfilter_add_scriptpubkey -- Add a serialized scriptpubkey to the filter
  */
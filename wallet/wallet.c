@@ -18,6 +18,7 @@
 #include <lightningd/notification.h>
 #include <lightningd/peer_control.h>
 #include <onchaind/onchaind_wiregen.h>
+#include <wallet/db.h>
 #include <wallet/invoices.h>
 #include <wallet/txfilter.h>
 #include <wallet/wallet.h>
@@ -89,6 +90,8 @@ static void outpointfilters_init(struct wallet *w)
 	tal_free(stmt);
 }
 
+static void wallet_htlc_flush(struct wallet *wallet);
+
 struct wallet *wallet_new(struct lightningd *ld, struct timers *timers,
 			  struct ext_key *bip32_base STEALS)
 {
@@ -98,12 +101,16 @@ struct wallet *wallet_new(struct lightningd *ld, struct timers *timers,
 	wallet->bip32_base = tal_steal(wallet, bip32_base);
 	wallet->keyscan_gap = 50;
 	list_head_init(&wallet->unstored_payments);
+	list_head_init(&wallet->inflight_groups);
+	uintmap_init(&wallet->pending_htlc_updates);
 	wallet->db = db_setup(wallet, ld, wallet->bip32_base);
+	db_set_precommit(wallet->db, wallet_htlc_flush, wallet);
 
 	db_begin_transaction(wallet->db);
 	wallet->invoices = invoices_new(wallet, wallet->db, timers);
 	outpointfilters_init(wallet);
 	db_commit_transaction(wallet->db);
+	db_background_migrations_start(wallet->db, timers, wallet->log);
 	return wallet;
 }
 
@@ -525,16 +532,11 @@ static bool deep_enough(u32 maxheight, const struct utxo *utxo,
 
 /* FIXME: Make this wallet_find_utxos, and branch and bound and I've
  * left that to @niftynei to do, who actually read the paper! */
-struct utxo *wallet_find_utxo(const tal_t *ctx, struct wallet *w,
-			      unsigned current_blockheight,
-			      struct amount_sat *amount_hint,
-			      unsigned feerate_per_kw,
-			      u32 maxheight,
-			      bool nonwrapped,
-			      const struct utxo **excludes)
+/* All the outputs we could spend, in random order. */
+static struct db_stmt *query_available_utxos(struct wallet *w,
+					     unsigned current_blockheight)
 {
 	struct db_stmt *stmt;
-	struct utxo *utxo;
 
 	stmt = db_prepare_v2(w->db, SQL("SELECT"
 					"  prev_out_tx"
@@ -561,17 +563,41 @@ struct utxo *wallet_find_utxo(const tal_t *ctx, struct wallet *w,
 	db_bind_int(stmt, 1, output_status_in_db(OUTPUT_STATE_RESERVED));
 	db_bind_u64(stmt, 2, current_blockheight);
 
+	db_query_prepared(stmt);
+	return stmt;
+}
+
+static bool utxo_selectable(const struct utxo *utxo,
+			    unsigned current_blockheight,
+			    u32 maxheight,
+			    bool nonwrapped)
+{
+	return !(nonwrapped && utxo->is_p2sh)
+		&& deep_enough(maxheight, utxo, current_blockheight);
+}
+
+struct utxo *wallet_find_utxo(const tal_t *ctx, struct wallet *w,
+			      unsigned current_blockheight,
+			      struct amount_sat *amount_hint,
+			      unsigned feerate_per_kw,
+			      u32 maxheight,
+			      bool nonwrapped,
+			      const struct utxo **excludes)
+{
+	struct db_stmt *stmt;
+	struct utxo *utxo;
+
 	/* FIXME: Use feerate + estimate of input cost to establish
 	 * range for amount_hint */
 
-	db_query_prepared(stmt);
+	stmt = query_available_utxos(w, current_blockheight);
 
 	utxo = NULL;
 	while (!utxo && db_step(stmt)) {
 		utxo = wallet_stmt2output(ctx, stmt);
 		if (excluded(excludes, utxo)
-		    || (nonwrapped && utxo->is_p2sh)
-		    || !deep_enough(maxheight, utxo, current_blockheight))
+		    || !utxo_selectable(utxo, current_blockheight,
+					maxheight, nonwrapped))
 			utxo = tal_free(utxo);
 
 	}
@@ -579,6 +605,27 @@ struct utxo *wallet_find_utxo(const tal_t *ctx, struct wallet *w,
 	return utxo;
 }
 
+struct utxo **wallet_find_utxos(const tal_t *ctx, struct wallet *w,
+				unsigned current_blockheight,
+				u32 maxheight,
+				bool nonwrapped)
+{
+	struct db_stmt *stmt;
+	struct utxo **utxos = tal_arr(ctx, struct utxo *, 0);
+
+	stmt = query_available_utxos(w, current_blockheight);
+	while (db_step(stmt)) {
+		struct utxo *utxo = wallet_stmt2output(utxos, stmt);
+		if (utxo_selectable(utxo, current_blockheight,
+				    maxheight, nonwrapped))
+			tal_arr_expand(&utxos, utxo);
+		else
+			tal_free(utxo);
+	}
+	tal_free(stmt);
+	return utxos;
+}
+
 bool wallet_add_onchaind_utxo(struct wallet *w,
 			      const struct bitcoin_outpoint *outpoint,
 			      const u8 *scriptpubkey,
@@ -869,7 +916,7 @@ done:
 	return peer;
 }
 
-static struct bitcoin_signature *
+struct bitcoin_signature *
 wallet_htlc_sigs_load(const tal_t *ctx, struct wallet *w, u64 channelid,
 		      bool option_anchor_outputs)
 {
@@ -904,6 +951,26 @@ wallet_htlc_sigs_load(const tal_t *ctx, struct wallet *w, u64 channelid,
 	return htlc_sigs;
 }
 
+struct bitcoin_tx *wallet_channel_last_tx_load(const tal_t *ctx,
+					       struct wallet *w, u64 id)
+{
+	struct db_stmt *stmt;
+	struct bitcoin_tx *last_tx = NULL;
+
+	stmt = db_prepare_v2(w->db, SQL("SELECT last_tx"
+					" FROM channels WHERE id = ?"));
+	db_bind_u64(stmt, 0, id);
+	db_query_prepared(stmt);
+
+	if (db_step(stmt) && !db_col_is_null(stmt, "last_tx")) {
+		last_tx = db_col_psbt_to_tx(ctx, stmt, "last_tx");
+		if (last_tx)
+			last_tx->chainparams = chainparams;
+	}
+	tal_free(stmt);
+	return last_tx;
+}
+
 bool wallet_remote_ann_sigs_load(const tal_t *ctx, struct wallet *w, u64 id,
 				 secp256k1_ecdsa_signature **remote_ann_node_sig,
 				 secp256k1_ecdsa_signature **remote_ann_bitcoin_sig)
@@ -1294,6 +1361,7 @@ static struct channel *wallet_stmt2channel(struct wallet *w, struct db_stmt *stm
 	struct bitcoin_outpoint *shutdown_wrong_funding;
 	struct bitcoin_signature last_sig;
 	struct bitcoin_tx *last_tx;
+	bool last_unloaded;
 	u8 *remote_shutdown_scriptpubkey;
 	u8 *local_shutdown_scriptpubkey;
 	struct changed_htlc *last_sent_commit;
@@ -1479,11 +1547,17 @@ static struct channel *wallet_stmt2channel(struct wallet *w, struct db_stmt *stm
 		type = channel_type_none(NULL);
 
 	/* last_tx is null for stub channels used for recovering funds through
-	 * Static channel backups. */
-	if (!db_col_is_null(stmt, "last_tx"))
-		last_tx = db_col_psbt_to_tx(tmpctx, stmt, "last_tx");
-	else
+	 * Static channel backups.  Onchain channels only need it (and the
+	 * HTLC sigs) when onchaind starts, so leave those in the db. */
+	last_unloaded = false;
+	if (db_col_is_null(stmt, "last_tx"))
+		last_tx = NULL;
+	else if (db_col_int(stmt, "state") == ONCHAIN) {
+		db_col_ignore(stmt, "last_tx");
 		last_tx = NULL;
+		last_unloaded = true;
+	} else
+		last_tx = db_col_psbt_to_tx(tmpctx, stmt, "last_tx");
 
 	chan = new_channel(peer, db_col_u64(stmt, "id"),
 			   &wshachain,
@@ -1513,9 +1587,10 @@ static struct channel *wallet_stmt2channel(struct wallet *w, struct db_stmt *stm
 			   msat_to_us_max, /* msatoshi_to_us_max */
 			   last_tx,
 			   &last_sig,
-			   wallet_htlc_sigs_load(tmpctx, w,
-						 db_col_u64(stmt, "id"),
-						 db_col_int(stmt, "option_anchor_outputs")),
+			   last_unloaded ? NULL
+			   : wallet_htlc_sigs_load(tmpctx, w,
+						   db_col_u64(stmt, "id"),
+						   db_col_int(stmt, "option_anchor_outputs")),
 			   &channel_info,
 			   take(fee_states),
 			   remote_shutdown_scriptpubkey,
@@ -1545,6 +1620,8 @@ static struct channel *wallet_stmt2channel(struct wallet *w, struct db_stmt *stm
 			   htlc_minimum_msat,
 			   htlc_maximum_msat);
 
+	chan->last_tx_unloaded = last_unloaded;
+
 	if (!wallet_channel_load_inflights(w, chan)) {
 		tal_free(chan);
 		return NULL;
@@ -1902,7 +1979,7 @@ void wallet_channel_save(struct wallet *w, struct channel *chan)
 					"  shutdown_scriptpubkey_remote=?,"
 					"  shutdown_keyidx_local=?," // 18
 					"  channel_config_local=?," // 19
-					"  last_tx=?, last_sig=?," // 20 + 21
+					"  last_tx=COALESCE(?, last_tx), last_sig=?," // 20 + 21
 					"  last_was_revoke=?," // 22
 					"  min_possible_feerate=?," // 23
 					"  max_possible_feerate=?," // 24
@@ -1956,6 +2033,8 @@ void wallet_channel_save(struct wallet *w, struct channel *chan)
 	db_bind_talarr(stmt, 17, chan->shutdown_scriptpubkey[REMOTE]);
 	db_bind_u64(stmt, 18, chan->final_key_idx);
 	db_bind_u64(stmt, 19, chan->our_config.id);
+	/* NULL leaves it alone: stubs have none, and onchain channels
+	 * may have unloaded theirs (see channel_unload_last_tx). */
 	if (chan->last_tx)
 		db_bind_psbt(stmt, 20, chan->last_tx->psbt);
 	else
@@ -2250,6 +2329,7 @@ void wallet_channel_close(struct wallet *w, u64 wallet_id)
 	struct db_stmt *stmt;
 
 	/* Delete entries from `channel_htlcs` */
+	wallet_htlc_flush(w);
 	stmt = db_prepare_v2(w->db, SQL("DELETE FROM channel_htlcs "
 					"WHERE channel_id=?"));
 	db_bind_u64(stmt, 0, wallet_id);
@@ -2543,56 +2623,59 @@ void wallet_htlc_save_out(struct wallet *wallet,
 }
 
 /* input htlcs use failcode & failonion & we_filled, output htlcs use failmsg & failonion */
-void wallet_htlc_update(struct wallet *wallet, const u64 htlc_dbid,
-			const enum htlc_state new_state,
-			const struct preimage *payment_key,
-			u64 max_commit_num,
-			enum onion_wire badonion,
-			const struct onionreply *failonion,
-			const u8 *failmsg,
-			bool *we_filled)
+/* An HTLC goes through several states, often in a single transaction.
+ * Since each update overwrites all the fields, we only need to write the
+ * last one: we keep them here until commit (or until someone reads
+ * channel_htlcs). */
+struct htlc_pending_update {
+	u64 dbid;
+	enum htlc_state state;
+	struct preimage *payment_key;
+	u64 max_commit_num;
+	enum onion_wire badonion;
+	struct onionreply *failonion;
+	u8 *failmsg;
+	bool *we_filled;
+};
+
+static void wallet_htlc_write(struct wallet *wallet,
+			      const struct htlc_pending_update *u)
 {
 	struct db_stmt *stmt;
-	bool terminal = (new_state == RCVD_REMOVE_ACK_REVOCATION
-			 || new_state == SENT_REMOVE_ACK_REVOCATION);
+	bool terminal = (u->state == RCVD_REMOVE_ACK_REVOCATION
+			 || u->state == SENT_REMOVE_ACK_REVOCATION);
 
-	/* We should only use this for badonion codes */
-	assert(!badonion || (badonion & BADONION));
-
-	/* The database ID must be set by a previous call to
-	 * `wallet_htlc_save_*` */
-	assert(htlc_dbid);
 	stmt = db_prepare_v2(
 	    wallet->db, SQL("UPDATE channel_htlcs SET hstate=?, payment_key=?, "
 			    "malformed_onion=?, failuremsg=?, localfailmsg=?, "
 			    "we_filled=?, max_commit_num=?"
 			    " WHERE id=?"));
 
-	db_bind_int(stmt, 0, htlc_state_in_db(new_state));
-	db_bind_u64(stmt, 7, htlc_dbid);
+	db_bind_int(stmt, 0, htlc_state_in_db(u->state));
+	db_bind_u64(stmt, 7, u->dbid);
 
-	if (payment_key)
-		db_bind_preimage(stmt, 1, payment_key);
+	if (u->payment_key)
+		db_bind_preimage(stmt, 1, u->payment_key);
 	else
 		db_bind_null(stmt, 1);
 
-	db_bind_int(stmt, 2, badonion);
+	db_bind_int(stmt, 2, u->badonion);
 
-	if (failonion)
-		db_bind_onionreply(stmt, 3, failonion);
+	if (u->failonion)
+		db_bind_onionreply(stmt, 3, u->failonion);
 	else
 		db_bind_null(stmt, 3);
 
-	db_bind_talarr(stmt, 4, failmsg);
+	db_bind_talarr(stmt, 4, u->failmsg);
 
-	if (we_filled)
-		db_bind_int(stmt, 5, *we_filled);
+	if (u->we_filled)
+		db_bind_int(stmt, 5, *u->we_filled);
 	else
 		db_bind_null(stmt, 5);
 
 	/* Set max_commit_num iff we're in final state. */
 	if (terminal)
-		db_bind_u64(stmt, 6, max_commit_num);
+		db_bind_u64(stmt, 6, u->max_commit_num);
 	else
 		db_bind_null(stmt, 6);
 
@@ -2604,11 +2687,63 @@ void wallet_htlc_update(struct wallet *wallet, const u64 htlc_dbid,
 			wallet->db,
 			SQL("UPDATE channel_htlcs SET payment_key=NULL, routing_onion=NULL, failuremsg=NULL, shared_secret=NULL, localfailmsg=NULL "
 			    " WHERE id=?"));
-		db_bind_u64(stmt, 0, htlc_dbid);
+		db_bind_u64(stmt, 0, u->dbid);
 		db_exec_prepared_v2(take(stmt));
 	}
 }
 
+/* Write out any cached HTLC updates: called before commit, and before
+ * anything reads channel_htlcs. */
+static void wallet_htlc_flush(struct wallet *wallet)
+{
+	struct htlc_pending_update *u;
+	u64 idx;
+
+	for (u = uintmap_first(&wallet->pending_htlc_updates, &idx);
+	     u;
+	     u = uintmap_after(&wallet->pending_htlc_updates, &idx)) {
+		wallet_htlc_write(wallet, u);
+		tal_free(u);
+	}
+	uintmap_clear(&wallet->pending_htlc_updates);
+}
+
+void wallet_htlc_update(struct wallet *wallet, const u64 htlc_dbid,
+			const enum htlc_state new_state,
+			const struct preimage *payment_key,
+			u64 max_commit_num,
+			enum onion_wire badonion,
+			const struct onionreply *failonion,
+			const u8 *failmsg,
+			bool *we_filled)
+{
+	struct htlc_pending_update *u;
+
+	/* We should only use this for badonion codes */
+	assert(!badonion || (badonion & BADONION));
+
+	/* The database ID must be set by a previous call to
+	 * `wallet_htlc_save_*` */
+	assert(htlc_dbid);
+
+	/* Replaces any previous update in this transaction. */
+	u = uintmap_get(&wallet->pending_htlc_updates, htlc_dbid);
+	if (u) {
+		uintmap_del(&wallet->pending_htlc_updates, htlc_dbid);
+		tal_free(u);
+	}
+	u = tal(wallet, struct htlc_pending_update);
+	u->dbid = htlc_dbid;
+	u->state = new_state;
+	u->payment_key = tal_dup_or_null(u, struct preimage, payment_key);
+	u->max_commit_num = max_commit_num;
+	u->badonion = badonion;
+	u->failonion = failonion ? dup_onionreply(u, failonion) : NULL;
+	u->failmsg = tal_dup_talarr(u, u8, failmsg);
+	u->we_filled = tal_dup_or_null(u, bool, we_filled);
+	uintmap_add(&wallet->pending_htlc_updates, htlc_dbid, u);
+}
+
 static bool wallet_stmt2htlc_in(struct channel *channel,
 				struct db_stmt *stmt, struct htlc_in *in)
 {
@@ -2663,6 +2798,8 @@ static bool wallet_stmt2htlc_in(struct channel *channel,
 	} else
 #endif /* COMPAT_V072 */
 	in->received_time = db_col_timeabs(stmt, "received_time");
+	/* We don't know how long ago the stages before restart were. */
+	memset(in->stage_time, 0, sizeof(in->stage_time));
 
 #ifdef COMPAT_V080
 	/* This field is now reserved for badonion codes: the rest should
@@ -2785,6 +2922,29 @@ static void fixup_hin(struct wallet *wallet, struct htlc_in *hin)
 #endif
 }
 
+u64 *wallet_channels_with_htlcs(const tal_t *ctx, struct wallet *wallet)
+{
+	struct db_stmt *stmt;
+	u64 *dbids = tal_arr(ctx, u64, 0);
+
+	wallet_htlc_flush(wallet);
+	stmt = db_prepare_v2(wallet->db, SQL("SELECT DISTINCT"
+					     "  channel_id"
+					     " FROM channel_htlcs"
+					     " WHERE hstate NOT IN (?, ?)"
+					     " ORDER BY channel_id"));
+	/* Same `hstate NOT IN (9, 19)` as the loaders, to use the index. */
+	db_bind_int(stmt, 0, RCVD_REMOVE_ACK_REVOCATION);
+	db_bind_int(stmt, 1, SENT_REMOVE_ACK_REVOCATION);
+	db_query_prepared(stmt);
+
+	while (db_step(stmt))
+		tal_arr_expand(&dbids, db_col_u64(stmt, "channel_id"));
+	tal_free(stmt);
+
+	return dbids;
+}
+
 bool wallet_htlcs_load_in_for_channel(struct wallet *wallet,
 				      struct channel *chan,
 				      struct htlc_in_map *htlcs_in)
@@ -2793,6 +2953,7 @@ bool wallet_htlcs_load_in_for_channel(struct wallet *wallet,
 	bool ok = true;
 	int incount = 0;
 
+	wallet_htlc_flush(wallet);
 	log_debug(wallet->log, "Loading in HTLCs for channel %"PRIu64, chan->dbid);
 	stmt = db_prepare_v2(wallet->db, SQL("SELECT"
 					     "  id"
@@ -2847,6 +3008,7 @@ bool wallet_htlcs_load_out_for_channel(struct wallet *wallet,
 	bool ok = true;
 	int outcount = 0;
 
+	wallet_htlc_flush(wallet);
 	stmt = db_prepare_v2(wallet->db, SQL("SELECT"
 					     "  id"
 					     ", channel_htlc_id"
@@ -2940,9 +3102,13 @@ void wallet_invoice_delete_expired(struct wallet *wallet, u64 e)
 	invoices_delete_expired(wallet->invoices, e);
 }
 bool wallet_invoice_iterate(struct wallet *wallet,
-			    struct invoice_iterator *it)
+			    struct invoice_iterator *it,
+			    const struct sha256 *local_offer_id,
+			    u64 start,
+			    const u32 *limit)
 {
-	return invoices_iterate(wallet->invoices, it);
+	return invoices_iterate(wallet->invoices, it,
+				local_offer_id, start, limit);
 }
 const struct invoice_details *
 wallet_invoice_iterator_deref(const tal_t *ctx, struct wallet *wallet,
@@ -2959,7 +3125,9 @@ bool wallet_invoice_resolve(struct wallet *wallet,
 void wallet_invoice_waitany(const tal_t *ctx,
 			    struct wallet *wallet,
 			    u64 lastpay_index,
-			    void (*cb)(const struct invoice *, void*),
+			    void (*cb)(const struct invoice *,
+				       const struct invoice_details *,
+				       void *),
 			    void *cbarg)
 {
 	invoices_waitany(ctx, wallet->invoices, lastpay_index, cb, cbarg);
@@ -2967,7 +3135,9 @@ void wallet_invoice_waitany(const tal_t *ctx,
 void wallet_invoice_waitone(const tal_t *ctx,
 			    struct wallet *wallet,
 			    struct invoice invoice,
-			    void (*cb)(const struct invoice *, void*),
+			    void (*cb)(const struct invoice *,
+				       const struct invoice_details *,
+				       void *),
 			    void *cbarg)
 {
 	invoices_waitone(ctx, wallet->invoices, invoice, cb, cbarg);
@@ -2987,6 +3157,7 @@ struct htlc_stub *wallet_htlc_stubs(const tal_t *ctx, struct wallet *wallet,
 	struct sha256 payment_hash;
 	struct db_stmt *stmt;
 
+	wallet_htlc_flush(wallet);
 	stmt = db_prepare_v2(wallet->db,
 			     SQL("SELECT channel_id, direction, cltv_expiry, "
 				 "channel_htlc_id, payment_hash "
@@ -3024,6 +3195,7 @@ void wallet_local_htlc_out_delete(struct wallet *wallet,
 {
 	struct db_stmt *stmt;
 
+	wallet_htlc_flush(wallet);
 	stmt = db_prepare_v2(wallet->db, SQL("DELETE FROM channel_htlcs"
 					     " WHERE direction = ?"
 					     " AND origin_htlc = ?"
@@ -3056,6 +3228,95 @@ static void destroy_unstored_payment(struct wallet_payment *payment)
 	list_del(&payment->list);
 }
 
+/* sendpay and waitsendpay want the latest groupid for a payment_hash on
+ * every part: while parts are pending we remember it, rather than asking
+ * the db each time as payments table grows.  There are only ever a few
+ * of these, so a list is fine. */
+struct inflight_group {
+	struct list_node list;
+	struct sha256 payment_hash;
+	/* MAX(groupid) in the db for this payment_hash */
+	u64 max_groupid;
+	/* How many stored parts are still PAYMENT_PENDING */
+	size_t num_pending;
+};
+
+static struct inflight_group *find_inflight_group(struct wallet *wallet,
+						  const struct sha256 *payment_hash)
+{
+	struct inflight_group *g;
+
+	list_for_each(&wallet->inflight_groups, g, list) {
+		if (sha256_eq(payment_hash, &g->payment_hash))
+			return g;
+	}
+	return NULL;
+}
+
+static u64 db_payment_get_groupid(struct wallet *wallet,
+				  const struct sha256 *payment_hash)
+{
+	struct db_stmt *stmt;
+	u64 groupid = 0;
+	stmt = db_prepare_v2(
+		wallet->db, SQL("SELECT MAX(groupid) FROM payments WHERE payment_hash = ?"));
+
+	db_bind_sha256(stmt, 0, payment_hash);
+	db_query_prepared(stmt);
+	if (db_step(stmt) && !db_col_is_null(stmt, "MAX(groupid)")) {
+		groupid = db_col_u64(stmt, "MAX(groupid)");
+	}
+	tal_free(stmt);
+	return groupid;
+}
+
+/* Called before a pending part goes into the db. */
+static void inflight_group_add(struct wallet *wallet,
+			       const struct sha256 *payment_hash,
+			       u64 groupid)
+{
+	struct inflight_group *g = find_inflight_group(wallet, payment_hash);
+
+	if (!g) {
+		g = tal(wallet, struct inflight_group);
+		g->payment_hash = *payment_hash;
+		g->max_groupid = db_payment_get_groupid(wallet, payment_hash);
+		g->num_pending = 0;
+		list_add_tail(&wallet->inflight_groups, &g->list);
+	}
+	if (groupid > g->max_groupid)
+		g->max_groupid = groupid;
+	g->num_pending++;
+}
+
+static void inflight_group_resolved(struct wallet *wallet,
+				    const struct sha256 *payment_hash)
+{
+	struct inflight_group *g = find_inflight_group(wallet, payment_hash);
+
+	/* Parts stored before we restarted aren't counted. */
+	if (!g)
+		return;
+	if (--g->num_pending == 0) {
+		list_del_from(&wallet->inflight_groups, &g->list);
+		tal_free(g);
+	}
+}
+
+/* Deleting parts can lower MAX(groupid): just ask the db again. */
+static void inflight_group_forget(struct wallet *wallet,
+				  const struct sha256 *payment_hash)
+{
+	struct inflight_group *g, *next;
+
+	list_for_each_safe(&wallet->inflight_groups, g, next, list) {
+		if (payment_hash && !sha256_eq(payment_hash, &g->payment_hash))
+			continue;
+		list_del_from(&wallet->inflight_groups, &g->list);
+		tal_free(g);
+	}
+}
+
 void wallet_payment_setup(struct wallet *wallet, struct wallet_payment *payment)
 {
 	assert(!find_unstored_payment(wallet, &payment->payment_hash,
@@ -3095,6 +3356,10 @@ void wallet_payment_store(struct wallet *wallet,
         /* Don't attempt to add the same payment twice */
 	assert(!payment->id);
 
+	if (payment->status == PAYMENT_PENDING)
+		inflight_group_add(wallet, &payment->payment_hash,
+				   payment->groupid);
+
 	stmt = db_prepare_v2(
 		wallet->db,
 		SQL("INSERT INTO payments ("
@@ -3184,18 +3449,12 @@ void wallet_payment_store(struct wallet *wallet,
 u64 wallet_payment_get_groupid(struct wallet *wallet,
 			       const struct sha256 *payment_hash)
 {
-	struct db_stmt *stmt;
-	u64 groupid = 0;
-	stmt = db_prepare_v2(
-		wallet->db, SQL("SELECT MAX(groupid) FROM payments WHERE payment_hash = ?"));
+	const struct inflight_group *g;
 
-	db_bind_sha256(stmt, 0, payment_hash);
-	db_query_prepared(stmt);
-	if (db_step(stmt) && !db_col_is_null(stmt, "MAX(groupid)")) {
-		groupid = db_col_u64(stmt, "MAX(groupid)");
-	}
-	tal_free(stmt);
-	return groupid;
+	g = find_inflight_group(wallet, payment_hash);
+	if (g)
+		return g->max_groupid;
+	return db_payment_get_groupid(wallet, payment_hash);
 }
 
 void wallet_payment_delete(struct wallet *wallet,
@@ -3221,6 +3480,32 @@ void wallet_payment_delete(struct wallet *wallet,
 	}
 	db_bind_sha256(stmt, 0, payment_hash);
 	db_exec_prepared_v2(take(stmt));
+	inflight_group_forget(wallet, payment_hash);
+}
+
+u64 wallet_payments_delete_before(struct wallet *wallet,
+				  enum wallet_payment_status status,
+				  u64 before,
+				  u32 limit)
+{
+	struct db_stmt *stmt;
+	u64 deleted;
+
+	stmt = db_prepare_v2(wallet->db,
+			     SQL("DELETE FROM payments"
+				 " WHERE id IN (SELECT id FROM payments"
+				 "  WHERE status = ? AND timestamp < ?"
+				 "  ORDER BY timestamp LIMIT ?);"));
+	db_bind_int(stmt, 0, wallet_payment_status_in_db(status));
+	db_bind_u64(stmt, 1, before);
+	db_bind_u64(stmt, 2, limit);
+	db_exec_prepared_v2(stmt);
+	deleted = db_count_changes(stmt);
+	tal_free(stmt);
+
+	if (status == PAYMENT_PENDING && deleted)
+		inflight_group_forget(wallet, NULL);
+	return deleted;
 }
 
 static struct wallet_payment *wallet_stmt2payment(const tal_t *ctx,
@@ -3416,6 +3701,8 @@ void wallet_payment_set_status(struct wallet *wallet,
 		db_exec_prepared_v2(take(stmt));
 	}
 	if (newstatus != PAYMENT_PENDING) {
+		/* A part only leaves PENDING once, when its HTLC resolves */
+		inflight_group_resolved(wallet, payment_hash);
 		stmt =
 		    db_prepare_v2(wallet->db, SQL("UPDATE payments"
 						  "   SET path_secrets = NULL"
@@ -3564,15 +3851,19 @@ void wallet_payment_set_failinfo(struct wallet *wallet,
 const struct wallet_payment **
 wallet_payment_list(const tal_t *ctx,
 		    struct wallet *wallet,
-		    const struct sha256 *payment_hash)
+		    const struct sha256 *payment_hash,
+		    const enum wallet_payment_status *status,
+		    u64 start,
+		    const u32 *limit)
 {
 	const struct wallet_payment **payments;
 	struct db_stmt *stmt;
 	struct wallet_payment *p;
-	size_t i;
+	size_t i, pos;
 
 	payments = tal_arr(ctx, const struct wallet_payment *, 0);
 
+	/* Separate queries, so we use the payment_hash index when we can */
 	if (payment_hash) {
 		stmt = db_prepare_v2(wallet->db, SQL("SELECT"
 						     "  id"
@@ -3598,8 +3889,12 @@ wallet_payment_list(const tal_t *ctx,
 						     " FROM payments"
 						     " WHERE"
 						     "  payment_hash = ?"
-						     " ORDER BY id;"));
+						     "  AND (1 = ? OR status = ?)"
+						     "  AND id >= ?"
+						     " ORDER BY id"
+						     " LIMIT ?;"));
 		db_bind_sha256(stmt, 0, payment_hash);
+		pos = 1;
 	} else {
 		stmt = db_prepare_v2(wallet->db, SQL("SELECT"
 						     "  id"
@@ -3623,8 +3918,23 @@ wallet_payment_list(const tal_t *ctx,
 						     ", groupid"
 						     ", completed_at"
 						     " FROM payments"
-						     " ORDER BY id;"));
+						     " WHERE"
+						     "  (1 = ? OR status = ?)"
+						     "  AND id >= ?"
+						     " ORDER BY id"
+						     " LIMIT ?;"));
+		pos = 0;
 	}
+
+	if (status) {
+		db_bind_int(stmt, pos, 0);
+		db_bind_int(stmt, pos + 1, wallet_payment_status_in_db(*status));
+	} else {
+		db_bind_int(stmt, pos, 1);
+		db_bind_null(stmt, pos + 1);
+	}
+	db_bind_u64(stmt, pos + 2, start);
+	db_bind_u64(stmt, pos + 3, limit ? *limit : INT64_MAX);
 	db_query_prepared(stmt);
 
 	for (i = 0; db_step(stmt); i++) {
@@ -3633,10 +3943,16 @@ wallet_payment_list(const tal_t *ctx,
 	}
 	tal_free(stmt);
 
+	/* These don't have an id yet, so can't be paged. */
+	if (start != 0 || limit)
+		return payments;
+
 	/* Now attach payments not yet in db. */
 	list_for_each(&wallet->unstored_payments, p, list) {
 		if (payment_hash && !sha256_eq(&p->payment_hash, payment_hash))
 			continue;
+		if (status && p->status != *status)
+			continue;
 		tal_resize(&payments, i+1);
 		payments[i++] = p;
 	}
@@ -4052,6 +4368,24 @@ wallet_utxoset_get_spent(const tal_t *ctx, struct wallet *w,
 	return db_scids(ctx, stmt);
 }
 
+const u8 **wallet_utxoset_unspent_scripts(const tal_t *ctx, struct wallet *w)
+{
+	struct db_stmt *stmt;
+	const u8 **scripts = tal_arr(ctx, const u8 *, 0);
+
+	stmt = db_prepare_v2(w->db, SQL("SELECT"
+					" scriptpubkey "
+					"FROM utxoset "
+					"WHERE spendheight IS NULL"));
+	db_query_prepared(stmt);
+	while (db_step(stmt)) {
+		const u8 *script = db_col_arr(scripts, stmt, "scriptpubkey", u8);
+		tal_arr_expand(&scripts, script);
+	}
+	tal_free(stmt);
+	return scripts;
+}
+
 const struct short_channel_id *
 wallet_utxoset_get_created(const tal_t *ctx, struct wallet *w,
 			   u32 blockheight)
@@ -4387,6 +4721,37 @@ static bool wallet_forwarded_payment_update(struct wallet *w,
 	return changed;
 }
 
+/* Keep total_forward_fees up to date as forwards settle, so getinfo
+ * doesn't have to add up the whole forwards table. */
+static void forward_fees_add(struct wallet *w,
+			     const struct htlc_in *in,
+			     const struct htlc_out *out)
+{
+	struct db_stmt *stmt;
+	struct amount_msat fee;
+	bool already;
+
+	/* Don't count it twice if we're told again. */
+	stmt = db_prepare_v2(w->db, SQL("SELECT state FROM forwards"
+					" WHERE in_htlc_id = ? AND in_channel_scid = ?"));
+	db_bind_u64(stmt, 0, in->key.id);
+	db_bind_scid(stmt, 1, channel_scid_or_local_alias(in->key.channel));
+	db_query_prepared(stmt);
+	already = db_step(stmt)
+		&& db_col_int(stmt, "state") == wallet_forward_status_in_db(FORWARD_SETTLED);
+	tal_free(stmt);
+	if (already)
+		return;
+
+	if (!out || !amount_msat_sub(&fee, in->msat, out->msat))
+		return;
+
+	fee.millisatoshis += /* Raw: db access */
+		db_get_intvar(w->db, "total_forward_fees", 0);
+	db_set_intvar(w->db, "total_forward_fees",
+		      fee.millisatoshis); /* Raw: db access */
+}
+
 void wallet_forwarded_payment_add(struct wallet *w, const struct htlc_in *in,
 				  enum forward_style forward_style,
 				  const struct short_channel_id *scid_out,
@@ -4396,6 +4761,7 @@ void wallet_forwarded_payment_add(struct wallet *w, const struct htlc_in *in,
 {
 	struct db_stmt *stmt;
 	struct timeabs *resolved_time;
+	u64 created_index;
 
 	if (state == FORWARD_SETTLED || state == FORWARD_FAILED) {
 		resolved_time = tal(tmpctx, struct timeabs);
@@ -4404,6 +4770,9 @@ void wallet_forwarded_payment_add(struct wallet *w, const struct htlc_in *in,
 		resolved_time = NULL;
 	}
 
+	if (state == FORWARD_SETTLED)
+		forward_fees_add(w, in, out);
+
 	if (wallet_forwarded_payment_update(w, in, out, state, failcode, resolved_time, forward_style))
 		goto notify;
 
@@ -4420,7 +4789,8 @@ void wallet_forwarded_payment_add(struct wallet *w, const struct htlc_in *in,
 				 ", resolved_time"
 				 ", failcode"
 				 ", forward_style"
-				 ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);"));
+				 ", created_index"
+				 ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);"));
 	db_bind_u64(stmt, 0, in->key.id);
 
 	/* FORWARD_LOCAL_FAILED may occur before we get htlc_out */
@@ -4471,39 +4841,23 @@ void wallet_forwarded_payment_add(struct wallet *w, const struct htlc_in *in,
 	else
 		db_bind_int(stmt, 10, forward_style_in_db(forward_style));
 
+	/* Never reused, even if forwards are deleted: listforwards callers
+	 * use it to page through. */
+	created_index = db_get_intvar(w->db, "last_forward_created_index", 0) + 1;
+	db_set_intvar(w->db, "last_forward_created_index", created_index);
+	db_bind_u64(stmt, 11, created_index);
+
 	db_exec_prepared_v2(take(stmt));
 
 notify:
+	w->ld->forwards_by_status[state]++;
 	notify_forward_event(w->ld, in, scid_out, out ? &out->msat : NULL,
 			     state, failcode, resolved_time, forward_style);
 }
 
 struct amount_msat wallet_total_forward_fees(struct wallet *w)
 {
-	struct db_stmt *stmt;
-	struct amount_msat total, deleted;
-	bool res;
-
-	stmt = db_prepare_v2(w->db, SQL("SELECT"
-					" CAST(COALESCE(SUM(in_msatoshi - out_msatoshi), 0) AS BIGINT)"
-					" FROM forwards "
-					"WHERE state = ?;"));
-	db_bind_int(stmt, 0, wallet_forward_status_in_db(FORWARD_SETTLED));
-	db_query_prepared(stmt);
-
-	res = db_step(stmt);
-	assert(res);
-
-	db_col_amount_msat(stmt, "CAST(COALESCE(SUM(in_msatoshi - out_msatoshi), 0) AS BIGINT)", &total);
-	tal_free(stmt);
-
-	deleted = amount_msat(db_get_intvar(w->db, "deleted_forward_fees", 0));
-	if (!amount_msat_add(&total, total, deleted))
-		db_fatal("Adding forward fees %s + %s overflowed",
-			 type_to_string(tmpctx, struct amount_msat, &total),
-			 type_to_string(tmpctx, struct amount_msat, &deleted));
-
-	return total;
+	return amount_msat(db_get_intvar(w->db, "total_forward_fees", 0));
 }
 
 bool string_to_forward_status(const char *status_str,
@@ -4526,11 +4880,19 @@ bool string_to_forward_status(const char *status_str,
 	return false;
 }
 
+bool wallet_forwards_indexed(struct wallet *w)
+{
+	return !db_background_migration_pending(w->db,
+						"bgmigrate_forwards_created_index");
+}
+
 const struct forwarding *wallet_forwarded_payments_get(struct wallet *w,
 						       const tal_t *ctx,
 						       enum forward_status status,
 						       const struct short_channel_id *chan_in,
-						       const struct short_channel_id *chan_out)
+						       const struct short_channel_id *chan_out,
+						       u64 start,
+						       const u32 *limit)
 {
 	struct forwarding *results = tal_arr(ctx, struct forwarding, 0);
 	size_t count = 0;
@@ -4539,24 +4901,129 @@ const struct forwarding *wallet_forwarded_payments_get(struct wallet *w,
 	// placeholder for any parameter, the value doesn't matter because it's discarded by sql
 	const int any = -1;
 
-	stmt = db_prepare_v2(
-	    w->db,
-	    SQL("SELECT"
-		"  state"
-		", in_msatoshi"
-		", out_msatoshi"
-		", in_channel_scid"
-		", out_channel_scid"
-		", in_htlc_id"
-		", out_htlc_id"
-		", received_time"
-		", resolved_time"
-		", failcode "
-		", forward_style "
-		"FROM forwards "
-		"WHERE (1 = ? OR state = ?) AND "
-		"(1 = ? OR in_channel_scid = ?) AND "
-		"(1 = ? OR out_channel_scid = ?)"));
+	/* The "(1 = ? OR col = ?)" form can't use an index, so when
+	 * filtering we use a variant where the most selective filter is
+	 * a plain AND term (same placeholders, so binding is identical). */
+	/* Until the background migration has numbered them all, older
+	 * forwards have no created_index: include them, in the order
+	 * they'll be numbered (which is much slower, but temporary).
+	 * Unnumbered ones would come back on every page, so callers
+	 * don't page until then (we get start 0 and no limit). */
+	if (!wallet_forwards_indexed(w))
+		stmt = db_prepare_v2(
+		    w->db,
+		    SQL("SELECT"
+			"  state"
+			", in_msatoshi"
+			", out_msatoshi"
+			", in_channel_scid"
+			", out_channel_scid"
+			", in_htlc_id"
+			", out_htlc_id"
+			", received_time"
+			", resolved_time"
+			", failcode "
+			", forward_style "
+			", created_index "
+			"FROM forwards "
+			"WHERE (1 = ? OR state = ?) AND "
+			"(1 = ? OR in_channel_scid = ?) AND "
+			"(1 = ? OR out_channel_scid = ?) AND "
+			"(created_index IS NULL OR created_index >= ?) "
+			"ORDER BY received_time, in_channel_scid, in_htlc_id "
+			"LIMIT ?;"));
+	else if (chan_in)
+		stmt = db_prepare_v2(
+		    w->db,
+		    SQL("SELECT"
+			"  state"
+			", in_msatoshi"
+			", out_msatoshi"
+			", in_channel_scid"
+			", out_channel_scid"
+			", in_htlc_id"
+			", out_htlc_id"
+			", received_time"
+			", resolved_time"
+			", failcode "
+			", forward_style "
+			", created_index "
+			"FROM forwards "
+			"WHERE (1 = ? OR state = ?) AND "
+			"(0 = ? AND in_channel_scid = ?) AND "
+			"(1 = ? OR out_channel_scid = ?) AND "
+			"created_index >= ? "
+			"ORDER BY created_index "
+			"LIMIT ?;"));
+	else if (chan_out)
+		stmt = db_prepare_v2(
+		    w->db,
+		    SQL("SELECT"
+			"  state"
+			", in_msatoshi"
+			", out_msatoshi"
+			", in_channel_scid"
+			", out_channel_scid"
+			", in_htlc_id"
+			", out_htlc_id"
+			", received_time"
+			", resolved_time"
+			", failcode "
+			", forward_style "
+			", created_index "
+			"FROM forwards "
+			"WHERE (1 = ? OR state = ?) AND "
+			"(1 = ? OR in_channel_scid = ?) AND "
+			"(0 = ? AND out_channel_scid = ?) AND "
+			"created_index >= ? "
+			"ORDER BY created_index "
+			"LIMIT ?;"));
+	else if (status != FORWARD_ANY)
+		stmt = db_prepare_v2(
+		    w->db,
+		    SQL("SELECT"
+			"  state"
+			", in_msatoshi"
+			", out_msatoshi"
+			", in_channel_scid"
+			", out_channel_scid"
+			", in_htlc_id"
+			", out_htlc_id"
+			", received_time"
+			", resolved_time"
+			", failcode "
+			", forward_style "
+			", created_index "
+			"FROM forwards "
+			"WHERE (0 = ? AND state = ?) AND "
+			"(1 = ? OR in_channel_scid = ?) AND "
+			"(1 = ? OR out_channel_scid = ?) AND "
+			"created_index >= ? "
+			"ORDER BY created_index "
+			"LIMIT ?;"));
+	else
+		stmt = db_prepare_v2(
+		    w->db,
+		    SQL("SELECT"
+			"  state"
+			", in_msatoshi"
+			", out_msatoshi"
+			", in_channel_scid"
+			", out_channel_scid"
+			", in_htlc_id"
+			", out_htlc_id"
+			", received_time"
+			", resolved_time"
+			", failcode "
+			", forward_style "
+			", created_index "
+			"FROM forwards "
+			"WHERE (1 = ? OR state = ?) AND "
+			"(1 = ? OR in_channel_scid = ?) AND "
+			"(1 = ? OR out_channel_scid = ?) AND "
+			"created_index >= ? "
+			"ORDER BY created_index "
+			"LIMIT ?;"));
 
 	if (status == FORWARD_ANY) {
 		// any status
@@ -4588,7 +5055,11 @@ const struct forwarding *wallet_forwarded_payments_get(struct wallet *w,
 		db_bind_int(stmt, 5, any);
 	}
 
-	db_query_prepared(stmt);
+	db_bind_u64(stmt, 6, start);
+	db_bind_u64(stmt, 7, limit ? *limit : INT64_MAX);
+
+	/* Only for listforwards, so a replica will do. */
+	db_query_prepared_stale(stmt);
 
 	for (count=0; db_step(stmt); count++) {
 		tal_resize(&results, count+1);
@@ -4662,11 +5133,71 @@ const struct forwarding *wallet_forwarded_payments_get(struct wallet *w,
 			cur->forward_style
 				= forward_style_in_db(db_col_int(stmt, "forward_style"));
 		}
+		/* Not numbered yet by the background migration? */
+		if (db_col_is_null(stmt, "created_index"))
+			cur->created_index = 0;
+		else
+			cur->created_index = db_col_u64(stmt, "created_index");
 	}
 	tal_free(stmt);
 	return results;
 }
 
+/* Add a forward we're about to delete to its hourly rollup */
+static void forward_rollup_add(struct wallet *w,
+			       const struct short_channel_id *chan_in,
+			       const struct short_channel_id *chan_out,
+			       enum forward_status state,
+			       struct timeabs resolved,
+			       u64 count,
+			       struct amount_msat msat_in,
+			       struct amount_msat msat_out)
+{
+	struct db_stmt *stmt;
+	u64 hour_start = resolved.ts.tv_sec / 3600 * 3600;
+	bool found;
+
+	stmt = db_prepare_v2(w->db, SQL("UPDATE forward_rollups SET"
+					"  num_forwards = num_forwards + ?"
+					", in_msatoshi = in_msatoshi + ?"
+					", out_msatoshi = out_msatoshi + ?"
+					" WHERE in_channel_scid = ?"
+					" AND out_channel_scid = ?"
+					" AND hour_start = ?"
+					" AND state = ?;"));
+	db_bind_u64(stmt, 0, count);
+	db_bind_amount_msat(stmt, 1, &msat_in);
+	db_bind_amount_msat(stmt, 2, &msat_out);
+	db_bind_scid(stmt, 3, chan_in);
+	db_bind_scid(stmt, 4, chan_out);
+	db_bind_u64(stmt, 5, hour_start);
+	db_bind_int(stmt, 6, wallet_forward_status_in_db(state));
+	db_exec_prepared_v2(stmt);
+	found = db_count_changes(stmt) != 0;
+	tal_free(stmt);
+
+	if (found)
+		return;
+
+	stmt = db_prepare_v2(w->db, SQL("INSERT INTO forward_rollups ("
+					"  in_channel_scid"
+					", out_channel_scid"
+					", hour_start"
+					", state"
+					", num_forwards"
+					", in_msatoshi"
+					", out_msatoshi"
+					") VALUES (?, ?, ?, ?, ?, ?, ?);"));
+	db_bind_scid(stmt, 0, chan_in);
+	db_bind_scid(stmt, 1, chan_out);
+	db_bind_u64(stmt, 2, hour_start);
+	db_bind_int(stmt, 3, wallet_forward_status_in_db(state));
+	db_bind_u64(stmt, 4, count);
+	db_bind_amount_msat(stmt, 5, &msat_in);
+	db_bind_amount_msat(stmt, 6, &msat_out);
+	db_exec_prepared_v2(take(stmt));
+}
+
 bool wallet_forward_delete(struct wallet *w,
 			   const struct short_channel_id *chan_in,
 			   const u64 *htlc_id,
@@ -4675,42 +5206,60 @@ bool wallet_forward_delete(struct wallet *w,
 	struct db_stmt *stmt;
 	bool changed;
 
-	/* When deleting settled ones, we have to add to deleted_forward_fees! */
-	if (state == FORWARD_SETTLED) {
-		/* Of course, it might not be settled: don't add if they're wrong! */
-		if (htlc_id) {
-			stmt = db_prepare_v2(w->db, SQL("SELECT"
-							" CAST(COALESCE(SUM(in_msatoshi - out_msatoshi), 0) AS BIGINT)"
-							" FROM forwards "
-							" WHERE in_channel_scid = ?"
-							" AND in_htlc_id = ?"
-							" AND state = ?;"));
-			db_bind_scid(stmt, 0, chan_in);
-			db_bind_u64(stmt, 1, *htlc_id);
-			db_bind_int(stmt, 2, wallet_forward_status_in_db(FORWARD_SETTLED));
-		} else {
-			stmt = db_prepare_v2(w->db, SQL("SELECT"
-							" CAST(COALESCE(SUM(in_msatoshi - out_msatoshi), 0) AS BIGINT)"
-							" FROM forwards "
-							" WHERE in_channel_scid = ?"
-							" AND in_htlc_id IS NULL"
-							" AND state = ?;"));
-			db_bind_scid(stmt, 0, chan_in);
-			db_bind_int(stmt, 1, wallet_forward_status_in_db(FORWARD_SETTLED));
-		}
-		db_query_prepared(stmt);
+	/* Keep hourly totals of what we delete (total_forward_fees already
+	 * includes settled ones, so that needs no change). */
+	if (htlc_id) {
+		stmt = db_prepare_v2(w->db, SQL("SELECT"
+						"  out_channel_scid"
+						", in_msatoshi"
+						", out_msatoshi"
+						", received_time"
+						", resolved_time"
+						" FROM forwards "
+						" WHERE in_channel_scid = ?"
+						" AND in_htlc_id = ?"
+						" AND state = ?;"));
+		db_bind_scid(stmt, 0, chan_in);
+		db_bind_u64(stmt, 1, *htlc_id);
+		db_bind_int(stmt, 2, wallet_forward_status_in_db(state));
+	} else {
+		stmt = db_prepare_v2(w->db, SQL("SELECT"
+						"  out_channel_scid"
+						", in_msatoshi"
+						", out_msatoshi"
+						", received_time"
+						", resolved_time"
+						" FROM forwards "
+						" WHERE in_channel_scid = ?"
+						" AND in_htlc_id IS NULL"
+						" AND state = ?;"));
+		db_bind_scid(stmt, 0, chan_in);
+		db_bind_int(stmt, 1, wallet_forward_status_in_db(state));
+	}
+	db_query_prepared(stmt);
 
-		if (db_step(stmt)) {
-			struct amount_msat deleted;
+	while (db_step(stmt)) {
+		struct short_channel_id chan_out;
+		struct amount_msat msat_in, msat_out;
+		struct timeabs resolved;
 
-			db_col_amount_msat(stmt, "CAST(COALESCE(SUM(in_msatoshi - out_msatoshi), 0) AS BIGINT)", &deleted);
-			deleted.millisatoshis += /* Raw: db access */
-				db_get_intvar(w->db, "deleted_forward_fees", 0);
-			db_set_intvar(w->db, "deleted_forward_fees",
-				      deleted.millisatoshis); /* Raw: db access */
-		}
-		tal_free(stmt);
+		if (!db_col_is_null(stmt, "out_channel_scid"))
+			db_col_scid(stmt, "out_channel_scid", &chan_out);
+		else
+			chan_out.u64 = 0;
+		db_col_amount_msat(stmt, "in_msatoshi", &msat_in);
+		db_col_amount_msat_or_default(stmt, "out_msatoshi", &msat_out,
+					      AMOUNT_MSAT(0));
+		if (!db_col_is_null(stmt, "resolved_time")) {
+			db_col_ignore(stmt, "received_time");
+			resolved = db_col_timeabs(stmt, "resolved_time");
+		} else
+			resolved = db_col_timeabs(stmt, "received_time");
+
+		forward_rollup_add(w, chan_in, &chan_out, state, resolved, 1,
+				   msat_in, msat_out);
 	}
+	tal_free(stmt);
 
 	if (htlc_id) {
 		stmt = db_prepare_v2(w->db,
@@ -4737,6 +5286,135 @@ bool wallet_forward_delete(struct wallet *w,
 	return changed;
 }
 
+u64 wallet_forwards_delete_before(struct wallet *w,
+				  enum forward_status state,
+				  u64 before,
+				  u32 limit)
+{
+	struct db_stmt *stmt;
+	struct timeabs beforetime;
+	u64 cutoff, deleted;
+
+	beforetime.ts.tv_sec = before;
+	beforetime.ts.tv_nsec = 0;
+
+	/* Find the resolved_time which gives us about @limit entries:
+	 * we delete everything up to and including it. */
+	stmt = db_prepare_v2(w->db, SQL("SELECT MAX(resolved_time)"
+					" FROM (SELECT resolved_time FROM forwards"
+					"  WHERE state = ? AND resolved_time < ?"
+					"  ORDER BY resolved_time LIMIT ?) AS oldest;"));
+	db_bind_int(stmt, 0, wallet_forward_status_in_db(state));
+	db_bind_timeabs(stmt, 1, beforetime);
+	db_bind_u64(stmt, 2, limit);
+	db_query_prepared(stmt);
+	if (!db_step(stmt) || db_col_is_null(stmt, "MAX(resolved_time)")) {
+		tal_free(stmt);
+		return 0;
+	}
+	cutoff = db_col_u64(stmt, "MAX(resolved_time)");
+	tal_free(stmt);
+
+	/* Fold them into the rollups, an hour at a time. */
+	stmt = db_prepare_v2(w->db, SQL("SELECT"
+					"  in_channel_scid"
+					", out_channel_scid"
+					", resolved_time / 3600000000000 AS resolved_hour"
+					", COUNT(*) AS num"
+					", CAST(SUM(in_msatoshi) AS BIGINT) AS in_total"
+					", CAST(SUM(out_msatoshi) AS BIGINT) AS out_total"
+					" FROM forwards"
+					" WHERE state = ? AND resolved_time <= ?"
+					" GROUP BY in_channel_scid, out_channel_scid,"
+					"  resolved_time / 3600000000000;"));
+	db_bind_int(stmt, 0, wallet_forward_status_in_db(state));
+	db_bind_u64(stmt, 1, cutoff);
+	db_query_prepared(stmt);
+	while (db_step(stmt)) {
+		struct short_channel_id chan_in, chan_out;
+		struct amount_msat msat_in, msat_out;
+		struct timeabs hour;
+
+		db_col_scid(stmt, "in_channel_scid", &chan_in);
+		if (!db_col_is_null(stmt, "out_channel_scid"))
+			db_col_scid(stmt, "out_channel_scid", &chan_out);
+		else
+			chan_out.u64 = 0;
+		hour.ts.tv_sec = db_col_u64(stmt, "resolved_hour") * 3600;
+		hour.ts.tv_nsec = 0;
+		db_col_amount_msat(stmt, "in_total", &msat_in);
+		db_col_amount_msat_or_default(stmt, "out_total",
+					      &msat_out, AMOUNT_MSAT(0));
+		forward_rollup_add(w, &chan_in, &chan_out, state, hour,
+				   db_col_u64(stmt, "num"),
+				   msat_in, msat_out);
+	}
+	tal_free(stmt);
+
+	stmt = db_prepare_v2(w->db, SQL("DELETE FROM forwards"
+					" WHERE state = ? AND resolved_time <= ?;"));
+	db_bind_int(stmt, 0, wallet_forward_status_in_db(state));
+	db_bind_u64(stmt, 1, cutoff);
+	db_exec_prepared_v2(stmt);
+	deleted = db_count_changes(stmt);
+	tal_free(stmt);
+
+	return deleted;
+}
+
+const struct forward_rollup *wallet_forward_rollups_get(struct wallet *w,
+							const tal_t *ctx,
+							const struct short_channel_id *chan_in,
+							const struct short_channel_id *chan_out)
+{
+	struct forward_rollup *results = tal_arr(ctx, struct forward_rollup, 0);
+	struct db_stmt *stmt;
+
+	stmt = db_prepare_v2(w->db, SQL("SELECT"
+					"  in_channel_scid"
+					", out_channel_scid"
+					", hour_start"
+					", state"
+					", num_forwards"
+					", in_msatoshi"
+					", out_msatoshi"
+					" FROM forward_rollups"
+					" WHERE (1 = ? OR in_channel_scid = ?)"
+					" AND (1 = ? OR out_channel_scid = ?)"
+					" ORDER BY hour_start, in_channel_scid, out_channel_scid;"));
+	if (chan_in) {
+		db_bind_int(stmt, 0, 0);
+		db_bind_scid(stmt, 1, chan_in);
+	} else {
+		db_bind_int(stmt, 0, 1);
+		db_bind_int(stmt, 1, -1);
+	}
+	if (chan_out) {
+		db_bind_int(stmt, 2, 0);
+		db_bind_scid(stmt, 3, chan_out);
+	} else {
+		db_bind_int(stmt, 2, 1);
+		db_bind_int(stmt, 3, -1);
+	}
+	db_query_prepared(stmt);
+
+	while (db_step(stmt)) {
+		struct forward_rollup r;
+
+		db_col_scid(stmt, "in_channel_scid", &r.channel_in);
+		db_col_scid(stmt, "out_channel_scid", &r.channel_out);
+		r.hour_start.ts.tv_sec = db_col_u64(stmt, "hour_start");
+		r.hour_start.ts.tv_nsec = 0;
+		r.status = wallet_forward_status_in_db(db_col_int(stmt, "state"));
+		r.count = db_col_u64(stmt, "num_forwards");
+		db_col_amount_msat(stmt, "in_msatoshi", &r.msat_in);
+		db_col_amount_msat(stmt, "out_msatoshi", &r.msat_out);
+		tal_arr_expand(&results, r);
+	}
+	tal_free(stmt);
+	return results;
+}
+
 struct wallet_transaction *wallet_transactions_get(struct wallet *w, const tal_t *ctx)
 {
 	struct db_stmt *stmt;
@@ -4896,6 +5574,19 @@ void wallet_penalty_base_delete(struct wallet *w, u64 chan_id, u64 commitnum)
 	db_exec_prepared_v2(take(stmt));
 }
 
+void wallet_penalty_base_delete_revoked(struct wallet *w, u64 chan_id,
+					u64 num_revocations)
+{
+	struct db_stmt *stmt;
+	stmt = db_prepare_v2(
+		w->db,
+		SQL("DELETE FROM penalty_bases "
+		    "WHERE channel_id = ? AND commitnum < ?"));
+	db_bind_u64(stmt, 0, chan_id);
+	db_bind_u64(stmt, 1, num_revocations);
+	db_exec_prepared_v2(take(stmt));
+}
+
 bool wallet_offer_create(struct wallet *w,
 			 const struct sha256 *offer_id,
 			 const char *bolt12,
@@ -5001,6 +5692,7 @@ struct db_stmt *wallet_offer_id_next(struct wallet *w,
 /* If we make an offer inactive, this also expires all invoices
  * which we issued for it. */
 static void offer_status_update(struct db *db,
+				struct invoices *invoices,
 				const struct sha256 *offer_id,
 				enum offer_status oldstatus,
 				enum offer_status newstatus)
@@ -5018,13 +5710,7 @@ static void offer_status_update(struct db *db,
 	    || offer_status_active(newstatus))
 		return;
 
-	stmt = db_prepare_v2(db, SQL("UPDATE invoices"
-				     " SET state=?"
-				     " WHERE state=? AND local_offer_id = ?;"));
-	db_bind_int(stmt, 0, invoice_status_in_db(EXPIRED));
-	db_bind_int(stmt, 1, invoice_status_in_db(UNPAID));
-	db_bind_sha256(stmt, 2, offer_id);
-	db_exec_prepared_v2(take(stmt));
+	invoices_expire_offer(invoices, offer_id);
 }
 
 enum offer_status wallet_offer_disable(struct wallet *w,
@@ -5036,12 +5722,13 @@ enum offer_status wallet_offer_disable(struct wallet *w,
 	assert(offer_status_active(s));
 
 	newstatus = offer_status_in_db(s & ~OFFER_STATUS_ACTIVE_F);
-	offer_status_update(w->db, offer_id, s, newstatus);
+	offer_status_update(w->db, w->invoices, offer_id, s, newstatus);
 
 	return newstatus;
 }
 
-void wallet_offer_mark_used(struct db *db, const struct sha256 *offer_id)
+void wallet_offer_mark_used(struct db *db, struct invoices *invoices,
+			    const struct sha256 *offer_id)
 {
 	struct db_stmt *stmt;
 	enum offer_status status;
@@ -5072,7 +5759,7 @@ void wallet_offer_mark_used(struct db *db, const struct sha256 *offer_id)
 			newstatus = OFFER_SINGLE_USE_USED;
 		else
 			newstatus = OFFER_MULTIPLE_USE_USED;
-		offer_status_update(db, offer_id, status, newstatus);
+		offer_status_update(db, invoices, offer_id, status, newstatus);
 	}
 }
 
@@ -5244,27 +5931,39 @@ void wallet_invoice_request_mark_used(struct db *db, const struct sha256 *invreq
 }
 
 /* We join key parts with nuls for now. */
-static void db_bind_datastore_key(struct db_stmt *stmt,
-				  int pos,
-				  const char **key)
+static u8 *datastore_key_join(const tal_t *ctx, const char **key)
 {
 	u8 *joined;
 	size_t len;
 
-	if (tal_count(key) == 1) {
-		db_bind_blob(stmt, pos, (u8 *)key[0], strlen(key[0]));
-		return;
-	}
-
 	len = strlen(key[0]);
-	joined = (u8 *)tal_strdup(tmpctx, key[0]);
+	joined = tal_dup_arr(ctx, u8, (u8 *)key[0], len, 0);
 	for (size_t i = 1; i < tal_count(key); i++) {
 		tal_resize(&joined, len + 1 + strlen(key[i]));
 		joined[len] = '\0';
 		memcpy(joined + len + 1, key[i], strlen(key[i]));
 		len += 1 + strlen(key[i]);
 	}
-	db_bind_blob(stmt, pos, joined, len);
+	return joined;
+}
+
+static void db_bind_datastore_key(struct db_stmt *stmt,
+				  int pos,
+				  const char **key)
+{
+	u8 *joined = datastore_key_join(tmpctx, key);
+	db_bind_blob(stmt, pos, joined, tal_bytelen(joined));
+}
+
+/* Binds the first possible key after key and all its children: since
+ * children are key||0||..., that's key||1. */
+static void db_bind_datastore_key_end(struct db_stmt *stmt,
+				      int pos,
+				      const char **key)
+{
+	u8 *joined = datastore_key_join(tmpctx, key);
+	tal_arr_expand(&joined, 1);
+	db_bind_blob(stmt, pos, joined, tal_bytelen(joined));
 }
 
 static const char **db_col_datastore_key(const tal_t *ctx,
@@ -5325,22 +6024,40 @@ void wallet_datastore_remove(struct wallet *w, const char **key)
 	db_exec_prepared_v2(take(stmt));
 }
 
-struct db_stmt *wallet_datastore_first(const tal_t *ctx,
+struct db_stmt *wallet_datastore_after(const tal_t *ctx,
 				       struct wallet *w,
 				       const char **startkey,
+				       const char **afterkey,
 				       const char ***key,
 				       const u8 **data,
 				       u64 *generation)
 {
 	struct db_stmt *stmt;
 
-	if (startkey) {
+	/* The primary key index makes these range scans. */
+	if (startkey && afterkey) {
 		stmt = db_prepare_v2(w->db,
 				     SQL("SELECT key, data, generation"
 					 " FROM datastore"
-					 " WHERE key >= ?"
+					 " WHERE key >= ? AND key < ?"
+					 " ORDER BY key;"));
+		db_bind_datastore_key_end(stmt, 0, afterkey);
+		db_bind_datastore_key_end(stmt, 1, startkey);
+	} else if (startkey) {
+		stmt = db_prepare_v2(w->db,
+				     SQL("SELECT key, data, generation"
+					 " FROM datastore"
+					 " WHERE key >= ? AND key < ?"
 					 " ORDER BY key;"));
 		db_bind_datastore_key(stmt, 0, startkey);
+		db_bind_datastore_key_end(stmt, 1, startkey);
+	} else if (afterkey) {
+		stmt = db_prepare_v2(w->db,
+				     SQL("SELECT key, data, generation"
+					 " FROM datastore"
+					 " WHERE key >= ?"
+					 " ORDER BY key;"));
+		db_bind_datastore_key_end(stmt, 0, afterkey);
 	} else {
 		stmt = db_prepare_v2(w->db,
 				     SQL("SELECT key, data, generation"
@@ -5352,6 +6069,17 @@ struct db_stmt *wallet_datastore_first(const tal_t *ctx,
 	return wallet_datastore_next(ctx, w, stmt, key, data, generation);
 }
 
+struct db_stmt *wallet_datastore_first(const tal_t *ctx,
+				       struct wallet *w,
+				       const char **startkey,
+				       const char ***key,
+				       const u8 **data,
+				       u64 *generation)
+{
+	return wallet_datastore_after(ctx, w, startkey, NULL,
+				      key, data, generation);
+}
+
 struct db_stmt *wallet_datastore_next(const tal_t *ctx,
 				      struct wallet *w,
 				      struct db_stmt *stmt,
@@ -5396,6 +6124,7 @@ struct wallet_htlc_iter *wallet_htlcs_first(const tal_t *ctx,
 {
 	struct wallet_htlc_iter *i = tal(ctx, struct wallet_htlc_iter);
 
+	wallet_htlc_flush(w);
 	if (chan) {
 		i->scid = *channel_scid_or_local_alias(chan);
 		assert(i->scid.u64 != 0);
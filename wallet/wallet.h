@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "db.h"
+#include <ccan/intmap/intmap.h>
 #include <common/onion_encode.h>
 #include <common/penalty_base.h>
 #include <common/utxo.h>
@@ -30,6 +31,8 @@ struct wallet {
 	struct ext_key *bip32_base;
 	struct invoices *invoices;
 	struct list_head unstored_payments;
+	/* Payment hashes with parts in flight (see struct inflight_group) */
+	struct list_head inflight_groups;
 	u64 max_channel_dbid;
 
 	/* Filter matching all outpoints corresponding to our owned outputs,
@@ -42,6 +45,10 @@ struct wallet {
 
 	/* How many keys should we look ahead at most? */
 	u64 keyscan_gap;
+
+	/* HTLC state updates in this transaction, by dbid, which we only
+	 * write out at commit (see wallet_htlc_update). */
+	UINTMAP(struct htlc_pending_update *) pending_htlc_updates;
 };
 
 static inline enum output_status output_status_in_db(enum output_status s)
@@ -283,6 +290,19 @@ struct forwarding {
 	struct timeabs received_time;
 	/* May not be present if the HTLC was not resolved yet. */
 	struct timeabs *resolved_time;
+	/* Order this was created in (0 if not known yet) */
+	u64 created_index;
+};
+
+/* Hourly totals of deleted forwards, per channel pair and status */
+struct forward_rollup {
+	/* channel_out is all-zero for local_failed. */
+	struct short_channel_id channel_in, channel_out;
+	enum forward_status status;
+	/* Start of the hour these were resolved in. */
+	struct timeabs hour_start;
+	u64 count;
+	struct amount_msat msat_in, msat_out;
 };
 
 /* A database backed shachain struct. The datastructure is
@@ -490,6 +510,22 @@ struct utxo *wallet_find_utxo(const tal_t *ctx, struct wallet *w,
 			      bool nonwrapped,
 			      const struct utxo **excludes);
 
+/**
+ * wallet_find_utxos - Get all UTXOs we could select, in random order.
+ * @ctx: tal context
+ * @w: wallet
+ * @current_blockheight: current chain length.
+ * @maxheight: zero (if caller doesn't care) or maximum blockheight to accept.
+ * @nonwrapped: filter out p2sh-wrapped inputs
+ *
+ * This is the same set wallet_find_utxo() picks from, but in one query,
+ * for callers which may need many of them.  None are reserved.
+ */
+struct utxo **wallet_find_utxos(const tal_t *ctx, struct wallet *w,
+				unsigned current_blockheight,
+				u32 maxheight,
+				bool nonwrapped);
+
 /**
  * wallet_add_onchaind_utxo - Add a UTXO with spending info from onchaind.
  *
@@ -743,6 +779,19 @@ void wallet_htlc_update(struct wallet *wallet, const u64 htlc_dbid,
 			const u8 *failmsg,
 			bool *we_filled);
 
+/**
+ * wallet_channels_with_htlcs - Find channels which have unresolved HTLCs.
+ *
+ * @ctx: allocation context for the result
+ * @wallet: wallet to load from
+ *
+ * Returns the dbids of all channels with HTLCs in the DB which are not
+ * fully removed, in ascending order.  Channels which are not in this
+ * array have nothing for wallet_htlcs_load_in_for_channel() and
+ * wallet_htlcs_load_out_for_channel() to load.
+ */
+u64 *wallet_channels_with_htlcs(const tal_t *ctx, struct wallet *wallet);
+
 /**
  * wallet_htlcs_load_in_for_channel - Load incoming HTLCs associated with chan from DB.
  *
@@ -843,6 +892,8 @@ struct invoice_details {
 	u8 *features;
 	/* The offer this refers to, if any. */
 	struct sha256 *local_offer_id;
+	/* Order this invoice was created in. */
+	u64 created_index;
 };
 
 /* An object that handles iteration over the set of invoices */
@@ -961,18 +1012,25 @@ void wallet_invoice_delete_expired(struct wallet *wallet,
  *
  * @wallet - the wallet whose invoices are to be iterated over.
  * @iterator - the iterator object to use.
+ * @local_offer_id - if non-NULL, only invoices for this offer.
+ * @start - only invoices with created_index >= start.
+ * @limit - if non-NULL, at most this many invoices.
  *
+ * The filters are only used on the first call.
  * Return false at end-of-sequence, true if still iterating.
  * Usage:
  *
  *   struct invoice_iterator it;
  *   memset(&it, 0, sizeof(it))
- *   while (wallet_invoice_iterate(wallet, &it)) {
+ *   while (wallet_invoice_iterate(wallet, &it, NULL, 0, NULL)) {
  *       ...
  *   }
  */
 bool wallet_invoice_iterate(struct wallet *wallet,
-			    struct invoice_iterator *it);
+			    struct invoice_iterator *it,
+			    const struct sha256 *local_offer_id,
+			    u64 start,
+			    const u32 *limit);
 
 /**
  * wallet_invoice_iterator_deref - Read the details of the
@@ -1011,14 +1069,16 @@ bool wallet_invoice_resolve(struct wallet *wallet,
  * @cb - the callback to invoke. If an invoice is already
  * paid with pay_index greater than lastpay_index, this
  * is called immediately, otherwise it is called during
- * an invoices_resolve call. Will never be given a NULL
- * pointer-to-invoice.
+ * an invoices_resolve call, with that invoice's details. Will
+ * never be given a NULL pointer-to-invoice.
  * @cbarg - the callback data.
  */
 void wallet_invoice_waitany(const tal_t *ctx,
 			    struct wallet *wallet,
 			    u64 lastpay_index,
-			    void (*cb)(const struct invoice *, void*),
+			    void (*cb)(const struct invoice *,
+				       const struct invoice_details *,
+				       void *),
 			    void *cbarg);
 
 /**
@@ -1032,15 +1092,17 @@ void wallet_invoice_waitany(const tal_t *ctx,
  * @cb - the callback to invoice. If invoice is already paid
  * or expired, this is called immediately, otherwise it is
  * called during an invoices_resolve or invoices_delete call.
- * If the invoice was deleted, the callback is given a NULL
- * invoice.
+ * It's given the invoice's details, or if the invoice was
+ * deleted, a NULL invoice (and NULL details).
  * @cbarg - the callback data.
  *
  */
 void wallet_invoice_waitone(const tal_t *ctx,
 			    struct wallet *wallet,
 			    struct invoice invoice,
-			    void (*cb)(const struct invoice *, void*),
+			    void (*cb)(const struct invoice *,
+				       const struct invoice_details *,
+				       void *),
 			    void *cbarg);
 
 /**
@@ -1101,6 +1163,17 @@ void wallet_payment_delete(struct wallet *wallet,
 			   const u64 *groupid,
 			   const u64 *partid);
 
+/**
+ * wallet_payments_delete_before - Remove old payments in bulk
+ *
+ * Removes up to @limit of the oldest payments with @status, created before
+ * UNIX time @before.  Returns the number removed.
+ */
+u64 wallet_payments_delete_before(struct wallet *wallet,
+				  enum wallet_payment_status status,
+				  u64 before,
+				  u32 limit);
+
 /**
  * wallet_local_htlc_out_delete - Remove a local outgoing failed HTLC
  *
@@ -1187,10 +1260,19 @@ void wallet_payment_set_failinfo(struct wallet *wallet,
  * wallet_payment_list - Retrieve a list of payments
  *
  * payment_hash: optional filter for only this payment hash.
+ * status: optional filter for only payments in this state.
+ * start: only return payments with id >= start.
+ * limit: if non-NULL, return at most this many.
+ *
+ * Payments not yet in the db are only included if @start is 0 and
+ * @limit is NULL.
  */
 const struct wallet_payment **wallet_payment_list(const tal_t *ctx,
 						  struct wallet *wallet,
-						  const struct sha256 *payment_hash)
+						  const struct sha256 *payment_hash,
+						  const enum wallet_payment_status *status,
+						  u64 start,
+						  const u32 *limit)
 	NON_NULL_ARGS(2);
 
 
@@ -1275,6 +1357,11 @@ void wallet_utxoset_add(struct wallet *w,
 const struct short_channel_id *
 wallet_utxoset_get_spent(const tal_t *ctx, struct wallet *w, u32 blockheight);
 
+/**
+ * The scripts of every UTXO entry which isn't spent yet.
+ */
+const u8 **wallet_utxoset_unspent_scripts(const tal_t *ctx, struct wallet *w);
+
 /**
  * Retrieve all UTXO entries that were created at a given blockheight.
  */
@@ -1356,22 +1443,85 @@ struct amount_msat wallet_total_forward_fees(struct wallet *w);
 
 /**
  * Retrieve a list of all forwarded_payments
+ *
+ * Only returns those with created_index >= @start, and at most @limit of
+ * them (if non-NULL), in created_index order.  While the background
+ * migration is still numbering old forwards, those are included too (with
+ * created_index 0), and everything is in received order: so don't page
+ * with @start and @limit until wallet_forwards_indexed().
  */
+/**
+ * Do all forwards have their created_index yet?
+ *
+ * Forwards from before created_index existed are numbered by a background
+ * migration: until it's done, they can't be paged through.
+ */
+bool wallet_forwards_indexed(struct wallet *w);
+
 const struct forwarding *wallet_forwarded_payments_get(struct wallet *w,
 						       const tal_t *ctx,
 						       enum forward_status state,
 						       const struct short_channel_id *chan_in,
-						       const struct short_channel_id *chan_out);
+						       const struct short_channel_id *chan_out,
+						       u64 start,
+						       const u32 *limit);
 
 /**
  * Delete a particular forward entry
- * Returns false if not found
+ * Returns false if not found.  Its amounts are added to the hourly
+ * forward_rollups first, so channel history survives deletion.
  */
 bool wallet_forward_delete(struct wallet *w,
 			   const struct short_channel_id *chan_in,
 			   const u64 *htlc_id,
 			   enum forward_status state);
 
+/**
+ * Delete forwards with @state which were resolved before UNIX time @before.
+ *
+ * Deletes the oldest first, stopping after about @limit (more if several
+ * share the same resolved_time), and adds them to the hourly rollups.
+ * Returns the number deleted.
+ */
+u64 wallet_forwards_delete_before(struct wallet *w,
+				  enum forward_status state,
+				  u64 before,
+				  u32 limit);
+
+/**
+ * Retrieve the hourly rollups of deleted forwards.
+ *
+ * Filtered by @chan_in and @chan_out if non-NULL, in hour_start order.
+ */
+const struct forward_rollup *wallet_forward_rollups_get(struct wallet *w,
+						        const tal_t *ctx,
+						        const struct short_channel_id *chan_in,
+						        const struct short_channel_id *chan_out);
+
+/**
+ * wallet_htlc_sigs_load - Load the HTLC signatures for our last commitment tx
+ *
+ * @ctx: allocation context for the return value
+ * @w: wallet containing the channel
+ * @channelid: channel database id
+ * @option_anchor_outputs: whether the channel uses anchor outputs
+ */
+struct bitcoin_signature *
+wallet_htlc_sigs_load(const tal_t *ctx, struct wallet *w, u64 channelid,
+		      bool option_anchor_outputs);
+
+/**
+ * wallet_channel_last_tx_load - Load our last commitment tx for a channel
+ *
+ * @ctx: allocation context for the return value
+ * @w: wallet containing the channel
+ * @id: channel database id
+ *
+ * Returns NULL if there is none (e.g. stub channels).
+ */
+struct bitcoin_tx *wallet_channel_last_tx_load(const tal_t *ctx,
+					       struct wallet *w, u64 id);
+
 /**
  * Load remote_ann_node_sig and remote_ann_bitcoin_sig
  *
@@ -1414,7 +1564,8 @@ void wallet_penalty_base_add(struct wallet *w, u64 chan_id,
  * Retrieve all pending penalty bases for a given channel.
  *
  * This list should stay relatively small since we remove items from it as we
- * get revocations. We retrieve this list whenever we start a new `channeld`.
+ * get revocations (see also wallet_penalty_base_delete_revoked). We retrieve
+ * this list whenever we start a new `channeld`.
  */
 struct penalty_base *wallet_penalty_base_load_for_channel(const tal_t *ctx,
 							  struct wallet *w,
@@ -1425,6 +1576,16 @@ struct penalty_base *wallet_penalty_base_load_for_channel(const tal_t *ctx,
  */
 void wallet_penalty_base_delete(struct wallet *w, u64 chan_id, u64 commitnum);
 
+/**
+ * Delete the penalty_bases of all commitments they have already revoked.
+ *
+ * Those are useless: we only build a penalty tx from one as the
+ * revocation arrives.  But a crash before the commitment_revocation hook
+ * returns, or a to_local output too small to penalize, leaves them behind.
+ */
+void wallet_penalty_base_delete_revoked(struct wallet *w, u64 chan_id,
+					u64 num_revocations);
+
 /* /!\ This is a DB ENUM, please do not change the numbering of any
  * already defined elements (adding is ok) /!\ */
 #define OFFER_STATUS_ACTIVE_F  0x1
@@ -1554,12 +1715,14 @@ enum offer_status wallet_offer_disable(struct wallet *w,
 
 /**
  * Mark an offer in the database used.
- * @w: the wallet
+ * @db: the database
+ * @invoices: the invoices (any others for a single-use offer expire)
  * @offer_id: the merkle root, as used for signing (must be unique)
  *
  * Must exist and be active.
  */
-void wallet_offer_mark_used(struct db *db, const struct sha256 *offer_id)
+void wallet_offer_mark_used(struct db *db, struct invoices *invoices,
+			    const struct sha256 *offer_id)
 	NO_NULL_ARGS;
 
 /**
@@ -1670,7 +1833,7 @@ void wallet_datastore_remove(struct wallet *w, const char **key);
  * Iterate through the datastore.
  * @ctx: the tal ctx to allocate off
  * @w: the wallet
- * @startkey: NULL, or the first key to start with
+ * @startkey: NULL, or the key to iterate (along with its children)
  * @key: the first key (if returns non-NULL)
  * @data: the first data (if returns non-NULL)
  * @generation: the first generation (if returns non-NULL)
@@ -1685,6 +1848,27 @@ struct db_stmt *wallet_datastore_first(const tal_t *ctx,
 				       const u8 **data,
 				       u64 *generation);
 
+/**
+ * Iterate through the datastore, skipping some keys.
+ * @ctx: the tal ctx to allocate off
+ * @w: the wallet
+ * @startkey: NULL, or the key to iterate (along with its children)
+ * @afterkey: NULL, or the key to start after (along with its children)
+ * @key: the first key (if returns non-NULL)
+ * @data: the first data (if returns non-NULL)
+ * @generation: the first generation (if returns non-NULL)
+ *
+ * Returns pointer to hand as @stmt to wallet_datastore_next(), or NULL.
+ * If you choose not to call wallet_datastore_next() you must free it!
+ */
+struct db_stmt *wallet_datastore_after(const tal_t *ctx,
+				       struct wallet *w,
+				       const char **startkey,
+				       const char **afterkey,
+				       const char ***key,
+				       const u8 **data,
+				       u64 *generation);
+
 /**
  * Iterate through the datastore.
  * @ctx: the tal ctx to allocate off
@@ -307,6 +307,67 @@ static void json_add_utxos(struct json_stream *response,
 		json_add_utxo(response, NULL, wallet, utxos[i]);
 }
 
+static void json_add_peer_funds(struct json_stream *response,
+				const struct peer *p)
+{
+	struct channel *c;
+
+	list_for_each(&p->channels, c, list) {
+		/* We don't print out uncommitted channels */
+		if (channel_unsaved(c))
+			continue;
+		json_object_start(response, NULL);
+		json_add_node_id(response, "peer_id", &p->id);
+		json_add_bool(response, "connected",
+			      channel_is_connected(c));
+		json_add_string(response, "state",
+				channel_state_name(c));
+		if (c->scid)
+			json_add_short_channel_id(response,
+						  "short_channel_id",
+						  c->scid);
+
+		json_add_amount_sat_compat(response,
+					   amount_msat_to_sat_round_down(c->our_msat),
+					   "channel_sat",
+					   "our_amount_msat");
+		json_add_amount_sat_compat(response, c->funding_sats,
+					   "channel_total_sat",
+					   "amount_msat");
+		json_add_txid(response, "funding_txid",
+			      &c->funding.txid);
+		json_add_num(response, "funding_output",
+			      c->funding.n);
+		json_object_end(response);
+	}
+}
+
+/* Peers we still have to list, if we had to pause. */
+struct listfunds_info {
+	struct node_id *ids;
+	size_t next;
+};
+
+static struct command_result *listfunds_continue(struct command *cmd,
+						 struct listfunds_info *info)
+{
+	struct json_stream *response = cmd->json_stream;
+
+	while (info->next < tal_count(info->ids)) {
+		/* It may have vanished while we were waiting. */
+		struct peer *p = peer_by_id(cmd->ld, &info->ids[info->next++]);
+		if (p)
+			json_add_peer_funds(response, p);
+
+		if (command_should_pause(cmd))
+			return command_wait_for_output(cmd, listfunds_continue,
+						       info);
+	}
+	json_array_end(response);
+
+	return command_success(cmd, response);
+}
+
 static struct command_result *json_listfunds(struct command *cmd,
 					     const char *buffer,
 					     const jsmntok_t *obj UNNEEDED,
@@ -316,6 +377,7 @@ static struct command_result *json_listfunds(struct command *cmd,
 	struct peer *p;
 	struct peer_node_id_map_iter it;
 	struct utxo **utxos, **reserved_utxos, **spent_utxos;
+	struct listfunds_info *info;
 	bool *spent;
 
 	if (!param(cmd, buffer, params,
@@ -339,44 +401,19 @@ static struct command_result *json_listfunds(struct command *cmd,
 
 	json_array_end(response);
 
-	/* Add funds that are allocated to channels */
+	/* Add funds that are allocated to channels: we may pause to let
+	 * others run, and the peers map can change, so snapshot ids. */
 	json_array_start(response, "channels");
+	info = tal(cmd, struct listfunds_info);
+	info->ids = tal_arr(info, struct node_id, 0);
+	info->next = 0;
 	for (p = peer_node_id_map_first(cmd->ld->peers, &it);
 	     p;
 	     p = peer_node_id_map_next(cmd->ld->peers, &it)) {
-		struct channel *c;
-		list_for_each(&p->channels, c, list) {
-			/* We don't print out uncommitted channels */
-			if (channel_unsaved(c))
-				continue;
-			json_object_start(response, NULL);
-			json_add_node_id(response, "peer_id", &p->id);
-			json_add_bool(response, "connected",
-				      channel_is_connected(c));
-			json_add_string(response, "state",
-					channel_state_name(c));
-			if (c->scid)
-				json_add_short_channel_id(response,
-							  "short_channel_id",
-							  c->scid);
-
-			json_add_amount_sat_compat(response,
-						   amount_msat_to_sat_round_down(c->our_msat),
-						   "channel_sat",
-						   "our_amount_msat");
-			json_add_amount_sat_compat(response, c->funding_sats,
-						   "channel_total_sat",
-						   "amount_msat");
-			json_add_txid(response, "funding_txid",
-				      &c->funding.txid);
-			json_add_num(response, "funding_output",
-				      c->funding.n);
-			json_object_end(response);
-		}
+		tal_arr_expand(&info->ids, p->id);
 	}
-	json_array_end(response);
 
-	return command_success(cmd, response);
+	return listfunds_continue(cmd, info);
 }
 
 static const struct json_command listfunds_command = {
@@ -388,7 +425,8 @@ static const struct json_command listfunds_command = {
 	"Returns a list of funds (outputs) that can be used "
 	"by the internal wallet to open new channels "
 	"or can be withdrawn, using the `withdraw` command, to another wallet. "
-	"Includes spent outputs if {spent} is set to true."
+	"Includes spent outputs if {spent} is set to true.",
+	.cacheable = true,
 };
 AUTODATA(json_command, &listfunds_command);
 
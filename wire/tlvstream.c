@@ -149,6 +149,8 @@ bool fromwire_tlv(const u8 **cursor, size_t *max,
 	bool first = true;
 	u64 prev_type = 0;
 	size_t initial_len = *max;
+	/* Next entry in types[] which could still match */
+	size_t next_meta = 0;
 
 	update_err_off(err_off, initial_len, *max);
 	while (*max > 0) {
@@ -193,13 +195,16 @@ bool fromwire_tlv(const u8 **cursor, size_t *max,
 		 * - if `type` is known:
 		 *   - MUST decode the next `length` bytes using the known
 		 *     encoding for `type`.
+		 *
+		 * Since types[] is sorted too, we never need to look behind
+		 * where we last stopped: the whole stream is one merge pass.
 		 */
 		field.meta = NULL;
-		for (size_t i = 0; i < num_types; i++) {
-			if (types[i].type == field.numtype) {
-				field.meta = &types[i];
-				break;
-			}
+		while (next_meta < num_types
+		       && types[next_meta].type <= field.numtype) {
+			if (types[next_meta].type == field.numtype)
+				field.meta = &types[next_meta];
+			next_meta++;
 		}
 
 		if (!field.meta && !tlv_type_is_allowed(&field, extra_types)) {
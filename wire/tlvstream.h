@@ -42,7 +42,7 @@ struct tlv_field *tlv_make_fields_(const struct tlv_record_type *types,
  * fromwire_tlv: generic TLV decode engine
  * @cursor: cursor to update (set to NULL if we fail).
  * @max: max len to update (always set to 0 if we succeed).
- * @types / @num_types: table of known tlv types
+ * @types / @num_types: table of known tlv types, sorted by type
  * @record: the tlv to hand to @type-specific decode
  * @fields: the fields array to populate
  * @extra_types: tal_arr of unknown types to allow, or NULL, or FROMWIRE_TLV_ANY_TYPE.
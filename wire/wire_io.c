@@ -1,10 +1,12 @@
 #include "config.h"
 /* FIXME: io_plan needs size_t */
  #include <unistd.h>
+#include <ccan/array_size/array_size.h>
 #include <ccan/io/io_plan.h>
 #include <ccan/mem/mem.h>
 #include <common/utils.h>
 #include <errno.h>
+#include <sys/uio.h>
 #include <wire/wire_io.h>
 
 /*
@@ -143,3 +145,82 @@ struct io_plan *io_write_wire_(struct io_conn *conn,
 	arg->u2.s = INSIDE_HEADER_BIT;
 	return io_set_plan(conn, IO_OUT, do_write_wire, next, next_arg);
 }
+
+/* Most iovecs we hand writev at once: two per message. */
+#define BATCH_IOVS 128
+
+struct wire_batch {
+	const u8 **msgs;
+	wire_len_t *hdrs;
+	/* Next message to write, and how much of it (header + body) is out. */
+	size_t msg, off;
+};
+
+/* arg->u1.vp contains struct wire_batch. */
+static int do_write_wire_batch(int fd, struct io_plan_arg *arg)
+{
+	struct wire_batch *b = arg->u1.vp;
+	struct iovec iov[BATCH_IOVS];
+	size_t n = 0, off = b->off;
+	ssize_t ret;
+
+	for (size_t i = b->msg;
+	     i < tal_count(b->msgs) && n + 2 <= ARRAY_SIZE(iov);
+	     i++, off = 0) {
+		if (off < HEADER_LEN) {
+			iov[n].iov_base = (u8 *)&b->hdrs[i] + off;
+			iov[n].iov_len = HEADER_LEN - off;
+			n++;
+			off = HEADER_LEN;
+		}
+		iov[n].iov_base = (u8 *)b->msgs[i] + off - HEADER_LEN;
+		iov[n].iov_len = tal_bytelen(b->msgs[i]) + HEADER_LEN - off;
+		n++;
+	}
+
+	ret = writev(fd, iov, n);
+	if (ret < 0)
+		return -1;
+
+	while (ret > 0) {
+		size_t left = HEADER_LEN + tal_bytelen(b->msgs[b->msg]) - b->off;
+		if ((size_t)ret < left) {
+			b->off += ret;
+			break;
+		}
+		ret -= left;
+		b->msg++;
+		b->off = 0;
+	}
+
+	if (b->msg != tal_count(b->msgs))
+		return 0;
+
+	tal_free(b);
+	return 1;
+}
+
+struct io_plan *io_write_wire_batch_(struct io_conn *conn,
+				     const u8 **msgs,
+				     struct io_plan *(*next)(struct io_conn *,
+							     void *),
+				     void *next_arg)
+{
+	struct io_plan_arg *arg = io_plan_arg(conn, IO_OUT);
+	struct wire_batch *b = tal(conn, struct wire_batch);
+
+	b->msgs = tal_dup_talarr(b, const u8 *, msgs);
+	b->hdrs = tal_arr(b, wire_len_t, tal_count(b->msgs));
+	for (size_t i = 0; i < tal_count(b->msgs); i++) {
+		if (tal_bytelen(b->msgs[i]) >= INSIDE_HEADER_BIT) {
+			tal_free(b);
+			errno = E2BIG;
+			return io_close(conn);
+		}
+		b->hdrs[i] = cpu_to_wirelen(tal_bytelen(b->msgs[i]));
+	}
+	b->msg = b->off = 0;
+
+	arg->u1.vp = b;
+	return io_set_plan(conn, IO_OUT, do_write_wire_batch, next, next_arg);
+}
@@ -36,4 +36,20 @@ struct io_plan *io_write_wire_(struct io_conn *conn,
 		       typesafe_cb_preargs(struct io_plan *, void *,	\
 					   (next), (arg), struct io_conn *), \
 		       (arg))
+
+/* Write several messages, as io_write_wire would one after another, but
+ * with as few syscalls as possible.  msgs can be take(), in which case it's
+ * freed (with any children) once written; otherwise it must stay around. */
+struct io_plan *io_write_wire_batch_(struct io_conn *conn,
+				     const u8 **msgs TAKES,
+				     struct io_plan *(*next)(struct io_conn *,
+							     void *),
+				     void *next_arg);
+
+#define io_write_wire_batch(conn, msgs, next, arg)			\
+	io_write_wire_batch_((conn), (msgs),				\
+			     typesafe_cb_preargs(struct io_plan *, void *, \
+						 (next), (arg),		\
+						 struct io_conn *),	\
+			     (arg))
 #endif /* LIGHTNING_WIRE_WIRE_IO_H */